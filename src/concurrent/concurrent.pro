@@ -14,6 +14,7 @@ SOURCES += \
         qtconcurrentfilter.cpp \
         qtconcurrentmap.cpp \
         qtconcurrentrun.cpp \
+        qtconcurrentsort.cpp \
         qtconcurrentthreadengine.cpp \
         qtconcurrentiteratekernel.cpp \
 
@@ -31,6 +32,8 @@ HEADERS += \
         qtconcurrentreducekernel.h \
         qtconcurrentrun.h \
         qtconcurrentrunbase.h \
+        qtconcurrentsort.h \
+        qtconcurrentsortkernel.h \
         qtconcurrentstoredfunctioncall.h \
         qtconcurrentthreadengine.h
 
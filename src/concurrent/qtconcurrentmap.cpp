@@ -127,8 +127,34 @@
     \value OrderedReduce Reduction is done in the order of the
     original sequence.
     \value SequentialReduce Reduction is done sequentially: only one
-    thread will enter the reduce function at a time. (Parallel reduction
-    might be supported in a future version of Qt Concurrent.)
+    thread will enter the reduce function at a time.
+    \value ParallelReduce Each block of results is reduced into a partial
+    result of its own, without locking, and the partial results are then
+    combined in a tree. The reduce function is called from several threads
+    at once, so it must only touch the result it is passed. Each partial
+    result starts out default-constructed and is then passed to the reduce
+    function in place of a mapped value, so the reduction must satisfy all
+    of the following: a default-constructed result must leave any result it
+    is reduced into unchanged; reducing a partial result into another must
+    give the same as reducing its values one by one; and the order of the
+    results must not matter. For example, \c{r += x} qualifies, but
+    \c{r += x * x} does not, because a partial result would be squared
+    again. Only the types are checked: if the map or filter function does
+    not produce values of the result type, UnorderedReduce is used instead,
+    but a reduce function that does not meet these rules silently gives
+    wrong results. This value was introduced in Qt 5.12.
+*/
+
+/*!
+  \class QtConcurrent::ParallelReducer
+  \inmodule QtConcurrent
+  \internal
+*/
+
+/*!
+  \class QtConcurrent::CanReduceInParallel
+  \inmodule QtConcurrent
+  \internal
 */
 
 /*!
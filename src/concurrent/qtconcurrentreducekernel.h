@@ -52,6 +52,9 @@
 #include <QtCore/qthreadpool.h>
 #include <QtCore/qvector.h>
 
+#include <type_traits>
+#include <utility>
+
 QT_BEGIN_NAMESPACE
 
 
@@ -90,13 +93,91 @@ public:
 enum ReduceOption {
     UnorderedReduce = 0x1,
     OrderedReduce = 0x2,
-    SequentialReduce = 0x4
-    // ParallelReduce = 0x8
+    SequentialReduce = 0x4,
+    ParallelReduce = 0x8
 };
 Q_DECLARE_FLAGS(ReduceOptions, ReduceOption)
 #ifndef Q_CLANG_QDOC
 Q_DECLARE_OPERATORS_FOR_FLAGS(ReduceOptions)
 #endif
+// ParallelReduce folds partial results into each other, which needs the
+// intermediate results to be of the result type. Checking that first keeps
+// unconstrained functors such as PushBackWrapper from being instantiated
+// with two containers. Whether folding gives the right result can't be
+// checked; that is part of the documented contract of ParallelReduce.
+template <typename ReduceFunctor, typename ReduceResultType, typename T,
+          bool SameType = std::is_same<ReduceResultType, T>::value>
+struct CanReduceInParallel
+{
+    template <typename F>
+    static auto test(int) -> decltype(std::declval<F &>()(std::declval<ReduceResultType &>(),
+                                                          std::declval<const ReduceResultType &>()),
+                                      std::true_type());
+    template <typename F>
+    static std::false_type test(...);
+    enum { Value = decltype(test<ReduceFunctor>(0))::value };
+};
+
+template <typename ReduceFunctor, typename ReduceResultType, typename T>
+struct CanReduceInParallel<ReduceFunctor, ReduceResultType, T, false>
+{
+    enum { Value = false };
+};
+
+// Each block of intermediate results is reduced into a partial result of
+// its own, without taking a lock. Partial results are then combined
+// pairwise: a thread parks its partial result in a single slot, or takes
+// the one found there and folds it in, until the slot is empty.
+template <typename ReduceFunctor, typename ReduceResultType, typename T,
+          bool Enabled = CanReduceInParallel<ReduceFunctor, ReduceResultType, T>::Value>
+class ParallelReducer
+{
+    QAtomicPointer<ReduceResultType> pending;
+
+public:
+    ParallelReducer() : pending(nullptr) { }
+    ~ParallelReducer() { delete pending.load(); }
+
+    static bool isEnabled() { return true; }
+
+    void runReduce(ReduceFunctor &reduce, const IntermediateResults<T> &result)
+    {
+        ReduceResultType *partial = new ReduceResultType();
+        for (int i = 0; i < result.vector.size(); ++i)
+            reduce(*partial, result.vector.at(i));
+
+        forever {
+            ReduceResultType *other = pending.fetchAndStoreAcquire(nullptr);
+            if (!other) {
+                if (pending.testAndSetRelease(nullptr, partial))
+                    return;
+                continue;
+            }
+            reduce(*other, *partial);
+            delete partial;
+            partial = other;
+        }
+    }
+
+    void finish(ReduceFunctor &reduce, ReduceResultType &r)
+    {
+        if (ReduceResultType *partial = pending.fetchAndStoreAcquire(nullptr)) {
+            reduce(r, *partial);
+            delete partial;
+        }
+    }
+};
+
+// fallback when partial results cannot be combined
+template <typename ReduceFunctor, typename ReduceResultType, typename T>
+class ParallelReducer<ReduceFunctor, ReduceResultType, T, false>
+{
+public:
+    static bool isEnabled() { return false; }
+    void runReduce(ReduceFunctor &, const IntermediateResults<T> &) { }
+    void finish(ReduceFunctor &, ReduceResultType &) { }
+};
+
 // supports both ordered and out-of-order reduction
 template <typename ReduceFunctor, typename ReduceResultType, typename T>
 class ReduceKernel
@@ -108,6 +189,8 @@ class ReduceKernel
     QMutex mutex;
     int progress, resultsMapSize, threadCount;
     ResultsMap resultsMap;
+    ParallelReducer<ReduceFunctor, ReduceResultType, T> parallelReducer;
+    const bool parallel;
 
     bool canReduce(int begin) const
     {
@@ -139,14 +222,23 @@ class ReduceKernel
 
 public:
     ReduceKernel(ReduceOptions _reduceOptions)
-        : reduceOptions(_reduceOptions), progress(0), resultsMapSize(0),
-          threadCount(QThreadPool::globalInstance()->maxThreadCount())
+        : reduceOptions((_reduceOptions & ParallelReduce)
+                        && !(_reduceOptions & (UnorderedReduce | OrderedReduce))
+                        ? (_reduceOptions | UnorderedReduce) : _reduceOptions),
+          progress(0), resultsMapSize(0),
+          threadCount(QThreadPool::globalInstance()->maxThreadCount()),
+          parallel((_reduceOptions & ParallelReduce) && parallelReducer.isEnabled())
     { }
 
     void runReduce(ReduceFunctor &reduce,
                    ReduceResultType &r,
                    const IntermediateResults<T> &result)
     {
+        if (parallel) {
+            parallelReducer.runReduce(reduce, result);
+            return;
+        }
+
         QMutexLocker locker(&mutex);
         if (!canReduce(result.begin)) {
             ++resultsMapSize;
@@ -205,7 +297,10 @@ public:
     // final reduction
     void finish(ReduceFunctor &reduce, ReduceResultType &r)
     {
-        reduceResults(reduce, r, resultsMap);
+        if (parallel)
+            parallelReducer.finish(reduce, r);
+        else
+            reduceResults(reduce, r, resultsMap);
     }
 
     inline bool shouldThrottle()
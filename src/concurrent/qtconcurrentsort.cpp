@@ -0,0 +1,168 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+/*!
+    \page qtconcurrentsort.html
+    \title Concurrent Sort
+    \ingroup thread
+
+    The QtConcurrent::sort() function sorts the items of a sequence in
+    parallel. It works on containers and iterator ranges with random-access
+    iterators, such as QVector, QList or std::vector.
+
+    This function is a part of the \l {Qt Concurrent} framework.
+
+    The range is split into pieces that are sorted with std::sort() in
+    different threads of the thread pool. Sorted pieces are merged pairwise
+    by whichever thread finishes the second piece of a pair, so no thread
+    waits for another one. Short ranges are sorted in a single thread. The
+    sort is not stable.
+
+    \code
+    QVector<int> values = ...;
+    QFuture<void> sorted = QtConcurrent::sort(values);
+    ...
+    sorted.waitForFinished();
+    \endcode
+
+    QtConcurrent::blockingSort() returns once the sequence is sorted, and
+    uses the calling thread as one of the sorting threads.
+
+    The sequence must not be modified or destroyed until sorting has
+    finished. Canceling the returned QFuture leaves the sequence partially
+    sorted.
+*/
+
+/*!
+  \enum QtConcurrent::SortKernelLimits
+  \internal
+*/
+
+/*!
+  \class QtConcurrent::SortKernel
+  \inmodule QtConcurrent
+  \internal
+*/
+
+/*!
+  \fn [qtconcurrentsortkernel-1] ThreadEngineStarter<void> QtConcurrent::startSort(Iterator begin, Iterator end, LessThan lessThan)
+  \internal
+*/
+
+/*!
+  \fn template <typename Sequence> QFuture<void> QtConcurrent::sort(Sequence &sequence)
+  \since 5.12
+
+  Sorts the items of \a sequence in ascending order, using \c operator<(),
+  in parallel.
+
+  \sa blockingSort(), {Concurrent Sort}
+*/
+
+/*!
+  \fn template <typename Sequence, typename LessThan> QFuture<void> QtConcurrent::sort(Sequence &sequence, LessThan lessThan)
+  \since 5.12
+
+  Sorts the items of \a sequence in parallel. \a lessThan returns \c true
+  if its first argument goes before its second one, and is called from
+  several threads at once.
+
+  \sa blockingSort(), {Concurrent Sort}
+*/
+
+/*!
+  \fn template <typename Iterator> QFuture<void> QtConcurrent::sort(Iterator begin, Iterator end)
+  \since 5.12
+
+  Sorts the items from \a begin up to \a end in ascending order, using
+  \c operator<(), in parallel.
+
+  \sa blockingSort(), {Concurrent Sort}
+*/
+
+/*!
+  \fn template <typename Iterator, typename LessThan> QFuture<void> QtConcurrent::sort(Iterator begin, Iterator end, LessThan lessThan)
+  \since 5.12
+
+  Sorts the items from \a begin up to \a end in parallel, using
+  \a lessThan to compare them.
+
+  \sa blockingSort(), {Concurrent Sort}
+*/
+
+/*!
+  \fn template <typename Sequence> void QtConcurrent::blockingSort(Sequence &sequence)
+  \since 5.12
+
+  Sorts the items of \a sequence in ascending order in parallel, and
+  returns once they are sorted.
+
+  \sa sort(), {Concurrent Sort}
+*/
+
+/*!
+  \fn template <typename Sequence, typename LessThan> void QtConcurrent::blockingSort(Sequence &sequence, LessThan lessThan)
+  \since 5.12
+
+  Sorts the items of \a sequence in parallel, using \a lessThan to compare
+  them, and returns once they are sorted.
+
+  \sa sort(), {Concurrent Sort}
+*/
+
+/*!
+  \fn template <typename Iterator> void QtConcurrent::blockingSort(Iterator begin, Iterator end)
+  \since 5.12
+
+  Sorts the items from \a begin up to \a end in ascending order in
+  parallel, and returns once they are sorted.
+
+  \sa sort(), {Concurrent Sort}
+*/
+
+/*!
+  \fn template <typename Iterator, typename LessThan> void QtConcurrent::blockingSort(Iterator begin, Iterator end, LessThan lessThan)
+  \since 5.12
+
+  Sorts the items from \a begin up to \a end in parallel, using
+  \a lessThan to compare them, and returns once they are sorted.
+
+  \sa sort(), {Concurrent Sort}
+*/
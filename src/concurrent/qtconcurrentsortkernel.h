@@ -0,0 +1,191 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QTCONCURRENT_SORTKERNEL_H
+#define QTCONCURRENT_SORTKERNEL_H
+
+#include <QtConcurrent/qtconcurrent_global.h>
+
+#if !defined(QT_NO_CONCURRENT) || defined (Q_CLANG_QDOC)
+
+#include <QtConcurrent/qtconcurrentthreadengine.h>
+#include <QtCore/qscopedpointer.h>
+
+#include <algorithm>
+#include <iterator>
+
+QT_BEGIN_NAMESPACE
+
+
+namespace QtConcurrent {
+
+/*
+    The SortMinimumLeafSize constant is the smallest number of elements
+    a thread sorts on its own; shorter ranges are not split. The range is
+    split into SortLeavesPerThread leaves per thread of the pool, rounded
+    up to a power of two, so that faster threads can pick up more leaves.
+*/
+#ifdef Q_CLANG_QDOC
+enum SortKernelLimits {
+    SortMinimumLeafSize = 4096,
+    SortLeavesPerThread = 4
+};
+#else
+enum {
+    SortMinimumLeafSize = 4096,
+    SortLeavesPerThread = 4
+};
+#endif
+
+// Parallel merge sort. The range is split into leaves that are sorted
+// independently. Leaves and merged runs form a complete binary tree: the
+// thread that completes the second child of a node merges the node, so
+// no thread ever waits for another one.
+template <typename Iterator, typename LessThan>
+class SortKernel : public ThreadEngine<void>
+{
+    typedef typename std::iterator_traits<Iterator>::difference_type Distance;
+
+    const Iterator begin;
+    const Distance count;
+    LessThan lessThan;
+    int leafCount;
+    QAtomicInt nextLeaf;
+    QAtomicInt sortedLeaves;
+    QScopedArrayPointer<QAtomicInt> arrivals;
+
+    Iterator leafBegin(int leaf) const
+    {
+        return begin + Distance(qint64(count) * leaf / leafCount);
+    }
+
+    // the first leaf under node, in heap order
+    int firstLeaf(int node) const
+    {
+        while (node < leafCount - 1)
+            node = 2 * node + 1;
+        return node - (leafCount - 1);
+    }
+
+    int lastLeaf(int node) const
+    {
+        while (node < leafCount - 1)
+            node = 2 * node + 2;
+        return node - (leafCount - 1);
+    }
+
+    void merge(int node)
+    {
+        std::inplace_merge(leafBegin(firstLeaf(node)),
+                           leafBegin(firstLeaf(2 * node + 2)),
+                           leafBegin(lastLeaf(node) + 1),
+                           lessThan);
+    }
+
+public:
+    typedef void ReturnType;
+    typedef void ResultType;
+
+    SortKernel(Iterator _begin, Iterator _end, LessThan _lessThan)
+        : begin(_begin), count(std::distance(_begin, _end)), lessThan(_lessThan),
+          leafCount(1), nextLeaf(0), sortedLeaves(0)
+    { }
+
+    void start() override
+    {
+        const int maxLeaves = qMax(1, threadPool->maxThreadCount()) * SortLeavesPerThread;
+        while (leafCount < maxLeaves && count / (leafCount * 2) >= SortMinimumLeafSize)
+            leafCount *= 2;
+        if (leafCount > 1)
+            arrivals.reset(new QAtomicInt[leafCount - 1]);
+        if (futureInterface)
+            setProgressRange(0, leafCount);
+    }
+
+    bool shouldStartThread() override
+    {
+        return ThreadEngine<void>::shouldStartThread() && nextLeaf.load() < leafCount;
+    }
+
+    ThreadFunctionResult threadFunction() override
+    {
+        forever {
+            if (this->isCanceled())
+                return ThreadFinished;
+
+            const int leaf = nextLeaf.fetchAndAddRelaxed(1);
+            if (leaf >= leafCount)
+                return ThreadFinished;
+
+            std::sort(leafBegin(leaf), leafBegin(leaf + 1), lessThan);
+
+            // Walk up the tree for as long as this thread is the second to
+            // arrive at a node. The ordered increment makes the other
+            // half's writes visible.
+            int node = leaf + leafCount - 1;
+            while (node > 0) {
+                const int parent = (node - 1) / 2;
+                if (!arrivals[parent].fetchAndAddOrdered(1))
+                    break;
+                merge(parent);
+                node = parent;
+            }
+
+            if (futureInterface)
+                setProgressValue(sortedLeaves.fetchAndAddRelaxed(1) + 1);
+        }
+    }
+};
+
+//! [qtconcurrentsortkernel-1]
+template <typename Iterator, typename LessThan>
+inline ThreadEngineStarter<void> startSort(Iterator begin, Iterator end, LessThan lessThan)
+{
+    return startThreadEngine(new SortKernel<Iterator, LessThan>(begin, end, lessThan));
+}
+
+} // namespace QtConcurrent
+
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_CONCURRENT
+
+#endif
@@ -304,6 +304,424 @@ static inline const uchar *simdFindNonAscii(const uchar *src, const uchar *end,
 }
 #endif
 
+#if QT_COMPILER_SUPPORTS_HERE(SSSE3)
+// For each 8-bit mask, the positions of its set bits in ascending order, one
+// per byte. Used as a PSHUFB control, it moves the selected bytes to the front
+// of the register.
+static const quint64 utf8PackTable[256] = {
+    Q_UINT64_C(0x0000000000000000), Q_UINT64_C(0x0000000000000000), Q_UINT64_C(0x0000000000000001),
+    Q_UINT64_C(0x0000000000000100), Q_UINT64_C(0x0000000000000002), Q_UINT64_C(0x0000000000000200),
+    Q_UINT64_C(0x0000000000000201), Q_UINT64_C(0x0000000000020100), Q_UINT64_C(0x0000000000000003),
+    Q_UINT64_C(0x0000000000000300), Q_UINT64_C(0x0000000000000301), Q_UINT64_C(0x0000000000030100),
+    Q_UINT64_C(0x0000000000000302), Q_UINT64_C(0x0000000000030200), Q_UINT64_C(0x0000000000030201),
+    Q_UINT64_C(0x0000000003020100), Q_UINT64_C(0x0000000000000004), Q_UINT64_C(0x0000000000000400),
+    Q_UINT64_C(0x0000000000000401), Q_UINT64_C(0x0000000000040100), Q_UINT64_C(0x0000000000000402),
+    Q_UINT64_C(0x0000000000040200), Q_UINT64_C(0x0000000000040201), Q_UINT64_C(0x0000000004020100),
+    Q_UINT64_C(0x0000000000000403), Q_UINT64_C(0x0000000000040300), Q_UINT64_C(0x0000000000040301),
+    Q_UINT64_C(0x0000000004030100), Q_UINT64_C(0x0000000000040302), Q_UINT64_C(0x0000000004030200),
+    Q_UINT64_C(0x0000000004030201), Q_UINT64_C(0x0000000403020100), Q_UINT64_C(0x0000000000000005),
+    Q_UINT64_C(0x0000000000000500), Q_UINT64_C(0x0000000000000501), Q_UINT64_C(0x0000000000050100),
+    Q_UINT64_C(0x0000000000000502), Q_UINT64_C(0x0000000000050200), Q_UINT64_C(0x0000000000050201),
+    Q_UINT64_C(0x0000000005020100), Q_UINT64_C(0x0000000000000503), Q_UINT64_C(0x0000000000050300),
+    Q_UINT64_C(0x0000000000050301), Q_UINT64_C(0x0000000005030100), Q_UINT64_C(0x0000000000050302),
+    Q_UINT64_C(0x0000000005030200), Q_UINT64_C(0x0000000005030201), Q_UINT64_C(0x0000000503020100),
+    Q_UINT64_C(0x0000000000000504), Q_UINT64_C(0x0000000000050400), Q_UINT64_C(0x0000000000050401),
+    Q_UINT64_C(0x0000000005040100), Q_UINT64_C(0x0000000000050402), Q_UINT64_C(0x0000000005040200),
+    Q_UINT64_C(0x0000000005040201), Q_UINT64_C(0x0000000504020100), Q_UINT64_C(0x0000000000050403),
+    Q_UINT64_C(0x0000000005040300), Q_UINT64_C(0x0000000005040301), Q_UINT64_C(0x0000000504030100),
+    Q_UINT64_C(0x0000000005040302), Q_UINT64_C(0x0000000504030200), Q_UINT64_C(0x0000000504030201),
+    Q_UINT64_C(0x0000050403020100), Q_UINT64_C(0x0000000000000006), Q_UINT64_C(0x0000000000000600),
+    Q_UINT64_C(0x0000000000000601), Q_UINT64_C(0x0000000000060100), Q_UINT64_C(0x0000000000000602),
+    Q_UINT64_C(0x0000000000060200), Q_UINT64_C(0x0000000000060201), Q_UINT64_C(0x0000000006020100),
+    Q_UINT64_C(0x0000000000000603), Q_UINT64_C(0x0000000000060300), Q_UINT64_C(0x0000000000060301),
+    Q_UINT64_C(0x0000000006030100), Q_UINT64_C(0x0000000000060302), Q_UINT64_C(0x0000000006030200),
+    Q_UINT64_C(0x0000000006030201), Q_UINT64_C(0x0000000603020100), Q_UINT64_C(0x0000000000000604),
+    Q_UINT64_C(0x0000000000060400), Q_UINT64_C(0x0000000000060401), Q_UINT64_C(0x0000000006040100),
+    Q_UINT64_C(0x0000000000060402), Q_UINT64_C(0x0000000006040200), Q_UINT64_C(0x0000000006040201),
+    Q_UINT64_C(0x0000000604020100), Q_UINT64_C(0x0000000000060403), Q_UINT64_C(0x0000000006040300),
+    Q_UINT64_C(0x0000000006040301), Q_UINT64_C(0x0000000604030100), Q_UINT64_C(0x0000000006040302),
+    Q_UINT64_C(0x0000000604030200), Q_UINT64_C(0x0000000604030201), Q_UINT64_C(0x0000060403020100),
+    Q_UINT64_C(0x0000000000000605), Q_UINT64_C(0x0000000000060500), Q_UINT64_C(0x0000000000060501),
+    Q_UINT64_C(0x0000000006050100), Q_UINT64_C(0x0000000000060502), Q_UINT64_C(0x0000000006050200),
+    Q_UINT64_C(0x0000000006050201), Q_UINT64_C(0x0000000605020100), Q_UINT64_C(0x0000000000060503),
+    Q_UINT64_C(0x0000000006050300), Q_UINT64_C(0x0000000006050301), Q_UINT64_C(0x0000000605030100),
+    Q_UINT64_C(0x0000000006050302), Q_UINT64_C(0x0000000605030200), Q_UINT64_C(0x0000000605030201),
+    Q_UINT64_C(0x0000060503020100), Q_UINT64_C(0x0000000000060504), Q_UINT64_C(0x0000000006050400),
+    Q_UINT64_C(0x0000000006050401), Q_UINT64_C(0x0000000605040100), Q_UINT64_C(0x0000000006050402),
+    Q_UINT64_C(0x0000000605040200), Q_UINT64_C(0x0000000605040201), Q_UINT64_C(0x0000060504020100),
+    Q_UINT64_C(0x0000000006050403), Q_UINT64_C(0x0000000605040300), Q_UINT64_C(0x0000000605040301),
+    Q_UINT64_C(0x0000060504030100), Q_UINT64_C(0x0000000605040302), Q_UINT64_C(0x0000060504030200),
+    Q_UINT64_C(0x0000060504030201), Q_UINT64_C(0x0006050403020100), Q_UINT64_C(0x0000000000000007),
+    Q_UINT64_C(0x0000000000000700), Q_UINT64_C(0x0000000000000701), Q_UINT64_C(0x0000000000070100),
+    Q_UINT64_C(0x0000000000000702), Q_UINT64_C(0x0000000000070200), Q_UINT64_C(0x0000000000070201),
+    Q_UINT64_C(0x0000000007020100), Q_UINT64_C(0x0000000000000703), Q_UINT64_C(0x0000000000070300),
+    Q_UINT64_C(0x0000000000070301), Q_UINT64_C(0x0000000007030100), Q_UINT64_C(0x0000000000070302),
+    Q_UINT64_C(0x0000000007030200), Q_UINT64_C(0x0000000007030201), Q_UINT64_C(0x0000000703020100),
+    Q_UINT64_C(0x0000000000000704), Q_UINT64_C(0x0000000000070400), Q_UINT64_C(0x0000000000070401),
+    Q_UINT64_C(0x0000000007040100), Q_UINT64_C(0x0000000000070402), Q_UINT64_C(0x0000000007040200),
+    Q_UINT64_C(0x0000000007040201), Q_UINT64_C(0x0000000704020100), Q_UINT64_C(0x0000000000070403),
+    Q_UINT64_C(0x0000000007040300), Q_UINT64_C(0x0000000007040301), Q_UINT64_C(0x0000000704030100),
+    Q_UINT64_C(0x0000000007040302), Q_UINT64_C(0x0000000704030200), Q_UINT64_C(0x0000000704030201),
+    Q_UINT64_C(0x0000070403020100), Q_UINT64_C(0x0000000000000705), Q_UINT64_C(0x0000000000070500),
+    Q_UINT64_C(0x0000000000070501), Q_UINT64_C(0x0000000007050100), Q_UINT64_C(0x0000000000070502),
+    Q_UINT64_C(0x0000000007050200), Q_UINT64_C(0x0000000007050201), Q_UINT64_C(0x0000000705020100),
+    Q_UINT64_C(0x0000000000070503), Q_UINT64_C(0x0000000007050300), Q_UINT64_C(0x0000000007050301),
+    Q_UINT64_C(0x0000000705030100), Q_UINT64_C(0x0000000007050302), Q_UINT64_C(0x0000000705030200),
+    Q_UINT64_C(0x0000000705030201), Q_UINT64_C(0x0000070503020100), Q_UINT64_C(0x0000000000070504),
+    Q_UINT64_C(0x0000000007050400), Q_UINT64_C(0x0000000007050401), Q_UINT64_C(0x0000000705040100),
+    Q_UINT64_C(0x0000000007050402), Q_UINT64_C(0x0000000705040200), Q_UINT64_C(0x0000000705040201),
+    Q_UINT64_C(0x0000070504020100), Q_UINT64_C(0x0000000007050403), Q_UINT64_C(0x0000000705040300),
+    Q_UINT64_C(0x0000000705040301), Q_UINT64_C(0x0000070504030100), Q_UINT64_C(0x0000000705040302),
+    Q_UINT64_C(0x0000070504030200), Q_UINT64_C(0x0000070504030201), Q_UINT64_C(0x0007050403020100),
+    Q_UINT64_C(0x0000000000000706), Q_UINT64_C(0x0000000000070600), Q_UINT64_C(0x0000000000070601),
+    Q_UINT64_C(0x0000000007060100), Q_UINT64_C(0x0000000000070602), Q_UINT64_C(0x0000000007060200),
+    Q_UINT64_C(0x0000000007060201), Q_UINT64_C(0x0000000706020100), Q_UINT64_C(0x0000000000070603),
+    Q_UINT64_C(0x0000000007060300), Q_UINT64_C(0x0000000007060301), Q_UINT64_C(0x0000000706030100),
+    Q_UINT64_C(0x0000000007060302), Q_UINT64_C(0x0000000706030200), Q_UINT64_C(0x0000000706030201),
+    Q_UINT64_C(0x0000070603020100), Q_UINT64_C(0x0000000000070604), Q_UINT64_C(0x0000000007060400),
+    Q_UINT64_C(0x0000000007060401), Q_UINT64_C(0x0000000706040100), Q_UINT64_C(0x0000000007060402),
+    Q_UINT64_C(0x0000000706040200), Q_UINT64_C(0x0000000706040201), Q_UINT64_C(0x0000070604020100),
+    Q_UINT64_C(0x0000000007060403), Q_UINT64_C(0x0000000706040300), Q_UINT64_C(0x0000000706040301),
+    Q_UINT64_C(0x0000070604030100), Q_UINT64_C(0x0000000706040302), Q_UINT64_C(0x0000070604030200),
+    Q_UINT64_C(0x0000070604030201), Q_UINT64_C(0x0007060403020100), Q_UINT64_C(0x0000000000070605),
+    Q_UINT64_C(0x0000000007060500), Q_UINT64_C(0x0000000007060501), Q_UINT64_C(0x0000000706050100),
+    Q_UINT64_C(0x0000000007060502), Q_UINT64_C(0x0000000706050200), Q_UINT64_C(0x0000000706050201),
+    Q_UINT64_C(0x0000070605020100), Q_UINT64_C(0x0000000007060503), Q_UINT64_C(0x0000000706050300),
+    Q_UINT64_C(0x0000000706050301), Q_UINT64_C(0x0000070605030100), Q_UINT64_C(0x0000000706050302),
+    Q_UINT64_C(0x0000070605030200), Q_UINT64_C(0x0000070605030201), Q_UINT64_C(0x0007060503020100),
+    Q_UINT64_C(0x0000000007060504), Q_UINT64_C(0x0000000706050400), Q_UINT64_C(0x0000000706050401),
+    Q_UINT64_C(0x0000070605040100), Q_UINT64_C(0x0000000706050402), Q_UINT64_C(0x0000070605040200),
+    Q_UINT64_C(0x0000070605040201), Q_UINT64_C(0x0007060504020100), Q_UINT64_C(0x0000000706050403),
+    Q_UINT64_C(0x0000070605040300), Q_UINT64_C(0x0000070605040301), Q_UINT64_C(0x0007060504030100),
+    Q_UINT64_C(0x0000070605040302), Q_UINT64_C(0x0007060504030200), Q_UINT64_C(0x0007060504030201),
+    Q_UINT64_C(0x0706050403020100)
+};
+
+QT_FUNCTION_TARGET(SSSE3)
+static inline __m128i packBytesShuffle(uint mask, char offset)
+{
+    const __m128i indexes = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(utf8PackTable + mask));
+    return _mm_add_epi8(indexes, _mm_set1_epi8(offset));
+}
+
+// Counts the bytes set to 0xff in each half of \a mask
+QT_FUNCTION_TARGET(SSSE3)
+static inline void countPerHalf(__m128i mask, uint &lo, uint &hi)
+{
+    const __m128i counts = _mm_sad_epu8(_mm_and_si128(mask, _mm_set1_epi8(1)), _mm_setzero_si128());
+    lo = _mm_cvtsi128_si32(counts);
+    hi = _mm_extract_epi16(counts, 4);
+}
+
+QT_FUNCTION_TARGET(SSSE3)
+static inline __m128i packWordsShuffle(uint mask)
+{
+    // turn the word indexes into pairs of byte indexes: 2n, 2n + 1
+    __m128i indexes = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(utf8PackTable + mask));
+    indexes = _mm_unpacklo_epi8(indexes, indexes);
+    indexes = _mm_add_epi8(indexes, indexes);
+    return _mm_add_epi8(indexes, _mm_set1_epi16(0x0100));
+}
+
+// Decodes the sequence starting at each of eight bytes, as if it were one.
+// \a b0, \a b1 and \a b2 hold those bytes and the two following each of them,
+// zero-extended to 16 bits. \a invalid is set for three-byte sequences that
+// are overlong or encode a surrogate.
+QT_FUNCTION_TARGET(SSSE3)
+static inline __m128i decodeUtf8Words(__m128i b0, __m128i b1, __m128i b2, __m128i &invalid)
+{
+    const __m128i payload = _mm_set1_epi16(0x3f);
+    const __m128i c1 = _mm_and_si128(b1, payload);
+    const __m128i c2 = _mm_and_si128(b2, payload);
+
+    // 110xxxxx 10yyyyyy
+    const __m128i two = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(b0, _mm_set1_epi16(0x1f)), 6), c1);
+    // 1110xxxx 10yyyyyy 10zzzzzz
+    const __m128i three = _mm_or_si128(_mm_or_si128(_mm_slli_epi16(b0, 12), _mm_slli_epi16(c1, 6)), c2);
+
+    const __m128i isAscii = _mm_cmplt_epi16(b0, _mm_set1_epi16(0x80));
+    const __m128i isThree = _mm_cmpgt_epi16(b0, _mm_set1_epi16(0xdf));
+    __m128i result = _mm_or_si128(_mm_and_si128(isThree, three), _mm_andnot_si128(isThree, two));
+    result = _mm_or_si128(_mm_and_si128(isAscii, b0), _mm_andnot_si128(isAscii, result));
+
+    // three-byte sequences must decode to U+0800 or above, but not to a surrogate
+    const __m128i top = _mm_and_si128(three, _mm_set1_epi16(short(0xf800)));
+    invalid = _mm_and_si128(isThree, _mm_or_si128(_mm_cmpeq_epi16(top, _mm_setzero_si128()),
+                                                  _mm_cmpeq_epi16(top, _mm_set1_epi16(short(0xd800)))));
+    return result;
+}
+
+QT_FUNCTION_TARGET(SSSE3)
+static bool simdDecodeUtf8Ssse3(ushort *&dst, const uchar *&nextAscii, const uchar *&src, const uchar *end)
+{
+    // Do sixteen bytes at a time, as long as they hold nothing but well-formed
+    // sequences of one to three bytes. Sequences of four bytes and errors are
+    // left to the caller, which decodes up to nextAscii before calling us again.
+    // So are blocks of ASCII, which simdDecodeAscii handles faster.
+    //
+    // We always advance by sixteen bytes, so that the next load does not wait
+    // for the decoding. A sequence starting in the last two bytes of a block is
+    // decoded in full, which is why we need eighteen; the continuation bytes it
+    // takes from the next block are carried over.
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i continuationLimit = _mm_set1_epi8(char(0xc0));
+    uint carried = 0;
+    nextAscii = end;
+    for ( ; end - src >= 18; src += 16) {
+        const __m128i data0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+        const __m128i data1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 1));
+        const __m128i data2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 2));
+
+        const uint nonAscii = _mm_movemask_epi8(data0);
+        if (!nonAscii) {
+            nextAscii = src;
+            break;
+        }
+
+        // continuation bytes are 0x80 to 0xbf, that is, below 0xc0 as signed bytes
+        const __m128i isContinuation = _mm_cmplt_epi8(data0, continuationLimit);
+        const uint continuation = _mm_movemask_epi8(isContinuation)
+                | ((_mm_movemask_epi8(_mm_cmplt_epi8(data2, continuationLimit)) & 0xc000) << 2);
+        const uint aboveC1 = _mm_movemask_epi8(_mm_cmpgt_epi8(data0, _mm_set1_epi8(char(0xc1))));
+        const uint aboveDF = _mm_movemask_epi8(_mm_cmpgt_epi8(data0, _mm_set1_epi8(char(0xdf))));
+        const uint aboveEF = _mm_movemask_epi8(_mm_cmpgt_epi8(data0, _mm_set1_epi8(char(0xef))));
+        const uint lead2 = nonAscii & aboveC1 & ~aboveDF;
+        const uint lead3 = nonAscii & aboveDF & ~aboveEF;
+        const uint expected = (lead2 << 1) | (lead3 << 1) | (lead3 << 2) | carried;
+
+        // bad lead bytes (0xc0, 0xc1, 0xf0 and up), continuation bytes where
+        // none belong or missing where one does
+        uint problems = (nonAscii & ~continuation & ~(lead2 | lead3))
+                | ((continuation ^ expected) & 0xffff)
+                | (((expected & ~continuation) >> 2) & 0xc000);
+
+        __m128i invalidLo, invalidHi;
+        const __m128i wordsLo = decodeUtf8Words(_mm_unpacklo_epi8(data0, zero), _mm_unpacklo_epi8(data1, zero),
+                                                _mm_unpacklo_epi8(data2, zero), invalidLo);
+        const __m128i wordsHi = decodeUtf8Words(_mm_unpackhi_epi8(data0, zero), _mm_unpackhi_epi8(data1, zero),
+                                                _mm_unpackhi_epi8(data2, zero), invalidHi);
+        problems |= _mm_movemask_epi8(_mm_packs_epi16(invalidLo, invalidHi));
+        if (problems) {
+            nextAscii = src + qCountTrailingZeroBits(problems) + 1;
+            break;
+        }
+
+        // keep the words decoded at the start of each sequence
+        const uint starts = ~continuation & 0xffff;
+        uint countLo, countHi;
+        countPerHalf(_mm_cmpeq_epi8(isContinuation, zero), countLo, countHi);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_shuffle_epi8(wordsLo, packWordsShuffle(starts & 0xff)));
+        dst += countLo;
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_shuffle_epi8(wordsHi, packWordsShuffle(starts >> 8)));
+        dst += countHi;
+        carried = expected >> 16;
+    }
+    // skip the bytes already decoded
+    src += (carried & 1) + (carried >> 1);
+    return src == end;
+}
+
+#if QT_COMPILER_SUPPORTS_HERE(AVX2)
+// Same as decodeUtf8Words, for sixteen bytes at a time
+QT_FUNCTION_TARGET(AVX2)
+static inline __m256i decodeUtf8WordsAvx2(__m256i b0, __m256i b1, __m256i b2, __m256i &invalid)
+{
+    const __m256i payload = _mm256_set1_epi16(0x3f);
+    const __m256i c1 = _mm256_and_si256(b1, payload);
+    const __m256i c2 = _mm256_and_si256(b2, payload);
+    const __m256i two = _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(b0, _mm256_set1_epi16(0x1f)), 6), c1);
+    const __m256i three = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi16(b0, 12), _mm256_slli_epi16(c1, 6)), c2);
+
+    const __m256i isAscii = _mm256_cmpgt_epi16(_mm256_set1_epi16(0x80), b0);
+    const __m256i isThree = _mm256_cmpgt_epi16(b0, _mm256_set1_epi16(0xdf));
+    __m256i result = _mm256_blendv_epi8(two, three, isThree);
+    result = _mm256_blendv_epi8(result, b0, isAscii);
+
+    const __m256i top = _mm256_and_si256(three, _mm256_set1_epi16(short(0xf800)));
+    invalid = _mm256_and_si256(isThree, _mm256_or_si256(_mm256_cmpeq_epi16(top, _mm256_setzero_si256()),
+                                                        _mm256_cmpeq_epi16(top, _mm256_set1_epi16(short(0xd800)))));
+    return result;
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static bool simdDecodeUtf8Avx2(ushort *&dst, const uchar *&nextAscii, const uchar *&src, const uchar *end)
+{
+    // see simdDecodeUtf8Ssse3
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i continuationLimit = _mm_set1_epi8(char(0xc0));
+    uint carried = 0;
+    nextAscii = end;
+    for ( ; end - src >= 18; src += 16) {
+        const __m128i data0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+        const __m128i data1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 1));
+        const __m128i data2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 2));
+
+        const uint nonAscii = _mm_movemask_epi8(data0);
+        if (!nonAscii) {
+            nextAscii = src;
+            break;
+        }
+
+        const __m128i isContinuation = _mm_cmplt_epi8(data0, continuationLimit);
+        const uint continuation = _mm_movemask_epi8(isContinuation)
+                | ((_mm_movemask_epi8(_mm_cmplt_epi8(data2, continuationLimit)) & 0xc000) << 2);
+        const uint aboveC1 = _mm_movemask_epi8(_mm_cmpgt_epi8(data0, _mm_set1_epi8(char(0xc1))));
+        const uint aboveDF = _mm_movemask_epi8(_mm_cmpgt_epi8(data0, _mm_set1_epi8(char(0xdf))));
+        const uint aboveEF = _mm_movemask_epi8(_mm_cmpgt_epi8(data0, _mm_set1_epi8(char(0xef))));
+        const uint lead2 = nonAscii & aboveC1 & ~aboveDF;
+        const uint lead3 = nonAscii & aboveDF & ~aboveEF;
+        const uint expected = (lead2 << 1) | (lead3 << 1) | (lead3 << 2) | carried;
+        uint problems = (nonAscii & ~continuation & ~(lead2 | lead3))
+                | ((continuation ^ expected) & 0xffff)
+                | (((expected & ~continuation) >> 2) & 0xc000);
+
+        __m256i invalid;
+        const __m256i words = decodeUtf8WordsAvx2(_mm256_cvtepu8_epi16(data0), _mm256_cvtepu8_epi16(data1),
+                                                  _mm256_cvtepu8_epi16(data2), invalid);
+        // two bits per word
+        const uint invalidMask = _mm256_movemask_epi8(invalid);
+        if (problems | invalidMask) {
+            const uint first = qMin(problems ? qCountTrailingZeroBits(problems) : 16u,
+                                    invalidMask ? qCountTrailingZeroBits(invalidMask) / 2 : 16u);
+            nextAscii = src + first + 1;
+            break;
+        }
+
+        const uint starts = ~continuation & 0xffff;
+        uint countLo, countHi;
+        countPerHalf(_mm_cmpeq_epi8(isContinuation, zero), countLo, countHi);
+        const __m256i shuffle = _mm256_inserti128_si256(_mm256_castsi128_si256(packWordsShuffle(starts & 0xff)),
+                                                        packWordsShuffle(starts >> 8), 1);
+        const __m256i packed = _mm256_shuffle_epi8(words, shuffle);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm256_castsi256_si128(packed));
+        dst += countLo;
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm256_extracti128_si256(packed, 1));
+        dst += countHi;
+        carried = expected >> 16;
+    }
+    // skip the bytes already decoded
+    src += (carried & 1) + (carried >> 1);
+    return src == end;
+}
+#endif
+
+QT_FUNCTION_TARGET(SSSE3)
+static bool simdEncodeUtf8Ssse3(uchar *&dst, const ushort *&nextAscii, const ushort *&src, const ushort *end)
+{
+    // Do eight characters at a time, as long as there are no surrogates. We
+    // need sixteen so that the stores of up to 24 bytes cannot overrun the
+    // buffer. Surrogates are left to the caller, which encodes up to nextAscii
+    // before calling us again. So are blocks of ASCII.
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lowByte = _mm_set1_epi16(0x00ff);
+    const __m128i payload = _mm_set1_epi16(0x3f);
+    const __m128i continuation = _mm_set1_epi16(0x80);
+    for ( ; end - src >= 16; src += 8) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+
+        // unsigned comparisons: the saturating subtraction is zero for the smaller values
+        const __m128i isAscii = _mm_cmpeq_epi16(_mm_subs_epu16(data, _mm_set1_epi16(0x7f)), zero);
+        const __m128i belowThree = _mm_cmpeq_epi16(_mm_subs_epu16(data, _mm_set1_epi16(0x7ff)), zero);
+        const uint asciiMask = _mm_movemask_epi8(isAscii);
+        if (asciiMask == 0xffff) {
+            nextAscii = src;
+            return false;
+        }
+        const __m128i top = _mm_and_si128(data, _mm_set1_epi16(short(0xf800)));
+        const uint surrogates = _mm_movemask_epi8(_mm_cmpeq_epi16(top, _mm_set1_epi16(short(0xd800))));
+        if (surrogates) {
+            nextAscii = src + qCountTrailingZeroBits(surrogates) / 2 + 1;
+            return false;
+        }
+
+        // 10zzzzzz
+        const __m128i last = _mm_or_si128(_mm_and_si128(data, payload), continuation);
+        // 110xxxxx
+        const __m128i lead2 = _mm_or_si128(_mm_srli_epi16(data, 6), _mm_set1_epi16(0xc0));
+        __m128i first = _mm_or_si128(_mm_and_si128(isAscii, data), _mm_andnot_si128(isAscii, lead2));
+
+        if (_mm_movemask_epi8(belowThree) == 0xffff) {
+            // one or two bytes per character, in the two bytes of each word
+            const __m128i bytes = _mm_or_si128(first, _mm_slli_epi16(last, 8));
+            const __m128i keep = _mm_or_si128(_mm_andnot_si128(isAscii, _mm_set1_epi16(short(0xff00))), lowByte);
+            const uint keepMask = _mm_movemask_epi8(keep);
+            uint countLo, countHi;
+            countPerHalf(keep, countLo, countHi);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_shuffle_epi8(bytes, packBytesShuffle(keepMask & 0xff, 0)));
+            dst += countLo;
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_shuffle_epi8(bytes, packBytesShuffle(keepMask >> 8, 8)));
+            dst += countHi;
+            continue;
+        }
+
+        // up to three bytes per character, in the first three bytes of each dword
+        // 1110xxxx 10yyyyyy
+        const __m128i lead3 = _mm_or_si128(_mm_srli_epi16(data, 12), _mm_set1_epi16(0xe0));
+        const __m128i middle = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(data, 6), payload), continuation);
+        first = _mm_or_si128(_mm_and_si128(belowThree, first), _mm_andnot_si128(belowThree, lead3));
+        const __m128i second = _mm_or_si128(_mm_and_si128(belowThree, last), _mm_andnot_si128(belowThree, middle));
+        const __m128i firstTwo = _mm_or_si128(first, _mm_slli_epi16(second, 8));
+        const __m128i third = _mm_andnot_si128(belowThree, last);
+
+        const __m128i keepFirstTwo = _mm_or_si128(_mm_andnot_si128(isAscii, _mm_set1_epi16(short(0xff00))), lowByte);
+        const __m128i keepThird = _mm_andnot_si128(belowThree, lowByte);
+        uint countLo, countHi;
+
+        const __m128i bytesLo = _mm_unpacklo_epi16(firstTwo, third);
+        const __m128i keepLo = _mm_unpacklo_epi16(keepFirstTwo, keepThird);
+        const uint keepLoMask = _mm_movemask_epi8(keepLo);
+        countPerHalf(keepLo, countLo, countHi);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_shuffle_epi8(bytesLo, packBytesShuffle(keepLoMask & 0xff, 0)));
+        dst += countLo;
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_shuffle_epi8(bytesLo, packBytesShuffle(keepLoMask >> 8, 8)));
+        dst += countHi;
+
+        const __m128i bytesHi = _mm_unpackhi_epi16(firstTwo, third);
+        const __m128i keepHi = _mm_unpackhi_epi16(keepFirstTwo, keepThird);
+        const uint keepHiMask = _mm_movemask_epi8(keepHi);
+        countPerHalf(keepHi, countLo, countHi);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_shuffle_epi8(bytesHi, packBytesShuffle(keepHiMask & 0xff, 0)));
+        dst += countLo;
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_shuffle_epi8(bytesHi, packBytesShuffle(keepHiMask >> 8, 8)));
+        dst += countHi;
+    }
+    nextAscii = end;
+    return src == end;
+}
+#endif
+
+// Convert runs of non-ASCII text; when these return false, the caller needs to
+// convert up to nextAscii one character at a time before trying again
+static inline bool simdDecodeUtf8(ushort *&dst, const uchar *&nextAscii, const uchar *&src, const uchar *end)
+{
+#if QT_COMPILER_SUPPORTS_HERE(AVX2)
+    if (qCpuHasFeature(AVX2))
+        return simdDecodeUtf8Avx2(dst, nextAscii, src, end);
+#endif
+#if QT_COMPILER_SUPPORTS_HERE(SSSE3)
+    if (qCpuHasFeature(SSSE3))
+        return simdDecodeUtf8Ssse3(dst, nextAscii, src, end);
+#endif
+    Q_UNUSED(dst);
+    Q_UNUSED(nextAscii);
+    Q_UNUSED(src);
+    Q_UNUSED(end);
+    return false;
+}
+
+static inline bool simdEncodeUtf8(uchar *&dst, const ushort *&nextAscii, const ushort *&src, const ushort *end)
+{
+#if QT_COMPILER_SUPPORTS_HERE(SSSE3)
+    if (qCpuHasFeature(SSSE3))
+        return simdEncodeUtf8Ssse3(dst, nextAscii, src, end);
+#endif
+    Q_UNUSED(dst);
+    Q_UNUSED(nextAscii);
+    Q_UNUSED(src);
+    Q_UNUSED(end);
+    return false;
+}
+
 QByteArray QUtf8::convertFromUnicode(const QChar *uc, int len)
 {
     // create a QByteArray with the worst case scenario size
@@ -316,6 +734,8 @@ QByteArray QUtf8::convertFromUnicode(const QChar *uc, int len)
         const ushort *nextAscii = end;
         if (simdEncodeAscii(dst, nextAscii, src, end))
             break;
+        if (simdEncodeUtf8(dst, nextAscii, src, end))
+            break;
 
         do {
             ushort uc = *src++;
@@ -368,7 +788,8 @@ QByteArray QUtf8::convertFromUnicode(const QChar *uc, int len, QTextCodec::Conve
             surrogate_high = -1;
             res = QUtf8Functions::toUtf8<QUtf8BaseTraits>(uc, cursor, src, end);
         } else {
-            if (src >= nextAscii && simdEncodeAscii(cursor, nextAscii, src, end))
+            if (src >= nextAscii && (simdEncodeAscii(cursor, nextAscii, src, end)
+                                     || simdEncodeUtf8(cursor, nextAscii, src, end)))
                 break;
 
             uc = *src++;
@@ -459,6 +880,8 @@ QChar *QUtf8::convertToUnicode(QChar *buffer, const char *chars, int len) Q_DECL
             nextAscii = end;
             if (simdDecodeAscii(dst, nextAscii, src, end))
                 break;
+            if (simdDecodeUtf8(dst, nextAscii, src, end))
+                break;
 
             do {
                 uchar b = *src++;
@@ -476,12 +899,6 @@ QChar *QUtf8::convertToUnicode(QChar *buffer, const char *chars, int len) Q_DECL
 
 QString QUtf8::convertToUnicode(const char *chars, int len, QTextCodec::ConverterState *state)
 {
-    bool headerdone = false;
-    ushort replacement = QChar::ReplacementCharacter;
-    int invalid = 0;
-    int res;
-    uchar ch = 0;
-
     // See above for buffer requirements for stateless decoding. However, that
     // fails if the state is not empty. The following situations can add to the
     // requirements:
@@ -493,8 +910,30 @@ QString QUtf8::convertToUnicode(const char *chars, int len, QTextCodec::Converte
     //   2 of 3 bytes       same                        +1 (same)
     //   3 of 4 bytes       same                        +1 (same)
     QString result(len + 1, Qt::Uninitialized);
+    QChar *end = convertToUnicode(result.data(), chars, len, state);
+    result.truncate(end - result.constData());
+    return result;
+}
+
+/*!
+    \internal
+    \overload
+
+    Converts the UTF-8 sequence of \a len octets beginning at \a chars to
+    a sequence of QChar starting at \a buffer, carrying incomplete sequences
+    over in \a state. The buffer must be at least \a len + 1 QChars long.
 
-    ushort *dst = reinterpret_cast<ushort *>(const_cast<QChar *>(result.constData()));
+    Returns a pointer to one past the last QChar written.
+*/
+QChar *QUtf8::convertToUnicode(QChar *buffer, const char *chars, int len, QTextCodec::ConverterState *state)
+{
+    bool headerdone = false;
+    ushort replacement = QChar::ReplacementCharacter;
+    int invalid = 0;
+    int res;
+    uchar ch = 0;
+
+    ushort *dst = reinterpret_cast<ushort *>(buffer);
     const uchar *src = reinterpret_cast<const uchar *>(chars);
     const uchar *end = src + len;
 
@@ -526,7 +965,7 @@ QString QUtf8::convertToUnicode(const char *chars, int len, QTextCodec::Converte
                 // copy to our state and return
                 state->remainingChars = remainingCharsCount + newCharsToCopy;
                 memcpy(&state->state_data[0], remainingCharsData, state->remainingChars);
-                return QString();
+                return buffer;
             } else if (!headerdone && res >= 0) {
                 // eat the UTF-8 BOM
                 headerdone = true;
@@ -547,7 +986,9 @@ QString QUtf8::convertToUnicode(const char *chars, int len, QTextCodec::Converte
     const uchar *nextAscii = src;
     const uchar *start = src;
     while (res >= 0 && src < end) {
-        if (src >= nextAscii && simdDecodeAscii(dst, nextAscii, src, end))
+        // the UTF-8 BOM is removed by the code below, so leave it to that
+        if (src >= nextAscii && (simdDecodeAscii(dst, nextAscii, src, end)
+                                 || (headerdone && simdDecodeUtf8(dst, nextAscii, src, end))))
             break;
 
         ch = *src++;
@@ -574,7 +1015,6 @@ QString QUtf8::convertToUnicode(const char *chars, int len, QTextCodec::Converte
             *dst++ = QChar::ReplacementCharacter;
     }
 
-    result.truncate(dst - (const ushort *)result.unicode());
     if (state) {
         state->invalidChars += invalid;
         if (headerdone)
@@ -587,7 +1027,7 @@ QString QUtf8::convertToUnicode(const char *chars, int len, QTextCodec::Converte
             state->remainingChars = 0;
         }
     }
-    return result;
+    return reinterpret_cast<QChar *>(dst);
 }
 
 struct QUtf8NoOutputTraits : public QUtf8BaseTraitsNoAscii
@@ -935,7 +1375,11 @@ QByteArray QUtf8Codec::convertFromUnicode(const QChar *uc, int len, ConverterSta
 
 void QUtf8Codec::convertToUnicode(QString *target, const char *chars, int len, ConverterState *state) const
 {
-    *target += QUtf8::convertToUnicode(chars, len, state);
+    // decode straight into the target, without a temporary string
+    const int oldSize = target->size();
+    target->resize(oldSize + len + 1);
+    QChar *end = QUtf8::convertToUnicode(target->data() + oldSize, chars, len, state);
+    target->truncate(end - target->constData());
 }
 
 QString QUtf8Codec::convertToUnicode(const char *chars, int len, ConverterState *state) const
@@ -97,10 +97,10 @@
 #define QT_NO_QOBJECT
 #define QT_FEATURE_process -1
 #define QT_FEATURE_regularexpression -1
-#define QT_FEATURE_renameat2 -1
+#define QT_FEATURE_renameat2 1 // BUILDFIX
 #define QT_FEATURE_sharedmemory -1
 #define QT_FEATURE_slog2 -1
-#define QT_FEATURE_statx -1
+#define QT_FEATURE_statx 1 // BUILDFIX
 #define QT_FEATURE_syslog -1
 #define QT_NO_SYSTEMLOCALE
 #define QT_FEATURE_systemsemaphore -1
@@ -111,6 +111,11 @@
 #define QT_NO_TRANSLATION
 #define QT_FEATURE_translation -1
 
+// rcc.pro overrides this when Qt is configured with Zstandard support
+#ifndef QT_FEATURE_zstd
+#define QT_FEATURE_zstd -1
+#endif
+
 #ifdef QT_BUILD_QMAKE
 #define QT_FEATURE_commandlineparser -1
 #define QT_NO_COMPRESS
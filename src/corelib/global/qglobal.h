@@ -140,6 +140,7 @@
 #ifdef __cplusplus
 
 #include <algorithm>
+#include <limits> // BUILDFIX
 
 #if !defined(QT_NAMESPACE) || defined(Q_MOC_RUN) /* user namespace */
 
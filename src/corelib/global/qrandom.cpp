@@ -135,6 +135,7 @@ enum {
 
 struct QRandomGenerator::SystemGenerator
 {
+    typedef quint32 result_type; // BUILDFIX
 #if QT_CONFIG(getentropy)
     static qsizetype fillBuffer(void *buffer, qsizetype count) Q_DECL_NOTHROW
     {
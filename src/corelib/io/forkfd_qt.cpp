@@ -40,7 +40,10 @@
 // these might be defined via precompiled headers
 #include <QtCore/qatomic.h>
 
-#define FORKFD_NO_SPAWNFD
+// QProcess uses spawnfd() on Linux only; elsewhere forkfd() may use pdfork()
+#if !defined(Q_OS_LINUX) || defined(Q_OS_ANDROID)
+#  define FORKFD_NO_SPAWNFD
+#endif
 
 #if defined(QT_NO_DEBUG) && !defined(NDEBUG)
 #  define NDEBUG
@@ -36,6 +36,7 @@ HEADERS +=  \
         io/qtldurl_p.h \
         io/qsettings.h \
         io/qsettings_p.h \
+        io/qsettingsbinarystore_p.h \
         io/qfsfileengine_p.h \
         io/qfsfileengine_iterator_p.h \
         io/qfilesystemwatcher.h \
@@ -77,6 +78,7 @@ SOURCES += \
         io/qurlquery.cpp \
         io/qurlrecode.cpp \
         io/qsettings.cpp \
+        io/qsettingsbinarystore.cpp \
         io/qfsfileengine.cpp \
         io/qfsfileengine_iterator.cpp \
         io/qfilesystemwatcher.cpp \
@@ -100,6 +102,8 @@ qtConfig(processenvironment) {
         SOURCES += io/qprocess_unix.cpp
 }
 
+qtConfig(zstd): QMAKE_USE_PRIVATE += zstd
+
 win32 {
         SOURCES += io/qfsfileengine_win.cpp
         SOURCES += io/qlockfile_win.cpp
@@ -179,6 +183,11 @@ win32 {
             HEADERS += io/qfilesystemwatcher_inotify_p.h
         }
 
+        linux {
+            SOURCES += io/qfilesystemwatcher_fanotify.cpp
+            HEADERS += io/qfilesystemwatcher_fanotify_p.h
+        }
+
         !nacl {
             freebsd-*|mac|darwin-*|openbsd-*|netbsd-*:{
                 SOURCES += io/qfilesystemwatcher_kqueue.cpp
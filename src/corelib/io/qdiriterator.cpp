@@ -87,6 +87,19 @@
     enables iterating through all subdirectories of the assigned path,
     following all symbolic links. Symbolic link loops (e.g., "link" => "." or
     "link" => "..") are automatically detected and ignored.
+
+    \value Concurrent When combined with Subdirectories, directories are
+    listed on the threads of QThreadPool::globalInstance(), several at a
+    time, while the thread using the iterator consumes the entries found so
+    far. The iterator returns the same entries as without this flag, but in
+    no particular order. This flag is ignored for paths handled by a custom
+    file engine, such as Qt resources. This value was added in Qt 5.12.
+
+    \value PrefetchMetaData Read the size, times, ownership and permissions of
+    each entry while listing its directory, instead of when the QFileInfo is
+    first asked for them. On Unix, this is done relative to the directory
+    being listed; with Concurrent, it is done on the worker threads. This
+    value was added in Qt 5.12.
 */
 
 #include "qdiriterator.h"
@@ -96,6 +109,13 @@
 #include <QtCore/qset.h>
 #include <QtCore/qstack.h>
 #include <QtCore/qvariant.h>
+#ifndef QT_NO_THREAD
+#include <QtCore/qmutex.h>
+#include <QtCore/qqueue.h>
+#include <QtCore/qrunnable.h>
+#include <QtCore/qthreadpool.h>
+#include <QtCore/qwaitcondition.h>
+#endif
 
 #include <QtCore/private/qfilesystemiterator_p.h>
 #include <QtCore/private/qfilesystementry_p.h>
@@ -115,19 +135,73 @@ public:
     }
 };
 
+#if !defined(QT_NO_THREAD) && !defined(QT_NO_FILESYSTEMITERATOR)
+#  define QDIRITERATOR_CONCURRENT
+
+class QDirIteratorPrivate;
+
+class QDirIteratorWorker : public QRunnable
+{
+public:
+    explicit QDirIteratorWorker(QDirIteratorPrivate *d)
+        : d(d), queued(false)
+    { setAutoDelete(false); }
+
+    void run() override;
+
+    QDirIteratorPrivate *d;
+    bool queued; // started on the pool and not yet finished
+};
+
+// State of a QDirIterator::Concurrent iteration. Everything but the
+// consumer's current batch is guarded by the mutex.
+struct QDirIteratorConcurrentState
+{
+    enum {
+        BatchSize = 256,
+        MaxQueuedBatches = 64
+    };
+
+    QMutex mutex;
+    QWaitCondition consumerWait;
+    QWaitCondition producerWait;
+    QVector<QFileInfo> directories; // waiting to be listed, used as a stack
+    QQueue<QVector<QFileInfo> > results;
+    QVector<QDirIteratorWorker *> workers;
+    int listing = 0; // directories being listed right now
+    int running = 0; // workers inside run()
+    bool cancelled = false;
+
+    QVector<QFileInfo> batch;
+    int batchIndex = 0;
+    bool atEnd = false;
+};
+#endif
+
 class QDirIteratorPrivate
 {
 public:
     QDirIteratorPrivate(const QFileSystemEntry &entry, const QStringList &nameFilters,
                         QDir::Filters filters, QDirIterator::IteratorFlags flags, bool resolveEngine = true);
+    ~QDirIteratorPrivate();
 
     void advance();
 
     bool entryMatches(const QString & fileName, const QFileInfo &fileInfo);
     void pushDirectory(const QFileInfo &fileInfo);
+    bool shouldDescend(const QFileInfo &fileInfo) const;
     void checkAndPushDirectory(const QFileInfo &);
     bool matchesFilters(const QString &fileName, const QFileInfo &fi) const;
 
+#ifdef QDIRITERATOR_CONCURRENT
+    void startConcurrent(const QFileInfo &fileInfo);
+    void stopConcurrent();
+    void advanceConcurrent();
+    void listDirectory(const QFileInfo &dirInfo, bool mayWait);
+    bool publish(QVector<QFileInfo> &found, QVector<QFileInfo> &subdirectories,
+                 bool mayWait, bool finished);
+#endif
+
     QScopedPointer<QAbstractFileEngine> engine;
 
     QFileSystemEntry dirEntry;
@@ -149,6 +223,10 @@ public:
 
     // Loop protection
     QSet<QString> visitedLinks;
+
+#ifdef QDIRITERATOR_CONCURRENT
+    QScopedPointer<QDirIteratorConcurrentState> concurrent;
+#endif
 };
 
 /*!
@@ -175,10 +253,26 @@ QDirIteratorPrivate::QDirIteratorPrivate(const QFileSystemEntry &entry, const QS
     QFileInfo fileInfo(new QFileInfoPrivate(dirEntry, metaData));
 
     // Populate fields for hasNext() and next()
-    pushDirectory(fileInfo);
+#ifdef QDIRITERATOR_CONCURRENT
+    if (!engine && (iteratorFlags & QDirIterator::Concurrent))
+        startConcurrent(fileInfo);
+    else
+#endif
+        pushDirectory(fileInfo);
     advance();
 }
 
+/*!
+    \internal
+*/
+QDirIteratorPrivate::~QDirIteratorPrivate()
+{
+#ifdef QDIRITERATOR_CONCURRENT
+    if (concurrent)
+        stopConcurrent();
+#endif
+}
+
 /*!
     \internal
 */
@@ -234,6 +328,13 @@ inline bool QDirIteratorPrivate::entryMatches(const QString & fileName, const QF
 */
 void QDirIteratorPrivate::advance()
 {
+#ifdef QDIRITERATOR_CONCURRENT
+    if (concurrent) {
+        advanceConcurrent();
+        return;
+    }
+#endif
+
     if (engine) {
         while (!fileEngineIterators.isEmpty()) {
             // Find the next valid iterator that matches the filters.
@@ -275,28 +376,42 @@ void QDirIteratorPrivate::advance()
 
 /*!
     \internal
+
+    Returns \c true if the iteration should descend into \a fileInfo, not
+    taking symbolic link loops into account.
  */
-void QDirIteratorPrivate::checkAndPushDirectory(const QFileInfo &fileInfo)
+bool QDirIteratorPrivate::shouldDescend(const QFileInfo &fileInfo) const
 {
     // If we're doing flat iteration, we're done.
     if (!(iteratorFlags & QDirIterator::Subdirectories))
-        return;
+        return false;
 
     // Never follow non-directory entries
     if (!fileInfo.isDir())
-        return;
+        return false;
 
     // Follow symlinks only when asked
     if (!(iteratorFlags & QDirIterator::FollowSymlinks) && fileInfo.isSymLink())
-        return;
+        return false;
 
     // Never follow . and ..
     QString fileName = fileInfo.fileName();
     if (QLatin1String(".") == fileName || QLatin1String("..") == fileName)
-        return;
+        return false;
 
     // No hidden directories unless requested
     if (!(filters & QDir::AllDirs) && !(filters & QDir::Hidden) && fileInfo.isHidden())
+        return false;
+
+    return true;
+}
+
+/*!
+    \internal
+ */
+void QDirIteratorPrivate::checkAndPushDirectory(const QFileInfo &fileInfo)
+{
+    if (!shouldDescend(fileInfo))
         return;
 
     // Stop link loops
@@ -397,6 +512,200 @@ bool QDirIteratorPrivate::matchesFilters(const QString &fileName, const QFileInf
     return true;
 }
 
+#ifdef QDIRITERATOR_CONCURRENT
+/*!
+    \internal
+
+    Sets up a QDirIterator::Concurrent iteration of the directory \a fileInfo.
+    The directories waiting to be listed are shared by the workers and the
+    thread using the iterator, which lists them itself when no worker is
+    running, for instance because the pool is busy.
+*/
+void QDirIteratorPrivate::startConcurrent(const QFileInfo &fileInfo)
+{
+    concurrent.reset(new QDirIteratorConcurrentState);
+    if (iteratorFlags & QDirIterator::FollowSymlinks)
+        visitedLinks << fileInfo.canonicalFilePath();
+    concurrent->directories.append(fileInfo);
+
+    const int workerCount = qMax(1, QThreadPool::globalInstance()->maxThreadCount());
+    concurrent->workers.reserve(workerCount);
+    for (int i = 0; i < workerCount; ++i)
+        concurrent->workers.append(new QDirIteratorWorker(this));
+}
+
+/*!
+    \internal
+
+    Stops the workers and waits for the ones already running to return.
+*/
+void QDirIteratorPrivate::stopConcurrent()
+{
+    QDirIteratorConcurrentState *c = concurrent.data();
+    QThreadPool *pool = QThreadPool::globalInstance();
+    {
+        QMutexLocker locker(&c->mutex);
+        c->cancelled = true;
+        c->directories.clear();
+        c->producerWait.wakeAll();
+        for (QDirIteratorWorker *worker : qAsConst(c->workers)) {
+            if (worker->queued && pool->tryTake(worker))
+                worker->queued = false;
+        }
+        for (QDirIteratorWorker *worker : qAsConst(c->workers)) {
+            while (worker->queued)
+                c->consumerWait.wait(&c->mutex);
+        }
+    }
+    qDeleteAll(c->workers);
+}
+
+void QDirIteratorWorker::run()
+{
+    QDirIteratorConcurrentState *c = d->concurrent.data();
+    QMutexLocker locker(&c->mutex);
+    ++c->running;
+    while (!c->cancelled && !c->directories.isEmpty()) {
+        const QFileInfo dirInfo = c->directories.takeLast();
+        ++c->listing;
+        locker.unlock();
+        d->listDirectory(dirInfo, true);
+        locker.relock();
+    }
+    --c->running;
+    queued = false;
+    c->consumerWait.wakeAll();
+}
+
+/*!
+    \internal
+
+    Lists the directory \a dirInfo, handing the matching entries and the
+    subdirectories to descend into over to the shared state as it goes.
+    Workers pass \c true for \a mayWait, so that they stop when the consumer
+    falls behind.
+*/
+void QDirIteratorPrivate::listDirectory(const QFileInfo &dirInfo, bool mayWait)
+{
+    typedef QDirIteratorConcurrentState State;
+    QVector<QFileInfo> found;
+    QVector<QFileInfo> subdirectories;
+    QFileSystemIterator it(dirInfo.d_ptr->fileEntry, filters, nameFilters, iteratorFlags);
+    QFileSystemEntry entry;
+    QFileSystemMetaData metaData;
+    int seen = 0;
+    while (it.advance(entry, metaData)) {
+        QFileInfo info(new QFileInfoPrivate(entry, metaData));
+        if (shouldDescend(info)) {
+            // resolve it here, not with the lock held in publish()
+            if (iteratorFlags & QDirIterator::FollowSymlinks)
+                info.canonicalFilePath();
+            subdirectories.append(info);
+        }
+        if (matchesFilters(entry.fileName(), info))
+            found.append(info);
+        metaData = QFileSystemMetaData();
+
+        if (++seen % State::BatchSize == 0 || found.size() == State::BatchSize) {
+            if (!publish(found, subdirectories, mayWait, false))
+                break;
+        }
+    }
+    publish(found, subdirectories, mayWait, true);
+}
+
+/*!
+    \internal
+
+    Queues the entries in \a found as a batch for the consumer and the
+    directories in \a subdirectories for listing, then clears both. If
+    \a finished is \c true, the directory they came from has been listed
+    completely. Returns \c false if the iteration has been stopped.
+*/
+bool QDirIteratorPrivate::publish(QVector<QFileInfo> &found, QVector<QFileInfo> &subdirectories,
+                                  bool mayWait, bool finished)
+{
+    QDirIteratorConcurrentState *c = concurrent.data();
+    QMutexLocker locker(&c->mutex);
+
+    // keep the memory use bounded when the consumer is slower than the workers
+    while (mayWait && !c->cancelled && !found.isEmpty()
+           && c->results.size() >= QDirIteratorConcurrentState::MaxQueuedBatches) {
+        c->producerWait.wait(&c->mutex);
+    }
+    if (finished)
+        --c->listing;
+    if (c->cancelled) {
+        c->consumerWait.wakeAll();
+        return false;
+    }
+
+    if (!found.isEmpty()) {
+        c->results.enqueue(found);
+        found.clear();
+    }
+    for (const QFileInfo &dirInfo : qAsConst(subdirectories)) {
+        // Stop link loops
+        if (iteratorFlags & QDirIterator::FollowSymlinks) {
+            const QString canonicalPath = dirInfo.canonicalFilePath();
+            if (visitedLinks.contains(canonicalPath))
+                continue;
+            visitedLinks << canonicalPath;
+        }
+        c->directories.append(dirInfo);
+    }
+    subdirectories.clear();
+
+    int toStart = c->directories.size() - c->running;
+    for (int i = 0; toStart > 0 && i < c->workers.size(); ++i) {
+        QDirIteratorWorker *worker = c->workers.at(i);
+        if (!worker->queued) {
+            worker->queued = true;
+            QThreadPool::globalInstance()->start(worker);
+            --toStart;
+        }
+    }
+
+    c->consumerWait.wakeAll();
+    return true;
+}
+
+/*!
+    \internal
+*/
+void QDirIteratorPrivate::advanceConcurrent()
+{
+    QDirIteratorConcurrentState *c = concurrent.data();
+    currentFileInfo = nextFileInfo;
+
+    for (;;) {
+        if (c->batchIndex < c->batch.size()) {
+            nextFileInfo = c->batch.at(c->batchIndex++);
+            return;
+        }
+        c->batch.clear();
+        c->batchIndex = 0;
+
+        QMutexLocker locker(&c->mutex);
+        if (!c->results.isEmpty()) {
+            c->batch = c->results.dequeue();
+            c->producerWait.wakeAll();
+        } else if (!c->directories.isEmpty() && c->running == 0) {
+            const QFileInfo dirInfo = c->directories.takeLast();
+            ++c->listing;
+            locker.unlock();
+            listDirectory(dirInfo, false);
+        } else if (c->directories.isEmpty() && c->listing == 0) {
+            c->atEnd = true;
+            nextFileInfo = QFileInfo();
+            return;
+        } else {
+            c->consumerWait.wait(&c->mutex);
+        }
+    }
+}
+#endif // QDIRITERATOR_CONCURRENT
+
 /*!
     Constructs a QDirIterator that can iterate over \a dir's entrylist, using
     \a dir's name filters and regular filters. You can pass options via \a
@@ -503,6 +812,10 @@ QString QDirIterator::next()
 */
 bool QDirIterator::hasNext() const
 {
+#ifdef QDIRITERATOR_CONCURRENT
+    if (d->concurrent)
+        return !d->concurrent->atEnd;
+#endif
     if (d->engine)
         return !d->fileEngineIterators.isEmpty();
     else
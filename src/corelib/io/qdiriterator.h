@@ -51,7 +51,9 @@ public:
     enum IteratorFlag {
         NoIteratorFlags = 0x0,
         FollowSymlinks = 0x1,
-        Subdirectories = 0x2
+        Subdirectories = 0x2,
+        Concurrent = 0x4,
+        PrefetchMetaData = 0x8
     };
     Q_DECLARE_FLAGS(IteratorFlags, IteratorFlag)
 
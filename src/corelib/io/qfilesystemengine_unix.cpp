@@ -411,6 +411,9 @@ inline void QFileSystemMetaData::fillFromStatxBuf(const struct statx &statxBuffe
     groupId_ = statxBuffer.stx_gid;
 }
 #else
+static int qt_real_statx(int, const char *, int, struct statx *)
+{ return -ENOSYS; }
+
 static int qt_statx(const char *, struct statx *)
 { return -ENOSYS; }
 
@@ -452,6 +455,70 @@ bool QFileSystemEngine::fillMetaData(int fd, QFileSystemMetaData &data)
     return false;
 }
 
+#ifdef AT_SYMLINK_NOFOLLOW
+#if defined(QT_USE_XOPEN_LFS_EXTENSIONS) && defined(QT_LARGEFILE_SUPPORT)
+#  define QT_FSTATAT ::fstatat64
+#else
+#  define QT_FSTATAT ::fstatat
+#endif
+
+//static
+bool QFileSystemEngine::fillMetaData(int dirFd, const char *fileName, QFileSystemMetaData &data)
+{
+    // This is the lstat(2) and stat(2) part of fillMetaData() below, done
+    // relative to the directory so the kernel doesn't resolve the whole path
+    // again for every entry of a directory being listed.
+    data.entryFlags &= ~(QFileSystemMetaData::PosixStatFlags | QFileSystemMetaData::LinkType
+                         | QFileSystemMetaData::ExistsAttribute);
+    data.knownFlagsMask |= QFileSystemMetaData::PosixStatFlags | QFileSystemMetaData::LinkType
+            | QFileSystemMetaData::ExistsAttribute;
+
+    union {
+        QT_STATBUF statBuffer;
+        struct statx statxBuffer;
+    } buffer;
+    bool usedStatx = false;
+    mode_t mode = 0;
+    auto statAt = [&](int flags) {
+        int ret = qt_real_statx(dirFd, fileName, flags, &buffer.statxBuffer);
+        if (ret == -ENOSYS) {
+            usedStatx = false;
+            if (QT_FSTATAT(dirFd, fileName, &buffer.statBuffer, flags) != 0)
+                return false;
+            mode = buffer.statBuffer.st_mode;
+            return true;
+        }
+        usedStatx = true;
+        mode = buffer.statxBuffer.stx_mode;
+        return ret == 0;
+    };
+
+    bool exists = statAt(AT_SYMLINK_NOFOLLOW);
+    if (exists && S_ISLNK(mode)) {
+        // it's a symlink, we need to know about its target
+        data.entryFlags |= QFileSystemMetaData::LinkType;
+        exists = statAt(0);
+    }
+
+    if (!exists) {
+        data.birthTime_ = 0;
+        data.metadataChangeTime_ = 0;
+        data.modificationTime_ = 0;
+        data.accessTime_ = 0;
+        data.size_ = 0;
+        data.userId_ = (uint) -2;
+        data.groupId_ = (uint) -2;
+        return false;
+    }
+
+    if (usedStatx)
+        data.fillFromStatxBuf(buffer.statxBuffer);
+    else
+        data.fillFromStatBuf(buffer.statBuffer);
+    return true;
+}
+#endif // AT_SYMLINK_NOFOLLOW
+
 #if defined(_DEXTRA_FIRST)
 static void fillStat64fromStat32(struct stat64 *statBuf64, const struct stat &statBuf32)
 {
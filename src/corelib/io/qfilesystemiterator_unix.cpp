@@ -39,6 +39,7 @@
 
 #include "qplatformdefs.h"
 #include "qfilesystemiterator_p.h"
+#include "qfilesystemengine_p.h"
 
 #ifndef QT_NO_FILESYSTEMITERATOR
 
@@ -53,10 +54,10 @@ QFileSystemIterator::QFileSystemIterator(const QFileSystemEntry &entry, QDir::Fi
     , dir(0)
     , dirEntry(0)
     , lastError(0)
+    , prefetchMetaData(flags & QDirIterator::PrefetchMetaData)
 {
     Q_UNUSED(filters)
     Q_UNUSED(nameFilters)
-    Q_UNUSED(flags)
 
     if ((dir = QT_OPENDIR(nativePath.constData())) == 0) {
         lastError = errno;
@@ -85,6 +86,13 @@ bool QFileSystemIterator::advance(QFileSystemEntry &fileEntry, QFileSystemMetaDa
             if (QFile::encodeName(QFile::decodeName(dirEntry->d_name)) == dirEntry->d_name) {
                 fileEntry = QFileSystemEntry(nativePath + QByteArray(dirEntry->d_name), QFileSystemEntry::FromNativePath());
                 metaData.fillFromDirEnt(*dirEntry);
+#ifdef AT_SYMLINK_NOFOLLOW
+                // Symlinks and file systems that don't report the type in the
+                // directory entry need a stat anyway for QDirIterator's
+                // filters; do that one relative to the directory.
+                if (prefetchMetaData || !metaData.hasFlags(QFileSystemMetaData::DirectoryType))
+                    QFileSystemEngine::fillMetaData(dirfd(dir), dirEntry->d_name, metaData);
+#endif
                 return true;
             }
         } else {
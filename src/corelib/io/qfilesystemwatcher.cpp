@@ -52,12 +52,18 @@
 #if defined(Q_OS_LINUX) || (defined(Q_OS_QNX) && !defined(QT_NO_INOTIFY))
 #define USE_INOTIFY
 #endif
+#if defined(Q_OS_LINUX)
+#define USE_FANOTIFY
+#endif
 
 #include "qfilesystemwatcher_polling_p.h"
 #if defined(Q_OS_WIN)
 #  include "qfilesystemwatcher_win_p.h"
 #elif defined(USE_INOTIFY)
 #  include "qfilesystemwatcher_inotify_p.h"
+#  if defined(USE_FANOTIFY)
+#    include "qfilesystemwatcher_fanotify_p.h"
+#  endif
 #elif defined(Q_OS_FREEBSD) || defined(Q_OS_NETBSD) || defined(Q_OS_OPENBSD) || defined(QT_PLATFORM_UIKIT)
 #  include "qfilesystemwatcher_kqueue_p.h"
 #elif defined(Q_OS_OSX)
@@ -88,7 +94,7 @@ QFileSystemWatcherEngine *QFileSystemWatcherPrivate::createNativeEngine(QObject
 }
 
 QFileSystemWatcherPrivate::QFileSystemWatcherPrivate()
-    : native(0), poller(0)
+    : native(0), poller(0), fanotify(0), coalescingTimer(0), coalescingInterval(0)
 {
 }
 
@@ -105,6 +111,7 @@ void QFileSystemWatcherPrivate::init()
                          SIGNAL(directoryChanged(QString,bool)),
                          q,
                          SLOT(_q_directoryChanged(QString,bool)));
+        connectTreeEngine(native);
 #if defined(Q_OS_WIN) && !defined(Q_OS_WINRT)
         QObject::connect(static_cast<QWindowsFileSystemWatcherEngine *>(native),
                          &QWindowsFileSystemWatcherEngine::driveLockForRemoval,
@@ -136,6 +143,28 @@ void QFileSystemWatcherPrivate::initPollerEngine()
                      SLOT(_q_directoryChanged(QString,bool)));
 }
 
+void QFileSystemWatcherPrivate::connectTreeEngine(QFileSystemWatcherEngine *engine)
+{
+    Q_Q(QFileSystemWatcher);
+    QObject::connect(engine, &QFileSystemWatcherEngine::treeChanged, q,
+                     [this] (QFileSystemWatcher::Change change, const QString &path,
+                             const QString &oldPath) {
+                         _q_treeChanged(change, path, oldPath);
+                     });
+}
+
+bool QFileSystemWatcherPrivate::isInTree(const QString &path) const
+{
+    for (const QString &tree : trees) {
+        if (path.startsWith(tree)
+            && (path.size() == tree.size() || tree.endsWith(QLatin1Char('/'))
+                || path.at(tree.size()) == QLatin1Char('/'))) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void QFileSystemWatcherPrivate::_q_fileChanged(const QString &path, bool removed)
 {
     Q_Q(QFileSystemWatcher);
@@ -160,6 +189,74 @@ void QFileSystemWatcherPrivate::_q_directoryChanged(const QString &path, bool re
     emit q->directoryChanged(path, QFileSystemWatcher::QPrivateSignal());
 }
 
+void QFileSystemWatcherPrivate::_q_treeChanged(QFileSystemWatcher::Change change,
+                                               const QString &path, const QString &oldPath)
+{
+    Q_Q(QFileSystemWatcher);
+
+    // Merge the change with the one still pending for the same path, if any.
+    // Renames are kept as they are and end the sequence for both paths.
+    const auto it = pendingChangeIndex.constFind(path);
+    if (change != QFileSystemWatcher::Renamed && it != pendingChangeIndex.constEnd()) {
+        PendingChange &pending = pendingChanges[*it];
+        switch (pending.change) {
+        case QFileSystemWatcher::Created:
+            if (change == QFileSystemWatcher::Removed) {
+                pending.path.clear();
+                pendingChangeIndex.erase(it);
+            }
+            break;
+        case QFileSystemWatcher::Modified:
+            if (change == QFileSystemWatcher::Removed)
+                pending.change = QFileSystemWatcher::Removed;
+            break;
+        case QFileSystemWatcher::Removed:
+            if (change == QFileSystemWatcher::Created)
+                pending.change = QFileSystemWatcher::Modified;
+            break;
+        case QFileSystemWatcher::Renamed:
+            Q_UNREACHABLE();
+        }
+        return;
+    }
+
+    if (change == QFileSystemWatcher::Renamed) {
+        pendingChangeIndex.remove(oldPath);
+        pendingChangeIndex.remove(path);
+    } else {
+        pendingChangeIndex.insert(path, pendingChanges.size());
+    }
+    pendingChanges.append({ change, path, oldPath });
+
+    if (!coalescingTimer) {
+        coalescingTimer = new QTimer(q);
+        coalescingTimer->setSingleShot(true);
+        QObject::connect(coalescingTimer, &QTimer::timeout, q, [this] () { _q_flushTreeChanges(); });
+    }
+    if (!coalescingTimer->isActive())
+        coalescingTimer->start(coalescingInterval);
+}
+
+void QFileSystemWatcherPrivate::_q_flushTreeChanges()
+{
+    Q_Q(QFileSystemWatcher);
+    const QVector<PendingChange> changes = std::move(pendingChanges);
+    pendingChanges.clear();
+    pendingChangeIndex.clear();
+
+    for (const PendingChange &pending : changes) {
+        // the tree may have been removed after the change was detected
+        if (pending.path.isEmpty() || !isInTree(pending.path))
+            continue;
+        if (pending.change == QFileSystemWatcher::Removed && trees.contains(pending.path)) {
+            // the engine has stopped watching it
+            trees.removeAll(pending.path);
+        }
+        emit q->treeChanged(pending.change, pending.path, pending.oldPath,
+                            QFileSystemWatcher::QPrivateSignal());
+    }
+}
+
 #if defined(Q_OS_WIN) && !defined(Q_OS_WINRT)
 
 void QFileSystemWatcherPrivate::_q_winDriveLockForRemoval(const QString &path)
@@ -249,6 +346,25 @@ void  QFileSystemWatcherPrivate::_q_winDriveRemoved(const QString &path)
     \endlist
     \endlist
 
+    \section1 Watching Directory Trees
+
+    Call addTree() to watch a directory and everything below it. Rather
+    than a bare directoryChanged(), the treeChanged() signal then reports
+    which entry was created, removed, modified or renamed, so there is
+    no need to list the directory again to find out. Changes arriving in
+    quick succession are merged before the signal is emitted: for
+    instance, a file that is created and removed again is not reported at
+    all. The coalescingInterval() property controls how long changes are
+    collected.
+
+    On Linux, when the process is allowed to use fanotify for a whole
+    file system (this usually requires the \c CAP_SYS_ADMIN capability and
+    Linux 5.9 or later), a single mark per file system reports all changes
+    in the trees on it, so the cost does not depend on the size of the
+    trees. Otherwise one inotify watch is used per directory in the tree,
+    which counts against the \c fs.inotify.max_user_watches limit.
+    Watching trees is currently not supported on other platforms.
+
     \sa QFile, QDir
 */
 
@@ -466,6 +582,42 @@ QStringList QFileSystemWatcher::removePaths(const QStringList &paths)
     \sa fileChanged()
 */
 
+/*!
+    \enum QFileSystemWatcher::Change
+    \since 5.12
+
+    This enum describes a change reported by treeChanged().
+
+    \value Created     The entry was created, or moved into the tree.
+    \value Removed     The entry was removed, or moved out of the tree.
+    \value Modified    The contents or the attributes of the entry changed,
+                       or it was replaced by a new entry of the same name.
+    \value Renamed     The entry was moved within the tree. The new path is
+                       reported along with the old one.
+*/
+
+/*!
+    \fn void QFileSystemWatcher::treeChanged(QFileSystemWatcher::Change change, const QString &path, const QString &oldPath)
+    \since 5.12
+
+    This signal is emitted when the entry at \a path in one of the trees
+    passed to addTree() is changed as described by \a change. If
+    \a change is Renamed, \a oldPath holds the previous path of the
+    entry; otherwise it is empty.
+
+    When a directory is created in, or moved into a watched tree, the
+    signal is also emitted for each entry already inside it. Those entries
+    are listed from the event loop, a few directories at a time, so an
+    entry that changes meanwhile may be reported as created twice.
+
+    If more changes happen at once than the operating system can queue,
+    the individual changes are lost. The signal is then emitted with
+    Modified for the root of each watched tree, and clients should list
+    the trees again.
+
+    \sa addTree(), coalescingInterval()
+*/
+
 /*!
     \fn QStringList QFileSystemWatcher::directories() const
 
@@ -494,6 +646,123 @@ QStringList QFileSystemWatcher::files() const
     return d->files;
 }
 
+/*!
+    \since 5.12
+
+    Starts watching \a directory and all the files and directories below
+    it. Subdirectories created later are watched as well.
+
+    Changes are reported with the treeChanged() signal, after being
+    merged for coalescingInterval() milliseconds. If \a directory itself
+    is removed or moved away, treeChanged() is emitted for it with
+    Removed and the tree is no longer watched.
+
+    Returns \c true if the tree is being watched. Returns \c false if
+    \a directory does not exist, if it is part of a watched tree or
+    contains one, or if watching trees is not supported on this platform.
+
+    \sa removeTree(), trees(), addPath()
+*/
+bool QFileSystemWatcher::addTree(const QString &directory)
+{
+    Q_D(QFileSystemWatcher);
+
+    if (directory.isEmpty()) {
+        qWarning("QFileSystemWatcher::addTree: path is empty");
+        return false;
+    }
+    if (d->isInTree(directory))
+        return false;
+    for (const QString &tree : qAsConst(d->trees)) {
+        if (tree.startsWith(directory + QLatin1Char('/')))
+            return false;
+    }
+
+    QStringList p(directory);
+    const QString on = objectName();
+    const bool forced = on.startsWith(QLatin1String("_qt_autotest_force_engine_"));
+    const QStringRef forceName = on.midRef(26);
+
+#ifdef USE_FANOTIFY
+    if (!forced || forceName == QLatin1String("fanotify")) {
+        if (!d->fanotify) {
+            d->fanotify = QFanotifyFileSystemWatcherEngine::create(this);
+            if (d->fanotify)
+                d->connectTreeEngine(d->fanotify);
+        }
+        if (d->fanotify)
+            p = d->fanotify->addTrees(p, &d->trees);
+    }
+#endif
+    if (!p.isEmpty() && d->native && (!forced || forceName == QLatin1String("native")))
+        p = d->native->addTrees(p, &d->trees);
+
+    return p.isEmpty();
+}
+
+/*!
+    \since 5.12
+
+    Stops watching the tree rooted at \a directory, which must have been
+    passed to addTree() before. Returns \c true on success.
+
+    \sa addTree(), trees()
+*/
+bool QFileSystemWatcher::removeTree(const QString &directory)
+{
+    Q_D(QFileSystemWatcher);
+
+    if (directory.isEmpty()) {
+        qWarning("QFileSystemWatcher::removeTree: path is empty");
+        return false;
+    }
+
+    QStringList p(directory);
+    if (d->fanotify)
+        p = d->fanotify->removeTrees(p, &d->trees);
+    if (!p.isEmpty() && d->native)
+        p = d->native->removeTrees(p, &d->trees);
+
+    return p.isEmpty();
+}
+
+/*!
+    \since 5.12
+
+    Returns the directories passed to addTree() whose trees are being
+    watched.
+
+    \sa addTree(), removeTree()
+*/
+QStringList QFileSystemWatcher::trees() const
+{
+    Q_D(const QFileSystemWatcher);
+    return d->trees;
+}
+
+/*!
+    \property QFileSystemWatcher::coalescingInterval
+    \since 5.12
+
+    This property holds how long, in milliseconds, changes in watched
+    trees are collected and merged before treeChanged() is emitted for
+    them.
+
+    The default value of 0 merges the changes that have been detected by
+    the time control returns to the event loop.
+*/
+int QFileSystemWatcher::coalescingInterval() const
+{
+    Q_D(const QFileSystemWatcher);
+    return d->coalescingInterval;
+}
+
+void QFileSystemWatcher::setCoalescingInterval(int msecs)
+{
+    Q_D(QFileSystemWatcher);
+    d->coalescingInterval = qMax(0, msecs);
+}
+
 QT_END_NAMESPACE
 
 #include "moc_qfilesystemwatcher.cpp"
@@ -53,8 +53,17 @@ class Q_CORE_EXPORT QFileSystemWatcher : public QObject
 {
     Q_OBJECT
     Q_DECLARE_PRIVATE(QFileSystemWatcher)
+    Q_PROPERTY(int coalescingInterval READ coalescingInterval WRITE setCoalescingInterval)
 
 public:
+    enum Change {
+        Created,
+        Removed,
+        Modified,
+        Renamed
+    };
+    Q_ENUM(Change)
+
     QFileSystemWatcher(QObject *parent = nullptr);
     QFileSystemWatcher(const QStringList &paths, QObject *parent = nullptr);
     ~QFileSystemWatcher();
@@ -67,9 +76,18 @@ public:
     QStringList files() const;
     QStringList directories() const;
 
+    bool addTree(const QString &directory);
+    bool removeTree(const QString &directory);
+    QStringList trees() const;
+
+    int coalescingInterval() const;
+    void setCoalescingInterval(int msecs);
+
 Q_SIGNALS:
     void fileChanged(const QString &path, QPrivateSignal);
     void directoryChanged(const QString &path, QPrivateSignal);
+    void treeChanged(QFileSystemWatcher::Change change, const QString &path,
+                     const QString &oldPath, QPrivateSignal);
 
 private:
     Q_PRIVATE_SLOT(d_func(), void _q_fileChanged(const QString &path, bool removed))
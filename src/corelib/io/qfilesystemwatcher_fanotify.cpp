@@ -0,0 +1,440 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qplatformdefs.h"
+#include "qfilesystemwatcher.h"
+#include "qfilesystemwatcher_fanotify_p.h"
+
+#ifndef QT_NO_FILESYSTEMWATCHER
+
+#include "private/qcore_unix_p.h"
+
+#include <qdebug.h>
+#include <qdiriterator.h>
+#include <qfile.h>
+#include <qfileinfo.h>
+
+#include <sys/fanotify.h>
+#include <sys/statfs.h>
+#include <fcntl.h>
+#include <limits.h>
+
+// the following values are documented in linux/fanotify.h; reporting
+// directory file handles and entry names needs Linux 5.9
+#ifndef FAN_ATTRIB
+#  define FAN_ATTRIB            0x00000004
+#endif
+#ifndef FAN_MOVED_FROM
+#  define FAN_MOVED_FROM        0x00000040
+#  define FAN_MOVED_TO          0x00000080
+#endif
+#ifndef FAN_CREATE
+#  define FAN_CREATE            0x00000100
+#  define FAN_DELETE            0x00000200
+#endif
+#ifndef FAN_REPORT_DIR_FID
+#  define FAN_REPORT_DIR_FID    0x00000400
+#endif
+#ifndef FAN_REPORT_NAME
+#  define FAN_REPORT_NAME       0x00000800
+#endif
+#ifndef FAN_MARK_FILESYSTEM
+#  define FAN_MARK_FILESYSTEM   0x00000100
+#endif
+
+QT_BEGIN_NAMESPACE
+
+enum {
+    EventInfoTypeDirectoryFidName = 2 // FAN_EVENT_INFO_TYPE_DFID_NAME
+};
+
+// struct fanotify_event_info_fid, which older headers don't have
+struct QFanotifyEventInfoFid
+{
+    quint8 infoType;
+    quint8 pad;
+    quint16 len;
+    qint32 fsid[2];
+    // followed by a struct file_handle and the entry name
+};
+
+static const quint64 watchMask = FAN_ONDIR
+        | FAN_CREATE | FAN_DELETE | FAN_MODIFY | FAN_ATTRIB | FAN_MOVED_FROM | FAN_MOVED_TO;
+
+static bool isWithin(const QString &path, const QString &directory)
+{
+    return path.startsWith(directory)
+            && (path.size() == directory.size() || directory.endsWith(QLatin1Char('/'))
+                || path.at(directory.size()) == QLatin1Char('/'));
+}
+
+QFanotifyFileSystemWatcherEngine *QFanotifyFileSystemWatcherEngine::create(QObject *parent)
+{
+    // fails without CAP_SYS_ADMIN, or with kernels that can't report names
+    int fd = fanotify_init(FAN_CLASS_NOTIF | FAN_CLOEXEC | FAN_NONBLOCK
+                           | FAN_REPORT_DIR_FID | FAN_REPORT_NAME,
+                           O_RDONLY | O_CLOEXEC | O_LARGEFILE);
+    if (fd == -1)
+        return 0;
+    return new QFanotifyFileSystemWatcherEngine(fd, parent);
+}
+
+QFanotifyFileSystemWatcherEngine::QFanotifyFileSystemWatcherEngine(int fd, QObject *parent)
+    : QFileSystemWatcherEngine(parent),
+      fanotifyFd(fd),
+      notifier(fd, QSocketNotifier::Read, this),
+      crawlTimer(this)
+{
+    connect(&notifier, SIGNAL(activated(int)), SLOT(readFromFanotify()));
+    crawlTimer.setSingleShot(true);
+    connect(&crawlTimer, SIGNAL(timeout()), SLOT(crawlPendingDirectories()));
+}
+
+QFanotifyFileSystemWatcherEngine::~QFanotifyFileSystemWatcherEngine()
+{
+    notifier.setEnabled(false);
+    for (const FileSystem &fileSystem : qAsConst(fileSystems))
+        qt_safe_close(fileSystem.mountFd);
+    qt_safe_close(fanotifyFd);
+}
+
+QStringList QFanotifyFileSystemWatcherEngine::addPaths(const QStringList &paths, QStringList *files,
+                                                       QStringList *directories)
+{
+    Q_UNUSED(files);
+    Q_UNUSED(directories);
+    return paths;
+}
+
+QStringList QFanotifyFileSystemWatcherEngine::removePaths(const QStringList &paths, QStringList *files,
+                                                          QStringList *directories)
+{
+    Q_UNUSED(files);
+    Q_UNUSED(directories);
+    return paths;
+}
+
+QStringList QFanotifyFileSystemWatcherEngine::addTrees(const QStringList &paths, QStringList *treeList)
+{
+    // directories moved while no tree contained them may be cached with
+    // their old paths, see reportMove()
+    directoryCache.clear();
+
+    QStringList p = paths;
+    QMutableListIterator<QString> it(p);
+    while (it.hasNext()) {
+        const QString &path = it.next();
+        const QFileInfo info(path);
+        if (!info.isDir())
+            continue;
+
+        int dirFd = qt_safe_open(QFile::encodeName(path), O_RDONLY | O_DIRECTORY);
+        if (dirFd < 0)
+            continue;
+        struct statfs fileSystemInfo;
+        if (::fstatfs(dirFd, &fileSystemInfo) != 0) {
+            qt_safe_close(dirFd);
+            continue;
+        }
+        quint64 fsid;
+        memcpy(&fsid, &fileSystemInfo.f_fsid, sizeof(fsid));
+
+        // one mark covers every tree on the file system
+        auto fileSystem = fileSystems.find(fsid);
+        if (fileSystem == fileSystems.end()) {
+            if (::fanotify_mark(fanotifyFd, FAN_MARK_ADD | FAN_MARK_FILESYSTEM, watchMask,
+                                dirFd, 0) != 0) {
+                qt_safe_close(dirFd);
+                continue;
+            }
+            fileSystem = fileSystems.insert(fsid, { dirFd, 0 });
+        } else {
+            qt_safe_close(dirFd);
+        }
+        ++fileSystem->trees;
+
+        trees.append({ path, info.canonicalFilePath(), fsid });
+        treeList->append(path);
+        it.remove();
+    }
+    return p;
+}
+
+QStringList QFanotifyFileSystemWatcherEngine::removeTrees(const QStringList &paths, QStringList *treeList)
+{
+    QStringList p = paths;
+    QMutableListIterator<QString> it(p);
+    while (it.hasNext()) {
+        const QString &path = it.next();
+        for (int i = 0; i < trees.size(); ++i) {
+            if (trees.at(i).path == path) {
+                removeTree(i);
+                treeList->removeAll(path);
+                it.remove();
+                break;
+            }
+        }
+    }
+    return p;
+}
+
+void QFanotifyFileSystemWatcherEngine::removeTree(int tree)
+{
+    const QString &canonicalPath = trees.at(tree).canonicalPath;
+    for (auto it = pendingCrawls.begin(); it != pendingCrawls.end(); ) {
+        if (isWithin(*it, canonicalPath))
+            it = pendingCrawls.erase(it);
+        else
+            ++it;
+    }
+
+    const auto fileSystem = fileSystems.find(trees.at(tree).fsid);
+    if (--fileSystem->trees == 0) {
+        ::fanotify_mark(fanotifyFd, FAN_MARK_REMOVE | FAN_MARK_FILESYSTEM, watchMask,
+                        fileSystem->mountFd, 0);
+        qt_safe_close(fileSystem->mountFd);
+        fileSystems.erase(fileSystem);
+    }
+    trees.remove(tree);
+}
+
+int QFanotifyFileSystemWatcherEngine::treeOf(const QString &canonicalPath) const
+{
+    for (int i = 0; i < trees.size(); ++i) {
+        if (isWithin(canonicalPath, trees.at(i).canonicalPath))
+            return i;
+    }
+    return -1;
+}
+
+// Returns whether \a canonicalPath is in a tree or contains one.
+bool QFanotifyFileSystemWatcherEngine::touchesTree(const QString &canonicalPath) const
+{
+    for (const Tree &tree : trees) {
+        if (isWithin(canonicalPath, tree.canonicalPath) || isWithin(tree.canonicalPath, canonicalPath))
+            return true;
+    }
+    return false;
+}
+
+// Maps a path reported by the kernel back to the path the tree was added with.
+QString QFanotifyFileSystemWatcherEngine::treePath(int tree, const QString &canonicalPath) const
+{
+    const Tree &t = trees.at(tree);
+    return t.path + canonicalPath.midRef(t.canonicalPath.size());
+}
+
+// Returns the path of the directory identified by \a handle, which starts
+// with the file system ID. Resolving it is the only cost per event, so the
+// result is cached until a directory is moved or removed.
+QString QFanotifyFileSystemWatcherEngine::directoryFromHandle(quint64 fsid, const QByteArray &handle)
+{
+    const auto cached = directoryCache.constFind(handle);
+    if (cached != directoryCache.constEnd())
+        return *cached;
+
+    const auto fileSystem = fileSystems.constFind(fsid);
+    if (fileSystem == fileSystems.constEnd())
+        return QString();
+
+    QByteArray fileHandle = handle.mid(sizeof(fsid));
+    int fd = ::open_by_handle_at(fileSystem->mountFd,
+                                 reinterpret_cast<struct file_handle *>(fileHandle.data()),
+                                 O_PATH | O_CLOEXEC);
+    if (fd < 0)
+        return QString(); // removed in the meantime
+
+    char buffer[PATH_MAX];
+    const ssize_t len = ::readlink(QByteArray("/proc/self/fd/" + QByteArray::number(fd)).constData(),
+                                   buffer, sizeof(buffer));
+    qt_safe_close(fd);
+    if (len <= 0)
+        return QString();
+
+    const QString directory = QFile::decodeName(QByteArray(buffer, int(len)));
+    if (directoryCache.size() >= 4096)
+        directoryCache.clear();
+    directoryCache.insert(handle, directory);
+    return directory;
+}
+
+void QFanotifyFileSystemWatcherEngine::reportChange(QFileSystemWatcher::Change change,
+                                                   const QString &canonicalPath, bool isDir)
+{
+    const int tree = treeOf(canonicalPath);
+    if (tree < 0)
+        return;
+    if (isDir && change == QFileSystemWatcher::Removed)
+        directoryCache.clear();
+
+    emit treeChanged(change, treePath(tree, canonicalPath), QString());
+    if (change == QFileSystemWatcher::Removed && canonicalPath == trees.at(tree).canonicalPath)
+        removeTree(tree);
+}
+
+void QFanotifyFileSystemWatcherEngine::reportMove(const QString &from, const QString &to, bool isDir)
+{
+    // The cached paths of the directories below a moved one are stale.
+    // That only matters for paths in the trees: addTrees() drops the cache
+    // for directories that are moved into a tree later.
+    if (isDir && ((!from.isEmpty() && touchesTree(from)) || (!to.isEmpty() && touchesTree(to))))
+        directoryCache.clear();
+
+    const int fromTree = from.isEmpty() ? -1 : treeOf(from);
+    const int toTree = to.isEmpty() ? -1 : treeOf(to);
+    if (fromTree >= 0 && fromTree == toTree && from != trees.at(fromTree).canonicalPath) {
+        emit treeChanged(QFileSystemWatcher::Renamed, treePath(toTree, to), treePath(fromTree, from));
+        for (QString &directory : pendingCrawls) {
+            if (isWithin(directory, from))
+                directory = to + directory.midRef(from.size());
+        }
+        return;
+    }
+
+    if (fromTree >= 0)
+        reportChange(QFileSystemWatcher::Removed, from, isDir);
+    if (toTree >= 0) {
+        reportChange(QFileSystemWatcher::Created, to, isDir);
+        if (isDir) {
+            // nothing was reported while its contents were outside the tree
+            pendingCrawls.append(to);
+            if (!crawlTimer.isActive())
+                crawlTimer.start(0);
+        }
+    }
+}
+
+// Reports the entries below the directories moved into the trees as
+// created, a few directories at a time so that moving a large tree in
+// does not block the event loop.
+void QFanotifyFileSystemWatcherEngine::crawlPendingDirectories()
+{
+    for (int i = 0; i < 16 && !pendingCrawls.isEmpty(); ++i) {
+        QDirIterator it(pendingCrawls.takeFirst(),
+                        QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System);
+        while (it.hasNext()) {
+            const QString path = it.next();
+            const QFileInfo info = it.fileInfo();
+            reportChange(QFileSystemWatcher::Created, path, false);
+            if (info.isDir() && !info.isSymLink())
+                pendingCrawls.append(path);
+        }
+    }
+    if (!pendingCrawls.isEmpty())
+        crawlTimer.start(0);
+}
+
+void QFanotifyFileSystemWatcherEngine::readFromFanotify()
+{
+    // the kernel queues the two halves of a rename one after the other
+    QString movedFrom;
+    bool movedFromIsDir = false;
+
+    alignas(struct fanotify_event_metadata) char buffer[16384];
+    for (;;) {
+        ssize_t len = qt_safe_read(fanotifyFd, buffer, sizeof(buffer));
+        if (len <= 0)
+            break;
+
+        const struct fanotify_event_metadata *event =
+                reinterpret_cast<const struct fanotify_event_metadata *>(buffer);
+        for ( ; FAN_EVENT_OK(event, len); event = FAN_EVENT_NEXT(event, len)) {
+            if (event->fd >= 0)
+                qt_safe_close(event->fd);
+            if (event->mask & FAN_Q_OVERFLOW) {
+                // all that can be said is that something in the trees changed
+                directoryCache.clear();
+                for (int i = 0; i < trees.size(); ++i)
+                    emit treeChanged(QFileSystemWatcher::Modified, trees.at(i).path, QString());
+                continue;
+            }
+
+            const char *at = reinterpret_cast<const char *>(event) + event->metadata_len;
+            const QFanotifyEventInfoFid *info = reinterpret_cast<const QFanotifyEventInfoFid *>(at);
+            if (event->event_len < event->metadata_len + sizeof(QFanotifyEventInfoFid) + sizeof(struct file_handle)
+                || info->infoType != EventInfoTypeDirectoryFidName) {
+                continue;
+            }
+            const struct file_handle *handle =
+                    reinterpret_cast<const struct file_handle *>(at + sizeof(QFanotifyEventInfoFid));
+            const char *name = reinterpret_cast<const char *>(handle->f_handle) + handle->handle_bytes;
+
+            quint64 fsid;
+            memcpy(&fsid, info->fsid, sizeof(fsid));
+            QByteArray key(reinterpret_cast<const char *>(&fsid), sizeof(fsid));
+            key.append(reinterpret_cast<const char *>(handle), sizeof(struct file_handle) + handle->handle_bytes);
+            const QString directory = directoryFromHandle(fsid, key);
+            if (directory.isEmpty() || qstrcmp(name, ".") == 0)
+                continue;
+            QString path = directory;
+            if (!path.endsWith(QLatin1Char('/')))
+                path += QLatin1Char('/');
+            path += QFile::decodeName(name);
+            const bool isDir = event->mask & FAN_ONDIR;
+
+            if (!movedFrom.isEmpty() && !(event->mask & FAN_MOVED_TO)) {
+                reportMove(movedFrom, QString(), movedFromIsDir);
+                movedFrom.clear();
+            }
+            if (event->mask & FAN_CREATE)
+                reportChange(QFileSystemWatcher::Created, path, isDir);
+            if (event->mask & (FAN_MODIFY | FAN_ATTRIB))
+                reportChange(QFileSystemWatcher::Modified, path, isDir);
+            if (event->mask & FAN_MOVED_TO) {
+                reportMove(movedFrom, path, isDir);
+                movedFrom.clear();
+            }
+            if (event->mask & FAN_MOVED_FROM) {
+                movedFrom = path;
+                movedFromIsDir = isDir;
+            }
+            if (event->mask & FAN_DELETE)
+                reportChange(QFileSystemWatcher::Removed, path, isDir);
+        }
+    }
+
+    if (!movedFrom.isEmpty())
+        reportMove(movedFrom, QString(), movedFromIsDir);
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qfilesystemwatcher_fanotify_p.cpp"
+
+#endif // QT_NO_FILESYSTEMWATCHER
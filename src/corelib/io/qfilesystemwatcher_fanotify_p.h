@@ -0,0 +1,119 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QFILESYSTEMWATCHER_FANOTIFY_P_H
+#define QFILESYSTEMWATCHER_FANOTIFY_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qfilesystemwatcher_p.h"
+
+#ifndef QT_NO_FILESYSTEMWATCHER
+
+#include <QtCore/qhash.h>
+#include <QtCore/qsocketnotifier.h>
+#include <QtCore/qtimer.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+// Watches whole trees with one fanotify mark per file system. It only
+// implements the tree part of the engine interface.
+class QFanotifyFileSystemWatcherEngine : public QFileSystemWatcherEngine
+{
+    Q_OBJECT
+
+public:
+    ~QFanotifyFileSystemWatcherEngine();
+
+    static QFanotifyFileSystemWatcherEngine *create(QObject *parent);
+
+    QStringList addPaths(const QStringList &paths, QStringList *files, QStringList *directories) override;
+    QStringList removePaths(const QStringList &paths, QStringList *files, QStringList *directories) override;
+    QStringList addTrees(const QStringList &paths, QStringList *trees) override;
+    QStringList removeTrees(const QStringList &paths, QStringList *trees) override;
+
+private Q_SLOTS:
+    void readFromFanotify();
+    void crawlPendingDirectories();
+
+private:
+    struct Tree
+    {
+        QString path;
+        QString canonicalPath;
+        quint64 fsid;
+    };
+    struct FileSystem
+    {
+        int mountFd; // any directory on it, for open_by_handle_at()
+        int trees;
+    };
+
+    QFanotifyFileSystemWatcherEngine(int fd, QObject *parent);
+    QString directoryFromHandle(quint64 fsid, const QByteArray &handle);
+    int treeOf(const QString &canonicalPath) const;
+    bool touchesTree(const QString &canonicalPath) const;
+    QString treePath(int tree, const QString &canonicalPath) const;
+    void removeTree(int tree);
+    void reportChange(QFileSystemWatcher::Change change, const QString &canonicalPath, bool isDir);
+    void reportMove(const QString &from, const QString &to, bool isDir);
+
+    int fanotifyFd;
+    QVector<Tree> trees;
+    QHash<quint64, FileSystem> fileSystems;
+    QHash<QByteArray, QString> directoryCache;
+    // directories moved into the trees whose entries have not been reported yet
+    QStringList pendingCrawls;
+    QSocketNotifier notifier;
+    QTimer crawlTimer;
+};
+
+QT_END_NAMESPACE
+#endif // QT_NO_FILESYSTEMWATCHER
+#endif // QFILESYSTEMWATCHER_FANOTIFY_P_H
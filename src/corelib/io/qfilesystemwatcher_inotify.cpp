@@ -46,6 +46,7 @@
 #include "private/qsystemerror_p.h"
 
 #include <qdebug.h>
+#include <qdiriterator.h>
 #include <qfile.h>
 #include <qfileinfo.h>
 #include <qsocketnotifier.h>
@@ -210,6 +211,10 @@ struct inotify_event {
 #define IN_Q_OVERFLOW           0x00004000
 #define IN_IGNORED              0x00008000
 
+#define IN_ONLYDIR              0x01000000
+#define IN_MASK_ADD             0x20000000
+#define IN_ISDIR                0x40000000
+
 #define IN_CLOSE                (IN_CLOSE_WRITE | IN_CLOSE_NOWRITE)
 #define IN_MOVE                 (IN_MOVED_FROM | IN_MOVED_TO)
 }
@@ -251,10 +256,13 @@ QInotifyFileSystemWatcherEngine *QInotifyFileSystemWatcherEngine::create(QObject
 QInotifyFileSystemWatcherEngine::QInotifyFileSystemWatcherEngine(int fd, QObject *parent)
     : QFileSystemWatcherEngine(parent),
       inotifyFd(fd),
-      notifier(fd, QSocketNotifier::Read, this)
+      notifier(fd, QSocketNotifier::Read, this),
+      crawlTimer(this)
 {
     fcntl(inotifyFd, F_SETFD, FD_CLOEXEC);
     connect(&notifier, SIGNAL(activated(int)), SLOT(readFromInotify()));
+    crawlTimer.setSingleShot(true);
+    connect(&crawlTimer, SIGNAL(timeout()), SLOT(crawlPendingDirectories()));
 }
 
 QInotifyFileSystemWatcherEngine::~QInotifyFileSystemWatcherEngine()
@@ -284,17 +292,18 @@ QStringList QInotifyFileSystemWatcherEngine::addPaths(const QStringList &paths,
                 continue;
         }
 
+        // IN_MASK_ADD so as not to drop the events of a tree watch on the same inode
         int wd = inotify_add_watch(inotifyFd,
                                    QFile::encodeName(path),
                                    (isDir
-                                    ? (0
+                                    ? (IN_MASK_ADD
                                        | IN_ATTRIB
                                        | IN_MOVE
                                        | IN_CREATE
                                        | IN_DELETE
                                        | IN_DELETE_SELF
                                        )
-                                    : (0
+                                    : (IN_MASK_ADD
                                        | IN_ATTRIB
                                        | IN_MODIFY
                                        | IN_MOVE
@@ -337,7 +346,8 @@ QStringList QInotifyFileSystemWatcherEngine::removePaths(const QStringList &path
 
         int wd = id < 0 ? -id : id;
         // qDebug() << "removing watch for path" << path << "wd" << wd;
-        inotify_rm_watch(inotifyFd, wd);
+        if (!treeWatchToPath.contains(wd))
+            inotify_rm_watch(inotifyFd, wd);
 
         it.remove();
         if (id < 0) {
@@ -362,8 +372,16 @@ void QInotifyFileSystemWatcherEngine::readFromInotify()
     char * const end = at + buffSize;
 
     QHash<int, inotify_event *> eventForId;
+    QHash<quint32, PendingMove> moves;
+    bool overflowed = false;
     while (at < end) {
         inotify_event *event = reinterpret_cast<inotify_event *>(at);
+        if (event->mask & IN_Q_OVERFLOW)
+            overflowed = true;
+
+        // changes within trees are reported one by one, in order
+        if (!treeWatchToPath.isEmpty())
+            processTreeEvent(event->wd, event->mask, event->cookie, event->len ? event->name : 0, &moves);
 
         if (eventForId.contains(event->wd))
             eventForId[event->wd]->mask |= event->mask;
@@ -373,6 +391,24 @@ void QInotifyFileSystemWatcherEngine::readFromInotify()
         at += sizeof(inotify_event) + event->len;
     }
 
+    // entries moved out of the trees, or whose other half of the move
+    // has not been read yet
+    for (const PendingMove &move : qAsConst(moves)) {
+        if (move.isDir)
+            removeTreeWatches(move.path);
+        emit treeChanged(QFileSystemWatcher::Removed, move.path, QString());
+    }
+
+    // Changes were dropped, so all that can be said is that something in
+    // the trees changed. Directories created meanwhile are not watched
+    // yet either, so crawl the trees again.
+    if (overflowed) {
+        for (const QString &root : qAsConst(treeRoots)) {
+            emit treeChanged(QFileSystemWatcher::Modified, root, QString());
+            crawlLater(root, false);
+        }
+    }
+
     QHash<int, inotify_event *>::const_iterator it = eventForId.constBegin();
     while (it != eventForId.constEnd()) {
         const inotify_event &event = **it;
@@ -380,6 +416,9 @@ void QInotifyFileSystemWatcherEngine::readFromInotify()
 
         // qDebug() << "inotify event, wd" << event.wd << "mask" << hex << event.mask;
 
+        if (event.mask & IN_Q_OVERFLOW)
+            qWarning("QFileSystemWatcher: inotify event queue overflowed, changes were lost");
+
         int id = event.wd;
         QString path = getPathFromID(id);
         if (path.isEmpty()) {
@@ -395,7 +434,7 @@ void QInotifyFileSystemWatcherEngine::readFromInotify()
         if ((event.mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_UNMOUNT)) != 0) {
             pathToID.remove(path);
             idToPath.remove(id, getPathFromID(id));
-            if (!idToPath.contains(id))
+            if (!idToPath.contains(id) && !treeWatchToPath.contains(event.wd))
                 inotify_rm_watch(inotifyFd, event.wd);
 
             if (id < 0)
@@ -411,6 +450,212 @@ void QInotifyFileSystemWatcherEngine::readFromInotify()
     }
 }
 
+static const quint32 treeWatchMask = IN_MASK_ADD | IN_ONLYDIR
+        | IN_ATTRIB | IN_MODIFY | IN_MOVE | IN_CREATE | IN_DELETE | IN_DELETE_SELF | IN_MOVE_SELF;
+
+static bool isWithin(const QString &path, const QString &directory)
+{
+    return path.startsWith(directory)
+            && (path.size() == directory.size() || path.at(directory.size()) == QLatin1Char('/'));
+}
+
+QStringList QInotifyFileSystemWatcherEngine::addTrees(const QStringList &paths, QStringList *trees)
+{
+    QStringList p = paths;
+    QMutableListIterator<QString> it(p);
+    while (it.hasNext()) {
+        const QString &path = it.next();
+        if (treePathToWatch.contains(path) || !QFileInfo(path).isDir())
+            continue;
+        if (!addTreeWatches(path)) {
+            removeTreeWatches(path);
+            continue;
+        }
+        treeRoots.append(path);
+        trees->append(path);
+        it.remove();
+    }
+    return p;
+}
+
+QStringList QInotifyFileSystemWatcherEngine::removeTrees(const QStringList &paths, QStringList *trees)
+{
+    QStringList p = paths;
+    QMutableListIterator<QString> it(p);
+    while (it.hasNext()) {
+        const QString &path = it.next();
+        if (!treeRoots.removeOne(path))
+            continue;
+        removeTreeWatches(path);
+        trees->removeAll(path);
+        it.remove();
+    }
+    return p;
+}
+
+bool QInotifyFileSystemWatcherEngine::addTreeWatch(const QString &directory)
+{
+    int wd = inotify_add_watch(inotifyFd, QFile::encodeName(directory), treeWatchMask);
+    if (wd < 0) {
+        // vanished in the meantime, or a symbolic link to a file
+        if (errno == ENOENT || errno == ENOTDIR)
+            return true;
+        qWarning().nospace() << "inotify_add_watch(" << directory << ") failed: " << QSystemError(errno, QSystemError::NativeError).toString();
+        return false;
+    }
+    treePathToWatch.insert(directory, wd);
+    treeWatchToPath.insert(wd, directory);
+    return true;
+}
+
+// Watches \a directory and all the directories below it, for addTrees().
+bool QInotifyFileSystemWatcherEngine::addTreeWatches(const QString &directory)
+{
+    if (!addTreeWatch(directory))
+        return false;
+
+    QDirIterator it(directory, QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System,
+                    QDirIterator::Subdirectories | QDirIterator::Concurrent);
+    while (it.hasNext()) {
+        const QString path = it.next();
+        if (!it.fileInfo().isSymLink() && !addTreeWatch(path))
+            return false;
+    }
+    return true;
+}
+
+// Lists \a directory, which is already watched, and the directories below
+// it from the event loop, watching the directories and reporting all
+// entries as created if \a reportContents is set. Since the directory is
+// watched first, entries created meanwhile are reported at least once.
+void QInotifyFileSystemWatcherEngine::crawlLater(const QString &directory, bool reportContents)
+{
+    pendingCrawls.append({ directory, reportContents });
+    if (!crawlTimer.isActive())
+        crawlTimer.start(0);
+}
+
+// Lists a few of the directories queued by crawlLater() at a time, so that
+// a large tree moved into a watched one does not block the event loop.
+void QInotifyFileSystemWatcherEngine::crawlPendingDirectories()
+{
+    for (int i = 0; i < 16 && !pendingCrawls.isEmpty(); ++i) {
+        const PendingCrawl crawl = pendingCrawls.takeFirst();
+        const QDir::Filters filters = crawl.reportContents
+                ? QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System
+                : QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System;
+        QDirIterator it(crawl.directory, filters);
+        while (it.hasNext()) {
+            const QString path = it.next();
+            const QFileInfo info = it.fileInfo();
+            if (crawl.reportContents)
+                emit treeChanged(QFileSystemWatcher::Created, path, QString());
+            if (info.isDir() && !info.isSymLink() && addTreeWatch(path))
+                pendingCrawls.append({ path, crawl.reportContents });
+        }
+    }
+    if (!pendingCrawls.isEmpty())
+        crawlTimer.start(0);
+}
+
+void QInotifyFileSystemWatcherEngine::removeTreeWatches(const QString &directory)
+{
+    for (auto it = pendingCrawls.begin(); it != pendingCrawls.end(); ) {
+        if (isWithin(it->directory, directory))
+            it = pendingCrawls.erase(it);
+        else
+            ++it;
+    }
+    for (auto it = treePathToWatch.begin(); it != treePathToWatch.end(); ) {
+        if (isWithin(it.key(), directory)) {
+            const int wd = it.value();
+            treeWatchToPath.remove(wd);
+            if (!idToPath.contains(wd) && !idToPath.contains(-wd))
+                inotify_rm_watch(inotifyFd, wd);
+            it = treePathToWatch.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void QInotifyFileSystemWatcherEngine::moveTreeWatches(const QString &from, const QString &to)
+{
+    QVector<QPair<QString, int> > moved;
+    for (auto it = treePathToWatch.begin(); it != treePathToWatch.end(); ) {
+        if (isWithin(it.key(), from)) {
+            moved.append(qMakePair(to + it.key().midRef(from.size()), it.value()));
+            it = treePathToWatch.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (const auto &entry : qAsConst(moved)) {
+        treePathToWatch.insert(entry.first, entry.second);
+        treeWatchToPath.insert(entry.second, entry.first);
+    }
+    for (PendingCrawl &crawl : pendingCrawls) {
+        if (isWithin(crawl.directory, from))
+            crawl.directory = to + crawl.directory.midRef(from.size());
+    }
+}
+
+void QInotifyFileSystemWatcherEngine::processTreeEvent(int wd, quint32 mask, quint32 cookie,
+                                                       const char *name,
+                                                       QHash<quint32, PendingMove> *moves)
+{
+    const auto dir = treeWatchToPath.constFind(wd);
+    if (dir == treeWatchToPath.constEnd())
+        return;
+    const QString directory = *dir;
+
+    if (mask & IN_IGNORED) {
+        // the directory is gone, or a watch of the same tree replaced it
+        treeWatchToPath.remove(wd);
+        const auto it = treePathToWatch.find(directory);
+        if (it != treePathToWatch.end() && *it == wd)
+            treePathToWatch.erase(it);
+        return;
+    }
+    if (mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_UNMOUNT)) {
+        // other directories are reported by their parent, but a
+        // tree that disappears is no longer watched
+        if (treeRoots.removeOne(directory)) {
+            removeTreeWatches(directory);
+            emit treeChanged(QFileSystemWatcher::Removed, directory, QString());
+        }
+        return;
+    }
+    if (!name)
+        return; // the parent reports the change as well
+
+    const QString path = directory + QLatin1Char('/') + QFile::decodeName(name);
+    const bool isDir = mask & IN_ISDIR;
+    if (mask & IN_CREATE) {
+        emit treeChanged(QFileSystemWatcher::Created, path, QString());
+        if (isDir && addTreeWatch(path))
+            crawlLater(path, true);
+    } else if (mask & IN_DELETE) {
+        emit treeChanged(QFileSystemWatcher::Removed, path, QString());
+    } else if (mask & IN_MOVED_FROM) {
+        moves->insert(cookie, { path, isDir });
+    } else if (mask & IN_MOVED_TO) {
+        const auto move = moves->find(cookie);
+        if (move != moves->end()) {
+            emit treeChanged(QFileSystemWatcher::Renamed, path, move->path);
+            if (isDir)
+                moveTreeWatches(move->path, path);
+            moves->erase(move);
+        } else {
+            emit treeChanged(QFileSystemWatcher::Created, path, QString());
+            if (isDir && addTreeWatch(path))
+                crawlLater(path, true);
+        }
+    } else if (mask & (IN_MODIFY | IN_ATTRIB)) {
+        emit treeChanged(QFileSystemWatcher::Modified, path, QString());
+    }
+}
+
 QString QInotifyFileSystemWatcherEngine::getPathFromID(int id) const
 {
     QHash<int, QString>::const_iterator i = idToPath.find(id);
@@ -58,6 +58,7 @@
 #include <QtCore/qhash.h>
 #include <QtCore/qmutex.h>
 #include <QtCore/qsocketnotifier.h>
+#include <QtCore/qtimer.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -72,19 +73,47 @@ public:
 
     QStringList addPaths(const QStringList &paths, QStringList *files, QStringList *directories) override;
     QStringList removePaths(const QStringList &paths, QStringList *files, QStringList *directories) override;
+    QStringList addTrees(const QStringList &paths, QStringList *trees) override;
+    QStringList removeTrees(const QStringList &paths, QStringList *trees) override;
 
 private Q_SLOTS:
     void readFromInotify();
+    void crawlPendingDirectories();
 
 private:
     QString getPathFromID(int id) const;
 
+    struct PendingMove
+    {
+        QString path;
+        bool isDir;
+    };
+    struct PendingCrawl
+    {
+        QString directory;
+        bool reportContents;
+    };
+    bool addTreeWatch(const QString &directory);
+    bool addTreeWatches(const QString &directory);
+    void crawlLater(const QString &directory, bool reportContents);
+    void removeTreeWatches(const QString &directory);
+    void moveTreeWatches(const QString &from, const QString &to);
+    void processTreeEvent(int wd, quint32 mask, quint32 cookie, const char *name,
+                          QHash<quint32, PendingMove> *moves);
+
 private:
     QInotifyFileSystemWatcherEngine(int fd, QObject *parent);
     int inotifyFd;
     QHash<QString, int> pathToID;
     QMultiHash<int, QString> idToPath;
+    // one watch per directory in the trees passed to addTrees()
+    QHash<QString, int> treePathToWatch;
+    QHash<int, QString> treeWatchToPath;
+    QStringList treeRoots;
+    // directories in the trees whose entries have not been listed yet
+    QList<PendingCrawl> pendingCrawls;
     QSocketNotifier notifier;
+    QTimer crawlTimer;
 };
 
 
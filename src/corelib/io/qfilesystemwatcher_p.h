@@ -59,9 +59,12 @@
 
 #include <QtCore/qstringlist.h>
 #include <QtCore/qhash.h>
+#include <QtCore/qvector.h>
 
 QT_BEGIN_NAMESPACE
 
+class QTimer;
+
 class QFileSystemWatcherEngine : public QObject
 {
     Q_OBJECT
@@ -84,10 +87,27 @@ public:
     virtual QStringList removePaths(const QStringList &paths,
                                     QStringList *files,
                                     QStringList *directories) = 0;
+    // watches everything below the directories in \a paths, adds them
+    // to \a trees, and returns a list of paths this engine could not watch
+    virtual QStringList addTrees(const QStringList &paths, QStringList *trees)
+    {
+        Q_UNUSED(trees);
+        return paths;
+    }
+    // stops watching the trees in \a paths, removes them from \a trees,
+    // and returns a list of paths this engine does not know about
+    virtual QStringList removeTrees(const QStringList &paths, QStringList *trees)
+    {
+        Q_UNUSED(trees);
+        return paths;
+    }
 
 Q_SIGNALS:
     void fileChanged(const QString &path, bool removed);
     void directoryChanged(const QString &path, bool removed);
+    // for Renamed, \a oldPath is where \a path was before
+    void treeChanged(QFileSystemWatcher::Change change, const QString &path,
+                     const QString &oldPath);
 };
 
 class QFileSystemWatcherPrivate : public QObjectPrivate
@@ -100,13 +120,30 @@ public:
     QFileSystemWatcherPrivate();
     void init();
     void initPollerEngine();
+    void connectTreeEngine(QFileSystemWatcherEngine *engine);
+    bool isInTree(const QString &path) const;
+
+    QFileSystemWatcherEngine *native, *poller, *fanotify;
+    QStringList files, directories, trees;
 
-    QFileSystemWatcherEngine *native, *poller;
-    QStringList files, directories;
+    // tree changes waiting for the coalescing timer
+    struct PendingChange
+    {
+        QFileSystemWatcher::Change change;
+        QString path; // empty if the change cancelled out
+        QString oldPath;
+    };
+    QVector<PendingChange> pendingChanges;
+    QHash<QString, int> pendingChangeIndex;
+    QTimer *coalescingTimer;
+    int coalescingInterval;
 
     // private slots
     void _q_fileChanged(const QString &path, bool removed);
     void _q_directoryChanged(const QString &path, bool removed);
+    void _q_treeChanged(QFileSystemWatcher::Change change, const QString &path,
+                        const QString &oldPath);
+    void _q_flushTreeChanges();
 
 #if defined(Q_OS_WIN) && !defined(Q_OS_WINRT)
     void _q_winDriveLockForRemoval(const QString &);
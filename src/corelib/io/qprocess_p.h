@@ -351,6 +351,7 @@ public:
     void startProcess();
 #if defined(Q_OS_UNIX)
     void execChild(const char *workingDirectory, char **argv, char **envp);
+    int spawnChild(const char *workingDirectory, char **argv, char **envp, pid_t *pid);
 #endif
     bool processStarted(QString *errorMessage = nullptr);
     void terminateProcess();
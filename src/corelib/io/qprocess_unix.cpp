@@ -118,6 +118,18 @@ QT_END_NAMESPACE
 #include <forkfd.h>
 #endif
 
+// posix_spawn() in glibc 2.24 and later starts the child with
+// clone(CLONE_VM | CLONE_VFORK), so the page tables of the parent are not
+// copied, and it reports a failing execve() to the caller
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID) && defined(__GLIBC__) \
+    && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 24) && _POSIX_SPAWN > 0
+#  define QPROCESS_USE_SPAWN
+#  if __GLIBC__ > 2 || __GLIBC_MINOR__ >= 29
+#    define QPROCESS_SPAWN_CHDIR
+#  endif
+#  include <typeinfo>
+#endif
+
 QT_BEGIN_NAMESPACE
 
 #if !defined(Q_OS_DARWIN)
@@ -360,6 +372,83 @@ static char **_q_dupEnvironment(const QProcessEnvironmentPrivate::Map &environme
     return envp;
 }
 
+struct ChildError
+{
+    int code;
+    char function[8];
+};
+
+#ifdef QPROCESS_USE_SPAWN
+static bool canSpawn(QProcess *q, const char *workingDir)
+{
+#ifndef QPROCESS_SPAWN_CHDIR
+    if (workingDir)
+        return false;
+#else
+    Q_UNUSED(workingDir);
+#endif
+#if defined(__GXX_RTTI) || defined(__cpp_rtti)
+    // setupChildProcess() has to run in a forked child, and any subclass
+    // may reimplement it
+    return typeid(*q) == typeid(QProcess);
+#else
+    Q_UNUSED(q);
+    return false;
+#endif
+}
+
+// Returns the forkfd for a child started with posix_spawn(), doing what
+// execChild() does in a forked child.
+int QProcessPrivate::spawnChild(const char *workingDir, char **argv, char **envp, pid_t *pid)
+{
+    posix_spawn_file_actions_t fileActions;
+    posix_spawnattr_t attributes;
+    ::posix_spawn_file_actions_init(&fileActions);
+    ::posix_spawnattr_init(&attributes);
+
+    if (inputChannelMode != QProcess::ForwardedInputChannel)
+        ::posix_spawn_file_actions_adddup2(&fileActions, stdinChannel.pipe[0], STDIN_FILENO);
+    if (processChannelMode != QProcess::ForwardedChannels) {
+        if (processChannelMode != QProcess::ForwardedOutputChannel)
+            ::posix_spawn_file_actions_adddup2(&fileActions, stdoutChannel.pipe[1], STDOUT_FILENO);
+        if (processChannelMode == QProcess::MergedChannels)
+            ::posix_spawn_file_actions_adddup2(&fileActions, STDOUT_FILENO, STDERR_FILENO);
+        else if (processChannelMode != QProcess::ForwardedErrorChannel)
+            ::posix_spawn_file_actions_adddup2(&fileActions, stderrChannel.pipe[1], STDERR_FILENO);
+    }
+#ifdef QPROCESS_SPAWN_CHDIR
+    if (workingDir)
+        ::posix_spawn_file_actions_addchdir_np(&fileActions, workingDir);
+#endif
+
+    // reset the signal that we ignored
+    sigset_t defaultSignals;
+    sigemptyset(&defaultSignals);
+    sigaddset(&defaultSignals, SIGPIPE);
+    ::posix_spawnattr_setsigdefault(&attributes, &defaultSignals);
+    ::posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETSIGDEF);
+
+    int fd = ::spawnfd(FFD_CLOEXEC, pid, argv[0], &fileActions, &attributes, argv,
+                       envp ? envp : environ);
+    int spawnErrno = errno;
+
+    ::posix_spawnattr_destroy(&attributes);
+    ::posix_spawn_file_actions_destroy(&fileActions);
+
+    if (fd == -1) {
+        // report it the way a forked child reports a failing chdir() or execve()
+        QT_STATBUF st;
+        const bool chdirFailed = workingDir && (QT_STAT(workingDir, &st) != 0 || !S_ISDIR(st.st_mode)
+                                                || ::access(workingDir, X_OK) != 0);
+        ChildError error = { spawnErrno, {} };
+        strcpy(error.function, chdirFailed ? "chdir" : envp ? "execve" : "execvp");
+        qt_safe_write(childStartedPipe[1], &error, sizeof(error));
+        *pid = 0;
+    }
+    return fd;
+}
+#endif // QPROCESS_USE_SPAWN
+
 void QProcessPrivate::startProcess()
 {
     Q_Q(QProcess);
@@ -454,7 +543,13 @@ void QProcessPrivate::startProcess()
 
     // Start the process manager, and fork off the child process.
     pid_t childPid;
-    forkfd = ::forkfd(FFD_CLOEXEC, &childPid);
+#ifdef QPROCESS_USE_SPAWN
+    const bool spawned = canSpawn(q, workingDirPtr);
+    if (spawned)
+        forkfd = spawnChild(workingDirPtr, argv, envp, &childPid);
+    else
+#endif
+        forkfd = ::forkfd(FFD_CLOEXEC, &childPid);
     int lastForkErrno = errno;
     if (forkfd != FFD_CHILD_PROCESS) {
         // Parent process.
@@ -471,7 +566,12 @@ void QProcessPrivate::startProcess()
     // This is intentional because we only want to handle failure to fork()
     // here, which is a rare occurrence. Handling of the failure to start is
     // done elsewhere.
+#ifdef QPROCESS_USE_SPAWN
+    // spawnChild() has reported its failure like a child would have
+    if (forkfd == -1 && !spawned) {
+#else
     if (forkfd == -1) {
+#endif
         // Cleanup, report error and return
 #if defined (QPROCESS_DEBUG)
         qDebug("fork failed: %s", qPrintable(qt_error_string(lastForkErrno)));
@@ -519,19 +619,13 @@ void QProcessPrivate::startProcess()
     if (stderrChannel.pipe[0] != -1)
         ::fcntl(stderrChannel.pipe[0], F_SETFL, ::fcntl(stderrChannel.pipe[0], F_GETFL) | O_NONBLOCK);
 
-    if (threadData->eventDispatcher) {
+    if (threadData->eventDispatcher && forkfd != -1) {
         deathNotifier = new QSocketNotifier(forkfd, QSocketNotifier::Read, q);
         QObject::connect(deathNotifier, SIGNAL(activated(int)),
                          q, SLOT(_q_processDied()));
     }
 }
 
-struct ChildError
-{
-    int code;
-    char function[8];
-};
-
 void QProcessPrivate::execChild(const char *workingDir, char **argv, char **envp)
 {
     ::signal(SIGPIPE, SIG_DFL);         // reset the signal that we ignored
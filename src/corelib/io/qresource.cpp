@@ -59,6 +59,13 @@
 # include "private/qcore_unix_p.h"
 #endif
 
+#if QT_CONFIG(zstd)
+#  include <zstd.h>
+#endif
+
+#include <algorithm>
+#include <limits>
+
 //#define DEBUG_RESOURCE_MATCH
 
 QT_BEGIN_NAMESPACE
@@ -97,26 +104,37 @@ class QResourceRoot
 {
     enum Flags
     {
-        Compressed = 0x01,
-        Directory = 0x02
+        // must match rcc.cpp
+        CompressedZlib = 0x01,
+        Directory = 0x02,
+        CompressedZstd = 0x04
     };
-    const uchar *tree, *names, *payloads;
+    const uchar *tree, *names, *payloads, *pathIndex;
     int version;
     inline int findOffset(int node) const { return node * (14 + (version >= 0x02 ? 8 : 0)); } //sizeof each tree element
     uint hash(int node) const;
     QString name(int node) const;
     short flags(int node) const;
+    int findNodeInIndex(QStringView path, const QLocale &locale) const;
 public:
     mutable QAtomicInt ref;
 
-    inline QResourceRoot(): tree(0), names(0), payloads(0), version(0) {}
-    inline QResourceRoot(int version, const uchar *t, const uchar *n, const uchar *d) { setSource(version, t, n, d); }
+    inline QResourceRoot(): tree(0), names(0), payloads(0), pathIndex(0), version(0) {}
+    inline QResourceRoot(int version, const uchar *t, const uchar *n, const uchar *d) : pathIndex(0) { setSource(version, t, n, d); }
     virtual ~QResourceRoot() { }
     int findNode(const QString &path, const QLocale &locale=QLocale()) const;
     inline bool isContainer(int node) const { return flags(node) & Directory; }
-    inline bool isCompressed(int node) const { return flags(node) & Compressed; }
+    inline QResource::Compression compressionAlgorithm(int node) const
+    {
+        const uint compressionFlags = flags(node) & (CompressedZlib | CompressedZstd);
+        if (compressionFlags == CompressedZlib)
+            return QResource::ZlibCompression;
+        if (compressionFlags == CompressedZstd)
+            return QResource::ZstdCompression;
+        return QResource::NoCompression;
+    }
     const uchar *data(int node, qint64 *size) const;
-    QDateTime lastModified(int node) const;
+    qint64 lastModified(int node) const;
     QStringList children(int node) const;
     virtual QString mappingRoot() const { return QString(); }
     bool mappingRootSubdir(const QString &path, QString *match=0) const;
@@ -134,6 +152,7 @@ protected:
         payloads = d;
         version = v;
     }
+    inline void setPathIndex(const uchar *index) { pathIndex = index; }
 };
 
 static QString cleanPath(const QString &_path)
@@ -166,6 +185,41 @@ static inline ResourceList *resourceList()
 static inline QStringList *resourceSearchPaths()
 { return &resourceGlobalData->resourceSearchPaths; }
 
+#if QT_CONFIG(zstd)
+namespace {
+// rcc writes Zstandard-compressed files as a sequence of independent frames
+// that each record their decompressed size, so any part of a file can be
+// located and decompressed without touching the rest of it.
+struct ZstdFrame
+{
+    qint64 offset;          // in the decompressed data
+    qint64 size;            // decompressed
+    const uchar *data;
+    size_t compressedSize;
+};
+}
+Q_DECLARE_TYPEINFO(ZstdFrame, Q_PRIMITIVE_TYPE);
+
+static qint64 zstdFrames(const uchar *data, qint64 size, QVector<ZstdFrame> *frames)
+{
+    qint64 offset = 0;
+    while (size > 0) {
+        const size_t compressedSize = ZSTD_findFrameCompressedSize(data, size_t(size));
+        if (ZSTD_isError(compressedSize))
+            return -1;
+        const unsigned long long frameSize = ZSTD_getFrameContentSize(data, compressedSize);
+        if (frameSize == ZSTD_CONTENTSIZE_UNKNOWN || frameSize == ZSTD_CONTENTSIZE_ERROR)
+            return -1;
+        if (frames && frameSize)
+            frames->append({ offset, qint64(frameSize), data, compressedSize });
+        offset += frameSize;
+        data += compressedSize;
+        size -= compressedSize;
+    }
+    return offset;
+}
+#endif // QT_CONFIG(zstd)
+
 /*!
     \class QResource
     \inmodule QtCore
@@ -193,11 +247,15 @@ static inline QStringList *resourceSearchPaths()
     which will be found in the list of paths returned by QDir::searchPaths().
 
     A QResource that is representing a file will have data backing it, this
-    data can possibly be compressed, in which case qUncompress() must be
+    data can possibly be compressed, in which case uncompressedData() must be
     used to access the real data; this happens implicitly when accessed
     through a QFile. A QResource that is representing a directory will have
     only children and no data.
 
+    Files compressed with Zstandard are split into independently compressed
+    chunks, so reading from such a resource through QFile only decompresses
+    the chunks that are actually read.
+
     \section1 Dynamic Resource Loading
 
     A resource can be left out of an application's binary and loaded when
@@ -226,6 +284,22 @@ static inline QStringList *resourceSearchPaths()
     \sa {The Qt Resource System}, QFile, QDir, QFileInfo
 */
 
+/*!
+    \enum QResource::Compression
+    \since 5.12
+
+    This enum is used by compressionAlgorithm() to indicate which algorithm the
+    RCC tool used to compress the payload.
+
+    \value NoCompression       Contents are not compressed
+    \value ZlibCompression     Contents are compressed using \l{https://zlib.net}{zlib} and can
+                                be decompressed using the qUncompress() function.
+    \value ZstdCompression     Contents are compressed using \l{https://facebook.github.io/zstd/}{Zstandard}.
+                                To decompress, use uncompressedData().
+
+    \sa compressionAlgorithm()
+*/
+
 class QResourcePrivate {
 public:
     inline QResourcePrivate(QResource *_q) : q_ptr(_q) { clear(); }
@@ -233,6 +307,8 @@ public:
 
     void ensureInitialized() const;
     void ensureChildren() const;
+    qint64 uncompressedSize() const Q_DECL_PURE_FUNCTION;
+    QByteArray uncompressedData() const;
 
     bool load(const QString &file);
     void clear();
@@ -241,11 +317,11 @@ public:
     QString fileName, absoluteFilePath;
     QList<QResourceRoot*> related;
     uint container : 1;
-    mutable uint compressed : 1;
+    mutable uint compressionAlgorithm : 2;
     mutable qint64 size;
     mutable const uchar *data;
     mutable QStringList children;
-    mutable QDateTime lastModified;
+    mutable qint64 lastModified; // msecs since epoch, 0 if unknown
 
     QResource *q_ptr;
     Q_DECLARE_PUBLIC(QResource)
@@ -255,11 +331,11 @@ void
 QResourcePrivate::clear()
 {
     absoluteFilePath.clear();
-    compressed = 0;
+    compressionAlgorithm = QResource::NoCompression;
     data = 0;
     size = 0;
     children.clear();
-    lastModified = QDateTime();
+    lastModified = 0;
     container = 0;
     for(int i = 0; i < related.size(); ++i) {
         QResourceRoot *root = related.at(i);
@@ -284,11 +360,11 @@ QResourcePrivate::load(const QString &file)
                 container = res->isContainer(node);
                 if(!container) {
                     data = res->data(node, &size);
-                    compressed = res->isCompressed(node);
+                    compressionAlgorithm = res->compressionAlgorithm(node);
                 } else {
                     data = 0;
                     size = 0;
-                    compressed = 0;
+                    compressionAlgorithm = QResource::NoCompression;
                 }
                 lastModified = res->lastModified(node);
             } else if(res->isContainer(node) != container) {
@@ -300,8 +376,8 @@ QResourcePrivate::load(const QString &file)
             container = true;
             data = 0;
             size = 0;
-            compressed = 0;
-            lastModified = QDateTime();
+            compressionAlgorithm = QResource::NoCompression;
+            lastModified = 0;
             res->ref.ref();
             related.append(res);
         }
@@ -376,6 +452,67 @@ QResourcePrivate::ensureChildren() const
     }
 }
 
+qint64 QResourcePrivate::uncompressedSize() const
+{
+    switch (QResource::Compression(compressionAlgorithm)) {
+    case QResource::NoCompression:
+        return size;
+
+    case QResource::ZlibCompression:
+#ifndef QT_NO_COMPRESS
+        // qCompress() stores the uncompressed size in front of the data
+        if (size >= 4)
+            return qFromBigEndian<quint32>(data);
+#endif
+        break;
+
+    case QResource::ZstdCompression:
+#if QT_CONFIG(zstd)
+        return zstdFrames(data, size, nullptr);
+#endif
+        break;
+    }
+    return -1;
+}
+
+QByteArray QResourcePrivate::uncompressedData() const
+{
+    switch (QResource::Compression(compressionAlgorithm)) {
+    case QResource::NoCompression:
+        return QByteArray(reinterpret_cast<const char *>(data), size);
+
+    case QResource::ZlibCompression:
+#ifndef QT_NO_COMPRESS
+        return qUncompress(data, size);
+#else
+        qWarning("QResource: Qt built without support for zlib compression");
+        break;
+#endif
+
+    case QResource::ZstdCompression: {
+#if QT_CONFIG(zstd)
+        const qint64 n = uncompressedSize();
+        if (n < 0 || n >= std::numeric_limits<int>::max()) {
+            qWarning("QResource: invalid Zstandard data in %ls", qUtf16Printable(absoluteFilePath));
+            break;
+        }
+        QByteArray result(int(n), Qt::Uninitialized);
+        const size_t r = ZSTD_decompress(result.data(), size_t(n), data, size_t(size));
+        if (ZSTD_isError(r)) {
+            qWarning("QResource: error decompressing %ls: %s", qUtf16Printable(absoluteFilePath),
+                     ZSTD_getErrorName(r));
+            break;
+        }
+        return result;
+#else
+        qWarning("QResource: Qt built without support for Zstandard compression");
+        break;
+#endif
+    }
+    }
+    return QByteArray();
+}
+
 /*!
     Constructs a QResource pointing to \a file. \a locale is used to
     load a specific localization of a resource data.
@@ -492,14 +629,32 @@ bool QResource::isValid() const
     Returns \c true if the resource represents a file and the data backing it
     is in a compressed format, false otherwise.
 
-    \sa data(), isFile()
+    \sa data(), compressionAlgorithm(), isFile()
 */
 
 bool QResource::isCompressed() const
+{
+    return compressionAlgorithm() != NoCompression;
+}
+
+/*!
+    \since 5.12
+
+    Returns the compression type that this resource is compressed with, if any.
+    If it is not compressed, this function returns QResource::NoCompression.
+
+    If this function returns QResource::ZlibCompression, you may decompress
+    the data using the qUncompress() function. Up until Qt 5.11, this was the
+    only possible compression algorithm. Whatever the algorithm,
+    uncompressedData() returns the decompressed contents.
+
+    \sa isCompressed(), data(), uncompressedData()
+*/
+QResource::Compression QResource::compressionAlgorithm() const
 {
     Q_D(const QResource);
     d->ensureInitialized();
-    return d->compressed;
+    return Compression(d->compressionAlgorithm);
 }
 
 /*!
@@ -517,11 +672,11 @@ qint64 QResource::size() const
 
 /*!
     Returns direct access to a read only segment of data that this resource
-    represents. If the resource is compressed the data returns is
-    compressed and qUncompress() must be used to access the data. If the
+    represents. If the resource is compressed the data returned is
+    compressed and uncompressedData() must be used to access the data. If the
     resource is a directory 0 is returned.
 
-    \sa size(), isCompressed(), isFile()
+    \sa size(), compressionAlgorithm(), isFile()
 */
 
 const uchar *QResource::data() const
@@ -531,6 +686,44 @@ const uchar *QResource::data() const
     return d->data;
 }
 
+/*!
+    \since 5.12
+
+    Returns the size of the data in this resource once decompressed. If the
+    resource is not compressed, this is the same as size(). If the size
+    cannot be determined, for example because the compression algorithm is
+    not supported by this build of Qt, -1 is returned.
+
+    Finding the size does not decompress the data.
+
+    \sa size(), uncompressedData(), compressionAlgorithm()
+*/
+qint64 QResource::uncompressedSize() const
+{
+    Q_D(const QResource);
+    d->ensureInitialized();
+    return d->uncompressedSize();
+}
+
+/*!
+    \since 5.12
+
+    Returns a copy of the data in this resource, decompressing it first if
+    necessary. If the data is compressed with an algorithm that this build
+    of Qt does not support, or is corrupt, an empty QByteArray is returned.
+
+    Reading the resource through QFile instead avoids holding all of the
+    decompressed data in memory for Zstandard-compressed resources.
+
+    \sa uncompressedSize(), data(), compressionAlgorithm()
+*/
+QByteArray QResource::uncompressedData() const
+{
+    Q_D(const QResource);
+    d->ensureInitialized();
+    return d->uncompressedData();
+}
+
 /*!
     Returns the date and time when the file was last modified before
     packaging into a resource.
@@ -539,7 +732,8 @@ QDateTime QResource::lastModified() const
 {
     Q_D(const QResource);
     d->ensureInitialized();
-    return d->lastModified;
+    // converting to local time is expensive, so only do it when asked
+    return d->lastModified ? QDateTime::fromMSecsSinceEpoch(d->lastModified) : QDateTime();
 }
 
 /*!
@@ -643,8 +837,116 @@ inline QString QResourceRoot::name(int node) const
     return ret;
 }
 
+/*
+    The path index that rcc -path-index writes into binary resources maps
+    the full path of every node to the node with a perfect hash (hash and
+    displace). Everything is big-endian:
+
+        quint32 slotCount, bucketCount
+        quint32 displacement[bucketCount]
+        { quint32 node, pathOffset } entry[slotCount]
+        { quint16 nodeCount, pathLength; quint16 path[pathLength] } ...
+
+    pathOffset is relative to the start of the index, or 0 for a free
+    slot; nodeCount is the number of consecutive nodes with the same path
+    (locale variants).
+
+    The hash functions must match rcc.cpp.
+*/
+static inline quint64 qt_resource_path_hash_mix(quint64 h)
+{
+    h ^= h >> 33;
+    h *= Q_UINT64_C(0xff51afd7ed558ccd);
+    h ^= h >> 33;
+    h *= Q_UINT64_C(0xc4ceb9fe1a85ec53);
+    h ^= h >> 33;
+    return h;
+}
+
+static inline quint32 qt_resource_path_index_slot(quint64 h, quint32 displacement, quint32 slotCount)
+{
+    return qt_resource_path_hash_mix(h ^ (displacement * Q_UINT64_C(0x9e3779b97f4a7c15))) % slotCount;
+}
+
+int QResourceRoot::findNodeInIndex(QStringView path, const QLocale &locale) const
+{
+    quint64 h = Q_UINT64_C(0xcbf29ce484222325); // FNV-1a
+    for (QChar c : path) {
+        h ^= c.unicode();
+        h *= Q_UINT64_C(0x100000001b3);
+    }
+
+    const quint32 slotCount = qFromBigEndian<quint32>(pathIndex);
+    const quint32 bucketCount = qFromBigEndian<quint32>(pathIndex + 4);
+    if (!slotCount)
+        return -1;
+    const quint32 displacement = qFromBigEndian<quint32>(pathIndex + 8 + 4 * ((h >> 32) % bucketCount));
+    const quint32 slot = qt_resource_path_index_slot(h, displacement, slotCount);
+    const uchar *entry = pathIndex + 8 + 4 * bucketCount + 8 * slot;
+    const qint32 first = qFromBigEndian<qint32>(entry);
+    const quint32 pathOffset = qFromBigEndian<quint32>(entry + 4);
+    if (!pathOffset)
+        return -1;
+    const uchar *key = pathIndex + pathOffset;
+
+    // every path hashes to some slot, check that it is the right one
+    const int nodeCount = qFromBigEndian<quint16>(key);
+    const int length = qFromBigEndian<quint16>(key + 2);
+    if (length != path.size())
+        return -1;
+    key += 4;
+    for (int i = 0; i < length; ++i) {
+        if (qFromBigEndian<quint16>(key + 2 * i) != path.at(i).unicode())
+            return -1;
+    }
+
+    // same as the last step of the tree search
+    int node = -1;
+    for (int sub_node = first; sub_node < first + nodeCount; ++sub_node) {
+        int offset = findOffset(sub_node) + 4;
+        const qint16 flags = qFromBigEndian<qint16>(tree + offset);
+        offset += 2;
+        if (flags & Directory)
+            return sub_node;
+
+        const qint16 country = qFromBigEndian<qint16>(tree + offset);
+        offset += 2;
+        const qint16 language = qFromBigEndian<qint16>(tree + offset);
+        if (country == locale.country() && language == locale.language())
+            return sub_node;
+        if ((country == QLocale::AnyCountry && language == locale.language()) ||
+            (country == QLocale::AnyCountry && language == QLocale::C && node == -1)) {
+            node = sub_node;
+        }
+    }
+    return node;
+}
+
 int QResourceRoot::findNode(const QString &_path, const QLocale &locale) const
 {
+    if (pathIndex) {
+        // The index only knows clean paths and is searched without making
+        // copies of the path; anything else takes the slow route below.
+        QStringView path(_path);
+        const QString root = mappingRoot();
+        if (!root.isEmpty()) {
+            if (root == _path)
+                return 0;
+            const bool slash = root.endsWith(QLatin1Char('/'));
+            if (path.startsWith(root) && (slash || (path.size() > root.size()
+                                                    && path.at(root.size()) == QLatin1Char('/')))) {
+                path = path.mid(root.size() - (slash ? 1 : 0));
+            }
+        }
+        bool clean = !path.isEmpty() && path.first() == QLatin1Char('/');
+        for (qsizetype i = 1; clean && i < path.size(); ++i)
+            clean = path.at(i) != QLatin1Char('/') || path.at(i - 1) != QLatin1Char('/');
+        if (clean && path.size() == 1)
+            return 0;
+        if (clean && path.last() != QLatin1Char('/'))
+            return findNodeInIndex(path, locale);
+    }
+
     QString path = _path;
     {
         QString root = mappingRoot();
@@ -797,18 +1099,14 @@ const uchar *QResourceRoot::data(int node, qint64 *size) const
     return 0;
 }
 
-QDateTime QResourceRoot::lastModified(int node) const
+qint64 QResourceRoot::lastModified(int node) const
 {
     if (node == -1 || version < 0x02)
-        return QDateTime();
+        return 0;
 
     const int offset = findOffset(node) + 14;
 
-    const quint64 timeStamp = qFromBigEndian<quint64>(tree + offset);
-    if (timeStamp == 0)
-        return QDateTime();
-
-    return QDateTime::fromMSecsSinceEpoch(timeStamp);
+    return qFromBigEndian<qint64>(tree + offset);
 }
 
 QStringList QResourceRoot::children(int node) const
@@ -858,7 +1156,7 @@ Q_CORE_EXPORT bool qRegisterResourceData(int version, const unsigned char *tree,
                                          const unsigned char *name, const unsigned char *data)
 {
     QMutexLocker lock(resourceMutex());
-    if ((version == 0x01 || version == 0x2) && resourceList()) {
+    if (version >= 0x01 && version <= 0x03 && resourceList()) {
         bool found = false;
         QResourceRoot res(version, tree, name, data);
         for(int i = 0; i < resourceList()->size(); ++i) {
@@ -884,7 +1182,7 @@ Q_CORE_EXPORT bool qUnregisterResourceData(int version, const unsigned char *tre
         return false;
 
     QMutexLocker lock(resourceMutex());
-    if ((version == 0x01 || version == 0x02) && resourceList()) {
+    if (version >= 0x01 && version <= 0x03 && resourceList()) {
         QResourceRoot res(version, tree, name, data);
         for(int i = 0; i < resourceList()->size(); ) {
             if(*resourceList()->at(i) == res) {
@@ -947,9 +1245,21 @@ public:
         if (size >= 0 && (tree_offset >= size || data_offset >= size || name_offset >= size))
             return false;
 
-        if (version == 0x01 || version == 0x02) {
+        // version 3 added the offset of the optional path index
+        int index_offset = 0;
+        if (version >= 0x03) {
+            if (size >= 0 && size < 24)
+                return false;
+            index_offset = qFromBigEndian<qint32>(b + offset);
+            offset += 4;
+            if (size >= 0 && index_offset >= size)
+                return false;
+        }
+
+        if (version >= 0x01 && version <= 0x03) {
             buffer = b;
             setSource(version, b+tree_offset, b+name_offset, b+data_offset);
+            setPathIndex(index_offset ? b + index_offset : 0);
             return true;
         }
         return false;
@@ -1223,11 +1533,35 @@ private:
     uchar *map(qint64 offset, qint64 size, QFile::MemoryMapFlags flags);
     bool unmap(uchar *ptr);
     void uncompress() const;
+    qint64 uncompressedSize() const;
+#if QT_CONFIG(zstd)
+    bool readZstd(char *data, qint64 len);
+#endif
+    void clearUncompressed();
     qint64 offset;
     QResource resource;
     mutable QByteArray uncompressed;
+    mutable qint64 cachedUncompressedSize;
+#if QT_CONFIG(zstd)
+    // the frame holding the current position is kept decompressed
+    mutable QVector<ZstdFrame> zstdFrameIndex;
+    QByteArray zstdFrameData;
+    int zstdFrame;
+    ZSTD_DCtx *zstdContext;
+#endif
 protected:
-    QResourceFileEnginePrivate() : offset(0) { }
+    QResourceFileEnginePrivate()
+        : offset(0), cachedUncompressedSize(-1)
+#if QT_CONFIG(zstd)
+        , zstdFrame(-1), zstdContext(nullptr)
+#endif
+    { }
+    ~QResourceFileEnginePrivate()
+    {
+#if QT_CONFIG(zstd)
+        ZSTD_freeDCtx(zstdContext);
+#endif
+    }
 };
 
 bool QResourceFileEngine::mkdir(const QString &, bool) const
@@ -1269,6 +1603,7 @@ QResourceFileEngine::~QResourceFileEngine()
 void QResourceFileEngine::setFileName(const QString &file)
 {
     Q_D(QResourceFileEngine);
+    d->clearUncompressed();
     d->resource.setFileName(file);
 }
 
@@ -1281,11 +1616,15 @@ bool QResourceFileEngine::open(QIODevice::OpenMode flags)
     }
     if(flags & QIODevice::WriteOnly)
         return false;
-    d->uncompress();
     if (!d->resource.isValid()) {
         d->errorString = QSystemError::stdString(ENOENT);
         return false;
     }
+    // compressed data is only decompressed when it is read
+    if (d->resource.isCompressed() && d->uncompressedSize() < 0) {
+        d->errorString = QSystemError::stdString(ENOTSUP);
+        return false;
+    }
     return true;
 }
 
@@ -1293,7 +1632,7 @@ bool QResourceFileEngine::close()
 {
     Q_D(QResourceFileEngine);
     d->offset = 0;
-    d->uncompressed.clear();
+    d->clearUncompressed();
     return true;
 }
 
@@ -1309,10 +1648,25 @@ qint64 QResourceFileEngine::read(char *data, qint64 len)
         len = size()-d->offset;
     if(len <= 0)
         return 0;
-    if(d->resource.isCompressed())
-        memcpy(data, d->uncompressed.constData()+d->offset, len);
-    else
+    switch (d->resource.compressionAlgorithm()) {
+    case QResource::NoCompression:
         memcpy(data, d->resource.data()+d->offset, len);
+        break;
+    case QResource::ZlibCompression:
+        d->uncompress();
+        if (d->uncompressed.size() < d->offset + len)
+            return -1;
+        memcpy(data, d->uncompressed.constData()+d->offset, len);
+        break;
+    case QResource::ZstdCompression:
+#if QT_CONFIG(zstd)
+        if (!d->readZstd(data, len))
+            return -1;
+        break;
+#else
+        return -1;
+#endif
+    }
     d->offset += len;
     return len;
 }
@@ -1347,10 +1701,8 @@ qint64 QResourceFileEngine::size() const
     Q_D(const QResourceFileEngine);
     if(!d->resource.isValid())
         return 0;
-    if (d->resource.isCompressed()) {
-        d->uncompress();
-        return d->uncompressed.size();
-    }
+    if (d->resource.isCompressed())
+        return qMax(d->uncompressedSize(), Q_INT64_C(0));
     return d->resource.size();
 }
 
@@ -1508,11 +1860,20 @@ uchar *QResourceFileEnginePrivate::map(qint64 offset, qint64 size, QFile::Memory
 {
     Q_Q(QResourceFileEngine);
     Q_UNUSED(flags);
-    if (offset < 0 || size <= 0 || !resource.isValid() || offset + size > resource.size()) {
+    if (offset < 0 || size <= 0 || !resource.isValid() || offset + size > q->size()) {
         q->setError(QFile::UnspecifiedError, QString());
         return 0;
     }
     uchar *address = const_cast<uchar *>(resource.data());
+    if (resource.isCompressed()) {
+        // the mapping stays valid until the file is closed
+        uncompress();
+        if (uncompressed.size() < offset + size) {
+            q->setError(QFile::UnspecifiedError, QString());
+            return 0;
+        }
+        address = reinterpret_cast<uchar *>(uncompressed.data());
+    }
     return (address + offset);
 }
 
@@ -1524,13 +1885,72 @@ bool QResourceFileEnginePrivate::unmap(uchar *ptr)
 
 void QResourceFileEnginePrivate::uncompress() const
 {
-    if (resource.isCompressed() && uncompressed.isEmpty() && resource.size()) {
-#ifndef QT_NO_COMPRESS
-        uncompressed = qUncompress(resource.data(), resource.size());
-#else
-        Q_ASSERT(!"QResourceFileEngine::open: Qt built without support for compression");
+    if (resource.isCompressed() && uncompressed.isEmpty() && resource.size())
+        uncompressed = resource.uncompressedData();
+}
+
+qint64 QResourceFileEnginePrivate::uncompressedSize() const
+{
+    if (cachedUncompressedSize < 0) {
+#if QT_CONFIG(zstd)
+        if (resource.compressionAlgorithm() == QResource::ZstdCompression) {
+            zstdFrameIndex.clear();
+            cachedUncompressedSize = zstdFrames(resource.data(), resource.size(), &zstdFrameIndex);
+            return cachedUncompressedSize;
+        }
 #endif
+        cachedUncompressedSize = resource.uncompressedSize();
     }
+    return cachedUncompressedSize;
+}
+
+#if QT_CONFIG(zstd)
+bool QResourceFileEnginePrivate::readZstd(char *data, qint64 len)
+{
+    Q_Q(QResourceFileEngine);
+    qint64 pos = offset;
+    while (len > 0) {
+        if (zstdFrame < 0 || pos < zstdFrameIndex.at(zstdFrame).offset
+                || pos >= zstdFrameIndex.at(zstdFrame).offset + zstdFrameIndex.at(zstdFrame).size) {
+            const auto byOffset = [](qint64 pos, const ZstdFrame &frame) { return pos < frame.offset; };
+            const auto it = std::upper_bound(zstdFrameIndex.cbegin(), zstdFrameIndex.cend(), pos, byOffset) - 1;
+            zstdFrame = -1;
+            if (it->size >= std::numeric_limits<int>::max()) {
+                q->setError(QFile::ReadError, QSystemError::stdString(EFBIG));
+                return false;
+            }
+            if (!zstdContext)
+                zstdContext = ZSTD_createDCtx();
+            zstdFrameData.resize(int(it->size));
+            const size_t r = ZSTD_decompressDCtx(zstdContext, zstdFrameData.data(), zstdFrameData.size(),
+                                                 it->data, it->compressedSize);
+            if (ZSTD_isError(r) || r != size_t(it->size)) {
+                q->setError(QFile::ReadError, QString::fromLatin1(ZSTD_getErrorName(r)));
+                return false;
+            }
+            zstdFrame = it - zstdFrameIndex.cbegin();
+        }
+
+        const ZstdFrame &frame = zstdFrameIndex.at(zstdFrame);
+        const qint64 n = qMin(len, frame.offset + frame.size - pos);
+        memcpy(data, zstdFrameData.constData() + (pos - frame.offset), n);
+        data += n;
+        pos += n;
+        len -= n;
+    }
+    return true;
+}
+#endif // QT_CONFIG(zstd)
+
+void QResourceFileEnginePrivate::clearUncompressed()
+{
+    uncompressed.clear();
+    cachedUncompressedSize = -1;
+#if QT_CONFIG(zstd)
+    zstdFrameIndex.clear();
+    zstdFrameData.clear();
+    zstdFrame = -1;
+#endif
 }
 
 #endif // !defined(QT_BOOTSTRAPPED)
@@ -44,6 +44,7 @@
 #ifndef QT_NO_SETTINGS
 
 #include "qsettings_p.h"
+#include "qsettingsbinarystore_p.h"
 #include "qcache.h"
 #include "qfile.h"
 #include "qdir.h"
@@ -151,6 +152,16 @@ static QBasicMutex settingsGlobalMutex;
 
 static QSettings::Format globalDefaultFormat = QSettings::NativeFormat;
 
+static inline bool isBinaryFormat(QSettings::Format format)
+{
+#ifdef QSETTINGS_USE_BINARY_STORE
+    return format == QSettings::BinaryFormat;
+#else
+    Q_UNUSED(format);
+    return false;
+#endif
+}
+
 QConfFile::QConfFile(const QString &fileName, bool _userPerms)
     : name(fileName), size(0), ref(1), userPerms(_userPerms)
 {
@@ -934,7 +945,10 @@ void QConfFileSettingsPrivate::initFormat()
     caseSensitivity = IniCaseSensitivity;
 #endif
 
-    if (format > QSettings::IniFormat) {
+    if (format == QSettings::BinaryFormat) {
+        extension = QLatin1String(".qsettings");
+        caseSensitivity = Qt::CaseSensitive;
+    } else if (format > QSettings::IniFormat) {
         QMutexLocker locker(&settingsGlobalMutex);
         const CustomFormatVector *customFormatVector = customFormatVectorFunc();
 
@@ -952,7 +966,7 @@ void QConfFileSettingsPrivate::initFormat()
 void QConfFileSettingsPrivate::initAccess()
 {
     if (!confFiles.isEmpty()) {
-        if (format > QSettings::IniFormat) {
+        if (format > QSettings::IniFormat && !isBinaryFormat(format)) {
             if (!readFunc)
                 setStatus(QSettings::AccessError);
         }
@@ -1247,6 +1261,17 @@ void QConfFileSettingsPrivate::remove(const QString &key)
         i = confFile->addedKeys.erase(i);
     confFile->addedKeys.remove(theKey);
 
+#ifdef QSETTINGS_USE_BINARY_STORE
+    if (confFile->binaryStore) {
+        const QStringList keys = confFile->binaryStore->keys(prefix);
+        for (const QString &k : keys)
+            confFile->removedKeys.insert(QSettingsKey(k, caseSensitivity), QVariant());
+        if (confFile->binaryStore->contains(theKey))
+            confFile->removedKeys.insert(theKey, QVariant());
+        return;
+    }
+#endif
+
     ParsedSettingsMap::const_iterator j = const_cast<const ParsedSettingsMap *>(&confFile->originalKeys)->lowerBound(prefix);
     while (j != confFile->originalKeys.constEnd() && j.key().startsWith(prefix)) {
         confFile->removedKeys.insert(j.key(), QVariant());
@@ -1283,6 +1308,18 @@ bool QConfFileSettingsPrivate::get(const QString &key, QVariant *value) const
             j = confFile->addedKeys.constFind(theKey);
             found = (j != confFile->addedKeys.constEnd());
         }
+#ifdef QSETTINGS_USE_BINARY_STORE
+        if (!found && confFile->binaryStore) {
+            // the store decodes only the value asked for, straight from the file
+            if (!confFile->removedKeys.contains(theKey)
+                    && confFile->binaryStore->value(theKey, value)) {
+                return true;
+            }
+            if (!fallbacks)
+                break;
+            continue;
+        }
+#endif
         if (!found) {
             ensureSectionParsed(confFile, theKey);
             j = confFile->originalKeys.constFind(theKey);
@@ -1317,6 +1354,16 @@ QStringList QConfFileSettingsPrivate::children(const QString &prefix, ChildSpec
         else
             ensureSectionParsed(confFile, thePrefix);
 
+#ifdef QSETTINGS_USE_BINARY_STORE
+        if (confFile->binaryStore) {
+            const QStringList keys = confFile->binaryStore->keys(thePrefix);
+            for (const QString &key : keys) {
+                if (!confFile->removedKeys.contains(QSettingsKey(key, caseSensitivity)))
+                    processChild(key.midRef(startPos), spec, result);
+            }
+        }
+#endif
+
         j = const_cast<const ParsedSettingsMap *>(
                 &confFile->originalKeys)->lowerBound( thePrefix);
         while (j != confFile->originalKeys.constEnd() && j.key().startsWith(thePrefix)) {
@@ -1353,6 +1400,13 @@ void QConfFileSettingsPrivate::clear()
     ensureAllSectionsParsed(confFile);
     confFile->addedKeys.clear();
     confFile->removedKeys = confFile->originalKeys;
+#ifdef QSETTINGS_USE_BINARY_STORE
+    if (confFile->binaryStore) {
+        const QStringList keys = confFile->binaryStore->keys(QString());
+        for (const QString &key : keys)
+            confFile->removedKeys.insert(QSettingsKey(key, caseSensitivity), QVariant());
+    }
+#endif
 }
 
 void QConfFileSettingsPrivate::sync()
@@ -1382,7 +1436,7 @@ QString QConfFileSettingsPrivate::fileName() const
 
 bool QConfFileSettingsPrivate::isWritable() const
 {
-    if (format > QSettings::IniFormat && !writeFunc)
+    if (format > QSettings::IniFormat && !isBinaryFormat(format) && !writeFunc)
         return false;
 
     if (confFiles.isEmpty())
@@ -1391,8 +1445,28 @@ bool QConfFileSettingsPrivate::isWritable() const
     return confFiles.at(0)->isWritable();
 }
 
+static void setConfFilePermissions(const QConfFile *confFile)
+{
+    QFile::Permissions perms = QFileInfo(confFile->name).permissions() | QFile::ReadOwner | QFile::WriteOwner;
+    if (!confFile->userPerms)
+        perms |= QFile::ReadGroup | QFile::ReadOther;
+    QFile(confFile->name).setPermissions(perms);
+}
+
 void QConfFileSettingsPrivate::syncConfFile(QConfFile *confFile)
 {
+#ifdef QSETTINGS_USE_BINARY_STORE
+    if (format == QSettings::BinaryFormat) {
+        syncBinaryFile(confFile);
+        return;
+    }
+    if (confFile->binaryStore) {
+        // the same file was last opened as BinaryFormat; read it from scratch
+        confFile->binaryStore.reset();
+        confFile->size = 0;
+    }
+#endif
+
     bool readOnly = confFile->addedKeys.isEmpty() && confFile->removedKeys.isEmpty();
 
     /*
@@ -1538,18 +1612,61 @@ void QConfFileSettingsPrivate::syncConfFile(QConfFile *confFile)
             confFile->timeStamp = fileInfo.lastModified();
 
             // If we have created the file, apply the file perms
-            if (createFile) {
-                QFile::Permissions perms = fileInfo.permissions() | QFile::ReadOwner | QFile::WriteOwner;
-                if (!confFile->userPerms)
-                    perms |= QFile::ReadGroup | QFile::ReadOther;
-                QFile(confFile->name).setPermissions(perms);
-            }
+            if (createFile)
+                setConfFilePermissions(confFile);
         } else {
             setStatus(QSettings::AccessError);
         }
     }
 }
 
+#ifdef QSETTINGS_USE_BINARY_STORE
+void QConfFileSettingsPrivate::syncBinaryFile(QConfFile *confFile)
+{
+    if (!confFile->binaryStore) {
+        // drop what another format may have parsed from the same file
+        confFile->unparsedIniSections.clear();
+        confFile->originalKeys.clear();
+        confFile->binaryStore.reset(new QSettingsBinaryStore(confFile->name));
+    }
+    QSettingsBinaryStore *store = confFile->binaryStore.data();
+
+    /*
+        Picking up changes from other processes only needs a stat() in
+        the common case, and reading what they appended otherwise.
+    */
+    if (confFile->addedKeys.isEmpty() && confFile->removedKeys.isEmpty()) {
+        if (!store->refresh())
+            setStatus(QSettings::FormatError);
+        confFile->size = store->size();
+        return;
+    }
+
+    if (!confFile->isWritable()) {
+        setStatus(QSettings::AccessError);
+        return;
+    }
+
+    QLockFile lockFile(confFile->name + QLatin1String(".lock"));
+    if (!lockFile.lock() && atomicSyncOnly) {
+        setStatus(QSettings::AccessError);
+        return;
+    }
+
+    const bool createFile = !QFileInfo::exists(confFile->name);
+    if (!store->update(confFile->addedKeys, confFile->removedKeys)) {
+        setStatus(QSettings::AccessError);
+        return;
+    }
+    confFile->addedKeys.clear();
+    confFile->removedKeys.clear();
+    confFile->size = store->size();
+
+    if (createFile)
+        setConfFilePermissions(confFile);
+}
+#endif // QSETTINGS_USE_BINARY_STORE
+
 enum { Space = 0x1, Special = 0x2 };
 
 static const char charTraits[256] =
@@ -2437,6 +2554,10 @@ void QConfFileSettingsPrivate::ensureSectionParsed(QConfFile *confFile,
                             this works the same as specifying NativeFormat.
                             This enum value was added in Qt 5.7.
     \value IniFormat        Store the settings in INI files.
+    \value BinaryFormat     Store the settings in an indexed binary file,
+                            with the \c .qsettings extension, that is read
+                            without being parsed. This enum value was added
+                            in Qt 5.12.
     \value InvalidFormat    Special value returned by registerFormat().
     \omitvalue CustomFormat1
     \omitvalue CustomFormat2
@@ -2501,6 +2622,16 @@ void QConfFileSettingsPrivate::ensureSectionParsed(QConfFile *confFile,
         potentially less compatible), call setIniCodec().
     \endlist
 
+    BinaryFormat is meant for large settings files shared by many
+    processes. The file is memory mapped, and reading a value only
+    decodes that value, so opening the file takes the same time no matter
+    how big it is. sync() appends the changed keys to the file instead of
+    rewriting it, and only reads what other processes have appended
+    since. When enough changes have accumulated, the file is rewritten
+    to drop the outdated values. Keys are always case sensitive, and
+    values are stored with QDataStream, so custom types need stream
+    operators registered with qRegisterMetaTypeStreamOperators().
+
     \sa registerFormat(), setPath()
 */
 
@@ -93,6 +93,8 @@ public:
         Registry64Format,
 #endif
 
+        BinaryFormat = 4,
+
         InvalidFormat = 16,
         CustomFormat1,
         CustomFormat2,
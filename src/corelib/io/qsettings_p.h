@@ -72,6 +72,10 @@ QT_BEGIN_NAMESPACE
 #define QT_QTSETTINGS_FORGET_ORIGINAL_KEY_ORDER
 #endif
 
+#if !defined(QT_BOOTSTRAPPED) && QT_CONFIG(temporaryfile)
+#define QSETTINGS_USE_BINARY_STORE
+#endif
+
 // used in testing framework
 #define QSETTINGS_P_H_VERSION 3
 
@@ -114,6 +118,8 @@ Q_DECLARE_TYPEINFO(QSettingsKey, Q_MOVABLE_TYPE);
 typedef QMap<QSettingsKey, QByteArray> UnparsedSettingsMap;
 typedef QMap<QSettingsKey, QVariant> ParsedSettingsMap;
 
+class QSettingsBinaryStore;
+
 class QSettingsGroup
 {
 public:
@@ -166,6 +172,9 @@ public:
     ParsedSettingsMap originalKeys;
     ParsedSettingsMap addedKeys;
     ParsedSettingsMap removedKeys;
+#ifdef QSETTINGS_USE_BINARY_STORE
+    QScopedPointer<QSettingsBinaryStore> binaryStore;
+#endif
     QAtomicInt ref;
     QMutex mutex;
     bool userPerms;
@@ -283,6 +292,9 @@ private:
     void initFormat();
     void initAccess();
     void syncConfFile(QConfFile *confFile);
+#ifdef QSETTINGS_USE_BINARY_STORE
+    void syncBinaryFile(QConfFile *confFile);
+#endif
     bool writeIniFile(QIODevice &device, const ParsedSettingsMap &map);
 #ifdef Q_OS_MAC
     bool readPlistFile(const QByteArray &data, ParsedSettingsMap *map) const;
@@ -0,0 +1,572 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsettings.h"
+
+#ifndef QT_NO_SETTINGS
+
+#include "qsettingsbinarystore_p.h"
+
+#include "qdatastream.h"
+#include "qendian.h"
+#include "qfileinfo.h"
+#include "qmath.h"
+#include "qrandom.h"
+#include "qsavefile.h"
+#include "qvector.h"
+
+#include <limits>
+#include <string.h>
+
+#ifdef QSETTINGS_USE_BINARY_STORE
+
+QT_BEGIN_NAMESPACE
+
+/*
+    QSettingsBinaryStore implements QSettings::BinaryFormat.
+
+    A file starts with a snapshot of all settings, which is indexed by an
+    open addressing hash table for lookups and by a sorted table for
+    listing the keys under a group, and continues with a log of the changes
+    made since the snapshot was written. The file is memory mapped and
+    lookups read it in place, so opening it costs the same no matter how
+    many settings it contains.
+
+    Writers hold the same lock file as for INI files, but only append
+    their changes to the log. Once the log has grown as big as the
+    snapshot, the writer compacts the file into a new snapshot and
+    atomically replaces it. Readers that notice the file has changed only
+    have to read the new part of the log, unless the generation in the
+    header tells them the file was replaced.
+
+    All numbers are little-endian:
+
+        char magic[8]                   "QSETTBIN"
+        quint32 version                 2
+        quint32 generation              changes with every compaction
+        quint32 indexOffset, bucketCount
+        quint32 logOffset
+        quint32 streamVersion           QDataStream version of the values
+
+        record[]                        the snapshot
+        quint32 index[bucketCount]      record offsets, 0 for free buckets
+        quint32 sorted[]                record offsets in key order, up to logOffset
+        record[]                        the log, up to the end of the file
+
+    and every record is
+
+        quint32 hash, keyLength, valueLength
+        quint16 key[keyLength]          UTF-16, padded to 4 bytes
+        char value[valueLength]         a QVariant, padded to 4 bytes
+
+    A valueLength of 0xffffffff marks a key removed in the log.
+*/
+
+static const char binaryStoreMagic[8] = { 'Q', 'S', 'E', 'T', 'T', 'B', 'I', 'N' };
+static const quint32 binaryStoreVersion = 2;
+static const QDataStream::Version binaryStoreStreamVersion = QDataStream::Qt_5_11;
+static const quint32 removedValue = 0xffffffff;
+static const qint64 minimumCompactionLogSize = 64 * 1024;
+
+enum {
+    HeaderSize = 32,
+    RecordHeaderSize = 12
+};
+
+static quint32 keyHash(const QString &key)
+{
+    quint32 h = 2166136261u; // FNV-1a
+    for (QChar c : key) {
+        h ^= c.unicode();
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static inline qint64 padded(qint64 size)
+{
+    return (size + 3) & ~qint64(3);
+}
+
+static inline quint32 recordKeyLength(const uchar *record)
+{
+    return qFromLittleEndian<quint32>(record + 4);
+}
+
+static inline quint32 recordValueLength(const uchar *record)
+{
+    return qFromLittleEndian<quint32>(record + 8);
+}
+
+static inline const uchar *recordValue(const uchar *record)
+{
+    return record + RecordHeaderSize + padded(2 * qint64(recordKeyLength(record)));
+}
+
+static qint64 recordSize(const uchar *record)
+{
+    const quint32 valueLength = recordValueLength(record);
+    return RecordHeaderSize + padded(2 * qint64(recordKeyLength(record)))
+            + (valueLength == removedValue ? 0 : padded(valueLength));
+}
+
+static QString recordKey(const uchar *record)
+{
+    const int length = recordKeyLength(record);
+    QString key(length, Qt::Uninitialized);
+    QChar *dst = key.data();
+    for (int i = 0; i < length; ++i)
+        dst[i] = QChar(qFromLittleEndian<quint16>(record + RecordHeaderSize + 2 * i));
+    return key;
+}
+
+static bool recordKeyStartsWith(const uchar *record, const QString &prefix)
+{
+    if (recordKeyLength(record) < uint(prefix.size()))
+        return false;
+    for (int i = 0; i < prefix.size(); ++i) {
+        if (qFromLittleEndian<quint16>(record + RecordHeaderSize + 2 * i) != prefix.at(i).unicode())
+            return false;
+    }
+    return true;
+}
+
+static int compareRecordKey(const uchar *record, const QString &key)
+{
+    const int length = recordKeyLength(record);
+    for (int i = 0, n = qMin(length, key.size()); i < n; ++i) {
+        const quint16 c = qFromLittleEndian<quint16>(record + RecordHeaderSize + 2 * i);
+        if (c != key.at(i).unicode())
+            return c < key.at(i).unicode() ? -1 : 1;
+    }
+    return length - key.size();
+}
+
+static void appendRecord(QByteArray *out, const QString &key, const QByteArray *value)
+{
+    const qint64 start = out->size();
+    const qint64 keySize = padded(2 * qint64(key.size()));
+    out->resize(start + RecordHeaderSize + keySize + (value ? padded(value->size()) : 0));
+    uchar *record = reinterpret_cast<uchar *>(out->data()) + start;
+    memset(record, 0, out->size() - start);
+
+    qToLittleEndian<quint32>(keyHash(key), record);
+    qToLittleEndian<quint32>(key.size(), record + 4);
+    qToLittleEndian<quint32>(value ? quint32(value->size()) : removedValue, record + 8);
+    for (int i = 0; i < key.size(); ++i)
+        qToLittleEndian<quint16>(key.at(i).unicode(), record + RecordHeaderSize + 2 * i);
+    if (value)
+        memcpy(record + RecordHeaderSize + keySize, value->constData(), value->size());
+}
+
+static QByteArray encodedValue(const QVariant &value)
+{
+    QByteArray result;
+    QDataStream stream(&result, QIODevice::WriteOnly);
+    stream.setVersion(binaryStoreStreamVersion);
+    stream << value;
+    return result;
+}
+
+QSettingsBinaryStore::QSettingsBinaryStore(const QString &fileName)
+    : fileName(fileName), data(0)
+{
+    reset();
+}
+
+QSettingsBinaryStore::~QSettingsBinaryStore()
+{
+    reset();
+}
+
+void QSettingsBinaryStore::reset()
+{
+    if (data)
+        file.unmap(const_cast<uchar *>(data));
+    file.close();
+    data = 0;
+    mappedSize = 0;
+    lastModified = QDateTime();
+    currentGeneration = 0;
+    indexOffset = 0;
+    bucketCount = 0;
+    sortedCount = 0;
+    logOffset = 0;
+    streamVersion = binaryStoreStreamVersion;
+    scannedEnd = 0;
+    log.clear();
+}
+
+/*
+    Makes the store reflect the file on disk. Returns \c false if the file
+    exists but cannot be read, in which case the store is empty.
+*/
+bool QSettingsBinaryStore::refresh()
+{
+    const QFileInfo fileInfo(fileName);
+    if (!fileInfo.exists()) {
+        reset();
+        return true;
+    }
+    if (data && fileInfo.size() == mappedSize && fileInfo.lastModified() == lastModified)
+        return true;
+    return open();
+}
+
+bool QSettingsBinaryStore::open()
+{
+    if (data)
+        file.unmap(const_cast<uchar *>(data));
+    file.close();
+    data = 0;
+
+    file.setFileName(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        reset();
+        return false;
+    }
+    const qint64 size = file.size();
+    if (size == 0) {
+        reset();
+        return true;
+    }
+    if (size >= HeaderSize && size <= std::numeric_limits<int>::max())
+        data = file.map(0, size);
+    if (!data || memcmp(data, binaryStoreMagic, sizeof(binaryStoreMagic)) != 0
+            || qFromLittleEndian<quint32>(data + 8) != binaryStoreVersion) {
+        reset();
+        return false;
+    }
+
+    const quint32 generation = qFromLittleEndian<quint32>(data + 12);
+    indexOffset = qFromLittleEndian<quint32>(data + 16);
+    bucketCount = qFromLittleEndian<quint32>(data + 20);
+    logOffset = qFromLittleEndian<quint32>(data + 24);
+    streamVersion = qFromLittleEndian<quint32>(data + 28);
+    if (indexOffset < HeaderSize || !bucketCount || (bucketCount & (bucketCount - 1))
+            || logOffset < indexOffset + 4 * qint64(bucketCount) || logOffset > size
+            || (logOffset - indexOffset) % 4 != 0
+            || streamVersion > QDataStream::Qt_DefaultCompiledVersion) {
+        reset();
+        return false;
+    }
+    sortedCount = (logOffset - indexOffset) / 4 - bucketCount;
+
+    // the changes we know about are still valid unless the file was compacted
+    if (generation != currentGeneration || size < scannedEnd) {
+        log.clear();
+        scannedEnd = logOffset;
+    }
+    currentGeneration = generation;
+    mappedSize = size;
+    lastModified = QFileInfo(fileName).lastModified();
+    scanLog();
+    return true;
+}
+
+void QSettingsBinaryStore::scanLog()
+{
+    qint64 pos = scannedEnd;
+    while (pos + RecordHeaderSize <= mappedSize) {
+        const uchar *record = data + pos;
+        const qint64 length = recordSize(record);
+        if (pos + length > mappedSize)
+            break; // still being written, or left behind by a writer that crashed
+        log.insert(recordKey(record), quint32(pos));
+        pos += length;
+    }
+    scannedEnd = pos;
+}
+
+/*
+    Returns the snapshot record at \a offset, or null if it doesn't fit
+    in the snapshot because the file is corrupt.
+*/
+const uchar *QSettingsBinaryStore::snapshotRecord(qint64 offset) const
+{
+    if (offset < HeaderSize || offset + RecordHeaderSize > indexOffset)
+        return 0;
+    const uchar *record = data + offset;
+    if (recordValueLength(record) == removedValue || offset + recordSize(record) > indexOffset)
+        return 0;
+    return record;
+}
+
+quint32 QSettingsBinaryStore::findRecord(const QString &key) const
+{
+    if (!data)
+        return 0;
+
+    if (!log.isEmpty()) {
+        const auto it = log.constFind(key);
+        if (it != log.constEnd())
+            return it.value();
+    }
+
+    const quint32 h = keyHash(key);
+    const uchar *index = data + indexOffset;
+    quint32 bucket = h & (bucketCount - 1);
+    for (quint32 i = 0; i < bucketCount; ++i) {
+        const quint32 offset = qFromLittleEndian<quint32>(index + 4 * bucket);
+        const uchar *record = snapshotRecord(offset);
+        if (!record)
+            return 0;
+        if (qFromLittleEndian<quint32>(record) == h && recordKeyLength(record) == uint(key.size())
+                && recordKeyStartsWith(record, key)) {
+            return offset;
+        }
+        bucket = (bucket + 1) & (bucketCount - 1);
+    }
+    return 0;
+}
+
+bool QSettingsBinaryStore::contains(const QString &key) const
+{
+    const quint32 offset = findRecord(key);
+    return offset && recordValueLength(data + offset) != removedValue;
+}
+
+bool QSettingsBinaryStore::value(const QString &key, QVariant *value) const
+{
+    const quint32 offset = findRecord(key);
+    if (!offset || recordValueLength(data + offset) == removedValue)
+        return false;
+
+    if (value) {
+        const uchar *record = data + offset;
+        const QByteArray bytes = QByteArray::fromRawData(reinterpret_cast<const char *>(recordValue(record)),
+                                                         recordValueLength(record));
+        QDataStream stream(bytes);
+        stream.setVersion(streamVersion);
+        stream >> *value;
+    }
+    return true;
+}
+
+/*
+    Returns the snapshot record at position \a i of the sorted table, or
+    null if the file is corrupt.
+*/
+const uchar *QSettingsBinaryStore::sortedRecord(quint32 i) const
+{
+    return snapshotRecord(qFromLittleEndian<quint32>(data + indexOffset + 4 * (bucketCount + qint64(i))));
+}
+
+/*
+    Returns the keys starting with \a prefix, in no particular order.
+    Only the keys in that range of the sorted table and of the log are
+    visited.
+*/
+QStringList QSettingsBinaryStore::keys(const QString &prefix) const
+{
+    QStringList result;
+    if (!data)
+        return result;
+
+    // find the first key not less than the prefix
+    quint32 first = 0;
+    quint32 count = sortedCount;
+    while (count > 0) {
+        const quint32 half = count / 2;
+        const uchar *record = sortedRecord(first + half);
+        if (!record)
+            return result;
+        if (compareRecordKey(record, prefix) < 0) {
+            first += half + 1;
+            count -= half + 1;
+        } else {
+            count = half;
+        }
+    }
+    for (quint32 i = first; i < sortedCount; ++i) {
+        const uchar *record = sortedRecord(i);
+        if (!record || !recordKeyStartsWith(record, prefix))
+            break;
+        const QString key = recordKey(record);
+        if (!log.contains(key))
+            result.append(key);
+    }
+
+    for (auto it = log.lowerBound(prefix), end = log.cend(); it != end && it.key().startsWith(prefix); ++it) {
+        if (recordValueLength(data + it.value()) != removedValue)
+            result.append(it.key());
+    }
+    return result;
+}
+
+/*
+    Appends the changes to the file, compacting it if the log has grown
+    too big. The caller must hold the lock file.
+*/
+bool QSettingsBinaryStore::update(const ParsedSettingsMap &addedKeys,
+                                  const ParsedSettingsMap &removedKeys)
+{
+    // a file we can't read is overwritten, like an INI file with errors
+    refresh();
+
+    // Other processes may have the file mapped, so it may only grow in
+    // place. If a writer that crashed left a partial record behind, replace
+    // the file instead of truncating it.
+    if (!data || scannedEnd != mappedSize) {
+        QMap<QString, QByteArray> entries = snapshotEntries();
+        for (auto it = removedKeys.cbegin(), end = removedKeys.cend(); it != end; ++it)
+            entries.remove(it.key());
+        for (auto it = addedKeys.cbegin(), end = addedKeys.cend(); it != end; ++it)
+            entries.insert(it.key(), encodedValue(it.value()));
+        return writeSnapshot(entries);
+    }
+
+    QByteArray records;
+    for (auto it = removedKeys.cbegin(), end = removedKeys.cend(); it != end; ++it) {
+        if (!addedKeys.contains(it.key()) && contains(it.key()))
+            appendRecord(&records, it.key(), 0);
+    }
+    for (auto it = addedKeys.cbegin(), end = addedKeys.cend(); it != end; ++it) {
+        const QByteArray value = encodedValue(it.value());
+        appendRecord(&records, it.key(), &value);
+    }
+    if (records.isEmpty())
+        return true;
+
+    QFile out(fileName);
+    if (!out.open(QIODevice::ReadWrite) || out.size() != scannedEnd)
+        return false;
+    if (!out.seek(scannedEnd) || out.write(records) != records.size())
+        return false;
+    out.close();
+
+    if (!refresh())
+        return false;
+    if (logSize() > qMax(minimumCompactionLogSize, qint64(indexOffset)))
+        return compact();
+    return true;
+}
+
+/*
+    Replaces the file with a snapshot of its current contents.
+*/
+bool QSettingsBinaryStore::compact()
+{
+    return writeSnapshot(snapshotEntries());
+}
+
+/*
+    Returns all settings with their encoded values. Records that don't fit
+    in the file are skipped.
+*/
+QMap<QString, QByteArray> QSettingsBinaryStore::snapshotEntries() const
+{
+    QMap<QString, QByteArray> entries;
+    if (data) {
+        for (qint64 pos = HeaderSize; pos < indexOffset; pos += recordSize(data + pos)) {
+            const uchar *record = snapshotRecord(pos);
+            if (!record)
+                break;
+            entries.insert(recordKey(record), QByteArray(reinterpret_cast<const char *>(recordValue(record)),
+                                                         recordValueLength(record)));
+        }
+        for (auto it = log.cbegin(), end = log.cend(); it != end; ++it) {
+            const uchar *record = data + it.value();
+            if (recordValueLength(record) == removedValue) {
+                entries.remove(it.key());
+            } else {
+                entries.insert(it.key(), QByteArray(reinterpret_cast<const char *>(recordValue(record)),
+                                                    recordValueLength(record)));
+            }
+        }
+    }
+    return entries;
+}
+
+bool QSettingsBinaryStore::writeSnapshot(const QMap<QString, QByteArray> &entries)
+{
+    QByteArray out(HeaderSize, '\0');
+    QVector<quint32> offsets;
+    offsets.reserve(entries.size());
+    for (auto it = entries.cbegin(), end = entries.cend(); it != end; ++it) {
+        offsets.append(out.size());
+        appendRecord(&out, it.key(), &it.value());
+    }
+
+    // at most half full, so that probe sequences stay short
+    const quint32 newBucketCount = qNextPowerOfTwo(quint32(2 * entries.size()));
+    QVector<quint32> index(newBucketCount, 0);
+    for (quint32 offset : qAsConst(offsets)) {
+        quint32 bucket = qFromLittleEndian<quint32>(out.constData() + offset) & (newBucketCount - 1);
+        while (index.at(bucket))
+            bucket = (bucket + 1) & (newBucketCount - 1);
+        index[bucket] = offset;
+    }
+
+    // the records were written in key order
+    const qint64 newIndexOffset = out.size();
+    const qint64 sortedOffset = newIndexOffset + 4 * newBucketCount;
+    out.resize(sortedOffset + 4 * offsets.size());
+    uchar *p = reinterpret_cast<uchar *>(out.data());
+    for (quint32 i = 0; i < newBucketCount; ++i)
+        qToLittleEndian<quint32>(index.at(i), p + newIndexOffset + 4 * i);
+    for (int i = 0; i < offsets.size(); ++i)
+        qToLittleEndian<quint32>(offsets.at(i), p + sortedOffset + 4 * i);
+
+    memcpy(p, binaryStoreMagic, sizeof(binaryStoreMagic));
+    qToLittleEndian<quint32>(binaryStoreVersion, p + 8);
+    quint32 generation;
+    do {
+        generation = QRandomGenerator::global()->generate();
+    } while (!generation || generation == currentGeneration);
+    qToLittleEndian<quint32>(generation, p + 12);
+    qToLittleEndian<quint32>(newIndexOffset, p + 16);
+    qToLittleEndian<quint32>(newBucketCount, p + 20);
+    qToLittleEndian<quint32>(out.size(), p + 24);
+    qToLittleEndian<quint32>(binaryStoreStreamVersion, p + 28);
+
+    // other processes may have the file mapped, so never write it in place
+    QSaveFile saveFile(fileName);
+    if (!saveFile.open(QIODevice::WriteOnly) || saveFile.write(out) != out.size()
+            || !saveFile.commit()) {
+        return false;
+    }
+    return open();
+}
+
+QT_END_NAMESPACE
+
+#endif // QSETTINGS_USE_BINARY_STORE
+
+#endif // QT_NO_SETTINGS
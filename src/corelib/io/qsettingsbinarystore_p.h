@@ -0,0 +1,116 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSETTINGSBINARYSTORE_P_H
+#define QSETTINGSBINARYSTORE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qsettings_p.h"
+
+#include "QtCore/qdatetime.h"
+#include "QtCore/qfile.h"
+#include "QtCore/qmap.h"
+
+#ifdef QSETTINGS_USE_BINARY_STORE
+
+QT_BEGIN_NAMESPACE
+
+class Q_AUTOTEST_EXPORT QSettingsBinaryStore
+{
+public:
+    explicit QSettingsBinaryStore(const QString &fileName);
+    ~QSettingsBinaryStore();
+
+    bool refresh();
+    bool update(const ParsedSettingsMap &addedKeys, const ParsedSettingsMap &removedKeys);
+    bool compact();
+
+    bool contains(const QString &key) const;
+    bool value(const QString &key, QVariant *value) const;
+    QStringList keys(const QString &prefix) const;
+
+    qint64 size() const { return mappedSize; }
+    int generation() const { return int(currentGeneration); }
+    qint64 logSize() const { return scannedEnd - logOffset; }
+
+private:
+    Q_DISABLE_COPY(QSettingsBinaryStore)
+
+    void reset();
+    bool open();
+    void scanLog();
+    const uchar *snapshotRecord(qint64 offset) const;
+    quint32 findRecord(const QString &key) const;
+    const uchar *sortedRecord(quint32 i) const;
+    QMap<QString, QByteArray> snapshotEntries() const;
+    bool writeSnapshot(const QMap<QString, QByteArray> &entries);
+
+    QString fileName;
+    QFile file;
+    const uchar *data;
+    qint64 mappedSize;
+    QDateTime lastModified;
+    quint32 currentGeneration;
+    quint32 indexOffset;
+    quint32 bucketCount;
+    quint32 sortedCount;
+    quint32 logOffset;
+    int streamVersion;
+    qint64 scannedEnd;
+
+    // the latest log record of every key written since the last compaction,
+    // ordered so that the keys under a group can be found without a full scan
+    QMap<QString, quint32> log;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSETTINGS_USE_BINARY_STORE
+
+#endif // QSETTINGSBINARYSTORE_P_H
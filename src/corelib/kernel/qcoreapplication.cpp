@@ -372,6 +372,10 @@ bool QCoreApplicationPrivate::is_app_closing = false;
 Q_CORE_EXPORT uint qGlobalPostedEventsCount()
 {
     QThreadData *currentThreadData = QThreadData::current();
+    if (currentThreadData->postEventList.hasIncomingEvents()) {
+        QMutexLocker locker(&currentThreadData->postEventList.mutex);
+        currentThreadData->postEventList.addIncomingEvents();
+    }
     return currentThreadData->postEventList.size() - currentThreadData->postEventList.startOffset;
 }
 
@@ -520,6 +524,7 @@ void QCoreApplicationPrivate::cleanupThreadData()
 
         // need to clear the state of the mainData, just in case a new QCoreApplication comes along.
         QMutexLocker locker(&threadData->postEventList.mutex);
+        threadData->postEventList.addIncomingEvents();
         for (int i = 0; i < threadData->postEventList.size(); ++i) {
             const QPostEvent &pe = threadData->postEventList.at(i);
             if (pe.event) {
@@ -1474,6 +1479,9 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
 
     QMutexUnlocker locker(&data->postEventList.mutex);
 
+    // keep the order with the events posted without the mutex
+    data->postEventList.addIncomingEvents();
+
     // if this is one of the compressible events, do compression
     if (receiver->d_func()->postedEvents
         && self && self->compressEvent(event, receiver, &data->postEventList)) {
@@ -1520,6 +1528,61 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
         dispatcher->wakeUp();
 }
 
+/*!
+    \internal
+
+    Posts the queued call \a event to \a receiver, like
+    QCoreApplication::postEvent() does with Qt::NormalEventPriority.
+
+    Queued calls are by far the most common posted events, often coming from
+    many threads at once, and they are never compressed. So instead of
+    fighting over the mutex of the receiving thread's QPostEventList, this
+    pushes them onto the list's lock-free stack and lets the receiving thread
+    sort them in (see QPostEventList::addIncomingEvents()).
+
+    Returns \c false if \a receiver is being destroyed; the event is not
+    posted then, and the caller has to delete it.
+*/
+bool QCoreApplicationPrivate::postMetaCallEvent(QObject *receiver, QMetaCallEvent *event)
+{
+    QThreadData * volatile * pdata = &receiver->d_func()->threadData;
+    QThreadData *data = *pdata;
+
+    // if object has moved to another thread, follow it. Announcing ourselves
+    // as a pusher first makes sure moveToThread() either sees us and waits,
+    // or we see its new thread data.
+    forever {
+        if (!data)
+            return false;
+        if (!data->postEventList.addPusher()) {
+            // someone holding the mutex waits for the pushers to finish;
+            // wait for the mutex instead of adding to their wait
+            data->postEventList.mutex.lock();
+            data->postEventList.mutex.unlock();
+            data = *pdata;
+            continue;
+        }
+        QThreadData *current = *pdata;
+        if (current == data)
+            break;
+        data->postEventList.removePusher();
+        data = current;
+    }
+
+    QPostEventNode *node = &event->postNode_;
+    node->receiver = receiver;
+    node->event = event;
+    event->posted = true;
+    receiver->d_func()->incomingEvents.ref();
+    data->postEventList.push(node);
+    data->postEventList.removePusher();
+
+    QAbstractEventDispatcher* dispatcher = data->eventDispatcher.loadAcquire();
+    if (dispatcher)
+        dispatcher->wakeUp();
+    return true;
+}
+
 /*!
   \internal
   Returns \c true if \a event was compressed away (possibly deleted) and should not be added to the list.
@@ -1616,6 +1679,7 @@ void QCoreApplicationPrivate::sendPostedEvents(QObject *receiver, int event_type
     ++data->postEventList.recursion;
 
     QMutexLocker locker(&data->postEventList.mutex);
+    data->postEventList.addIncomingEvents();
 
     // by default, we assume that the event dispatcher can go to sleep after
     // processing all events. if any new events are posted while we send
@@ -1776,6 +1840,11 @@ void QCoreApplication::removePostedEvents(QObject *receiver, int eventType)
 {
     QThreadData *data = receiver ? receiver->d_func()->threadData : QThreadData::current();
     QMutexLocker locker(&data->postEventList.mutex);
+    // let the queued calls that are being posted without the mutex land
+    // first, so that they are removed as well
+    data->postEventList.blockPushers();
+    data->postEventList.addIncomingEvents();
+    data->postEventList.unblockPushers();
 
     // the QObject destructor calls this function directly.  this can
     // happen while the event loop is in the middle of posting events,
@@ -1841,6 +1910,7 @@ void QCoreApplicationPrivate::removePostedEvent(QEvent * event)
     QThreadData *data = QThreadData::current();
 
     QMutexLocker locker(&data->postEventList.mutex);
+    data->postEventList.addIncomingEvents();
 
     if (data->postEventList.size() == 0) {
 #if defined(QT_DEBUG)
@@ -106,6 +106,7 @@ public:
     virtual void createEventDispatcher();
     virtual void eventDispatcherReady();
     static void removePostedEvent(QEvent *);
+    static bool postMetaCallEvent(QObject *receiver, QMetaCallEvent *event);
 #ifdef Q_OS_WIN
     static void removePostedTimerEvent(QObject *object, int timerId);
 #endif
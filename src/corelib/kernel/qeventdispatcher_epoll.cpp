@@ -0,0 +1,571 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qplatformdefs.h"
+
+#include "qcoreapplication.h"
+#include "qsocketnotifier.h"
+#include "qthread.h"
+
+#include "qeventdispatcher_epoll_p.h"
+#include <private/qthread_p.h>
+#include <private/qcoreapplication_p.h>
+#include <private/qcore_unix_p.h>
+
+#include <errno.h>
+#include <stdio.h>
+
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    QEventDispatcherEpoll is an alternative to QEventDispatcherUNIX for
+    Linux processes that keep a large number of socket notifiers around
+    (servers with thousands of mostly idle connections). Instead of
+    rebuilding a pollfd array from every registered notifier on each
+    iteration, the interest set lives in the kernel and is only updated
+    when a notifier is enabled or disabled. epoll_wait() then hands back
+    just the ready descriptors, so the cost of one iteration scales with
+    the number of active descriptors rather than the number of registered
+    ones. Timer deadlines are delivered through a timerfd that is part of
+    the same epoll set, which gives us nanosecond resolution instead of
+    epoll_wait()'s millisecond timeout.
+
+    The descriptors are registered level-triggered on purpose: a socket
+    notifier keeps firing for as long as the condition holds, and classes
+    such as QAbstractSocket rely on that when they leave data in the kernel
+    buffer. Edge-triggered registration would silently lose those wakeups.
+
+    The dispatcher is opt-in: set QT_EVENT_DISPATCHER_EPOLL=1 in the
+    environment before the thread (or the application) is created.
+*/
+
+enum { MaxEpollEvents = 256 };
+
+static const char *socketType(QSocketNotifier::Type type)
+{
+    switch (type) {
+    case QSocketNotifier::Read:
+        return "Read";
+    case QSocketNotifier::Write:
+        return "Write";
+    case QSocketNotifier::Exception:
+        return "Exception";
+    }
+
+    Q_UNREACHABLE();
+}
+
+static uint epollEvents(const QSocketNotifierSetUNIX &sn_set)
+{
+    uint result = 0;
+
+    if (sn_set.notifiers[QSocketNotifier::Read])
+        result |= EPOLLIN;
+
+    if (sn_set.notifiers[QSocketNotifier::Write])
+        result |= EPOLLOUT;
+
+    if (sn_set.notifiers[QSocketNotifier::Exception])
+        result |= EPOLLPRI;
+
+    return result;
+}
+
+QEventDispatcherEpollPrivate::QEventDispatcherEpollPrivate()
+    : epollFd(-1), timerFd(-1), timerFdArmed(false)
+{
+    if (Q_UNLIKELY(threadPipe.init() == false))
+        qFatal("QEventDispatcherEpollPrivate(): Can not continue without a thread pipe");
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (Q_UNLIKELY(epollFd == -1))
+        qFatal("QEventDispatcherEpollPrivate(): Can not continue without epoll: %s",
+               qPrintable(qt_error_string(errno)));
+
+    timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (Q_UNLIKELY(timerFd == -1))
+        qFatal("QEventDispatcherEpollPrivate(): Can not continue without a timerfd: %s",
+               qPrintable(qt_error_string(errno)));
+
+    epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.fd = threadPipe.fds[0];
+    if (Q_UNLIKELY(epoll_ctl(epollFd, EPOLL_CTL_ADD, ev.data.fd, &ev) == -1))
+        qFatal("QEventDispatcherEpollPrivate(): Can not watch the thread pipe: %s",
+               qPrintable(qt_error_string(errno)));
+
+    ev.events = EPOLLIN;
+    ev.data.fd = timerFd;
+    if (Q_UNLIKELY(epoll_ctl(epollFd, EPOLL_CTL_ADD, ev.data.fd, &ev) == -1))
+        qFatal("QEventDispatcherEpollPrivate(): Can not watch the timerfd: %s",
+               qPrintable(qt_error_string(errno)));
+}
+
+QEventDispatcherEpollPrivate::~QEventDispatcherEpollPrivate()
+{
+    qt_safe_close(timerFd);
+    qt_safe_close(epollFd);
+}
+
+/*!
+    \internal
+
+    Adds \a fd to the kernel interest set, or updates its event mask if
+    \a isNew is false. Returns false if the descriptor cannot be watched at
+    all (for instance because it has already been closed).
+*/
+bool QEventDispatcherEpollPrivate::updateInterest(int fd, const QSocketNotifierSetUNIX &sn_set, bool isNew)
+{
+    if (unpollableFds.contains(fd))
+        return true;
+
+    epoll_event ev;
+    ev.events = epollEvents(sn_set);
+    ev.data.fd = fd;
+
+    int op = isNew ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+    if (epoll_ctl(epollFd, op, fd, &ev) == 0)
+        return true;
+
+    switch (errno) {
+    case EEXIST:
+        // the descriptor was closed without unregistering its notifier and
+        // the number got reused while a dup() kept the old description alive
+        return epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &ev) == 0;
+    case ENOENT:
+        // the kernel dropped the descriptor behind our back when it was closed
+        return epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) == 0;
+    case EPERM:
+        // regular files and the like don't support epoll; poll() always
+        // reports them as ready, so emulate that
+        unpollableFds.insert(fd);
+        return true;
+    default:
+        return false;
+    }
+}
+
+void QEventDispatcherEpollPrivate::removeInterest(int fd)
+{
+    if (unpollableFds.remove(fd))
+        return;
+
+    // EBADF and ENOENT are expected when the descriptor was closed before
+    // its notifier got disabled: the kernel has already forgotten about it
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+void QEventDispatcherEpollPrivate::armTimerFd(const timespec *wait)
+{
+    itimerspec spec;
+    spec.it_interval.tv_sec = 0;
+    spec.it_interval.tv_nsec = 0;
+
+    if (wait) {
+        spec.it_value = *wait;
+    } else {
+        if (!timerFdArmed)
+            return;
+        spec.it_value.tv_sec = 0;
+        spec.it_value.tv_nsec = 0;
+    }
+
+    timerFdArmed = wait != nullptr;
+    timerfd_settime(timerFd, 0, &spec, nullptr);
+}
+
+void QEventDispatcherEpollPrivate::setSocketNotifierPending(QSocketNotifier *notifier)
+{
+    Q_ASSERT(notifier);
+
+    if (pendingNotifierSet.contains(notifier))
+        return;
+
+    pendingNotifierSet.insert(notifier);
+    pendingNotifiers << notifier;
+}
+
+int QEventDispatcherEpollPrivate::activateTimers()
+{
+    return timerList.activateTimers();
+}
+
+void QEventDispatcherEpollPrivate::markPendingSocketNotifiers(int fd, uint revents)
+{
+    auto it = socketNotifiers.constFind(fd);
+    if (it == socketNotifiers.cend())
+        return;
+
+    const QSocketNotifierSetUNIX &sn_set = it.value();
+
+    static const struct {
+        QSocketNotifier::Type type;
+        uint flags;
+    } notifiers[] = {
+        { QSocketNotifier::Read,      EPOLLIN  | EPOLLHUP | EPOLLERR },
+        { QSocketNotifier::Write,     EPOLLOUT | EPOLLHUP | EPOLLERR },
+        { QSocketNotifier::Exception, EPOLLPRI | EPOLLHUP | EPOLLERR }
+    };
+
+    for (const auto &n : notifiers) {
+        QSocketNotifier *notifier = sn_set.notifiers[n.type];
+
+        if (notifier && (revents & n.flags))
+            setSocketNotifierPending(notifier);
+    }
+}
+
+int QEventDispatcherEpollPrivate::activateSocketNotifiers()
+{
+    if (pendingNotifierSet.isEmpty()) {
+        pendingNotifiers.clear();
+        return 0;
+    }
+
+    int n_activated = 0;
+    QEvent event(QEvent::SockAct);
+
+    // notifiers that are unregistered by the slots are no longer in the set
+    const QVector<QSocketNotifier *> notifiers = std::move(pendingNotifiers);
+    pendingNotifiers.clear();
+    for (QSocketNotifier *notifier : notifiers) {
+        if (!pendingNotifierSet.remove(notifier))
+            continue;
+        QCoreApplication::sendEvent(notifier, &event);
+        ++n_activated;
+    }
+
+    return n_activated;
+}
+
+QEventDispatcherEpoll::QEventDispatcherEpoll(QObject *parent)
+    : QAbstractEventDispatcher(*new QEventDispatcherEpollPrivate, parent)
+{ }
+
+QEventDispatcherEpoll::QEventDispatcherEpoll(QEventDispatcherEpollPrivate &dd, QObject *parent)
+    : QAbstractEventDispatcher(dd, parent)
+{ }
+
+QEventDispatcherEpoll::~QEventDispatcherEpoll()
+{ }
+
+/*!
+    \internal
+*/
+void QEventDispatcherEpoll::registerTimer(int timerId, int interval, Qt::TimerType timerType, QObject *obj)
+{
+#ifndef QT_NO_DEBUG
+    if (timerId < 1 || interval < 0 || !obj) {
+        qWarning("QEventDispatcherEpoll::registerTimer: invalid arguments");
+        return;
+    } else if (obj->thread() != thread() || thread() != QThread::currentThread()) {
+        qWarning("QEventDispatcherEpoll::registerTimer: timers cannot be started from another thread");
+        return;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    d->timerList.registerTimer(timerId, interval, timerType, obj);
+}
+
+/*!
+    \internal
+*/
+bool QEventDispatcherEpoll::unregisterTimer(int timerId)
+{
+#ifndef QT_NO_DEBUG
+    if (timerId < 1) {
+        qWarning("QEventDispatcherEpoll::unregisterTimer: invalid argument");
+        return false;
+    } else if (thread() != QThread::currentThread()) {
+        qWarning("QEventDispatcherEpoll::unregisterTimer: timers cannot be stopped from another thread");
+        return false;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    return d->timerList.unregisterTimer(timerId);
+}
+
+/*!
+    \internal
+*/
+bool QEventDispatcherEpoll::unregisterTimers(QObject *object)
+{
+#ifndef QT_NO_DEBUG
+    if (!object) {
+        qWarning("QEventDispatcherEpoll::unregisterTimers: invalid argument");
+        return false;
+    } else if (object->thread() != thread() || thread() != QThread::currentThread()) {
+        qWarning("QEventDispatcherEpoll::unregisterTimers: timers cannot be stopped from another thread");
+        return false;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    return d->timerList.unregisterTimers(object);
+}
+
+QList<QEventDispatcherEpoll::TimerInfo>
+QEventDispatcherEpoll::registeredTimers(QObject *object) const
+{
+    if (!object) {
+        qWarning("QEventDispatcherEpoll:registeredTimers: invalid argument");
+        return QList<TimerInfo>();
+    }
+
+    Q_D(const QEventDispatcherEpoll);
+    return d->timerList.registeredTimers(object);
+}
+
+void QEventDispatcherEpoll::registerSocketNotifier(QSocketNotifier *notifier)
+{
+    Q_ASSERT(notifier);
+    int sockfd = notifier->socket();
+    QSocketNotifier::Type type = notifier->type();
+#ifndef QT_NO_DEBUG
+    if (notifier->thread() != thread() || thread() != QThread::currentThread()) {
+        qWarning("QSocketNotifier: socket notifiers cannot be enabled from another thread");
+        return;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    QSocketNotifierSetUNIX &sn_set = d->socketNotifiers[sockfd];
+    const bool isNew = sn_set.isEmpty();
+
+    if (sn_set.notifiers[type] && sn_set.notifiers[type] != notifier)
+        qWarning("%s: Multiple socket notifiers for same socket %d and type %s",
+                 Q_FUNC_INFO, sockfd, socketType(type));
+
+    sn_set.notifiers[type] = notifier;
+
+    if (Q_UNLIKELY(!d->updateInterest(sockfd, sn_set, isNew))) {
+        // this is what QEventDispatcherUNIX does when poll() says POLLNVAL
+        qWarning("QSocketNotifier: Invalid socket %d with type %s, disabling...",
+                 sockfd, socketType(type));
+        notifier->setEnabled(false);
+    }
+}
+
+void QEventDispatcherEpoll::unregisterSocketNotifier(QSocketNotifier *notifier)
+{
+    Q_ASSERT(notifier);
+    int sockfd = notifier->socket();
+    QSocketNotifier::Type type = notifier->type();
+#ifndef QT_NO_DEBUG
+    if (notifier->thread() != thread() || thread() != QThread::currentThread()) {
+        qWarning("QSocketNotifier: socket notifier (fd %d) cannot be disabled from another thread.\n"
+                "(Notifier's thread is %s(%p), event dispatcher's thread is %s(%p), current thread is %s(%p))",
+                sockfd,
+                notifier->thread() ? notifier->thread()->metaObject()->className() : "QThread", notifier->thread(),
+                thread() ? thread()->metaObject()->className() : "QThread", thread(),
+                QThread::currentThread() ? QThread::currentThread()->metaObject()->className() : "QThread", QThread::currentThread());
+        return;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+
+    d->pendingNotifierSet.remove(notifier);
+
+    auto i = d->socketNotifiers.find(sockfd);
+    if (i == d->socketNotifiers.end())
+        return;
+
+    QSocketNotifierSetUNIX &sn_set = i.value();
+
+    if (sn_set.notifiers[type] == nullptr)
+        return;
+
+    if (sn_set.notifiers[type] != notifier) {
+        qWarning("%s: Multiple socket notifiers for same socket %d and type %s",
+                 Q_FUNC_INFO, sockfd, socketType(type));
+        return;
+    }
+
+    sn_set.notifiers[type] = nullptr;
+
+    if (sn_set.isEmpty()) {
+        d->socketNotifiers.erase(i);
+        d->removeInterest(sockfd);
+    } else {
+        d->updateInterest(sockfd, sn_set, false);
+    }
+}
+
+bool QEventDispatcherEpoll::processEvents(QEventLoop::ProcessEventsFlags flags)
+{
+    Q_D(QEventDispatcherEpoll);
+    d->interrupt.store(0);
+
+    // we are awake, broadcast it
+    emit awake();
+    QCoreApplicationPrivate::sendPostedEvents(0, 0, d->threadData);
+
+    const bool include_timers = (flags & QEventLoop::X11ExcludeTimers) == 0;
+    const bool include_notifiers = (flags & QEventLoop::ExcludeSocketNotifiers) == 0;
+    const bool wait_for_events = flags & QEventLoop::WaitForMoreEvents;
+
+    const bool canWait = (d->threadData->canWaitLocked()
+                          && !d->interrupt.load()
+                          && wait_for_events);
+
+    if (canWait)
+        emit aboutToBlock();
+
+    if (d->interrupt.load())
+        return false;
+
+    timespec *tm = nullptr;
+    timespec wait_tm = { 0, 0 };
+
+    if (!canWait || (include_timers && d->timerList.timerWait(wait_tm)))
+        tm = &wait_tm;
+
+    int nevents = 0;
+
+    if (!include_notifiers) {
+        // The interest set is permanent, so we can't wait on it without
+        // spinning on descriptors that are ready but must not be reported.
+        // Fall back to waiting for the thread pipe alone, like
+        // QEventDispatcherUNIX does in this case.
+        pollfd pfd = d->threadPipe.prepare();
+        switch (qt_safe_poll(&pfd, 1, tm)) {
+        case -1:
+            perror("qt_safe_poll");
+            break;
+        case 0:
+            break;
+        default:
+            nevents += d->threadPipe.check(pfd);
+            break;
+        }
+    } else {
+        // descriptors epoll won't watch are always ready: don't block
+        if (!d->unpollableFds.isEmpty()) {
+            wait_tm.tv_sec = 0;
+            wait_tm.tv_nsec = 0;
+            tm = &wait_tm;
+        }
+
+        int timeout = -1;
+        if (tm && tm->tv_sec == 0 && tm->tv_nsec == 0) {
+            timeout = 0;
+            d->armTimerFd(nullptr);
+        } else {
+            d->armTimerFd(tm);
+        }
+
+        epoll_event events[MaxEpollEvents];
+        int n;
+        EINTR_LOOP(n, epoll_wait(d->epollFd, events, MaxEpollEvents, timeout));
+        if (n == -1)
+            perror("epoll_wait");
+
+        for (int i = 0; i < n; ++i) {
+            const int fd = events[i].data.fd;
+            if (fd == d->threadPipe.fds[0]) {
+                pollfd pfd = d->threadPipe.prepare();
+                pfd.revents = POLLIN;
+                nevents += d->threadPipe.check(pfd);
+            } else if (fd == d->timerFd) {
+                // consume the expiration count; the timers are checked below
+                quint64 expirations;
+                qt_safe_read(d->timerFd, &expirations, sizeof(expirations));
+                d->timerFdArmed = false;
+            } else {
+                d->markPendingSocketNotifiers(fd, events[i].events);
+            }
+        }
+
+        for (int fd : qAsConst(d->unpollableFds))
+            d->markPendingSocketNotifiers(fd, EPOLLIN | EPOLLOUT);
+
+        nevents += d->activateSocketNotifiers();
+    }
+
+    if (include_timers)
+        nevents += d->activateTimers();
+
+    // return true if we handled events, false otherwise
+    return (nevents > 0);
+}
+
+bool QEventDispatcherEpoll::hasPendingEvents()
+{
+    extern uint qGlobalPostedEventsCount(); // from qapplication.cpp
+    return qGlobalPostedEventsCount();
+}
+
+int QEventDispatcherEpoll::remainingTime(int timerId)
+{
+#ifndef QT_NO_DEBUG
+    if (timerId < 1) {
+        qWarning("QEventDispatcherEpoll::remainingTime: invalid argument");
+        return -1;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    return d->timerList.timerRemainingTime(timerId);
+}
+
+void QEventDispatcherEpoll::wakeUp()
+{
+    Q_D(QEventDispatcherEpoll);
+    d->threadPipe.wakeUp();
+}
+
+void QEventDispatcherEpoll::interrupt()
+{
+    Q_D(QEventDispatcherEpoll);
+    d->interrupt.store(1);
+    wakeUp();
+}
+
+void QEventDispatcherEpoll::flush()
+{ }
+
+QT_END_NAMESPACE
+
+#include "moc_qeventdispatcher_epoll_p.cpp"
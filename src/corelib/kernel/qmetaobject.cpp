@@ -52,6 +52,7 @@
 #include <qdebug.h>
 #include <qsemaphore.h>
 
+#include "private/qcoreapplication_p.h"
 #include "private/qobject_p.h"
 #include "private/qmetaobject_p.h"
 
@@ -1523,7 +1524,9 @@ bool QMetaObject::invokeMethodImpl(QObject *object, QtPrivate::QSlotObjectBase *
         int *types = static_cast<int *>(calloc(1, sizeof(int)));
         Q_CHECK_PTR(types);
 
-        QCoreApplication::postEvent(object, new QMetaCallEvent(slot, 0, -1, 1, types, args));
+        QMetaCallEvent *event = new QMetaCallEvent(slot, 0, -1, 1, types, args);
+        if (!QCoreApplicationPrivate::postMetaCallEvent(object, event))
+            delete event;
     } else if (type == Qt::BlockingQueuedConnection) {
 #ifndef QT_NO_THREAD
         if (currentThread == objectThread)
@@ -2330,8 +2333,10 @@ bool QMetaMethod::invoke(QObject *object,
             }
         }
 
-        QCoreApplication::postEvent(object, new QMetaCallEvent(idx_offset, idx_relative, callFunction,
-                                                        0, -1, nargs, types, args));
+        QMetaCallEvent *event = new QMetaCallEvent(idx_offset, idx_relative, callFunction,
+                                                   0, -1, nargs, types, args);
+        if (!QCoreApplicationPrivate::postMetaCallEvent(object, event))
+            delete event;
     } else { // blocking queued connection
 #ifndef QT_NO_THREAD
         if (currentThread == objectThread) {
@@ -59,11 +59,13 @@
 #include <qset.h>
 #include <qsemaphore.h>
 #include <qsharedpointer.h>
+#include <qpointer.h>
 
 #include <private/qorderedmutexlocker_p.h>
 #include <private/qhooks_p.h>
 
 #include <new>
+#include <cstddef>
 
 #include <ctype.h>
 #include <limits.h>
@@ -204,7 +206,8 @@ QMetaObject *QObjectData::dynamicMetaObject() const
 }
 
 QObjectPrivate::QObjectPrivate(int version)
-    : threadData(0), connectionLists(0), senders(0), currentSender(0), currentChildBeingDeleted(0)
+    : threadData(0), connectionLists(0), senders(0), currentSender(0), currentChildBeingDeleted(0),
+      incomingEvents(0)
 {
 #ifdef QT_BUILD_INTERNAL
     // Don't check the version parameter in internal builds.
@@ -249,7 +252,7 @@ QObjectPrivate::~QObjectPrivate()
         }
     }
 
-    if (postedEvents)
+    if (postedEvents || incomingEvents.load())
         QCoreApplication::removePostedEvents(q_ptr, 0);
 
     threadData->deref();
@@ -497,13 +500,23 @@ QMetaCallEvent::~QMetaCallEvent()
     \internal
  */
 void QMetaCallEvent::placeMetaCall(QObject *object)
+{
+    callSlot(object, args_);
+}
+
+/*!
+    \internal
+
+    Invokes the slot of this event on \a object with the arguments \a args.
+ */
+void QMetaCallEvent::callSlot(QObject *object, void **args)
 {
     if (slotObj_) {
-        slotObj_->call(object, args_);
+        slotObj_->call(object, args);
     } else if (callFunction_ && method_offset_ <= object->metaObject()->methodOffset()) {
-        callFunction_(object, QMetaObject::InvokeMetaMethod, method_relative_, args_);
+        callFunction_(object, QMetaObject::InvokeMetaMethod, method_relative_, args);
     } else {
-        QMetaObject::metacall(object, QMetaObject::InvokeMetaMethod, method_offset_ + method_relative_, args_);
+        QMetaObject::metacall(object, QMetaObject::InvokeMetaMethod, method_offset_ + method_relative_, args);
     }
 }
 
@@ -1501,9 +1514,36 @@ void QObject::moveToThread(QThread *targetThread)
     // keep currentData alive (since we've got it locked)
     currentData->ref();
 
+    // bring in the events posted without the mutex, so that they move along
+    currentData->postEventList.addIncomingEvents();
+    targetData->postEventList.addIncomingEvents();
+
     // move the object
     d_func()->setThreadData_helper(currentData, targetData);
 
+    // QCoreApplicationPrivate::postMetaCallEvent() may have picked the old
+    // list for our objects just before they moved; move what it pushed there
+    // as well
+    currentData->postEventList.blockPushers();
+    if (currentData->postEventList.hasIncomingEvents()) {
+        currentData->postEventList.addIncomingEvents();
+        int eventsMoved = 0;
+        for (int i = 0; i < currentData->postEventList.size(); ++i) {
+            const QPostEvent &pe = currentData->postEventList.at(i);
+            if (pe.event && pe.receiver->d_func()->threadData == targetData) {
+                targetData->postEventList.addEvent(pe);
+                const_cast<QPostEvent &>(pe).event = 0;
+                ++eventsMoved;
+            }
+        }
+        if (eventsMoved > 0 && targetData->hasEventDispatcher()) {
+            targetData->canWait = false;
+            targetData->eventDispatcher.load()->wakeUp();
+        }
+    }
+
+    currentData->postEventList.unblockPushers();
+
     locker.unlock();
 
     // now currentData can commit suicide if it wants to
@@ -3308,7 +3348,8 @@ QObjectPrivate::Connection *QMetaObjectPrivate::connect(const QObject *sender,
     c->receiver = r;
     c->method_relative = method_index;
     c->method_offset = method_offset;
-    c->connectionType = type;
+    c->connectionType = type & ~Qt::BatchedConnection;
+    c->isBatched = (type & Qt::BatchedConnection) != 0;
     c->isSlotObject = false;
     c->argumentTypes.store(types);
     c->nextConnectionList = 0;
@@ -3563,6 +3604,138 @@ void QMetaObject::connectSlotsByName(QObject *o)
     }
 }
 
+/*!
+    \internal
+
+    The emissions of a Qt::BatchedConnection that happened before its receiver
+    got to the first one; see queued_activate().
+*/
+class QBatchedMetaCallEvent : public QMetaCallEvent
+{
+public:
+    QBatchedMetaCallEvent(QObjectPrivate::Connection *c, const QObject *sender, int signalId)
+        : QMetaCallEvent(c->method_offset, c->method_relative, c->callFunction, sender, signalId),
+          connection(c)
+    {
+        connection->ref();
+    }
+
+    QBatchedMetaCallEvent(QtPrivate::QSlotObjectBase *slotObj, QObjectPrivate::Connection *c,
+                          const QObject *sender, int signalId)
+        : QMetaCallEvent(slotObj, sender, signalId), connection(c)
+    {
+        connection->ref();
+    }
+
+    ~QBatchedMetaCallEvent();
+
+    void placeMetaCall(QObject *object) override;
+
+    static void **createCall(const int *argumentTypes, int nargs, void **argv);
+    static void destroyCall(const int *argumentTypes, int nargs, void **call);
+
+    // the argument blocks of the emissions, in order; appended to by
+    // queued_activate() while this event is the connection's pendingBatch
+    QVector<void **> calls;
+
+private:
+    void detach();
+
+    QObjectPrivate::Connection *connection;
+};
+
+/*!
+    \internal
+
+    Copies the arguments \a argv of one emission into a single block, which
+    starts with the argument pointers to pass to the slot. Returns \nullptr
+    if the signal has no arguments.
+*/
+void **QBatchedMetaCallEvent::createCall(const int *argumentTypes, int nargs, void **argv)
+{
+    if (nargs == 1)
+        return nullptr;
+
+    // the arguments get the alignment of the block itself
+    const size_t alignment = alignof(std::max_align_t);
+    const size_t pointersSize = (nargs * sizeof(void *) + alignment - 1) & ~(alignment - 1);
+    QVarLengthArray<size_t, 8> sizes(nargs);
+    size_t size = pointersSize;
+    for (int n = 1; n < nargs; ++n) {
+        sizes[n] = (size_t(QMetaType::sizeOf(argumentTypes[n-1])) + alignment - 1) & ~(alignment - 1);
+        size += sizes[n];
+    }
+
+    void **call = static_cast<void **>(malloc(size));
+    Q_CHECK_PTR(call);
+    char *data = reinterpret_cast<char *>(call) + pointersSize;
+    call[0] = nullptr; // return value
+    for (int n = 1; n < nargs; ++n) {
+        call[n] = QMetaType::construct(argumentTypes[n-1], data, argv[n]);
+        data += sizes[n];
+    }
+    return call;
+}
+
+/*!
+    \internal
+
+    Destroys an argument block created by createCall().
+*/
+void QBatchedMetaCallEvent::destroyCall(const int *argumentTypes, int nargs, void **call)
+{
+    if (!call)
+        return;
+    for (int n = 1; n < nargs; ++n)
+        QMetaType::destruct(argumentTypes[n-1], call[n]);
+    free(call);
+}
+
+QBatchedMetaCallEvent::~QBatchedMetaCallEvent()
+{
+    detach();
+
+    const int *argumentTypes = connection->argumentTypes.load();
+    int nargs = 1;
+    while (argumentTypes[nargs-1])
+        ++nargs;
+    for (void **call : qAsConst(calls))
+        destroyCall(argumentTypes, nargs, call);
+
+    connection->deref();
+}
+
+/*!
+    \internal
+
+    Makes sure that no more emissions get added to this event.
+*/
+void QBatchedMetaCallEvent::detach()
+{
+    QMutexLocker locker(signalSlotLock(sender()));
+    if (connection->pendingBatch == this)
+        connection->pendingBatch = nullptr;
+}
+
+void QBatchedMetaCallEvent::placeMetaCall(QObject *object)
+{
+    detach();
+
+    void *noArguments[] = { nullptr };
+    if (calls.size() == 1) {
+        callSlot(object, calls.first() ? calls.first() : noArguments);
+        return;
+    }
+
+    // the slot might delete the receiver
+    QPointer<QObject> guard(object);
+    for (void **call : qAsConst(calls)) {
+        callSlot(object, call ? call : noArguments);
+        if (!guard)
+            break;
+    }
+}
+
 /*!
     \internal
 
@@ -3588,6 +3761,44 @@ static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connect
     int nargs = 1; // include return type
     while (argumentTypes[nargs-1])
         ++nargs;
+
+    if (c->isBatched) {
+        void **call = nullptr;
+        if (nargs > 1) {
+            locker.unlock();
+            call = QBatchedMetaCallEvent::createCall(argumentTypes, nargs, argv);
+            locker.relock();
+
+            if (!c->receiver) {
+                locker.unlock();
+                // we have been disconnected while the mutex was unlocked
+                QBatchedMetaCallEvent::destroyCall(argumentTypes, nargs, call);
+                locker.relock();
+                return;
+            }
+        }
+
+        // add to the call that the receiver hasn't got to yet, if any
+        if (c->pendingBatch) {
+            static_cast<QBatchedMetaCallEvent *>(c->pendingBatch)->calls.append(call);
+            return;
+        }
+
+        QBatchedMetaCallEvent *ev = c->isSlotObject ?
+            new QBatchedMetaCallEvent(c->slotObj, c, sender, signal) :
+            new QBatchedMetaCallEvent(c, sender, signal);
+        ev->calls.append(call);
+        c->pendingBatch = ev;
+        if (!QCoreApplicationPrivate::postMetaCallEvent(c->receiver, ev)) {
+            // the event's destructor takes the lock to detach itself
+            c->pendingBatch = nullptr;
+            locker.unlock();
+            delete ev;
+            locker.relock();
+        }
+        return;
+    }
+
     int *types = (int *) malloc(nargs*sizeof(int));
     Q_CHECK_PTR(types);
     void **args = (void **) malloc(nargs*sizeof(void *));
@@ -3619,7 +3830,8 @@ static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connect
     QMetaCallEvent *ev = c->isSlotObject ?
         new QMetaCallEvent(c->slotObj, sender, signal, nargs, types, args) :
         new QMetaCallEvent(c->method_offset, c->method_relative, c->callFunction, sender, signal, nargs, types, args);
-    QCoreApplication::postEvent(c->receiver, ev);
+    if (!QCoreApplicationPrivate::postMetaCallEvent(c->receiver, ev))
+        delete ev;
 }
 
 /*!
@@ -4834,7 +5046,8 @@ QMetaObject::Connection QObjectPrivate::connectImpl(const QObject *sender, int s
     c->signal_index = signal_index;
     c->receiver = r;
     c->slotObj = slotObj;
-    c->connectionType = type;
+    c->connectionType = type & ~Qt::BatchedConnection;
+    c->isBatched = (type & Qt::BatchedConnection) != 0;
     c->isSlotObject = true;
     if (types) {
         c->argumentTypes.store(types);
@@ -66,6 +66,7 @@ QT_BEGIN_NAMESPACE
 
 class QVariant;
 class QThreadData;
+class QMetaCallEvent;
 class QObjectConnectionListVector;
 namespace QtSharedPointer { struct ExternalRefCountData; }
 
@@ -138,6 +139,8 @@ public:
         Connection *next;
         Connection **prev;
         QAtomicPointer<const int> argumentTypes;
+        // the undelivered call of a Qt::BatchedConnection, guarded by the sender's lock
+        QMetaCallEvent *pendingBatch;
         QAtomicInt ref_;
         ushort method_offset;
         ushort method_relative;
@@ -145,7 +148,8 @@ public:
         ushort connectionType : 3; // 0 == auto, 1 == direct, 2 == queued, 4 == blocking
         ushort isSlotObject : 1;
         ushort ownArgumentTypes : 1;
-        Connection() : nextConnectionList(nullptr), ref_(2), ownArgumentTypes(true) {
+        ushort isBatched : 1;
+        Connection() : nextConnectionList(nullptr), pendingBatch(nullptr), ref_(2), ownArgumentTypes(true), isBatched(false) {
             //ref_ is 2 for the use in the internal lists, and for the use in QMetaObject::Connection
         }
         ~Connection();
@@ -242,6 +246,10 @@ public:
     // these objects are all used to indicate that a QObject was deleted
     // plus QPointer, which keeps a separate list
     QAtomicPointer<QtSharedPointer::ExternalRefCountData> sharedRefcount;
+
+    // queued calls posted without the mutex of the post event list, which
+    // are not counted in postedEvents yet; see QPostEventList::addIncomingEvents()
+    QAtomicInt incomingEvents;
 };
 
 Q_DECLARE_TYPEINFO(QObjectPrivate::ConnectionList, Q_MOVABLE_TYPE);
@@ -372,6 +380,15 @@ Q_DECLARE_TYPEINFO(QObjectPrivate::Connection, Q_MOVABLE_TYPE);
 Q_DECLARE_TYPEINFO(QObjectPrivate::Sender, Q_MOVABLE_TYPE);
 
 class QSemaphore;
+// Links a queued call into the receiving thread's QPostEventList without
+// locking it, see QCoreApplicationPrivate::postMetaCallEvent()
+struct QPostEventNode
+{
+    QPostEventNode *next;
+    QObject *receiver;
+    QEvent *event;
+};
+
 class Q_CORE_EXPORT QMetaCallEvent : public QEvent
 {
 public:
@@ -392,6 +409,9 @@ public:
 
     virtual void placeMetaCall(QObject *object);
 
+protected:
+    void callSlot(QObject *object, void **args);
+
 private:
     QtPrivate::QSlotObjectBase *slotObj_;
     const QObject *sender_;
@@ -403,6 +423,9 @@ private:
     QObjectPrivate::StaticMetaCallFunction callFunction_;
     ushort method_offset_;
     ushort method_relative_;
+    QPostEventNode postNode_;
+
+    friend class QCoreApplicationPrivate;
 };
 
 class QBoolBlocker
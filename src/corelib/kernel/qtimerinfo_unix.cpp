@@ -46,6 +46,10 @@
 #include "private/qobject_p.h"
 #include "private/qabstracteventdispatcher_p.h"
 
+#include <qvarlengtharray.h>
+
+#include <algorithm>
+
 #ifdef QTIMERINFO_DEBUG
 #  include <QDebug>
 #  include <QThread>
@@ -57,6 +61,14 @@ QT_BEGIN_NAMESPACE
 
 Q_CORE_EXPORT bool qt_disable_lowpriority_timers=false;
 
+// the millisecond a point in time falls into; that's the wheel's resolution
+static inline quint64 timespecToTick(const timespec &t)
+{
+    if (t.tv_sec < 0)
+        return 0;
+    return quint64(t.tv_sec) * 1000 + quint64(t.tv_nsec) / (1000 * 1000);
+}
+
 /*
  * Internal functions for manipulating timer data structures.  The
  * timerBitVec array is used for keeping track of timer identifiers.
@@ -84,6 +96,18 @@ QTimerInfoList::QTimerInfoList()
 #endif
 
     firstTimerInfo = 0;
+
+    for (QTimerInfo *&head : wheel)
+        head = nullptr;
+    for (quint64 &bits : occupied)
+        bits = 0;
+    wheelTick = 0;
+    nextSequence = 0;
+}
+
+QTimerInfoList::~QTimerInfoList()
+{
+    qDeleteAll(timers);
 }
 
 timespec QTimerInfoList::updateCurrentTime()
@@ -150,10 +174,13 @@ bool QTimerInfoList::timeChanged(timespec *delta)
 */
 void QTimerInfoList::timerRepair(const timespec &diff)
 {
-    // repair all timers
-    for (int i = 0; i < size(); ++i) {
-        QTimerInfo *t = at(i);
+    // repair all timers; their ticks have changed, so rebuild the wheel
+    for (QTimerInfo *t : qAsConst(timers))
+        timerRemove(t);
+    wheelTick = timespecToTick(currentTime);
+    for (QTimerInfo *t : qAsConst(timers)) {
         t->timeout = t->timeout + diff;
+        timerInsert(t);
     }
 }
 
@@ -174,18 +201,222 @@ void QTimerInfoList::repairTimersIfNeeded()
 
 #endif
 
+// the order in which timers fire: by timeout, then first come, first served
+static inline bool firesBefore(const QTimerInfo *t1, const QTimerInfo *t2)
+{
+    if (t1->timeout != t2->timeout)
+        return t1->timeout < t2->timeout;
+    return t1->sequence < t2->sequence;
+}
+
+// dueTimers is sorted backwards, so that taking the next timer is cheap
+static inline bool firesAfter(const QTimerInfo *t1, const QTimerInfo *t2)
+{
+    return firesBefore(t2, t1);
+}
+
+void QTimerInfoList::linkTimer(QTimerInfo *t, int slot)
+{
+    t->slot = slot;
+    t->prev = nullptr;
+    t->next = wheel[slot];
+    if (t->next)
+        t->next->prev = t;
+    wheel[slot] = t;
+    if (slot < OverflowSlot)
+        occupied[slot >> LevelBits] |= Q_UINT64_C(1) << (slot & SlotMask);
+}
+
+void QTimerInfoList::unlinkTimer(QTimerInfo *t)
+{
+    if (t->prev)
+        t->prev->next = t->next;
+    else
+        wheel[t->slot] = t->next;
+    if (t->next)
+        t->next->prev = t->prev;
+    if (!wheel[t->slot] && t->slot < OverflowSlot)
+        occupied[t->slot >> LevelBits] &= ~(Q_UINT64_C(1) << (t->slot & SlotMask));
+    t->next = t->prev = nullptr;
+    t->slot = NoSlot;
+}
+
 /*
-  insert timer info into list
+  insert timer info into the wheel, or into the due list if its tick has
+  already been reached
 */
 void QTimerInfoList::timerInsert(QTimerInfo *ti)
 {
-    int index = size();
-    while (index--) {
-        const QTimerInfo * const t = at(index);
-        if (!(ti->timeout < t->timeout))
+    const quint64 tick = timespecToTick(ti->timeout);
+
+    if (tick <= wheelTick) {
+        ti->slot = DueSlot;
+        ti->next = ti->prev = nullptr;
+        dueTimers.insert(std::lower_bound(dueTimers.begin(), dueTimers.end(), ti, firesAfter), ti);
+        return;
+    }
+
+    // a timer goes to the lowest level whose window (the slots that level
+    // covers before it wraps around) contains its tick
+    for (int level = 0; level < Levels; ++level) {
+        const int shift = LevelBits * (level + 1);
+        if ((tick >> shift) == (wheelTick >> shift)) {
+            const int index = int(tick >> (LevelBits * level)) & SlotMask;
+            linkTimer(ti, level * SlotsPerLevel + index);
+            return;
+        }
+    }
+
+    linkTimer(ti, OverflowSlot);
+}
+
+/*
+  remove timer info from the wheel or the due list
+*/
+void QTimerInfoList::timerRemove(QTimerInfo *ti)
+{
+    if (ti->slot == DueSlot) {
+        auto it = std::lower_bound(dueTimers.begin(), dueTimers.end(), ti, firesAfter);
+        Q_ASSERT(it != dueTimers.end() && *it == ti);
+        dueTimers.erase(it);
+        ti->slot = NoSlot;
+    } else if (ti->slot != NoSlot) {
+        unlinkTimer(ti);
+    }
+}
+
+/*
+  redistribute the timers of \a slot, whose window has just been reached,
+  over the lower levels
+*/
+void QTimerInfoList::cascade(int slot)
+{
+    QTimerInfo *t = wheel[slot];
+    if (!t)
+        return;
+
+    wheel[slot] = nullptr;
+    if (slot < OverflowSlot)
+        occupied[slot >> LevelBits] &= ~(Q_UINT64_C(1) << (slot & SlotMask));
+
+    const int dueCount = dueTimers.size();
+    while (t) {
+        QTimerInfo *next = t->next;
+        const quint64 tick = timespecToTick(t->timeout);
+        if (tick <= wheelTick) {
+            // sorted below, all at once
+            t->slot = DueSlot;
+            t->next = t->prev = nullptr;
+            dueTimers.append(t);
+        } else {
+            timerInsert(t);
+        }
+        t = next;
+    }
+
+    if (dueTimers.size() != dueCount) {
+        std::sort(dueTimers.begin() + dueCount, dueTimers.end(), firesAfter);
+        std::inplace_merge(dueTimers.begin(), dueTimers.begin() + dueCount, dueTimers.end(), firesAfter);
+    }
+}
+
+/*
+  Returns the next tick at which a non-empty slot needs to be visited, or
+  ~0 if the wheel is empty. For level 0 this is the exact millisecond the
+  timers are due; for the other levels it is the start of the slot.
+*/
+quint64 QTimerInfoList::nextWheelTick() const
+{
+    quint64 next = ~Q_UINT64_C(0);
+
+    for (int level = 0; level < Levels; ++level) {
+        if (!occupied[level])
+            continue;
+        const int shift = LevelBits * level;
+        const int current = int(wheelTick >> shift) & SlotMask;
+        if (current == SlotMask)
+            continue;
+        const quint64 pending = occupied[level] & (~Q_UINT64_C(0) << (current + 1));
+        if (!pending)
+            continue;
+        const quint64 windowStart = (wheelTick >> (shift + LevelBits)) << (shift + LevelBits);
+        next = qMin(next, windowStart + (quint64(qCountTrailingZeroBits(pending)) << shift));
+    }
+
+    if (wheel[OverflowSlot]) {
+        const int shift = LevelBits * Levels;
+        next = qMin(next, ((wheelTick >> shift) + 1) << shift);
+    }
+
+    return next;
+}
+
+/*
+  Moves the wheel forward to \a currentTime, putting the timers whose tick
+  has been reached into the due list. Empty stretches of the wheel are
+  skipped, so this costs one step per visited slot, not per millisecond.
+*/
+void QTimerInfoList::advanceWheel(const timespec &currentTime)
+{
+    const quint64 now = timespecToTick(currentTime);
+
+    forever {
+        const quint64 next = nextWheelTick();
+        if (next > now)
             break;
+
+        wheelTick = next;
+
+        // cascade the slots whose window starts now, outermost first
+        if ((next & ((Q_UINT64_C(1) << (LevelBits * Levels)) - 1)) == 0)
+            cascade(OverflowSlot);
+        for (int level = Levels - 1; level > 0; --level) {
+            const int shift = LevelBits * level;
+            if ((next & ((Q_UINT64_C(1) << shift) - 1)) == 0)
+                cascade(level * SlotsPerLevel + (int(next >> shift) & SlotMask));
+        }
+        cascade(int(next) & SlotMask);
+    }
+
+    if (now > wheelTick)
+        wheelTick = now;
+}
+
+/*
+  Returns the first due timer that is not currently being activated, or
+  null if there is none.
+*/
+QTimerInfo *QTimerInfoList::firstDueTimer() const
+{
+    for (int i = dueTimers.size() - 1; i >= 0; --i) {
+        QTimerInfo *t = dueTimers.at(i);
+        if (!t->activateRef)
+            return t;
+    }
+    return nullptr;
+}
+
+void QTimerInfoList::linkObjectTimer(QTimerInfo *t)
+{
+    QTimerInfo *&head = timersByObject[t->obj];
+    t->objectPrev = nullptr;
+    t->objectNext = head;
+    if (head)
+        head->objectPrev = t;
+    head = t;
+}
+
+void QTimerInfoList::unlinkObjectTimer(QTimerInfo *t)
+{
+    if (t->objectNext)
+        t->objectNext->objectPrev = t->objectPrev;
+    if (t->objectPrev) {
+        t->objectPrev->objectNext = t->objectNext;
+    } else if (t->objectNext) {
+        timersByObject[t->obj] = t->objectNext;
+    } else {
+        timersByObject.remove(t->obj);
     }
-    insert(index+1, ti);
 }
 
 inline timespec &operator+=(timespec &t1, int ms)
@@ -387,28 +618,37 @@ bool QTimerInfoList::timerWait(timespec &tm)
 {
     timespec currentTime = updateCurrentTime();
     repairTimersIfNeeded();
+    advanceWheel(currentTime);
 
     // Find first waiting timer not already active
-    QTimerInfo *t = 0;
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (!(*it)->activateRef) {
-            t = *it;
-            break;
+    if (const QTimerInfo *t = firstDueTimer()) {
+        if (currentTime < t->timeout) {
+            // time to wait
+            tm = roundToMillisecond(t->timeout - currentTime);
+        } else {
+            // no time to wait
+            tm.tv_sec  = 0;
+            tm.tv_nsec = 0;
         }
+        return true;
     }
 
-    if (!t)
-      return false;
+    // Nothing is due yet: wait until the wheel reaches its next occupied
+    // slot. For the outer levels that's the start of the slot, which may be
+    // a bit early; we then just cascade and go back to sleep.
+    const quint64 next = nextWheelTick();
+    if (next == ~Q_UINT64_C(0))
+        return false;
 
-    if (currentTime < t->timeout) {
-        // time to wait
-        tm = roundToMillisecond(t->timeout - currentTime);
+    timespec nextTime;
+    nextTime.tv_sec = time_t(next / 1000);
+    nextTime.tv_nsec = long(next % 1000) * 1000 * 1000;
+    if (currentTime < nextTime) {
+        tm = roundToMillisecond(nextTime - currentTime);
     } else {
-        // no time to wait
         tm.tv_sec  = 0;
         tm.tv_nsec = 0;
     }
-
     return true;
 }
 
@@ -423,16 +663,13 @@ int QTimerInfoList::timerRemainingTime(int timerId)
     repairTimersIfNeeded();
     timespec tm = {0, 0};
 
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            if (currentTime < t->timeout) {
-                // time to wait
-                tm = roundToMillisecond(t->timeout - currentTime);
-                return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
-            } else {
-                return 0;
-            }
+    if (const QTimerInfo *t = timers.value(timerId)) {
+        if (currentTime < t->timeout) {
+            // time to wait
+            tm = roundToMillisecond(t->timeout - currentTime);
+            return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
+        } else {
+            return 0;
         }
     }
 
@@ -451,9 +688,16 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
     t->timerType = timerType;
     t->obj = object;
     t->activateRef = 0;
+    t->next = t->prev = nullptr;
+    t->slot = NoSlot;
+    t->sequence = nextSequence++;
 
     timespec expected = updateCurrentTime() + interval;
 
+    // nothing to catch up with if the wheel is empty
+    if (timers.isEmpty())
+        wheelTick = timespecToTick(currentTime);
+
     switch (timerType) {
     case Qt::PreciseTimer:
         // high precision timer is based on millisecond precision
@@ -493,6 +737,8 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
             ++t->timeout.tv_sec;
     }
 
+    timers.insert(timerId, t);
+    linkObjectTimer(t);
     timerInsert(t);
 
 #ifdef QTIMERINFO_DEBUG
@@ -508,56 +754,60 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
 bool QTimerInfoList::unregisterTimer(int timerId)
 {
     // set timer inactive
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            // found it
-            removeAt(i);
-            if (t == firstTimerInfo)
-                firstTimerInfo = 0;
-            if (t->activateRef)
-                *(t->activateRef) = 0;
-            delete t;
-            return true;
-        }
+    QTimerInfo *t = timers.take(timerId);
+    if (!t) {
+        // id not found
+        return false;
     }
-    // id not found
-    return false;
+
+    unlinkObjectTimer(t);
+    timerRemove(t);
+    if (t == firstTimerInfo)
+        firstTimerInfo = 0;
+    if (t->activateRef)
+        *(t->activateRef) = 0;
+    delete t;
+    return true;
 }
 
 bool QTimerInfoList::unregisterTimers(QObject *object)
 {
     if (isEmpty())
         return false;
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->obj == object) {
-            // object found
-            removeAt(i);
-            if (t == firstTimerInfo)
-                firstTimerInfo = 0;
-            if (t->activateRef)
-                *(t->activateRef) = 0;
-            delete t;
-            // move back one so that we don't skip the new current item
-            --i;
-        }
+
+    QTimerInfo *t = timersByObject.take(object);
+    while (t) {
+        // object found
+        QTimerInfo *next = t->objectNext;
+        timers.remove(t->id);
+        timerRemove(t);
+        if (t == firstTimerInfo)
+            firstTimerInfo = 0;
+        if (t->activateRef)
+            *(t->activateRef) = 0;
+        delete t;
+        t = next;
     }
     return true;
 }
 
 QList<QAbstractEventDispatcher::TimerInfo> QTimerInfoList::registeredTimers(QObject *object) const
 {
+    QVarLengthArray<const QTimerInfo *, 16> objectTimers;
+    for (const QTimerInfo *t = timersByObject.value(object); t; t = t->objectNext)
+        objectTimers.append(t);
+
+    // report them in the order they're going to fire
+    std::sort(objectTimers.begin(), objectTimers.end(), firesBefore);
+
     QList<QAbstractEventDispatcher::TimerInfo> list;
-    for (int i = 0; i < count(); ++i) {
-        const QTimerInfo * const t = at(i);
-        if (t->obj == object) {
-            list << QAbstractEventDispatcher::TimerInfo(t->id,
-                                                        (t->timerType == Qt::VeryCoarseTimer
-                                                         ? t->interval * 1000
-                                                         : t->interval),
-                                                        t->timerType);
-        }
+    list.reserve(objectTimers.size());
+    for (const QTimerInfo *t : qAsConst(objectTimers)) {
+        list << QAbstractEventDispatcher::TimerInfo(t->id,
+                                                    (t->timerType == Qt::VeryCoarseTimer
+                                                     ? t->interval * 1000
+                                                     : t->interval),
+                                                    t->timerType);
     }
     return list;
 }
@@ -576,21 +826,21 @@ int QTimerInfoList::activateTimers()
     timespec currentTime = updateCurrentTime();
     // qDebug() << "Thread" << QThread::currentThreadId() << "woken up at" << currentTime;
     repairTimersIfNeeded();
-
+    advanceWheel(currentTime);
 
     // Find out how many timer have expired
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (currentTime < (*it)->timeout)
+    for (int i = dueTimers.size() - 1; i >= 0; --i) {
+        if (currentTime < dueTimers.at(i)->timeout)
             break;
         maxCount++;
     }
 
     //fire the timers.
     while (maxCount--) {
-        if (isEmpty())
+        if (dueTimers.isEmpty())
             break;
 
-        QTimerInfo *currentTimerInfo = constFirst();
+        QTimerInfo *currentTimerInfo = dueTimers.constLast();
         if (currentTime < currentTimerInfo->timeout)
             break; // no timer has expired
 
@@ -605,7 +855,8 @@ int QTimerInfoList::activateTimers()
         }
 
         // remove from list
-        removeFirst();
+        dueTimers.removeLast();
+        currentTimerInfo->slot = NoSlot;
 
 #ifdef QTIMERINFO_DEBUG
         float diff;
@@ -631,6 +882,7 @@ int QTimerInfoList::activateTimers()
         calculateNextTimeout(currentTimerInfo, currentTime);
 
         // reinsert timer
+        currentTimerInfo->sequence = nextSequence++;
         timerInsert(currentTimerInfo);
         if (currentTimerInfo->interval > 0)
             n_act++;
@@ -56,6 +56,8 @@
 // #define QTIMERINFO_DEBUG
 
 #include "qabstracteventdispatcher.h"
+#include "qhash.h"
+#include "qvector.h"
 
 #include <sys/time.h> // struct timeval
 
@@ -70,6 +72,14 @@ struct QTimerInfo {
     QObject *obj;     // - object to receive event
     QTimerInfo **activateRef; // - ref from activateTimers
 
+    // bookkeeping for QTimerInfoList's timer wheel
+    QTimerInfo *next;
+    QTimerInfo *prev;
+    int slot;         // - wheel slot the timer is linked into
+    quint64 sequence; // - insertion order, breaks ties between equal timeouts
+    QTimerInfo *objectNext; // - the other timers of obj
+    QTimerInfo *objectPrev;
+
 #ifdef QTIMERINFO_DEBUG
     timeval expected; // when timer is expected to fire
     float cumulativeError;
@@ -77,7 +87,16 @@ struct QTimerInfo {
 #endif
 };
 
-class Q_CORE_EXPORT QTimerInfoList : public QList<QTimerInfo*>
+/*
+    QTimerInfoList keeps the timers in a hierarchical timing wheel: four
+    levels of 64 one-millisecond (level 0) to 2^18 millisecond (level 3)
+    slots plus an overflow list for timers more than ~4.6 hours away.
+    Registering and unregistering a timer only links or unlinks it from its
+    slot. Timers that are due (their millisecond tick has been reached) are
+    moved to a small list sorted by timeout, from which activateTimers()
+    fires them in order.
+*/
+class Q_CORE_EXPORT QTimerInfoList
 {
 #if ((_POSIX_MONOTONIC_CLOCK-0 <= 0) && !defined(Q_OS_MAC)) || defined(QT_BOOTSTRAPPED)
     timespec previousTime;
@@ -94,6 +113,7 @@ class Q_CORE_EXPORT QTimerInfoList : public QList<QTimerInfo*>
 
 public:
     QTimerInfoList();
+    ~QTimerInfoList();
 
     timespec currentTime;
     timespec updateCurrentTime();
@@ -103,6 +123,7 @@ public:
 
     bool timerWait(timespec &);
     void timerInsert(QTimerInfo *);
+    void timerRemove(QTimerInfo *);
 
     int timerRemainingTime(int timerId);
 
@@ -112,8 +133,44 @@ public:
     QList<QAbstractEventDispatcher::TimerInfo> registeredTimers(QObject *object) const;
 
     int activateTimers();
-};
 
+    bool isEmpty() const { return timers.isEmpty(); }
+    int size() const { return timers.size(); }
+
+private:
+    Q_DISABLE_COPY(QTimerInfoList)
+
+    enum {
+        LevelBits = 6,
+        SlotsPerLevel = 1 << LevelBits,
+        SlotMask = SlotsPerLevel - 1,
+        Levels = 4,
+        OverflowSlot = Levels * SlotsPerLevel,
+        DueSlot,
+        NoSlot = -1
+    };
+
+    void linkTimer(QTimerInfo *t, int slot);
+    void unlinkTimer(QTimerInfo *t);
+    void cascade(int slot);
+    quint64 nextWheelTick() const;
+    void advanceWheel(const timespec &currentTime);
+    QTimerInfo *firstDueTimer() const;
+    void linkObjectTimer(QTimerInfo *t);
+    void unlinkObjectTimer(QTimerInfo *t);
+
+    QTimerInfo *wheel[OverflowSlot + 1];
+    quint64 occupied[Levels];   // bit n set if slot n of that level is non-empty
+    quint64 wheelTick;          // millisecond tick the wheel has advanced to
+    quint64 nextSequence;
+
+    // timers whose tick has been reached, sorted so that the next one to
+    // fire is at the end
+    QVector<QTimerInfo *> dueTimers;
+
+    QHash<int, QTimerInfo *> timers;
+    QHash<QObject *, QTimerInfo *> timersByObject; // first timer of each object
+};
 QT_END_NAMESPACE
 
 #endif // QTIMERINFO_UNIX_P_H
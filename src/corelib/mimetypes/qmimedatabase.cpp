@@ -55,6 +55,16 @@
 #include <QtCore/QBuffer>
 #include <QtCore/QUrl>
 #include <QtCore/QDebug>
+#include <QtCore/private/qfilesystementry_p.h>
+#ifdef Q_OS_UNIX
+#include <QtCore/private/qcore_unix_p.h>
+#endif
+#ifndef QT_NO_THREAD
+#include <QtCore/qatomic.h>
+#include <QtCore/qrunnable.h>
+#include <QtCore/qsemaphore.h>
+#include <QtCore/qthreadpool.h>
+#endif
 
 #include <algorithm>
 #include <functional>
@@ -344,6 +354,24 @@ QMimeType QMimeDatabasePrivate::findByData(const QByteArray &data, int *accuracy
     return mimeTypeForName(defaultMimeType());
 }
 
+static int magicExtent(const QVector<QMimeProviderBase *> &providers)
+{
+    // isTextFile() needs 32 bytes, whatever the magic rules look at
+    int extent = 32;
+    for (QMimeProviderBase *provider : providers)
+        extent = qMax(extent, provider->magicExtent());
+    return extent;
+}
+
+/*!
+    \internal
+    Returns how many bytes from the start of a file findByData() needs.
+ */
+int QMimeDatabasePrivate::magicExtent()
+{
+    return QT_PREPEND_NAMESPACE(magicExtent)(providers());
+}
+
 QMimeType QMimeDatabasePrivate::mimeTypeForFileNameAndData(const QString &fileName, QIODevice *device, int *accuracyPtr)
 {
     // First, glob patterns are evaluated. If there is a match with max weight,
@@ -371,9 +399,9 @@ QMimeType QMimeDatabasePrivate::mimeTypeForFileNameAndData(const QString &fileNa
     // Pass 2) Match on content, if we can read the data
     if (device->isOpen()) {
 
-        // Read 16K in one go (QIODEVICE_BUFFERSIZE in qiodevice_p.h).
+        // Read what the magic rules need in one go.
         // This is much faster than seeking back and forth into QIODevice.
-        const QByteArray data = device->peek(16384);
+        const QByteArray data = device->peek(magicExtent());
 
         int magicAccuracy = 0;
         QMimeType candidateByData(findByData(data, &magicAccuracy));
@@ -406,6 +434,281 @@ QMimeType QMimeDatabasePrivate::mimeTypeForFileNameAndData(const QString &fileNa
     return mimeTypeForName(defaultMimeType());
 }
 
+namespace {
+
+struct QMimeFileMatch
+{
+    QMimeGlobMatchResult candidatesByName;
+    QString typeByMagic;
+    const char *fixedType = nullptr; // special files, or findByData() without a magic match
+    int accuracy = 0;
+    bool dataRead = false;
+};
+
+/*
+    Matches a list of files on several threads at once. The providers must
+    not be reloaded meanwhile, which holding QMimeDatabasePrivate::mutex
+    ensures, since only providers() reloads them.
+*/
+struct QMimeFileBatch
+{
+    enum { ChunkSize = 64 };
+
+    QMimeFileBatch(const QVector<QMimeProviderBase *> &providers, const QStringList &fileNames,
+                   QMimeDatabase::MatchMode mode)
+        : providers(providers), fileNames(fileNames), mode(mode),
+          extent(magicExtent(providers)), matches(fileNames.size()),
+          results(matches.data()), next(0)
+    {
+    }
+
+    void matchAll();
+    void match(const QString &fileName, QMimeFileMatch &result, QByteArray &buffer) const;
+
+    const QVector<QMimeProviderBase *> providers;
+    const QStringList &fileNames;
+    const QMimeDatabase::MatchMode mode;
+    const int extent;
+    QVector<QMimeFileMatch> matches;
+    QMimeFileMatch * const results;
+    QAtomicInt next;
+#ifndef QT_NO_THREAD
+    QSemaphore finished;
+#endif
+};
+
+#ifndef QT_NO_THREAD
+class QMimeFileBatchWorker : public QRunnable
+{
+public:
+    explicit QMimeFileBatchWorker(QMimeFileBatch *batch) : m_batch(batch) {}
+
+    void run() override
+    {
+        m_batch->matchAll();
+        m_batch->finished.release();
+    }
+
+private:
+    QMimeFileBatch *m_batch;
+};
+#endif
+
+} // unnamed namespace
+
+/*
+    Reads the start of the file into \a buffer, as far as its size. Returns
+    how many bytes were read, or -1 if the file cannot be opened.
+*/
+static qint64 readFileHead(const QString &fileName, QByteArray &buffer)
+{
+#ifdef Q_OS_UNIX
+    const int fd = qt_safe_open(QFile::encodeName(fileName).constData(), O_RDONLY);
+    if (fd == -1)
+        return -1;
+    // Local files hand out everything asked for in a single read()
+    const qint64 length = qt_safe_read(fd, buffer.data(), buffer.size());
+    qt_safe_close(fd);
+#else
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Unbuffered))
+        return -1;
+    const qint64 length = file.read(buffer.data(), buffer.size());
+#endif
+    return qMax<qint64>(length, 0);
+}
+
+void QMimeFileBatch::matchAll()
+{
+    // reused for every file this thread reads
+    QByteArray buffer;
+    const int count = fileNames.size();
+    for (int first = next.fetchAndAddRelaxed(ChunkSize); first < count;
+         first = next.fetchAndAddRelaxed(ChunkSize)) {
+        const int last = qMin(first + int(ChunkSize), count);
+        for (int i = first; i < last; ++i)
+            match(fileNames.at(i), results[i], buffer);
+    }
+}
+
+/*
+    Does what mimeTypeForFile() does, except for looking up the MIME types
+    by name, which needs the mutex.
+*/
+void QMimeFileBatch::match(const QString &fileName, QMimeFileMatch &result, QByteArray &buffer) const
+{
+    if (mode != QMimeDatabase::MatchExtension) {
+#ifdef Q_OS_UNIX
+        // One stat() tells directories and special files apart, following symlinks
+        QT_STATBUF statBuffer;
+        if (QT_STAT(QFile::encodeName(fileName).constData(), &statBuffer) == 0) {
+            if (S_ISDIR(statBuffer.st_mode))
+                result.fixedType = "inode/directory";
+            else if (S_ISCHR(statBuffer.st_mode))
+                result.fixedType = "inode/chardevice";
+            else if (S_ISBLK(statBuffer.st_mode))
+                result.fixedType = "inode/blockdevice";
+            else if (S_ISFIFO(statBuffer.st_mode))
+                result.fixedType = "inode/fifo";
+            else if (S_ISSOCK(statBuffer.st_mode))
+                result.fixedType = "inode/socket";
+        }
+#else
+        if (QFileInfo(fileName).isDir())
+            result.fixedType = "inode/directory";
+#endif
+        if (result.fixedType)
+            return;
+    }
+
+    if (mode != QMimeDatabase::MatchContent) {
+        if (fileName.endsWith(QLatin1Char('/'))) {
+            result.candidatesByName.addMatch(QStringLiteral("inode/directory"), 100, QString());
+        } else {
+            const QString shortName = QFileSystemEntry(fileName).fileName();
+            for (QMimeProviderBase *provider : providers)
+                provider->addFileNameMatches(shortName, result.candidatesByName);
+        }
+        // A single match with the name is enough
+        if (mode == QMimeDatabase::MatchExtension
+                || result.candidatesByName.m_allMatchingMimeTypes.count() == 1) {
+            return;
+        }
+    }
+
+    if (buffer.size() != extent)
+        buffer.resize(extent);
+    const qint64 length = readFileHead(fileName, buffer);
+    if (length < 0)
+        return;
+    result.dataRead = true;
+    if (length == 0) {
+        result.fixedType = "application/x-zerosize";
+        result.accuracy = 100;
+        return;
+    }
+
+    const QByteArray data = QByteArray::fromRawData(buffer.constData(), int(length));
+    QMimeType candidate;
+    for (QMimeProviderBase *provider : providers)
+        provider->findByMagic(data, &result.accuracy, candidate);
+    if (candidate.isValid()) {
+        result.typeByMagic = candidate.name();
+    } else if (isTextFile(data)) {
+        result.fixedType = "text/plain";
+        result.accuracy = 5;
+    }
+}
+
+QList<QMimeType> QMimeDatabasePrivate::mimeTypesForFiles(const QStringList &fileNames, QMimeDatabase::MatchMode mode)
+{
+    Q_ASSERT(!mutex.tryLock()); // caller should have locked mutex
+    QList<QMimeType> result;
+    const int count = fileNames.size();
+    if (!count)
+        return result;
+
+    QMimeFileBatch batch(providers(), fileNames, mode);
+#ifndef QT_NO_THREAD
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const int chunkCount = (count + QMimeFileBatch::ChunkSize - 1) / QMimeFileBatch::ChunkSize;
+    const int helperCount = qMin(pool->maxThreadCount(), chunkCount) - 1;
+    int started = 0;
+    for (; started < helperCount; ++started) {
+        QMimeFileBatchWorker *worker = new QMimeFileBatchWorker(&batch);
+        if (!pool->tryStart(worker)) {
+            delete worker;
+            break;
+        }
+    }
+#endif
+    batch.matchAll();
+#ifndef QT_NO_THREAD
+    batch.finished.acquire(started);
+#endif
+
+    // Files of the same type share the QMimeType
+    QHash<QString, QMimeType> mimeTypes;
+    const auto mimeTypeNamed = [this, &mimeTypes](const QString &name) {
+        auto it = mimeTypes.constFind(name);
+        if (it == mimeTypes.constEnd())
+            it = mimeTypes.insert(name, mimeTypeForName(name));
+        return *it;
+    };
+
+    // For the rare files the batch could not settle, like findByData() does
+    const auto matchContent = [this, &batch, &fileNames](int i, int *accuracyPtr, QMimeType *mime) {
+        QByteArray buffer(batch.extent, Qt::Uninitialized);
+        const qint64 length = readFileHead(fileNames.at(i), buffer);
+        if (length < 0)
+            return false;
+        buffer.truncate(int(length));
+        *mime = findByData(buffer, accuracyPtr);
+        return true;
+    };
+
+    result.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        QMimeFileMatch &match = batch.matches[i];
+        if (match.fixedType && !match.dataRead) {
+            result.append(mimeTypeNamed(QLatin1String(match.fixedType)));
+            continue;
+        }
+
+        QStringList &matchingMimeTypes = match.candidatesByName.m_matchingMimeTypes;
+        if (mode == QMimeDatabase::MatchExtension) {
+            matchingMimeTypes.sort(); // make it deterministic
+            result.append(mimeTypeNamed(matchingMimeTypes.isEmpty() ? defaultMimeType() : matchingMimeTypes.first()));
+            continue;
+        }
+
+        QMimeType candidateByData;
+        int accuracy = match.accuracy;
+        bool dataRead = match.dataRead;
+        if (mode == QMimeDatabase::MatchDefault && match.candidatesByName.m_allMatchingMimeTypes.count() == 1) {
+            const QMimeType mime = mimeTypeNamed(matchingMimeTypes.at(0));
+            if (mime.isValid()) {
+                result.append(mime);
+                continue;
+            }
+            // The name matches an unknown type: look at the contents after all
+            match.candidatesByName = QMimeGlobMatchResult();
+            dataRead = matchContent(i, &accuracy, &candidateByData);
+        } else if (dataRead && !match.typeByMagic.isEmpty()) {
+            candidateByData = mimeTypeNamed(match.typeByMagic);
+            // A magic rule of a type missing from the list of types
+            if (!candidateByData.isValid())
+                dataRead = matchContent(i, &accuracy, &candidateByData);
+        } else if (dataRead) {
+            candidateByData = mimeTypeNamed(match.fixedType ? QString(QLatin1String(match.fixedType)) : defaultMimeType());
+        }
+
+        if (mode == QMimeDatabase::MatchContent) {
+            result.append(dataRead ? candidateByData : mimeTypeNamed(defaultMimeType()));
+            continue;
+        }
+
+        // Disambiguate conflicting extensions, like mimeTypeForFileNameAndData()
+        if (dataRead && candidateByData.isValid() && accuracy > 0) {
+            const QString sniffedMime = candidateByData.name();
+            const auto it = std::find_if(matchingMimeTypes.cbegin(), matchingMimeTypes.cend(),
+                                         [this, &sniffedMime](const QString &m) { return inherits(m, sniffedMime); });
+            result.append(it != matchingMimeTypes.cend() ? mimeTypeNamed(*it) : candidateByData);
+            continue;
+        }
+        if (match.candidatesByName.m_allMatchingMimeTypes.count() > 1) {
+            matchingMimeTypes.sort(); // make it deterministic
+            const QMimeType mime = mimeTypeNamed(matchingMimeTypes.at(0));
+            if (mime.isValid()) {
+                result.append(mime);
+                continue;
+            }
+        }
+        result.append(mimeTypeNamed(defaultMimeType()));
+    }
+    return result;
+}
+
 QList<QMimeType> QMimeDatabasePrivate::allMimeTypes()
 {
     QList<QMimeType> result;
@@ -618,6 +921,30 @@ QMimeType QMimeDatabase::mimeTypeForFile(const QString &fileName, MatchMode mode
     }
 }
 
+/*!
+    \since 5.12
+
+    Returns the MIME types of the files named \a fileNames, in the same
+    order, using \a mode.
+
+    Each MIME type is the one mimeTypeForFile() returns for the file, but
+    the files are examined in parallel, on the threads of
+    QThreadPool::globalInstance(), and with less file system access: files
+    are only opened when their name is not enough, and then only read as
+    far as the magic rules of the database go. The files of the same MIME
+    type share the QMimeType returned for them.
+
+    Other threads using the MIME database wait until this function returns.
+
+    \sa mimeTypeForFile()
+*/
+QList<QMimeType> QMimeDatabase::mimeTypesForFiles(const QStringList &fileNames, MatchMode mode) const
+{
+    QMutexLocker locker(&d->mutex);
+
+    return d->mimeTypesForFiles(fileNames, mode);
+}
+
 /*!
     Returns the MIME types for the file name \a fileName.
 
@@ -682,9 +1009,9 @@ QMimeType QMimeDatabase::mimeTypeForData(QIODevice *device) const
     int accuracy = 0;
     const bool openedByUs = !device->isOpen() && device->open(QIODevice::ReadOnly);
     if (device->isOpen()) {
-        // Read 16K in one go (QIODEVICE_BUFFERSIZE in qiodevice_p.h).
+        // Read what the magic rules need in one go.
         // This is much faster than seeking back and forth into QIODevice.
-        const QByteArray data = device->peek(16384);
+        const QByteArray data = device->peek(d->magicExtent());
         const QMimeType result = d->findByData(data, &accuracy);
         if (openedByUs)
             device->close();
@@ -52,7 +52,7 @@
 // We mean it.
 //
 
-#include "qmimetype.h"
+#include "qmimedatabase.h"
 
 #ifndef QT_NO_MIMETYPE
 
@@ -92,6 +92,8 @@ public:
     QMimeType findByData(const QByteArray &data, int *priorityPtr);
     QStringList mimeTypeForFileName(const QString &fileName);
     QMimeGlobMatchResult findByFileName(const QString &fileName);
+    QList<QMimeType> mimeTypesForFiles(const QStringList &fileNames, QMimeDatabase::MatchMode mode);
+    int magicExtent();
 
     // API for QMimeType. Takes care of locking the mutex.
     void loadMimeTypePrivate(QMimeTypePrivate &mimePrivate);
@@ -98,23 +98,49 @@ void QMimeGlobMatchResult::addMatch(const QString &mimeType, int weight, const Q
     \sa QMimeType, QMimeDatabase, QMimeMagicRuleMatcher, QMimeMagicRule
 */
 
+QMimeGlobPattern::PatternType QMimeGlobPattern::detectPatternType(const QString &pattern)
+{
+    const int patternLength = pattern.length();
+    if (!patternLength)
+        return OtherPattern;
+
+    const int starCount = pattern.count(QLatin1Char('*'));
+    const bool hasSquareBracket = pattern.indexOf(QLatin1Char('[')) != -1;
+
+    // Patterns like "*~", "*.extension"
+    if (pattern.at(0) == QLatin1Char('*') && !hasSquareBracket && starCount == 1)
+        return SuffixPattern;
+    // Patterns like "README*" (well this is currently the only one like that...)
+    if (starCount == 1 && pattern.at(patternLength - 1) == QLatin1Char('*'))
+        return PrefixPattern;
+    // Names without any wildcards like "README"
+    if (!hasSquareBracket && starCount == 0 && pattern.indexOf(QLatin1Char('?')))
+        return LiteralPattern;
+    return OtherPattern;
+}
+
 bool QMimeGlobPattern::matchFileName(const QString &inputFilename) const
 {
     // "Applications MUST match globs case-insensitively, except when the case-sensitive
     // attribute is set to true."
     // The constructor takes care of putting case-insensitive patterns in lowercase.
-    const QString filename = m_caseSensitivity == Qt::CaseInsensitive ? inputFilename.toLower() : inputFilename;
+    return matchFileName(inputFilename, m_caseSensitivity == Qt::CaseInsensitive ? inputFilename.toLower() : inputFilename);
+}
+
+/*!
+    \internal
+    Overload for matching the same file name against many patterns,
+    with \a lowerFilename the lowercase version of \a inputFilename.
+*/
+bool QMimeGlobPattern::matchFileName(const QString &inputFilename, const QString &lowerFilename) const
+{
+    const QString &filename = m_caseSensitivity == Qt::CaseInsensitive ? lowerFilename : inputFilename;
 
     const int pattern_len = m_pattern.length();
-    if (!pattern_len)
-        return false;
     const int len = filename.length();
 
-    const int starCount = m_pattern.count(QLatin1Char('*'));
-
-    // Patterns like "*~", "*.extension"
-    if (m_pattern[0] == QLatin1Char('*') && m_pattern.indexOf(QLatin1Char('[')) == -1 && starCount == 1)
-    {
+    switch (m_patternType) {
+    case SuffixPattern: {
         if (len + 1 < pattern_len) return false;
 
         const QChar *c1 = m_pattern.unicode() + pattern_len - 1;
@@ -124,9 +150,7 @@ bool QMimeGlobPattern::matchFileName(const QString &inputFilename) const
             ++cnt;
         return cnt == pattern_len;
     }
-
-    // Patterns like "README*" (well this is currently the only one like that...)
-    if (starCount == 1 && m_pattern.at(pattern_len - 1) == QLatin1Char('*')) {
+    case PrefixPattern: {
         if (len + 1 < pattern_len) return false;
         if (m_pattern.at(0) == QLatin1Char('*'))
             return filename.indexOf(m_pattern.midRef(1, pattern_len - 2)) != -1;
@@ -138,10 +162,14 @@ bool QMimeGlobPattern::matchFileName(const QString &inputFilename) const
            ++cnt;
         return cnt == pattern_len;
     }
-
-    // Names without any wildcards like "README"
-    if (m_pattern.indexOf(QLatin1Char('[')) == -1 && starCount == 0 && m_pattern.indexOf(QLatin1Char('?')))
+    case LiteralPattern:
         return (m_pattern == filename);
+    case OtherPattern:
+        break;
+    }
+
+    if (!pattern_len)
+        return false;
 
     // Other (quite rare) patterns, like "*.anim[1-9j]": use slow but correct method
     QRegExp rx(m_pattern, Qt::CaseSensitive, QRegExp::WildcardUnix);
@@ -199,9 +227,12 @@ void QMimeGlobPatternList::match(QMimeGlobMatchResult &result,
 
     QMimeGlobPatternList::const_iterator it = this->constBegin();
     const QMimeGlobPatternList::const_iterator endIt = this->constEnd();
+    if (it == endIt)
+        return;
+    const QString lowerFileName = fileName.toLower();
     for (; it != endIt; ++it) {
         const QMimeGlobPattern &glob = *it;
-        if (glob.matchFileName(fileName))
+        if (glob.matchFileName(fileName, lowerFileName))
             result.addMatch(glob.mimeType(), glob.weight(), glob.pattern());
     }
 }
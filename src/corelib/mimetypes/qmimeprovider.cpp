@@ -181,10 +181,15 @@ void QMimeBinaryProvider::ensureLoaded()
         else
             return; // nothing to do
     }
+    m_globs.clear();
     if (!m_cacheFile->isValid()) { // verify existence and version
         delete m_cacheFile;
         m_cacheFile = nullptr;
+        return;
     }
+    // Literals (e.g. "Makefile") are checked before complex globs (e.g. "callgrind.out[0-9]*")
+    loadGlobList(m_cacheFile, m_cacheFile->getUint32(PosLiteralListOffset));
+    loadGlobList(m_cacheFile, m_cacheFile->getUint32(PosGlobListOffset));
 }
 
 static QMimeType mimeTypeForNameUnchecked(const QString &name)
@@ -214,10 +219,11 @@ void QMimeBinaryProvider::addFileNameMatches(const QString &fileName, QMimeGlobM
         return;
     Q_ASSERT(m_cacheFile);
     const QString lowerFileName = fileName.toLower();
-    // Check literals (e.g. "Makefile")
-    matchGlobList(result, m_cacheFile, m_cacheFile->getUint32(PosLiteralListOffset), fileName);
-    // Check complex globs (e.g. "callgrind.out[0-9]*")
-    matchGlobList(result, m_cacheFile, m_cacheFile->getUint32(PosGlobListOffset), fileName);
+    // Check literals (e.g. "Makefile") and complex globs (e.g. "callgrind.out[0-9]*")
+    for (const QMimeGlobPattern &glob : qAsConst(m_globs)) {
+        if (glob.matchFileName(fileName, lowerFileName))
+            result.addMatch(glob.mimeType(), glob.weight(), glob.pattern());
+    }
     // Check the very common *.txt cases with the suffix tree
     const int reverseSuffixTreeOffset = m_cacheFile->getUint32(PosReverseSuffixTreeOffset);
     const int numRoots = m_cacheFile->getUint32(reverseSuffixTreeOffset);
@@ -227,10 +233,11 @@ void QMimeBinaryProvider::addFileNameMatches(const QString &fileName, QMimeGlobM
         matchSuffixTree(result, m_cacheFile, numRoots, firstRootOffset, fileName, fileName.length() - 1, true);
 }
 
-void QMimeBinaryProvider::matchGlobList(QMimeGlobMatchResult &result, CacheFile *cacheFile, int off, const QString &fileName)
+void QMimeBinaryProvider::loadGlobList(CacheFile *cacheFile, int off)
 {
     const int numGlobs = cacheFile->getUint32(off);
     //qDebug() << "Loading" << numGlobs << "globs from" << cacheFile->file.fileName() << "at offset" << cacheFile->globListOffset;
+    m_globs.reserve(m_globs.size() + numGlobs);
     for (int i = 0; i < numGlobs; ++i) {
         const int globOffset = cacheFile->getUint32(off + 4 + 12 * i);
         const int mimeTypeOffset = cacheFile->getUint32(off + 4 + 12 * i + 4);
@@ -242,11 +249,7 @@ void QMimeBinaryProvider::matchGlobList(QMimeGlobMatchResult &result, CacheFile
 
         const char *mimeType = cacheFile->getCharStar(mimeTypeOffset);
         //qDebug() << pattern << mimeType << weight << caseSensitive;
-        QMimeGlobPattern glob(pattern, QString() /*unused*/, weight, qtCaseSensitive);
-
-        // TODO: this could be done faster for literals where a simple == would do.
-        if (glob.matchFileName(fileName))
-            result.addMatch(QLatin1String(mimeType), weight, pattern);
+        m_globs.append(QMimeGlobPattern(pattern, QLatin1String(mimeType), weight, qtCaseSensitive));
     }
 }
 
@@ -326,7 +329,6 @@ void QMimeBinaryProvider::findByMagic(const QByteArray &data, int *accuracyPtr,
 {
     const int magicListOffset = m_cacheFile->getUint32(PosMagicListOffset);
     const int numMatches = m_cacheFile->getUint32(magicListOffset);
-    //const int maxExtent = cacheFile->getUint32(magicListOffset + 4);
     const int firstMatchOffset = m_cacheFile->getUint32(magicListOffset + 8);
 
     for (int i = 0; i < numMatches; ++i) {
@@ -345,6 +347,12 @@ void QMimeBinaryProvider::findByMagic(const QByteArray &data, int *accuracyPtr,
     }
 }
 
+int QMimeBinaryProvider::magicExtent()
+{
+    const int magicListOffset = m_cacheFile->getUint32(PosMagicListOffset);
+    return m_cacheFile->getUint32(magicListOffset + 4);
+}
+
 void QMimeBinaryProvider::addParents(const QString &mime, QStringList &result)
 {
     const QByteArray mimeStr = mime.toLatin1();
@@ -642,6 +650,11 @@ void QMimeXMLProvider::findByMagic(const QByteArray &data, int *accuracyPtr, QMi
         candidate = mimeTypeForName(candidateName);
 }
 
+int QMimeXMLProvider::magicExtent()
+{
+    return m_magicExtent;
+}
+
 void QMimeXMLProvider::ensureLoaded()
 {
     QStringList allFiles;
@@ -661,6 +674,7 @@ void QMimeXMLProvider::ensureLoaded()
     m_parents.clear();
     m_mimeTypeGlobs.clear();
     m_magicMatchers.clear();
+    m_magicExtent = 0;
 
     //qDebug() << "Loading" << m_allFiles;
 
@@ -751,9 +765,22 @@ void QMimeXMLProvider::addAllMimeTypes(QList<QMimeType> &result)
     }
 }
 
+// How many bytes of data the rule can look at. Values are counted before
+// being unescaped, so this can be more than needed, but never less.
+static int magicRuleExtent(const QMimeMagicRule &rule)
+{
+    int extent = rule.endPos() + qMax(rule.value().size(), 4);
+    for (const QMimeMagicRule &subMatch : rule.m_subMatches)
+        extent = qMax(extent, magicRuleExtent(subMatch));
+    return extent;
+}
+
 void QMimeXMLProvider::addMagicMatcher(const QMimeMagicRuleMatcher &matcher)
 {
     m_magicMatchers.append(matcher);
+    const QList<QMimeMagicRule> rules = matcher.magicRules();
+    for (const QMimeMagicRule &rule : rules)
+        m_magicExtent = qMax(m_magicExtent, magicRuleExtent(rule));
 }
 
 QT_END_NAMESPACE
@@ -77,6 +77,7 @@ public:
     virtual QString resolveAlias(const QString &name) = 0;
     virtual void addAliases(const QString &name, QStringList &result) = 0;
     virtual void findByMagic(const QByteArray &data, int *accuracyPtr, QMimeType &candidate) = 0;
+    virtual int magicExtent() = 0;
     virtual void addAllMimeTypes(QList<QMimeType> &result) = 0;
     virtual void loadIcon(QMimeTypePrivate &) {}
     virtual void loadGenericIcon(QMimeTypePrivate &) {}
@@ -104,6 +105,7 @@ public:
     virtual QString resolveAlias(const QString &name) override;
     void addAliases(const QString &name, QStringList &result) override;
     void findByMagic(const QByteArray &data, int *accuracyPtr, QMimeType &candidate) override;
+    int magicExtent() override;
     void addAllMimeTypes(QList<QMimeType> &result) override;
     static void loadMimeTypePrivate(QMimeTypePrivate &);
     virtual void loadIcon(QMimeTypePrivate &) override;
@@ -113,7 +115,7 @@ public:
 private:
     struct CacheFile;
 
-    void matchGlobList(QMimeGlobMatchResult &result, CacheFile *cacheFile, int offset, const QString &fileName);
+    void loadGlobList(CacheFile *cacheFile, int offset);
     bool matchSuffixTree(QMimeGlobMatchResult &result, CacheFile *cacheFile, int numEntries, int firstOffset, const QString &fileName, int charPos, bool caseSensitiveCheck);
     bool matchMagicRule(CacheFile *cacheFile, int numMatchlets, int firstOffset, const QByteArray &data);
     QLatin1String iconForMime(CacheFile *cacheFile, int posListOffset, const QByteArray &inputMime);
@@ -121,6 +123,7 @@ private:
     bool checkCacheChanged();
 
     CacheFile *m_cacheFile = nullptr;
+    QMimeGlobPatternList m_globs; // the literals and the complex globs, parsed once
     QStringList m_cacheFileNames;
     QSet<QString> m_mimetypeNames;
     bool m_mimetypeListLoaded;
@@ -142,6 +145,7 @@ public:
     virtual QString resolveAlias(const QString &name) override;
     void addAliases(const QString &name, QStringList &result) override;
     void findByMagic(const QByteArray &data, int *accuracyPtr, QMimeType &candidate) override;
+    int magicExtent() override;
     void addAllMimeTypes(QList<QMimeType> &result) override;
     void ensureLoaded() override;
 
@@ -168,6 +172,7 @@ private:
     QMimeAllGlobPatterns m_mimeTypeGlobs;
 
     QList<QMimeMagicRuleMatcher> m_magicMatchers;
+    int m_magicExtent = 0;
     QStringList m_allFiles;
 };
 
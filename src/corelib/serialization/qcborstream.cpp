@@ -0,0 +1,2598 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qcborstream.h"
+
+#include <qdatetime.h>
+#include <qendian.h>
+#include <qiodevice.h>
+#include <qjsonarray.h>
+#include <qjsondocument.h>
+#include <qjsonobject.h>
+#include <qlocale.h>
+#include <qnumeric.h>
+#include <qurl.h>
+#include <quuid.h>
+#include <qvarlengtharray.h>
+#if QT_CONFIG(regularexpression)
+#include <qregularexpression.h>
+#endif
+
+#include <private/qbytearray_p.h>
+#include <private/qjson_p.h>
+#include <private/qutfcodec_p.h>
+
+#include <cmath>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+enum {
+    ReadChunkSize = 16 * 1024,
+    WriteBufferSize = 16 * 1024,
+    NestingLimit = 1024
+};
+
+enum : quint64 {
+    IndefiniteLength = ~Q_UINT64_C(0)
+};
+
+enum : uchar {
+    BreakByte = 0xff,
+    IndefiniteLengthMarker = 0x1f,
+    SimpleTypeInNextByte = 24,
+    Float16Marker = 25,
+    FloatMarker = 26,
+    DoubleMarker = 27
+};
+}
+
+/*!
+    \class QCborError
+    \inmodule QtCore
+    \since 5.12
+
+    \brief The QCborError class holds the error condition found while
+    reading or writing a CBOR stream.
+
+    \sa QCborStreamReader
+*/
+
+/*!
+    \enum QCborError::Code
+
+    \value NoError No error occurred.
+    \value UnknownError An unknown error occurred.
+    \value AdvancePastEnd QCborStreamReader was asked to move past the end
+           of the data.
+    \value InputOutputError The device reported an error while reading.
+    \value GarbageAtEnd Data was found after the end of the stream.
+    \value EndOfFile The stream ended before the current item was complete,
+           or, at the top level, there are no more items.
+    \value UnexpectedBreak A Break stop code was found outside of an
+           indefinite-length array, map or string.
+    \value UnknownType The stream contains an unknown type.
+    \value IllegalType A chunk of an indefinite-length string has the wrong
+           type, or is not of definite length itself.
+    \value IllegalNumber The stream uses a reserved length encoding.
+    \value IllegalSimpleType A simple type below 32 was encoded in two bytes.
+    \value InvalidUtf8String A text string is not valid UTF-8.
+    \value DataTooLarge A string does not fit into a QByteArray or QString.
+    \value NestingTooDeep Arrays, maps and tags are nested too deeply.
+    \value UnsupportedType The stream contains something that cannot be
+           converted to the requested type.
+*/
+
+/*!
+    \variable QCborError::c
+    \internal
+*/
+
+/*!
+    \fn QCborError::operator Code() const
+
+    Returns the error code this object holds.
+*/
+
+/*!
+    Returns a text description of the error this object holds. The string
+    is not translated.
+*/
+QString QCborError::toString() const
+{
+    switch (c) {
+    case NoError:
+        return QStringLiteral("No error");
+    case UnknownError:
+        break;
+    case AdvancePastEnd:
+        return QStringLiteral("Read past end of buffer (more bytes needed)");
+    case InputOutputError:
+        return QStringLiteral("Input/Output error");
+    case GarbageAtEnd:
+        return QStringLiteral("Data found after the end of the stream");
+    case EndOfFile:
+        return QStringLiteral("Unexpected end of input data (more bytes needed)");
+    case UnexpectedBreak:
+        return QStringLiteral("Invalid CBOR stream: unexpected 'break' byte");
+    case UnknownType:
+        return QStringLiteral("Invalid CBOR stream: unknown type");
+    case IllegalType:
+        return QStringLiteral("Invalid CBOR stream: illegal type found");
+    case IllegalNumber:
+        return QStringLiteral("Invalid CBOR stream: illegal number encoding (future extension)");
+    case IllegalSimpleType:
+        return QStringLiteral("Invalid CBOR stream: illegal simple type");
+    case InvalidUtf8String:
+        return QStringLiteral("Invalid UTF-8 string");
+    case DataTooLarge:
+        return QStringLiteral("Internal limitation: data set too large");
+    case NestingTooDeep:
+        return QStringLiteral("Internal limitation: data nested too deeply");
+    case UnsupportedType:
+        return QStringLiteral("Unsupported type found in input");
+    }
+    return QStringLiteral("Unknown error");
+}
+
+class QCborStreamReaderPrivate
+{
+    Q_DECLARE_PUBLIC(QCborStreamReader)
+public:
+    enum HeadResult { HeadOk, HeadBreak, HeadError };
+    enum ByteEncoding { Base64url, Base64, Base16 };
+
+    // the output of the JSON conversion, in the binary format of
+    // QJsonDocument, as the JSON parser writes it
+    struct JsonBuffer {
+        char *data;
+        int length;
+        int current;
+
+        int reserveSpace(int space)
+        {
+            if (current + qint64(space) >= length) {
+                const qint64 newLength = 2 * qint64(length) + space;
+                char *newData = newLength < MaxByteArraySize
+                        ? static_cast<char *>(realloc(data, size_t(newLength))) : nullptr;
+                if (!newData)
+                    return -1;
+                data = newData;
+                length = int(newLength);
+            }
+            const int pos = current;
+            current += space;
+            return pos;
+        }
+    };
+
+    // the initial byte and argument of an item
+    struct Head {
+        QCborStreamReader::Type type;
+        bool indefinite;
+        int size;
+        quint64 value;
+    };
+
+    // for definite-length containers, count is the number of items left;
+    // for indefinite-length ones, the number of items read so far
+    struct Container {
+        quint64 count;
+        bool isMap;
+        bool indefinite;
+    };
+
+    explicit QCborStreamReaderPrivate(QCborStreamReader *q)
+        : q_ptr(q), device(nullptr), bufferStart(0), pos(0), afterTag(false)
+    {
+        lastError.c = QCborError::NoError;
+        current.type = QCborStreamReader::Invalid;
+        current.indefinite = false;
+        current.size = 0;
+        current.value = 0;
+    }
+
+    bool fail(QCborError::Code code)
+    {
+        lastError.c = code;
+        current.type = QCborStreamReader::Invalid;
+        return false;
+    }
+
+    bool ensure(qint64 n)
+    {
+        return buffer.size() - pos >= n || fillBuffer(n);
+    }
+    bool fillBuffer(qint64 n);
+    void compact();
+    void reset();
+    HeadResult decodeHead(qint64 offset, Head *head);
+    bool expectItem(qint64 offset, Head *head);
+    bool containerFor(const Head &head, Container *container);
+    void preparse();
+    void itemDone();
+    void advance(qint64 n)
+    {
+        pos += int(n);
+        itemDone();
+        preparse();
+    }
+    const char *stringData(int *len);
+    bool skipItem(qint64 *offset, int maxRecursion);
+    bool readStringData(qint64 *offset, QByteArray *out, bool copy);
+
+    QJsonValue readJson(int depth, ByteEncoding encoding);
+    QString readJsonKey(int depth);
+    QJsonValue readJsonContainer(int depth, ByteEncoding encoding);
+    bool buildJsonContainer(JsonBuffer *out, int depth, ByteEncoding encoding);
+    bool buildJsonValue(JsonBuffer *out, QJsonPrivate::Value *val, int baseOffset,
+                        int depth, ByteEncoding encoding);
+    bool buildJsonString(JsonBuffer *out, bool *latin1);
+    QVariant readVariant(int depth);
+
+    QCborStreamReader *q_ptr;
+    QIODevice *device;
+    QByteArray buffer;
+    qint64 bufferStart;
+    int pos;
+    bool afterTag;
+    QCborError lastError;
+    Head current;
+    QVarLengthArray<Container, 16> containers;
+};
+
+void QCborStreamReaderPrivate::reset()
+{
+    buffer.clear();
+    bufferStart = 0;
+    pos = 0;
+    afterTag = false;
+    lastError.c = QCborError::NoError;
+    current.type = QCborStreamReader::Invalid;
+    containers.clear();
+}
+
+void QCborStreamReaderPrivate::compact()
+{
+    if (pos) {
+        buffer.remove(0, pos);
+        bufferStart += pos;
+        pos = 0;
+    }
+}
+
+/*!
+    \internal
+
+    Makes sure that \a n bytes from the current item on are in the buffer,
+    reading from the device if there is one. Items are only consumed once
+    they are complete, so the buffer may have to hold a large string or
+    container entirely.
+*/
+bool QCborStreamReaderPrivate::fillBuffer(qint64 n)
+{
+    while (buffer.size() - pos < n) {
+        if (!device || n > MaxByteArraySize)
+            return fail(QCborError::EndOfFile);
+        compact();
+        const int oldSize = buffer.size();
+        const qint64 chunk = qMin<qint64>(qMax<qint64>(ReadChunkSize, n - oldSize),
+                                          MaxByteArraySize - oldSize);
+        buffer.resize(oldSize + int(chunk));
+        const qint64 read = device->read(buffer.data() + oldSize, chunk);
+        buffer.resize(oldSize + int(qMax<qint64>(read, 0)));
+        if (read < 0)
+            return fail(QCborError::InputOutputError);
+        if (read == 0)
+            return fail(QCborError::EndOfFile);
+    }
+    return true;
+}
+
+/*!
+    \internal
+
+    Decodes the initial byte and argument of the item \a offset bytes after
+    the current one into \a head. Returns HeadBreak without changing \a head
+    for a Break stop code, whose validity depends on the context.
+*/
+QCborStreamReaderPrivate::HeadResult QCborStreamReaderPrivate::decodeHead(qint64 offset, Head *head)
+{
+    if (!ensure(offset + 1))
+        return HeadError;
+    const uchar *p = reinterpret_cast<const uchar *>(buffer.constData()) + pos + offset;
+    const uchar initial = *p;
+    if (initial == BreakByte)
+        return HeadBreak;
+
+    const uchar major = initial & 0xe0;
+    const uchar info = initial & 0x1f;
+    head->indefinite = false;
+    if (info < 24) {
+        head->value = info;
+        head->size = 1;
+    } else if (info <= DoubleMarker) {
+        const int n = 1 << (info - 24);
+        if (!ensure(offset + 1 + n))
+            return HeadError;
+        p = reinterpret_cast<const uchar *>(buffer.constData()) + pos + offset + 1;
+        switch (n) {
+        case 1:
+            head->value = *p;
+            break;
+        case 2:
+            head->value = qFromBigEndian<quint16>(p);
+            break;
+        case 4:
+            head->value = qFromBigEndian<quint32>(p);
+            break;
+        default:
+            head->value = qFromBigEndian<quint64>(p);
+            break;
+        }
+        head->size = 1 + n;
+    } else if (info == IndefiniteLengthMarker && major >= QCborStreamReader::ByteString
+               && major <= QCborStreamReader::Map) {
+        head->value = 0;
+        head->size = 1;
+        head->indefinite = true;
+    } else {
+        // additional information 28 to 30 is reserved
+        fail(QCborError::IllegalNumber);
+        return HeadError;
+    }
+
+    if (major != QCborStreamReader::SimpleType) {
+        head->type = QCborStreamReader::Type(major);
+        return HeadOk;
+    }
+    switch (info) {
+    case Float16Marker:
+        head->type = QCborStreamReader::Float16;
+        break;
+    case FloatMarker:
+        head->type = QCborStreamReader::Float;
+        break;
+    case DoubleMarker:
+        head->type = QCborStreamReader::Double;
+        break;
+    case SimpleTypeInNextByte:
+        // the values below 32 must be encoded in the initial byte
+        if (head->value < 32) {
+            fail(QCborError::IllegalSimpleType);
+            return HeadError;
+        }
+        Q_FALLTHROUGH();
+    default:
+        head->type = QCborStreamReader::SimpleType;
+        break;
+    }
+    return HeadOk;
+}
+
+bool QCborStreamReaderPrivate::expectItem(qint64 offset, Head *head)
+{
+    const HeadResult result = decodeHead(offset, head);
+    if (result == HeadBreak)
+        return fail(QCborError::UnexpectedBreak);
+    return result == HeadOk;
+}
+
+bool QCborStreamReaderPrivate::containerFor(const Head &head, Container *container)
+{
+    container->isMap = (head.type == QCborStreamReader::Map);
+    container->indefinite = head.indefinite;
+    container->count = head.value;
+    if (container->isMap && !head.indefinite) {
+        // a map holds a key and a value for each of its entries
+        if (head.value > IndefiniteLength / 2)
+            return fail(QCborError::DataTooLarge);
+        container->count *= 2;
+    }
+    return true;
+}
+
+/*!
+    \internal
+
+    Decodes the item at the current position. At the end of a container,
+    the type becomes Invalid without an error.
+*/
+void QCborStreamReaderPrivate::preparse()
+{
+    current.type = QCborStreamReader::Invalid;
+    if (lastError != QCborError::NoError)
+        return;
+    if (!afterTag && !containers.isEmpty()) {
+        const Container &c = containers.last();
+        if (!c.indefinite && c.count == 0)
+            return;
+    }
+
+    Head head;
+    switch (decodeHead(0, &head)) {
+    case HeadOk:
+        current = head;
+        break;
+    case HeadBreak:
+        if (afterTag || containers.isEmpty() || !containers.last().indefinite
+                || (containers.last().isMap && containers.last().count % 2))
+            fail(QCborError::UnexpectedBreak);
+        break;
+    case HeadError:
+        break;
+    }
+}
+
+void QCborStreamReaderPrivate::itemDone()
+{
+    afterTag = false;
+    if (!containers.isEmpty()) {
+        Container &c = containers.last();
+        if (c.indefinite)
+            ++c.count;
+        else
+            --c.count;
+    }
+}
+
+/*!
+    \internal
+
+    Returns the contents of the current definite-length string and stores
+    its size in \a len, once the whole string is in the buffer.
+*/
+const char *QCborStreamReaderPrivate::stringData(int *len)
+{
+    Q_ASSERT(!current.indefinite);
+    if (current.value > quint64(MaxByteArraySize)) {
+        fail(QCborError::DataTooLarge);
+        return nullptr;
+    }
+    *len = int(current.value);
+    if (!ensure(current.size + *len))
+        return nullptr;
+    return buffer.constData() + pos + current.size;
+}
+
+/*!
+    \internal
+
+    Reads the string whose head is current, \a offset bytes after the
+    current position, and advances \a offset past it. The contents are
+    returned in \a out unless it is null; unless \a copy is set, they
+    reference the buffer if the string is in one piece.
+*/
+bool QCborStreamReaderPrivate::readStringData(qint64 *offset, QByteArray *out, bool copy)
+{
+    const QCborStreamReader::Type type = current.type;
+    Head head = current;
+    qint64 at = *offset;
+    QByteArray result;
+    if (head.indefinite)
+        ++at;
+
+    for (;;) {
+        if (head.indefinite) {
+            // indefinite-length strings are a sequence of definite-length
+            // chunks of the same type, ended by a break
+            const HeadResult r = decodeHead(at, &head);
+            if (r == HeadError)
+                return false;
+            if (r == HeadBreak) {
+                ++at;
+                break;
+            }
+            if (head.type != type || head.indefinite)
+                return fail(QCborError::IllegalType);
+        }
+
+        if (head.value > quint64(MaxByteArraySize - result.size()))
+            return fail(QCborError::DataTooLarge);
+        const int len = int(head.value);
+        if (!ensure(at + head.size + len))
+            return false;
+        const char *data = buffer.constData() + pos + at + head.size;
+        if (out && type == QCborStreamReader::TextString
+                && !QUtf8::isValidUtf8(data, len).isValidUtf8)
+            return fail(QCborError::InvalidUtf8String);
+        at += head.size + len;
+
+        if (!current.indefinite) {
+            if (out)
+                *out = copy ? QByteArray(data, len) : QByteArray::fromRawData(data, len);
+            *offset = at;
+            return true;
+        }
+        if (out)
+            result.append(data, len);
+        head.indefinite = true;
+    }
+
+    if (out)
+        *out = result;
+    *offset = at;
+    return true;
+}
+
+/*!
+    \internal
+
+    Skips the current item, including the contents of containers and the
+    items tags apply to, and advances \a offset past it. This is iterative,
+    so \a maxRecursion only limits the nesting, not the stack usage.
+*/
+bool QCborStreamReaderPrivate::skipItem(qint64 *offset, int maxRecursion)
+{
+    // most items are scalars or strings in one piece
+    switch (current.type) {
+    case QCborStreamReader::Array:
+    case QCborStreamReader::Map:
+    case QCborStreamReader::Tag:
+        break;
+    case QCborStreamReader::ByteString:
+    case QCborStreamReader::TextString:
+        if (!current.indefinite) {
+            int len;
+            if (!stringData(&len))
+                return false;
+            *offset = current.size + len;
+            return true;
+        }
+        break;
+    default:
+        *offset = current.size;
+        return true;
+    }
+
+    QVarLengthArray<Container, 16> pending;
+    const Head saved = current;
+    qint64 at = 0;
+    Head head = current;
+    for (;;) {
+        switch (head.type) {
+        case QCborStreamReader::Array:
+        case QCborStreamReader::Map: {
+            if (pending.size() >= maxRecursion)
+                return fail(QCborError::NestingTooDeep);
+            Container c;
+            if (!containerFor(head, &c))
+                return false;
+            pending.append(c);
+            at += head.size;
+            break;
+        }
+        case QCborStreamReader::Tag:
+            at += head.size;
+            if (!expectItem(at, &head))
+                return false;
+            continue;
+        case QCborStreamReader::ByteString:
+        case QCborStreamReader::TextString:
+            if (!head.indefinite) {
+                if (head.value > quint64(MaxByteArraySize))
+                    return fail(QCborError::DataTooLarge);
+                at += head.size + qint64(head.value);
+                if (!ensure(at))
+                    return false;
+                break;
+            }
+            current = head;
+            if (!readStringData(&at, nullptr, false))
+                return false;
+            current = saved;
+            break;
+        default:
+            at += head.size;
+            break;
+        }
+
+        // find the next item to skip, leaving the containers that ended
+        for (;;) {
+            if (pending.isEmpty()) {
+                *offset = at;
+                return true;
+            }
+            Container &c = pending.last();
+            if (!c.indefinite) {
+                if (c.count == 0) {
+                    pending.removeLast();
+                    continue;
+                }
+                --c.count;
+                if (!expectItem(at, &head))
+                    return false;
+                break;
+            }
+            const HeadResult r = decodeHead(at, &head);
+            if (r == HeadError)
+                return false;
+            if (r == HeadOk) {
+                ++c.count;
+                break;
+            }
+            if (c.isMap && c.count % 2)
+                return fail(QCborError::UnexpectedBreak);
+            ++at;
+            pending.removeLast();
+        }
+    }
+}
+
+/*!
+    \class QCborStreamReader
+    \inmodule QtCore
+    \reentrant
+    \since 5.12
+
+    \brief The QCborStreamReader class is a simple CBOR stream decoder,
+    operating on either a QByteArray or QIODevice.
+
+    CBOR, the Concise Binary Object Representation, is a binary data format
+    defined in RFC 7049 that covers the JSON data model and extends it with
+    byte strings, integers of up to 64 bits and tags that give values
+    additional meaning. It is much faster to read and write than JSON text,
+    and unlike the binary format of QJsonDocument, it is a stable and
+    interoperable standard.
+
+    QCborStreamReader decodes a CBOR stream one item at a time. type()
+    returns the type of the current item, and the to*() functions such as
+    toInteger() and toDouble() return its value. next() advances to the
+    next item:
+
+    \snippet code/src_corelib_serialization_qcborstream.cpp 0
+
+    Arrays and maps are entered with enterContainer(), after which the
+    reader iterates over their items until hasNext() returns \c false. The
+    items of a map alternate between keys and values. leaveContainer()
+    skips the remaining items and continues after the container. Calling
+    next() on a container skips it entirely. A Tag item applies to the item
+    that follows it; next() moves from the tag to that item.
+
+    Strings are read with readString() and readByteArray(), which also
+    advance to the next item. readStringData() avoids copying the contents
+    of a string: when the reader was created on a buffer, for example on a
+    memory-mapped file, the returned QByteArray points into that buffer.
+
+    readJsonValue() and readVariant() read the current item, including the
+    contents of containers, and convert it into a QJsonValue or QVariant.
+    QCborStreamWriter::appendJsonValue() and
+    QCborStreamWriter::appendVariant() convert in the other direction.
+
+    The reader validates the stream as it goes. When it finds a malformed
+    item, type() becomes Invalid and lastError() returns the error. When
+    the data ends in the middle of an item, lastError() returns EndOfFile;
+    if more data is added with addData(), reparse() resumes decoding. At
+    the top level, a stream can contain any number of items, and EndOfFile
+    also indicates that there are no more.
+
+    \sa QCborStreamWriter, QJsonStreamReader
+*/
+
+/*!
+    \enum QCborStreamReader::Type
+
+    This enum contains the types of items found in a CBOR stream.
+
+    \value UnsignedInteger An integer from 0 to 2\sup{64} - 1, returned by
+           toUnsignedInteger() and toInteger().
+    \value NegativeInteger An integer from -1 to -2\sup{64}, returned by
+           toNegativeInteger() and toInteger().
+    \value ByteString A byte string, read with readByteArray() or
+           readStringData().
+    \value ByteArray Same as ByteString.
+    \value TextString A UTF-8 text string, read with readString() or
+           readStringData().
+    \value String Same as TextString.
+    \value Array An array, entered with enterContainer().
+    \value Map A map, entered with enterContainer().
+    \value Tag A tag, returned by toTag(), which applies to the next item.
+    \value SimpleType A simple type, such as \c false, \c true and \c null,
+           returned by toSimpleType().
+    \value HalfFloat A half-precision floating point number, returned by
+           toFloat16().
+    \value Float16 Same as HalfFloat.
+    \value Float A single-precision floating point number, returned by toFloat().
+    \value Double A double-precision floating point number, returned by toDouble().
+    \value Invalid The reader is at the end of a container or of the data,
+           or has found an error.
+*/
+
+/*!
+    \enum QCborStreamReader::StringResultCode
+
+    This enum is the status of the StringResult returned by readString(),
+    readByteArray() and readStringData().
+
+    \value Ok The string was read, and the reader advanced to the next item.
+    \value Error The string could not be read; lastError() says why.
+*/
+
+/*!
+    \class QCborStreamReader::StringResult
+    \inmodule QtCore
+
+    This class holds the result of reading a string: its contents in \c
+    data and whether reading succeeded in \c status.
+*/
+
+/*!
+    Constructs a QCborStreamReader with no data. Use addData() or
+    setDevice() to provide some.
+*/
+QCborStreamReader::QCborStreamReader()
+    : d_ptr(new QCborStreamReaderPrivate(this))
+{
+    d_ptr->preparse();
+}
+
+/*!
+    Constructs a QCborStreamReader that reads the \a len bytes at \a data.
+    The data is not copied, so it must stay valid and unmodified as long as
+    the reader uses it.
+*/
+QCborStreamReader::QCborStreamReader(const char *data, qsizetype len)
+    : d_ptr(new QCborStreamReaderPrivate(this))
+{
+    d_ptr->buffer = QByteArray::fromRawData(data, int(len));
+    d_ptr->preparse();
+}
+
+/*!
+    \overload
+*/
+QCborStreamReader::QCborStreamReader(const quint8 *data, qsizetype len)
+    : d_ptr(new QCborStreamReaderPrivate(this))
+{
+    d_ptr->buffer = QByteArray::fromRawData(reinterpret_cast<const char *>(data), int(len));
+    d_ptr->preparse();
+}
+
+/*!
+    Constructs a QCborStreamReader that reads from \a data. The reader
+    keeps a shallow copy of \a data.
+*/
+QCborStreamReader::QCborStreamReader(const QByteArray &data)
+    : d_ptr(new QCborStreamReaderPrivate(this))
+{
+    d_ptr->buffer = data;
+    d_ptr->preparse();
+}
+
+/*!
+    Constructs a QCborStreamReader that reads from \a device.
+*/
+QCborStreamReader::QCborStreamReader(QIODevice *device)
+    : d_ptr(new QCborStreamReaderPrivate(this))
+{
+    d_ptr->device = device;
+    d_ptr->preparse();
+}
+
+/*!
+    Destroys the reader.
+*/
+QCborStreamReader::~QCborStreamReader()
+{
+}
+
+/*!
+    Discards any data the reader holds and makes it read from \a device.
+*/
+void QCborStreamReader::setDevice(QIODevice *device)
+{
+    Q_D(QCborStreamReader);
+    d->reset();
+    d->device = device;
+    d->preparse();
+}
+
+/*!
+    Returns the device the reader reads from, or \c nullptr if it reads
+    from a buffer.
+*/
+QIODevice *QCborStreamReader::device() const
+{
+    Q_D(const QCborStreamReader);
+    return d->device;
+}
+
+/*!
+    Adds \a data to the end of the data the reader reads. Call reparse()
+    afterwards if the reader stopped with an EndOfFile error.
+
+    Adding data invalidates the results of readStringData() for items
+    read so far.
+*/
+void QCborStreamReader::addData(const QByteArray &data)
+{
+    addData(data.constData(), data.size());
+}
+
+/*!
+    \fn void QCborStreamReader::addData(const quint8 *data, qsizetype len)
+    \overload
+*/
+
+/*!
+    \overload
+
+    Adds the \a len bytes at \a data.
+*/
+void QCborStreamReader::addData(const char *data, qsizetype len)
+{
+    Q_D(QCborStreamReader);
+    if (d->device) {
+        qWarning("QCborStreamReader: addData() with device()");
+        return;
+    }
+    d->compact();
+    d->buffer.append(data, int(len));
+}
+
+/*!
+    Decodes the current item again, after an EndOfFile error once more
+    data was added with addData(), or became available in the device.
+*/
+void QCborStreamReader::reparse()
+{
+    Q_D(QCborStreamReader);
+    if (d->lastError == QCborError::EndOfFile)
+        d->lastError.c = QCborError::NoError;
+    d->preparse();
+}
+
+/*!
+    Discards all data and the device, and resets the reader to its initial
+    state.
+
+    \sa reset()
+*/
+void QCborStreamReader::clear()
+{
+    Q_D(QCborStreamReader);
+    d->reset();
+    d->device = nullptr;
+    d->preparse();
+}
+
+/*!
+    Rewinds the reader to the beginning of the data it holds, or, when
+    reading from a device, to the beginning of the device. Errors are
+    cleared.
+
+    \sa clear()
+*/
+void QCborStreamReader::reset()
+{
+    Q_D(QCborStreamReader);
+    if (d->device) {
+        d->buffer.clear();
+        d->device->reset();
+    } else if (d->bufferStart) {
+        qWarning("QCborStreamReader::reset: data consumed by addData() cannot be rewound");
+    }
+    d->bufferStart = 0;
+    d->pos = 0;
+    d->afterTag = false;
+    d->lastError.c = QCborError::NoError;
+    d->containers.clear();
+    d->preparse();
+}
+
+/*!
+    Returns the last error, or QCborError::NoError.
+*/
+QCborError QCborStreamReader::lastError() const
+{
+    Q_D(const QCborStreamReader);
+    return d->lastError;
+}
+
+/*!
+    Returns the offset of the current item from the beginning of the data.
+*/
+qint64 QCborStreamReader::currentOffset() const
+{
+    Q_D(const QCborStreamReader);
+    return d->bufferStart + d->pos;
+}
+
+/*!
+    \fn bool QCborStreamReader::isValid() const
+
+    Returns \c true unless the reader is at the end of a container or of
+    the data, or has found an error.
+*/
+
+/*!
+    Returns the number of containers the reader entered with
+    enterContainer() and has not left yet.
+*/
+int QCborStreamReader::containerDepth() const
+{
+    Q_D(const QCborStreamReader);
+    return d->containers.size();
+}
+
+/*!
+    Returns Array or Map if the reader is inside a container, and Invalid
+    at the top level.
+*/
+QCborStreamReader::Type QCborStreamReader::parentContainerType() const
+{
+    Q_D(const QCborStreamReader);
+    if (d->containers.isEmpty())
+        return Invalid;
+    return d->containers.last().isMap ? Map : Array;
+}
+
+/*!
+    Returns \c true if there is an item to read in the current container,
+    or at the top level, and \c false at the end of the container, at the
+    end of the data, and after an error.
+*/
+bool QCborStreamReader::hasNext() const
+{
+    return type() != Invalid;
+}
+
+/*!
+    Advances to the next item. Arrays and maps are skipped with all their
+    contents, as long as they are nested at most \a maxRecursion levels
+    deep; tags advance to the item they apply to. Returns \c true if the
+    current item was skipped, and \c false at the end of a container and
+    on errors.
+
+    \sa enterContainer(), leaveContainer()
+*/
+bool QCborStreamReader::next(int maxRecursion)
+{
+    Q_D(QCborStreamReader);
+    if (d->current.type == Invalid)
+        return false;
+
+    if (d->current.type == Tag) {
+        d->pos += d->current.size;
+        d->afterTag = true;
+    } else {
+        qint64 offset;
+        if (!d->skipItem(&offset, maxRecursion))
+            return false;
+        d->advance(offset);
+        return true;
+    }
+    d->preparse();
+    return true;
+}
+
+/*!
+    Returns the type of the current item.
+*/
+QCborStreamReader::Type QCborStreamReader::type() const
+{
+    Q_D(const QCborStreamReader);
+    return d->current.type;
+}
+
+/*!
+    \fn bool QCborStreamReader::isUnsignedInteger() const
+    Returns \c true if the current item is an UnsignedInteger.
+*/
+/*!
+    \fn bool QCborStreamReader::isNegativeInteger() const
+    Returns \c true if the current item is a NegativeInteger.
+*/
+/*!
+    \fn bool QCborStreamReader::isInteger() const
+    Returns \c true if the current item is an UnsignedInteger or a
+    NegativeInteger.
+*/
+/*!
+    \fn bool QCborStreamReader::isByteArray() const
+    Returns \c true if the current item is a ByteString.
+*/
+/*!
+    \fn bool QCborStreamReader::isString() const
+    Returns \c true if the current item is a TextString.
+*/
+/*!
+    \fn bool QCborStreamReader::isArray() const
+    Returns \c true if the current item is an Array.
+*/
+/*!
+    \fn bool QCborStreamReader::isMap() const
+    Returns \c true if the current item is a Map.
+*/
+/*!
+    \fn bool QCborStreamReader::isTag() const
+    Returns \c true if the current item is a Tag.
+*/
+/*!
+    \fn bool QCborStreamReader::isSimpleType() const
+    Returns \c true if the current item is a SimpleType.
+*/
+/*!
+    \fn bool QCborStreamReader::isFloat16() const
+    Returns \c true if the current item is a Float16.
+*/
+/*!
+    \fn bool QCborStreamReader::isFloat() const
+    Returns \c true if the current item is a Float.
+*/
+/*!
+    \fn bool QCborStreamReader::isDouble() const
+    Returns \c true if the current item is a Double.
+*/
+/*!
+    \fn bool QCborStreamReader::isInvalid() const
+    Returns \c true if the current item is Invalid.
+*/
+/*!
+    \fn bool QCborStreamReader::isSimpleType(QCborSimpleType st) const
+    \overload
+    Returns \c true if the current item is the simple type \a st.
+*/
+/*!
+    \fn bool QCborStreamReader::isFalse() const
+    Returns \c true if the current item is \c false.
+*/
+/*!
+    \fn bool QCborStreamReader::isTrue() const
+    Returns \c true if the current item is \c true.
+*/
+/*!
+    \fn bool QCborStreamReader::isBool() const
+    Returns \c true if the current item is \c false or \c true.
+*/
+/*!
+    \fn bool QCborStreamReader::isNull() const
+    Returns \c true if the current item is \c null.
+*/
+/*!
+    \fn bool QCborStreamReader::isUndefined() const
+    Returns \c true if the current item is \c undefined.
+*/
+/*!
+    \fn bool QCborStreamReader::isContainer() const
+    Returns \c true if the current item is an Array or a Map.
+*/
+/*!
+    \fn bool QCborStreamReader::toBool() const
+    Returns \c true if the current item is \c true, and \c false otherwise.
+*/
+
+/*!
+    Returns \c true if the current string, array or map encodes its length,
+    and \c false if it has indefinite length.
+
+    \sa length()
+*/
+bool QCborStreamReader::isLengthKnown() const
+{
+    Q_D(const QCborStreamReader);
+    return !d->current.indefinite;
+}
+
+/*!
+    Returns the length of the current string in bytes, or the number of
+    items in the current array, or of entries in the current map. Returns
+    0 for items of indefinite length.
+
+    \sa isLengthKnown()
+*/
+quint64 QCborStreamReader::length() const
+{
+    Q_D(const QCborStreamReader);
+    return d->current.value;
+}
+
+/*!
+    Enters the current array or map, so that the reader iterates over its
+    items. Returns \c true on success.
+
+    \sa leaveContainer(), containerDepth()
+*/
+bool QCborStreamReader::enterContainer()
+{
+    Q_D(QCborStreamReader);
+    Q_ASSERT(isContainer());
+    if (!isContainer())
+        return false;
+    QCborStreamReaderPrivate::Container c;
+    if (!d->containerFor(d->current, &c))
+        return false;
+    d->pos += d->current.size;
+    d->afterTag = false;
+    d->containers.append(c);
+    d->preparse();
+    return true;
+}
+
+/*!
+    Skips the remaining items of the container the reader is in, and
+    advances to the item after it. Returns \c true on success.
+
+    \sa enterContainer()
+*/
+bool QCborStreamReader::leaveContainer()
+{
+    Q_D(QCborStreamReader);
+    Q_ASSERT(!d->containers.isEmpty());
+    if (d->containers.isEmpty())
+        return false;
+    while (hasNext())
+        next();
+    if (d->lastError != QCborError::NoError)
+        return false;
+
+    if (d->containers.last().indefinite)
+        ++d->pos;       // the break
+    d->containers.removeLast();
+    d->itemDone();
+    d->preparse();
+    return true;
+}
+
+/*!
+    Reads the current text string, and advances to the next item.
+
+    \sa readByteArray(), readStringData()
+*/
+QCborStreamReader::StringResult<QString> QCborStreamReader::readString()
+{
+    Q_D(QCborStreamReader);
+    StringResult<QString> result;
+    Q_ASSERT(isString());
+    if (!isString())
+        return result;
+
+    if (!d->current.indefinite) {
+        int len;
+        const char *data = d->stringData(&len);
+        if (!data)
+            return result;
+        const QUtf8::ValidUtf8Result check = QUtf8::isValidUtf8(data, len);
+        if (!check.isValidUtf8) {
+            d->fail(QCborError::InvalidUtf8String);
+            return result;
+        }
+        result.data = check.isValidAscii ? QString::fromLatin1(data, len)
+                                         : QUtf8::convertToUnicode(data, len);
+        result.status = Ok;
+        d->advance(d->current.size + len);
+        return result;
+    }
+
+    QByteArray utf8;
+    qint64 offset = 0;
+    if (!d->readStringData(&offset, &utf8, false))
+        return result;
+    result.data = QUtf8::convertToUnicode(utf8.constData(), utf8.size());
+    result.status = Ok;
+    d->advance(offset);
+    return result;
+}
+
+/*!
+    Reads the current byte string, and advances to the next item.
+
+    \sa readString(), readStringData()
+*/
+QCborStreamReader::StringResult<QByteArray> QCborStreamReader::readByteArray()
+{
+    Q_D(QCborStreamReader);
+    StringResult<QByteArray> result;
+    qint64 offset = 0;
+    Q_ASSERT(isByteArray());
+    if (!isByteArray() || !d->readStringData(&offset, &result.data, true))
+        return result;
+
+    result.status = Ok;
+    d->advance(offset);
+    return result;
+}
+
+/*!
+    Reads the current byte or text string without copying it, and advances
+    to the next item. For text strings, the UTF-8 encoded contents are
+    returned, after checking that they are valid.
+
+    Unless the string has indefinite length or the reader reads from a
+    device, the returned QByteArray refers to the data the reader was
+    created on, or to its internal buffer, as if created with
+    QByteArray::fromRawData(). In the first case, it stays valid as long as
+    that data; in the second case, only until more data is added or the
+    reader is destroyed. Strings read from a device are always copied,
+    since advancing to the next item may refill the buffer.
+
+    \sa readString(), readByteArray()
+*/
+QCborStreamReader::StringResult<QByteArray> QCborStreamReader::readStringData()
+{
+    Q_D(QCborStreamReader);
+    StringResult<QByteArray> result;
+    qint64 offset = 0;
+    Q_ASSERT(isString() || isByteArray());
+    if ((!isString() && !isByteArray())
+            || !d->readStringData(&offset, &result.data, d->device != nullptr))
+        return result;
+
+    result.status = Ok;
+    d->advance(offset);
+    return result;
+}
+
+/*!
+    Returns the value of the current Tag.
+*/
+QCborTag QCborStreamReader::toTag() const
+{
+    Q_D(const QCborStreamReader);
+    Q_ASSERT(isTag());
+    return QCborTag(d->current.value);
+}
+
+/*!
+    Returns the value of the current UnsignedInteger.
+*/
+quint64 QCborStreamReader::toUnsignedInteger() const
+{
+    Q_D(const QCborStreamReader);
+    Q_ASSERT(isUnsignedInteger());
+    return d->current.value;
+}
+
+/*!
+    Returns the absolute value of the current NegativeInteger. The value
+    -2\sup{64} is returned as 0.
+*/
+QCborNegativeInteger QCborStreamReader::toNegativeInteger() const
+{
+    Q_D(const QCborStreamReader);
+    Q_ASSERT(isNegativeInteger());
+    return QCborNegativeInteger(d->current.value + 1);
+}
+
+/*!
+    Returns the value of the current UnsignedInteger or NegativeInteger.
+    Values outside of the range of qint64 are truncated.
+*/
+qint64 QCborStreamReader::toInteger() const
+{
+    Q_D(const QCborStreamReader);
+    Q_ASSERT(isInteger());
+    if (isNegativeInteger())
+        return -1 - qint64(d->current.value);
+    return qint64(d->current.value);
+}
+
+/*!
+    Returns the value of the current SimpleType.
+*/
+QCborSimpleType QCborStreamReader::toSimpleType() const
+{
+    Q_D(const QCborStreamReader);
+    return QCborSimpleType(quint8(d->current.value));
+}
+
+/*!
+    Returns the value of the current Float16.
+*/
+qfloat16 QCborStreamReader::toFloat16() const
+{
+    Q_D(const QCborStreamReader);
+    Q_ASSERT(isFloat16());
+    const quint16 bits = quint16(d->current.value);
+    qfloat16 f;
+    memcpy(static_cast<void *>(&f), &bits, sizeof(f));
+    return f;
+}
+
+/*!
+    Returns the value of the current Float.
+*/
+float QCborStreamReader::toFloat() const
+{
+    Q_D(const QCborStreamReader);
+    Q_ASSERT(isFloat());
+    const quint32 bits = quint32(d->current.value);
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+/*!
+    Returns the value of the current Double, Float or Float16.
+*/
+double QCborStreamReader::toDouble() const
+{
+    Q_D(const QCborStreamReader);
+    switch (d->current.type) {
+    case Float16:
+        return double(float(toFloat16()));
+    case Float:
+        return double(toFloat());
+    default:
+        break;
+    }
+    Q_ASSERT(isDouble());
+    double result;
+    memcpy(&result, &d->current.value, sizeof(result));
+    return result;
+}
+
+static QString jsonKeyFromValue(const QJsonValue &value)
+{
+    switch (value.type()) {
+    case QJsonValue::String:
+        return value.toString();
+    case QJsonValue::Double: {
+        const double d = value.toDouble();
+        if (d == std::floor(d) && qAbs(d) < 9007199254740992.)
+            return QString::number(qint64(d));
+        return QString::number(d, 'g', QLocale::FloatingPointShortest);
+    }
+    case QJsonValue::Bool:
+        return value.toBool() ? QStringLiteral("true") : QStringLiteral("false");
+    case QJsonValue::Array:
+        return QString::fromUtf8(QJsonDocument(value.toArray()).toJson(QJsonDocument::Compact));
+    case QJsonValue::Object:
+        return QString::fromUtf8(QJsonDocument(value.toObject()).toJson(QJsonDocument::Compact));
+    case QJsonValue::Null:
+    case QJsonValue::Undefined:
+        break;
+    }
+    return QStringLiteral("null");
+}
+
+QString QCborStreamReaderPrivate::readJsonKey(int depth)
+{
+    Q_Q(QCborStreamReader);
+    if (current.type == QCborStreamReader::TextString)
+        return q->readString().data;
+    return jsonKeyFromValue(readJson(depth, Base64url));
+}
+
+/*!
+    \internal
+
+    Converts the current array or map to a QJsonArray or QJsonObject. Like
+    the JSON parser, this writes the binary format of QJsonDocument
+    directly, which is much faster than inserting the items one by one.
+*/
+QJsonValue QCborStreamReaderPrivate::readJsonContainer(int depth, ByteEncoding encoding)
+{
+    JsonBuffer out;
+    out.length = qMax(int(buffer.size() - pos) * 2, 256);
+    out.data = static_cast<char *>(malloc(size_t(out.length)));
+    if (!out.data) {
+        fail(QCborError::DataTooLarge);
+        return QJsonValue(QJsonValue::Undefined);
+    }
+
+    QJsonPrivate::Header *h = reinterpret_cast<QJsonPrivate::Header *>(out.data);
+    h->tag = QJsonDocument::BinaryFormatTag;
+    h->version = 1u;
+    out.current = sizeof(QJsonPrivate::Header);
+
+    if (!buildJsonContainer(&out, depth, encoding)) {
+        free(out.data);
+        return QJsonValue(QJsonValue::Undefined);
+    }
+
+    const QJsonDocument doc(new QJsonPrivate::Data(out.data, out.current));
+    if (doc.isArray())
+        return doc.array();
+    return doc.object();
+}
+
+bool QCborStreamReaderPrivate::buildJsonContainer(JsonBuffer *out, int depth,
+                                                  ByteEncoding encoding)
+{
+    Q_Q(QCborStreamReader);
+    if (depth > NestingLimit)
+        return fail(QCborError::NestingTooDeep);
+
+    const bool isObject = (current.type == QCborStreamReader::Map);
+    const int baseOffset = out->reserveSpace(sizeof(QJsonPrivate::Base));
+    if (baseOffset < 0)
+        return fail(QCborError::DataTooLarge);
+    if (!q->enterContainer())
+        return false;
+
+    // arrays collect their values, objects the offsets of their entries,
+    // sorted by key; the table follows the data
+    QVarLengthArray<QJsonPrivate::Value, 64> values;
+    QVarLengthArray<uint, 64> offsets;
+    while (q->hasNext()) {
+        QJsonPrivate::Value val;
+        val._dummy = 0;
+        if (!isObject) {
+            if (!buildJsonValue(out, &val, baseOffset, depth + 1, encoding))
+                return false;
+            values.append(val);
+            continue;
+        }
+
+        const int entryOffset = out->reserveSpace(sizeof(QJsonPrivate::Entry));
+        if (entryOffset < 0)
+            return fail(QCborError::DataTooLarge);
+        bool latin1 = false;
+        if (current.type == QCborStreamReader::TextString) {
+            if (!buildJsonString(out, &latin1))
+                return false;
+        } else {
+            const QString key = readJsonKey(depth + 1);
+            if (lastError != QCborError::NoError)
+                return false;
+            latin1 = QJsonPrivate::useCompressed(key);
+            const int keyOffset = out->reserveSpace(QJsonPrivate::qStringSize(key, latin1));
+            if (keyOffset < 0)
+                return fail(QCborError::DataTooLarge);
+            QJsonPrivate::copyString(out->data + keyOffset, key, latin1);
+        }
+        if (!q->hasNext())
+            return false;
+        if (!buildJsonValue(out, &val, baseOffset, depth + 1, encoding))
+            return false;
+        val.latinKey = latin1;
+        QJsonPrivate::Entry *entry = reinterpret_cast<QJsonPrivate::Entry *>(out->data + entryOffset);
+        entry->value = val;
+
+        // the last of several equal keys wins, as with QJsonObject::insert()
+        const uint offset = uint(entryOffset - baseOffset);
+        const auto entryAt = [out, baseOffset](uint o) {
+            return reinterpret_cast<const QJsonPrivate::Entry *>(out->data + baseOffset + o);
+        };
+        const QJsonPrivate::Entry *newEntry = entryAt(offset);
+        int min = 0;
+        int n = offsets.size();
+        while (n > 0) {
+            const int half = n >> 1;
+            const int middle = min + half;
+            if (*entryAt(offsets[middle]) >= *newEntry) {
+                n = half;
+            } else {
+                min = middle + 1;
+                n -= half + 1;
+            }
+        }
+        if (min < offsets.size() && *entryAt(offsets[min]) == *newEntry)
+            offsets[min] = offset;
+        else
+            offsets.insert(min, offset);
+    }
+    if (!q->leaveContainer())
+        return false;
+
+    int table = baseOffset;
+    const int length = isObject ? offsets.size() : values.size();
+    if (length) {
+        const int tableSize = isObject ? length * int(sizeof(QJsonPrivate::offset))
+                                       : length * int(sizeof(QJsonPrivate::Value));
+        table = out->reserveSpace(tableSize);
+        if (table < 0)
+            return fail(QCborError::DataTooLarge);
+        if (!isObject) {
+            memcpy(out->data + table, values.constData(), size_t(tableSize));
+        } else {
+            QJsonPrivate::offset *o = reinterpret_cast<QJsonPrivate::offset *>(out->data + table);
+            for (int i = 0; i < length; ++i)
+                o[i] = offsets[i];
+        }
+    }
+
+    QJsonPrivate::Base *b = reinterpret_cast<QJsonPrivate::Base *>(out->data + baseOffset);
+    b->tableOffset = table - baseOffset;
+    b->size = out->current - baseOffset;
+    b->is_object = isObject;
+    b->length = length;
+    return true;
+}
+
+bool QCborStreamReaderPrivate::buildJsonValue(JsonBuffer *out, QJsonPrivate::Value *val,
+                                              int baseOffset, int depth, ByteEncoding encoding)
+{
+    if (out->current - baseOffset >= QJsonPrivate::Value::MaxSize)
+        return fail(QCborError::DataTooLarge);
+
+    switch (current.type) {
+    case QCborStreamReader::Array:
+    case QCborStreamReader::Map:
+        val->type = current.type == QCborStreamReader::Map ? QJsonValue::Object : QJsonValue::Array;
+        val->value = out->current - baseOffset;
+        return buildJsonContainer(out, depth, encoding);
+    case QCborStreamReader::TextString:
+        if (!current.indefinite) {
+            bool latin1;
+            val->type = QJsonValue::String;
+            val->value = out->current - baseOffset;
+            if (!buildJsonString(out, &latin1))
+                return false;
+            val->latinOrIntValue = latin1;
+            return true;
+        }
+        break;
+    case QCborStreamReader::Tag: {
+        const QCborKnownTags tag = QCborKnownTags(current.value);
+        if (tag == QCborKnownTags::PositiveBignum || tag == QCborKnownTags::NegativeBignum)
+            break;
+        if (tag == QCborKnownTags::ExpectedBase64url)
+            encoding = Base64url;
+        else if (tag == QCborKnownTags::ExpectedBase64)
+            encoding = Base64;
+        else if (tag == QCborKnownTags::ExpectedBase16)
+            encoding = Base16;
+        q_func()->next();
+        return buildJsonValue(out, val, baseOffset, depth + 1, encoding);
+    }
+    case QCborStreamReader::UnsignedInteger:
+    case QCborStreamReader::NegativeInteger:
+    case QCborStreamReader::Float16:
+    case QCborStreamReader::Float:
+    case QCborStreamReader::Double: {
+        double d;
+        if (current.type == QCborStreamReader::UnsignedInteger)
+            d = double(current.value);
+        else if (current.type == QCborStreamReader::NegativeInteger)
+            d = -1 - double(current.value);
+        else
+            d = q_func()->toDouble();
+        if (!qIsFinite(d)) {
+            val->type = QJsonValue::Null;
+            return q_func()->next();
+        }
+        val->type = QJsonValue::Double;
+        const int compressed = QJsonPrivate::compressedNumber(d);
+        if (compressed != INT_MAX) {
+            val->latinOrIntValue = true;
+            val->int_value = compressed;
+        } else {
+            const int valueOffset = out->reserveSpace(sizeof(double));
+            if (valueOffset < 0)
+                return fail(QCborError::DataTooLarge);
+            quint64 bits;
+            memcpy(&bits, &d, sizeof(bits));
+            qToLittleEndian(bits, out->data + valueOffset);
+            val->value = valueOffset - baseOffset;
+        }
+        return q_func()->next();
+    }
+    case QCborStreamReader::SimpleType:
+        if (q_func()->isBool()) {
+            val->type = QJsonValue::Bool;
+            val->value = q_func()->toBool();
+        } else {
+            val->type = QJsonValue::Null;
+        }
+        return q_func()->next();
+    default:
+        break;
+    }
+
+    // the remaining items convert to a scalar QJsonValue first
+    QJsonValue v = readJson(depth, encoding);
+    if (v.isUndefined())
+        return false;
+    bool compressed;
+    const int size = QJsonPrivate::Value::requiredStorage(v, &compressed);
+    const int valueOffset = out->reserveSpace(size);
+    if (valueOffset < 0)
+        return fail(QCborError::DataTooLarge);
+    val->type = v.type();
+    val->latinOrIntValue = compressed;
+    val->value = QJsonPrivate::Value::valueToStore(v, valueOffset - baseOffset);
+    QJsonPrivate::Value::copyData(v, out->data + valueOffset, compressed);
+    return true;
+}
+
+/*!
+    \internal
+
+    Writes the current definite-length text string in the binary format of
+    QJsonDocument, as a Latin-1 string if it is short and ASCII only.
+*/
+bool QCborStreamReaderPrivate::buildJsonString(JsonBuffer *out, bool *latin1)
+{
+    int len;
+    const char *data = stringData(&len);
+    if (!data)
+        return false;
+    if (len >= QJsonPrivate::Value::MaxSize)
+        return fail(QCborError::DataTooLarge);
+    const QUtf8::ValidUtf8Result check = QUtf8::isValidUtf8(data, len);
+    if (!check.isValidUtf8)
+        return fail(QCborError::InvalidUtf8String);
+
+    *latin1 = check.isValidAscii && len < 0x8000;
+    if (*latin1) {
+        const int pos = out->reserveSpace(QJsonPrivate::alignedSize(int(sizeof(ushort)) + len));
+        if (pos < 0)
+            return fail(QCborError::DataTooLarge);
+        QJsonPrivate::Latin1String::Data *s =
+                reinterpret_cast<QJsonPrivate::Latin1String::Data *>(out->data + pos);
+        s->length = ushort(len);
+        memcpy(s->latin1, data, size_t(len));
+        memset(s->latin1 + len, 0, size_t(out->current - pos - int(sizeof(ushort)) - len));
+    } else {
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+        // UTF-8 never needs more UTF-16 code units than it has bytes
+        const int pos = out->reserveSpace(QJsonPrivate::alignedSize(int(sizeof(int)) + 2 * len));
+        if (pos < 0)
+            return fail(QCborError::DataTooLarge);
+        QJsonPrivate::String::Data *s = reinterpret_cast<QJsonPrivate::String::Data *>(out->data + pos);
+        QChar *begin = reinterpret_cast<QChar *>(s->utf16);
+        const int length = int(QUtf8::convertToUnicode(begin, data, len) - begin);
+        s->length = length;
+        out->current = pos + QJsonPrivate::alignedSize(int(sizeof(int)) + 2 * length);
+        memset(static_cast<void *>(begin + length), 0,
+               size_t(out->current - pos - int(sizeof(int)) - 2 * length));
+#else
+        const QString str = QUtf8::convertToUnicode(data, len);
+        const int pos = out->reserveSpace(QJsonPrivate::qStringSize(str, false));
+        if (pos < 0)
+            return fail(QCborError::DataTooLarge);
+        QJsonPrivate::copyString(out->data + pos, str, false);
+#endif
+    }
+    advance(current.size + len);
+    return true;
+}
+
+/*!
+    \internal
+
+    Converts the current item to JSON as suggested by RFC 7049: byte
+    strings become base64url strings, unless a tag asks for another
+    encoding, and values JSON cannot represent become null.
+*/
+QJsonValue QCborStreamReaderPrivate::readJson(int depth, ByteEncoding encoding)
+{
+    Q_Q(QCborStreamReader);
+    if (depth > NestingLimit) {
+        fail(QCborError::NestingTooDeep);
+        return QJsonValue(QJsonValue::Undefined);
+    }
+
+    // the reader reports EndOfFile after the last top-level item, so
+    // success is judged by the steps that read this item
+    QJsonValue result;
+    bool ok = false;
+    switch (current.type) {
+    case QCborStreamReader::UnsignedInteger:
+        result = current.value <= quint64(std::numeric_limits<qint64>::max())
+                ? QJsonValue(qint64(current.value)) : QJsonValue(double(current.value));
+        ok = q->next();
+        break;
+    case QCborStreamReader::NegativeInteger:
+        result = current.value <= quint64(std::numeric_limits<qint64>::max())
+                ? QJsonValue(-1 - qint64(current.value)) : QJsonValue(-1 - double(current.value));
+        ok = q->next();
+        break;
+    case QCborStreamReader::ByteString: {
+        const QCborStreamReader::StringResult<QByteArray> r = q->readStringData();
+        ok = (r.status == QCborStreamReader::Ok);
+        switch (encoding) {
+        case Base64url:
+            result = QString::fromLatin1(r.data.toBase64(QByteArray::Base64UrlEncoding
+                                                         | QByteArray::OmitTrailingEquals));
+            break;
+        case Base64:
+            result = QString::fromLatin1(r.data.toBase64());
+            break;
+        case Base16:
+            result = QString::fromLatin1(r.data.toHex());
+            break;
+        }
+        break;
+    }
+    case QCborStreamReader::TextString: {
+        const QCborStreamReader::StringResult<QString> r = q->readString();
+        ok = (r.status == QCborStreamReader::Ok);
+        result = r.data;
+        break;
+    }
+    case QCborStreamReader::Array:
+    case QCborStreamReader::Map:
+        return readJsonContainer(depth, encoding);
+    case QCborStreamReader::Tag: {
+        const QCborKnownTags tag = QCborKnownTags(current.value);
+        q->next();
+        switch (tag) {
+        case QCborKnownTags::ExpectedBase64url:
+            encoding = Base64url;
+            break;
+        case QCborKnownTags::ExpectedBase64:
+            encoding = Base64;
+            break;
+        case QCborKnownTags::ExpectedBase16:
+            encoding = Base16;
+            break;
+        case QCborKnownTags::PositiveBignum:
+        case QCborKnownTags::NegativeBignum:
+            if (current.type == QCborStreamReader::ByteString) {
+                const QJsonValue digits = readJson(depth + 1, Base64url);
+                if (tag == QCborKnownTags::PositiveBignum || digits.isUndefined())
+                    return digits;
+                return QJsonValue(QLatin1Char('~') + digits.toString());
+            }
+            break;
+        default:
+            break;
+        }
+        return readJson(depth + 1, encoding);
+    }
+    case QCborStreamReader::SimpleType:
+        if (q->isBool())
+            result = q->toBool();
+        else
+            result = QJsonValue(QJsonValue::Null);
+        ok = q->next();
+        break;
+    case QCborStreamReader::Float16:
+    case QCborStreamReader::Float:
+    case QCborStreamReader::Double: {
+        const double d = q->toDouble();
+        result = qIsFinite(d) ? QJsonValue(d) : QJsonValue(QJsonValue::Null);
+        ok = q->next();
+        break;
+    }
+    case QCborStreamReader::Invalid:
+        if (lastError == QCborError::NoError)
+            fail(QCborError::AdvancePastEnd);
+        break;
+    }
+    return ok ? result : QJsonValue(QJsonValue::Undefined);
+}
+
+QVariant QCborStreamReaderPrivate::readVariant(int depth)
+{
+    Q_Q(QCborStreamReader);
+    if (depth > NestingLimit) {
+        fail(QCborError::NestingTooDeep);
+        return QVariant();
+    }
+
+    QVariant result;
+    bool ok = false;
+    switch (current.type) {
+    case QCborStreamReader::UnsignedInteger:
+        if (current.value <= quint64(std::numeric_limits<qint64>::max()))
+            result = qint64(current.value);
+        else
+            result = current.value;
+        ok = q->next();
+        break;
+    case QCborStreamReader::NegativeInteger:
+        if (current.value <= quint64(std::numeric_limits<qint64>::max()))
+            result = -1 - qint64(current.value);
+        else
+            result = -1 - double(current.value);
+        ok = q->next();
+        break;
+    case QCborStreamReader::ByteString: {
+        const QCborStreamReader::StringResult<QByteArray> r = q->readByteArray();
+        ok = (r.status == QCborStreamReader::Ok);
+        result = r.data;
+        break;
+    }
+    case QCborStreamReader::TextString: {
+        const QCborStreamReader::StringResult<QString> r = q->readString();
+        ok = (r.status == QCborStreamReader::Ok);
+        result = r.data;
+        break;
+    }
+    case QCborStreamReader::Array: {
+        QVariantList list;
+        if (!q->enterContainer())
+            break;
+        while (q->hasNext())
+            list.append(readVariant(depth + 1));
+        ok = q->leaveContainer();
+        result = list;
+        break;
+    }
+    case QCborStreamReader::Map: {
+        QVariantMap map;
+        if (!q->enterContainer())
+            break;
+        while (q->hasNext()) {
+            const QString key = readJsonKey(depth + 1);
+            if (!q->hasNext())
+                break;
+            map.insert(key, readVariant(depth + 1));
+        }
+        ok = q->leaveContainer();
+        result = map;
+        break;
+    }
+    case QCborStreamReader::Tag: {
+        const QCborKnownTags tag = QCborKnownTags(current.value);
+        q->next();
+        result = readVariant(depth + 1);
+        switch (tag) {
+        case QCborKnownTags::DateTimeString:
+            if (result.type() == QVariant::String) {
+                const QDateTime dt = QDateTime::fromString(result.toString(), Qt::ISODateWithMs);
+                if (dt.isValid())
+                    result = dt;
+            }
+            break;
+        case QCborKnownTags::UnixTime_t:
+            if (result.type() == QVariant::LongLong || result.type() == QVariant::Double)
+                result = QDateTime::fromMSecsSinceEpoch(qint64(result.toDouble() * 1000), Qt::UTC);
+            break;
+        case QCborKnownTags::Url:
+            if (result.type() == QVariant::String)
+                result = QUrl(result.toString());
+            break;
+        case QCborKnownTags::Uuid:
+            if (result.type() == QVariant::ByteArray && result.toByteArray().size() == 16)
+                result = QUuid::fromRfc4122(result.toByteArray());
+            break;
+#if QT_CONFIG(regularexpression)
+        case QCborKnownTags::RegularExpression:
+            if (result.type() == QVariant::String)
+                result = QRegularExpression(result.toString());
+            break;
+#endif
+        default:
+            break;
+        }
+        return result;
+    }
+    case QCborStreamReader::SimpleType:
+        if (q->isBool())
+            result = q->toBool();
+        else if (q->isNull())
+            result = QVariant::fromValue(nullptr);
+        ok = q->next();
+        break;
+    case QCborStreamReader::Float16:
+    case QCborStreamReader::Float:
+    case QCborStreamReader::Double:
+        result = q->toDouble();
+        ok = q->next();
+        break;
+    case QCborStreamReader::Invalid:
+        if (lastError == QCborError::NoError)
+            fail(QCborError::AdvancePastEnd);
+        break;
+    }
+    return ok ? result : QVariant();
+}
+
+/*!
+    Reads the current item, including the contents of arrays and maps, and
+    converts it to a QJsonValue, following the recommendations of RFC 7049:
+
+    \list
+    \li Integers and floating point numbers become numbers, except for
+        infinities and NaN, which become null.
+    \li Byte strings become strings in base64url encoding, or in the
+        encoding requested by an ExpectedBase64 or ExpectedBase16 tag.
+    \li Map keys that are not text strings are converted to their JSON
+        representation.
+    \li Other tags are ignored, and \c undefined and other simple types
+        become null.
+    \endlist
+
+    Returns an undefined QJsonValue on errors.
+
+    \sa readVariant(), QCborStreamWriter::appendJsonValue()
+*/
+QJsonValue QCborStreamReader::readJsonValue()
+{
+    Q_D(QCborStreamReader);
+    return d->readJson(0, QCborStreamReaderPrivate::Base64url);
+}
+
+/*!
+    Reads the current item, including the contents of arrays and maps, and
+    converts it to a QVariant. Arrays become QVariantList, maps become
+    QVariantMap, and the DateTimeString, UnixTime_t, Url, Uuid and
+    RegularExpression tags produce the corresponding Qt types.
+
+    Returns an invalid QVariant for \c undefined, and on errors.
+
+    \sa readJsonValue(), QCborStreamWriter::appendVariant()
+*/
+QVariant QCborStreamReader::readVariant()
+{
+    Q_D(QCborStreamReader);
+    return d->readVariant(0);
+}
+
+class QCborStreamWriterPrivate
+{
+public:
+    struct Container {
+        quint64 expected;
+        quint64 count;
+        bool isMap;
+    };
+
+    QCborStreamWriterPrivate()
+        : device(nullptr), array(nullptr)
+    {}
+
+    QByteArray &output() { return array ? *array : buffer; }
+    void writeHead(uchar major, quint64 value);
+    void writeByte(uchar byte) { output().append(char(byte)); }
+    void startContainer(uchar major, quint64 count, bool isMap);
+    bool endContainer(bool isMap);
+    void itemDone();
+    void flush();
+
+    QIODevice *device;
+    QByteArray *array;
+    QByteArray buffer;
+    QVarLengthArray<Container, 16> containers;
+};
+
+void QCborStreamWriterPrivate::writeHead(uchar major, quint64 value)
+{
+    uchar head[9];
+    int size;
+    if (value < 24) {
+        head[0] = major | uchar(value);
+        size = 1;
+    } else if (value <= 0xff) {
+        head[0] = major | 24;
+        head[1] = uchar(value);
+        size = 2;
+    } else if (value <= 0xffff) {
+        head[0] = major | 25;
+        qToBigEndian(quint16(value), head + 1);
+        size = 3;
+    } else if (value <= 0xffffffffU) {
+        head[0] = major | 26;
+        qToBigEndian(quint32(value), head + 1);
+        size = 5;
+    } else {
+        head[0] = major | 27;
+        qToBigEndian(value, head + 1);
+        size = 9;
+    }
+    output().append(reinterpret_cast<const char *>(head), size);
+}
+
+void QCborStreamWriterPrivate::startContainer(uchar major, quint64 count, bool isMap)
+{
+    Container c;
+    c.isMap = isMap;
+    c.count = 0;
+    if (count == IndefiniteLength) {
+        writeByte(major | IndefiniteLengthMarker);
+        c.expected = IndefiniteLength;
+    } else {
+        writeHead(major, count);
+        c.expected = isMap ? 2 * count : count;
+    }
+    containers.append(c);
+}
+
+bool QCborStreamWriterPrivate::endContainer(bool isMap)
+{
+    Q_ASSERT(!containers.isEmpty() && containers.last().isMap == isMap);
+    if (containers.isEmpty())
+        return false;
+    Q_UNUSED(isMap);
+    const Container c = containers.last();
+    containers.removeLast();
+    bool ok = true;
+    if (c.expected == IndefiniteLength) {
+        writeByte(BreakByte);
+        ok = !c.isMap || c.count % 2 == 0;
+    } else {
+        ok = (c.count == c.expected);
+    }
+    itemDone();
+    return ok;
+}
+
+void QCborStreamWriterPrivate::itemDone()
+{
+    if (!containers.isEmpty()) {
+        ++containers.last().count;
+        if (buffer.size() >= WriteBufferSize)
+            flush();
+    } else {
+        flush();
+    }
+}
+
+void QCborStreamWriterPrivate::flush()
+{
+    if (device && !buffer.isEmpty()) {
+        device->write(buffer);
+        buffer.clear();
+    }
+}
+
+/*!
+    \class QCborStreamWriter
+    \inmodule QtCore
+    \reentrant
+    \since 5.12
+
+    \brief The QCborStreamWriter class is a simple CBOR encoder operating
+    on a one-way stream.
+
+    QCborStreamWriter writes a CBOR stream, as defined in RFC 7049, to a
+    QByteArray or a QIODevice. Each append() call writes one item; arrays
+    and maps are written with startArray() and startMap(), followed by
+    their items, followed by endArray() or endMap(). The items of a map
+    alternate between keys and values. Arrays and maps can declare the
+    number of items they hold, or have indefinite length.
+
+    \snippet code/src_corelib_serialization_qcborstream.cpp 1
+
+    appendJsonValue() and appendVariant() write a QJsonValue or QVariant,
+    including the contents of arrays, objects, lists and maps.
+
+    When writing to a device, the writer collects each top-level item in a
+    buffer and writes it to the device once it is complete, or whenever the
+    buffer grows too large.
+
+    \sa QCborStreamReader, QJsonStreamWriter
+*/
+
+/*!
+    Constructs a writer that writes to \a device.
+*/
+QCborStreamWriter::QCborStreamWriter(QIODevice *device)
+    : d_ptr(new QCborStreamWriterPrivate)
+{
+    d_ptr->device = device;
+}
+
+/*!
+    Constructs a writer that appends to \a data.
+*/
+QCborStreamWriter::QCborStreamWriter(QByteArray *data)
+    : d_ptr(new QCborStreamWriterPrivate)
+{
+    d_ptr->array = data;
+}
+
+/*!
+    Destroys the writer, writing any buffered data to the device.
+*/
+QCborStreamWriter::~QCborStreamWriter()
+{
+    d_ptr->flush();
+}
+
+/*!
+    Makes the writer write to \a device, after writing any buffered data
+    to the previous one.
+*/
+void QCborStreamWriter::setDevice(QIODevice *device)
+{
+    Q_D(QCborStreamWriter);
+    d->flush();
+    d->device = device;
+    d->array = nullptr;
+}
+
+/*!
+    Returns the device the writer writes to, or \c nullptr if it writes to
+    a QByteArray.
+*/
+QIODevice *QCborStreamWriter::device() const
+{
+    Q_D(const QCborStreamWriter);
+    return d->device;
+}
+
+/*!
+    Appends the unsigned integer \a u.
+*/
+void QCborStreamWriter::append(quint64 u)
+{
+    Q_D(QCborStreamWriter);
+    d->writeHead(QCborStreamReader::UnsignedInteger, u);
+    d->itemDone();
+}
+
+/*!
+    \overload
+
+    Appends the integer \a i, as an UnsignedInteger or NegativeInteger.
+*/
+void QCborStreamWriter::append(qint64 i)
+{
+    Q_D(QCborStreamWriter);
+    if (i < 0)
+        d->writeHead(QCborStreamReader::NegativeInteger, quint64(-1 - i));
+    else
+        d->writeHead(QCborStreamReader::UnsignedInteger, quint64(i));
+    d->itemDone();
+}
+
+/*!
+    \overload
+
+    Appends the negative integer whose absolute value is \a n. The value 0
+    stands for -2\sup{64}.
+*/
+void QCborStreamWriter::append(QCborNegativeInteger n)
+{
+    Q_D(QCborStreamWriter);
+    d->writeHead(QCborStreamReader::NegativeInteger, quint64(n) - 1);
+    d->itemDone();
+}
+
+/*!
+    \fn void QCborStreamWriter::append(const QByteArray &ba)
+    \overload
+
+    Appends \a ba as a byte string.
+*/
+
+/*!
+    \overload
+
+    Appends \a str as a text string.
+*/
+void QCborStreamWriter::append(QLatin1String str)
+{
+    if (QtPrivate::isAscii(str))
+        appendTextString(str.data(), str.size());
+    else
+        append(QStringView(QString(str)));
+}
+
+/*!
+    \overload
+
+    Appends \a str as a text string, in UTF-8.
+*/
+void QCborStreamWriter::append(QStringView str)
+{
+    Q_D(QCborStreamWriter);
+    if (!QtPrivate::isAscii(str)) {
+        const QByteArray utf8 = QUtf8::convertFromUnicode(str.data(), int(str.size()));
+        appendTextString(utf8.constData(), utf8.size());
+        return;
+    }
+
+    d->writeHead(QCborStreamReader::TextString, quint64(str.size()));
+    QByteArray &out = d->output();
+    const int oldSize = out.size();
+    out.resize(oldSize + int(str.size()));
+    char *dst = out.data() + oldSize;
+    const QChar *src = str.data();
+    for (qsizetype i = 0; i < str.size(); ++i)
+        dst[i] = char(src[i].unicode());
+    d->itemDone();
+}
+
+/*!
+    \overload
+
+    Appends \a tag. The next item appended is the one the tag applies to.
+*/
+void QCborStreamWriter::append(QCborTag tag)
+{
+    Q_D(QCborStreamWriter);
+    d->writeHead(QCborStreamReader::Tag, quint64(tag));
+}
+
+/*!
+    \fn void QCborStreamWriter::append(QCborKnownTags tag)
+    \overload
+*/
+
+/*!
+    \overload
+
+    Appends the simple type \a st. The values 24 to 31 are reserved and
+    must not be used.
+*/
+void QCborStreamWriter::append(QCborSimpleType st)
+{
+    Q_D(QCborStreamWriter);
+    const quint8 value = quint8(st);
+    Q_ASSERT(value < 24 || value >= 32);
+    if (value < 24) {
+        d->writeByte(QCborStreamReader::SimpleType | value);
+    } else {
+        d->writeByte(QCborStreamReader::SimpleType | SimpleTypeInNextByte);
+        d->writeByte(value);
+    }
+    d->itemDone();
+}
+
+/*!
+    \fn void QCborStreamWriter::append(std::nullptr_t)
+    \overload
+
+    Appends \c null.
+*/
+
+/*!
+    \overload
+
+    Appends \a f as a half-precision floating point number.
+*/
+void QCborStreamWriter::append(qfloat16 f)
+{
+    Q_D(QCborStreamWriter);
+    quint16 bits;
+    memcpy(&bits, &f, sizeof(bits));
+    uchar data[3] = { QCborStreamReader::Float16 };
+    qToBigEndian(bits, data + 1);
+    d->output().append(reinterpret_cast<const char *>(data), sizeof(data));
+    d->itemDone();
+}
+
+/*!
+    \overload
+
+    Appends \a f as a single-precision floating point number.
+*/
+void QCborStreamWriter::append(float f)
+{
+    Q_D(QCborStreamWriter);
+    quint32 bits;
+    memcpy(&bits, &f, sizeof(bits));
+    uchar data[5] = { QCborStreamReader::Float };
+    qToBigEndian(bits, data + 1);
+    d->output().append(reinterpret_cast<const char *>(data), sizeof(data));
+    d->itemDone();
+}
+
+/*!
+    \overload
+
+    Appends \a d as a double-precision floating point number.
+*/
+void QCborStreamWriter::append(double d)
+{
+    quint64 bits;
+    memcpy(&bits, &d, sizeof(bits));
+    uchar data[9] = { QCborStreamReader::Double };
+    qToBigEndian(bits, data + 1);
+    d_func()->output().append(reinterpret_cast<const char *>(data), sizeof(data));
+    d_func()->itemDone();
+}
+
+/*!
+    Appends the \a len bytes at \a data as a byte string.
+*/
+void QCborStreamWriter::appendByteString(const char *data, qsizetype len)
+{
+    Q_D(QCborStreamWriter);
+    d->writeHead(QCborStreamReader::ByteString, quint64(len));
+    d->output().append(data, int(len));
+    d->itemDone();
+}
+
+/*!
+    Appends the \a len bytes of UTF-8 at \a utf8 as a text string. The
+    data is not checked to be valid UTF-8.
+*/
+void QCborStreamWriter::appendTextString(const char *utf8, qsizetype len)
+{
+    Q_D(QCborStreamWriter);
+    d->writeHead(QCborStreamReader::TextString, quint64(len));
+    d->output().append(utf8, int(len));
+    d->itemDone();
+}
+
+/*!
+    \fn void QCborStreamWriter::append(bool b)
+    \overload
+
+    Appends \a b as \c true or \c false.
+*/
+
+/*!
+    \fn void QCborStreamWriter::appendNull()
+
+    Appends \c null.
+*/
+
+/*!
+    \fn void QCborStreamWriter::appendUndefined()
+
+    Appends \c undefined.
+*/
+
+/*!
+    \fn void QCborStreamWriter::append(int i)
+    \overload
+*/
+
+/*!
+    \fn void QCborStreamWriter::append(uint u)
+    \overload
+*/
+
+/*!
+    \fn void QCborStreamWriter::append(const char *str, qsizetype size)
+    \overload
+
+    Appends the \a size bytes of UTF-8 at \a str as a text string. If \a
+    size is -1, \a str must be null-terminated.
+*/
+
+/*!
+    Starts an array of indefinite length. Append its items and call
+    endArray() afterwards.
+*/
+void QCborStreamWriter::startArray()
+{
+    Q_D(QCborStreamWriter);
+    d->startContainer(QCborStreamReader::Array, IndefiniteLength, false);
+}
+
+/*!
+    \overload
+
+    Starts an array of \a count items. Append exactly \a count items and
+    call endArray() afterwards.
+*/
+void QCborStreamWriter::startArray(quint64 count)
+{
+    Q_D(QCborStreamWriter);
+    d->startContainer(QCborStreamReader::Array, count, false);
+}
+
+/*!
+    Ends the array started last. Returns \c false if the number of items
+    does not match the count passed to startArray().
+*/
+bool QCborStreamWriter::endArray()
+{
+    Q_D(QCborStreamWriter);
+    return d->endContainer(false);
+}
+
+/*!
+    Starts a map of indefinite length. Append its keys and values, and call
+    endMap() afterwards.
+*/
+void QCborStreamWriter::startMap()
+{
+    Q_D(QCborStreamWriter);
+    d->startContainer(QCborStreamReader::Map, IndefiniteLength, true);
+}
+
+/*!
+    \overload
+
+    Starts a map of \a count entries. Append exactly \a count keys and
+    values, and call endMap() afterwards.
+*/
+void QCborStreamWriter::startMap(quint64 count)
+{
+    Q_D(QCborStreamWriter);
+    d->startContainer(QCborStreamReader::Map, count, true);
+}
+
+/*!
+    Ends the map started last. Returns \c false if the number of entries
+    does not match the count passed to startMap(), or a key has no value.
+*/
+bool QCborStreamWriter::endMap()
+{
+    Q_D(QCborStreamWriter);
+    return d->endContainer(true);
+}
+
+/*!
+    Appends \a value, including the contents of arrays and objects. Numbers
+    that are integers are written as integers, and other numbers as
+    doubles.
+
+    \sa appendVariant(), QCborStreamReader::readJsonValue()
+*/
+void QCborStreamWriter::appendJsonValue(const QJsonValue &value)
+{
+    switch (value.type()) {
+    case QJsonValue::Null:
+        appendNull();
+        break;
+    case QJsonValue::Bool:
+        append(value.toBool());
+        break;
+    case QJsonValue::Double: {
+        const double d = value.toDouble();
+        if (d >= -9223372036854775808.0 && d < 9223372036854775808.0 && d == qint64(d)
+                && (d != 0 || !std::signbit(d)))
+            append(qint64(d));
+        else
+            append(d);
+        break;
+    }
+    case QJsonValue::String:
+        append(QStringView(value.toString()));
+        break;
+    case QJsonValue::Array: {
+        const QJsonArray array = value.toArray();
+        startArray(quint64(array.size()));
+        for (const QJsonValue &v : array)
+            appendJsonValue(v);
+        endArray();
+        break;
+    }
+    case QJsonValue::Object: {
+        const QJsonObject object = value.toObject();
+        startMap(quint64(object.size()));
+        for (auto it = object.constBegin(), end = object.constEnd(); it != end; ++it) {
+            append(QStringView(it.key()));
+            appendJsonValue(it.value());
+        }
+        endMap();
+        break;
+    }
+    case QJsonValue::Undefined:
+        appendUndefined();
+        break;
+    }
+}
+
+/*!
+    Appends \a value, including the contents of lists and maps. Types
+    without a CBOR representation are written as strings if QVariant can
+    convert them to QString, and as \c undefined otherwise.
+
+    \sa appendJsonValue(), QCborStreamReader::readVariant()
+*/
+void QCborStreamWriter::appendVariant(const QVariant &value)
+{
+    switch (value.userType()) {
+    case QMetaType::UnknownType:
+        appendUndefined();
+        return;
+    case QMetaType::Nullptr:
+        appendNull();
+        return;
+    case QMetaType::Bool:
+        append(value.toBool());
+        return;
+    case QMetaType::Char:
+    case QMetaType::SChar:
+    case QMetaType::Short:
+    case QMetaType::Int:
+    case QMetaType::Long:
+    case QMetaType::LongLong:
+        append(value.toLongLong());
+        return;
+    case QMetaType::UChar:
+    case QMetaType::UShort:
+    case QMetaType::UInt:
+    case QMetaType::ULong:
+    case QMetaType::ULongLong:
+        append(value.toULongLong());
+        return;
+    case QMetaType::Float:
+        append(value.toFloat());
+        return;
+    case QMetaType::Double:
+        append(value.toDouble());
+        return;
+    case QMetaType::QByteArray:
+        append(value.toByteArray());
+        return;
+    case QMetaType::QString:
+        append(QStringView(value.toString()));
+        return;
+    case QMetaType::QStringList:
+    case QMetaType::QVariantList: {
+        const QVariantList list = value.toList();
+        startArray(quint64(list.size()));
+        for (const QVariant &v : list)
+            appendVariant(v);
+        endArray();
+        return;
+    }
+    case QMetaType::QVariantMap: {
+        const QVariantMap map = value.toMap();
+        startMap(quint64(map.size()));
+        for (auto it = map.constBegin(), end = map.constEnd(); it != end; ++it) {
+            append(QStringView(it.key()));
+            appendVariant(it.value());
+        }
+        endMap();
+        return;
+    }
+    case QMetaType::QVariantHash: {
+        const QVariantHash hash = value.toHash();
+        startMap(quint64(hash.size()));
+        for (auto it = hash.constBegin(), end = hash.constEnd(); it != end; ++it) {
+            append(QStringView(it.key()));
+            appendVariant(it.value());
+        }
+        endMap();
+        return;
+    }
+    case QMetaType::QDateTime:
+        append(QCborKnownTags::DateTimeString);
+        append(QStringView(value.toDateTime().toString(Qt::ISODateWithMs)));
+        return;
+    case QMetaType::QUrl:
+        append(QCborKnownTags::Url);
+        append(QStringView(value.toUrl().toString(QUrl::FullyEncoded)));
+        return;
+    case QMetaType::QUuid:
+        append(QCborKnownTags::Uuid);
+        append(value.toUuid().toRfc4122());
+        return;
+#if QT_CONFIG(regularexpression)
+    case QMetaType::QRegularExpression:
+        append(QCborKnownTags::RegularExpression);
+        append(QStringView(value.toRegularExpression().pattern()));
+        return;
+#endif
+    case QMetaType::QJsonValue:
+        appendJsonValue(value.value<QJsonValue>());
+        return;
+    case QMetaType::QJsonObject:
+        appendJsonValue(value.value<QJsonObject>());
+        return;
+    case QMetaType::QJsonArray:
+        appendJsonValue(value.value<QJsonArray>());
+        return;
+    case QMetaType::QJsonDocument: {
+        const QJsonDocument doc = value.value<QJsonDocument>();
+        if (doc.isArray())
+            appendJsonValue(doc.array());
+        else if (doc.isObject())
+            appendJsonValue(doc.object());
+        else
+            appendNull();
+        return;
+    }
+    default:
+        break;
+    }
+
+    if (value.canConvert<QString>())
+        append(QStringView(value.toString()));
+    else
+        appendUndefined();
+}
+
+QT_END_NAMESPACE
@@ -48,6 +48,7 @@
 #include <ctype.h>
 #include <stdlib.h>
 #include "qendian.h"
+#include <private/qsimd_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -1395,6 +1396,114 @@ int QDataStream::skipRawData(int len)
     return skipResult;
 }
 
+/*****************************************************************************
+  Bulk (de)serialization of arrays of numbers
+ *****************************************************************************/
+
+#if QT_COMPILER_SUPPORTS_HERE(SSSE3)
+QT_FUNCTION_TARGET(SSSE3)
+static qsizetype swapBytesSsse3(const uchar *src, uchar *dst, qsizetype len, int size)
+{
+    const __m128i shuffle = size == 2 ? _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14)
+                          : size == 4 ? _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12)
+                          : _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    qsizetype i = 0;
+    for ( ; i + 16 <= len; i += 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_shuffle_epi8(data, shuffle));
+    }
+    return i;
+}
+#endif
+
+// Copies \a count numbers of \a size bytes from \a src to \a dst, reversing
+// the byte order of each; \a src and \a dst may be the same
+static void swapBytes(const uchar *src, uchar *dst, qsizetype count, int size)
+{
+    const qsizetype len = count * size;
+    qsizetype i = 0;
+#if QT_COMPILER_SUPPORTS_HERE(SSSE3)
+    if (qCpuHasFeature(SSSE3))
+        i = swapBytesSsse3(src, dst, len, size);
+#endif
+
+    for ( ; i < len; i += size) {
+        switch (size) {
+        case 2:
+            qToUnaligned(qbswap(qFromUnaligned<quint16>(src + i)), dst + i);
+            break;
+        case 4:
+            qToUnaligned(qbswap(qFromUnaligned<quint32>(src + i)), dst + i);
+            break;
+        case 8:
+            qToUnaligned(qbswap(qFromUnaligned<quint64>(src + i)), dst + i);
+            break;
+        }
+    }
+}
+
+namespace QtPrivate {
+
+/*!
+    \internal
+
+    Writes the \a count numbers of \a size bytes each at \a data to the
+    stream \a s, producing the same bytes as writing them one at a time but
+    with as few device writes as possible.
+*/
+void writeArrayData(QDataStream &s, const void *data, qsizetype count, int size)
+{
+    const uchar *src = static_cast<const uchar *>(data);
+    if (size == 1 || s.byteOrder() == QDataStream::ByteOrder(QSysInfo::ByteOrder)) {
+        qsizetype len = count * size;
+        while (len > 0) {
+            const int chunk = int(qMin<qsizetype>(len, 1 << 30));
+            if (s.writeRawData(reinterpret_cast<const char *>(src), chunk) != chunk)
+                return;
+            src += chunk;
+            len -= chunk;
+        }
+        return;
+    }
+
+    // swap through a buffer that comfortably fits in the L1 cache
+    uchar buffer[8192];
+    const qsizetype step = sizeof(buffer) / size;
+    while (count > 0) {
+        const qsizetype n = qMin(count, step);
+        swapBytes(src, buffer, n, size);
+        if (s.writeRawData(reinterpret_cast<const char *>(buffer), int(n * size)) != n * size)
+            return;
+        src += n * size;
+        count -= n;
+    }
+}
+
+/*!
+    \internal
+
+    Reads \a count numbers of \a size bytes each from the stream \a s into
+    \a data, which must have room for them. Returns \c false if the stream
+    ended before all of them could be read.
+*/
+bool readArrayData(QDataStream &s, void *data, qsizetype count, int size)
+{
+    uchar *dst = static_cast<uchar *>(data);
+    const qsizetype len = count * size;
+    for (qsizetype i = 0; i < len; ) {
+        const int chunk = int(qMin<qsizetype>(len - i, 1 << 30));
+        if (s.readRawData(reinterpret_cast<char *>(dst + i), chunk) != chunk)
+            return false;
+        i += chunk;
+    }
+
+    if (size != 1 && s.byteOrder() != QDataStream::ByteOrder(QSysInfo::ByteOrder))
+        swapBytes(dst, dst, count, size);
+    return true;
+}
+
+} // namespace QtPrivate
+
 QT_END_NAMESPACE
 
 #endif // QT_NO_DATASTREAM
@@ -44,6 +44,8 @@
 #include <QtCore/qiodevice.h>
 #include <QtCore/qpair.h>
 
+#include <limits>
+
 #ifdef Status
 #error qdatastream.h must be included before any header file that defines Status
 #endif
@@ -304,6 +306,90 @@ QDataStream &writeSequentialContainer(QDataStream &s, const Container &c)
     return s;
 }
 
+// Arrays of these types are stored as their bytes in the stream's byte
+// order, so whole arrays can be written and read at once
+template <typename T> struct IsStreamedAsBytes : std::false_type {};
+template <> struct IsStreamedAsBytes<qint8> : std::true_type {};
+template <> struct IsStreamedAsBytes<quint8> : std::true_type {};
+template <> struct IsStreamedAsBytes<qint16> : std::true_type {};
+template <> struct IsStreamedAsBytes<quint16> : std::true_type {};
+template <> struct IsStreamedAsBytes<qint32> : std::true_type {};
+template <> struct IsStreamedAsBytes<quint32> : std::true_type {};
+template <> struct IsStreamedAsBytes<qint64> : std::true_type {};
+template <> struct IsStreamedAsBytes<quint64> : std::true_type {};
+template <> struct IsStreamedAsBytes<float> : std::true_type {};
+template <> struct IsStreamedAsBytes<double> : std::true_type {};
+
+// ... unless the stream's settings ask for a different representation
+template <typename T> inline bool isStreamedAsBytes(const QDataStream &) { return true; }
+template <> inline bool isStreamedAsBytes<qint64>(const QDataStream &s)
+{ return s.version() >= QDataStream::Qt_3_3; }
+template <> inline bool isStreamedAsBytes<quint64>(const QDataStream &s)
+{ return s.version() >= QDataStream::Qt_3_3; }
+template <> inline bool isStreamedAsBytes<float>(const QDataStream &s)
+{ return s.version() < QDataStream::Qt_4_6 || s.floatingPointPrecision() == QDataStream::SinglePrecision; }
+template <> inline bool isStreamedAsBytes<double>(const QDataStream &s)
+{ return s.version() < QDataStream::Qt_4_6 || s.floatingPointPrecision() == QDataStream::DoublePrecision; }
+
+Q_CORE_EXPORT void writeArrayData(QDataStream &s, const void *data, qsizetype count, int size);
+Q_CORE_EXPORT bool readArrayData(QDataStream &s, void *data, qsizetype count, int size);
+
+template <typename Container>
+QDataStream &readArrayBasedContainer(QDataStream &s, Container &c, std::false_type)
+{
+    return readArrayBasedContainer(s, c);
+}
+
+template <typename Container>
+QDataStream &readArrayBasedContainer(QDataStream &s, Container &c, std::true_type)
+{
+    typedef typename Container::value_type T;
+    if (!isStreamedAsBytes<T>(s))
+        return readArrayBasedContainer(s, c);
+
+    StreamStateSaver stateSaver(&s);
+
+    c.clear();
+    quint32 n;
+    s >> n;
+    if (n > quint32(std::numeric_limits<int>::max())) {
+        s.setStatus(QDataStream::ReadCorruptData);
+        return s;
+    }
+    // grow the container as the data arrives, rather than trusting n up front
+    const quint32 step = (1024 * 1024) / sizeof(T);
+    for (quint32 i = 0; i < n; ) {
+        const quint32 count = qMin(n - i, step);
+        c.resize(int(i + count));
+        if (!readArrayData(s, c.data() + i, count, sizeof(T))) {
+            c.clear();
+            break;
+        }
+        i += count;
+    }
+
+    return s;
+}
+
+template <typename Container>
+QDataStream &writeArrayBasedContainer(QDataStream &s, const Container &c, std::false_type)
+{
+    return writeSequentialContainer(s, c);
+}
+
+template <typename Container>
+QDataStream &writeArrayBasedContainer(QDataStream &s, const Container &c, std::true_type)
+{
+    typedef typename Container::value_type T;
+    if (!isStreamedAsBytes<T>(s))
+        return writeSequentialContainer(s, c);
+
+    s << quint32(c.size());
+    writeArrayData(s, c.constData(), c.size(), sizeof(T));
+
+    return s;
+}
+
 template <typename Container>
 QDataStream &writeAssociativeContainer(QDataStream &s, const Container &c)
 {
@@ -398,13 +484,13 @@ inline QDataStream &operator<<(QDataStream &s, const QLinkedList<T> &l)
 template<typename T>
 inline QDataStream &operator>>(QDataStream &s, QVector<T> &v)
 {
-    return QtPrivate::readArrayBasedContainer(s, v);
+    return QtPrivate::readArrayBasedContainer(s, v, QtPrivate::IsStreamedAsBytes<T>());
 }
 
 template<typename T>
 inline QDataStream &operator<<(QDataStream &s, const QVector<T> &v)
 {
-    return QtPrivate::writeSequentialContainer(s, v);
+    return QtPrivate::writeArrayBasedContainer(s, v, QtPrivate::IsStreamedAsBytes<T>());
 }
 
 template <typename T>
@@ -39,6 +39,9 @@
 
 #include "qjson_p.h"
 #include <qalgorithms.h>
+#include <qfile.h>
+#include <qmutex.h>
+#include <qset.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -48,6 +51,21 @@ namespace QJsonPrivate
 static Q_CONSTEXPR Base emptyArray  = { { qle_uint(sizeof(Base)) }, { 0 }, { qle_uint(0) } };
 static Q_CONSTEXPR Base emptyObject = { { qle_uint(sizeof(Base)) }, { 0 }, { qle_uint(0) } };
 
+// the offsets of the arrays and objects that have been validated so far
+struct LazyValidation
+{
+    QBasicMutex mutex;
+    QSet<uint> validated;
+};
+
+Data::~Data()
+{
+    if (ownsData)
+        free(rawData);
+    delete lazyValidation;
+    delete mappedFile;
+}
+
 void Data::compact()
 {
     Q_ASSERT(sizeof(Value) == sizeof(offset));
@@ -120,10 +138,14 @@ void Data::compact()
     header = h;
     this->alloc = alloc;
     compactionCounter = 0;
+    if (lazyValidation)
+        lazyValidation->validated.clear();
 }
 
-bool Data::valid() const
+bool Data::valid(bool recursive) const
 {
+    if (alloc < int(sizeof(Header) + sizeof(Base)))
+        return false;
     if (header->tag != QJsonDocument::BinaryFormatTag || header->version != 1u)
         return false;
 
@@ -131,13 +153,55 @@ bool Data::valid() const
     Base *root = header->root();
     int maxSize = alloc - sizeof(Header);
     if (root->is_object)
-        res = static_cast<Object *>(root)->isValid(maxSize);
+        res = static_cast<Object *>(root)->isValid(maxSize, recursive);
     else
-        res = static_cast<Array *>(root)->isValid(maxSize);
+        res = static_cast<Array *>(root)->isValid(maxSize, recursive);
 
     return res;
 }
 
+/*
+    Makes the document check each array and object the first time it is
+    accessed, instead of all of them up front. The root is checked by the
+    caller.
+ */
+void Data::setValidateLazily()
+{
+    if (!lazyValidation)
+        lazyValidation = new LazyValidation;
+}
+
+/*
+    Checks the array or object \a b, but not the arrays and objects nested
+    in it. Its parent has already made sure that it lies within the parent.
+    Like the full validation, this goes by the type recorded in the parent
+    (\a isObject), not by the flag in the container itself.
+ */
+bool Data::validateContainerLazily(const Base *b, bool isObject) const
+{
+    const uint key = (offsetOf(b) << 1) | uint(isObject);
+    QMutexLocker locker(&lazyValidation->mutex);
+    if (lazyValidation->validated.contains(key))
+        return true;
+    const bool ok = isObject ? static_cast<const Object *>(b)->isValid(b->size, false)
+                             : static_cast<const Array *>(b)->isValid(b->size, false);
+    if (ok)
+        lazyValidation->validated.insert(key);
+    return ok;
+}
+
+/*
+    Checks the array or object \a b with all its contents, for code that
+    walks the binary data directly. Only documents validated lazily need it.
+ */
+bool Data::validateTree(const Base *b, bool isObject) const
+{
+    if (!lazyValidation)
+        return true;
+    return isObject ? static_cast<const Object *>(b)->isValid(b->size)
+                    : static_cast<const Array *>(b)->isValid(b->size);
+}
+
 
 int Base::reserveSpace(uint dataSize, int posInTable, uint numItems, bool replace)
 {
@@ -218,12 +282,12 @@ int Object::indexOf(QLatin1String key, bool *exists) const
     return min;
 }
 
-bool Object::isValid(int maxSize) const
+bool Object::isValid(int maxSize, bool recursive) const
 {
-    if (size > (uint)maxSize || tableOffset + length*sizeof(offset) > size)
+    if (size > (uint)maxSize || size < sizeof(Base) || tableOffset + length*sizeof(offset) > size)
         return false;
 
-    QString lastKey;
+    const Entry *last = nullptr;
     for (uint i = 0; i < length; ++i) {
         offset entryOffset = table()[i];
         if (entryOffset + sizeof(Entry) >= tableOffset)
@@ -231,25 +295,25 @@ bool Object::isValid(int maxSize) const
         Entry *e = entryAt(i);
         if (!e->isValid(tableOffset - table()[i]))
             return false;
-        QString key = e->key();
-        if (key < lastKey)
+        // compare the keys in place, the way lookups do
+        if (last && !(*e >= *last))
             return false;
-        if (!e->value.isValid(this))
+        if (!e->value.isValid(this, recursive))
             return false;
-        lastKey = key;
+        last = e;
     }
     return true;
 }
 
 
 
-bool Array::isValid(int maxSize) const
+bool Array::isValid(int maxSize, bool recursive) const
 {
-    if (size > (uint)maxSize || tableOffset + length*sizeof(offset) > size)
+    if (size > (uint)maxSize || size < sizeof(Base) || tableOffset + length*sizeof(offset) > size)
         return false;
 
     for (uint i = 0; i < length; ++i) {
-        if (!at(i).isValid(this))
+        if (!at(i).isValid(this, recursive))
             return false;
     }
     return true;
@@ -326,7 +390,7 @@ int Value::usedStorage(const Base *b) const
     return alignedSize(s);
 }
 
-bool Value::isValid(const Base *b) const
+bool Value::isValid(const Base *b, bool recursive) const
 {
     int offset = 0;
     switch (type) {
@@ -338,6 +402,10 @@ bool Value::isValid(const Base *b) const
     case QJsonValue::Array:
     case QJsonValue::Object:
         offset = value;
+        // the data follows the header; an array or object at offset 0
+        // would contain itself
+        if (offset < int(sizeof(Base)))
+            return false;
         break;
     case QJsonValue::Null:
     case QJsonValue::Bool:
@@ -355,6 +423,8 @@ bool Value::isValid(const Base *b) const
         return true;
     if (s < 0 || s > (int)b->tableOffset - offset)
         return false;
+    if (!recursive)
+        return true;
     if (type == QJsonValue::Array)
         return static_cast<Array *>(base(b))->isValid(s);
     if (type == QJsonValue::Object)
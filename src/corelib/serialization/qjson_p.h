@@ -69,6 +69,8 @@
 
 QT_BEGIN_NAMESPACE
 
+class QFile;
+
 /*
   This defines a binary data structure for Json data. The data structure is optimised for fast reading
   and minimum allocations. The whole data structure can be mmap'ed and used directly.
@@ -490,7 +492,7 @@ public:
     int indexOf(const QString &key, bool *exists) const;
     int indexOf(QLatin1String key, bool *exists) const;
 
-    bool isValid(int maxSize) const;
+    bool isValid(int maxSize, bool recursive = true) const;
 };
 
 
@@ -500,7 +502,7 @@ public:
     inline Value at(int i) const;
     inline Value &operator [](int i);
 
-    bool isValid(int maxSize) const;
+    bool isValid(int maxSize, bool recursive = true) const;
 };
 
 
@@ -529,7 +531,7 @@ public:
     Latin1String asLatin1String(const Base *b) const;
     Base *base(const Base *b) const;
 
-    bool isValid(const Base *b) const;
+    bool isValid(const Base *b, bool recursive = true) const;
 
     static int requiredStorage(QJsonValue &v, bool *compressed);
     static uint valueToStore(const QJsonValue &v, uint offset);
@@ -682,6 +684,8 @@ inline Base *Value::base(const Base *b) const
     return reinterpret_cast<Base *>(data(b));
 }
 
+struct LazyValidation;
+
 class Data {
 public:
     enum Validation {
@@ -698,13 +702,19 @@ public:
     };
     uint compactionCounter : 31;
     uint ownsData : 1;
+    // set for documents created with QJsonDocument::ValidateLazily
+    LazyValidation *lazyValidation;
+    // keeps the mapping of QJsonDocument::fromBinaryFile() alive
+    QFile *mappedFile;
 
     inline Data(char *raw, int a)
-        : alloc(a), rawData(raw), compactionCounter(0), ownsData(true)
+        : alloc(a), rawData(raw), compactionCounter(0), ownsData(true),
+          lazyValidation(nullptr), mappedFile(nullptr)
     {
     }
     inline Data(int reserved, QJsonValue::Type valueType)
-        : rawData(0), compactionCounter(0), ownsData(true)
+        : rawData(0), compactionCounter(0), ownsData(true),
+          lazyValidation(nullptr), mappedFile(nullptr)
     {
         Q_ASSERT(valueType == QJsonValue::Array || valueType == QJsonValue::Object);
 
@@ -719,8 +729,7 @@ public:
         b->tableOffset = sizeof(Base);
         b->length = 0;
     }
-    inline ~Data()
-    { if (ownsData) free(rawData); }
+    ~Data();
 
     uint offsetOf(const void *ptr) const { return (uint)(((char *)ptr - rawData)); }
 
@@ -737,7 +746,7 @@ public:
     Data *clone(Base *b, int reserve = 0)
     {
         int size = sizeof(Header) + b->size;
-        if (b == header->root() && ref.load() == 1 && alloc >= size + reserve)
+        if (b == header->root() && ref.load() == 1 && ownsData && alloc >= size + reserve)
             return this;
 
         if (reserve) {
@@ -757,11 +766,19 @@ public:
         h->version = 1;
         Data *d = new Data(raw, size);
         d->compactionCounter = (b == header->root()) ? compactionCounter : 0;
+        if (lazyValidation)
+            d->setValidateLazily();
         return d;
     }
 
     void compact();
-    bool valid() const;
+    bool valid(bool recursive = true) const;
+
+    void setValidateLazily();
+    bool validateContainer(const Base *b, bool isObject) const
+    { return !lazyValidation || validateContainerLazily(b, isObject); }
+    bool validateContainerLazily(const Base *b, bool isObject) const;
+    bool validateTree(const Base *b, bool isObject) const;
 
 private:
     Q_DISABLE_COPY(Data)
@@ -1209,7 +1209,7 @@ bool QJsonArray::detach2(uint reserve)
         d->ref.ref();
         return true;
     }
-    if (reserve == 0 && d->ref.load() == 1)
+    if (reserve == 0 && d->ref.load() == 1 && d->ownsData)
         return true;
 
     QJsonPrivate::Data *x = d->clone(a, reserve);
@@ -1241,7 +1241,7 @@ void QJsonArray::compact()
 QDebug operator<<(QDebug dbg, const QJsonArray &a)
 {
     QDebugStateSaver saver(dbg);
-    if (!a.a) {
+    if (!a.a || !a.d->validateTree(a.a, false)) {
         dbg << "QJsonArray()";
         return dbg;
     }
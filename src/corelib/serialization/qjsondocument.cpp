@@ -38,6 +38,7 @@
 ****************************************************************************/
 
 #include <qjsondocument.h>
+#include <qfile.h>
 #include <qjsonobject.h>
 #include <qjsonvalue.h>
 #include <qjsonarray.h>
@@ -184,8 +185,26 @@ QJsonDocument &QJsonDocument::operator =(const QJsonDocument &other)
   \value BypassValidation Bypasses data validation. Only use if you received the
   data from a trusted place and know it's valid, as using of invalid data can crash
   the application.
+  \value ValidateLazily Validate each array and object the first time it is
+  accessed, instead of the whole document up front. Invalid arrays and objects
+  read as undefined values, and toJson() returns an empty string if any part of
+  the document is invalid. This value was introduced in Qt 5.12.
   */
 
+static bool validate(QJsonPrivate::Data *d, QJsonDocument::DataValidation validation)
+{
+    switch (validation) {
+    case QJsonDocument::Validate:
+        return d->valid();
+    case QJsonDocument::BypassValidation:
+        return true;
+    case QJsonDocument::ValidateLazily:
+        d->setValidateLazily();
+        return d->valid(false);
+    }
+    return false;
+}
+
 /*!
  Creates a QJsonDocument that uses the first \a size bytes from
  \a data. It assumes \a data contains a binary encoded JSON document.
@@ -213,7 +232,7 @@ QJsonDocument QJsonDocument::fromRawData(const char *data, int size, DataValidat
     QJsonPrivate::Data *d = new QJsonPrivate::Data((char *)data, size);
     d->ownsData = false;
 
-    if (validation != BypassValidation && !d->valid()) {
+    if (!validate(d, validation)) {
         delete d;
         return QJsonDocument();
     }
@@ -270,7 +289,58 @@ QJsonDocument QJsonDocument::fromBinaryData(const QByteArray &data, DataValidati
     memcpy(raw, data.constData(), size);
     QJsonPrivate::Data *d = new QJsonPrivate::Data(raw, size);
 
-    if (validation != BypassValidation && !d->valid()) {
+    if (!validate(d, validation)) {
+        delete d;
+        return QJsonDocument();
+    }
+
+    return QJsonDocument(d);
+}
+
+/*!
+ \since 5.12
+
+ Creates a QJsonDocument from the binary data in the file \a fileName, as
+ written from rawData() or toBinaryData().
+
+ The file is mapped into memory instead of being read, so only the pages
+ that are accessed are loaded, and processes that open the same file share
+ them. The document keeps the file open and mapped as long as any
+ QJsonDocument, QJsonObject or QJsonArray still references it. Modifying the
+ document creates a copy of the data. If the file cannot be mapped, it is
+ read into memory.
+
+ \a validation decides whether the data is checked for validity before being used.
+ With ValidateLazily, loading the document takes the same time regardless of
+ the size of the file; with BypassValidation, the file has to come from a
+ trusted place, and must not be modified while it is in use. Writing files
+ with QSaveFile makes sure that they are never seen incomplete. If the file
+ cannot be opened or is not valid, the method returns a null document.
+
+ \sa fromRawData(), rawData(), isNull(), DataValidation
+ */
+QJsonDocument QJsonDocument::fromBinaryFile(const QString &fileName, DataValidation validation)
+{
+    QScopedPointer<QFile> file(new QFile(fileName));
+    if (!file->open(QIODevice::ReadOnly))
+        return QJsonDocument();
+
+    const qint64 size = file->size();
+    if (size < qint64(sizeof(QJsonPrivate::Header) + sizeof(QJsonPrivate::Base))
+            || size > std::numeric_limits<int>::max()) {
+        return QJsonDocument();
+    }
+
+    // mappings are page aligned, which satisfies the alignment requirement
+    char *data = reinterpret_cast<char *>(file->map(0, size));
+    if (!data)
+        return fromBinaryData(file->readAll(), validation);
+
+    QJsonPrivate::Data *d = new QJsonPrivate::Data(data, int(size));
+    d->ownsData = false;
+    d->mappedFile = file.take();
+
+    if (!validate(d, validation)) {
         delete d;
         return QJsonDocument();
     }
@@ -373,7 +443,7 @@ QByteArray QJsonDocument::toJson() const
 QByteArray QJsonDocument::toJson(JsonFormat format) const
 {
     QByteArray json;
-    if (!d)
+    if (!d || !d->validateTree(d->header->root(), d->header->root()->isObject()))
         return json;
 
     if (d->header->root()->isArray())
@@ -648,7 +718,7 @@ bool QJsonDocument::isNull() const
 QDebug operator<<(QDebug dbg, const QJsonDocument &o)
 {
     QDebugStateSaver saver(dbg);
-    if (!o.d) {
+    if (!o.d || !o.d->validateTree(o.d->header->root(), o.d->header->root()->isObject())) {
         dbg << "QJsonDocument()";
         return dbg;
     }
@@ -45,6 +45,7 @@
 QT_BEGIN_NAMESPACE
 
 class QDebug;
+class QCborStreamReaderPrivate;
 
 namespace QJsonPrivate {
     class Parser;
@@ -112,7 +113,8 @@ public:
 
     enum DataValidation {
         Validate,
-        BypassValidation
+        BypassValidation,
+        ValidateLazily
     };
 
     static QJsonDocument fromRawData(const char *data, int size, DataValidation validation = Validate);
@@ -121,6 +123,8 @@ public:
     static QJsonDocument fromBinaryData(const QByteArray &data, DataValidation validation  = Validate);
     QByteArray toBinaryData() const;
 
+    static QJsonDocument fromBinaryFile(const QString &fileName, DataValidation validation = Validate);
+
     static QJsonDocument fromVariant(const QVariant &variant);
     QVariant toVariant() const;
 
@@ -159,6 +163,7 @@ private:
     friend class QJsonValue;
     friend class QJsonPrivate::Data;
     friend class QJsonPrivate::Parser;
+    friend class QCborStreamReaderPrivate;
     friend Q_CORE_EXPORT QDebug operator<<(QDebug, const QJsonDocument &);
 
     QJsonDocument(QJsonPrivate::Data *data);
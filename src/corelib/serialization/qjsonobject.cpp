@@ -1231,7 +1231,7 @@ bool QJsonObject::detach2(uint reserve)
         d->ref.ref();
         return true;
     }
-    if (reserve == 0 && d->ref.load() == 1)
+    if (reserve == 0 && d->ref.load() == 1 && d->ownsData)
         return true;
 
     QJsonPrivate::Data *x = d->clone(o, reserve);
@@ -1296,7 +1296,7 @@ void QJsonObject::setValueAt(int i, const QJsonValue &val)
 QDebug operator<<(QDebug dbg, const QJsonObject &o)
 {
     QDebugStateSaver saver(dbg);
-    if (!o.o) {
+    if (!o.o || !o.d->validateTree(o.o, true)) {
         dbg << "QJsonObject()";
         return dbg;
     }
@@ -45,6 +45,8 @@
 #include "qjsonparser_p.h"
 #include "qjson_p.h"
 #include "private/qutfcodec_p.h"
+#include "private/qsimd_p.h"
+#include "private/qlocale_tools_p.h"
 
 //#define PARSER_DEBUG
 #ifdef PARSER_DEBUG
@@ -195,6 +197,193 @@ QString QJsonParseError::errorString() const
 #endif
 }
 
+void qt_from_latin1(ushort *dst, const char *str, size_t size) Q_DECL_NOTHROW;
+
+namespace QJsonPrivate {
+
+/*
+    Vectorized scanners for the two loops the parser spends most of its time
+    in: skipping insignificant whitespace and skipping over the plain ASCII
+    part of strings. Each kernel handles 16 or 32 bytes per iteration and
+    leaves the remainder to the scalar tail.
+*/
+static inline bool isJsonWhitespace(uchar c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static const char *findStringSpecialTail(const char *json, const char *end)
+{
+    for ( ; json < end; ++json) {
+        const uchar c = *json;
+        if (c == '"' || c == '\\' || c >= 0x80)
+            break;
+    }
+    return json;
+}
+
+static const char *skipWhitespaceTail(const char *json, const char *end)
+{
+    while (json < end && isJsonWhitespace(*json))
+        ++json;
+    return json;
+}
+
+#if defined(__SSE2__)
+static const char *findStringSpecialSse2(const char *json, const char *end)
+{
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    for ( ; end - json >= 16; json += 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(json));
+        const __m128i special = _mm_or_si128(_mm_cmpeq_epi8(data, quote),
+                                             _mm_cmpeq_epi8(data, backslash));
+        // non-ASCII bytes already have their sign bit set
+        const uint mask = _mm_movemask_epi8(_mm_or_si128(special, data));
+        if (mask)
+            return json + qCountTrailingZeroBits(mask);
+    }
+    return findStringSpecialTail(json, end);
+}
+
+static const char *skipWhitespaceSse2(const char *json, const char *end)
+{
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i lineFeed = _mm_set1_epi8('\n');
+    const __m128i carriageReturn = _mm_set1_epi8('\r');
+    for ( ; end - json >= 16; json += 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(json));
+        const __m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(data, space),
+                                                     _mm_cmpeq_epi8(data, tab)),
+                                        _mm_or_si128(_mm_cmpeq_epi8(data, lineFeed),
+                                                     _mm_cmpeq_epi8(data, carriageReturn)));
+        const uint mask = ~uint(_mm_movemask_epi8(ws)) & 0xffffu;
+        if (mask)
+            return json + qCountTrailingZeroBits(mask);
+    }
+    return skipWhitespaceTail(json, end);
+}
+#endif
+
+#if QT_COMPILER_SUPPORTS_HERE(AVX2)
+QT_FUNCTION_TARGET(AVX2)
+static const char *findStringSpecialAvx2(const char *json, const char *end)
+{
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    for ( ; end - json >= 32; json += 32) {
+        const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(json));
+        const __m256i special = _mm256_or_si256(_mm256_cmpeq_epi8(data, quote),
+                                                _mm256_cmpeq_epi8(data, backslash));
+        const uint mask = _mm256_movemask_epi8(_mm256_or_si256(special, data));
+        if (mask)
+            return json + qCountTrailingZeroBits(mask);
+    }
+    return findStringSpecialSse2(json, end);
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static const char *skipWhitespaceAvx2(const char *json, const char *end)
+{
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i lineFeed = _mm256_set1_epi8('\n');
+    const __m256i carriageReturn = _mm256_set1_epi8('\r');
+    for ( ; end - json >= 32; json += 32) {
+        const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(json));
+        const __m256i ws = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(data, space),
+                                                           _mm256_cmpeq_epi8(data, tab)),
+                                           _mm256_or_si256(_mm256_cmpeq_epi8(data, lineFeed),
+                                                           _mm256_cmpeq_epi8(data, carriageReturn)));
+        const uint mask = ~uint(_mm256_movemask_epi8(ws));
+        if (mask)
+            return json + qCountTrailingZeroBits(mask);
+    }
+    return skipWhitespaceSse2(json, end);
+}
+#endif
+
+#if defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64) // vaddv is only available on Aarch64
+static inline uint neonMovemask(uint8x16_t v)
+{
+    const uint8x8_t vmask = { 1, 1 << 1, 1 << 2, 1 << 3, 1 << 4, 1 << 5, 1 << 6, 1 << 7 };
+    return vaddv_u8(vand_u8(vget_low_u8(v), vmask))
+            | (uint(vaddv_u8(vand_u8(vget_high_u8(v), vmask))) << 8);
+}
+
+static const char *findStringSpecialNeon(const char *json, const char *end)
+{
+    const uint8x16_t quote = vdupq_n_u8('"');
+    const uint8x16_t backslash = vdupq_n_u8('\\');
+    const uint8x16_t nonAscii = vdupq_n_u8(0x80);
+    for ( ; end - json >= 16; json += 16) {
+        const uint8x16_t data = vld1q_u8(reinterpret_cast<const uchar *>(json));
+        const uint mask = neonMovemask(vorrq_u8(vorrq_u8(vceqq_u8(data, quote),
+                                                         vceqq_u8(data, backslash)),
+                                                vcgeq_u8(data, nonAscii)));
+        if (mask)
+            return json + qCountTrailingZeroBits(mask);
+    }
+    return findStringSpecialTail(json, end);
+}
+
+static const char *skipWhitespaceNeon(const char *json, const char *end)
+{
+    const uint8x16_t space = vdupq_n_u8(' ');
+    const uint8x16_t tab = vdupq_n_u8('\t');
+    const uint8x16_t lineFeed = vdupq_n_u8('\n');
+    const uint8x16_t carriageReturn = vdupq_n_u8('\r');
+    for ( ; end - json >= 16; json += 16) {
+        const uint8x16_t data = vld1q_u8(reinterpret_cast<const uchar *>(json));
+        const uint8x16_t ws = vorrq_u8(vorrq_u8(vceqq_u8(data, space), vceqq_u8(data, tab)),
+                                       vorrq_u8(vceqq_u8(data, lineFeed),
+                                                vceqq_u8(data, carriageReturn)));
+        const uint mask = neonMovemask(vmvnq_u8(ws));
+        if (mask)
+            return json + qCountTrailingZeroBits(mask);
+    }
+    return skipWhitespaceTail(json, end);
+}
+#endif
+
+const char *findStringSpecial(const char *json, const char *end)
+{
+#if QT_COMPILER_SUPPORTS_HERE(AVX2)
+    if (qCpuHasFeature(AVX2))
+        return findStringSpecialAvx2(json, end);
+#endif
+#if defined(__SSE2__)
+    return findStringSpecialSse2(json, end);
+#elif defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64)
+    return findStringSpecialNeon(json, end);
+#else
+    return findStringSpecialTail(json, end);
+#endif
+}
+
+const char *skipWhitespace(const char *json, const char *end)
+{
+    // most runs of whitespace are a single space or a line break followed
+    // by indentation, so check the first byte before going wide
+    if (json >= end || !isJsonWhitespace(*json))
+        return json;
+    ++json;
+#if QT_COMPILER_SUPPORTS_HERE(AVX2)
+    if (qCpuHasFeature(AVX2))
+        return skipWhitespaceAvx2(json, end);
+#endif
+#if defined(__SSE2__)
+    return skipWhitespaceSse2(json, end);
+#elif defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64)
+    return skipWhitespaceNeon(json, end);
+#else
+    return skipWhitespaceTail(json, end);
+#endif
+}
+
+} // namespace QJsonPrivate
+
 using namespace QJsonPrivate;
 
 Parser::Parser(const char *json, int length)
@@ -258,16 +447,9 @@ void Parser::eatBOM()
 
 bool Parser::eatSpace()
 {
-    while (json < end) {
-        if (*json > Space)
-            break;
-        if (*json != Space &&
-            *json != Tab &&
-            *json != LineFeed &&
-            *json != Return)
-            break;
-        ++json;
-    }
+    if (json < end && uchar(*json) > Space)
+        return true;
+    json = skipWhitespace(json, end);
     return (json < end);
 }
 
@@ -738,65 +920,45 @@ bool Parser::parseNumber(QJsonPrivate::Value *val, int baseOffset)
     val->type = QJsonValue::Double;
 
     const char *start = json;
-    bool isInt = true;
-
-    // minus
-    if (json < end && *json == '-')
-        ++json;
-
-    // int = zero / ( digit1-9 *DIGIT )
-    if (json < end && *json == '0') {
-        ++json;
-    } else {
-        while (json < end && *json >= '0' && *json <= '9')
-            ++json;
-    }
-
-    // frac = decimal-point 1*DIGIT
-    if (json < end && *json == '.') {
-        isInt = false;
-        ++json;
-        while (json < end && *json >= '0' && *json <= '9')
-            ++json;
-    }
-
-    // exp = e [ minus / plus ] 1*DIGIT
-    if (json < end && (*json == 'e' || *json == 'E')) {
-        isInt = false;
-        ++json;
-        if (json < end && (*json == '-' || *json == '+'))
-            ++json;
-        while (json < end && *json >= '0' && *json <= '9')
-            ++json;
-    }
+    bool isInt;
+    json = scanNumber(json, end, &isInt);
 
     if (json >= end) {
         lastError = QJsonParseError::TerminationByNumber;
         return false;
     }
 
-    QByteArray number(start, json - start);
-    DEBUG << "numberstring" << number;
+    DEBUG << "numberstring" << QByteArray(start, json - start);
 
     if (isInt) {
-        bool ok;
-        int n = number.toInt(&ok);
-        if (ok && n < (1<<25) && n > -(1<<25)) {
-            val->int_value = n;
-            val->latinOrIntValue = true;
-            END;
-            return true;
+        // integers of up to 9 digits can't overflow, so convert them in place
+        const bool negative = (*start == '-');
+        const char *digits = start + negative;
+        if (json > digits && json - digits <= 9) {
+            int n = 0;
+            for (const char *c = digits; c < json; ++c)
+                n = n * 10 + (*c - '0');
+            if (negative)
+                n = -n;
+            if (n < (1<<25) && n > -(1<<25)) {
+                val->int_value = n;
+                val->latinOrIntValue = true;
+                END;
+                return true;
+            }
         }
     }
 
+    // the whole number has to convert, so that a dangling exponent is rejected
     bool ok;
+    int processed;
     union {
         quint64 ui;
         double d;
     };
-    d = number.toDouble(&ok);
+    d = asciiToDouble(start, int(json - start), ok, processed, TrailingJunkProhibited);
 
-    if (!ok) {
+    if (!ok || processed != json - start) {
         lastError = QJsonParseError::IllegalNumber;
         return false;
     }
@@ -838,80 +1000,6 @@ bool Parser::parseNumber(QJsonPrivate::Value *val, int baseOffset)
 
         unescaped = %x20-21 / %x23-5B / %x5D-10FFFF
  */
-static inline bool addHexDigit(char digit, uint *result)
-{
-    *result <<= 4;
-    if (digit >= '0' && digit <= '9')
-        *result |= (digit - '0');
-    else if (digit >= 'a' && digit <= 'f')
-        *result |= (digit - 'a') + 10;
-    else if (digit >= 'A' && digit <= 'F')
-        *result |= (digit - 'A') + 10;
-    else
-        return false;
-    return true;
-}
-
-static inline bool scanEscapeSequence(const char *&json, const char *end, uint *ch)
-{
-    ++json;
-    if (json >= end)
-        return false;
-
-    DEBUG << "scan escape" << (char)*json;
-    uint escaped = *json++;
-    switch (escaped) {
-    case '"':
-        *ch = '"'; break;
-    case '\\':
-        *ch = '\\'; break;
-    case '/':
-        *ch = '/'; break;
-    case 'b':
-        *ch = 0x8; break;
-    case 'f':
-        *ch = 0xc; break;
-    case 'n':
-        *ch = 0xa; break;
-    case 'r':
-        *ch = 0xd; break;
-    case 't':
-        *ch = 0x9; break;
-    case 'u': {
-        *ch = 0;
-        if (json > end - 4)
-            return false;
-        for (int i = 0; i < 4; ++i) {
-            if (!addHexDigit(*json, ch))
-                return false;
-            ++json;
-        }
-        return true;
-    }
-    default:
-        // this is not as strict as one could be, but allows for more Json files
-        // to be parsed correctly.
-        *ch = escaped;
-        return true;
-    }
-    return true;
-}
-
-static inline bool scanUtf8Char(const char *&json, const char *end, uint *result)
-{
-    const uchar *&src = reinterpret_cast<const uchar *&>(json);
-    const uchar *uend = reinterpret_cast<const uchar *>(end);
-    uchar b = *src++;
-    int res = QUtf8Functions::fromUtf8<QUtf8BaseTraits>(b, result, src, uend);
-    if (res < 0) {
-        // decoding error, backtrack the character we read above
-        --json;
-        return false;
-    }
-
-    return true;
-}
-
 bool Parser::parseString(bool *latin1)
 {
     *latin1 = true;
@@ -926,7 +1014,21 @@ bool Parser::parseString(bool *latin1)
         return false;
 
     BEGIN << "parse string stringPos=" << stringPos << json;
+    // the bail out below limits a latin1 string to 0x7fff bytes of input
+    const char *latin1End = end - start > 0x7fff ? start + 0x7fff : end;
     while (json < end) {
+        // copy runs of plain ASCII in one go
+        const char *run = findStringSpecial(json, latin1End);
+        if (run != json) {
+            const int length = int(run - json);
+            int pos = reserveSpace(length);
+            if (pos < 0)
+                return false;
+            memcpy(data + pos, json, length);
+            json = run;
+            if (json >= end)
+                break;
+        }
         uint ch = 0;
         if (*json == '"')
             break;
@@ -979,6 +1081,19 @@ bool Parser::parseString(bool *latin1)
     current = outStart + sizeof(int);
 
     while (json < end) {
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+        const char *run = findStringSpecial(json, end);
+        if (run != json) {
+            const int length = int(run - json);
+            int pos = reserveSpace(2 * length);
+            if (pos < 0)
+                return false;
+            qt_from_latin1(reinterpret_cast<ushort *>(data + pos), json, size_t(length));
+            json = run;
+            if (json >= end)
+                break;
+        }
+#endif
         uint ch = 0;
         if (*json == '"')
             break;
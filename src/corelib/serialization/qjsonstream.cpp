@@ -0,0 +1,1253 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qjsonstream.h"
+#include "qjsonarray.h"
+#include "qjsonobject.h"
+#include "qjsonparser_p.h"
+#include "qjsonwriter_p.h"
+
+#include <qiodevice.h>
+#include <qvarlengtharray.h>
+#include <private/qlocale_tools_p.h>
+
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+void qt_from_latin1(ushort *dst, const char *str, size_t size) Q_DECL_NOTHROW;
+
+using namespace QJsonPrivate;
+
+namespace {
+enum {
+    ReadChunkSize = 16 * 1024,
+    WriteBufferSize = 16 * 1024,
+    NestingLimit = 1024
+};
+}
+
+class QJsonStreamReaderPrivate
+{
+public:
+    enum Result { Ok, NeedData, Failed };
+    enum State : uchar { ExpectFirst, ExpectSeparator };
+    struct Container {
+        bool isObject;
+        State state;
+    };
+
+    QJsonStreamReaderPrivate()
+        : device(nullptr), pos(0), consumed(0), bomChecked(false), finished(false),
+          type(QJsonStreamReader::NoToken), error(QJsonParseError::NoError),
+          errorAtEnd(QJsonParseError::NoError), number(0), integer(0),
+          isInteger(false), boolean(false)
+    {}
+
+    QJsonStreamReader::TokenType readNext();
+    Result scanToken();
+    Result scanValue(const char *&p, const char *end);
+    Result scanString(const char *&p, const char *end, QString &out);
+    Result scanNumber(const char *&p, const char *end);
+    Result scanLiteral(const char *&p, const char *end, const char *literal, int length);
+    Result fail(QJsonParseError::ParseError e, const char *at);
+    Result needData(QJsonParseError::ParseError e) { errorAtEnd = e; return NeedData; }
+    bool fillBuffer();
+    void compact();
+    void reset();
+
+    QIODevice *device;
+    QByteArray buffer;
+    int pos;
+    qint64 consumed;
+    bool bomChecked;
+    bool finished;
+
+    QJsonStreamReader::TokenType type;
+    QJsonParseError::ParseError error;
+    QJsonParseError::ParseError errorAtEnd;
+    QVarLengthArray<Container, 32> stack;
+
+    QString name;
+    QString text;
+    double number;
+    qint64 integer;
+    bool isInteger;
+    bool boolean;
+};
+
+void QJsonStreamReaderPrivate::reset()
+{
+    buffer.clear();
+    pos = 0;
+    consumed = 0;
+    bomChecked = false;
+    finished = false;
+    type = QJsonStreamReader::NoToken;
+    error = errorAtEnd = QJsonParseError::NoError;
+    stack.clear();
+    name.clear();
+    text.clear();
+}
+
+void QJsonStreamReaderPrivate::compact()
+{
+    if (pos) {
+        buffer.remove(0, pos);
+        consumed += pos;
+        pos = 0;
+    }
+}
+
+/*!
+    \internal
+
+    Reads more data from the device into the buffer. Tokens are only
+    consumed once they are complete, so the unconsumed tail of the buffer
+    is kept, and the amount read grows with it so that a long token is not
+    rescanned too many times.
+*/
+bool QJsonStreamReaderPrivate::fillBuffer()
+{
+    if (!device)
+        return false;
+    compact();
+    const int oldSize = buffer.size();
+    const int chunk = qMax(int(ReadChunkSize), oldSize);
+    buffer.resize(oldSize + chunk);
+    const qint64 n = device->read(buffer.data() + oldSize, chunk);
+    buffer.resize(oldSize + int(qMax(n, qint64(0))));
+    return n > 0;
+}
+
+QJsonStreamReaderPrivate::Result QJsonStreamReaderPrivate::fail(QJsonParseError::ParseError e,
+                                                                const char *at)
+{
+    error = e;
+    pos = at - buffer.constData();
+    return Failed;
+}
+
+QJsonStreamReaderPrivate::Result QJsonStreamReaderPrivate::scanString(const char *&p, const char *end,
+                                                                      QString &out)
+{
+    // find the closing quote first, so that only complete strings are decoded
+    const char *q = p;
+    bool ascii = true;
+    while ((q = findStringSpecial(q, end)) < end && *q != '"') {
+        // skip the escaped character, or the first byte of a UTF-8 sequence,
+        // but not past the end if the buffer ends in a backslash
+        ascii = false;
+        q += qMin<qptrdiff>((*q == '\\') ? 2 : 1, end - q);
+    }
+    if (q >= end)
+        return needData(QJsonParseError::UnterminatedString);
+
+    out.resize(int(q - p));
+    ushort *dst = reinterpret_cast<ushort *>(out.data());
+    if (ascii) {
+        qt_from_latin1(dst, p, size_t(q - p));
+        p = q;
+    } else {
+        ushort *const start = dst;
+        while (p != q) {
+            uint ch = 0;
+            if (*p == '\\') {
+                if (!scanEscapeSequence(p, q, &ch))
+                    return fail(QJsonParseError::IllegalEscapeSequence, p);
+            } else if (!scanUtf8Char(p, q, &ch)) {
+                return fail(QJsonParseError::IllegalUTF8String, p);
+            }
+            if (QChar::requiresSurrogates(ch)) {
+                *dst++ = QChar::highSurrogate(ch);
+                *dst++ = QChar::lowSurrogate(ch);
+            } else {
+                *dst++ = ushort(ch);
+            }
+        }
+        out.resize(int(dst - start));
+    }
+    ++p;
+    return Ok;
+}
+
+QJsonStreamReaderPrivate::Result QJsonStreamReaderPrivate::scanNumber(const char *&p, const char *end)
+{
+    bool isInt;
+    const char *numberEnd = QJsonPrivate::scanNumber(p, end, &isInt);
+    if (numberEnd >= end)
+        return needData(QJsonParseError::TerminationByNumber);
+
+    // the whole number has to convert, so that a dangling exponent is rejected
+    bool ok;
+    int processed;
+    number = asciiToDouble(p, int(numberEnd - p), ok, processed, TrailingJunkProhibited);
+    if (!ok || processed != numberEnd - p)
+        return fail(QJsonParseError::IllegalNumber, p);
+    isInteger = false;
+    if (isInt) {
+        const char *parsedEnd;
+        integer = qstrtoll(p, &parsedEnd, 10, &ok);
+        isInteger = ok && parsedEnd == numberEnd;
+    }
+    p = numberEnd;
+    return Ok;
+}
+
+QJsonStreamReaderPrivate::Result QJsonStreamReaderPrivate::scanLiteral(const char *&p, const char *end,
+                                                                       const char *literal, int length)
+{
+    const int available = int(qMin<qptrdiff>(length, end - p));
+    if (memcmp(p, literal, available) != 0)
+        return fail(QJsonParseError::IllegalValue, p);
+    if (available < length)
+        return needData(QJsonParseError::IllegalValue);
+    p += length;
+    return Ok;
+}
+
+QJsonStreamReaderPrivate::Result QJsonStreamReaderPrivate::scanValue(const char *&p, const char *end)
+{
+    switch (*p) {
+    case '{':
+    case '[':
+        if (stack.size() >= NestingLimit)
+            return fail(QJsonParseError::DeepNesting, p);
+        type = *p++ == '{' ? QJsonStreamReader::StartObject : QJsonStreamReader::StartArray;
+        return Ok;
+    case '"':
+        type = QJsonStreamReader::String;
+        ++p;
+        return scanString(p, end, text);
+    case 't':
+        type = QJsonStreamReader::Bool;
+        boolean = true;
+        return scanLiteral(p, end, "true", 4);
+    case 'f':
+        type = QJsonStreamReader::Bool;
+        boolean = false;
+        return scanLiteral(p, end, "false", 5);
+    case 'n':
+        type = QJsonStreamReader::Null;
+        return scanLiteral(p, end, "null", 4);
+    case '}':
+    case ']':
+        return fail(QJsonParseError::MissingObject, p);
+    case ',':
+        return fail(QJsonParseError::IllegalValue, p);
+    default:
+        type = QJsonStreamReader::Number;
+        return scanNumber(p, end);
+    }
+}
+
+/*!
+    \internal
+
+    Scans the next token, including the separators before it. The state of
+    the reader is only updated if the token is complete; if the buffer ends
+    before that, NeedData is returned and errorAtEnd says which error to
+    report if no more data arrives.
+*/
+QJsonStreamReaderPrivate::Result QJsonStreamReaderPrivate::scanToken()
+{
+    const char *const begin = buffer.constData();
+    const char *const end = begin + buffer.size();
+    const char *p = begin + pos;
+
+    if (Q_UNLIKELY(!bomChecked)) {
+        // eat UTF-8 byte order mark
+        static const char utf8bom[] = "\xef\xbb\xbf";
+        const int available = int(qMin<qptrdiff>(3, end - p));
+        if (available && memcmp(p, utf8bom, available) == 0) {
+            if (available < 3)
+                return needData(QJsonParseError::IllegalValue);
+            p += 3;
+            pos += 3;
+        }
+        bomChecked = available > 0;
+    }
+
+    const QJsonParseError::ParseError unterminated = stack.isEmpty()
+            ? QJsonParseError::NoError
+            : stack.last().isObject ? QJsonParseError::UnterminatedObject
+                                    : QJsonParseError::UnterminatedArray;
+    // whitespace between tokens needs no rescanning
+    p = skipWhitespace(p, end);
+    pos = p - begin;
+    if (p == end)
+        return needData(unterminated);
+
+    if (stack.isEmpty()) {
+        // JSON-text = object / array, any number of them one after the other
+        if (*p != '{' && *p != '[')
+            return fail(QJsonParseError::IllegalValue, p);
+        scanValue(p, end);
+        name.clear();
+        stack.append({ type == QJsonStreamReader::StartObject, ExpectFirst });
+        pos = p - begin;
+        return Ok;
+    }
+
+    Container &container = stack.last();
+    const char close = container.isObject ? '}' : ']';
+    bool afterComma = false;
+    if (container.state == ExpectSeparator) {
+        if (*p == ',') {
+            afterComma = true;
+            ++p;
+            p = skipWhitespace(p, end);
+            if (p == end)
+                return needData(unterminated);
+        } else if (*p != close) {
+            return fail(container.isObject ? QJsonParseError::UnterminatedObject
+                                           : QJsonParseError::MissingValueSeparator, p);
+        }
+    }
+
+    if (*p == close && !afterComma) {
+        type = container.isObject ? QJsonStreamReader::EndObject : QJsonStreamReader::EndArray;
+        name.clear();
+        stack.removeLast();
+        pos = ++p - begin;
+        return Ok;
+    }
+
+    if (container.isObject) {
+        // member = string name-separator value
+        if (*p != '"') {
+            return fail(afterComma && *p == '}' ? QJsonParseError::MissingObject
+                                                : QJsonParseError::UnterminatedObject, p);
+        }
+        ++p;
+        const Result result = scanString(p, end, name);
+        if (result != Ok)
+            return result;
+        p = skipWhitespace(p, end);
+        if (p == end)
+            return needData(unterminated);
+        if (*p != ':')
+            return fail(QJsonParseError::MissingNameSeparator, p);
+        ++p;
+        p = skipWhitespace(p, end);
+        if (p == end)
+            return needData(unterminated);
+    } else {
+        name.clear();
+    }
+
+    const Result result = scanValue(p, end);
+    if (result != Ok)
+        return result;
+
+    container.state = ExpectSeparator;
+    if (type == QJsonStreamReader::StartObject || type == QJsonStreamReader::StartArray)
+        stack.append({ type == QJsonStreamReader::StartObject, ExpectFirst });
+    pos = p - begin;
+    return Ok;
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::readNext()
+{
+    if (error != QJsonParseError::NoError)
+        return type = QJsonStreamReader::Invalid;
+
+    finished = false;
+    for (;;) {
+        switch (scanToken()) {
+        case Ok:
+            return type;
+        case Failed:
+            finished = true;
+            return type = QJsonStreamReader::Invalid;
+        case NeedData:
+            break;
+        }
+        if (!fillBuffer())
+            break;
+    }
+
+    // Out of data. A random-access device that has no more data will not
+    // get any, so an unfinished value is an error; otherwise, more data can
+    // be added with addData() or may arrive on the device later.
+    finished = true;
+    if (device && !device->isSequential() && errorAtEnd != QJsonParseError::NoError) {
+        error = errorAtEnd;
+        pos = buffer.size();
+        return type = QJsonStreamReader::Invalid;
+    }
+    return type = QJsonStreamReader::NoToken;
+}
+
+/*!
+    \class QJsonStreamReader
+    \inmodule QtCore
+    \ingroup json
+    \reentrant
+    \since 5.12
+
+    \brief The QJsonStreamReader class provides a fast parser for reading
+    JSON incrementally, one token at a time.
+
+    QJsonDocument::fromJson() needs the whole document in memory, and
+    converts all of it into a QJsonDocument, which needs about as much
+    memory again. QJsonStreamReader instead reads JSON from a QIODevice, or
+    from data added piecewise with addData(), and reports it as a sequence
+    of tokens, like QXmlStreamReader does for XML. It only keeps the token
+    it is reading in memory, so it can process inputs of any size in
+    constant memory.
+
+    The basic loop reads tokens with readNext() until atEnd() returns
+    \c true:
+
+    \snippet code/src_corelib_serialization_qjsonstream.cpp 0
+
+    Objects and arrays are reported as a StartObject or StartArray token,
+    followed by the tokens of their contents, followed by an EndObject or
+    EndArray token. The values inside an object carry the name of their
+    member, which name() returns. String, Number, Bool and Null tokens
+    carry their value, which text(), toDouble(), toInteger() and toBool()
+    return. At any point, readValue() reads the current value, including
+    the contents of an object or array, into a QJsonValue, and
+    skipCurrentValue() skips it.
+
+    The input may contain any number of objects and arrays one after the
+    other, separated by whitespace. In particular, the reader can read
+    newline-delimited JSON (NDJSON), in which every line is a JSON object.
+
+    When the reader runs out of data, readNext() returns NoToken. If the
+    data comes from addData(), or from a sequential device such as a
+    socket, more data may still come, and reading can resume once it has
+    arrived; depth() returns 0 if the reader stopped between two top-level
+    values. When a random-access device such as a file ends in the middle
+    of a value, the reader reports an error instead.
+
+    On errors, readNext() returns Invalid, and error(), errorString() and
+    characterOffset() describe the error. The reader accepts the same JSON
+    as QJsonDocument::fromJson(), and reports the same errors.
+
+    \sa QJsonStreamWriter, QJsonDocument, QXmlStreamReader
+*/
+
+/*!
+    \enum QJsonStreamReader::TokenType
+
+    This enum specifies the type of token the reader just read.
+
+    \value NoToken The reader has not read anything yet, or has run out of data.
+    \value Invalid An error has occurred, reported in error() and errorString().
+    \value StartObject The reader reports the start of an object.
+    \value EndObject The reader reports the end of an object.
+    \value StartArray The reader reports the start of an array.
+    \value EndArray The reader reports the end of an array.
+    \value String The reader reports a string, available from text().
+    \value Number The reader reports a number, available from toDouble()
+           and toInteger().
+    \value Bool The reader reports \c true or \c false, available from toBool().
+    \value Null The reader reports \c null.
+*/
+
+/*!
+    Constructs a stream reader.
+
+    \sa setDevice(), addData()
+*/
+QJsonStreamReader::QJsonStreamReader()
+    : d_ptr(new QJsonStreamReaderPrivate)
+{
+}
+
+/*!
+    Creates a new stream reader that reads from \a device.
+
+    \sa setDevice(), clear()
+*/
+QJsonStreamReader::QJsonStreamReader(QIODevice *device)
+    : d_ptr(new QJsonStreamReaderPrivate)
+{
+    setDevice(device);
+}
+
+/*!
+    Creates a new stream reader that reads from \a data.
+
+    \sa addData(), clear()
+*/
+QJsonStreamReader::QJsonStreamReader(const QByteArray &data)
+    : d_ptr(new QJsonStreamReaderPrivate)
+{
+    addData(data);
+}
+
+/*!
+    Destructs the reader.
+*/
+QJsonStreamReader::~QJsonStreamReader()
+{
+}
+
+/*!
+    Sets the current device to \a device, and resets the reader to its
+    initial state. The reader reads the device from its current position.
+
+    \sa device(), clear()
+*/
+void QJsonStreamReader::setDevice(QIODevice *device)
+{
+    Q_D(QJsonStreamReader);
+    d->reset();
+    d->device = device;
+}
+
+/*!
+    Returns the current device associated with the QJsonStreamReader, or
+    \c nullptr if no device has been assigned.
+
+    \sa setDevice()
+*/
+QIODevice *QJsonStreamReader::device() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->device;
+}
+
+/*!
+    Adds more \a data for the reader to read. This function does nothing if
+    the reader has a device().
+
+    \sa readNext(), clear()
+*/
+void QJsonStreamReader::addData(const QByteArray &data)
+{
+    Q_D(QJsonStreamReader);
+    if (d->device) {
+        qWarning("QJsonStreamReader: addData() with device()");
+        return;
+    }
+    d->compact();
+    d->buffer += data;
+    d->finished = false;
+}
+
+/*!
+    Removes any device() or data from the reader, and resets it to its
+    initial state.
+
+    \sa addData()
+*/
+void QJsonStreamReader::clear()
+{
+    Q_D(QJsonStreamReader);
+    d->reset();
+    d->device = nullptr;
+}
+
+/*!
+    Returns \c true if the reader has read until the end of the data
+    available, or if an error has occurred; otherwise returns \c false.
+
+    \sa hasError(), depth()
+*/
+bool QJsonStreamReader::atEnd() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->finished;
+}
+
+/*!
+    Reads the next token and returns its type.
+
+    Once an error has been reported, this function keeps returning
+    Invalid.
+
+    \sa tokenType(), atEnd()
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::readNext()
+{
+    Q_D(QJsonStreamReader);
+    return d->readNext();
+}
+
+/*!
+    Returns the current value as a QJsonValue. If the current token is
+    StartObject or StartArray, this function reads the whole object or
+    array, and the current token becomes the matching EndObject or
+    EndArray.
+
+    The whole value must be available: if the reader runs out of data
+    before the end of the value, an error is raised. If the current token
+    is not the start of a value, returns an undefined QJsonValue.
+
+    \sa skipCurrentValue()
+*/
+QJsonValue QJsonStreamReader::readValue()
+{
+    Q_D(QJsonStreamReader);
+    switch (d->type) {
+    case String:
+        return QJsonValue(d->text);
+    case Number:
+        return QJsonValue(d->number);
+    case Bool:
+        return QJsonValue(d->boolean);
+    case Null:
+        return QJsonValue(QJsonValue::Null);
+    case StartObject: {
+        QJsonObject object;
+        while (readNext() != EndObject) {
+            if (d->type == Invalid || d->type == NoToken)
+                break;
+            const QString key = d->name;
+            object.insert(key, readValue());
+        }
+        if (d->type == EndObject)
+            return object;
+        break;
+    }
+    case StartArray: {
+        QJsonArray array;
+        while (readNext() != EndArray) {
+            if (d->type == Invalid || d->type == NoToken)
+                break;
+            array.append(readValue());
+        }
+        if (d->type == EndArray)
+            return array;
+        break;
+    }
+    default:
+        return QJsonValue(QJsonValue::Undefined);
+    }
+
+    if (d->type == NoToken) {
+        d->error = d->errorAtEnd;
+        d->type = Invalid;
+    }
+    return QJsonValue(QJsonValue::Undefined);
+}
+
+/*!
+    Skips the current value. If the current token is StartObject or
+    StartArray, reads until the matching EndObject or EndArray, which
+    becomes the current token. Otherwise, does nothing.
+
+    \sa readValue()
+*/
+void QJsonStreamReader::skipCurrentValue()
+{
+    Q_D(QJsonStreamReader);
+    if (d->type != StartObject && d->type != StartArray)
+        return;
+    const int level = d->stack.size();
+    while (d->stack.size() >= level) {
+        if (readNext() == Invalid || d->type == NoToken)
+            return;
+    }
+}
+
+/*!
+    Returns the type of the current token.
+
+    \sa readNext()
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::tokenType() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->type;
+}
+
+/*!
+    \fn bool QJsonStreamReader::isStartObject() const
+
+    Returns \c true if tokenType() equals \l StartObject; otherwise returns \c false.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isEndObject() const
+
+    Returns \c true if tokenType() equals \l EndObject; otherwise returns \c false.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isStartArray() const
+
+    Returns \c true if tokenType() equals \l StartArray; otherwise returns \c false.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isEndArray() const
+
+    Returns \c true if tokenType() equals \l EndArray; otherwise returns \c false.
+*/
+
+/*!
+    Returns the number of objects and arrays the current token is in. After
+    a StartObject or StartArray token, this includes the object or array
+    that just started; after an EndObject or EndArray token, it does not
+    include the object or array that just ended.
+*/
+int QJsonStreamReader::depth() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->stack.size();
+}
+
+/*!
+    Returns the name of the object member whose value is the current token,
+    or an empty string if the current token is not the value of an object
+    member.
+*/
+QString QJsonStreamReader::name() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->name;
+}
+
+/*!
+    Returns the value of the current String token, or an empty string for
+    other tokens.
+*/
+QString QJsonStreamReader::text() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->type == String ? d->text : QString();
+}
+
+/*!
+    Returns the value of the current Number token, or 0 for other tokens.
+
+    \sa toInteger()
+*/
+double QJsonStreamReader::toDouble() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->type == Number ? d->number : 0;
+}
+
+/*!
+    Returns the value of the current Number token if it is an integer that
+    fits into a qint64; otherwise returns \a defaultValue. Unlike
+    toDouble(), this function does not lose precision for integers larger
+    than 2\sup{53}.
+
+    \sa toDouble()
+*/
+qint64 QJsonStreamReader::toInteger(qint64 defaultValue) const
+{
+    Q_D(const QJsonStreamReader);
+    return d->type == Number && d->isInteger ? d->integer : defaultValue;
+}
+
+/*!
+    Returns the value of the current Bool token, or \c false for other
+    tokens.
+*/
+bool QJsonStreamReader::toBool() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->type == Bool && d->boolean;
+}
+
+/*!
+    Returns the position of the reader in the input, in bytes. After a
+    token, this is the end of the token, or the start of the whitespace
+    after it that has been read already. If an error occurred, returns the
+    offset at which it was found.
+*/
+qint64 QJsonStreamReader::characterOffset() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->consumed + d->pos;
+}
+
+/*!
+    Returns the type of the error that occurred, or QJsonParseError::NoError.
+
+    \sa errorString(), hasError()
+*/
+QJsonParseError::ParseError QJsonStreamReader::error() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->error;
+}
+
+/*!
+    Returns the message of the error that occurred, or an empty string if
+    there was no error.
+
+    \sa error()
+*/
+QString QJsonStreamReader::errorString() const
+{
+    Q_D(const QJsonStreamReader);
+    if (d->error == QJsonParseError::NoError)
+        return QString();
+    QJsonParseError error;
+    error.error = d->error;
+    error.offset = int(characterOffset());
+    return error.errorString();
+}
+
+/*!
+    \fn bool QJsonStreamReader::hasError() const
+
+    Returns \c true if an error has occurred; otherwise returns \c false.
+
+    \sa error(), errorString()
+*/
+
+#if !defined(QT_JSON_READONLY) || defined(Q_CLANG_QDOC)
+
+class QJsonStreamWriterPrivate
+{
+public:
+    struct Container {
+        bool isObject;
+        bool hasElements;
+    };
+
+    QJsonStreamWriterPrivate()
+        : device(nullptr), array(nullptr), compact(false), hasError(false)
+    {}
+
+    QByteArray &output() { return array ? *array : buffer; }
+    void beginValue(const QString *name);
+    void endValue();
+    void startContainer(const QString *name, bool isObject);
+    void endContainer(bool isObject);
+    void writeValue(const QString *name, const QJsonValue &value);
+    void writeIndent(QByteArray &out, int level) { out.append(4 * level, ' '); }
+    void flush();
+
+    QIODevice *device;
+    QByteArray *array;
+    QByteArray buffer;
+    QVarLengthArray<Container, 32> stack;
+    bool compact;
+    bool hasError;
+};
+
+void QJsonStreamWriterPrivate::beginValue(const QString *name)
+{
+    QByteArray &out = output();
+    if (stack.isEmpty())
+        return;
+
+    Container &container = stack.last();
+    Q_ASSERT_X(container.isObject == bool(name), "QJsonStreamWriter",
+               container.isObject ? "values in objects need a name" : "values in arrays have no name");
+    if (container.hasElements)
+        out += ',';
+    container.hasElements = true;
+    if (!compact) {
+        out += '\n';
+        writeIndent(out, stack.size());
+    }
+    if (name) {
+        out += '"';
+        out += Writer::escapedString(*name);
+        out += compact ? "\":" : "\": ";
+    }
+}
+
+void QJsonStreamWriterPrivate::endValue()
+{
+    if (stack.isEmpty()) {
+        // every top-level value gets its own line
+        output() += '\n';
+        flush();
+    } else if (device && buffer.size() >= WriteBufferSize) {
+        flush();
+    }
+}
+
+void QJsonStreamWriterPrivate::startContainer(const QString *name, bool isObject)
+{
+    beginValue(name);
+    output() += isObject ? '{' : '[';
+    stack.append({ isObject, false });
+}
+
+void QJsonStreamWriterPrivate::endContainer(bool isObject)
+{
+    Q_ASSERT_X(!stack.isEmpty() && stack.last().isObject == isObject, "QJsonStreamWriter",
+               "unbalanced end of object or array");
+    if (stack.isEmpty())
+        return;
+    stack.removeLast();
+    QByteArray &out = output();
+    if (!compact) {
+        out += '\n';
+        writeIndent(out, stack.size());
+    }
+    out += isObject ? '}' : ']';
+    endValue();
+}
+
+void QJsonStreamWriterPrivate::writeValue(const QString *name, const QJsonValue &value)
+{
+    switch (value.type()) {
+    case QJsonValue::Object: {
+        const QJsonObject object = value.toObject();
+        startContainer(name, true);
+        for (auto it = object.constBegin(), end = object.constEnd(); it != end; ++it) {
+            const QString key = it.key();
+            writeValue(&key, it.value());
+        }
+        endContainer(true);
+        return;
+    }
+    case QJsonValue::Array: {
+        const QJsonArray array = value.toArray();
+        startContainer(name, false);
+        for (const QJsonValue &element : array)
+            writeValue(nullptr, element);
+        endContainer(false);
+        return;
+    }
+    default:
+        break;
+    }
+
+    Q_ASSERT_X(!stack.isEmpty(), "QJsonStreamWriter",
+               "only objects and arrays can be written at the top level");
+    beginValue(name);
+    QByteArray &out = output();
+    switch (value.type()) {
+    case QJsonValue::Bool:
+        out += value.toBool() ? "true" : "false";
+        break;
+    case QJsonValue::Double:
+        Writer::doubleToJson(value.toDouble(), out);
+        break;
+    case QJsonValue::String:
+        out += '"';
+        out += Writer::escapedString(value.toString());
+        out += '"';
+        break;
+    default:
+        out += "null";
+        break;
+    }
+    endValue();
+}
+
+void QJsonStreamWriterPrivate::flush()
+{
+    if (!device || buffer.isEmpty())
+        return;
+    if (device->write(buffer) != buffer.size())
+        hasError = true;
+    // keep the allocation for the next chunk; resize(0) only does that
+    // once the capacity is reserved
+    buffer.reserve(WriteBufferSize);
+    buffer.resize(0);
+}
+
+/*!
+    \class QJsonStreamWriter
+    \inmodule QtCore
+    \ingroup json
+    \reentrant
+    \since 5.12
+
+    \brief The QJsonStreamWriter class provides a JSON writer with a simple
+    streaming API.
+
+    QJsonStreamWriter is the counterpart to QJsonStreamReader. Instead of
+    building a QJsonDocument and converting all of it with
+    QJsonDocument::toJson(), the JSON is written piece by piece to a
+    QIODevice or a QByteArray as it is produced, so that writing large
+    amounts of JSON only needs memory for a small buffer:
+
+    \snippet code/src_corelib_serialization_qjsonstream.cpp 1
+
+    writeStartObject() and writeStartArray() open an object or an array,
+    which writeEndObject() and writeEndArray() close. writeValue() writes
+    a value, which can be a whole QJsonObject or QJsonArray. Values inside
+    an object need a name, and values inside an array must not have one.
+    writeCurrentToken() copies the current token of a QJsonStreamReader,
+    which makes it easy to filter JSON.
+
+    The output has the same format as QJsonDocument::toJson(), except that
+    every value written at the top level is followed by a newline, so that
+    writing several objects in the Compact format() produces
+    newline-delimited JSON (NDJSON).
+
+    Output to a device is buffered, and flushed at the end of every
+    top-level value, as well as by flush() and the destructor.
+
+    \sa QJsonStreamReader, QJsonDocument, QXmlStreamWriter
+*/
+
+/*!
+    Constructs a stream writer.
+
+    \sa setDevice()
+*/
+QJsonStreamWriter::QJsonStreamWriter()
+    : d_ptr(new QJsonStreamWriterPrivate)
+{
+}
+
+/*!
+    Constructs a stream writer that writes into \a device.
+*/
+QJsonStreamWriter::QJsonStreamWriter(QIODevice *device)
+    : d_ptr(new QJsonStreamWriterPrivate)
+{
+    d_ptr->device = device;
+}
+
+/*!
+    Constructs a stream writer that appends to \a array.
+*/
+QJsonStreamWriter::QJsonStreamWriter(QByteArray *array)
+    : d_ptr(new QJsonStreamWriterPrivate)
+{
+    d_ptr->array = array;
+}
+
+/*!
+    Flushes the buffered output to the device, and destructs the writer.
+*/
+QJsonStreamWriter::~QJsonStreamWriter()
+{
+    Q_D(QJsonStreamWriter);
+    d->flush();
+}
+
+/*!
+    Flushes the buffered output and sets the current device to \a device.
+
+    \sa device()
+*/
+void QJsonStreamWriter::setDevice(QIODevice *device)
+{
+    Q_D(QJsonStreamWriter);
+    d->flush();
+    d->device = device;
+    d->array = nullptr;
+}
+
+/*!
+    Returns the device associated with the QJsonStreamWriter, or \c nullptr
+    if no device has been assigned.
+
+    \sa setDevice()
+*/
+QIODevice *QJsonStreamWriter::device() const
+{
+    Q_D(const QJsonStreamWriter);
+    return d->device;
+}
+
+/*!
+    Sets the format of the output to \a format. The default is
+    QJsonDocument::Indented.
+*/
+void QJsonStreamWriter::setFormat(QJsonDocument::JsonFormat format)
+{
+    Q_D(QJsonStreamWriter);
+    d->compact = format == QJsonDocument::Compact;
+}
+
+/*!
+    Returns the format of the output.
+
+    \sa setFormat()
+*/
+QJsonDocument::JsonFormat QJsonStreamWriter::format() const
+{
+    Q_D(const QJsonStreamWriter);
+    return d->compact ? QJsonDocument::Compact : QJsonDocument::Indented;
+}
+
+/*!
+    Writes the start of an object, at the top level or in an array.
+
+    \sa writeEndObject()
+*/
+void QJsonStreamWriter::writeStartObject()
+{
+    Q_D(QJsonStreamWriter);
+    d->startContainer(nullptr, true);
+}
+
+/*!
+    \overload
+
+    Writes the start of an object that is the value of the member \a name
+    of the current object.
+*/
+void QJsonStreamWriter::writeStartObject(const QString &name)
+{
+    Q_D(QJsonStreamWriter);
+    d->startContainer(&name, true);
+}
+
+/*!
+    Closes the object started by the matching writeStartObject().
+*/
+void QJsonStreamWriter::writeEndObject()
+{
+    Q_D(QJsonStreamWriter);
+    d->endContainer(true);
+}
+
+/*!
+    Writes the start of an array, at the top level or in an array.
+
+    \sa writeEndArray()
+*/
+void QJsonStreamWriter::writeStartArray()
+{
+    Q_D(QJsonStreamWriter);
+    d->startContainer(nullptr, false);
+}
+
+/*!
+    \overload
+
+    Writes the start of an array that is the value of the member \a name
+    of the current object.
+*/
+void QJsonStreamWriter::writeStartArray(const QString &name)
+{
+    Q_D(QJsonStreamWriter);
+    d->startContainer(&name, false);
+}
+
+/*!
+    Closes the array started by the matching writeStartArray().
+*/
+void QJsonStreamWriter::writeEndArray()
+{
+    Q_D(QJsonStreamWriter);
+    d->endContainer(false);
+}
+
+/*!
+    Writes \a value as an element of the current array. At the top level,
+    \a value must be an object or an array.
+
+    Undefined values are written as \c null.
+*/
+void QJsonStreamWriter::writeValue(const QJsonValue &value)
+{
+    Q_D(QJsonStreamWriter);
+    d->writeValue(nullptr, value);
+}
+
+/*!
+    \overload
+
+    Writes \a value as the member \a name of the current object.
+*/
+void QJsonStreamWriter::writeValue(const QString &name, const QJsonValue &value)
+{
+    Q_D(QJsonStreamWriter);
+    d->writeValue(&name, value);
+}
+
+/*!
+    Writes the current token of \a reader. Inside objects, the token's
+    QJsonStreamReader::name() is written as well. Nothing is written for
+    NoToken and Invalid tokens.
+*/
+void QJsonStreamWriter::writeCurrentToken(const QJsonStreamReader &reader)
+{
+    Q_D(QJsonStreamWriter);
+    const bool inObject = !d->stack.isEmpty() && d->stack.last().isObject;
+    const QString name = inObject ? reader.name() : QString();
+    const QString *namePtr = inObject ? &name : nullptr;
+    switch (reader.tokenType()) {
+    case QJsonStreamReader::StartObject:
+        d->startContainer(namePtr, true);
+        break;
+    case QJsonStreamReader::EndObject:
+        d->endContainer(true);
+        break;
+    case QJsonStreamReader::StartArray:
+        d->startContainer(namePtr, false);
+        break;
+    case QJsonStreamReader::EndArray:
+        d->endContainer(false);
+        break;
+    case QJsonStreamReader::String:
+        d->writeValue(namePtr, QJsonValue(reader.text()));
+        break;
+    case QJsonStreamReader::Number:
+        d->writeValue(namePtr, QJsonValue(reader.toDouble()));
+        break;
+    case QJsonStreamReader::Bool:
+        d->writeValue(namePtr, QJsonValue(reader.toBool()));
+        break;
+    case QJsonStreamReader::Null:
+        d->writeValue(namePtr, QJsonValue(QJsonValue::Null));
+        break;
+    case QJsonStreamReader::NoToken:
+    case QJsonStreamReader::Invalid:
+        break;
+    }
+}
+
+/*!
+    Writes the buffered output to the device.
+*/
+void QJsonStreamWriter::flush()
+{
+    Q_D(QJsonStreamWriter);
+    d->flush();
+}
+
+/*!
+    Returns \c true if writing to the device failed; otherwise returns
+    \c false.
+*/
+bool QJsonStreamWriter::hasError() const
+{
+    Q_D(const QJsonStreamWriter);
+    return d->hasError;
+}
+
+#endif // !QT_JSON_READONLY || Q_CLANG_QDOC
+
+QT_END_NAMESPACE
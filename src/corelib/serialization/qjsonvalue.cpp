@@ -134,6 +134,12 @@ QJsonValue::QJsonValue(QJsonPrivate::Data *data, QJsonPrivate::Base *base, const
     }
     case Array:
     case Object:
+        // documents validated lazily check each array and object here
+        if (!data->validateContainer(v.base(base), t == Object)) {
+            t = Undefined;
+            dbl = 0;
+            break;
+        }
         d = data;
         this->base = v.base(base);
         break;
@@ -56,7 +56,7 @@ static inline uchar hexdig(uint u)
     return (u < 0xa ? '0' + u : 'a' + u - 0xa);
 }
 
-static QByteArray escapedString(const QString &s)
+QByteArray Writer::escapedString(const QString &s)
 {
     const uchar replacement = '?';
     QByteArray ba(s.length(), Qt::Uninitialized);
@@ -121,6 +121,16 @@ static QByteArray escapedString(const QString &s)
     return ba;
 }
 
+void Writer::doubleToJson(double d, QByteArray &json)
+{
+    if (qIsFinite(d)) { // +2 to format to ensure the expected precision
+        const double abs = std::abs(d);
+        json += QByteArray::number(d, abs == static_cast<quint64>(abs) ? 'f' : 'g', QLocale::FloatingPointShortest);
+    } else {
+        json += "null"; // +INF || -INF || NaN (see RFC4627#section2.4)
+    }
+}
+
 static void valueToJson(const QJsonPrivate::Base *b, const QJsonPrivate::Value &v, QByteArray &json, int indent, bool compact)
 {
     QJsonValue::Type type = (QJsonValue::Type)(uint)v.type;
@@ -128,19 +138,12 @@ static void valueToJson(const QJsonPrivate::Base *b, const QJsonPrivate::Value &
     case QJsonValue::Bool:
         json += v.toBoolean() ? "true" : "false";
         break;
-    case QJsonValue::Double: {
-        const double d = v.toDouble(b);
-        if (qIsFinite(d)) { // +2 to format to ensure the expected precision
-            const double abs = std::abs(d);
-            json += QByteArray::number(d, abs == static_cast<quint64>(abs) ? 'f' : 'g', QLocale::FloatingPointShortest);
-        } else {
-            json += "null"; // +INF || -INF || NaN (see RFC4627#section2.4)
-        }
+    case QJsonValue::Double:
+        Writer::doubleToJson(v.toDouble(b), json);
         break;
-    }
     case QJsonValue::String:
         json += '"';
-        json += escapedString(v.toString(b));
+        json += Writer::escapedString(v.toString(b));
         json += '"';
         break;
     case QJsonValue::Array:
@@ -196,7 +199,7 @@ static void objectContentToJson(const QJsonPrivate::Object *o, QByteArray &json,
         QJsonPrivate::Entry *e = o->entryAt(i);
         json += indentString;
         json += '"';
-        json += escapedString(e->key());
+        json += Writer::escapedString(e->key());
         json += compact ? "\":" : "\": ";
         valueToJson(o, e->value, json, indent, compact);
 
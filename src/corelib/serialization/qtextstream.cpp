@@ -233,6 +233,7 @@ static const int QTEXTSTREAM_BUFFERSIZE = 16384;
 
 #include <locale.h>
 #include "private/qlocale_p.h"
+#include "private/qlocale_tools_p.h"
 
 #include <stdlib.h>
 #include <limits.h>
@@ -330,7 +331,8 @@ QTextStreamPrivate::QTextStreamPrivate(QTextStream *q_ptr)
     readConverterSavedState(0),
 #endif
     readConverterSavedStateOffset(0),
-    locale(QLocale::c())
+    locale(QLocale::c()),
+    cLocale(true)
 {
     this->q_ptr = q_ptr;
     reset();
@@ -1549,14 +1551,17 @@ QTextStream::RealNumberNotation QTextStream::realNumberNotation() const
     describes the number of fraction digits QTextStream should
     write when generating real numbers.
 
-    The precision cannot be a negative value. The default value is 6.
+    The precision cannot be a negative value, except for
+    QLocale::FloatingPointShortest (since Qt 5.12), which makes QTextStream
+    write the shortest representation that reads back as the same number.
+    The default value is 6.
 
     \sa realNumberPrecision(), setRealNumberNotation()
 */
 void QTextStream::setRealNumberPrecision(int precision)
 {
     Q_D(QTextStream);
-    if (precision < 0) {
+    if (precision < 0 && precision != QLocale::FloatingPointShortest) {
         qWarning("QTextStream::setRealNumberPrecision: Invalid precision (%d)", precision);
         d->params.realNumberPrecision = 6;
         return;
@@ -1861,12 +1866,16 @@ QTextStreamPrivate::NumberParsingStatus QTextStreamPrivate::getNumber(qulonglong
             ndigits++;
         }
         // Parse digits
+        const QChar group = locale.groupSeparator();
         QChar ch;
         while (getChar(&ch)) {
-            if (ch.isDigit()) {
+            if (ch.unicode() >= '0' && ch.unicode() <= '9') {
+                val *= 10;
+                val += ch.unicode() - '0';
+            } else if (ch.isDigit()) {
                 val *= 10;
                 val += ch.digitValue();
-            } else if (locale != QLocale::c() && ch == locale.groupSeparator()) {
+            } else if (!cLocale && ch == group) {
                 continue;
             } else {
                 ungetChar(ch);
@@ -2018,7 +2027,7 @@ bool QTextStreamPrivate::getReal(double *f)
             else if (lc == locale.negativeSign().toLower()
                      || lc == locale.positiveSign().toLower())
                 input = InputSign;
-            else if (locale != QLocale::c() // backward-compatibility
+            else if (!cLocale // backward-compatibility
                      && lc == locale.groupSeparator().toLower())
                 input = InputDigit; // well, it isn't a digit, but no one cares.
             else
@@ -2066,7 +2075,14 @@ bool QTextStreamPrivate::getReal(double *f)
         return true;
     }
     bool ok;
-    *f = locale.toDouble(QString::fromLatin1(buf), &ok);
+    if (cLocale) {
+        // the C locale accepts exactly what the state machine above
+        // let through, so there is no need to go through QString
+        int processed;
+        *f = asciiToDouble(buf, i, ok, processed);
+    } else {
+        *f = locale.toDouble(QString::fromLatin1(buf), &ok);
+    }
     return ok;
 }
 
@@ -2330,6 +2346,21 @@ QTextStream &QTextStream::operator>>(char *c)
  */
 void QTextStreamPrivate::putNumber(qulonglong number, bool negative)
 {
+    int base = params.integerBase ? params.integerBase : 10;
+    if (cLocale && base == 10) {
+        // Fast path: in the C locale only the sign flag affects how a
+        // decimal number is written, so format it right here.
+        char buffer[24]; // 20 digits of ULLONG_MAX and the sign
+        char *end = buffer + sizeof buffer;
+        char *p = qulltodec(end, number);
+        if (negative)
+            *--p = '-';
+        else if (params.numberFlags & QTextStream::ForceSign)
+            *--p = '+';
+        putString(QLatin1String(p, int(end - p)), true);
+        return;
+    }
+
     QString result;
 
     unsigned flags = 0;
@@ -2345,11 +2376,10 @@ void QTextStreamPrivate::putNumber(qulonglong number, bool negative)
 
     // add thousands group separators. For backward compatibility we
     // don't add a group separator for C locale.
-    if (locale != QLocale::c() && !locale.numberOptions().testFlag(QLocale::OmitGroupSeparator))
+    if (!cLocale && !locale.numberOptions().testFlag(QLocale::OmitGroupSeparator))
         flags |= QLocaleData::ThousandsGroup;
 
     const QLocaleData *dd = locale.d->m_data;
-    int base = params.integerBase ? params.integerBase : 10;
     if (negative && base == 10) {
         result = dd->longLongToString(-static_cast<qlonglong>(number), -1,
                                       base, -1, flags);
@@ -2546,7 +2576,7 @@ QTextStream &QTextStream::operator<<(double f)
     }
 
     uint flags = 0;
-    const QLocale::NumberOptions numberOptions = locale().numberOptions();
+    const QLocale::NumberOptions numberOptions = d->locale.numberOptions();
     if (numberFlags() & ShowBase)
         flags |= QLocaleData::ShowBase;
     if (numberFlags() & ForceSign)
@@ -2561,13 +2591,21 @@ QTextStream &QTextStream::operator<<(double f)
         // Only for backwards compatibility
         flags |= QLocaleData::AddTrailingZeroes | QLocaleData::ShowBase;
     }
-    if (locale() != QLocale::c() && !(numberOptions & QLocale::OmitGroupSeparator))
+    if (!d->cLocale && !(numberOptions & QLocale::OmitGroupSeparator))
         flags |= QLocaleData::ThousandsGroup;
     if (!(numberOptions & QLocale::OmitLeadingZeroInExponent))
         flags |= QLocaleData::ZeroPadExponent;
     if (numberOptions & QLocale::IncludeTrailingZeroesAfterDot)
         flags |= QLocaleData::AddTrailingZeroes;
 
+    if (d->cLocale) {
+        // format straight into a stack buffer, skipping the QString
+        QLocaleData::CharBuff buff;
+        QLocaleData::doubleToCLocale(f, d->params.realNumberPrecision, form, -1, flags, &buff);
+        d->putString(QLatin1String(buff.constData(), buff.size()), true);
+        return *this;
+    }
+
     const QLocaleData *dd = d->locale.d->m_data;
     QString num = dd->doubleToString(f, d->params.realNumberPrecision, form, -1, flags);
     d->putString(num, true);
@@ -3170,6 +3208,7 @@ void QTextStream::setLocale(const QLocale &locale)
 {
     Q_D(QTextStream);
     d->locale = locale;
+    d->cLocale = locale == QLocale::c();
 }
 
 /*!
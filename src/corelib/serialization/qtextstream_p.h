@@ -141,6 +141,7 @@ public:
 
     int lastTokenSize;
     bool deleteDevice;
+    bool cLocale; // locale == QLocale::c(), the case the number fast paths handle
 #ifndef QT_NO_TEXTCODEC
     bool autoDetectUnicode;
 #endif
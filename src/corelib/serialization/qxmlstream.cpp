@@ -858,6 +858,7 @@ void QXmlStreamReaderPrivate::init()
     namespaceProcessing = true;
     rawReadBuffer.clear();
     dataBuffer.clear();
+    dataBufferPos = 0;
     readBuffer.clear();
     tagStackStringStorageSize = initialTagStackStringStorageSize;
 
@@ -1141,6 +1142,32 @@ bool QXmlStreamReaderPrivate::scanAttType()
     return false;
 }
 
+/*!
+ \internal
+
+ Appends the run of characters at the read position for which \a accept
+ returns true to textBuffer in one go and returns its length. The fast
+ scanners call this so that ordinary characters don't have to go through
+ getChar() one at a time; anything that needs special treatment ends the run.
+ */
+template <typename Accept>
+inline int QXmlStreamReaderPrivate::fastScanRun(Accept accept)
+{
+    if (!putStack.isEmpty())
+        return 0;
+    const QChar *begin = readBuffer.constData() + readBufferPos;
+    const QChar *end = readBuffer.constData() + readBuffer.size();
+    const QChar *it = begin;
+    while (it != end && accept(it->unicode()))
+        ++it;
+    const int n = int(it - begin);
+    if (n) {
+        textBuffer.append(begin, n);
+        readBufferPos += n;
+    }
+    return n;
+}
+
 /*!
  \internal
 
@@ -1157,7 +1184,12 @@ inline int QXmlStreamReaderPrivate::fastScanLiteralContent()
 {
     int n = 0;
     uint c;
-    while ((c = getChar()) != StreamEOF) {
+    for (;;) {
+        n += fastScanRun([](ushort ch) {
+            return ch >= ' ' && ch != '&' && ch != '<' && ch != '\"' && ch != '\'' && ch < 0xfffe;
+        });
+        if ((c = getChar()) == StreamEOF)
+            break;
         switch (ushort(c)) {
         case 0xfffe:
         case 0xffff:
@@ -1240,7 +1272,15 @@ inline int QXmlStreamReaderPrivate::fastScanContentCharList()
 {
     int n = 0;
     uint c;
-    while ((c = getChar()) != StreamEOF) {
+    for (;;) {
+        if (int run = fastScanRun([](ushort ch) {
+                return ch >= ' ' && ch != '&' && ch != '<' && ch != ']' && ch < 0xfffe; })) {
+            n += run;
+            for (int i = textBuffer.size() - run; isWhitespace && i < textBuffer.size(); ++i)
+                isWhitespace = textBuffer.at(i) == QLatin1Char(' ');
+        }
+        if ((c = getChar()) == StreamEOF)
+            break;
         switch (ushort(c)) {
         case 0xfffe:
         case 0xffff:
@@ -1304,7 +1344,13 @@ inline int QXmlStreamReaderPrivate::fastScanName(int *prefix)
 {
     int n = 0;
     uint c;
-    while ((c = getChar()) != StreamEOF) {
+    for (;;) {
+        n += fastScanRun([](ushort ch) {
+            return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9')
+                    || ch == '_' || ch == '-' || ch == '.' || ch >= 0x80;
+        });
+        if ((c = getChar()) == StreamEOF)
+            break;
         switch (c) {
         case '\n':
         case ' ':
@@ -1491,12 +1537,17 @@ uint QXmlStreamReaderPrivate::getChar_helper()
         int nbytesreadOrMinus1 = device->read(rawReadBuffer.data() + nbytesread, BUFFER_SIZE - nbytesread);
         nbytesread += qMax(nbytesreadOrMinus1, 0);
     } else {
-        if (nbytesread)
-            rawReadBuffer += dataBuffer;
-        else
-            rawReadBuffer = dataBuffer;
-        nbytesread = rawReadBuffer.size();
-        dataBuffer.clear();
+        // decode the added data in pieces too, so that a large document
+        // doesn't have to be held in memory a second time as UTF-16
+        const int chunk = qMin(dataBuffer.size() - dataBufferPos, BUFFER_SIZE - int(nbytesread));
+        rawReadBuffer.resize(int(nbytesread) + chunk);
+        memcpy(rawReadBuffer.data() + nbytesread, dataBuffer.constData() + dataBufferPos, chunk);
+        nbytesread += chunk;
+        dataBufferPos += chunk;
+        if (dataBufferPos == dataBuffer.size()) {
+            dataBuffer.clear();
+            dataBufferPos = 0;
+        }
     }
     if (!nbytesread) {
         atEnd = true;
@@ -252,6 +252,7 @@ public:
 
     QByteArray rawReadBuffer;
     QByteArray dataBuffer;
+    int dataBufferPos;
     uchar firstByte;
     qint64 nbytesread;
     QString readBuffer;
@@ -497,6 +498,7 @@ public:
     // not very well suited for scanning fast
     int fastScanLiteralContent();
     int fastScanSpace();
+    template <typename Accept> inline int fastScanRun(Accept accept);
     int fastScanContentCharList();
     int fastScanName(int *prefix = 0);
     inline int fastScanNMTOKEN();
@@ -47,6 +47,8 @@
 
 QT_REQUIRE_CONFIG(future);
 
+#include <QtCore/qfuture_impl.h>
+
 QT_BEGIN_NAMESPACE
 
 
@@ -101,6 +103,16 @@ public:
     operator T() const { return result(); }
     QList<T> results() const { return d.results(); }
 
+    template <class Function>
+    QFuture<typename QtPrivate::ContinuationTraits<Function, T>::Result> then(Function &&function)
+    { return QtPrivate::continueWith<T>(d, QtPrivate::ContinuationLauncher(), std::forward<Function>(function)); }
+    template <class Function>
+    QFuture<typename QtPrivate::ContinuationTraits<Function, T>::Result> then(QThreadPool *pool, Function &&function)
+    { return QtPrivate::continueWith<T>(d, QtPrivate::continuationLauncher(pool), std::forward<Function>(function)); }
+    template <class Function>
+    QFuture<typename QtPrivate::ContinuationTraits<Function, T>::Result> then(QObject *context, Function &&function)
+    { return QtPrivate::continueWith<T>(d, QtPrivate::continuationLauncher(context), std::forward<Function>(function)); }
+
     class const_iterator
     {
     public:
@@ -225,6 +237,16 @@ public:
     QString progressText() const { return d.progressText(); }
     void waitForFinished() { d.waitForFinished(); }
 
+    template <class Function>
+    QFuture<typename QtPrivate::ContinuationTraits<Function, void>::Result> then(Function &&function)
+    { return QtPrivate::continueWith<void>(d, QtPrivate::ContinuationLauncher(), std::forward<Function>(function)); }
+    template <class Function>
+    QFuture<typename QtPrivate::ContinuationTraits<Function, void>::Result> then(QThreadPool *pool, Function &&function)
+    { return QtPrivate::continueWith<void>(d, QtPrivate::continuationLauncher(pool), std::forward<Function>(function)); }
+    template <class Function>
+    QFuture<typename QtPrivate::ContinuationTraits<Function, void>::Result> then(QObject *context, Function &&function)
+    { return QtPrivate::continueWith<void>(d, QtPrivate::continuationLauncher(context), std::forward<Function>(function)); }
+
 private:
     friend class QFutureWatcher<void>;
 
@@ -245,6 +267,58 @@ QFuture<void> qToVoidFuture(const QFuture<T> &future)
     return QFuture<void>(future.d);
 }
 
+namespace QtFuture {
+
+template <typename T>
+struct WhenAnyResult
+{
+    int index;
+    QFuture<T> future;
+};
+
+template <typename T>
+QFuture<QList<QFuture<T> > > whenAll(const QList<QFuture<T> > &futures)
+{
+    typedef QtPrivate::WhenAllContext<T> Context;
+    std::shared_ptr<Context> context = std::make_shared<Context>(futures);
+    context->promise.reportStarted();
+    QFuture<QList<QFuture<T> > > all = context->promise.future();
+    if (futures.isEmpty()) {
+        context->promise.reportResult(futures);
+        context->promise.reportFinished();
+        return all;
+    }
+    for (QFuture<T> future : futures)
+        future.then([context](const QFuture<T> &) { context->arrived(); });
+    return all;
+}
+
+template <typename T>
+QFuture<WhenAnyResult<T> > whenAny(const QList<QFuture<T> > &futures)
+{
+    typedef QtPrivate::WhenAnyContext<WhenAnyResult<T> > Context;
+    std::shared_ptr<Context> context = std::make_shared<Context>();
+    context->promise.reportStarted();
+    QFuture<WhenAnyResult<T> > any = context->promise.future();
+    if (futures.isEmpty()) {
+        context->promise.reportResult(WhenAnyResult<T>{ -1, QFuture<T>() });
+        context->promise.reportFinished();
+        return any;
+    }
+    for (int i = 0; i < futures.size(); ++i) {
+        QFuture<T> future = futures.at(i);
+        future.then([context, i](const QFuture<T> &finished) {
+            if (context->done.testAndSetRelaxed(0, 1)) {
+                context->promise.reportResult(WhenAnyResult<T>{ i, finished });
+                context->promise.reportFinished();
+            }
+        });
+    }
+    return any;
+}
+
+} // namespace QtFuture
+
 QT_END_NAMESPACE
 
 #endif // QFUTURE_H
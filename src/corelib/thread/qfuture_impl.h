@@ -0,0 +1,258 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef Q_QDOC
+
+#ifndef QFUTURE_H
+#error Do not include qfuture_impl.h directly
+#endif
+
+#if 0
+#pragma qt_sync_skip_header_check
+#pragma qt_sync_stop_processing
+#endif
+
+#include <functional>
+#include <memory>
+#include <type_traits>
+
+QT_BEGIN_NAMESPACE
+
+class QObject;
+class QThreadPool;
+
+namespace QtPrivate {
+    /*
+        Schedules a continuation once the future it is attached to has
+        finished. An empty launcher runs the continuation right away, in the
+        thread that finished the future.
+    */
+    typedef std::function<void(std::function<void()>)> ContinuationLauncher;
+    Q_CORE_EXPORT ContinuationLauncher continuationLauncher(QThreadPool *pool);
+    Q_CORE_EXPORT ContinuationLauncher continuationLauncher(QObject *context);
+    Q_CORE_EXPORT void propagateCancellation(const QFutureInterfaceBase &from, QFutureInterfaceBase &to);
+
+    template <typename Function, typename Arg>
+    struct IsInvocableWith
+    {
+        template <typename F>
+        static auto test(int) -> decltype(std::declval<F>()(std::declval<Arg>()), std::true_type());
+        template <typename F>
+        static std::false_type test(...);
+        enum { Value = decltype(test<Function>(0))::value };
+    };
+    template <typename Function>
+    struct IsInvocableWith<Function, void>
+    {
+        template <typename F>
+        static auto test(int) -> decltype(std::declval<F>()(), std::true_type());
+        template <typename F>
+        static std::false_type test(...);
+        enum { Value = decltype(test<Function>(0))::value };
+    };
+
+    /*
+        A continuation either takes the result of the future it is attached
+        to (nothing for QFuture<void>), or the future itself. Only the latter
+        is invoked when the future was canceled.
+    */
+    template <typename T, bool TakesFuture>
+    struct ContinuationArgs
+    {
+        template <typename Function>
+        static auto call(Function &function, const QFutureInterfaceBase &parent)
+            -> decltype(function(std::declval<const T &>()))
+        { return function(QFutureInterface<T>(parent).resultReference(0)); }
+    };
+    template <>
+    struct ContinuationArgs<void, false>
+    {
+        template <typename Function>
+        static auto call(Function &function, const QFutureInterfaceBase &)
+            -> decltype(function())
+        { return function(); }
+    };
+    template <typename T>
+    struct ContinuationArgs<T, true>
+    {
+        template <typename Function>
+        static auto call(Function &function, const QFutureInterfaceBase &parent)
+            -> decltype(function(std::declval<QFuture<T>>()))
+        {
+            QFutureInterface<T> future(parent);
+            return function(QFuture<T>(&future));
+        }
+    };
+
+    template <typename Function, typename T>
+    struct ContinuationTraits
+    {
+        typedef typename std::decay<Function>::type Type;
+        enum { TakesFuture = !IsInvocableWith<Type, const T &>::Value };
+        typedef ContinuationArgs<T, TakesFuture> Args;
+        typedef typename std::decay<decltype(Args::call(std::declval<Type &>(),
+                                                        std::declval<const QFutureInterfaceBase &>()))>::type Result;
+    };
+    template <typename Function>
+    struct ContinuationTraits<Function, void>
+    {
+        typedef typename std::decay<Function>::type Type;
+        enum { TakesFuture = !IsInvocableWith<Type, void>::Value };
+        typedef ContinuationArgs<void, TakesFuture> Args;
+        typedef typename std::decay<decltype(Args::call(std::declval<Type &>(),
+                                                        std::declval<const QFutureInterfaceBase &>()))>::type Result;
+    };
+
+    template <typename R>
+    struct ContinuationReport
+    {
+        template <typename Args, typename Function>
+        static void run(Function &function, const QFutureInterfaceBase &parent, QFutureInterface<R> &promise)
+        { promise.reportResult(Args::call(function, parent)); }
+    };
+    template <>
+    struct ContinuationReport<void>
+    {
+        template <typename Args, typename Function>
+        static void run(Function &function, const QFutureInterfaceBase &parent, QFutureInterface<void> &)
+        { Args::call(function, parent); }
+    };
+
+    template <typename Function, typename T>
+    class Continuation
+    {
+        typedef ContinuationTraits<Function, T> Traits;
+        typedef typename Traits::Result R;
+    public:
+        template <typename F>
+        Continuation(F &&function, const QFutureInterface<R> &promise)
+            : function(std::forward<F>(function)), promise(promise)
+        { }
+        ~Continuation()
+        {
+            // dropped without running, e.g. because its context object was
+            // destroyed or the future it was attached to was never finished
+            if (!promise.isFinished()) {
+                promise.reportCanceled();
+                promise.reportFinished();
+            }
+        }
+
+        void run(const QFutureInterfaceBase &parent)
+        {
+            if (promise.isCanceled()) {
+                promise.reportFinished();
+                return;
+            }
+            if (!Traits::TakesFuture
+                    && (parent.isCanceled() || (!std::is_void<T>::value && parent.resultCount() == 0))) {
+                propagateCancellation(parent, promise);
+                promise.reportFinished();
+                return;
+            }
+#ifndef QT_NO_EXCEPTIONS
+            try {
+#endif
+                ContinuationReport<R>::template run<typename Traits::Args>(function, parent, promise);
+#ifndef QT_NO_EXCEPTIONS
+            } catch (QException &e) {
+                promise.reportException(e);
+            } catch (...) {
+                promise.reportException(QUnhandledException());
+            }
+#endif
+            promise.reportFinished();
+        }
+
+    private:
+        typename Traits::Type function;
+        QFutureInterface<R> promise;
+    };
+
+    template <typename T, typename Function>
+    QFuture<typename ContinuationTraits<Function, T>::Result>
+    continueWith(QFutureInterfaceBase &parent, const ContinuationLauncher &launch, Function &&function)
+    {
+        typedef Continuation<typename std::decay<Function>::type, T> C;
+        QFutureInterface<typename ContinuationTraits<Function, T>::Result> promise;
+        promise.reportStarted();
+        std::shared_ptr<C> continuation = std::make_shared<C>(std::forward<Function>(function), promise);
+        parent.addContinuation([continuation, launch](const QFutureInterfaceBase &parent) {
+            if (!launch) {
+                continuation->run(parent);
+                return;
+            }
+            // keeps the results alive until the continuation has run
+            QFutureInterface<T> finished(parent);
+            launch([continuation, finished]() { continuation->run(finished); });
+        });
+        return promise.future();
+    }
+
+    template <typename T>
+    struct WhenAllContext
+    {
+        explicit WhenAllContext(const QList<QFuture<T> > &futures)
+            : futures(futures), remaining(futures.size())
+        { }
+
+        void arrived()
+        {
+            if (!remaining.deref()) {
+                promise.reportResult(futures);
+                promise.reportFinished();
+            }
+        }
+
+        QList<QFuture<T> > futures;
+        QAtomicInt remaining;
+        QFutureInterface<QList<QFuture<T> > > promise;
+    };
+
+    template <typename Result>
+    struct WhenAnyContext
+    {
+        QAtomicInt done;
+        QFutureInterface<Result> promise;
+    };
+}
+
+QT_END_NAMESPACE
+
+#endif
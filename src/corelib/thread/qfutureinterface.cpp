@@ -42,6 +42,7 @@
 #include "qfutureinterface_p.h"
 
 #include <QtCore/qatomic.h>
+#include <QtCore/qpointer.h>
 #include <QtCore/qthread.h>
 #include <private/qthreadpool_p.h>
 
@@ -68,6 +69,56 @@ public:
 } // unnamed namespace
 
 
+namespace {
+class ContinuationRunnable : public QRunnable
+{
+public:
+    explicit ContinuationRunnable(std::function<void()> job)
+        : job(std::move(job))
+    { }
+    void run() override { job(); }
+private:
+    std::function<void()> job;
+};
+} // unnamed namespace
+
+namespace QtPrivate {
+
+ContinuationLauncher continuationLauncher(QThreadPool *pool)
+{
+    return [pool](std::function<void()> job) {
+        QThreadPool *threadPool = pool ? pool : QThreadPool::globalInstance();
+        threadPool->start(new ContinuationRunnable(std::move(job)));
+    };
+}
+
+// If the context object is gone by the time the future finishes, or before
+// the queued call is delivered, the job is destroyed without running. That
+// cancels the continuation's future.
+ContinuationLauncher continuationLauncher(QObject *context)
+{
+    QPointer<QObject> guard(context);
+    return [guard](std::function<void()> job) {
+        if (QObject *context = guard.data())
+            QMetaObject::invokeMethod(context, std::move(job), Qt::QueuedConnection);
+    };
+}
+
+void propagateCancellation(const QFutureInterfaceBase &from, QFutureInterfaceBase &to)
+{
+#ifndef QT_NO_EXCEPTIONS
+    QFutureInterfaceBase source(from);
+    QtPrivate::ExceptionStore &store = source.exceptionStore();
+    if (store.hasException()) {
+        to.reportException(*store.exception().exception());
+        return;
+    }
+#endif
+    to.reportCanceled();
+}
+
+} // namespace QtPrivate
+
 QFutureInterfaceBase::QFutureInterfaceBase(State initialState)
     : d(new QFutureInterfaceBasePrivate(initialState))
 { }
@@ -290,7 +341,29 @@ void QFutureInterfaceBase::reportFinished()
         switch_from_to(d->state, Running, Finished);
         d->waitCondition.wakeAll();
         d->sendCallOut(QFutureCallOutEvent(QFutureCallOutEvent::Finished));
+
+        // Continuations may attach further continuations to this future, or
+        // finish other futures, so they are run without holding the lock.
+        const QVector<std::function<void(const QFutureInterfaceBase &)>> continuations
+                = std::move(d->continuations);
+        d->continuations.clear();
+        locker.unlock();
+        for (const auto &continuation : continuations)
+            continuation(*this);
+    }
+}
+
+// Runs \a continuation once this future has finished, in the thread that
+// finishes it, or right away if it already has.
+void QFutureInterfaceBase::addContinuation(std::function<void(const QFutureInterfaceBase &)> continuation)
+{
+    QMutexLocker locker(&d->m_mutex);
+    if (!isFinished()) {
+        d->continuations.append(std::move(continuation));
+        return;
     }
+    locker.unlock();
+    continuation(*this);
 }
 
 void QFutureInterfaceBase::setExpectedResultCount(int resultCount)
@@ -45,6 +45,8 @@
 #include <QtCore/qexception.h>
 #include <QtCore/qresultstore.h>
 
+#include <functional>
+
 QT_REQUIRE_CONFIG(future);
 
 QT_BEGIN_NAMESPACE
@@ -126,6 +128,8 @@ public:
     inline bool operator!=(const QFutureInterfaceBase &other) const { return d != other.d; }
     QFutureInterfaceBase &operator=(const QFutureInterfaceBase &other);
 
+    void addContinuation(std::function<void(const QFutureInterfaceBase &)> continuation);
+
 protected:
     bool refT() const;
     bool derefT() const;
@@ -155,6 +159,11 @@ public:
     {
         refT();
     }
+    explicit QFutureInterface(const QFutureInterfaceBase &dd) // internal
+        : QFutureInterfaceBase(dd)
+    {
+        refT();
+    }
     ~QFutureInterface()
     {
         if (!derefT())
@@ -281,6 +290,9 @@ public:
     explicit QFutureInterface<void>(State initialState = NoState)
         : QFutureInterfaceBase(initialState)
     { }
+    explicit QFutureInterface<void>(const QFutureInterfaceBase &dd) // internal
+        : QFutureInterfaceBase(dd)
+    { }
 
     static QFutureInterface<void> canceledResult()
     { return QFutureInterface(State(Started | Finished | Canceled)); }
@@ -89,6 +89,7 @@ QThreadData::~QThreadData()
     thread = 0;
     delete t;
 
+    postEventList.addIncomingEvents();
     for (int i = 0; i < postEventList.size(); ++i) {
         const QPostEvent &pe = postEventList.at(i);
         if (pe.event) {
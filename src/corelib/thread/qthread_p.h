@@ -115,10 +115,98 @@ public:
 
     QMutex mutex;
 
+    // Events posted without locking the mutex (see
+    // QCoreApplicationPrivate::postMetaCallEvent()), the most recent one
+    // first. The thread holding the mutex moves them into the list with
+    // addIncomingEvents() before it looks at the list.
+    QAtomicPointer<QPostEventNode> incoming;
+
+    // number of threads between choosing this list and pushing onto it,
+    // plus PushersBlocked while the holder of the mutex waits for them
+    QAtomicInt pushers;
+    enum { PushersBlocked = 0x40000000 };
+
     inline QPostEventList()
         : QVector<QPostEvent>(), recursion(0), startOffset(0), insertionOffset(0)
     { }
 
+    ~QPostEventList()
+    {
+        Q_ASSERT(!incoming.load());
+    }
+
+    // lock-free, may be called from any thread
+    void push(QPostEventNode *node)
+    {
+        QPostEventNode *head = incoming.load();
+        do {
+            node->next = head;
+        } while (!incoming.testAndSetRelease(head, node, head));
+    }
+
+    bool hasIncomingEvents() const
+    {
+        return incoming.loadAcquire() != nullptr;
+    }
+
+    // must be called with the mutex locked
+    void addIncomingEvents()
+    {
+        if (!hasIncomingEvents())
+            return;
+
+        // reverse the stack, so that the events get added in posting order
+        QPostEventNode *node = incoming.fetchAndStoreAcquire(nullptr);
+        QPostEventNode *ordered = nullptr;
+        while (node) {
+            QPostEventNode *next = node->next;
+            node->next = ordered;
+            ordered = node;
+            node = next;
+        }
+
+        while (ordered) {
+            QObjectPrivate *d = QObjectPrivate::get(ordered->receiver);
+            addEvent(QPostEvent(ordered->receiver, ordered->event, Qt::NormalEventPriority));
+            ++d->postedEvents;
+            d->incomingEvents.deref();
+            ordered = ordered->next;
+        }
+    }
+
+    // Returns \c false if pushers are blocked; the caller should then wait
+    // for the mutex and try again.
+    bool addPusher()
+    {
+        if (pushers.fetchAndAddOrdered(1) & PushersBlocked) {
+            pushers.deref();
+            return false;
+        }
+        return true;
+    }
+
+    void removePusher()
+    {
+        pushers.deref();
+    }
+
+    // Keeps new pushers out and waits until the ones that already chose this
+    // list are done, so that every event they push is incoming. Only the
+    // threads in the middle of pushing are waited for, and they never block,
+    // so this can't starve. Must be called with the mutex locked.
+    void blockPushers()
+    {
+        if (pushers.fetchAndAddOrdered(PushersBlocked) == 0)
+            return;
+        while (pushers.loadAcquire() != PushersBlocked)
+            QThread::yieldCurrentThread();
+    }
+
+    void unblockPushers()
+    {
+        pushers.fetchAndAddRelease(-PushersBlocked);
+    }
+
     void addEvent(const QPostEvent &ev) {
         int priority = ev.priority;
         if (isEmpty() ||
@@ -252,7 +340,7 @@ public:
     bool canWaitLocked()
     {
         QMutexLocker locker(&postEventList.mutex);
-        return canWait;
+        return canWait && !postEventList.hasIncomingEvents();
     }
 
     // This class provides per-thread (by way of being a QThreadData
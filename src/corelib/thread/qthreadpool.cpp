@@ -59,11 +59,24 @@ public:
     void run() override;
     void registerThreadInactive();
 
+    void pushLocal(QRunnable *runnable);
+    QRunnable *popLocal();
+    QRunnable *stealLocal();
+
     QWaitCondition runnableReady;
     QThreadPoolPrivate *manager;
     QRunnable *runnable;
+
+    // the runnables started from this thread when work stealing, newest
+    // last; this thread takes them from the back, others from the front
+    QMutex localMutex;
+    QList<QRunnable *> localQueue;
 };
 
+#if defined(Q_COMPILER_THREAD_LOCAL)
+static thread_local QThreadPoolThread *runningPoolThread = nullptr;
+#endif
+
 /*
     QThreadPool private class.
 */
@@ -83,6 +96,9 @@ QThreadPoolThread::QThreadPoolThread(QThreadPoolPrivate *manager)
 */
 void QThreadPoolThread::run()
 {
+#if defined(Q_COMPILER_THREAD_LOCAL)
+    runningPoolThread = this;
+#endif
     QMutexLocker locker(&manager->mutex);
     for(;;) {
         QRunnable *r = runnable;
@@ -108,22 +124,39 @@ void QThreadPoolThread::run()
                     throw;
                 }
 #endif
-                locker.relock();
+                if (autoDelete) {
+                    // the count is guarded by the mutex
+                    locker.relock();
+                    if (!--r->ref)
+                        delete r;
+                }
 
-                if (autoDelete && !--r->ref)
-                    delete r;
+                // the runnables started from this thread come before the
+                // queued ones, unless those have a higher priority
+                if (!manager->urgentRunnables.load() && (r = popLocal()))
+                    continue;
+
+                locker.relock();
             }
 
             // if too many threads are active, expire this thread
-            if (manager->tooManyThreadsActive())
+            if (manager->tooManyThreadsActive()) {
+                manager->enqueueLocal(this);
                 break;
+            }
 
             if (manager->queue.isEmpty()) {
-                r = nullptr;
-                break;
+                r = popLocal();
+                if (!r)
+                    r = manager->stealLocal();
+                if (!r)
+                    break;
+                continue;
             }
 
             QueuePage *page = manager->queue.first();
+            if (page->priority() > 0)
+                manager->urgentRunnables.deref();
             r = page->pop();
 
             if (page->isFinished()) {
@@ -141,19 +174,29 @@ void QThreadPoolThread::run()
         bool expired = manager->tooManyThreadsActive();
         if (!expired) {
             manager->waitingThreads.enqueue(this);
+            manager->idleThreads.ref();
             registerThreadInactive();
-            // wait for work, exiting after the expiry timeout is reached
-            runnableReady.wait(locker.mutex(), manager->expiryTimeout);
+            // wait for work, exiting after the expiry timeout is reached. Don't
+            // wait if a thread started a runnable locally without seeing us
+            // idle (see QThreadPoolPrivate::startLocal())
+            if (!manager->localRunnables.fetchAndAddOrdered(0))
+                runnableReady.wait(locker.mutex(), manager->expiryTimeout);
             ++manager->activeThreads;
-            if (manager->waitingThreads.removeOne(this))
-                expired = true;
+            if (manager->waitingThreads.removeOne(this)) {
+                manager->idleThreads.deref();
+                expired = !manager->localRunnables.load();
+            }
         }
         if (expired) {
             manager->expiredThreads.enqueue(this);
+            manager->atCapacity.store(false);
             registerThreadInactive();
             break;
         }
     }
+#if defined(Q_COMPILER_THREAD_LOCAL)
+    runningPoolThread = nullptr;
+#endif
 }
 
 void QThreadPoolThread::registerThreadInactive()
@@ -162,6 +205,45 @@ void QThreadPoolThread::registerThreadInactive()
         manager->noActiveThreads.wakeAll();
 }
 
+/*
+    \internal
+    Only called from this thread.
+*/
+void QThreadPoolThread::pushLocal(QRunnable *runnable)
+{
+    QMutexLocker locker(&localMutex);
+    localQueue.append(runnable);
+}
+
+/*
+    \internal
+    Only called from this thread.
+*/
+QRunnable *QThreadPoolThread::popLocal()
+{
+    if (!manager->localRunnables.load())
+        return nullptr;
+
+    QMutexLocker locker(&localMutex);
+    if (localQueue.isEmpty())
+        return nullptr;
+    manager->localRunnables.deref();
+    return localQueue.takeLast();
+}
+
+/*
+    \internal
+    Called from the other threads, with the manager's mutex locked.
+*/
+QRunnable *QThreadPoolThread::stealLocal()
+{
+    QMutexLocker locker(&localMutex);
+    if (localQueue.isEmpty())
+        return nullptr;
+    manager->localRunnables.deref();
+    return localQueue.takeFirst();
+}
+
 
 /*
     \internal
@@ -186,6 +268,7 @@ bool QThreadPoolPrivate::tryStart(QRunnable *task)
         // recycle an available thread
         enqueueTask(task);
         waitingThreads.takeFirst()->runnableReady.wakeOne();
+        idleThreads.deref();
         return true;
     }
 
@@ -218,14 +301,19 @@ void QThreadPoolPrivate::enqueueTask(QRunnable *runnable, int priority)
     Q_ASSERT(runnable != nullptr);
     if (runnable->autoDelete())
         ++runnable->ref;
+    if (priority > 0)
+        urgentRunnables.ref();
 
-    for (QueuePage *page : qAsConst(queue)) {
+    // pages are sorted by priority and only the last page of a given
+    // priority can have room left, so there is no need to scan the queue
+    auto it = std::upper_bound(queue.constBegin(), queue.constEnd(), priority, comparePriority);
+    if (it != queue.constBegin()) {
+        QueuePage *page = *(it - 1);
         if (page->priority() == priority && !page->isFull()) {
             page->push(runnable);
             return;
         }
     }
-    auto it = std::upper_bound(queue.constBegin(), queue.constEnd(), priority, comparePriority);
     queue.insert(std::distance(queue.constBegin(), it), new QueuePage(runnable, priority));
 }
 
@@ -245,6 +333,8 @@ void QThreadPoolPrivate::tryToStartMoreThreads()
         if (!tryStart(page->first()))
             break;
 
+        if (page->priority() > 0)
+            urgentRunnables.deref();
         page->pop();
 
         if (page->isFinished()) {
@@ -304,7 +394,9 @@ void QThreadPoolPrivate::reset()
     }
 
     waitingThreads.clear();
+    idleThreads.store(0);
     expiredThreads.clear();
+    atCapacity.store(false);
 
     isExiting = false;
 }
@@ -338,6 +430,95 @@ void QThreadPoolPrivate::clear()
     }
     qDeleteAll(queue);
     queue.clear();
+    urgentRunnables.store(0);
+
+    while (QRunnable *r = stealLocal()) {
+        if (r->autoDelete() && !--r->ref)
+            delete r;
+    }
+}
+
+/*!
+    \internal
+    Returns the pool thread this function is called from, or \nullptr if it
+    isn't one of this pool's threads.
+*/
+QThreadPoolThread *QThreadPoolPrivate::currentPoolThread() const
+{
+#if defined(Q_COMPILER_THREAD_LOCAL)
+    QThreadPoolThread *thread = runningPoolThread;
+    if (thread && thread->manager == this)
+        return thread;
+#endif
+    return nullptr;
+}
+
+/*!
+    \internal
+    Puts \a runnable, started from the pool thread \a thread, on that
+    thread's local queue. This only locks the mutex to count a reference to
+    an auto-deleting runnable, or if there are idle threads to wake or
+    threads to start to help with the local queues.
+*/
+void QThreadPoolPrivate::startLocal(QThreadPoolThread *thread, QRunnable *runnable)
+{
+    if (runnable->autoDelete()) {
+        // QRunnable's count is a plain int, guarded by the mutex
+        QMutexLocker locker(&mutex);
+        ++runnable->ref;
+    }
+    localRunnables.ref();
+    thread->pushLocal(runnable);
+
+    // pairs with the check in QThreadPoolThread::run() before waiting
+    if (!idleThreads.fetchAndAddOrdered(0) && atCapacity.load())
+        return;
+
+    QMutexLocker locker(&mutex);
+    if (!waitingThreads.isEmpty()) {
+        // it steals the runnable
+        waitingThreads.takeFirst()->runnableReady.wakeOne();
+        idleThreads.deref();
+    } else if (activeThreadCount() < maxThreadCount) {
+        // hand it to another thread
+        if (QRunnable *r = thread->stealLocal()) {
+            if (r->autoDelete())
+                --r->ref; // tryStart() counts it again
+            tryStart(r);
+        }
+    } else {
+        atCapacity.store(true);
+    }
+}
+
+/*!
+    \internal
+    Steals a runnable from the local queue of one of the pool threads, with
+    the mutex locked.
+*/
+QRunnable *QThreadPoolPrivate::stealLocal()
+{
+    if (!localRunnables.load())
+        return nullptr;
+    for (QThreadPoolThread *thread : qAsConst(allThreads)) {
+        if (QRunnable *r = thread->stealLocal())
+            return r;
+    }
+    return nullptr;
+}
+
+/*!
+    \internal
+    Moves the runnables from the local queue of \a thread to the queue, with
+    the mutex locked.
+*/
+void QThreadPoolPrivate::enqueueLocal(QThreadPoolThread *thread)
+{
+    while (QRunnable *r = thread->stealLocal()) {
+        if (r->autoDelete())
+            --r->ref; // enqueueTask() counts it again
+        enqueueTask(r);
+    }
 }
 
 /*!
@@ -368,6 +549,8 @@ bool QThreadPool::tryTake(QRunnable *runnable)
 
         for (QueuePage *page : qAsConst(d->queue)) {
             if (page->tryTake(runnable)) {
+                if (page->priority() > 0)
+                    d->urgentRunnables.deref();
                 if (page->isFinished()) {
                     d->queue.removeOne(page);
                     delete page;
@@ -377,6 +560,18 @@ bool QThreadPool::tryTake(QRunnable *runnable)
                 return true;
             }
         }
+
+        if (d->localRunnables.load()) {
+            for (QThreadPoolThread *thread : qAsConst(d->allThreads)) {
+                QMutexLocker localLocker(&thread->localMutex);
+                if (thread->localQueue.removeOne(runnable)) {
+                    d->localRunnables.deref();
+                    if (runnable->autoDelete())
+                        --runnable->ref; // undo ++ref in start()
+                    return true;
+                }
+            }
+        }
     }
 
     return false;
@@ -500,12 +695,21 @@ void QThreadPool::start(QRunnable *runnable, int priority)
         return;
 
     Q_D(QThreadPool);
+    if (priority == 0 && d->workStealing.load()) {
+        if (QThreadPoolThread *thread = d->currentPoolThread()) {
+            d->startLocal(thread, runnable);
+            return;
+        }
+    }
+
     QMutexLocker locker(&d->mutex);
     if (!d->tryStart(runnable)) {
         d->enqueueTask(runnable, priority);
 
-        if (!d->waitingThreads.isEmpty())
+        if (!d->waitingThreads.isEmpty()) {
             d->waitingThreads.takeFirst()->runnableReady.wakeOne();
+            d->idleThreads.deref();
+        }
     }
 }
 
@@ -594,6 +798,7 @@ void QThreadPool::setMaxThreadCount(int maxThreadCount)
         return;
 
     d->maxThreadCount = maxThreadCount;
+    d->atCapacity.store(false);
     d->tryToStartMoreThreads();
 }
 
@@ -659,6 +864,41 @@ uint QThreadPool::stackSize() const
     return d->stackSize;
 }
 
+/*! \property QThreadPool::workStealingEnabled
+
+    This property holds whether runnables started from the thread pool's own
+    threads are queued per thread.
+
+    When enabled, a runnable that one of the pool's threads passes to start()
+    with the default priority does not go through the pool's shared queue.
+    It is queued for the thread that started it instead, which runs it after
+    the runnable it is currently running, before the runnables in the shared
+    queue that don't have a higher priority. Threads that run out of work take
+    runnables from the other threads' queues. This avoids contention on the
+    shared queue when many short runnables are started from within other
+    runnables, as parallel algorithms do, at the cost of running them in an
+    order that is less predictable. The pool still locks briefly to count
+    the references to runnables that have \l{QRunnable::}{autoDelete()} set.
+
+    Runnables started from other threads, with a priority other than 0, or
+    with tryStart() are not affected.
+
+    The default value is \c false.
+
+    \since 5.12
+*/
+void QThreadPool::setWorkStealingEnabled(bool enabled)
+{
+    Q_D(QThreadPool);
+    d->workStealing.store(enabled);
+}
+
+bool QThreadPool::isWorkStealingEnabled() const
+{
+    Q_D(const QThreadPool);
+    return d->workStealing.load();
+}
+
 /*!
     Releases a thread previously reserved by a call to reserveThread().
 
@@ -676,6 +916,7 @@ void QThreadPool::releaseThread()
     Q_D(QThreadPool);
     QMutexLocker locker(&d->mutex);
     --d->reservedThreads;
+    d->atCapacity.store(false);
     d->tryToStartMoreThreads();
 }
 
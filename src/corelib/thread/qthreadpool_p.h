@@ -167,6 +167,11 @@ public:
     void stealAndRunRunnable(QRunnable *runnable);
     void deletePageIfFinished(QueuePage *page);
 
+    QThreadPoolThread *currentPoolThread() const;
+    void startLocal(QThreadPoolThread *thread, QRunnable *runnable);
+    QRunnable *stealLocal();
+    void enqueueLocal(QThreadPoolThread *thread);
+
     mutable QMutex mutex;
     QList<QThreadPoolThread *> allThreads;
     QQueue<QThreadPoolThread *> waitingThreads;
@@ -180,6 +185,15 @@ public:
     int activeThreads = 0;
     uint stackSize = 0;
     bool isExiting = false;
+
+    // Work stealing: runnables started from a pool thread go onto that
+    // thread's local queue instead of the queue above; idle threads steal
+    // from there. These are read without the mutex.
+    QAtomicInt workStealing;
+    QAtomicInt localRunnables; // on all local queues
+    QAtomicInt urgentRunnables; // in the queue above, with a priority > 0
+    QAtomicInt idleThreads; // == waitingThreads.count()
+    QAtomicInt atCapacity; // activeThreadCount() >= maxThreadCount, if set
 };
 
 QT_END_NAMESPACE
@@ -41,8 +41,10 @@
 #include <QtCore/qarraydata.h>
 #include <QtCore/private/qnumeric_p.h>
 #include <QtCore/private/qtools_p.h>
+#include <QtCore/private/qmonotonicarena_p.h>
 
 #include <stdlib.h>
+#include <string.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -78,9 +80,24 @@ static inline size_t calculateBlockSize(size_t &capacity, size_t objectSize, siz
     }
 }
 
-static QArrayData *reallocateData(QArrayData *header, size_t allocSize, uint options)
+static QArrayData *reallocateData(QArrayData *header, size_t objectSize, size_t allocSize,
+                                  uint options)
 {
-    header = static_cast<QArrayData *>(::realloc(header, allocSize));
+    if (qt_arena_contains(header)) {
+        // arena memory cannot grow in place: move it to the current arena,
+        // if there is one, or to the heap
+        void *newHeader = qt_arena_allocate(allocSize, Q_ALIGNOF(QArrayData));
+        if (!newHeader)
+            newHeader = ::malloc(allocSize);
+        if (!newHeader)
+            return 0;
+        const size_t oldSize = header->offset + header->alloc * objectSize;
+        ::memcpy(newHeader, header, qMin(oldSize, allocSize));
+        qt_arena_release(header);
+        header = static_cast<QArrayData *>(newHeader);
+    } else {
+        header = static_cast<QArrayData *>(::realloc(header, allocSize));
+    }
     if (header)
         header->capacityReserved = bool(options & QArrayData::CapacityReserved);
     return header;
@@ -115,7 +132,9 @@ QArrayData *QArrayData::allocate(size_t objectSize, size_t alignment,
         return 0;
 
     size_t allocSize = calculateBlockSize(capacity, objectSize, headerSize, options);
-    QArrayData *header = static_cast<QArrayData *>(::malloc(allocSize));
+    QArrayData *header = static_cast<QArrayData *>(qt_arena_allocate(allocSize, Q_ALIGNOF(QArrayData)));
+    if (!header)
+        header = static_cast<QArrayData *>(::malloc(allocSize));
     if (header) {
         quintptr data = (quintptr(header) + sizeof(QArrayData) + alignment - 1)
                 & ~(alignment - 1);
@@ -143,7 +162,7 @@ QArrayData *QArrayData::reallocateUnaligned(QArrayData *data, size_t objectSize,
 
     size_t headerSize = sizeof(QArrayData);
     size_t allocSize = calculateBlockSize(capacity, objectSize, headerSize, options);
-    QArrayData *header = static_cast<QArrayData *>(reallocateData(data, allocSize, options));
+    QArrayData *header = static_cast<QArrayData *>(reallocateData(data, objectSize, allocSize, options));
     if (header)
         header->alloc = capacity;
     return header;
@@ -164,7 +183,8 @@ void QArrayData::deallocate(QArrayData *data, size_t objectSize,
 
     Q_ASSERT_X(data == 0 || !data->ref.isStatic(), "QArrayData::deallocate",
                "Static data can not be deleted");
-    ::free(data);
+    if (!qt_arena_release(data))
+        ::free(data);
 }
 
 namespace QtPrivate {
@@ -38,6 +38,7 @@
 ****************************************************************************/
 
 #include "qbytearraymatcher.h"
+#include "private/qsimd_p.h"
 
 #include <limits.h>
 
@@ -87,6 +88,152 @@ static inline int bm_find(const uchar *cc, int l, int index, const uchar *puc, u
     return -1; // not found
 }
 
+/*
+    The first/last byte filter search: for a block of consecutive candidate
+    positions, compare the haystack bytes that would line up with the first
+    and with the last byte of the needle against those two bytes in one go,
+    and only compare the rest of the needle at the positions where both
+    matched. See qstringmatcher.cpp for the QChar version.
+*/
+#if defined(__SSE2__) || (defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64))
+#  define QT_HAVE_FIRST_LAST_FILTER_SEARCH
+#endif
+
+#ifdef QT_HAVE_FIRST_LAST_FILTER_SEARCH
+static int findFirstLastTail(const uchar *h, int from, int end, const uchar *needle, int sl)
+{
+    const uchar first = needle[0];
+    const uchar last = needle[sl - 1];
+    for (int i = from; i <= end; ++i) {
+        if (h[i] == first && h[i + sl - 1] == last
+                && memcmp(h + i + 1, needle + 1, sl - 2) == 0)
+            return i;
+    }
+    return -1;
+}
+
+#  if defined(__SSE2__)
+static int findFirstLastSse2(const uchar *h, int from, int end, const uchar *needle, int sl)
+{
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[sl - 1]);
+
+    // we're going to test positions i..i+15
+    int i = from;
+    for ( ; end - i >= 15; i += 16) {
+        const __m128i f = _mm_loadu_si128(reinterpret_cast<const __m128i *>(h + i));
+        const __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i *>(h + i + sl - 1));
+        uint mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(f, first),
+                                                    _mm_cmpeq_epi8(l, last)));
+        while (mask) {
+            const int pos = i + qCountTrailingZeroBits(mask);
+            if (memcmp(h + pos + 1, needle + 1, sl - 2) == 0)
+                return pos;
+            mask &= mask - 1;
+        }
+    }
+    return findFirstLastTail(h, i, end, needle, sl);
+}
+#  endif
+
+#  if QT_COMPILER_SUPPORTS_HERE(AVX2)
+QT_FUNCTION_TARGET(AVX2)
+static int findFirstLastAvx2(const uchar *h, int from, int end, const uchar *needle, int sl)
+{
+    const __m256i first = _mm256_set1_epi8(needle[0]);
+    const __m256i last = _mm256_set1_epi8(needle[sl - 1]);
+
+    // we're going to test positions i..i+31
+    int i = from;
+    for ( ; end - i >= 31; i += 32) {
+        const __m256i f = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(h + i));
+        const __m256i l = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(h + i + sl - 1));
+        uint mask = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(f, first),
+                                                          _mm256_cmpeq_epi8(l, last)));
+        while (mask) {
+            const int pos = i + qCountTrailingZeroBits(mask);
+            if (memcmp(h + pos + 1, needle + 1, sl - 2) == 0)
+                return pos;
+            mask &= mask - 1;
+        }
+    }
+    return findFirstLastSse2(h, i, end, needle, sl);
+}
+#  endif
+
+#  if defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64) // vaddv is only available on Aarch64
+static int findFirstLastNeon(const uchar *h, int from, int end, const uchar *needle, int sl)
+{
+    const uint8x8_t vmask = { 1, 1 << 1, 1 << 2, 1 << 3, 1 << 4, 1 << 5, 1 << 6, 1 << 7 };
+    const uint8x16_t first = vdupq_n_u8(needle[0]);
+    const uint8x16_t last = vdupq_n_u8(needle[sl - 1]);
+
+    int i = from;
+    for ( ; end - i >= 15; i += 16) {
+        const uint8x16_t f = vld1q_u8(h + i);
+        const uint8x16_t l = vld1q_u8(h + i + sl - 1);
+        const uint8x16_t candidates = vandq_u8(vceqq_u8(f, first), vceqq_u8(l, last));
+        uint mask = vaddv_u8(vand_u8(vget_low_u8(candidates), vmask))
+                | (uint(vaddv_u8(vand_u8(vget_high_u8(candidates), vmask))) << 8);
+        while (mask) {
+            const int pos = i + qCountTrailingZeroBits(mask);
+            if (memcmp(h + pos + 1, needle + 1, sl - 2) == 0)
+                return pos;
+            mask &= mask - 1;
+        }
+    }
+    return findFirstLastTail(h, i, end, needle, sl);
+}
+#  endif
+
+/*!
+    \internal
+
+    Searches for \a needle, which must be at least two bytes long, in
+    \a haystack from position \a from (which must be non-negative).
+*/
+static int qFindByteArrayFirstLast(const uchar *haystack, int haystackLen, int from,
+                                   const uchar *needle, int needleLen)
+{
+    const int end = haystackLen - needleLen;     // last position the needle fits in
+    if (from > end)
+        return -1;
+#  if QT_COMPILER_SUPPORTS_HERE(AVX2)
+    if (qCpuHasFeature(AVX2))
+        return findFirstLastAvx2(haystack, from, end, needle, needleLen);
+#  endif
+#  if defined(__SSE2__)
+    return findFirstLastSse2(haystack, from, end, needle, needleLen);
+#  else
+    return findFirstLastNeon(haystack, from, end, needle, needleLen);
+#  endif
+}
+#endif // QT_HAVE_FIRST_LAST_FILTER_SEARCH
+
+/*
+    Builds the skip table of a QByteArrayMatcher. findIn() only consults it
+    for needles the first/last byte filter search doesn't handle, so don't
+    pay for it otherwise.
+*/
+static inline void initMatcherSkipTable(const uchar *cc, int len, uchar *skiptable)
+{
+#ifdef QT_HAVE_FIRST_LAST_FILTER_SEARCH
+    if (len >= 2)
+        return;
+#endif
+    bm_init_skiptable(cc, len, skiptable);
+}
+
+static inline int findIn(const uchar *haystack, int haystackLen, int from,
+                         const uchar *needle, int needleLen, const uchar *skiptable)
+{
+#ifdef QT_HAVE_FIRST_LAST_FILTER_SEARCH
+    if (needleLen >= 2)
+        return qFindByteArrayFirstLast(haystack, haystackLen, from, needle, needleLen);
+#endif
+    return bm_find(haystack, haystackLen, from, needle, needleLen, skiptable);
+}
+
 /*! \class QByteArrayMatcher
     \inmodule QtCore
     \brief The QByteArrayMatcher class holds a sequence of bytes that
@@ -133,7 +280,7 @@ QByteArrayMatcher::QByteArrayMatcher(const char *pattern, int length)
 {
     p.p = reinterpret_cast<const uchar *>(pattern);
     p.l = length;
-    bm_init_skiptable(p.p, p.l, p.q_skiptable);
+    initMatcherSkipTable(p.p, p.l, p.q_skiptable);
 }
 
 /*!
@@ -145,7 +292,7 @@ QByteArrayMatcher::QByteArrayMatcher(const QByteArray &pattern)
 {
     p.p = reinterpret_cast<const uchar *>(pattern.constData());
     p.l = pattern.size();
-    bm_init_skiptable(p.p, p.l, p.q_skiptable);
+    initMatcherSkipTable(p.p, p.l, p.q_skiptable);
 }
 
 /*!
@@ -186,7 +333,7 @@ void QByteArrayMatcher::setPattern(const QByteArray &pattern)
     q_pattern = pattern;
     p.p = reinterpret_cast<const uchar *>(pattern.constData());
     p.l = pattern.size();
-    bm_init_skiptable(p.p, p.l, p.q_skiptable);
+    initMatcherSkipTable(p.p, p.l, p.q_skiptable);
 }
 
 /*!
@@ -200,8 +347,8 @@ int QByteArrayMatcher::indexIn(const QByteArray &ba, int from) const
 {
     if (from < 0)
         from = 0;
-    return bm_find(reinterpret_cast<const uchar *>(ba.constData()), ba.size(), from,
-                   p.p, p.l, p.q_skiptable);
+    return findIn(reinterpret_cast<const uchar *>(ba.constData()), ba.size(), from,
+                  p.p, p.l, p.q_skiptable);
 }
 
 /*!
@@ -215,8 +362,8 @@ int QByteArrayMatcher::indexIn(const char *str, int len, int from) const
 {
     if (from < 0)
         from = 0;
-    return bm_find(reinterpret_cast<const uchar *>(str), len, from,
-                   p.p, p.l, p.q_skiptable);
+    return findIn(reinterpret_cast<const uchar *>(str), len, from,
+                  p.p, p.l, p.q_skiptable);
 }
 
 /*!
@@ -245,6 +392,7 @@ static int findChar(const char *str, int len, char ch, int from)
     return -1;
 }
 
+#ifndef QT_HAVE_FIRST_LAST_FILTER_SEARCH
 /*!
     \internal
  */
@@ -264,6 +412,7 @@ static int qFindByteArrayBoyerMoore(
     if (sl_minus_1 < sizeof(uint) * CHAR_BIT) \
         hashHaystack -= uint(a) << sl_minus_1; \
     hashHaystack <<= 1
+#endif // QT_HAVE_FIRST_LAST_FILTER_SEARCH
 
 /*!
     \internal
@@ -286,6 +435,10 @@ int qFindByteArray(
     if (sl == 1)
         return findChar(haystack0, haystackLen, needle[0], from);
 
+#ifdef QT_HAVE_FIRST_LAST_FILTER_SEARCH
+    return qFindByteArrayFirstLast(reinterpret_cast<const uchar *>(haystack0), l, qMax(from, 0),
+                                   reinterpret_cast<const uchar *>(needle), sl);
+#else
     /*
       We use the Boyer-Moore algorithm in cases where the overhead
       for the skip table should pay off, otherwise we use a simple
@@ -321,6 +474,7 @@ int qFindByteArray(
         ++haystack;
     }
     return -1;
+#endif
 }
 
 /*!
@@ -405,8 +559,8 @@ int QStaticByteArrayMatcherBase::indexOfIn(const char *needle, uint nlen, const
 {
     if (from < 0)
         from = 0;
-    return bm_find(reinterpret_cast<const uchar *>(haystack), hlen, from,
-                   reinterpret_cast<const uchar *>(needle),   nlen, m_skiptable.data);
+    return findIn(reinterpret_cast<const uchar *>(haystack), hlen, from,
+                  reinterpret_cast<const uchar *>(needle),   nlen, m_skiptable.data);
 }
 
 /*!
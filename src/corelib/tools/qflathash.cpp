@@ -0,0 +1,705 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qflathash.h"
+#include "qtools_p.h"
+
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \internal
+
+    Allocates a table of \a capacity slots for nodes of \a nodeSize bytes
+    that need an alignment of \a nodeAlignment. The header, the control
+    bytes and the nodes are allocated in one block, with all the slots
+    marked empty.
+*/
+QFlatHashData *QFlatHashData::allocate(int capacity, size_t nodeSize, size_t nodeAlignment)
+{
+    Q_ASSERT(capacity >= QtPrivate::FlatHash::GroupWidth && !(capacity & (capacity - 1)));
+
+    // the control bytes follow the header, and the nodes follow the control bytes
+    const size_t alignment = qMax(nodeAlignment, size_t(Q_ALIGNOF(QFlatHashData)));
+    const size_t nodesOffset = (sizeof(QFlatHashData) + capacity + nodeAlignment - 1) & ~(nodeAlignment - 1);
+    const size_t allocSize = qCalculateBlockSize(capacity, nodeSize, nodesOffset);
+    if (Q_UNLIKELY(qsizetype(allocSize) < 0))
+        qBadAlloc();
+
+    void *block = qMallocAligned(allocSize, alignment);
+    Q_CHECK_PTR(block);
+    QFlatHashData *d = static_cast<QFlatHashData *>(block);
+    d->ref.initializeOwned();
+    d->size = 0;
+    d->capacity = capacity;
+    d->growthLeft = maxLoad(capacity);
+    d->seed = uint(qGlobalQHashSeed());
+    d->ctrl = reinterpret_cast<uchar *>(d + 1);
+    d->nodes = static_cast<char *>(block) + nodesOffset;
+    memset(d->ctrl, QtPrivate::FlatHash::Empty, capacity);
+    return d;
+}
+
+/*!
+    \internal
+
+    Frees the block of \a d. The nodes must have been destroyed already.
+*/
+void QFlatHashData::deallocate(QFlatHashData *d)
+{
+    qFreeAligned(d);
+}
+
+/*!
+    \internal
+
+    Returns the smallest capacity that can hold \a size entries without
+    going over the maximum load factor.
+*/
+int QFlatHashData::capacityForSize(int size)
+{
+    int capacity = QtPrivate::FlatHash::GroupWidth;
+    while (maxLoad(capacity) < size) {
+        if (Q_UNLIKELY(capacity > (std::numeric_limits<int>::max)() / 2))
+            qBadAlloc();
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+/*!
+    \class QFlatHash
+    \inmodule QtCore
+    \brief The QFlatHash class is a template class that provides an
+    open-addressing hash table with contiguous storage.
+    \since 5.12
+
+    \ingroup tools
+    \ingroup shared
+
+    \reentrant
+
+    QFlatHash<Key, T> stores (key, value) pairs and provides very fast
+    lookup of the value associated with a key, like QHash does. Unlike
+    QHash, it does not allocate a node for every item: all the items are
+    stored in one contiguous array of slots, next to an array of one
+    control byte per slot. Looking up a key compares the control bytes of
+    16 slots at once (using SSE2 where available), and only compares the
+    keys of the slots whose control byte matches 7 bits of the key's hash.
+
+    This makes QFlatHash use considerably less memory than QHash, and makes
+    lookups and iteration touch far fewer cache lines, which matters most
+    for large tables. In exchange:
+
+    \list
+    \li Inserting an item may move all the other items in memory, so
+       pointers and references to items, and all iterators, are invalidated
+       by insert() and operator[]() (but not by remove() or erase()).
+    \li Items are moved when the table grows, so a table of large values
+        grows more slowly than the corresponding QHash.
+    \li There is only one value per key: there is no equivalent of
+        QHash::insertMulti().
+    \endlist
+
+    The key type must provide operator==() and a global qHash(Key, uint)
+    function, exactly as for QHash; see the QHash documentation for
+    details. The same hash seed as QHash is used (see qSetGlobalQHashSeed()).
+
+    Like the other Qt containers, QFlatHash is \l{implicitly shared}, and
+    iterating over it visits the items in an arbitrary order.
+
+    \section1 Growth and deletion
+
+    The table holds at most 7/8 of its slots, and doubles in size when it
+    is full. capacity() returns the number of items that fit before the next
+    reallocation, and reserve() makes room for a given number of items in
+    advance. Removing an item only leaves a marker behind when it is needed
+    for lookups to stay correct; markers are cleaned up when the table is
+    next rehashed.
+
+    \sa QHash
+*/
+
+/*! \fn template <class Key, class T> QFlatHash<Key, T>::QFlatHash()
+
+    Constructs an empty hash. An empty hash does not allocate any memory.
+
+    \sa clear()
+*/
+
+/*!
+    \fn template <class Key, class T> QFlatHash<Key, T>::QFlatHash(std::initializer_list<std::pair<Key,T> > list)
+
+    Constructs a hash with a copy of each of the elements in the
+    initializer list \a list.
+
+    This function is only available if the program is being
+    compiled in C++11 mode.
+*/
+
+/*! \fn template <class Key, class T> QFlatHash<Key, T>::QFlatHash(const QFlatHash &other)
+
+    Constructs a copy of \a other.
+
+    This operation occurs in \l{constant time}, because QFlatHash is
+    \l{implicitly shared}. This makes returning a QFlatHash from a
+    function very fast. If a shared instance is modified, it will be
+    copied (copy-on-write), and that takes \l{linear time}.
+
+    \sa operator=()
+*/
+
+/*! \fn template <class Key, class T> QFlatHash<Key, T>::QFlatHash(QFlatHash &&other)
+
+    Move-constructs a QFlatHash instance, making it point at the same
+    object that \a other was pointing to. \a other is left empty.
+*/
+
+/*! \fn template <class Key, class T> QFlatHash<Key, T>::~QFlatHash()
+
+    Destroys the hash. References to the values in the hash and all
+    iterators of this hash become invalid.
+*/
+
+/*! \fn template <class Key, class T> QFlatHash &QFlatHash<Key, T>::operator=(const QFlatHash &other)
+
+    Assigns \a other to this hash and returns a reference to this hash.
+*/
+
+/*! \fn template <class Key, class T> QFlatHash &QFlatHash<Key, T>::operator=(QFlatHash &&other)
+
+    Move-assigns \a other to this QFlatHash instance.
+*/
+
+/*! \fn template <class Key, class T> void QFlatHash<Key, T>::swap(QFlatHash &other)
+
+    Swaps hash \a other with this hash. This operation is very fast and
+    never fails.
+*/
+
+/*! \fn template <class Key, class T> bool QFlatHash<Key, T>::operator==(const QFlatHash &other) const
+
+    Returns \c true if \a other is equal to this hash; otherwise returns
+    false.
+
+    Two hashes are considered equal if they contain the same (key, value)
+    pairs. This function requires the value type to implement \c operator==().
+
+    \sa operator!=()
+*/
+
+/*! \fn template <class Key, class T> bool QFlatHash<Key, T>::operator!=(const QFlatHash &other) const
+
+    Returns \c true if \a other is not equal to this hash; otherwise
+    returns \c false.
+
+    \sa operator==()
+*/
+
+/*! \fn template <class Key, class T> int QFlatHash<Key, T>::size() const
+
+    Returns the number of items in the hash.
+
+    \sa isEmpty(), count()
+*/
+
+/*! \fn template <class Key, class T> int QFlatHash<Key, T>::count() const
+
+    Same as size().
+*/
+
+/*! \fn template <class Key, class T> bool QFlatHash<Key, T>::isEmpty() const
+
+    Returns \c true if the hash contains no items; otherwise returns
+    false.
+
+    \sa size()
+*/
+
+/*! \fn template <class Key, class T> bool QFlatHash<Key, T>::empty() const
+
+    This function is provided for STL compatibility. It is equivalent
+    to isEmpty(), returning true if the hash is empty; otherwise
+    returns \c false.
+*/
+
+/*! \fn template <class Key, class T> int QFlatHash<Key, T>::capacity() const
+
+    Returns the number of items the hash can hold before it has to
+    reallocate its table.
+
+    \sa reserve(), squeeze()
+*/
+
+/*! \fn template <class Key, class T> void QFlatHash<Key, T>::reserve(int size)
+
+    Ensures that the hash can hold \a size items without reallocating
+    its table.
+
+    \sa squeeze(), capacity()
+*/
+
+/*! \fn template <class Key, class T> void QFlatHash<Key, T>::squeeze()
+
+    Shrinks the table to the smallest size that still holds all the
+    items, which also removes all the markers left behind by removed
+    items.
+
+    \sa reserve(), capacity()
+*/
+
+/*! \fn template <class Key, class T> void QFlatHash<Key, T>::detach()
+
+    \internal
+
+    Detaches this hash from any other hashes with which it may share
+    data.
+
+    \sa isDetached()
+*/
+
+/*! \fn template <class Key, class T> bool QFlatHash<Key, T>::isDetached() const
+
+    \internal
+
+    Returns \c true if the hash's internal data isn't shared with any
+    other hash object; otherwise returns \c false.
+
+    \sa detach()
+*/
+
+/*! \fn template <class Key, class T> bool QFlatHash<Key, T>::isSharedWith(const QFlatHash &other) const
+
+    \internal
+*/
+
+/*! \fn template <class Key, class T> void QFlatHash<Key, T>::clear()
+
+    Removes all items from the hash and frees its table.
+
+    \sa remove()
+*/
+
+/*! \fn template <class Key, class T> int QFlatHash<Key, T>::remove(const Key &key)
+
+    Removes the item that has the \a key from the hash. Returns 1 if an
+    item was removed, 0 otherwise.
+
+    \sa clear(), take()
+*/
+
+/*! \fn template <class Key, class T> T QFlatHash<Key, T>::take(const Key &key)
+
+    Removes the item with the \a key from the hash and returns
+    the value associated with it.
+
+    If the item does not exist in the hash, the function simply
+    returns a \l{default-constructed value}.
+
+    \sa remove()
+*/
+
+/*! \fn template <class Key, class T> bool QFlatHash<Key, T>::contains(const Key &key) const
+
+    Returns \c true if the hash contains an item with the \a key;
+    otherwise returns \c false.
+*/
+
+/*! \fn template <class Key, class T> const T QFlatHash<Key, T>::value(const Key &key) const
+
+    Returns the value associated with the \a key.
+
+    If the hash contains no item with the \a key, the function
+    returns a \l{default-constructed value}.
+
+    \sa contains(), operator[]()
+*/
+
+/*! \fn template <class Key, class T> const T QFlatHash<Key, T>::value(const Key &key, const T &defaultValue) const
+    \overload
+
+    If the hash contains no item with the given \a key, the function returns
+    \a defaultValue.
+*/
+
+/*! \fn template <class Key, class T> T &QFlatHash<Key, T>::operator[](const Key &key)
+
+    Returns the value associated with the \a key as a modifiable
+    reference.
+
+    If the hash contains no item with the \a key, the function inserts
+    a \l{default-constructed value} into the hash with the \a key, and
+    returns a reference to it.
+
+    \sa insert(), value()
+*/
+
+/*! \fn template <class Key, class T> const T QFlatHash<Key, T>::operator[](const Key &key) const
+
+    \overload
+
+    Same as value().
+*/
+
+/*! \fn template <class Key, class T> QList<Key> QFlatHash<Key, T>::keys() const
+
+    Returns a list containing all the keys in the hash, in an
+    arbitrary order.
+
+    \sa values()
+*/
+
+/*! \fn template <class Key, class T> QList<T> QFlatHash<Key, T>::values() const
+
+    Returns a list containing all the values in the hash, in an
+    arbitrary order.
+
+    \sa keys()
+*/
+
+/*! \fn template <class Key, class T> QFlatHash<Key, T>::iterator QFlatHash<Key, T>::begin()
+
+    Returns an \l{STL-style iterators}{STL-style iterator} pointing to the first item in
+    the hash.
+
+    \sa constBegin(), end()
+*/
+
+/*! \fn template <class Key, class T> QFlatHash<Key, T>::const_iterator QFlatHash<Key, T>::begin() const
+
+    \overload
+*/
+
+/*! \fn template <class Key, class T> QFlatHash<Key, T>::const_iterator QFlatHash<Key, T>::cbegin() const
+
+    Returns a const \l{STL-style iterators}{STL-style iterator} pointing to the first item
+    in the hash.
+
+    \sa begin(), cend()
+*/
+
+/*! \fn template <class Key, class T> QFlatHash<Key, T>::const_iterator QFlatHash<Key, T>::constBegin() const
+
+    Returns a const \l{STL-style iterators}{STL-style iterator} pointing to the first item
+    in the hash.
+
+    \sa begin(), constEnd()
+*/
+
+/*! \fn template <class Key, class T> QFlatHash<Key, T>::iterator QFlatHash<Key, T>::end()
+
+    Returns an \l{STL-style iterators}{STL-style iterator} pointing to the imaginary item
+    after the last item in the hash.
+
+    \sa begin(), constEnd()
+*/
+
+/*! \fn template <class Key, class T> QFlatHash<Key, T>::const_iterator QFlatHash<Key, T>::end() const
+
+    \overload
+*/
+
+/*! \fn template <class Key, class T> QFlatHash<Key, T>::const_iterator QFlatHash<Key, T>::cend() const
+
+    Returns a const \l{STL-style iterators}{STL-style iterator} pointing to the imaginary
+    item after the last item in the hash.
+
+    \sa cbegin(), end()
+*/
+
+/*! \fn template <class Key, class T> QFlatHash<Key, T>::const_iterator QFlatHash<Key, T>::constEnd() const
+
+    Returns a const \l{STL-style iterators}{STL-style iterator} pointing to the imaginary
+    item after the last item in the hash.
+
+    \sa constBegin(), end()
+*/
+
+/*! \fn template <class Key, class T> QFlatHash<Key, T>::iterator QFlatHash<Key, T>::erase(const_iterator pos)
+
+    Removes the (key, value) pair associated with the iterator \a pos
+    from the hash, and returns an iterator to the next item in the
+    hash.
+
+    Unlike insert(), this function never moves other items, so it is
+    safe to use while iterating over the hash:
+
+    \code
+    QFlatHash<QString, int>::iterator i = hash.begin();
+    while (i != hash.end()) {
+        if (i.value() < 0)
+            i = hash.erase(i);
+        else
+            ++i;
+    }
+    \endcode
+
+    \sa remove(), take()
+*/
+
+/*! \fn template <class Key, class T> QFlatHash<Key, T>::iterator QFlatHash<Key, T>::erase(iterator pos)
+    \overload
+*/
+
+/*! \fn template <class Key, class T> QFlatHash<Key, T>::iterator QFlatHash<Key, T>::find(const Key &key)
+
+    Returns an iterator pointing to the item with the \a key in the
+    hash.
+
+    If the hash contains no item with the \a key, the function
+    returns end().
+
+    \sa value(), contains()
+*/
+
+/*! \fn template <class Key, class T> QFlatHash<Key, T>::const_iterator QFlatHash<Key, T>::find(const Key &key) const
+
+    \overload
+*/
+
+/*! \fn template <class Key, class T> QFlatHash<Key, T>::const_iterator QFlatHash<Key, T>::constFind(const Key &key) const
+
+    Returns an iterator pointing to the item with the \a key in the
+    hash.
+
+    If the hash contains no item with the \a key, the function
+    returns constEnd().
+
+    \sa find()
+*/
+
+/*! \fn template <class Key, class T> QFlatHash<Key, T>::iterator QFlatHash<Key, T>::insert(const Key &key, const T &value)
+
+    Inserts a new item with the \a key and a value of \a value.
+
+    If there is already an item with the \a key, that item's value
+    is replaced with \a value.
+
+    Inserting may reallocate the table, which invalidates all iterators,
+    pointers and references into the hash.
+*/
+
+/*! \typedef QFlatHash::difference_type
+
+    Typedef for ptrdiff_t. Provided for STL compatibility.
+*/
+
+/*! \typedef QFlatHash::key_type
+
+    Typedef for Key. Provided for STL compatibility.
+*/
+
+/*! \typedef QFlatHash::mapped_type
+
+    Typedef for T. Provided for STL compatibility.
+*/
+
+/*! \typedef QFlatHash::size_type
+
+    Typedef for int. Provided for STL compatibility.
+*/
+
+/*! \typedef QFlatHash::Iterator
+
+    Qt-style synonym for QFlatHash::iterator.
+*/
+
+/*! \typedef QFlatHash::ConstIterator
+
+    Qt-style synonym for QFlatHash::const_iterator.
+*/
+
+/*! \class QFlatHash::iterator
+    \inmodule QtCore
+    \brief The QFlatHash::iterator class provides an STL-style non-const iterator for QFlatHash.
+
+    QFlatHash<Key, T>::iterator allows you to iterate over a QFlatHash
+    and to modify the value (but not the key) stored under a particular
+    key. If you want to iterate over a const QFlatHash, you should use
+    QFlatHash::const_iterator.
+
+    The iterator is invalidated by any function that inserts into the
+    hash.
+
+    \sa QFlatHash::const_iterator
+*/
+
+/*! \fn template <class Key, class T> QFlatHash<Key, T>::iterator::iterator()
+
+    Constructs an uninitialized iterator.
+*/
+
+/*! \fn template <class Key, class T> const Key &QFlatHash<Key, T>::iterator::key() const
+
+    Returns the current item's key as a const reference.
+
+    \sa value()
+*/
+
+/*! \fn template <class Key, class T> T &QFlatHash<Key, T>::iterator::value() const
+
+    Returns a modifiable reference to the current item's value.
+
+    \sa key(), operator*()
+*/
+
+/*! \fn template <class Key, class T> T &QFlatHash<Key, T>::iterator::operator*() const
+
+    Returns a modifiable reference to the current item's value.
+
+    Same as value().
+*/
+
+/*! \fn template <class Key, class T> T *QFlatHash<Key, T>::iterator::operator->() const
+
+    Returns a pointer to the current item's value.
+*/
+
+/*!
+    \fn template <class Key, class T> bool QFlatHash<Key, T>::iterator::operator==(const iterator &other) const
+    \fn template <class Key, class T> bool QFlatHash<Key, T>::iterator::operator==(const const_iterator &other) const
+
+    Returns \c true if \a other points to the same item as this
+    iterator; otherwise returns \c false.
+*/
+
+/*!
+    \fn template <class Key, class T> bool QFlatHash<Key, T>::iterator::operator!=(const iterator &other) const
+    \fn template <class Key, class T> bool QFlatHash<Key, T>::iterator::operator!=(const const_iterator &other) const
+
+    Returns \c true if \a other points to a different item than this
+    iterator; otherwise returns \c false.
+*/
+
+/*! \fn template <class Key, class T> QFlatHash<Key, T>::iterator &QFlatHash<Key, T>::iterator::operator++()
+
+    The prefix ++ operator (\c{++i}) advances the iterator to the
+    next item in the hash and returns an iterator to the new current
+    item.
+*/
+
+/*! \fn template <class Key, class T> QFlatHash<Key, T>::iterator QFlatHash<Key, T>::iterator::operator++(int)
+
+    \overload
+
+    The postfix ++ operator (\c{i++}) advances the iterator to the
+    next item in the hash and returns an iterator to the previously
+    current item.
+*/
+
+/*! \class QFlatHash::const_iterator
+    \inmodule QtCore
+    \brief The QFlatHash::const_iterator class provides an STL-style const iterator for QFlatHash.
+
+    QFlatHash<Key, T>::const_iterator allows you to iterate over a
+    QFlatHash. If you want to modify the QFlatHash as you iterate over
+    it, you must use QFlatHash::iterator instead.
+
+    The iterator is invalidated by any function that inserts into the
+    hash.
+
+    \sa QFlatHash::iterator
+*/
+
+/*! \fn template <class Key, class T> QFlatHash<Key, T>::const_iterator::const_iterator()
+
+    Constructs an uninitialized iterator.
+*/
+
+/*! \fn template <class Key, class T> QFlatHash<Key, T>::const_iterator::const_iterator(const iterator &other)
+
+    Constructs a copy of \a other.
+*/
+
+/*! \fn template <class Key, class T> const Key &QFlatHash<Key, T>::const_iterator::key() const
+
+    Returns the current item's key.
+
+    \sa value()
+*/
+
+/*! \fn template <class Key, class T> const T &QFlatHash<Key, T>::const_iterator::value() const
+
+    Returns the current item's value.
+
+    \sa key(), operator*()
+*/
+
+/*! \fn template <class Key, class T> const T &QFlatHash<Key, T>::const_iterator::operator*() const
+
+    Returns the current item's value.
+
+    Same as value().
+*/
+
+/*! \fn template <class Key, class T> const T *QFlatHash<Key, T>::const_iterator::operator->() const
+
+    Returns a pointer to the current item's value.
+*/
+
+/*! \fn template <class Key, class T> bool QFlatHash<Key, T>::const_iterator::operator==(const const_iterator &other) const
+
+    Returns \c true if \a other points to the same item as this
+    iterator; otherwise returns \c false.
+*/
+
+/*! \fn template <class Key, class T> bool QFlatHash<Key, T>::const_iterator::operator!=(const const_iterator &other) const
+
+    Returns \c true if \a other points to a different item than this
+    iterator; otherwise returns \c false.
+*/
+
+/*! \fn template <class Key, class T> QFlatHash<Key, T>::const_iterator &QFlatHash<Key, T>::const_iterator::operator++()
+
+    The prefix ++ operator (\c{++i}) advances the iterator to the
+    next item in the hash and returns an iterator to the new current
+    item.
+*/
+
+/*! \fn template <class Key, class T> QFlatHash<Key, T>::const_iterator QFlatHash<Key, T>::const_iterator::operator++(int)
+
+    \overload
+
+    The postfix ++ operator (\c{i++}) advances the iterator to the
+    next item in the hash and returns an iterator to the previously
+    current item.
+*/
+
+QT_END_NAMESPACE
@@ -0,0 +1,683 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QFLATHASH_H
+#define QFLATHASH_H
+
+#include <QtCore/qalgorithms.h>
+#include <QtCore/qendian.h>
+#include <QtCore/qhashfunctions.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qrefcount.h>
+
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+#include <initializer_list>
+#endif
+#include <iterator>
+#include <new>
+#include <utility>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+struct Q_CORE_EXPORT QFlatHashData
+{
+    QtPrivate::RefCount ref;
+    int size;
+    int capacity;       // number of slots: a power of two, and a multiple of the group width
+    int growthLeft;     // empty slots that can still be used before the table must be rehashed
+    uint seed;
+    uchar *ctrl;        // one control byte per slot
+    void *nodes;        // one node per slot
+
+    static QFlatHashData *allocate(int capacity, size_t nodeSize, size_t nodeAlignment);
+    static void deallocate(QFlatHashData *d);
+    static int capacityForSize(int size);
+    static int maxLoad(int capacity) Q_DECL_NOTHROW { return capacity - capacity / 8; }
+};
+
+namespace QtPrivate {
+namespace FlatHash {
+
+enum : uchar {
+    // full slots store the low 7 bits of the hash of their key
+    Empty = 0x80,
+    Deleted = 0xfe
+};
+
+// The slots are probed in groups, whose control bytes are all compared at once
+enum { GroupWidth = 16 };
+
+inline uint mix(uint h) Q_DECL_NOTHROW
+{
+    // qHash() of integers is the identity, but both the group index and
+    // the bits stored in the control bytes need to be well distributed
+    h ^= h >> 16;
+    h *= 0x85ebca6bU;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35U;
+    h ^= h >> 16;
+    return h;
+}
+
+// All the match functions return a mask with one bit per slot of the group
+struct Group
+{
+#if defined(__SSE2__)
+    __m128i ctrl;
+
+    explicit Group(const uchar *p) Q_DECL_NOTHROW
+        : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p))) {}
+
+    uint match(uchar h2) const Q_DECL_NOTHROW
+    { return _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(char(h2)))); }
+    uint matchEmpty() const Q_DECL_NOTHROW
+    { return match(Empty); }
+    uint matchFree() const Q_DECL_NOTHROW
+    { return _mm_movemask_epi8(ctrl); }
+#else
+    // two 64-bit words, compared a byte at a time using integer arithmetic
+    quint64 lo;
+    quint64 hi;
+
+    explicit Group(const uchar *p) Q_DECL_NOTHROW
+        : lo(qFromLittleEndian<quint64>(p)), hi(qFromLittleEndian<quint64>(p + 8)) {}
+
+    static quint64 lsbs() Q_DECL_NOTHROW { return Q_UINT64_C(0x0101010101010101); }
+    static quint64 msbs() Q_DECL_NOTHROW { return Q_UINT64_C(0x8080808080808080); }
+
+    // gathers the most significant bit of each byte of m into one byte
+    static uint compress(quint64 m) Q_DECL_NOTHROW
+    { return uint(((m >> 7) * Q_UINT64_C(0x0102040810204080)) >> 56); }
+
+    // may report a false positive next to a true match, which is harmless,
+    // as the keys are compared anyway
+    static quint64 matchWord(quint64 w, uchar h2) Q_DECL_NOTHROW
+    {
+        const quint64 x = w ^ (lsbs() * h2);
+        return (x - lsbs()) & ~x & msbs();
+    }
+
+    uint match(uchar h2) const Q_DECL_NOTHROW
+    { return compress(matchWord(lo, h2)) | compress(matchWord(hi, h2)) << 8; }
+    uint matchEmpty() const Q_DECL_NOTHROW
+    { return compress(lo & ~(lo << 6) & msbs()) | compress(hi & ~(hi << 6) & msbs()) << 8; }
+    uint matchFree() const Q_DECL_NOTHROW
+    { return compress(lo & msbs()) | compress(hi & msbs()) << 8; }
+#endif
+};
+
+// Returns the first full slot at or after i, or d->capacity if there is none
+inline int nextFull(const QFlatHashData *d, int i) Q_DECL_NOTHROW
+{
+    if (!d)
+        return 0;
+    while (i < d->capacity) {
+        const int group = i & ~(GroupWidth - 1);
+        const uint full = ~Group(d->ctrl + group).matchFree() & (0xffffU << (i - group)) & 0xffffU;
+        if (full)
+            return group + qCountTrailingZeroBits(full);
+        i = group + GroupWidth;
+    }
+    return d->capacity;
+}
+
+} // namespace FlatHash
+} // namespace QtPrivate
+
+template <class Key, class T>
+struct QFlatHashNode
+{
+    Key key;
+    T value;
+
+    inline QFlatHashNode(const Key &key0, const T &value0) : key(key0), value(value0) {}
+};
+
+template <class Key, class T>
+class QFlatHash
+{
+    typedef QFlatHashNode<Key, T> Node;
+    QFlatHashData *d;
+
+public:
+    inline QFlatHash() Q_DECL_NOTHROW : d(nullptr) { }
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+    inline QFlatHash(std::initializer_list<std::pair<Key,T> > list)
+        : d(nullptr)
+    {
+        reserve(int(list.size()));
+        for (typename std::initializer_list<std::pair<Key,T> >::const_iterator it = list.begin(); it != list.end(); ++it)
+            insert(it->first, it->second);
+    }
+#endif
+    QFlatHash(const QFlatHash &other) : d(other.d) { if (d) d->ref.ref(); }
+    ~QFlatHash() { if (d && !d->ref.deref()) freeData(d); }
+
+    QFlatHash &operator=(const QFlatHash &other)
+    {
+        QFlatHash copy(other);
+        swap(copy);
+        return *this;
+    }
+#ifdef Q_COMPILER_RVALUE_REFS
+    QFlatHash(QFlatHash &&other) Q_DECL_NOTHROW : d(other.d) { other.d = nullptr; }
+    QFlatHash &operator=(QFlatHash &&other) Q_DECL_NOTHROW
+    { QFlatHash moved(std::move(other)); swap(moved); return *this; }
+#endif
+    void swap(QFlatHash &other) Q_DECL_NOTHROW { qSwap(d, other.d); }
+
+    bool operator==(const QFlatHash &other) const;
+    inline bool operator!=(const QFlatHash &other) const { return !(*this == other); }
+
+    inline int size() const Q_DECL_NOTHROW { return d ? d->size : 0; }
+    inline int count() const Q_DECL_NOTHROW { return size(); }
+    inline bool isEmpty() const Q_DECL_NOTHROW { return size() == 0; }
+
+    inline int capacity() const Q_DECL_NOTHROW { return d ? QFlatHashData::maxLoad(d->capacity) : 0; }
+    void reserve(int size);
+    void squeeze();
+
+    inline void detach() { if (!d || d->ref.isShared()) detach_helper(); }
+    inline bool isDetached() const Q_DECL_NOTHROW { return d && !d->ref.isShared(); }
+    bool isSharedWith(const QFlatHash &other) const Q_DECL_NOTHROW { return d == other.d; }
+
+    void clear() { *this = QFlatHash(); }
+
+    int remove(const Key &key);
+    T take(const Key &key);
+
+    bool contains(const Key &key) const { return findIndex(key) >= 0; }
+    const T value(const Key &key) const;
+    const T value(const Key &key, const T &defaultValue) const;
+    T &operator[](const Key &key);
+    const T operator[](const Key &key) const;
+
+    QList<Key> keys() const;
+    QList<T> values() const;
+
+    class const_iterator;
+
+    class iterator
+    {
+        friend class const_iterator;
+        friend class QFlatHash<Key, T>;
+        QFlatHashData *d;
+        int i;
+
+        inline iterator(QFlatHashData *data, int index) Q_DECL_NOTHROW : d(data), i(index) { }
+        inline Node *node() const { return static_cast<Node *>(d->nodes) + i; }
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef T *pointer;
+        typedef T &reference;
+
+        Q_DECL_CONSTEXPR inline iterator() Q_DECL_NOTHROW : d(nullptr), i(0) { }
+
+        inline const Key &key() const { return node()->key; }
+        inline T &value() const { return node()->value; }
+        inline T &operator*() const { return node()->value; }
+        inline T *operator->() const { return &node()->value; }
+        inline bool operator==(const iterator &o) const Q_DECL_NOTHROW { return i == o.i; }
+        inline bool operator!=(const iterator &o) const Q_DECL_NOTHROW { return i != o.i; }
+        inline bool operator==(const const_iterator &o) const Q_DECL_NOTHROW { return i == o.i; }
+        inline bool operator!=(const const_iterator &o) const Q_DECL_NOTHROW { return i != o.i; }
+
+        inline iterator &operator++() Q_DECL_NOTHROW
+        {
+            i = QtPrivate::FlatHash::nextFull(d, i + 1);
+            return *this;
+        }
+        inline iterator operator++(int) Q_DECL_NOTHROW
+        {
+            iterator r = *this;
+            ++*this;
+            return r;
+        }
+    };
+    friend class iterator;
+
+    class const_iterator
+    {
+        friend class iterator;
+        friend class QFlatHash<Key, T>;
+        const QFlatHashData *d;
+        int i;
+
+        inline const_iterator(const QFlatHashData *data, int index) Q_DECL_NOTHROW : d(data), i(index) { }
+        inline const Node *node() const { return static_cast<const Node *>(d->nodes) + i; }
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        Q_DECL_CONSTEXPR inline const_iterator() Q_DECL_NOTHROW : d(nullptr), i(0) { }
+        inline const_iterator(const iterator &o) Q_DECL_NOTHROW : d(o.d), i(o.i) { }
+
+        inline const Key &key() const { return node()->key; }
+        inline const T &value() const { return node()->value; }
+        inline const T &operator*() const { return node()->value; }
+        inline const T *operator->() const { return &node()->value; }
+        inline bool operator==(const const_iterator &o) const Q_DECL_NOTHROW { return i == o.i; }
+        inline bool operator!=(const const_iterator &o) const Q_DECL_NOTHROW { return i != o.i; }
+
+        inline const_iterator &operator++() Q_DECL_NOTHROW
+        {
+            i = QtPrivate::FlatHash::nextFull(d, i + 1);
+            return *this;
+        }
+        inline const_iterator operator++(int) Q_DECL_NOTHROW
+        {
+            const_iterator r = *this;
+            ++*this;
+            return r;
+        }
+    };
+    friend class const_iterator;
+
+    // STL style
+    inline iterator begin()
+    {
+        if (isEmpty()) // prevents detaching shared null
+            return end();
+        detach();
+        return iterator(d, QtPrivate::FlatHash::nextFull(d, 0));
+    }
+    inline const_iterator begin() const Q_DECL_NOTHROW { return constBegin(); }
+    inline const_iterator cbegin() const Q_DECL_NOTHROW { return constBegin(); }
+    inline const_iterator constBegin() const Q_DECL_NOTHROW { return const_iterator(d, QtPrivate::FlatHash::nextFull(d, 0)); }
+    inline iterator end()
+    {
+        if (!isEmpty())
+            detach();
+        return iterator(d, d ? d->capacity : 0);
+    }
+    inline const_iterator end() const Q_DECL_NOTHROW { return constEnd(); }
+    inline const_iterator cend() const Q_DECL_NOTHROW { return constEnd(); }
+    inline const_iterator constEnd() const Q_DECL_NOTHROW { return const_iterator(d, d ? d->capacity : 0); }
+
+    iterator erase(const_iterator it);
+    inline iterator erase(iterator it) { return erase(const_iterator(it)); }
+
+    iterator find(const Key &key);
+    const_iterator find(const Key &key) const { return constFind(key); }
+    const_iterator constFind(const Key &key) const;
+    iterator insert(const Key &key, const T &value);
+
+    // STL compatibility
+    typedef T mapped_type;
+    typedef Key key_type;
+    typedef qptrdiff difference_type;
+    typedef int size_type;
+
+    inline bool empty() const Q_DECL_NOTHROW { return isEmpty(); }
+
+    typedef iterator Iterator;
+    typedef const_iterator ConstIterator;
+
+private:
+    inline Node *nodes() const { return static_cast<Node *>(d->nodes); }
+    static inline uint hash(const Key &key, uint seed)
+    { return QtPrivate::FlatHash::mix(qHash(key, seed)); }
+
+    int findIndex(const Key &key) const;
+    int findIndex(const Key &key, uint h) const;
+    int findFree(uint h);
+    void setFull(int i, uint h);
+    void eraseAt(int i);
+    void rehash(int capacity);
+    void detach_helper();
+    static void freeData(QFlatHashData *x);
+};
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::freeData(QFlatHashData *x)
+{
+    if (QTypeInfo<Key>::isComplex || QTypeInfo<T>::isComplex) {
+        Node *n = static_cast<Node *>(x->nodes);
+        for (int i = QtPrivate::FlatHash::nextFull(x, 0); i < x->capacity;
+             i = QtPrivate::FlatHash::nextFull(x, i + 1)) {
+            n[i].~Node();
+        }
+    }
+    QFlatHashData::deallocate(x);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::detach_helper()
+{
+    if (!d) {
+        d = QFlatHashData::allocate(QFlatHashData::capacityForSize(0), sizeof(Node), Q_ALIGNOF(Node));
+        return;
+    }
+
+    // keep every node in its slot, so that indexes stay valid across the detach
+    QFlatHashData *x = QFlatHashData::allocate(d->capacity, sizeof(Node), Q_ALIGNOF(Node));
+    x->seed = d->seed;
+    const Node *src = nodes();
+    Node *dst = static_cast<Node *>(x->nodes);
+    for (int i = QtPrivate::FlatHash::nextFull(d, 0); i < d->capacity;
+         i = QtPrivate::FlatHash::nextFull(d, i + 1)) {
+        new (dst + i) Node(src[i]);
+    }
+    // copy the tombstones too, or probe sequences through them would be cut short
+    memcpy(x->ctrl, d->ctrl, d->capacity);
+    x->size = d->size;
+    x->growthLeft = d->growthLeft;
+
+    if (!d->ref.deref())
+        freeData(d);
+    d = x;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::rehash(int newCapacity)
+{
+    Q_ASSERT(isDetached());
+    QFlatHashData *x = QFlatHashData::allocate(newCapacity, sizeof(Node), Q_ALIGNOF(Node));
+    x->seed = d->seed;
+    qSwap(d, x);
+
+    Node *src = static_cast<Node *>(x->nodes);
+    for (int i = QtPrivate::FlatHash::nextFull(x, 0); i < x->capacity;
+         i = QtPrivate::FlatHash::nextFull(x, i + 1)) {
+        const uint h = hash(src[i].key, d->seed);
+        const int j = findFree(h);
+        new (nodes() + j) Node(std::move(src[i]));
+        src[i].~Node();
+        setFull(j, h);
+    }
+    QFlatHashData::deallocate(x);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE int QFlatHash<Key, T>::findIndex(const Key &key) const
+{
+    if (isEmpty())
+        return -1;
+    return findIndex(key, hash(key, d->seed));
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE int QFlatHash<Key, T>::findIndex(const Key &key, uint h) const
+{
+    using namespace QtPrivate::FlatHash;
+    const uchar h2 = uchar(h & 0x7f);
+    const uint groupMask = uint(d->capacity) / GroupWidth - 1;
+    const Node *n = nodes();
+    uint group = (h >> 7) & groupMask;
+    // triangular probing visits every group, and there is always an empty slot
+    for (uint step = 1; ; ++step) {
+        const Group g(d->ctrl + group * GroupWidth);
+        for (uint m = g.match(h2); m; m &= m - 1) {
+            const int i = int(group * GroupWidth + qCountTrailingZeroBits(m));
+            if (n[i].key == key)
+                return i;
+        }
+        if (g.matchEmpty())
+            return -1;
+        group = (group + step) & groupMask;
+    }
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE int QFlatHash<Key, T>::findFree(uint h)
+{
+    using namespace QtPrivate::FlatHash;
+    if (d->growthLeft == 0) {
+        // grow, unless it's mostly tombstones that are filling the table up
+        const int maxLoad = QFlatHashData::maxLoad(d->capacity);
+        rehash(d->size >= maxLoad / 2 ? d->capacity * 2 : d->capacity);
+    }
+
+    const uint groupMask = uint(d->capacity) / GroupWidth - 1;
+    uint group = (h >> 7) & groupMask;
+    for (uint step = 1; ; ++step) {
+        const uint free = Group(d->ctrl + group * GroupWidth).matchFree();
+        if (free)
+            return int(group * GroupWidth + qCountTrailingZeroBits(free));
+        group = (group + step) & groupMask;
+    }
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE void QFlatHash<Key, T>::setFull(int i, uint h)
+{
+    if (d->ctrl[i] == QtPrivate::FlatHash::Empty)
+        --d->growthLeft;
+    d->ctrl[i] = uchar(h & 0x7f);
+    ++d->size;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::eraseAt(int i)
+{
+    using namespace QtPrivate::FlatHash;
+    nodes()[i].~Node();
+    // If the group still has an empty slot, no probe sequence ever went
+    // past it, and the slot can be reused right away. Otherwise, leave a
+    // tombstone behind.
+    if (Group(d->ctrl + (i & ~(GroupWidth - 1))).matchEmpty()) {
+        d->ctrl[i] = Empty;
+        ++d->growthLeft;
+    } else {
+        d->ctrl[i] = Deleted;
+    }
+    --d->size;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::reserve(int asize)
+{
+    const int newCapacity = QFlatHashData::capacityForSize(asize);
+    detach();
+    if (newCapacity > d->capacity)
+        rehash(newCapacity);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::squeeze()
+{
+    if (!d)
+        return;
+    const int newCapacity = QFlatHashData::capacityForSize(d->size);
+    if (newCapacity < d->capacity) {
+        detach();
+        rehash(newCapacity);
+    }
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::insert(const Key &akey, const T &avalue)
+{
+    detach();
+    const uint h = hash(akey, d->seed);
+    int i = findIndex(akey, h);
+    if (i >= 0) {
+        nodes()[i].value = avalue;
+    } else {
+        i = findFree(h);
+        new (nodes() + i) Node(akey, avalue);
+        setFull(i, h);
+    }
+    return iterator(d, i);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE T &QFlatHash<Key, T>::operator[](const Key &akey)
+{
+    detach();
+    const uint h = hash(akey, d->seed);
+    int i = findIndex(akey, h);
+    if (i < 0) {
+        i = findFree(h);
+        new (nodes() + i) Node(akey, T());
+        setFull(i, h);
+    }
+    return nodes()[i].value;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE const T QFlatHash<Key, T>::operator[](const Key &akey) const
+{
+    return value(akey);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE const T QFlatHash<Key, T>::value(const Key &akey) const
+{
+    const int i = findIndex(akey);
+    return i < 0 ? T() : nodes()[i].value;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE const T QFlatHash<Key, T>::value(const Key &akey, const T &adefaultValue) const
+{
+    const int i = findIndex(akey);
+    return i < 0 ? adefaultValue : nodes()[i].value;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE int QFlatHash<Key, T>::remove(const Key &akey)
+{
+    if (isEmpty()) // prevents detaching shared null
+        return 0;
+    detach();
+    const int i = findIndex(akey);
+    if (i < 0)
+        return 0;
+    eraseAt(i);
+    return 1;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE T QFlatHash<Key, T>::take(const Key &akey)
+{
+    if (isEmpty()) // prevents detaching shared null
+        return T();
+    detach();
+    const int i = findIndex(akey);
+    if (i < 0)
+        return T();
+    T t = std::move(nodes()[i].value);
+    eraseAt(i);
+    return t;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::erase(const_iterator it)
+{
+    Q_ASSERT_X(it.d == d || (d && it.d && d->ref.isShared()), "QFlatHash::erase",
+               "The specified iterator argument 'it' is invalid");
+    if (it == constEnd())
+        return end();
+    // the slots keep their nodes across a detach, so the index stays valid
+    const int i = it.i;
+    detach();
+    eraseAt(i);
+    return iterator(d, QtPrivate::FlatHash::nextFull(d, i + 1));
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::find(const Key &akey)
+{
+    detach();
+    const int i = findIndex(akey);
+    return i < 0 ? end() : iterator(d, i);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE typename QFlatHash<Key, T>::const_iterator QFlatHash<Key, T>::constFind(const Key &akey) const
+{
+    const int i = findIndex(akey);
+    return i < 0 ? constEnd() : const_iterator(d, i);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QList<Key> QFlatHash<Key, T>::keys() const
+{
+    QList<Key> res;
+    res.reserve(size());
+    for (const_iterator it = constBegin(); it != constEnd(); ++it)
+        res.append(it.key());
+    return res;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QList<T> QFlatHash<Key, T>::values() const
+{
+    QList<T> res;
+    res.reserve(size());
+    for (const_iterator it = constBegin(); it != constEnd(); ++it)
+        res.append(it.value());
+    return res;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE bool QFlatHash<Key, T>::operator==(const QFlatHash &other) const
+{
+    if (size() != other.size())
+        return false;
+    if (d == other.d)
+        return true;
+    for (const_iterator it = constBegin(); it != constEnd(); ++it) {
+        const const_iterator o = other.constFind(it.key());
+        if (o == other.constEnd() || !(o.value() == it.value()))
+            return false;
+    }
+    return true;
+}
+
+template <class Key, class T>
+inline void swap(QFlatHash<Key, T> &value1, QFlatHash<Key, T> &value2) Q_DECL_NOTHROW
+{ value1.swap(value2); }
+
+QT_END_NAMESPACE
+
+#endif // QFLATHASH_H
@@ -60,6 +60,7 @@
 #include <qbasicatomic.h>
 #include <qendian.h>
 #include <private/qsimd_p.h>
+#include <private/qmonotonicarena_p.h>
 
 #ifndef QT_BOOTSTRAPPED
 #include <qcoreapplication.h>
@@ -476,13 +477,18 @@ const QHashData QHashData::shared_null = {
 
 void *QHashData::allocateNode(int nodeAlign)
 {
-    void *ptr = strictAlignment ? qMallocAligned(nodeSize, nodeAlign) : malloc(nodeSize);
+    void *ptr = qt_arena_allocate(nodeSize, nodeAlign);
+    if (ptr)
+        return ptr;
+    ptr = strictAlignment ? qMallocAligned(nodeSize, nodeAlign) : malloc(nodeSize);
     Q_CHECK_PTR(ptr);
     return ptr;
 }
 
 void QHashData::freeNode(void *node)
 {
+    if (qt_arena_release(node))
+        return;
     if (strictAlignment)
         qFreeAligned(node);
     else
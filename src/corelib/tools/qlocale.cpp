@@ -3022,6 +3022,11 @@ QString QLocalePrivate::dateTimeToString(QStringView format, const QDateTime &da
 QString QLocaleData::doubleToString(double d, int precision, DoubleForm form,
                                     int width, unsigned flags) const
 {
+    if (this == c()) {
+        CharBuff buff;
+        doubleToCLocale(d, precision, form, width, flags, &buff);
+        return QString::fromLatin1(buff.constData(), buff.size());
+    }
     return doubleToString(m_zero, m_plus, m_minus, m_exponential, m_group, m_decimal,
                           d, precision, form, width, flags);
 }
@@ -3029,6 +3034,55 @@ QString QLocaleData::doubleToString(double d, int precision, DoubleForm form,
 QString QLocaleData::doubleToString(const QChar _zero, const QChar plus, const QChar minus,
                                     const QChar exponential, const QChar group, const QChar decimal,
                                     double d, int precision, DoubleForm form, int width, unsigned flags)
+{
+    CharBuff buff;
+    doubleToCLocale(d, precision, form, width, flags, &buff);
+
+    // every character of the C locale representation maps to exactly one
+    // character of the locale's
+    QString num_str(buff.size(), Qt::Uninitialized);
+    QChar *out = num_str.data();
+    for (char c : qAsConst(buff)) {
+        switch (c) {
+        case '0': case '1': case '2': case '3': case '4':
+        case '5': case '6': case '7': case '8': case '9':
+            *out++ = QChar(ushort(_zero.unicode() + (c - '0')));
+            break;
+        case '.':
+            *out++ = decimal;
+            break;
+        case ',':
+            *out++ = group;
+            break;
+        case 'e':
+        case 'E':
+            *out++ = exponential;
+            break;
+        case '+':
+            *out++ = plus;
+            break;
+        case '-':
+            *out++ = minus;
+            break;
+        default:
+            *out++ = QLatin1Char(c);
+            break;
+        }
+    }
+
+    if (flags & CapitalEorX)
+        num_str = std::move(num_str).toUpper();
+
+    return num_str;
+}
+
+/*
+    Formats \a d the way doubleToString() does for the C locale, but into
+    a char buffer, avoiding the QString allocation. The result is not
+    null-terminated.
+*/
+void QLocaleData::doubleToCLocale(double d, int precision, DoubleForm form, int width,
+                                  unsigned flags, CharBuff *result)
 {
     if (precision != QLocale::FloatingPointShortest && precision < 0)
         precision = 6;
@@ -3036,7 +3090,6 @@ QString QLocaleData::doubleToString(const QChar _zero, const QChar plus, const Q
         width = 0;
 
     bool negative = false;
-    QString num_str;
 
     int decpt;
     int bufSize = 1;
@@ -3048,34 +3101,27 @@ QString QLocaleData::doubleToString(const QChar _zero, const QChar plus, const Q
     else // Add extra digit due to different interpretations of precision. Also, "nan" has to fit.
         bufSize += qMax(2, precision) + 1;
 
-    QVarLengthArray<char> buf(bufSize);
+    CharBuff &num = *result;
+    num.resize(bufSize);
     int length;
 
-    doubleToAscii(d, form, precision, buf.data(), bufSize, negative, length, decpt);
+    doubleToAscii(d, form, precision, num.data(), bufSize, negative, length, decpt);
 
-    if (qstrncmp(buf.data(), "inf", 3) == 0 || qstrncmp(buf.data(), "nan", 3) == 0) {
-        num_str = QString::fromLatin1(buf.data(), length);
+    if (qstrncmp(num.constData(), "inf", 3) == 0 || qstrncmp(num.constData(), "nan", 3) == 0) {
+        num.resize(length);
     } else { // Handle normal numbers
-        QString digits = QString::fromLatin1(buf.data(), length);
-
-        if (_zero.unicode() != '0') {
-            ushort z = _zero.unicode() - '0';
-            for (int i = 0; i < digits.length(); ++i)
-                reinterpret_cast<ushort *>(digits.data())[i] += z;
-        }
+        num.resize(length);
 
         bool always_show_decpt = (flags & ForcePoint);
         switch (form) {
             case DFExponent: {
-                num_str = exponentForm(_zero, decimal, exponential, group, plus, minus,
-                                       digits, decpt, precision, PMDecimalDigits,
-                                       always_show_decpt, flags & ZeroPadExponent);
+                exponentForm(num, decpt, precision, PMDecimalDigits,
+                             always_show_decpt, flags & ZeroPadExponent);
                 break;
             }
             case DFDecimal: {
-                num_str = decimalForm(_zero, decimal, group,
-                                      digits, decpt, precision, PMDecimalDigits,
-                                      always_show_decpt, flags & ThousandsGroup);
+                decimalForm(num, decpt, precision, PMDecimalDigits,
+                            always_show_decpt, flags & ThousandsGroup);
                 break;
             }
             case DFSignificantDigits: {
@@ -3085,24 +3131,22 @@ QString QLocaleData::doubleToString(const QChar _zero, const QChar plus, const Q
                 int cutoff = precision < 0 ? 6 : precision;
                 // Find out which representation is shorter
                 if (precision == QLocale::FloatingPointShortest && decpt > 0) {
-                    cutoff = digits.length() + 4; // 'e', '+'/'-', one digit exponent
+                    cutoff = length + 4; // 'e', '+'/'-', one digit exponent
                     if (decpt <= 10) {
                         ++cutoff;
                     } else {
                         cutoff += decpt > 100 ? 2 : 1;
                     }
-                    if (!always_show_decpt && digits.length() > decpt)
+                    if (!always_show_decpt && length > decpt)
                         ++cutoff; // decpt shown in exponent form, but not in decimal form
                 }
 
-                if (decpt != digits.length() && (decpt <= -4 || decpt > cutoff))
-                    num_str = exponentForm(_zero, decimal, exponential, group, plus, minus,
-                                           digits, decpt, precision, mode,
-                                           always_show_decpt, flags & ZeroPadExponent);
+                if (decpt != length && (decpt <= -4 || decpt > cutoff))
+                    exponentForm(num, decpt, precision, mode,
+                                 always_show_decpt, flags & ZeroPadExponent);
                 else
-                    num_str = decimalForm(_zero, decimal, group,
-                                          digits, decpt, precision, mode,
-                                          always_show_decpt, flags & ThousandsGroup);
+                    decimalForm(num, decpt, precision, mode,
+                                always_show_decpt, flags & ThousandsGroup);
                 break;
             }
         }
@@ -3113,30 +3157,32 @@ QString QLocaleData::doubleToString(const QChar _zero, const QChar plus, const Q
         // pad with zeros. LeftAdjusted overrides this flag). Also, we don't
         // pad special numbers
         if (flags & QLocaleData::ZeroPadded && !(flags & QLocaleData::LeftAdjusted)) {
-            int num_pad_chars = width - num_str.length();
+            int num_pad_chars = width - num.length();
             // leave space for the sign
             if (negative
                     || flags & QLocaleData::AlwaysShowSign
                     || flags & QLocaleData::BlankBeforePositive)
                 --num_pad_chars;
 
-            for (int i = 0; i < num_pad_chars; ++i)
-                num_str.prepend(_zero);
+            if (num_pad_chars > 0)
+                num.insert(0, num_pad_chars, '0');
         }
     }
 
     // add sign
     if (negative)
-        num_str.prepend(minus);
+        num.prepend('-');
     else if (flags & QLocaleData::AlwaysShowSign)
-        num_str.prepend(plus);
+        num.prepend('+');
     else if (flags & QLocaleData::BlankBeforePositive)
-        num_str.prepend(QLatin1Char(' '));
-
-    if (flags & QLocaleData::CapitalEorX)
-        num_str = std::move(num_str).toUpper();
+        num.prepend(' ');
 
-    return num_str;
+    if (flags & QLocaleData::CapitalEorX) {
+        for (char &c : num) {
+            if (c >= 'a' && c <= 'z')
+                c -= 'a' - 'A';
+        }
+    }
 }
 
 QString QLocaleData::longLongToString(qlonglong l, int precision,
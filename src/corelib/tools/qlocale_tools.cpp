@@ -424,12 +424,54 @@ qstrtoll(const char * nptr, const char **endptr, int base, bool *ok)
     return result;
 }
 
+static const char digitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+// Writes the decimal digits of l backwards from end, two at a time, and
+// returns a pointer to the first digit. Zero is written as a single digit.
+template <typename Char>
+static Char *qulltodec_helper(Char *end, qulonglong l, ushort zero)
+{
+    const ushort offset = zero - '0';
+    while (l >= 100) {
+        const uint pair = uint(l % 100) * 2;
+        l /= 100;
+        *--end = Char(digitPairs[pair + 1] + offset);
+        *--end = Char(digitPairs[pair] + offset);
+    }
+    if (l >= 10) {
+        const uint pair = uint(l) * 2;
+        *--end = Char(digitPairs[pair + 1] + offset);
+        *--end = Char(digitPairs[pair] + offset);
+    } else {
+        *--end = Char('0' + uint(l) + offset);
+    }
+    return end;
+}
+
+char *qulltodec(char *end, qulonglong l)
+{
+    return qulltodec_helper(end, l, '0');
+}
+
 QString qulltoa(qulonglong l, int base, const QChar _zero)
 {
     ushort buff[65]; // length of MAX_ULLONG in base 2
     ushort *p = buff + 65;
 
-    if (base != 10 || _zero.unicode() == '0') {
+    if (base == 10) {
+        if (l != 0)
+            p = qulltodec_helper(p, l, _zero.unicode());
+    } else {
         while (l != 0) {
             int c = l % base;
 
@@ -443,89 +485,77 @@ QString qulltoa(qulonglong l, int base, const QChar _zero)
             l /= base;
         }
     }
-    else {
-        while (l != 0) {
-            int c = l % base;
-
-            *(--p) = _zero.unicode() + c;
-
-            l /= base;
-        }
-    }
 
     return QString(reinterpret_cast<QChar *>(p), 65 - (p - buff));
 }
 
-QString &decimalForm(QChar zero, QChar decimal, QChar group,
-                     QString &digits, int decpt, int precision,
-                     PrecisionMode pm,
-                     bool always_show_decpt,
-                     bool thousands_group)
+void decimalForm(QLocaleData::CharBuff &digits, int decpt, int precision,
+                 PrecisionMode pm,
+                 bool always_show_decpt,
+                 bool thousands_group)
 {
     if (decpt < 0) {
-        for (int i = 0; i < -decpt; ++i)
-            digits.prepend(zero);
+        digits.insert(0, -decpt, '0');
         decpt = 0;
     }
     else if (decpt > digits.length()) {
-        for (int i = digits.length(); i < decpt; ++i)
-            digits.append(zero);
+        digits.insert(digits.length(), decpt - digits.length(), '0');
     }
 
     if (pm == PMDecimalDigits) {
-        uint decimal_digits = digits.length() - decpt;
-        for (int i = decimal_digits; i < precision; ++i)
-            digits.append(zero);
+        int decimal_digits = digits.length() - decpt;
+        if (decimal_digits < precision)
+            digits.insert(digits.length(), precision - decimal_digits, '0');
     }
     else if (pm == PMSignificantDigits) {
-        for (int i = digits.length(); i < precision; ++i)
-            digits.append(zero);
+        if (digits.length() < precision)
+            digits.insert(digits.length(), precision - digits.length(), '0');
     }
     else { // pm == PMChopTrailingZeros
     }
 
     if (always_show_decpt || decpt < digits.length())
-        digits.insert(decpt, decimal);
+        digits.insert(decpt, '.');
 
     if (thousands_group) {
         for (int i = decpt - 3; i > 0; i -= 3)
-            digits.insert(i, group);
+            digits.insert(i, ',');
     }
 
     if (decpt == 0)
-        digits.prepend(zero);
-
-    return digits;
+        digits.prepend('0');
 }
 
-QString &exponentForm(QChar zero, QChar decimal, QChar exponential,
-                      QChar group, QChar plus, QChar minus,
-                      QString &digits, int decpt, int precision,
-                      PrecisionMode pm,
-                      bool always_show_decpt,
-                      bool leading_zero_in_exponent)
+void exponentForm(QLocaleData::CharBuff &digits, int decpt, int precision,
+                  PrecisionMode pm,
+                  bool always_show_decpt,
+                  bool leading_zero_in_exponent)
 {
     int exp = decpt - 1;
 
     if (pm == PMDecimalDigits) {
-        for (int i = digits.length(); i < precision + 1; ++i)
-            digits.append(zero);
+        if (digits.length() < precision + 1)
+            digits.insert(digits.length(), precision + 1 - digits.length(), '0');
     }
     else if (pm == PMSignificantDigits) {
-        for (int i = digits.length(); i < precision; ++i)
-            digits.append(zero);
+        if (digits.length() < precision)
+            digits.insert(digits.length(), precision - digits.length(), '0');
     }
     else { // pm == PMChopTrailingZeros
     }
 
     if (always_show_decpt || digits.length() > 1)
-        digits.insert(1, decimal);
+        digits.insert(1, '.');
 
-    digits.append(exponential);
-    digits.append(QLocaleData::longLongToString(zero, group, plus, minus,
-                   exp, leading_zero_in_exponent ? 2 : 1, 10, -1, QLocaleData::AlwaysShowSign));
+    digits.append('e');
+    digits.append(exp < 0 ? '-' : '+');
 
-    return digits;
+    char buff[8];
+    char *end = buff + sizeof buff;
+    char *p = qulltodec(end, qAbs(exp));
+    if (leading_zero_in_exponent && end - p < 2)
+        *--p = '0';
+    digits.append(p, int(end - p));
 }
 
 double qstrtod(const char *s00, const char **se, bool *ok)
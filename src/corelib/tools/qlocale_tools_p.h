@@ -83,6 +83,7 @@ void doubleToAscii(double d, QLocaleData::DoubleForm form, int precision, char *
                    bool &sign, int &length, int &decpt);
 
 QString qulltoa(qulonglong l, int base, const QChar _zero);
+char *qulltodec(char *end, qulonglong l);
 Q_CORE_EXPORT QString qdtoa(qreal d, int *decpt, int *sign);
 
 enum PrecisionMode {
@@ -91,17 +92,14 @@ enum PrecisionMode {
     PMChopTrailingZeros =   0x03
 };
 
-QString &decimalForm(QChar zero, QChar decimal, QChar group,
-                     QString &digits, int decpt, int precision,
-                     PrecisionMode pm,
-                     bool always_show_decpt,
-                     bool thousands_group);
-QString &exponentForm(QChar zero, QChar decimal, QChar exponential,
-                      QChar group, QChar plus, QChar minus,
-                      QString &digits, int decpt, int precision,
-                      PrecisionMode pm,
-                      bool always_show_decpt,
-                      bool leading_zero_in_exponent);
+void decimalForm(QLocaleData::CharBuff &digits, int decpt, int precision,
+                 PrecisionMode pm,
+                 bool always_show_decpt,
+                 bool thousands_group);
+void exponentForm(QLocaleData::CharBuff &digits, int decpt, int precision,
+                  PrecisionMode pm,
+                  bool always_show_decpt,
+                  bool leading_zero_in_exponent);
 
 inline bool isZero(double d)
 {
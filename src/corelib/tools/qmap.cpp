@@ -38,6 +38,7 @@
 ****************************************************************************/
 
 #include "qmap.h"
+#include "qmonotonicarena_p.h"
 
 #include <stdlib.h>
 
@@ -290,7 +291,8 @@ void QMapDataBase::freeNodeAndRebalance(QMapNodeBase *z)
     if (x)
         x->setColor(QMapNodeBase::Black);
     }
-    free(y);
+    if (!qt_arena_release(y))
+        free(y);
     --size;
 }
 
@@ -311,6 +313,8 @@ static inline int qMapAlignmentThreshold()
 
 static inline void *qMapAllocate(int alloc, int alignment)
 {
+    if (void *node = qt_arena_allocate(alloc, alignment))
+        return node;
     return alignment > qMapAlignmentThreshold()
         ? qMallocAligned(alloc, alignment)
         : ::malloc(alloc);
@@ -318,6 +322,8 @@ static inline void *qMapAllocate(int alloc, int alignment)
 
 static inline void qMapDeallocate(QMapNodeBase *node, int alignment)
 {
+    if (qt_arena_release(node))
+        return;
     if (alignment > qMapAlignmentThreshold())
         qFreeAligned(node);
     else
@@ -0,0 +1,425 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qmonotonicarena.h"
+#include "qmonotonicarena_p.h"
+
+#include <stdlib.h>
+#if defined(Q_OS_WIN)
+#  include <malloc.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QMonotonicArena
+    \inmodule QtCore
+    \brief The QMonotonicArena class provides scoped, per-thread memory for
+    Qt's containers.
+    \since 5.12
+
+    \ingroup tools
+
+    \reentrant
+
+    Code that processes one request, one file or one message at a time
+    often creates thousands of short-lived strings, byte arrays, vectors,
+    hashes and maps, and destroys them all shortly after. Each of them is a
+    separate malloc() and free() pair.
+
+    Creating a QMonotonicArena installs it as the current arena of the
+    calling thread until it is destroyed. While it is installed, the memory
+    blocks of QString, QByteArray, QVector and the other containers based
+    on QArrayData, as well as the nodes of QHash and QMap, are carved out
+    of large blocks owned by the arena with a simple pointer increment.
+    Freeing such memory does not make it available again: the arena is
+    monotonic, and gives the memory back to the system a whole block at a
+    time, once nothing allocated from the block is alive.
+
+    \snippet code/src_corelib_tools_qmonotonicarena.cpp 0
+
+    Data allocated from an arena may safely outlive it. Such data keeps the
+    block it was allocated from alive until it is freed, so it costs more
+    memory than a heap allocation would, but it stays valid. Modifying
+    escaped data outside of the arena's scope detaches or reallocates it on
+    the heap as usual.
+
+    Arenas can be nested: destroying an arena reinstalls the one that was
+    current when it was created. Arenas must be destroyed in the thread that
+    created them, in the reverse order of their creation, which is what
+    happens naturally when they are created on the stack. Memory allocated
+    from an arena can be freed in any thread.
+
+    Only allocations of up to 16 kilobytes are served from the arena; larger
+    ones, and allocations made while no arena is installed, use the heap.
+    Memory allocated with \c new, such as the items of a QList of large or
+    non-movable types, never comes from an arena.
+
+    \sa isSupported()
+*/
+
+#ifdef QT_HAVE_MONOTONIC_ARENA
+
+namespace {
+enum : size_t {
+    BlockSize = 64 * 1024,
+    MaxAllocationSize = BlockSize / 4,
+    MaxAlignment = 256
+};
+
+// While the arena allocates from a block, the block's count of outstanding
+// allocations is biased by BlockBias, which is larger than the number of
+// allocations a block can hold, so that it cannot drop to zero before the
+// arena moves on to another block.
+enum { BlockBias = int(BlockSize) };
+
+// Blocks are aligned on their size, so the block an allocation belongs to
+// is found by masking its address. The addresses of the live blocks are
+// kept in a lock-free, open-addressing table, which lets any thread find
+// out whether a pointer it is about to free came from an arena.
+enum { RegistrySize = 4096, RegistryShift = 20, MaxProbes = 16 };
+enum : quintptr { EmptySlot = 0, DeletedSlot = 1 };
+
+struct QArenaBlock
+{
+    QAtomicInt refs;
+};
+}
+
+QBasicAtomicInt qt_arena_block_count = Q_BASIC_ATOMIC_INITIALIZER(0);
+static QBasicAtomicInteger<quintptr> qt_arena_registry[RegistrySize];
+
+static inline uint registrySlot(quintptr block) Q_DECL_NOTHROW
+{
+    return (uint(block / BlockSize) * 0x9e3779b1U) >> RegistryShift;
+}
+
+static bool registerBlock(QArenaBlock *block) Q_DECL_NOTHROW
+{
+    const quintptr key = quintptr(block);
+    uint slot = registrySlot(key);
+    for (int i = 0; i < MaxProbes; ++i, slot = (slot + 1) % RegistrySize) {
+        const quintptr value = qt_arena_registry[slot].load();
+        if ((value == EmptySlot || value == DeletedSlot)
+                && qt_arena_registry[slot].testAndSetRelease(value, key)) {
+            qt_arena_block_count.ref();
+            return true;
+        }
+    }
+    return false;
+}
+
+static void unregisterBlock(QArenaBlock *block) Q_DECL_NOTHROW
+{
+    const quintptr key = quintptr(block);
+    uint slot = registrySlot(key);
+    for (int i = 0; i < MaxProbes; ++i, slot = (slot + 1) % RegistrySize) {
+        if (qt_arena_registry[slot].load() == key) {
+            qt_arena_registry[slot].storeRelease(DeletedSlot);
+            qt_arena_block_count.deref();
+            return;
+        }
+    }
+    Q_UNREACHABLE();
+}
+
+static QArenaBlock *findBlock(const void *ptr) Q_DECL_NOTHROW
+{
+    // A live block never overlaps memory that did not come from it, so a
+    // match is only found for pointers into a live block
+    const quintptr key = quintptr(ptr) & ~quintptr(BlockSize - 1);
+    uint slot = registrySlot(key);
+    for (int i = 0; i < MaxProbes; ++i, slot = (slot + 1) % RegistrySize) {
+        const quintptr value = qt_arena_registry[slot].loadAcquire();
+        if (value == key)
+            return reinterpret_cast<QArenaBlock *>(key);
+        if (value == EmptySlot)
+            break;
+    }
+    return nullptr;
+}
+
+static QArenaBlock *allocateBlock() Q_DECL_NOTHROW
+{
+    void *memory;
+#if defined(Q_OS_WIN)
+    memory = _aligned_malloc(BlockSize, BlockSize);
+#elif defined(Q_OS_UNIX)
+    if (posix_memalign(&memory, BlockSize, BlockSize) != 0)
+        memory = nullptr;
+#else
+    memory = qMallocAligned(BlockSize, BlockSize);
+#endif
+    if (!memory)
+        return nullptr;
+
+    QArenaBlock *block = new (memory) QArenaBlock;
+    block->refs.store(BlockBias);
+    if (Q_LIKELY(registerBlock(block)))
+        return block;
+
+    // too many live blocks; let the caller fall back to the heap
+    block->~QArenaBlock();
+#if defined(Q_OS_WIN)
+    _aligned_free(memory);
+#elif defined(Q_OS_UNIX)
+    ::free(memory);
+#else
+    qFreeAligned(memory);
+#endif
+    return nullptr;
+}
+
+static void releaseBlock(QArenaBlock *block) Q_DECL_NOTHROW
+{
+    unregisterBlock(block);
+    block->~QArenaBlock();
+#if defined(Q_OS_WIN)
+    _aligned_free(block);
+#elif defined(Q_OS_UNIX)
+    ::free(block);
+#else
+    qFreeAligned(block);
+#endif
+}
+
+#endif // QT_HAVE_MONOTONIC_ARENA
+
+class QMonotonicArenaPrivate
+{
+public:
+    QMonotonicArenaPrivate(QMonotonicArena *qq)
+        : q(qq), previous(nullptr), bytesAllocated(0)
+#ifdef QT_HAVE_MONOTONIC_ARENA
+        , block(nullptr), next(0), end(0), allocations(0)
+#endif
+    {}
+
+    QMonotonicArena *q;
+    QMonotonicArenaPrivate *previous;
+    qint64 bytesAllocated;
+
+#ifdef QT_HAVE_MONOTONIC_ARENA
+    void *allocate(size_t size, size_t alignment) Q_DECL_NOTHROW;
+    bool startBlock() Q_DECL_NOTHROW;
+    bool retireBlock() Q_DECL_NOTHROW;
+
+    QArenaBlock *block;
+    quintptr next;
+    quintptr end;
+    int allocations;
+#endif
+};
+
+#ifdef QT_HAVE_MONOTONIC_ARENA
+
+static thread_local QMonotonicArenaPrivate *qt_current_arena = nullptr;
+
+/*!
+    \internal
+
+    Drops the bias the arena holds on its current block. Returns \c true if
+    nothing allocated from the block is alive anymore, in which case the
+    block still belongs to the arena.
+*/
+bool QMonotonicArenaPrivate::retireBlock() Q_DECL_NOTHROW
+{
+    const int delta = allocations - BlockBias;
+    allocations = 0;
+    return block->refs.fetchAndAddOrdered(delta) + delta == 0;
+}
+
+/*!
+    \internal
+
+    Makes the arena allocate from a fresh block, recycling the current one
+    if everything allocated from it has been freed already. Blocks that
+    still hold live data are left to be released by the last
+    qt_arena_release_helper() call on them.
+*/
+bool QMonotonicArenaPrivate::startBlock() Q_DECL_NOTHROW
+{
+    if (block && retireBlock()) {
+        block->refs.store(BlockBias);
+    } else {
+        block = allocateBlock();
+        if (!block) {
+            next = end = 0;
+            return false;
+        }
+    }
+    next = quintptr(block) + sizeof(QArenaBlock);
+    end = quintptr(block) + BlockSize;
+    return true;
+}
+
+inline void *QMonotonicArenaPrivate::allocate(size_t size, size_t alignment) Q_DECL_NOTHROW
+{
+    Q_ASSERT(alignment && !(alignment & (alignment - 1)));
+    if (size > MaxAllocationSize || alignment > MaxAlignment)
+        return nullptr;
+
+    quintptr ptr = (next + alignment - 1) & ~quintptr(alignment - 1);
+    if (Q_UNLIKELY(!block || ptr + size > end)) {
+        if (!startBlock())
+            return nullptr;
+        ptr = (next + alignment - 1) & ~quintptr(alignment - 1);
+    }
+    next = ptr + size;
+    ++allocations;
+    bytesAllocated += size;
+    return reinterpret_cast<void *>(ptr);
+}
+
+/*!
+    \internal
+
+    Returns a block of \a size bytes aligned on \a alignment from the arena
+    installed in the current thread, or \c nullptr if there is no arena or
+    it cannot serve the request. In the latter case the caller should use
+    the heap.
+*/
+void *qt_arena_allocate(size_t size, size_t alignment) Q_DECL_NOTHROW
+{
+    QMonotonicArenaPrivate *d = qt_current_arena;
+    return d ? d->allocate(size, alignment) : nullptr;
+}
+
+/*!
+    \internal
+
+    Returns \c true if \a ptr was allocated by qt_arena_allocate() and has
+    not been released yet.
+*/
+bool qt_arena_contains_helper(const void *ptr) Q_DECL_NOTHROW
+{
+    return findBlock(ptr) != nullptr;
+}
+
+/*!
+    \internal
+
+    Releases \a ptr and returns \c true if it was allocated by
+    qt_arena_allocate(); otherwise returns \c false, and the caller should
+    free \a ptr itself. This may be called from any thread.
+*/
+bool qt_arena_release_helper(void *ptr) Q_DECL_NOTHROW
+{
+    QArenaBlock *block = findBlock(ptr);
+    if (!block)
+        return false;
+    if (!block->refs.deref())
+        releaseBlock(block);
+    return true;
+}
+
+#endif // QT_HAVE_MONOTONIC_ARENA
+
+/*!
+    Constructs an arena and installs it as the current arena of the calling
+    thread.
+
+    If the platform does not support arenas, the arena is not installed and
+    all the memory keeps coming from the heap.
+
+    \sa isSupported(), current()
+*/
+QMonotonicArena::QMonotonicArena()
+    : d(new QMonotonicArenaPrivate(this))
+{
+#ifdef QT_HAVE_MONOTONIC_ARENA
+    d->previous = qt_current_arena;
+    qt_current_arena = d;
+#endif
+}
+
+/*!
+    Uninstalls the arena, reinstalling the arena that was current when this
+    one was created, if any, and releases the memory of the arena that is
+    not used by data that outlives it.
+*/
+QMonotonicArena::~QMonotonicArena()
+{
+#ifdef QT_HAVE_MONOTONIC_ARENA
+    Q_ASSERT_X(qt_current_arena == d, "QMonotonicArena::~QMonotonicArena",
+               "Arenas must be destroyed in the thread that created them, in reverse order");
+    qt_current_arena = d->previous;
+    if (d->block && d->retireBlock())
+        releaseBlock(d->block);
+#endif
+    delete d;
+}
+
+/*!
+    Returns the arena installed in the calling thread, or \c nullptr if
+    there is none.
+*/
+QMonotonicArena *QMonotonicArena::current() Q_DECL_NOTHROW
+{
+#ifdef QT_HAVE_MONOTONIC_ARENA
+    return qt_current_arena ? qt_current_arena->q : nullptr;
+#else
+    return nullptr;
+#endif
+}
+
+/*!
+    Returns \c true if arenas are supported on this platform. Arenas rely on
+    thread-local storage support in the compiler.
+*/
+bool QMonotonicArena::isSupported() Q_DECL_NOTHROW
+{
+#ifdef QT_HAVE_MONOTONIC_ARENA
+    return true;
+#else
+    return false;
+#endif
+}
+
+/*!
+    Returns the number of bytes the containers have allocated from this
+    arena so far. Memory that was freed again is included.
+*/
+qint64 QMonotonicArena::bytesAllocated() const Q_DECL_NOTHROW
+{
+    return d->bytesAllocated;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,95 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QMONOTONICARENA_P_H
+#define QMONOTONICARENA_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qatomic.h>
+
+QT_BEGIN_NAMESPACE
+
+// The allocators of QArrayData, QHashData and QMapDataBase ask the arena
+// installed in the current thread (if any) for memory before falling back
+// to malloc, and hand every block back to qt_arena_release() before freeing
+// it. Memory that did not come from an arena is rejected by
+// qt_arena_release() with a single load while no arena block is alive.
+
+#if !defined(QT_BOOTSTRAPPED) && defined(Q_COMPILER_THREAD_LOCAL)
+#  define QT_HAVE_MONOTONIC_ARENA
+
+extern QBasicAtomicInt qt_arena_block_count;
+
+void *qt_arena_allocate(size_t size, size_t alignment) Q_DECL_NOTHROW;
+bool qt_arena_contains_helper(const void *ptr) Q_DECL_NOTHROW;
+bool qt_arena_release_helper(void *ptr) Q_DECL_NOTHROW;
+
+inline bool qt_arena_contains(const void *ptr) Q_DECL_NOTHROW
+{
+    return Q_UNLIKELY(qt_arena_block_count.load() != 0) && qt_arena_contains_helper(ptr);
+}
+
+inline bool qt_arena_release(void *ptr) Q_DECL_NOTHROW
+{
+    return Q_UNLIKELY(qt_arena_block_count.load() != 0) && qt_arena_release_helper(ptr);
+}
+
+#else
+
+inline void *qt_arena_allocate(size_t, size_t) Q_DECL_NOTHROW { return nullptr; }
+inline bool qt_arena_contains(const void *) Q_DECL_NOTHROW { return false; }
+inline bool qt_arena_release(void *) Q_DECL_NOTHROW { return false; }
+
+#endif
+
+QT_END_NAMESPACE
+
+#endif // QMONOTONICARENA_P_H
@@ -42,6 +42,7 @@
 #include "qalgorithms.h"
 #include <QByteArray>
 #include <stdio.h>
+#include <string.h>
 
 #ifdef Q_OS_LINUX
 #  include "../testlib/3rdparty/valgrind_p.h"
@@ -657,7 +658,8 @@ void qDetectCpuFeatures()
     if (!disable.isEmpty()) {
         disable.prepend(' ');
         for (int i = 0; i < features_count; ++i) {
-            if (disable.contains(features_string + features_indices[i]))
+            // don't use QByteArray::contains(): searching may itself dispatch on the CPU features
+            if (strstr(disable.constData(), features_string + features_indices[i]))
                 f &= ~(Q_UINT64_C(1) << i);
         }
     }
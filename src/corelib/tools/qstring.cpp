@@ -3462,6 +3462,11 @@ int qFindString(
     if (sl == 1)
         return findChar(haystack0, haystackLen, needle0[0], from, cs);
 
+    FirstLastFilter filter;
+    if (filter.init((const ushort *)needle0, sl, cs))
+        return qFindStringFirstLast((const ushort *)haystack0, l, qMax(from, 0),
+                                    (const ushort *)needle0, sl, filter, cs);
+
     /*
         We use the Boyer-Moore algorithm in cases where the overhead
         for the skip table should pay off, otherwise we use a simple
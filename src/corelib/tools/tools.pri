@@ -23,6 +23,7 @@ HEADERS +=  \
         tools/qdatetime_p.h \
         tools/qdoublescanprint_p.h \
         tools/qeasingcurve.h \
+        tools/qflathash.h \
         tools/qfreelist_p.h \
         tools/qhash.h \
         tools/qhashfunctions.h \
@@ -35,6 +36,8 @@ HEADERS +=  \
         tools/qlocale_tools_p.h \
         tools/qlocale_data_p.h \
         tools/qmap.h \
+        tools/qmonotonicarena.h \
+        tools/qmonotonicarena_p.h \
         tools/qmargins.h \
         tools/qmessageauthenticationcode.h \
         tools/qcontiguouscache.h \
@@ -84,6 +87,7 @@ SOURCES += \
         tools/qcryptographichash.cpp \
         tools/qdatetime.cpp \
         tools/qeasingcurve.cpp \
+        tools/qflathash.cpp \
         tools/qfreelist.cpp \
         tools/qhash.cpp \
         tools/qline.cpp \
@@ -93,6 +97,7 @@ SOURCES += \
         tools/qlocale_tools.cpp \
         tools/qpoint.cpp \
         tools/qmap.cpp \
+        tools/qmonotonicarena.cpp \
         tools/qmargins.cpp \
         tools/qmessageauthenticationcode.cpp \
         tools/qcontiguouscache.cpp \
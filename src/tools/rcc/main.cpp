@@ -127,6 +127,9 @@ int runRcc(int argc, char *argv[])
     QCommandLineOption rootOption(QStringLiteral("root"), QStringLiteral("Prefix resource access path with root path."), QStringLiteral("path"));
     parser.addOption(rootOption);
 
+    QCommandLineOption compressionAlgoOption(QStringLiteral("compress-algo"), QStringLiteral("Compress input files using algorithm <algo> ([zlib], zstd, none)."), QStringLiteral("algo"));
+    parser.addOption(compressionAlgoOption);
+
     QCommandLineOption compressOption(QStringLiteral("compress"), QStringLiteral("Compress input files by <level>."), QStringLiteral("level"));
     parser.addOption(compressOption);
 
@@ -139,6 +142,9 @@ int runRcc(int argc, char *argv[])
     QCommandLineOption binaryOption(QStringLiteral("binary"), QStringLiteral("Output a binary file for use as a dynamic resource."));
     parser.addOption(binaryOption);
 
+    QCommandLineOption pathIndexOption(QStringLiteral("path-index"), QStringLiteral("Add an index of all paths to a binary file for faster lookups."));
+    parser.addOption(pathIndexOption);
+
     QCommandLineOption passOption(QStringLiteral("pass"), QStringLiteral("Pass number for big resources"), QStringLiteral("number"));
     parser.addOption(passOption);
 
@@ -171,12 +177,19 @@ int runRcc(int argc, char *argv[])
         formatVersion = parser.value(formatVersionOption).toUInt(&ok);
         if (!ok) {
             errorMsg = QLatin1String("Invalid format version specified");
-        } else if (formatVersion != 1 && formatVersion != 2) {
+        } else if (formatVersion < 1 || formatVersion > 3) {
             errorMsg = QLatin1String("Unsupported format version specified");
         }
     }
+    if (parser.isSet(pathIndexOption)) {
+        if (parser.isSet(formatVersionOption) && formatVersion < 3)
+            errorMsg = QLatin1String("The path index requires format version 3");
+        formatVersion = 3;
+    }
 
     RCCResourceLibrary library(formatVersion);
+    library.setExplicitFormatVersion(parser.isSet(formatVersionOption));
+    library.setPathIndex(parser.isSet(pathIndexOption));
     if (parser.isSet(nameOption))
         library.setInitName(parser.value(nameOption));
     if (parser.isSet(rootOption)) {
@@ -185,6 +198,12 @@ int runRcc(int argc, char *argv[])
                 || library.resourceRoot().at(0) != QLatin1Char('/'))
             errorMsg = QLatin1String("Root must start with a /");
     }
+    if (parser.isSet(compressionAlgoOption)) {
+        library.setCompressionAlgorithm(RCCResourceLibrary::parseCompressionAlgorithm(parser.value(compressionAlgoOption), &errorMsg));
+        if (library.compressionAlgorithm() == RCCResourceLibrary::CompressionAlgorithm::Zstd
+                && parser.isSet(formatVersionOption) && formatVersion < 3)
+            errorMsg = QLatin1String("Zstandard compression requires format version 3");
+    }
     if (parser.isSet(compressOption))
         library.setCompressLevel(parser.value(compressOption).toInt());
     if (parser.isSet(nocompressOption))
@@ -37,10 +37,15 @@
 #include <qiodevice.h>
 #include <qlocale.h>
 #include <qstack.h>
+#include <qvector.h>
 #include <qxmlstream.h>
 
 #include <algorithm>
 
+#if QT_CONFIG(zstd)
+#  include <zstd.h>
+#endif
+
 // Note: A copy of this file is used in Qt Designer (qttools/src/designer/src/lib/shared/rcc.cpp)
 
 QT_BEGIN_NAMESPACE
@@ -48,6 +53,8 @@ QT_BEGIN_NAMESPACE
 enum {
     CONSTANT_USENAMESPACE = 1,
     CONSTANT_COMPRESSLEVEL_DEFAULT = -1,
+    CONSTANT_ZSTDCOMPRESSLEVEL_DEFAULT = 14,
+    CONSTANT_ZSTDCHUNKSIZE = 256 * 1024,
     CONSTANT_COMPRESSTHRESHOLD_DEFAULT = 70
 };
 
@@ -90,13 +97,15 @@ public:
     {
         NoFlags = 0x00,
         Compressed = 0x01,
-        Directory = 0x02
+        Directory = 0x02,
+        CompressedZstd = 0x04
     };
 
     RCCFileInfo(const QString &name = QString(), const QFileInfo &fileInfo = QFileInfo(),
                 QLocale::Language language = QLocale::C,
                 QLocale::Country country = QLocale::AnyCountry,
                 uint flags = NoFlags,
+                RCCResourceLibrary::CompressionAlgorithm compressAlgo = RCCResourceLibrary::CompressionAlgorithm::Zlib,
                 int compressLevel = CONSTANT_COMPRESSLEVEL_DEFAULT,
                 int compressThreshold = CONSTANT_COMPRESSTHRESHOLD_DEFAULT);
     ~RCCFileInfo();
@@ -115,6 +124,7 @@ public:
     QFileInfo m_fileInfo;
     RCCFileInfo *m_parent;
     QHash<QString, RCCFileInfo*> m_children;
+    RCCResourceLibrary::CompressionAlgorithm m_compressAlgo;
     int m_compressLevel;
     int m_compressThreshold;
 
@@ -125,7 +135,7 @@ public:
 
 RCCFileInfo::RCCFileInfo(const QString &name, const QFileInfo &fileInfo,
     QLocale::Language language, QLocale::Country country, uint flags,
-    int compressLevel, int compressThreshold)
+    RCCResourceLibrary::CompressionAlgorithm compressAlgo, int compressLevel, int compressThreshold)
 {
     m_name = name;
     m_fileInfo = fileInfo;
@@ -136,6 +146,7 @@ RCCFileInfo::RCCFileInfo(const QString &name, const QFileInfo &fileInfo,
     m_nameOffset = 0;
     m_dataOffset = 0;
     m_childOffset = 0;
+    m_compressAlgo = compressAlgo;
     m_compressLevel = compressLevel;
     m_compressThreshold = compressThreshold;
 }
@@ -236,9 +247,45 @@ qint64 RCCFileInfo::writeDataBlob(RCCResourceLibrary &lib, qint64 offset,
     }
     QByteArray data = file.readAll();
 
+#if QT_CONFIG(zstd)
+    // Compress in independent frames so that QResource can decompress only
+    // the part of the file that is being read
+    if (m_compressAlgo == RCCResourceLibrary::CompressionAlgorithm::Zstd
+            && m_compressLevel != 0 && data.size() != 0) {
+        if (!lib.m_zstdCCtx)
+            lib.m_zstdCCtx = ZSTD_createCCtx();
+        const int level = m_compressLevel < 0 ? int(CONSTANT_ZSTDCOMPRESSLEVEL_DEFAULT)
+                                              : qMin(m_compressLevel, ZSTD_maxCLevel());
+        QByteArray compressed;
+        for (int chunk = 0; chunk < data.size(); chunk += CONSTANT_ZSTDCHUNKSIZE) {
+            const size_t chunkSize = qMin(data.size() - chunk, int(CONSTANT_ZSTDCHUNKSIZE));
+            const int n = compressed.size();
+            compressed.resize(n + int(ZSTD_compressBound(chunkSize)));
+            const size_t result = ZSTD_compressCCtx(lib.m_zstdCCtx, compressed.data() + n,
+                                                    compressed.size() - n,
+                                                    data.constData() + chunk, chunkSize, level);
+            if (ZSTD_isError(result)) {
+                *errorMessage = QString::fromLatin1("Could not compress %1: %2\n")
+                        .arg(m_fileInfo.absoluteFilePath(), QString::fromLatin1(ZSTD_getErrorName(result)));
+                return 0;
+            }
+            compressed.resize(n + int(result));
+        }
+
+        int compressRatio = int(100.0 * (data.size() - compressed.size()) / data.size());
+        if (compressRatio >= m_compressThreshold) {
+            data = compressed;
+            m_flags |= CompressedZstd;
+            // see addFile()
+            Q_ASSERT(lib.m_formatVersion >= 3);
+        }
+    }
+#endif // QT_CONFIG(zstd)
+
 #ifndef QT_NO_COMPRESS
     // Check if compression is useful for this file
-    if (m_compressLevel != 0 && data.size() != 0) {
+    if (m_compressAlgo == RCCResourceLibrary::CompressionAlgorithm::Zlib
+            && m_compressLevel != 0 && data.size() != 0) {
         QByteArray compressed =
             qCompress(reinterpret_cast<uchar *>(data.data()), data.size(), m_compressLevel);
 
@@ -343,7 +390,8 @@ RCCResourceLibrary::Strings::Strings() :
    ATTRIBUTE_PREFIX(QLatin1String("prefix")),
    ATTRIBUTE_ALIAS(QLatin1String("alias")),
    ATTRIBUTE_THRESHOLD(QLatin1String("threshold")),
-   ATTRIBUTE_COMPRESS(QLatin1String("compress"))
+   ATTRIBUTE_COMPRESS(QLatin1String("compress")),
+   ATTRIBUTE_COMPRESSALGO(QLatin1String("compression-algorithm"))
 {
 }
 
@@ -351,15 +399,20 @@ RCCResourceLibrary::RCCResourceLibrary(quint8 formatVersion)
   : m_root(0),
     m_format(C_Code),
     m_verbose(false),
+    m_compressionAlgo(CompressionAlgorithm::Zlib),
     m_compressLevel(CONSTANT_COMPRESSLEVEL_DEFAULT),
     m_compressThreshold(CONSTANT_COMPRESSTHRESHOLD_DEFAULT),
     m_treeOffset(0),
     m_namesOffset(0),
     m_dataOffset(0),
+    m_indexOffset(0),
     m_useNameSpace(CONSTANT_USENAMESPACE),
+    m_pathIndex(false),
     m_errorDevice(0),
     m_outDevice(0),
-    m_formatVersion(formatVersion)
+    m_formatVersion(formatVersion),
+    m_explicitFormatVersion(false),
+    m_zstdCCtx(0)
 {
     m_out.reserve(30 * 1000 * 1000);
 }
@@ -367,6 +420,9 @@ RCCResourceLibrary::RCCResourceLibrary(quint8 formatVersion)
 RCCResourceLibrary::~RCCResourceLibrary()
 {
     delete m_root;
+#if QT_CONFIG(zstd)
+    ZSTD_freeCCtx(m_zstdCCtx);
+#endif
 }
 
 enum RCCXmlTag {
@@ -391,6 +447,7 @@ bool RCCResourceLibrary::interpretResourceFile(QIODevice *inputDevice,
     QLocale::Language language = QLocale::c().language();
     QLocale::Country country = QLocale::c().country();
     QString alias;
+    CompressionAlgorithm compressAlgo = m_compressionAlgo;
     int compressLevel = m_compressLevel;
     int compressThreshold = m_compressThreshold;
 
@@ -444,6 +501,15 @@ bool RCCResourceLibrary::interpretResourceFile(QIODevice *inputDevice,
                     if (attributes.hasAttribute(m_strings.ATTRIBUTE_ALIAS))
                         alias = attributes.value(m_strings.ATTRIBUTE_ALIAS).toString();
 
+                    compressAlgo = m_compressionAlgo;
+                    if (attributes.hasAttribute(m_strings.ATTRIBUTE_COMPRESSALGO)) {
+                        QString errorMsg;
+                        compressAlgo = parseCompressionAlgorithm(attributes.value(m_strings.ATTRIBUTE_COMPRESSALGO).toString(),
+                                                                 &errorMsg);
+                        if (!errorMsg.isEmpty())
+                            reader.raiseError(errorMsg);
+                    }
+
                     compressLevel = m_compressLevel;
                     if (attributes.hasAttribute(m_strings.ATTRIBUTE_COMPRESS))
                         compressLevel = attributes.value(m_strings.ATTRIBUTE_COMPRESS).toString().toInt();
@@ -455,6 +521,14 @@ bool RCCResourceLibrary::interpretResourceFile(QIODevice *inputDevice,
                     // Special case for -no-compress. Overrides all other settings.
                     if (m_compressLevel == -2)
                         compressLevel = 0;
+
+#if QT_CONFIG(zstd)
+                    // addFile() raises the version only if none was asked for
+                    if (compressAlgo == CompressionAlgorithm::Zstd && compressLevel != 0
+                            && m_explicitFormatVersion && m_formatVersion < 3) {
+                        reader.raiseError(QLatin1String("Zstandard compression requires format version 3"));
+                    }
+#endif
                 }
             } else {
                 reader.raiseError(QString(QLatin1String("unexpected tag: %1")).arg(reader.name().toString()));
@@ -521,6 +595,7 @@ bool RCCResourceLibrary::interpretResourceFile(QIODevice *inputDevice,
                                             language,
                                             country,
                                             RCCFileInfo::NoFlags,
+                                            compressAlgo,
                                             compressLevel,
                                             compressThreshold)
                                 );
@@ -550,6 +625,7 @@ bool RCCResourceLibrary::interpretResourceFile(QIODevice *inputDevice,
                                                     language,
                                                     country,
                                                     child.isDir() ? RCCFileInfo::Directory : RCCFileInfo::NoFlags,
+                                                    compressAlgo,
                                                     compressLevel,
                                                     compressThreshold)
                                         );
@@ -617,6 +693,14 @@ bool RCCResourceLibrary::addFile(const QString &alias, const RCCFileInfo &file)
         }
     }
 
+#if QT_CONFIG(zstd)
+    // Older versions of QResource would not know about the flag. The
+    // version is settled here, before the header of binary resources,
+    // whose layout depends on it, is written.
+    if (file.m_compressAlgo == CompressionAlgorithm::Zstd && file.m_compressLevel != 0)
+        m_formatVersion = qMax<quint8>(m_formatVersion, 3);
+#endif
+
     const QString filename = nodes.at(nodes.size()-1);
     RCCFileInfo *s = new RCCFileInfo(file);
     s->m_parent = parent;
@@ -736,6 +820,25 @@ RCCResourceLibrary::ResourceDataFileMap RCCResourceLibrary::resourceDataFileMap(
     return rc;
 }
 
+RCCResourceLibrary::CompressionAlgorithm RCCResourceLibrary::parseCompressionAlgorithm(const QString &value, QString *errorMsg)
+{
+    if (value == QLatin1String("zlib")) {
+#ifdef QT_NO_COMPRESS
+        *errorMsg = QLatin1String("zlib support not compiled in");
+#endif
+        return CompressionAlgorithm::Zlib;
+    } else if (value == QLatin1String("zstd")) {
+#if !QT_CONFIG(zstd)
+        *errorMsg = QLatin1String("Zstandard support not compiled in");
+#endif
+        return CompressionAlgorithm::Zstd;
+    } else if (value != QLatin1String("none")) {
+        *errorMsg = QString::fromLatin1("Unknown compression algorithm '%1'").arg(value);
+    }
+
+    return CompressionAlgorithm::None;
+}
+
 bool RCCResourceLibrary::output(QIODevice &outDevice, QIODevice &tempDevice, QIODevice &errorDevice)
 {
     m_errorDevice = &errorDevice;
@@ -793,6 +896,10 @@ bool RCCResourceLibrary::output(QIODevice &outDevice, QIODevice &tempDevice, QIO
             m_errorDevice->write("Could not write data tree\n");
             return false;
         }
+        if (m_format == Binary && m_pathIndex && !writePathIndex()) {
+            m_errorDevice->write("Could not write path index\n");
+            return false;
+        }
     }
     if (!writeInitializer()) {
         m_errorDevice->write("Could not write footer\n");
@@ -896,6 +1003,8 @@ bool RCCResourceLibrary::writeHeader()
         writeNumber4(0);
         writeNumber4(0);
         writeNumber4(0);
+        if (m_formatVersion >= 3)
+            writeNumber4(0); // path index
     }
     return true;
 }
@@ -984,7 +1093,15 @@ struct qt_rcc_compare_hash
     typedef bool result_type;
     result_type operator()(const RCCFileInfo *left, const RCCFileInfo *right) const
     {
-        return qt_hash(left->m_name) < qt_hash(right->m_name);
+        const uint leftHash = qt_hash(left->m_name);
+        const uint rightHash = qt_hash(right->m_name);
+        if (leftHash != rightHash)
+            return leftHash < rightHash;
+        // keep nodes with the same name together, directories first,
+        // so that the path index can refer to them as one run
+        if (left->m_name != right->m_name)
+            return left->m_name < right->m_name;
+        return (left->m_flags & RCCFileInfo::Directory) > (right->m_flags & RCCFileInfo::Directory);
     }
 };
 
@@ -1043,6 +1160,138 @@ bool RCCResourceLibrary::writeDataStructure()
     return true;
 }
 
+// must match qresource.cpp
+static quint64 pathIndexHash(const QString &path)
+{
+    quint64 h = Q_UINT64_C(0xcbf29ce484222325); // FNV-1a
+    for (QChar c : path) {
+        h ^= c.unicode();
+        h *= Q_UINT64_C(0x100000001b3);
+    }
+    return h;
+}
+
+static quint32 pathIndexSlot(quint64 h, quint32 displacement, quint32 slotCount)
+{
+    h ^= displacement * Q_UINT64_C(0x9e3779b97f4a7c15);
+    h ^= h >> 33;
+    h *= Q_UINT64_C(0xff51afd7ed558ccd);
+    h ^= h >> 33;
+    h *= Q_UINT64_C(0xc4ceb9fe1a85ec53);
+    h ^= h >> 33;
+    return h % slotCount;
+}
+
+bool RCCResourceLibrary::writePathIndex()
+{
+    struct Key {
+        QString path;
+        quint64 hash;
+        int node;
+        int nodeCount;
+    };
+    QVector<Key> keys;
+
+    // same traversal as writeDataStructure(), to find the node numbers
+    QStack<RCCFileInfo*> pending;
+    pending.push(m_root);
+    while (!pending.isEmpty()) {
+        RCCFileInfo *file = pending.pop();
+        QList<RCCFileInfo*> m_children = file->m_children.values();
+        std::sort(m_children.begin(), m_children.end(), qt_rcc_compare_hash());
+
+        for (int i = 0; i < m_children.size(); ++i) {
+            RCCFileInfo *child = m_children.at(i);
+            if (child->m_flags & RCCFileInfo::Directory)
+                pending.push(child);
+            if (i > 0 && m_children.at(i - 1)->m_name == child->m_name) {
+                ++keys.last().nodeCount;
+                continue;
+            }
+            const QString path = child->resourceName().mid(1);
+            if (path.size() > 0xffff) {
+                m_errorDevice->write(QString::fromLatin1("RCC: Error: Resource path too long for the index: %1\n")
+                                     .arg(path).toUtf8());
+                return false;
+            }
+            keys.append({ path, pathIndexHash(path), int(file->m_childOffset) + i, 1 });
+        }
+    }
+
+    // hash and displace: place the biggest buckets first, trying
+    // displacements until all keys of a bucket land in free slots. A fifth
+    // of the slots stays free, so that the last buckets still find room
+    // quickly.
+    const quint32 keyCount = keys.size();
+    const quint32 slotCount = qMax(1u, keyCount + keyCount / 4);
+    const quint32 bucketCount = qMax(1u, (keyCount + 3) / 4);
+    QVector<QVector<int> > buckets(bucketCount);
+    for (int i = 0; i < keys.size(); ++i)
+        buckets[(keys.at(i).hash >> 32) % bucketCount].append(i);
+    QVector<int> order(bucketCount);
+    for (int i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&buckets](int left, int right) {
+        return buckets.at(left).size() > buckets.at(right).size();
+    });
+
+    QVector<quint32> displacements(bucketCount, 0);
+    QVector<int> table(slotCount, -1);
+    QVector<quint32> bucketSlots;
+    for (int b : qAsConst(order)) {
+        const QVector<int> &bucket = buckets.at(b);
+        if (bucket.isEmpty())
+            break;
+        for (quint32 d = 0; ; ++d) {
+            if (d == 1u << 20) {
+                // QResource falls back to searching the tree
+                m_errorDevice->write("RCC: Warning: Could not build the path index, writing none\n");
+                return true;
+            }
+            bucketSlots.clear();
+            for (int k : bucket) {
+                const quint32 slot = pathIndexSlot(keys.at(k).hash, d, slotCount);
+                if (table.at(slot) != -1 || bucketSlots.contains(slot))
+                    break;
+                bucketSlots.append(slot);
+            }
+            if (bucketSlots.size() == bucket.size()) {
+                for (int i = 0; i < bucket.size(); ++i)
+                    table[bucketSlots.at(i)] = bucket.at(i);
+                displacements[b] = d;
+                break;
+            }
+        }
+    }
+
+    m_indexOffset = m_out.size();
+    writeNumber4(slotCount);
+    writeNumber4(bucketCount);
+    for (quint32 d : qAsConst(displacements))
+        writeNumber4(d);
+    quint32 pathOffset = 8 + 4 * bucketCount + 8 * slotCount;
+    for (int k : qAsConst(table)) {
+        if (k == -1) {
+            writeNumber4(0);
+            writeNumber4(0);
+            continue;
+        }
+        writeNumber4(keys.at(k).node);
+        writeNumber4(pathOffset);
+        pathOffset += 4 + 2 * keys.at(k).path.size();
+    }
+    for (int k : qAsConst(table)) {
+        if (k == -1)
+            continue;
+        const Key &key = keys.at(k);
+        writeNumber2(key.nodeCount);
+        writeNumber2(key.path.size());
+        for (QChar c : key.path)
+            writeNumber2(c.unicode());
+    }
+    return true;
+}
+
 void RCCResourceLibrary::writeMangleNamespaceFunction(const QByteArray &name)
 {
     if (m_useNameSpace) {
@@ -1183,6 +1432,13 @@ bool RCCResourceLibrary::writeInitializer()
         p[i++] = (m_namesOffset >> 16) & 0xff;
         p[i++] = (m_namesOffset >>  8) & 0xff;
         p[i++] = (m_namesOffset >>  0) & 0xff;
+
+        if (m_indexOffset) {
+            p[i++] = (m_indexOffset >> 24) & 0xff;
+            p[i++] = (m_indexOffset >> 16) & 0xff;
+            p[i++] = (m_indexOffset >>  8) & 0xff;
+            p[i++] = (m_indexOffset >>  0) & 0xff;
+        }
     }
     return true;
 }
@@ -35,6 +35,8 @@
 #include <qhash.h>
 #include <qstring.h>
 
+typedef struct ZSTD_CCtx_s ZSTD_CCtx;
+
 QT_BEGIN_NAMESPACE
 
 class RCCFileInfo;
@@ -77,6 +79,12 @@ public:
     void setOutputName(const QString &name) { m_outputName = name; }
     QString outputName() const { return m_outputName; }
 
+    enum class CompressionAlgorithm { Zlib, Zstd, None };
+
+    static CompressionAlgorithm parseCompressionAlgorithm(const QString &algo, QString *errorMsg);
+    void setCompressionAlgorithm(CompressionAlgorithm algo) { m_compressionAlgo = algo; }
+    CompressionAlgorithm compressionAlgorithm() const { return m_compressionAlgo; }
+
     void setCompressLevel(int c) { m_compressLevel = c; }
     int compressLevel() const { return m_compressLevel; }
 
@@ -89,10 +97,16 @@ public:
     void setUseNameSpace(bool v) { m_useNameSpace = v; }
     bool useNameSpace() const { return m_useNameSpace; }
 
+    void setPathIndex(bool b) { m_pathIndex = b; }
+    bool pathIndex() const { return m_pathIndex; }
+
     QStringList failedResources() const { return m_failedResources; }
 
     int formatVersion() const { return m_formatVersion; }
 
+    void setExplicitFormatVersion(bool b) { m_explicitFormatVersion = b; }
+    bool explicitFormatVersion() const { return m_explicitFormatVersion; }
+
 private:
     struct Strings {
         Strings();
@@ -104,6 +118,7 @@ private:
         const QString ATTRIBUTE_ALIAS;
         const QString ATTRIBUTE_THRESHOLD;
         const QString ATTRIBUTE_COMPRESS;
+        const QString ATTRIBUTE_COMPRESSALGO;
     };
     friend class RCCFileInfo;
     void reset();
@@ -114,6 +129,7 @@ private:
     bool writeDataBlobs();
     bool writeDataNames();
     bool writeDataStructure();
+    bool writePathIndex();
     bool writeInitializer();
     void writeMangleNamespaceFunction(const QByteArray &name);
     void writeAddNamespaceFunction(const QByteArray &name);
@@ -133,17 +149,22 @@ private:
     QString m_outputName;
     Format m_format;
     bool m_verbose;
+    CompressionAlgorithm m_compressionAlgo;
     int m_compressLevel;
     int m_compressThreshold;
     int m_treeOffset;
     int m_namesOffset;
     int m_dataOffset;
+    int m_indexOffset;
     bool m_useNameSpace;
+    bool m_pathIndex;
     QStringList m_failedResources;
     QIODevice *m_errorDevice;
     QIODevice *m_outDevice;
     QByteArray m_out;
     quint8 m_formatVersion;
+    bool m_explicitFormatVersion;
+    ZSTD_CCtx *m_zstdCCtx;
 };
 
 QT_END_NAMESPACE
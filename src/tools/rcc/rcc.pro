@@ -8,3 +8,10 @@ SOURCES += main.cpp
 
 QMAKE_TARGET_DESCRIPTION = "Qt Resource Compiler"
 load(qt_tool)
+
+# The bootstrap library is built without Zstandard, so the feature from
+# qconfig-bootstrapped.h has to be overridden for rcc itself.
+qtConfig(zstd):!cross_compile {
+    DEFINES += QT_FEATURE_zstd=1
+    QMAKE_USE_PRIVATE += zstd
+}
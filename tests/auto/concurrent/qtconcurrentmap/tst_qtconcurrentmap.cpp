@@ -58,6 +58,8 @@ private slots:
     void qFutureAssignmentLeak();
     void stressTest();
     void persistentResultTest();
+    void parallelReduce();
+    void parallelReduceContract();
 public slots:
     void throttling();
 };
@@ -2495,5 +2497,82 @@ void tst_QtConcurrentMap::persistentResultTest()
     QCOMPARE(ref.loadAcquire(), 3);
 }
 
+static void appendReduce(QList<int> &list, int x)
+{
+    list.append(x);
+}
+
+void tst_QtConcurrentMap::parallelReduce()
+{
+    QList<int> list;
+    int expected = 0;
+    for (int i = 0; i < 100000; ++i) {
+        list << (i % 1000);
+        expected += (i % 1000) * (i % 1000);
+    }
+
+    const ReduceOptions options = ReduceOptions(UnorderedReduce | ParallelReduce);
+
+    for (int threadCount : {1, 2, 4, 9}) {
+        QThreadPool::globalInstance()->setMaxThreadCount(threadCount);
+
+        QCOMPARE(QtConcurrent::blockingMappedReduced<int>(list, IntSquare(), IntSumReduce(), options),
+                 expected);
+        QCOMPARE(QtConcurrent::blockingMappedReduced(list, intSquare, intSumReduce, options),
+                 expected);
+        QCOMPARE(QtConcurrent::blockingMappedReduced(list.constBegin(), list.constEnd(),
+                                                     intSquare, intSumReduce, ParallelReduce),
+                 expected);
+        QCOMPARE(QtConcurrent::mappedReduced(list, intSquare, intSumReduce, options).result(),
+                 expected);
+    }
+    QThreadPool::globalInstance()->setMaxThreadCount(QThread::idealThreadCount());
+
+    // the results are not lists, so this falls back to the locked reduction
+    QList<int> all = QtConcurrent::blockingMappedReduced(list, intSquare, appendReduce, options);
+    QCOMPARE(all.size(), list.size());
+    all = QtConcurrent::blockingMappedReduced(list, intSquare, appendReduce, ParallelReduce);
+    QCOMPARE(all.size(), list.size());
+}
+
+static void sumReduce(double &sum, double x)
+{
+    sum += x;
+}
+
+static void squareSumReduce(double &sum, double x)
+{
+    sum += x * x;
+}
+
+static double identity(double x)
+{
+    return x;
+}
+
+void tst_QtConcurrentMap::parallelReduceContract()
+{
+    QVector<double> values;
+    double sum = 0;
+    double squareSum = 0;
+    for (int i = 0; i < 10000; ++i) {
+        values << (i % 100);
+        sum += i % 100;
+        squareSum += (i % 100) * (i % 100);
+    }
+
+    // reducing a partial sum is the same as reducing its values
+    QCOMPARE(QtConcurrent::blockingMappedReduced<double>(values, identity, sumReduce, ParallelReduce),
+             sum);
+
+    // squaring isn't: the partial sums are squared again when they are
+    // combined, which ParallelReduce can't detect
+    QCOMPARE(QtConcurrent::blockingMappedReduced<double>(values, identity, squareSumReduce,
+                                                         UnorderedReduce),
+             squareSum);
+    QVERIFY(QtConcurrent::blockingMappedReduced<double>(values, identity, squareSumReduce,
+                                                        ParallelReduce) != squareSum);
+}
+
 QTEST_MAIN(tst_QtConcurrentMap)
 #include "tst_qtconcurrentmap.moc"
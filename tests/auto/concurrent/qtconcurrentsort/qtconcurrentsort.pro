@@ -0,0 +1,5 @@
+CONFIG += testcase
+TARGET = tst_qtconcurrentsort
+QT = core testlib concurrent
+SOURCES = tst_qtconcurrentsort.cpp
+DEFINES += QT_STRICT_ITERATORS
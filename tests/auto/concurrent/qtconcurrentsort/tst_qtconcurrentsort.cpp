@@ -0,0 +1,180 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <qtconcurrentsort.h>
+#include <qrandom.h>
+
+#include <QtTest/QtTest>
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+class tst_QtConcurrentSort: public QObject
+{
+    Q_OBJECT
+private slots:
+    void sort_data();
+    void sort();
+    void lessThan();
+    void iterators();
+    void stdVector();
+    void strings();
+    void threadCounts();
+};
+
+static QVector<int> randomValues(int count, quint32 bound)
+{
+    QRandomGenerator generator(count);
+    QVector<int> values(count);
+    for (int &value : values)
+        value = int(generator.bounded(bound));
+    return values;
+}
+
+void tst_QtConcurrentSort::sort_data()
+{
+    QTest::addColumn<QVector<int> >("values");
+
+    QTest::newRow("empty") << QVector<int>();
+    QTest::newRow("one") << (QVector<int>() << 1);
+    QTest::newRow("small") << (QVector<int>() << 3 << 1 << 2 << 5 << 4);
+    QTest::newRow("one leaf") << randomValues(1000, 100000);
+    QTest::newRow("odd split") << randomValues(100003, 1000000);
+    QTest::newRow("duplicates") << randomValues(200000, 10);
+    QTest::newRow("large") << randomValues(1000000, 0xffffffff);
+
+    QVector<int> sorted = randomValues(100000, 1000);
+    std::sort(sorted.begin(), sorted.end());
+    QTest::newRow("sorted") << sorted;
+    std::reverse(sorted.begin(), sorted.end());
+    QTest::newRow("reversed") << sorted;
+}
+
+void tst_QtConcurrentSort::sort()
+{
+    QFETCH(QVector<int>, values);
+
+    QVector<int> expected = values;
+    std::sort(expected.begin(), expected.end());
+
+    QVector<int> blocking = values;
+    QtConcurrent::blockingSort(blocking);
+    QCOMPARE(blocking, expected);
+
+    QVector<int> async = values;
+    QFuture<void> future = QtConcurrent::sort(async);
+    future.waitForFinished();
+    QVERIFY(future.isFinished());
+    QCOMPARE(async, expected);
+}
+
+void tst_QtConcurrentSort::lessThan()
+{
+    QVector<int> values = randomValues(100000, 1000000);
+    QVector<int> expected = values;
+    std::sort(expected.begin(), expected.end(), std::greater<int>());
+
+    QtConcurrent::blockingSort(values, std::greater<int>());
+    QCOMPARE(values, expected);
+
+    values = randomValues(100000, 1000000);
+    QtConcurrent::sort(values, [](int a, int b) { return a > b; }).waitForFinished();
+    QCOMPARE(values, expected);
+}
+
+void tst_QtConcurrentSort::iterators()
+{
+    QVector<int> values = randomValues(100000, 1000000);
+    QVector<int> expected = values;
+
+    // only the middle is sorted
+    std::sort(expected.begin() + 10, expected.end() - 10);
+    QtConcurrent::blockingSort(values.begin() + 10, values.end() - 10);
+    QCOMPARE(values, expected);
+
+    values = randomValues(100000, 1000000);
+    expected = values;
+    std::sort(expected.begin(), expected.end(), std::greater<int>());
+    QtConcurrent::sort(values.begin(), values.end(), std::greater<int>()).waitForFinished();
+    QCOMPARE(values, expected);
+
+    QList<int> list = randomValues(50000, 1000).toList();
+    QList<int> expectedList = list;
+    std::sort(expectedList.begin(), expectedList.end());
+    QtConcurrent::blockingSort(list.begin(), list.end());
+    QCOMPARE(list, expectedList);
+}
+
+void tst_QtConcurrentSort::stdVector()
+{
+    const QVector<int> values = randomValues(100000, 1000000);
+    std::vector<int> vector = values.toStdVector();
+    std::vector<int> expected = vector;
+    std::sort(expected.begin(), expected.end());
+
+    QtConcurrent::blockingSort(vector);
+    QVERIFY(vector == expected);
+}
+
+void tst_QtConcurrentSort::strings()
+{
+    QStringList strings;
+    QRandomGenerator generator(42);
+    for (int i = 0; i < 50000; ++i)
+        strings << QString::number(generator.generate(), 36);
+    QStringList expected = strings;
+    std::sort(expected.begin(), expected.end());
+
+    QtConcurrent::blockingSort(strings);
+    QCOMPARE(strings, expected);
+}
+
+void tst_QtConcurrentSort::threadCounts()
+{
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const int maxThreadCount = pool->maxThreadCount();
+
+    const QVector<int> values = randomValues(300000, 1000000);
+    QVector<int> expected = values;
+    std::sort(expected.begin(), expected.end());
+
+    for (int threadCount : {1, 2, 3, 8, 17}) {
+        pool->setMaxThreadCount(threadCount);
+        QVector<int> sorted = values;
+        QtConcurrent::blockingSort(sorted);
+        QCOMPARE(sorted, expected);
+        sorted = values;
+        QtConcurrent::sort(sorted).waitForFinished();
+        QCOMPARE(sorted, expected);
+    }
+
+    pool->setMaxThreadCount(maxThreadCount);
+}
+
+QTEST_MAIN(tst_QtConcurrentSort)
+#include "tst_qtconcurrentsort.moc"
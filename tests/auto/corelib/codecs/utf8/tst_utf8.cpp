@@ -61,8 +61,18 @@ private slots:
 
     void nonCharacters_data();
     void nonCharacters();
+
+    void blockBoundaries_data();
+    void blockBoundaries();
 };
 
+// mostly two- and three-byte sequences, for the vectorized code paths
+static QString multiByteText()
+{
+    return QStringLiteral("\u041f\u0440\u0438\u0432\u0435\u0442 \u043c\u0438\u0440, "
+                          "\u65e5\u672c\u8a9e\u306e\u30c6\u30ad\u30b9\u30c8, \u00e9t\u00e9 ");
+}
+
 void tst_Utf8::initTestCase()
 {
     QTest::addColumn<bool>("useLocale");
@@ -166,6 +176,12 @@ void tst_Utf8::roundTrip()
 
     QCOMPARE(to8Bit(from8Bit(utf8)), utf8);
     QCOMPARE(from8Bit(to8Bit(utf16)), utf16);
+
+    // and surrounded by text that is mostly not ASCII
+    const QString text = multiByteText();
+    const QByteArray text8 = text.toUtf8();
+    QCOMPARE(to8Bit(text + utf16 + text), text8 + utf8 + text8);
+    QCOMPARE(from8Bit(text8 + utf8 + text8), text + utf16 + text);
 }
 
 void tst_Utf8::charByChar_data()
@@ -230,6 +246,18 @@ void tst_Utf8::invalidUtf8()
         QVERIFY(decoder->hasFailure());
     else if (!decoder->hasFailure())
         qWarning("System codec does not report failure when it should. Should report bug upstream.");
+
+    if (!useLocale) {
+        // the text around the invalid sequence must come out intact
+        const QString text = multiByteText();
+        const QByteArray text8 = text.toUtf8();
+        const QScopedPointer<QTextDecoder> decoder(codec->makeDecoder());
+        const QString decoded = decoder->toUnicode(text8 + utf8 + text8);
+        QVERIFY(decoder->hasFailure());
+        QVERIFY(decoded.startsWith(text));
+        QVERIFY(decoded.endsWith(text));
+        QVERIFY(decoded.contains(QChar(QChar::ReplacementCharacter)));
+    }
 }
 
 void tst_Utf8::nonCharacters_data()
@@ -264,5 +292,45 @@ void tst_Utf8::nonCharacters()
         qWarning("System codec reports failure when it shouldn't. Should report bug upstream.");
 }
 
+void tst_Utf8::blockBoundaries_data()
+{
+    QTest::addColumn<QString>("utf16");
+
+    static const uint nonBmp[] = { 0x10FFFD };
+    QTest::newRow("ascii") << QString(QLatin1Char('x'));
+    QTest::newRow("nul") << QString(QChar(QChar::Null));
+    QTest::newRow("two-bytes") << QString(QChar(0x00E9));
+    QTest::newRow("three-bytes") << QString(QChar(0x20AC));
+    QTest::newRow("bom") << QString(QChar(QChar::ByteOrderMark));
+    QTest::newRow("non-character") << QString(QChar(0xFFFF));
+    QTest::newRow("four-bytes") << QString::fromUcs4(nonBmp, 1);
+}
+
+void tst_Utf8::blockBoundaries()
+{
+    // The vectorized code converts blocks of eight characters or sixteen
+    // bytes; move a character of each length across them. Converting one
+    // character at a time does not use it, so it serves as a reference.
+    QFETCH(QString, utf16);
+
+    const QChar fillers[] = { QChar(0x0436), QChar(0x4E2D), QLatin1Char('a') };
+    for (QChar filler : fillers) {
+        for (int i = 0; i < 40; ++i) {
+            if (i == 0 && utf16.at(0) == QChar::ByteOrderMark)
+                continue;   // decoding drops it
+            QString text(40, filler);
+            text.insert(i, utf16);
+
+            const QScopedPointer<QTextEncoder> encoder(codec->makeEncoder(QTextCodec::IgnoreHeader));
+            QByteArray expected;
+            for (int j = 0; j < text.length(); ++j)
+                expected += encoder->fromUnicode(text.constData() + j, 1);
+
+            QCOMPARE(to8Bit(text), expected);
+            QCOMPARE(from8Bit(expected), text);
+        }
+    }
+}
+
 QTEST_MAIN(tst_Utf8)
 #include "tst_utf8.moc"
@@ -110,6 +110,8 @@ private slots:
 #ifndef Q_OS_WIN
     void hiddenDirs_hiddenFiles();
 #endif
+    void concurrent();
+    void concurrentStopEarly();
 #ifdef BUILTIN_TESTDATA
 private:
     QSharedPointer<QTemporaryDir> m_dataDir;
@@ -647,6 +649,85 @@ void tst_QDirIterator::hiddenDirs_hiddenFiles()
 }
 #endif // Q_OS_WIN
 
+static QStringList iterateSorted(const QString &path, QDir::Filters filters,
+                                 const QStringList &nameFilters, QDirIterator::IteratorFlags flags)
+{
+    QStringList list;
+    QDirIterator it(path, nameFilters, filters, flags);
+    while (it.hasNext()) {
+        const QString next = it.next();
+        if (next != it.fileInfo().filePath())
+            return QStringList(QLatin1String("mismatched entry ") + next);
+        list << next + QLatin1Char(' ') + QString::number(it.fileInfo().size());
+    }
+    list.sort();
+    return list;
+}
+
+void tst_QDirIterator::concurrent()
+{
+    QTemporaryDir tempDir;
+    QVERIFY2(tempDir.isValid(), qPrintable(tempDir.errorString()));
+    // enough entries for several batches, spread over nested directories
+    QDir root(tempDir.path());
+    for (int i = 0; i < 8; ++i) {
+        const QString dirName = QString::fromLatin1("dir%1/sub%2").arg(i).arg(i % 3);
+        QVERIFY(root.mkpath(dirName));
+        for (int j = 0; j < 50 * i; ++j) {
+            QFile file(root.filePath(dirName + QString::fromLatin1("/file%1.%2")
+                                     .arg(j).arg(j % 2 ? "txt" : "dat")));
+            QVERIFY(file.open(QIODevice::WriteOnly));
+            file.write(QByteArray(j % 7, 'x'));
+        }
+    }
+
+    const struct {
+        const char *name;
+        QDir::Filters filters;
+        const char *nameFilter;
+        QDirIterator::IteratorFlags flags;
+    } cases[] = {
+        { "all", QDir::AllEntries | QDir::NoDotAndDotDot, nullptr, QDirIterator::Subdirectories },
+        { "files", QDir::Files, nullptr, QDirIterator::Subdirectories },
+        { "name filters", QDir::AllEntries, "*.txt", QDirIterator::Subdirectories },
+        { "prefetch", QDir::AllEntries | QDir::NoDotAndDotDot, nullptr,
+          QDirIterator::Subdirectories | QDirIterator::PrefetchMetaData },
+        { "flat", QDir::AllEntries, nullptr, 0 }
+    };
+    for (const auto &c : cases) {
+        const QStringList nameFilters = c.nameFilter ? QStringList(QLatin1String(c.nameFilter))
+                                                     : QStringList();
+        const QStringList expected = iterateSorted(tempDir.path(), c.filters, nameFilters, c.flags);
+        QVERIFY2(!expected.isEmpty(), c.name);
+        const QStringList actual = iterateSorted(tempDir.path(), c.filters, nameFilters,
+                                                 c.flags | QDirIterator::Concurrent);
+        QVERIFY2(actual == expected, c.name);
+    }
+}
+
+void tst_QDirIterator::concurrentStopEarly()
+{
+    QTemporaryDir tempDir;
+    QVERIFY2(tempDir.isValid(), qPrintable(tempDir.errorString()));
+    QDir root(tempDir.path());
+    for (int i = 0; i < 20; ++i) {
+        const QString dirName = QString::fromLatin1("dir%1").arg(i);
+        QVERIFY(root.mkpath(dirName));
+        for (int j = 0; j < 50; ++j) {
+            QFile file(root.filePath(dirName + QString::fromLatin1("/file%1").arg(j)));
+            QVERIFY(file.open(QIODevice::WriteOnly));
+        }
+    }
+
+    // destroying the iterator must stop the workers while they still have work
+    for (int n = 0; n < 20; ++n) {
+        QDirIterator it(tempDir.path(), QDir::Files,
+                        QDirIterator::Subdirectories | QDirIterator::Concurrent);
+        for (int i = 0; i < n && it.hasNext(); ++i)
+            it.next();
+    }
+}
+
 QTEST_MAIN(tst_QDirIterator)
 
 #include "tst_qdiriterator.moc"
@@ -75,6 +75,12 @@ private slots:
 
     void watchUnicodeCharacters();
 
+    void watchTree_data();
+    void watchTree();
+    void coalesceTreeChanges();
+    void treeQueueOverflow_data() { watchTree_data(); }
+    void treeQueueOverflow();
+
 private:
     QString m_tempDirPattern;
 #endif // QT_NO_FILESYSTEMWATCHER
@@ -773,6 +779,185 @@ void tst_QFileSystemWatcher::watchUnicodeCharacters()
     QVERIFY(testDir.mkdir("creme"));
     QTRY_COMPARE(changedSpy.count(), 1);
 }
+
+class TreeChangeRecorder : public QObject
+{
+    Q_OBJECT
+public:
+    TreeChangeRecorder(const QString &root, QFileSystemWatcher *watcher)
+        : m_root(root + QLatin1Char('/'))
+    {
+        connect(watcher, &QFileSystemWatcher::treeChanged,
+                this, &TreeChangeRecorder::treeChanged);
+    }
+
+    QStringList changes;
+
+private slots:
+    void treeChanged(QFileSystemWatcher::Change change, const QString &path, const QString &oldPath)
+    {
+        static const char *const names[] = { "created", "removed", "modified", "renamed" };
+        QString entry = QLatin1String(names[change]) + QLatin1Char(' ') + relative(path);
+        if (change == QFileSystemWatcher::Renamed)
+            entry += QLatin1String(" from ") + relative(oldPath);
+        changes << entry;
+    }
+
+private:
+    QString relative(const QString &path) const
+    { return path.startsWith(m_root) ? path.mid(m_root.size()) : path; }
+
+    QString m_root;
+};
+
+static bool writeFile(const QString &fileName, const QByteArray &contents)
+{
+    QFile file(fileName);
+    return file.open(QIODevice::WriteOnly | QIODevice::Append) && file.write(contents) == contents.size();
+}
+
+void tst_QFileSystemWatcher::watchTree_data()
+{
+    QTest::addColumn<QString>("backend");
+
+#ifdef Q_OS_LINUX
+    QTest::newRow("native") << "native";
+    QTest::newRow("fanotify") << "fanotify";
+#endif
+}
+
+void tst_QFileSystemWatcher::watchTree()
+{
+    QFETCH(QString, backend);
+
+    QTemporaryDir temporaryDirectory(m_tempDirPattern);
+    QVERIFY2(temporaryDirectory.isValid(), qPrintable(temporaryDirectory.errorString()));
+    const QString root = temporaryDirectory.path();
+    QDir dir(root);
+    QVERIFY(dir.mkpath("a/b"));
+    QVERIFY(writeFile(dir.filePath("a/b/file.txt"), "x"));
+
+    QFileSystemWatcher watcher;
+    watcher.setObjectName(QLatin1String("_qt_autotest_force_engine_") + backend);
+    if (!watcher.addTree(root)) {
+        if (backend == QLatin1String("fanotify"))
+            QSKIP("fanotify is not available to this process");
+        QFAIL("Could not watch the tree");
+    }
+    QCOMPARE(watcher.trees(), QStringList(root));
+    QVERIFY(!watcher.addTree(dir.filePath("a")));
+
+    TreeChangeRecorder recorder(root, &watcher);
+    QStringList expected;
+
+    QVERIFY(writeFile(dir.filePath("a/b/file.txt"), "y"));
+    expected << "modified a/b/file.txt";
+    QTRY_COMPARE(recorder.changes, expected);
+
+    QVERIFY(writeFile(dir.filePath("a/new.txt"), "z"));
+    expected << "created a/new.txt";
+    QTRY_COMPARE(recorder.changes, expected);
+
+    // a new directory is watched as well
+    QVERIFY(dir.mkdir("a/c"));
+    expected << "created a/c";
+    QTRY_COMPARE(recorder.changes, expected);
+    QVERIFY(writeFile(dir.filePath("a/c/inner.txt"), "w"));
+    expected << "created a/c/inner.txt";
+    QTRY_COMPARE(recorder.changes, expected);
+
+    QVERIFY(dir.rename("a/new.txt", "a/b/moved.txt"));
+    expected << "renamed a/b/moved.txt from a/new.txt";
+    QTRY_COMPARE(recorder.changes, expected);
+
+    // changes below a renamed directory are reported with the new path
+    QVERIFY(dir.rename("a/c", "a/d"));
+    expected << "renamed a/d from a/c";
+    QTRY_COMPARE(recorder.changes, expected);
+    QVERIFY(QFile::remove(dir.filePath("a/d/inner.txt")));
+    expected << "removed a/d/inner.txt";
+    QTRY_COMPARE(recorder.changes, expected);
+
+    // entries moved in from outside the tree are reported as created
+    QTemporaryDir outside(m_tempDirPattern);
+    QVERIFY2(outside.isValid(), qPrintable(outside.errorString()));
+    QVERIFY(QDir(outside.path()).mkdir("e"));
+    QVERIFY(writeFile(outside.path() + "/e/f.txt", "v"));
+    QVERIFY(dir.rename(outside.path() + "/e", dir.filePath("a/e")));
+    // the contents are listed from the event loop, so they may be reported
+    // once more if the kernel already reported them under the new path
+    QTRY_VERIFY(recorder.changes.contains("created a/e")
+                && recorder.changes.contains("created a/e/f.txt"));
+    QCOMPARE(recorder.changes.mid(0, expected.size()), expected);
+    recorder.changes.clear();
+    expected.clear();
+
+    QVERIFY(watcher.removeTree(root));
+    QVERIFY(watcher.trees().isEmpty());
+    QVERIFY(writeFile(dir.filePath("a/b/file.txt"), "u"));
+    QTest::qWait(200);
+    QCOMPARE(recorder.changes, expected);
+}
+
+void tst_QFileSystemWatcher::coalesceTreeChanges()
+{
+    QTemporaryDir temporaryDirectory(m_tempDirPattern);
+    QVERIFY2(temporaryDirectory.isValid(), qPrintable(temporaryDirectory.errorString()));
+    const QString root = temporaryDirectory.path();
+    QDir dir(root);
+
+    QFileSystemWatcher watcher;
+    if (!watcher.addTree(root))
+        QSKIP("Watching trees is not supported on this platform");
+    watcher.setCoalescingInterval(300);
+    TreeChangeRecorder recorder(root, &watcher);
+
+    // a burst of changes to the same files is merged into one per file,
+    // and a temporary file that comes and goes is not reported at all
+    for (int i = 0; i < 10; ++i)
+        QVERIFY(writeFile(dir.filePath("log.txt"), "line\n"));
+    QVERIFY(writeFile(dir.filePath("temporary.txt"), "t"));
+    QVERIFY(QFile::remove(dir.filePath("temporary.txt")));
+
+    QTRY_COMPARE(recorder.changes, QStringList("created log.txt"));
+    QTest::qWait(500);
+    QCOMPARE(recorder.changes, QStringList("created log.txt"));
+}
+
+void tst_QFileSystemWatcher::treeQueueOverflow()
+{
+    QFETCH(QString, backend);
+
+    // both inotify and fanotify queue 16384 events by default
+    int maxQueuedEvents = 16384;
+    if (backend == QLatin1String("native")) {
+        QFile limit(QStringLiteral("/proc/sys/fs/inotify/max_queued_events"));
+        if (limit.open(QIODevice::ReadOnly))
+            maxQueuedEvents = limit.readAll().trimmed().toInt();
+    }
+    if (maxQueuedEvents <= 0 || maxQueuedEvents > 100000)
+        QSKIP("The event queue is too large to overflow it here");
+
+    QTemporaryDir temporaryDirectory(m_tempDirPattern);
+    QVERIFY2(temporaryDirectory.isValid(), qPrintable(temporaryDirectory.errorString()));
+    const QString root = temporaryDirectory.path();
+    QDir dir(root);
+
+    QFileSystemWatcher watcher;
+    watcher.setObjectName(QLatin1String("_qt_autotest_force_engine_") + backend);
+    if (!watcher.addTree(root)) {
+        if (backend == QLatin1String("fanotify"))
+            QSKIP("fanotify is not available to this process");
+        QFAIL("Could not watch the tree");
+    }
+    TreeChangeRecorder recorder(root, &watcher);
+
+    // the events are not read until control returns to the event loop
+    for (int i = 0; i <= maxQueuedEvents; ++i)
+        QVERIFY(writeFile(dir.filePath(QString::number(i)), QByteArray()));
+
+    QTRY_VERIFY(recorder.changes.contains(QLatin1String("modified ") + root));
+}
 #endif // QT_NO_FILESYSTEMWATCHER
 
 QTEST_MAIN(tst_QFileSystemWatcher)
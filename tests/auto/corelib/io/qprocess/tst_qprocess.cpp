@@ -40,6 +40,10 @@
 #include <QtNetwork/QHostInfo>
 #include <stdlib.h>
 
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#endif
+
 typedef void (QProcess::*QProcessFinishedSignal1)(int);
 typedef void (QProcess::*QProcessFinishedSignal2)(int, QProcess::ExitStatus);
 typedef void (QProcess::*QProcessErrorSignal)(QProcess::ProcessError);
@@ -109,6 +113,7 @@ private slots:
     void discardUnwantedOutput();
     void setWorkingDirectory();
     void setNonExistentWorkingDirectory();
+    void setupChildProcess();
 
     void exitStatus_data();
     void exitStatus();
@@ -2246,6 +2251,33 @@ void tst_QProcess::setNonExistentWorkingDirectory()
 #endif
 }
 
+#ifdef Q_OS_UNIX
+class SetupChildProcess : public QProcess
+{
+protected:
+    void setupChildProcess() override
+    {
+        // runs in the child, after the redirections and before exec
+        ::write(STDOUT_FILENO, "setup\n", 6);
+    }
+};
+#endif
+
+void tst_QProcess::setupChildProcess()
+{
+#ifndef Q_OS_UNIX
+    QSKIP("QProcess::setupChildProcess() is only called on Unix");
+#else
+    // subclasses must still get the fork()-based start, even where plain
+    // QProcess objects are started with posix_spawn()
+    SetupChildProcess process;
+    process.start("testProcessNormal/testProcessNormal");
+    QVERIFY2(process.waitForFinished(5000), process.errorString().toLocal8Bit());
+    QCOMPARE(process.exitStatus(), QProcess::NormalExit);
+    QCOMPARE(process.readAllStandardOutput(), QByteArray("setup\n"));
+#endif
+}
+
 void tst_QProcess::startFinishStartFinish()
 {
     QProcess process;
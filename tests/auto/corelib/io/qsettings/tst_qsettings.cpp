@@ -31,6 +31,7 @@
 
 #include <QtCore/QSettings>
 #include <private/qsettings_p.h>
+#include <private/qsettingsbinarystore_p.h>
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDateTime>
 #include <QtCore/QtGlobal>
@@ -183,6 +184,8 @@ private slots:
     void testByteArray_data();
     void testByteArray();
     void testByteArrayNativeFormat();
+    void binaryFormat();
+    void binaryFormatCorrupt();
     void iniCodec();
     void bom();
     void embeddedZeroByte_data();
@@ -284,6 +287,7 @@ static void populateWithFormats()
     QTest::newRow("ini") << QSettings::IniFormat;
     QTest::newRow("custom1") << QSettings::CustomFormat1;
     QTest::newRow("custom2") << QSettings::CustomFormat2;
+    QTest::newRow("binary") << QSettings::BinaryFormat;
 }
 
 tst_QSettings::tst_QSettings()
@@ -686,6 +690,120 @@ void tst_QSettings::testByteArrayNativeFormat()
 #endif
 }
 
+void tst_QSettings::binaryFormat()
+{
+#ifndef QSETTINGS_USE_BINARY_STORE
+    QSKIP("This test requires the binary settings store.");
+#else
+    const QString fileName = settingsPath("binary.qsettings");
+    QFile::remove(fileName);
+
+    {
+        QSettings settings(fileName, QSettings::BinaryFormat);
+        settings.setValue("alpha", 1);
+        settings.setValue("beta/gamma", QStringList() << "hope" << "destiny");
+        settings.sync();
+        QCOMPARE(settings.status(), QSettings::NoError);
+    }
+    const qint64 snapshotSize = QFileInfo(fileName).size();
+
+    // stands in for another process reading the same file
+    QSettingsBinaryStore other(fileName);
+    QVERIFY(other.refresh());
+    QCOMPARE(other.logSize(), qint64(0));
+    const int generation = other.generation();
+
+    // changes are appended to the file instead of rewriting it
+    {
+        QSettings settings(fileName, QSettings::BinaryFormat);
+        settings.setValue("alpha", 2);
+        settings.remove("beta");
+    }
+    QVERIFY(QFileInfo(fileName).size() > snapshotSize);
+    QVERIFY(other.refresh());
+    QCOMPARE(other.generation(), generation);
+    QVERIFY(other.logSize() > 0);
+    QVariant value;
+    QVERIFY(other.value("alpha", &value));
+    QCOMPARE(value.toInt(), 2);
+    QVERIFY(!other.contains("beta/gamma"));
+
+    // outdated values are dropped once enough of them have accumulated
+    {
+        QSettings settings(fileName, QSettings::BinaryFormat);
+        for (int i = 0; i < 200; ++i) {
+            settings.setValue("alpha", QByteArray(1024, 'a' + i % 26));
+            settings.sync();
+        }
+        QCOMPARE(settings.status(), QSettings::NoError);
+    }
+    QVERIFY(QFileInfo(fileName).size() < 200 * 1024);
+    QVERIFY(other.refresh());
+    QVERIFY(other.generation() != generation);
+    QVERIFY(other.value("alpha", &value));
+    QCOMPARE(value.toByteArray(), QByteArray(1024, 'a' + 199 % 26));
+    QCOMPARE(other.keys(QString()), QStringList("alpha"));
+
+    // anything else is rejected instead of being misread
+    {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write("[General]\nalpha=3\n");
+    }
+    QVERIFY(!other.refresh());
+    QVERIFY(!other.contains("alpha"));
+#endif
+}
+
+void tst_QSettings::binaryFormatCorrupt()
+{
+#ifndef QSETTINGS_USE_BINARY_STORE
+    QSKIP("This test requires the binary settings store.");
+#else
+    const QString fileName = settingsPath("corrupt.qsettings");
+    QFile::remove(fileName);
+
+    {
+        QSettings settings(fileName, QSettings::BinaryFormat);
+        settings.setValue("alpha", 1);
+        settings.setValue("beta", "two");
+    }
+    // the start of a record left behind by a writer that crashed
+    {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::Append));
+        file.write(QByteArray(6, '\0'));
+    }
+    QSettingsBinaryStore other(fileName);
+    QVERIFY(other.refresh());
+    const int generation = other.generation();
+
+    // the file is replaced instead of being truncated under other readers
+    {
+        QSettings settings(fileName, QSettings::BinaryFormat);
+        settings.setValue("gamma", 3);
+    }
+    QVERIFY(other.refresh());
+    QVERIFY(other.generation() != generation);
+    QCOMPARE(other.keys(QString()).size(), 3);
+
+    // a record claiming to be bigger than the snapshot is never read
+    {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.seek(32 + 8)); // the value length of "alpha"
+        const uchar length[4] = { 0xf0, 0xff, 0xff, 0x7f };
+        QCOMPARE(file.write(reinterpret_cast<const char *>(length), 4), qint64(4));
+    }
+    QVERIFY(other.refresh());
+    QVariant value;
+    QVERIFY(!other.value("alpha", &value));
+    QVERIFY(!other.keys(QString()).contains("alpha"));
+    QVERIFY(other.compact());
+    QVERIFY(!other.contains("alpha"));
+#endif
+}
+
 void tst_QSettings::iniCodec()
 {
     {
@@ -1327,7 +1445,7 @@ void tst_QSettings::testVariantTypes()
 
     // We store key sequences as strings instead of binary variant blob, for improved
     // readability in the resulting format.
-    if (format >= QSettings::InvalidFormat) {
+    if (format >= QSettings::InvalidFormat || format == QSettings::BinaryFormat) {
         testVal("keysequence", QKeySequence(Qt::ControlModifier + Qt::Key_F1), QKeySequence, KeySequence);
     } else {
         testVal("keysequence", QKeySequence(Qt::ControlModifier + Qt::Key_F1), QString, String);
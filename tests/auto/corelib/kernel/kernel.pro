@@ -4,6 +4,7 @@ SUBDIRS=\
     qdeadlinetimer \
     qelapsedtimer \
     qeventdispatcher \
+    qeventdispatcher_epoll \
     qeventloop \
     qmath \
     qmetaobject \
@@ -34,6 +35,7 @@ SUBDIRS=\
     qsocketnotifier
 
 !qtConfig(private_tests): SUBDIRS -= \
+    qeventdispatcher_epoll \
     qsocketnotifier \
     qsharedmemory
 
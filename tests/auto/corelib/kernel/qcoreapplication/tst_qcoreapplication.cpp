@@ -415,6 +415,58 @@ void tst_QCoreApplication::removePostedEvents()
     expected.clear();
 }
 
+void tst_QCoreApplication::postedMetaCalls()
+{
+    int argc = 1;
+    char *argv[] = { const_cast<char*>(QTest::currentAppName()) };
+    TestApplication app(argc, argv);
+
+    EventSpy spy;
+    QObject one;
+    one.installEventFilter(&spy);
+
+    QList<int> calls;
+    QList<int> expectedCalls;
+    QList<int> expected;
+
+    // queued calls keep their order and priority relative to other events
+    QCoreApplication::postEvent(&one, new QEvent(QEvent::Type(QEvent::User + 1)));
+    QMetaObject::invokeMethod(&one, [&calls]() { calls << 1; }, Qt::QueuedConnection);
+    QCoreApplication::postEvent(&one, new QEvent(QEvent::Type(QEvent::User + 2)));
+    QMetaObject::invokeMethod(&one, [&calls]() { calls << 2; }, Qt::QueuedConnection);
+    QCoreApplication::postEvent(&one, new QEvent(QEvent::Type(QEvent::User + 3)), Qt::HighEventPriority);
+    QCoreApplication::sendPostedEvents();
+    expected << QEvent::User + 3
+             << QEvent::User + 1
+             << QEvent::MetaCall
+             << QEvent::User + 2
+             << QEvent::MetaCall;
+    expectedCalls << 1 << 2;
+    QCOMPARE(spy.recordedEvents, expected);
+    QCOMPARE(calls, expectedCalls);
+    spy.recordedEvents.clear();
+    expected.clear();
+
+    // remove the queued calls for one object
+    QMetaObject::invokeMethod(&one, [&calls]() { calls << 3; }, Qt::QueuedConnection);
+    QCoreApplication::postEvent(&one, new QEvent(QEvent::Type(QEvent::User + 4)));
+    QMetaObject::invokeMethod(&one, [&calls]() { calls << 4; }, Qt::QueuedConnection);
+    QCoreApplication::removePostedEvents(&one, QEvent::MetaCall);
+    QCoreApplication::sendPostedEvents();
+    expected << QEvent::User + 4;
+    QCOMPARE(spy.recordedEvents, expected);
+    QCOMPARE(calls, expectedCalls);
+    spy.recordedEvents.clear();
+    expected.clear();
+
+    // queued calls to a deleted object are dropped
+    QObject *two = new QObject;
+    QMetaObject::invokeMethod(two, [&calls]() { calls << 5; }, Qt::QueuedConnection);
+    delete two;
+    QCoreApplication::sendPostedEvents();
+    QCOMPARE(calls, expectedCalls);
+}
+
 #ifndef QT_NO_THREAD
 class DeliverInDefinedOrderThread : public QThread
 {
@@ -532,6 +584,107 @@ void tst_QCoreApplication::deliverInDefinedOrder()
     QObject::connect(&obj, SIGNAL(done()), &app, SLOT(quit()));
     app.exec();
 }
+
+class SequenceEvent : public QEvent
+{
+public:
+    SequenceEvent(int sender, int value)
+        : QEvent(QEvent::User), sender(sender), value(value)
+    { }
+    int sender;
+    int value;
+};
+
+class SequenceReceiver : public QObject
+{
+    Q_OBJECT
+public:
+    SequenceReceiver(int senderCount)
+        : sequences(senderCount)
+    { }
+
+    void record(int sender, int value)
+    {
+        sequences[sender].append(value);
+        received.ref();
+    }
+
+    bool event(QEvent *event) override
+    {
+        if (event->type() != QEvent::User)
+            return QObject::event(event);
+        SequenceEvent *e = static_cast<SequenceEvent *>(event);
+        record(e->sender, e->value);
+        return true;
+    }
+
+    QVector<QVector<int> > sequences;
+    QAtomicInt received;
+};
+
+class SequenceSenderThread : public QThread
+{
+public:
+    SequenceSenderThread(SequenceReceiver *receiver, int sender, int count)
+        : receiver(receiver), sender(sender), count(count)
+    { }
+
+    void run() override
+    {
+        SequenceReceiver *r = receiver;
+        const int s = sender;
+        for (int i = 0; i < count; ++i) {
+            if (i % 10 == 0)
+                QCoreApplication::postEvent(r, new SequenceEvent(s, i));
+            else
+                QMetaObject::invokeMethod(r, [r, s, i]() { r->record(s, i); }, Qt::QueuedConnection);
+        }
+    }
+
+    SequenceReceiver *receiver;
+    int sender;
+    int count;
+};
+
+void tst_QCoreApplication::queuedCallsFromThreads()
+{
+    int argc = 1;
+    char *argv[] = { const_cast<char*>(QTest::currentAppName()) };
+    TestApplication app(argc, argv);
+
+    const int senderCount = 4;
+    const int callCount = 2000;
+
+    SequenceReceiver receiver(senderCount);
+    QVector<SequenceSenderThread *> senders;
+    for (int i = 0; i < senderCount; ++i)
+        senders << new SequenceSenderThread(&receiver, i, callCount);
+    for (SequenceSenderThread *sender : qAsConst(senders))
+        sender->start();
+
+    // deliver some of the calls here, then move the receiver while the
+    // senders are still posting to it
+    QTRY_VERIFY(receiver.received.load() > 0);
+    QThread worker;
+    worker.start();
+    receiver.moveToThread(&worker);
+
+    for (SequenceSenderThread *sender : qAsConst(senders))
+        QVERIFY(sender->wait());
+    qDeleteAll(senders);
+
+    QTRY_COMPARE(receiver.received.load(), senderCount * callCount);
+    worker.quit();
+    QVERIFY(worker.wait());
+
+    // every call is delivered exactly once, in the order of its sender
+    for (int i = 0; i < senderCount; ++i) {
+        const QVector<int> &sequence = receiver.sequences.at(i);
+        QCOMPARE(sequence.size(), callCount);
+        for (int j = 0; j < callCount; ++j)
+            QCOMPARE(sequence.at(j), j);
+    }
+}
 #endif // QT_NO_QTHREAD
 
 void tst_QCoreApplication::applicationPid()
@@ -43,8 +43,10 @@ private slots:
     void argc();
     void postEvent();
     void removePostedEvents();
+    void postedMetaCalls();
 #ifndef QT_NO_THREAD
     void deliverInDefinedOrder();
+    void queuedCallsFromThreads();
 #endif
     void applicationPid();
     void globalPostedEventsCount();
@@ -0,0 +1,5 @@
+CONFIG += testcase
+TARGET = tst_qeventdispatcher_epoll
+QT = core-private testlib
+SOURCES += tst_qeventdispatcher_epoll.cpp
+requires(qtConfig(epoll))
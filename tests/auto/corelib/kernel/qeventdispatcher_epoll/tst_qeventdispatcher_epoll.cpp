@@ -0,0 +1,335 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QEventLoop>
+#include <QtCore/QSocketNotifier>
+#include <QtCore/QTemporaryFile>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+#include <QtTest/QtTest>
+
+#include <private/qeventdispatcher_epoll_p.h>
+
+#include <memory>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+class SocketPair
+{
+public:
+    SocketPair()
+    {
+        if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0)
+            fds[0] = fds[1] = -1;
+    }
+    ~SocketPair()
+    {
+        if (fds[0] != -1)
+            ::close(fds[0]);
+        if (fds[1] != -1)
+            ::close(fds[1]);
+    }
+    bool isValid() const { return fds[0] != -1; }
+    bool send() const { return ::write(fds[1], "x", 1) == 1; }
+    bool receive() const { char c; return ::read(fds[0], &c, 1) == 1; }
+
+    int fds[2];
+};
+
+class tst_QEventDispatcherEpoll : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void timers();
+    void readNotifier();
+    void writeNotifier();
+    void regularFile();
+    void manyNotifiers();
+    void disableFromSlot();
+    void deleteFromSlot();
+    void wakeUp();
+    void interrupt();
+    void threads();
+};
+
+void tst_QEventDispatcherEpoll::initTestCase()
+{
+    QVERIFY(qobject_cast<QEventDispatcherEpoll *>(QAbstractEventDispatcher::instance()));
+}
+
+void tst_QEventDispatcherEpoll::timers()
+{
+    QElapsedTimer elapsed;
+    elapsed.start();
+
+    int preciseFired = 0;
+    QTimer precise;
+    precise.setTimerType(Qt::PreciseTimer);
+    precise.setInterval(5);
+    connect(&precise, &QTimer::timeout, [&]() { ++preciseFired; });
+    precise.start();
+
+    bool singleShotFired = false;
+    QTimer::singleShot(50, [&]() { singleShotFired = true; });
+
+    QTRY_VERIFY(singleShotFired);
+    QVERIFY(elapsed.elapsed() >= 50);
+    QTRY_VERIFY(preciseFired >= 5);
+
+    const int remaining = QAbstractEventDispatcher::instance()->remainingTime(precise.timerId());
+    QVERIFY(remaining >= 0 && remaining <= 5);
+    precise.stop();
+    const int fired = preciseFired;
+    QTest::qWait(50);
+    QCOMPARE(preciseFired, fired);
+}
+
+void tst_QEventDispatcherEpoll::readNotifier()
+{
+    SocketPair pair;
+    QVERIFY(pair.isValid());
+
+    int activated = 0;
+    QSocketNotifier notifier(pair.fds[0], QSocketNotifier::Read);
+    connect(&notifier, &QSocketNotifier::activated, [&]() { ++activated; });
+
+    QCoreApplication::processEvents();
+    QCOMPARE(activated, 0);
+
+    // the data is there before the dispatcher is asked, so each
+    // iteration activates the notifier once
+    QVERIFY(pair.send());
+    QCoreApplication::processEvents();
+    QCOMPARE(activated, 1);
+
+    // level-triggered: it keeps firing until the data is read
+    QCoreApplication::processEvents();
+    QCOMPARE(activated, 2);
+
+    QVERIFY(pair.receive());
+    QCoreApplication::processEvents();
+    QCOMPARE(activated, 2);
+
+    // disabled notifiers are taken out of the interest set
+    notifier.setEnabled(false);
+    QVERIFY(pair.send());
+    QCoreApplication::processEvents();
+    QCOMPARE(activated, 2);
+    notifier.setEnabled(true);
+    QCoreApplication::processEvents();
+    QCOMPARE(activated, 3);
+}
+
+void tst_QEventDispatcherEpoll::writeNotifier()
+{
+    SocketPair pair;
+    QVERIFY(pair.isValid());
+
+    int readActivated = 0;
+    int writeActivated = 0;
+    QSocketNotifier readNotifier(pair.fds[0], QSocketNotifier::Read);
+    QSocketNotifier writeNotifier(pair.fds[0], QSocketNotifier::Write);
+    connect(&readNotifier, &QSocketNotifier::activated, [&]() { ++readActivated; });
+    connect(&writeNotifier, &QSocketNotifier::activated, [&]() { ++writeActivated; });
+
+    QCoreApplication::processEvents();
+    QCOMPARE(writeActivated, 1);
+    QCOMPARE(readActivated, 0);
+
+    // both notifiers of one descriptor share its registration
+    writeNotifier.setEnabled(false);
+    QVERIFY(pair.send());
+    QCoreApplication::processEvents();
+    QCOMPARE(readActivated, 1);
+    QCOMPARE(writeActivated, 1);
+}
+
+void tst_QEventDispatcherEpoll::regularFile()
+{
+    // epoll refuses regular files, but poll() reports them as always
+    // ready, and so does the dispatcher
+    QTemporaryFile file;
+    QVERIFY(file.open());
+
+    int activated = 0;
+    QSocketNotifier notifier(file.handle(), QSocketNotifier::Read);
+    connect(&notifier, &QSocketNotifier::activated, [&]() { ++activated; });
+    QCoreApplication::processEvents();
+    QCOMPARE(activated, 1);
+    QCoreApplication::processEvents();
+    QCOMPARE(activated, 2);
+}
+
+void tst_QEventDispatcherEpoll::manyNotifiers()
+{
+    enum { Count = 300 };
+    std::vector<std::unique_ptr<SocketPair>> pairs;
+    std::vector<std::unique_ptr<QSocketNotifier>> notifiers;
+    QVector<int> activated(Count);
+    for (int i = 0; i < Count; ++i) {
+        pairs.emplace_back(new SocketPair);
+        QVERIFY(pairs.back()->isValid());
+        notifiers.emplace_back(new QSocketNotifier(pairs.back()->fds[0], QSocketNotifier::Read));
+        connect(notifiers.back().get(), &QSocketNotifier::activated, [&activated, i]() { ++activated[i]; });
+    }
+
+    for (int i = 0; i < Count; i += 3)
+        QVERIFY(pairs[i]->send());
+    QCoreApplication::processEvents();
+
+    // each ready notifier is activated exactly once per iteration
+    for (int i = 0; i < Count; ++i)
+        QCOMPARE(activated.at(i), i % 3 ? 0 : 1);
+}
+
+void tst_QEventDispatcherEpoll::disableFromSlot()
+{
+    SocketPair first, second;
+    QVERIFY(first.isValid() && second.isValid());
+
+    int activated = 0;
+    QSocketNotifier firstNotifier(first.fds[0], QSocketNotifier::Read);
+    QSocketNotifier secondNotifier(second.fds[0], QSocketNotifier::Read);
+    connect(&firstNotifier, &QSocketNotifier::activated, [&]() {
+        ++activated;
+        secondNotifier.setEnabled(false);
+    });
+    connect(&secondNotifier, &QSocketNotifier::activated, [&]() {
+        ++activated;
+        firstNotifier.setEnabled(false);
+    });
+
+    // both are ready, but the one that fires first disables the other
+    QVERIFY(first.send());
+    QVERIFY(second.send());
+    QCoreApplication::processEvents();
+    QCOMPARE(activated, 1);
+    QCoreApplication::processEvents();
+    QCOMPARE(activated, 2); // the one that is still enabled
+}
+
+void tst_QEventDispatcherEpoll::deleteFromSlot()
+{
+    SocketPair first, second;
+    QVERIFY(first.isValid() && second.isValid());
+
+    int activated = 0;
+    QSocketNotifier *firstNotifier = new QSocketNotifier(first.fds[0], QSocketNotifier::Read);
+    QSocketNotifier *secondNotifier = new QSocketNotifier(second.fds[0], QSocketNotifier::Read);
+    connect(firstNotifier, &QSocketNotifier::activated, [&]() {
+        ++activated;
+        delete secondNotifier;
+        secondNotifier = nullptr;
+    });
+    connect(secondNotifier, &QSocketNotifier::activated, [&]() {
+        ++activated;
+        delete firstNotifier;
+        firstNotifier = nullptr;
+    });
+
+    QVERIFY(first.send());
+    QVERIFY(second.send());
+    QCoreApplication::processEvents();
+    QCOMPARE(activated, 1);
+    QCoreApplication::processEvents();
+    QCOMPARE(activated, 2);
+    delete firstNotifier;
+    delete secondNotifier;
+}
+
+void tst_QEventDispatcherEpoll::wakeUp()
+{
+    QEventLoop loop;
+    QElapsedTimer elapsed;
+    elapsed.start();
+    QThread *thread = QThread::create([&loop]() {
+        QThread::msleep(100);
+        QMetaObject::invokeMethod(&loop, "quit", Qt::QueuedConnection);
+    });
+    thread->start();
+    QTimer::singleShot(10000, &loop, [&loop]() { loop.exit(1); });
+    QCOMPARE(loop.exec(), 0);
+    QVERIFY(elapsed.elapsed() < 5000);
+    QVERIFY(thread->wait());
+    delete thread;
+}
+
+void tst_QEventDispatcherEpoll::interrupt()
+{
+    QAbstractEventDispatcher *dispatcher = QAbstractEventDispatcher::instance();
+    QTimer timer;
+    timer.start(10000);
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+    dispatcher->interrupt();
+    dispatcher->processEvents(QEventLoop::WaitForMoreEvents);
+    QVERIFY(elapsed.elapsed() < 5000);
+}
+
+void tst_QEventDispatcherEpoll::threads()
+{
+    // QT_EVENT_DISPATCHER_EPOLL applies to the threads started later, too
+    bool isEpoll = false;
+    int fired = 0;
+    QThread thread;
+    QObject context;
+    context.moveToThread(&thread);
+    connect(&thread, &QThread::started, &context, [&]() {
+        isEpoll = qobject_cast<QEventDispatcherEpoll *>(QAbstractEventDispatcher::instance()) != nullptr;
+        QTimer *timer = new QTimer(&context);
+        connect(timer, &QTimer::timeout, [&fired, timer]() {
+            if (++fired == 3) {
+                timer->stop();
+                QThread::currentThread()->quit();
+            }
+        });
+        timer->start(5);
+    });
+    thread.start();
+    QVERIFY(thread.wait(10000));
+    QVERIFY(isEpoll);
+    QCOMPARE(fired, 3);
+}
+
+int main(int argc, char *argv[])
+{
+    qputenv("QT_EVENT_DISPATCHER_EPOLL", "1");
+    QCoreApplication app(argc, argv);
+    tst_QEventDispatcherEpoll tc;
+    QTEST_SET_MAIN_SOURCE_PATH
+    return QTest::qExec(&tc, argc, argv);
+}
+
+#include "tst_qeventdispatcher_epoll.moc"
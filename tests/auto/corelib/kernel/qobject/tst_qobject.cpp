@@ -91,6 +91,7 @@ private slots:
     void recursiveSignalEmission();
     void signalBlocking();
     void blockingQueuedConnection();
+    void batchedConnection();
     void childEvents();
     void installEventFilter();
     void deleteSelfInSlot();
@@ -3074,6 +3075,153 @@ void tst_QObject::blockingQueuedConnection()
     }
 }
 
+class BatchReceiver : public QObject
+{
+    Q_OBJECT
+public:
+    BatchReceiver() : metaCallEvents(0), deleteAfter(-1) {}
+
+    QList<int> numbers;
+    QStringList strings;
+    int metaCallEvents;
+    int deleteAfter;
+
+    bool event(QEvent *e) override
+    {
+        if (e->type() == QEvent::MetaCall)
+            ++metaCallEvents;
+        return QObject::event(e);
+    }
+
+public slots:
+    void record(int number, const QString &string)
+    {
+        numbers << number;
+        strings << string;
+        if (numbers.size() == deleteAfter)
+            delete this;
+    }
+
+    void count()
+    {
+        numbers << numbers.size();
+    }
+};
+
+class BatchSenderThread : public QThread
+{
+public:
+    SenderObject *sender;
+    int count;
+
+    void run() override
+    {
+        for (int i = 0; i < count; ++i)
+            emit sender->signal7(i, QString::number(i));
+    }
+};
+
+void tst_QObject::batchedConnection()
+{
+    const QList<int> expectedNumbers = QList<int>() << 1 << 2 << 3;
+    const QStringList expectedStrings = QStringList() << "one" << "two" << "three";
+
+    {
+        // emissions before the receiver gets to the first one share its event
+        SenderObject sender;
+        BatchReceiver receiver;
+        QVERIFY(connect(&sender, SIGNAL(signal7(int,QString)), &receiver, SLOT(record(int,QString)),
+                        Qt::ConnectionType(Qt::QueuedConnection | Qt::BatchedConnection)));
+        emit sender.signal7(1, "one");
+        emit sender.signal7(2, "two");
+        emit sender.signal7(3, "three");
+        QVERIFY(receiver.numbers.isEmpty());
+        QCoreApplication::sendPostedEvents(&receiver, QEvent::MetaCall);
+        QCOMPARE(receiver.metaCallEvents, 1);
+        QCOMPARE(receiver.numbers, expectedNumbers);
+        QCOMPARE(receiver.strings, expectedStrings);
+
+        // once delivered, the next emission starts a new batch
+        emit sender.signal7(4, "four");
+        QCoreApplication::sendPostedEvents(&receiver, QEvent::MetaCall);
+        QCOMPARE(receiver.metaCallEvents, 2);
+        QCOMPARE(receiver.numbers.last(), 4);
+        QCOMPARE(receiver.strings.last(), QString("four"));
+    }
+
+    {
+        // same with a functor and a signal without arguments
+        SenderObject sender;
+        BatchReceiver receiver;
+        QVERIFY(connect(&sender, &SenderObject::signal1, &receiver, &BatchReceiver::count,
+                        Qt::ConnectionType(Qt::QueuedConnection | Qt::BatchedConnection)));
+        QVERIFY(connect(&sender, &SenderObject::signal7, &receiver, &BatchReceiver::record,
+                        Qt::ConnectionType(Qt::QueuedConnection | Qt::BatchedConnection)));
+        sender.emitSignal1();
+        sender.emitSignal1();
+        sender.emitSignal1();
+        QCoreApplication::sendPostedEvents(&receiver, QEvent::MetaCall);
+        QCOMPARE(receiver.metaCallEvents, 1);
+        QCOMPARE(receiver.numbers, QList<int>() << 0 << 1 << 2);
+
+        receiver.numbers.clear();
+        emit sender.signal7(1, "one");
+        emit sender.signal7(2, "two");
+        emit sender.signal7(3, "three");
+        QCoreApplication::sendPostedEvents(&receiver, QEvent::MetaCall);
+        QCOMPARE(receiver.metaCallEvents, 2);
+        QCOMPARE(receiver.numbers, expectedNumbers);
+        QCOMPARE(receiver.strings, expectedStrings);
+    }
+
+    {
+        // the receiver can delete itself in the middle of a batch
+        SenderObject sender;
+        QPointer<BatchReceiver> receiver = new BatchReceiver;
+        receiver->deleteAfter = 2;
+        QVERIFY(connect(&sender, &SenderObject::signal7, receiver.data(), &BatchReceiver::record,
+                        Qt::ConnectionType(Qt::QueuedConnection | Qt::BatchedConnection)));
+        emit sender.signal7(1, "one");
+        emit sender.signal7(2, "two");
+        emit sender.signal7(3, "three");
+        QCoreApplication::sendPostedEvents(receiver.data(), QEvent::MetaCall);
+        QVERIFY(receiver.isNull());
+    }
+
+    {
+        // pending emissions are dropped with their receiver
+        SenderObject sender;
+        BatchReceiver *receiver = new BatchReceiver;
+        QVERIFY(connect(&sender, &SenderObject::signal7, receiver, &BatchReceiver::record,
+                        Qt::ConnectionType(Qt::QueuedConnection | Qt::BatchedConnection)));
+        emit sender.signal7(1, "one");
+        emit sender.signal7(2, "two");
+        delete receiver;
+        emit sender.signal7(3, "three");
+        QCoreApplication::sendPostedEvents();
+    }
+
+    {
+        // emissions from another thread arrive complete and in order
+        const int count = 10000;
+        SenderObject sender;
+        BatchReceiver receiver;
+        BatchSenderThread thread;
+        thread.sender = &sender;
+        thread.count = count;
+        QVERIFY(connect(&sender, &SenderObject::signal7, &receiver, &BatchReceiver::record,
+                        Qt::ConnectionType(Qt::AutoConnection | Qt::BatchedConnection)));
+        thread.start();
+        QVERIFY(thread.wait());
+        QTRY_COMPARE(receiver.numbers.size(), count);
+        QVERIFY(receiver.metaCallEvents <= count);
+        for (int i = 0; i < count; ++i) {
+            QCOMPARE(receiver.numbers.at(i), i);
+            QCOMPARE(receiver.strings.at(i), QString::number(i));
+        }
+    }
+}
+
 class EventSpy : public QObject
 {
     Q_OBJECT
@@ -45,6 +45,8 @@
 
 #include <QtTest/QtTest>
 
+Q_DECLARE_METATYPE(QMimeDatabase::MatchMode)
+
 static const char *const additionalMimeFiles[] = {
     "yast2-metapackage-handler-mimetypes.xml",
     "qml-again.xml",
@@ -688,6 +690,79 @@ void tst_QMimeDatabase::symlinkToFifo() // QTBUG-48529
 #endif
 }
 
+void tst_QMimeDatabase::mimeTypesForFiles_data()
+{
+    QTest::addColumn<QMimeDatabase::MatchMode>("mode");
+
+    QTest::newRow("default") << QMimeDatabase::MatchDefault;
+    QTest::newRow("extension") << QMimeDatabase::MatchExtension;
+    QTest::newRow("content") << QMimeDatabase::MatchContent;
+}
+
+void tst_QMimeDatabase::mimeTypesForFiles()
+{
+    QFETCH(QMimeDatabase::MatchMode, mode);
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QDir dir(tempDir.path());
+    const auto writeFile = [&dir](const char *fileName, const QByteArray &contents) {
+        QFile file(dir.filePath(QLatin1String(fileName)));
+        return file.open(QIODevice::WriteOnly) && file.write(contents) == contents.size();
+    };
+    QVERIFY(writeFile("pdf.txt", "%PDF-"));
+    QVERIFY(writeFile("pdf", "%PDF-"));
+    QVERIFY(writeFile("smil.txt", "<smil"));
+    QVERIFY(writeFile("empty", QByteArray()));
+    QVERIFY(writeFile("text", "just text\n"));
+    QVERIFY(writeFile("binary", QByteArray(100, '\1')));
+    QVERIFY(writeFile("foo.tar.bz2", "BZh"));
+    QVERIFY(writeFile("Makefile", "all:\n"));
+    QVERIFY(writeFile("translation.ts", "<?xml version=\"1.0\"?>\n<TS version=\"2.1\">"));
+    QVERIFY(dir.mkdir("directory"));
+    QStringList fileNames = dir.entryList(QDir::AllEntries | QDir::NoDotAndDotDot);
+    for (QString &fileName : fileNames)
+        fileName = dir.filePath(fileName);
+    fileNames << dir.filePath("missing.png") << dir.filePath("missing") << dir.filePath("directory/")
+              << QString();
+#ifdef Q_OS_UNIX
+    const QString fifo = dir.filePath("fifo");
+    QCOMPARE(mkfifo(QFile::encodeName(fifo), 0006), 0);
+    fileNames << fifo;
+#endif
+    const QString testData = QFINDTESTDATA("testdata.qrc");
+    if (!testData.isEmpty()) {
+        const QFileInfoList testFiles = QFileInfo(testData).absoluteDir().entryInfoList(QDir::Files);
+        for (const QFileInfo &fileInfo : testFiles)
+            fileNames << fileInfo.filePath();
+    }
+
+    QMimeDatabase db;
+    QStringList expected;
+    for (const QString &fileName : qAsConst(fileNames))
+        expected << db.mimeTypeForFile(fileName, mode).name();
+
+    QList<QMimeType> mimeTypes = db.mimeTypesForFiles(fileNames, mode);
+    QCOMPARE(mimeTypes.size(), fileNames.size());
+    for (int i = 0; i < fileNames.size(); ++i)
+        QVERIFY2(mimeTypes.at(i).name() == expected.at(i), qPrintable(fileNames.at(i) + ": " + mimeTypes.at(i).name()));
+    QVERIFY(db.mimeTypesForFiles(QStringList(), mode).isEmpty());
+
+    // Enough files to spread them over several threads
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const int maxThreadCount = pool->maxThreadCount();
+    pool->setMaxThreadCount(4);
+    const int repeat = 200;
+    QStringList manyFileNames;
+    for (int i = 0; i < repeat; ++i)
+        manyFileNames += fileNames;
+    mimeTypes = db.mimeTypesForFiles(manyFileNames, mode);
+    pool->setMaxThreadCount(maxThreadCount);
+    QCOMPARE(mimeTypes.size(), manyFileNames.size());
+    for (int i = 0; i < manyFileNames.size(); ++i)
+        QCOMPARE(mimeTypes.at(i).name(), expected.at(i % fileNames.size()));
+}
+
 void tst_QMimeDatabase::findByFileName_data()
 {
     QTest::addColumn<QString>("filePath");
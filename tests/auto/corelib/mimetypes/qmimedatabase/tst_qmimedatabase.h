@@ -67,6 +67,8 @@ private slots:
     void suffixes();
     void knownSuffix();
     void symlinkToFifo();
+    void mimeTypesForFiles_data();
+    void mimeTypesForFiles();
     void fromThreads();
 
     // shared-mime-info test suite
@@ -39,6 +39,8 @@
 #define UNICODE_NON_CHARACTER "\xEF\xBF\xBF"
 #define UNICODE_DJE "\320\202" // Character from the Serbian Cyrillic alphabet
 
+Q_DECLARE_METATYPE(QJsonDocument::DataValidation)
+
 class tst_QtJson: public QObject
 {
     Q_OBJECT
@@ -99,6 +101,9 @@ private Q_SLOTS:
     void toAndFromBinary_data();
     void toAndFromBinary();
     void invalidBinaryData();
+    void fromBinaryFile_data();
+    void fromBinaryFile();
+    void lazyValidation();
     void parseNumbers();
     void parseStrings();
     void parseDuplicateKeys();
@@ -1739,6 +1744,30 @@ void tst_QtJson::fromJsonErrors()
         QCOMPARE(error.error, QJsonParseError::IllegalNumber);
         QCOMPARE(error.offset, 15);
     }
+    {
+        QJsonParseError error;
+        QByteArray json = "[\n    1e]";
+        QJsonDocument doc = QJsonDocument::fromJson(json, &error);
+        QVERIFY(doc.isEmpty());
+        QCOMPARE(error.error, QJsonParseError::IllegalNumber);
+        QCOMPARE(error.offset, 8);
+    }
+    {
+        QJsonParseError error;
+        QByteArray json = "[\n    1e+]";
+        QJsonDocument doc = QJsonDocument::fromJson(json, &error);
+        QVERIFY(doc.isEmpty());
+        QCOMPARE(error.error, QJsonParseError::IllegalNumber);
+        QCOMPARE(error.offset, 9);
+    }
+    {
+        QJsonParseError error;
+        QByteArray json = "[\n    1.5E-]";
+        QJsonDocument doc = QJsonDocument::fromJson(json, &error);
+        QVERIFY(doc.isEmpty());
+        QCOMPARE(error.error, QJsonParseError::IllegalNumber);
+        QCOMPARE(error.offset, 11);
+    }
     {
         QJsonParseError error;
         QByteArray json = "[\n    \"\\u12\"]";
@@ -1843,6 +1872,95 @@ void tst_QtJson::invalidBinaryData()
         QByteArray bytes = file.readAll();
         QJsonDocument document = QJsonDocument::fromRawData(bytes.constData(), bytes.size());
         QVERIFY(document.isNull());
+
+        // lazy validation may only notice the error later, but must not crash
+        document = QJsonDocument::fromRawData(bytes.constData(), bytes.size(),
+                                              QJsonDocument::ValidateLazily);
+        document.toVariant();
+        QVERIFY(document.toJson().isEmpty());
+    }
+}
+
+void tst_QtJson::fromBinaryFile_data()
+{
+    QTest::addColumn<QJsonDocument::DataValidation>("validation");
+    QTest::newRow("Validate") << QJsonDocument::Validate;
+    QTest::newRow("BypassValidation") << QJsonDocument::BypassValidation;
+    QTest::newRow("ValidateLazily") << QJsonDocument::ValidateLazily;
+}
+
+void tst_QtJson::fromBinaryFile()
+{
+    QFETCH(QJsonDocument::DataValidation, validation);
+
+    QFile file(testDataDir + "/test.json");
+    QVERIFY(file.open(QFile::ReadOnly));
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    QVERIFY(!doc.isNull());
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = dir.filePath("test.bjson");
+    QSaveFile out(fileName);
+    QVERIFY(out.open(QIODevice::WriteOnly));
+    int size;
+    const char *data = doc.rawData(&size);
+    QCOMPARE(out.write(data, size), qint64(size));
+    QVERIFY(out.commit());
+
+    QJsonDocument mapped = QJsonDocument::fromBinaryFile(fileName, validation);
+    QVERIFY(!mapped.isNull());
+    QCOMPARE(mapped, doc);
+    QCOMPARE(mapped.toJson(), doc.toJson());
+
+    // modifying the document copies the data and leaves the file alone
+    QJsonArray array = mapped.array();
+    array.removeFirst();
+    array.append(QLatin1String("appended"));
+    QJsonObject object = array.at(0).toObject();
+    object.remove(object.keys().first());
+    QCOMPARE(array.last(), QJsonValue(QLatin1String("appended")));
+    QCOMPARE(QJsonDocument::fromBinaryFile(fileName, validation), doc);
+
+    QVERIFY(QJsonDocument::fromBinaryFile(dir.filePath("missing.bjson"), validation).isNull());
+    QFile garbage(dir.filePath("garbage.bjson"));
+    QVERIFY(garbage.open(QIODevice::WriteOnly));
+    garbage.write("qbjs garbage");
+    garbage.close();
+    if (validation != QJsonDocument::BypassValidation)
+        QVERIFY(QJsonDocument::fromBinaryFile(garbage.fileName(), validation).isNull());
+}
+
+void tst_QtJson::lazyValidation()
+{
+    QFile file(testDataDir + "/test.json");
+    QVERIFY(file.open(QFile::ReadOnly));
+    const QByteArray binary = QJsonDocument::fromJson(file.readAll()).toBinaryData();
+    QVERIFY(!binary.isEmpty());
+
+    const QJsonDocument lazy = QJsonDocument::fromBinaryData(binary, QJsonDocument::ValidateLazily);
+    QCOMPARE(lazy, QJsonDocument::fromBinaryData(binary));
+    QCOMPARE(lazy.toVariant(), QJsonDocument::fromBinaryData(binary).toVariant());
+
+    // damaged documents read the same as fully validated ones as far as
+    // they are intact, and never crash
+    QRandomGenerator rng(42);
+    for (int i = 0; i < 2000; ++i) {
+        QByteArray damaged = binary;
+        const int count = 1 + rng.bounded(4);
+        for (int j = 0; j < count; ++j) {
+            const int pos = 8 + rng.bounded(damaged.size() - 8);
+            damaged[pos] = char(rng.bounded(256));
+        }
+        const QJsonDocument checked = QJsonDocument::fromBinaryData(damaged);
+        const QJsonDocument unchecked = QJsonDocument::fromBinaryData(damaged, QJsonDocument::ValidateLazily);
+        if (!checked.isNull()) {
+            QVERIFY(!unchecked.isNull());
+            QCOMPARE(unchecked.toVariant(), checked.toVariant());
+        } else if (!unchecked.isNull()) {
+            unchecked.toVariant();
+            QVERIFY(unchecked.toJson().isEmpty());
+        }
     }
 }
 
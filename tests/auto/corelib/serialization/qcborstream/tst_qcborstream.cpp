@@ -0,0 +1,707 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest>
+
+#include <qbuffer.h>
+#include <qcborstream.h>
+#include <qjsonarray.h>
+#include <qjsondocument.h>
+#include <qjsonobject.h>
+#include <qrandom.h>
+
+class tst_QCborStream : public QObject
+{
+    Q_OBJECT
+private slots:
+    void integers_data();
+    void integers();
+    void floats_data();
+    void floats();
+    void strings_data();
+    void strings();
+    void readStringData();
+    void readStringDataFromDevice();
+    void containers();
+    void skipping();
+    void tags();
+    void errors_data();
+    void errors();
+    void incremental();
+    void device();
+    void multipleItems();
+
+    void writerCounts();
+    void jsonRoundTrip();
+    void jsonConversion();
+    void variantRoundTrip();
+    void fuzz();
+};
+
+static QByteArray encode(const std::function<void (QCborStreamWriter &)> &f)
+{
+    QByteArray data;
+    QCborStreamWriter writer(&data);
+    f(writer);
+    return data;
+}
+
+// test vectors from RFC 7049, appendix A
+void tst_QCborStream::integers_data()
+{
+    QTest::addColumn<QByteArray>("encoded");
+    QTest::addColumn<qint64>("value");
+
+    QTest::newRow("0") << QByteArray::fromHex("00") << Q_INT64_C(0);
+    QTest::newRow("1") << QByteArray::fromHex("01") << Q_INT64_C(1);
+    QTest::newRow("23") << QByteArray::fromHex("17") << Q_INT64_C(23);
+    QTest::newRow("24") << QByteArray::fromHex("1818") << Q_INT64_C(24);
+    QTest::newRow("100") << QByteArray::fromHex("1864") << Q_INT64_C(100);
+    QTest::newRow("1000") << QByteArray::fromHex("1903e8") << Q_INT64_C(1000);
+    QTest::newRow("1000000") << QByteArray::fromHex("1a000f4240") << Q_INT64_C(1000000);
+    QTest::newRow("1000000000000") << QByteArray::fromHex("1b000000e8d4a51000")
+                                   << Q_INT64_C(1000000000000);
+    QTest::newRow("-1") << QByteArray::fromHex("20") << Q_INT64_C(-1);
+    QTest::newRow("-10") << QByteArray::fromHex("29") << Q_INT64_C(-10);
+    QTest::newRow("-100") << QByteArray::fromHex("3863") << Q_INT64_C(-100);
+    QTest::newRow("-1000") << QByteArray::fromHex("3903e7") << Q_INT64_C(-1000);
+    QTest::newRow("min") << QByteArray::fromHex("3b7fffffffffffffff")
+                         << std::numeric_limits<qint64>::min();
+}
+
+void tst_QCborStream::integers()
+{
+    QFETCH(QByteArray, encoded);
+    QFETCH(qint64, value);
+
+    QCOMPARE(encode([=](QCborStreamWriter &w) { w.append(value); }), encoded);
+
+    QCborStreamReader reader(encoded);
+    QVERIFY(reader.isInteger());
+    QCOMPARE(reader.isNegativeInteger(), value < 0);
+    QCOMPARE(reader.toInteger(), value);
+    QVERIFY(reader.next());
+    QCOMPARE(reader.currentOffset(), qint64(encoded.size()));
+    QVERIFY(!reader.hasNext());
+    QCOMPARE(reader.lastError(), QCborError::EndOfFile);
+}
+
+void tst_QCborStream::floats_data()
+{
+    QTest::addColumn<QByteArray>("encoded");
+    QTest::addColumn<double>("value");
+
+    QTest::newRow("half 1.0") << QByteArray::fromHex("f93c00") << 1.0;
+    QTest::newRow("half -4.0") << QByteArray::fromHex("f9c400") << -4.0;
+    QTest::newRow("half 65504.0") << QByteArray::fromHex("f97bff") << 65504.0;
+    QTest::newRow("float 100000.0") << QByteArray::fromHex("fa47c35000") << 100000.0;
+    QTest::newRow("float 3.4028234663852886e+38") << QByteArray::fromHex("fa7f7fffff")
+                                                  << 3.4028234663852886e+38;
+    QTest::newRow("double 1.1") << QByteArray::fromHex("fb3ff199999999999a") << 1.1;
+    QTest::newRow("double -4.1") << QByteArray::fromHex("fbc010666666666666") << -4.1;
+}
+
+void tst_QCborStream::floats()
+{
+    QFETCH(QByteArray, encoded);
+    QFETCH(double, value);
+
+    QCborStreamReader reader(encoded);
+    QCOMPARE(int(reader.type()), int(uchar(encoded.at(0))));
+    QCOMPARE(reader.toDouble(), value);
+
+    QByteArray written;
+    if (reader.isFloat16())
+        written = encode([=](QCborStreamWriter &w) { w.append(qfloat16(float(value))); });
+    else if (reader.isFloat())
+        written = encode([=](QCborStreamWriter &w) { w.append(float(value)); });
+    else
+        written = encode([=](QCborStreamWriter &w) { w.append(value); });
+    QCOMPARE(written, encoded);
+}
+
+void tst_QCborStream::strings_data()
+{
+    QTest::addColumn<QByteArray>("encoded");
+    QTest::addColumn<bool>("isText");
+    QTest::addColumn<QByteArray>("contents");
+
+    QTest::newRow("empty-bytes") << QByteArray::fromHex("40") << false << QByteArray();
+    QTest::newRow("bytes") << QByteArray::fromHex("4401020304") << false
+                           << QByteArray::fromHex("01020304");
+    QTest::newRow("empty-text") << QByteArray::fromHex("60") << true << QByteArray();
+    QTest::newRow("a") << QByteArray::fromHex("6161") << true << QByteArray("a");
+    QTest::newRow("IETF") << QByteArray::fromHex("6449455446") << true << QByteArray("IETF");
+    QTest::newRow("u-umlaut") << QByteArray::fromHex("62c3bc") << true << QByteArray("\xc3\xbc");
+    QTest::newRow("water") << QByteArray::fromHex("63e6b0b4") << true
+                           << QByteArray("\xe6\xb0\xb4");
+    QTest::newRow("surrogate-pair") << QByteArray::fromHex("64f0908591") << true
+                                    << QByteArray("\xf0\x90\x85\x91");
+    QTest::newRow("chunked-bytes") << QByteArray::fromHex("5f42010243030405ff") << false
+                                   << QByteArray::fromHex("0102030405");
+    QTest::newRow("chunked-text") << QByteArray::fromHex("7f657374726561646d696e67ff") << true
+                                  << QByteArray("streaming");
+    QTest::newRow("chunked-empty") << QByteArray::fromHex("7fff") << true << QByteArray();
+}
+
+void tst_QCborStream::strings()
+{
+    QFETCH(QByteArray, encoded);
+    QFETCH(bool, isText);
+    QFETCH(QByteArray, contents);
+
+    QCborStreamReader reader(encoded);
+    QCOMPARE(reader.isString(), isText);
+    QCOMPARE(reader.isByteArray(), !isText);
+    QCOMPARE(reader.isLengthKnown(), (uchar(encoded.at(0)) & 0x1f) != 0x1f);
+    if (reader.isLengthKnown())
+        QCOMPARE(reader.length(), quint64(contents.size()));
+
+    if (isText) {
+        auto r = reader.readString();
+        QCOMPARE(r.status, QCborStreamReader::Ok);
+        QCOMPARE(r.data, QString::fromUtf8(contents));
+    } else {
+        auto r = reader.readByteArray();
+        QCOMPARE(r.status, QCborStreamReader::Ok);
+        QCOMPARE(r.data, contents);
+    }
+    QCOMPARE(reader.currentOffset(), qint64(encoded.size()));
+    QCOMPARE(reader.lastError(), QCborError::EndOfFile);
+
+    QCborStreamReader rawReader(encoded);
+    auto raw = rawReader.readStringData();
+    QCOMPARE(raw.status, QCborStreamReader::Ok);
+    QCOMPARE(raw.data, contents);
+
+    if ((uchar(encoded.at(0)) & 0x1f) != 0x1f) {
+        const QByteArray written = isText
+                ? encode([=](QCborStreamWriter &w) { w.append(QString::fromUtf8(contents)); })
+                : encode([=](QCborStreamWriter &w) { w.append(contents); });
+        QCOMPARE(written, encoded);
+    }
+}
+
+void tst_QCborStream::readStringData()
+{
+    const QByteArray encoded = QByteArray::fromHex("824461626364656162636465");
+    QCborStreamReader reader(encoded.constData(), encoded.size());
+    QVERIFY(reader.enterContainer());
+
+    auto bytes = reader.readStringData();
+    QCOMPARE(bytes.status, QCborStreamReader::Ok);
+    QCOMPARE(bytes.data, QByteArray("abcd"));
+    QCOMPARE(bytes.data.constData(), encoded.constData() + 2);
+
+    auto text = reader.readStringData();
+    QCOMPARE(text.status, QCborStreamReader::Ok);
+    QCOMPARE(text.data, QByteArray("abcde"));
+    QCOMPARE(text.data.constData(), encoded.constData() + 7);
+
+    QVERIFY(!reader.hasNext());
+    QVERIFY(reader.leaveContainer());
+}
+
+void tst_QCborStream::readStringDataFromDevice()
+{
+    // the second string starts in the first chunk read from the device and
+    // ends in the next one, so reading it refills the buffer
+    const QByteArray first(16380, 'a');
+    const QByteArray second(2000, 'b');
+    QBuffer buffer;
+    buffer.open(QIODevice::ReadWrite);
+    {
+        QCborStreamWriter writer(&buffer);
+        writer.appendTextString(first.constData(), first.size());
+        writer.appendTextString(second.constData(), second.size());
+        writer.append(QByteArray(3000, 'c'));
+    }
+
+    buffer.seek(0);
+    QCborStreamReader reader(&buffer);
+    auto r1 = reader.readStringData();
+    QCOMPARE(r1.status, QCborStreamReader::Ok);
+    auto r2 = reader.readStringData();
+    QCOMPARE(r2.status, QCborStreamReader::Ok);
+    auto r3 = reader.readStringData();
+    QCOMPARE(r3.status, QCborStreamReader::Ok);
+    QCOMPARE(r1.data, first);
+    QCOMPARE(r2.data, second);
+    QCOMPARE(r3.data, QByteArray(3000, 'c'));
+    QVERIFY(!reader.hasNext());
+}
+
+void tst_QCborStream::containers()
+{
+    // {"a": 1, "b": [2, 3]}
+    const QByteArray encoded = QByteArray::fromHex("a26161016162820203");
+    QCborStreamReader reader(encoded);
+    QVERIFY(reader.isMap());
+    QVERIFY(reader.isLengthKnown());
+    QCOMPARE(reader.length(), quint64(2));
+    QCOMPARE(reader.containerDepth(), 0);
+    QCOMPARE(reader.parentContainerType(), QCborStreamReader::Invalid);
+
+    QVERIFY(reader.enterContainer());
+    QCOMPARE(reader.containerDepth(), 1);
+    QCOMPARE(reader.parentContainerType(), QCborStreamReader::Map);
+    QCOMPARE(reader.readString().data, QString("a"));
+    QCOMPARE(reader.toInteger(), Q_INT64_C(1));
+    QVERIFY(reader.next());
+    QCOMPARE(reader.readString().data, QString("b"));
+    QVERIFY(reader.isArray());
+    QVERIFY(reader.enterContainer());
+    QCOMPARE(reader.parentContainerType(), QCborStreamReader::Array);
+    QCOMPARE(reader.toInteger(), Q_INT64_C(2));
+    QVERIFY(reader.next());
+    QCOMPARE(reader.toInteger(), Q_INT64_C(3));
+    QVERIFY(reader.next());
+    QVERIFY(!reader.hasNext());
+    QCOMPARE(reader.lastError(), QCborError::NoError);
+    QVERIFY(reader.leaveContainer());
+    QVERIFY(!reader.hasNext());
+    QVERIFY(reader.leaveContainer());
+    QCOMPARE(reader.containerDepth(), 0);
+    QCOMPARE(reader.currentOffset(), qint64(encoded.size()));
+
+    // the same, with indefinite lengths
+    QCborStreamReader indefinite(QByteArray::fromHex("bf61610161629f0203ffff"));
+    QVERIFY(indefinite.isMap());
+    QVERIFY(!indefinite.isLengthKnown());
+    QCOMPARE(indefinite.readJsonValue(),
+             QJsonValue(QJsonObject{ { "a", 1 }, { "b", QJsonArray{ 2, 3 } } }));
+    QCOMPARE(indefinite.lastError(), QCborError::EndOfFile);
+    QCOMPARE(indefinite.currentOffset(), qint64(11));
+}
+
+void tst_QCborStream::skipping()
+{
+    // [1, [2, 3], {"x": [4]}, "y", 5]
+    const QByteArray encoded = QByteArray::fromHex("8501820203a161788104617905");
+    QCborStreamReader reader(encoded);
+    QVERIFY(reader.enterContainer());
+    QVERIFY(reader.next());
+    QVERIFY(reader.isArray());
+    QVERIFY(reader.next());
+    QVERIFY(reader.isMap());
+    QVERIFY(reader.next());
+    QVERIFY(reader.isString());
+    QVERIFY(reader.next());
+    QCOMPARE(reader.toInteger(), Q_INT64_C(5));
+    QVERIFY(reader.leaveContainer());
+    QCOMPARE(reader.currentOffset(), qint64(encoded.size()));
+
+    // leaveContainer() skips what was not read
+    QCborStreamReader early(encoded);
+    QVERIFY(early.enterContainer());
+    QVERIFY(early.next());
+    QVERIFY(early.enterContainer());
+    QVERIFY(early.leaveContainer());
+    QVERIFY(early.isMap());
+    QVERIFY(early.leaveContainer());
+    QCOMPARE(early.currentOffset(), qint64(encoded.size()));
+
+    // the nesting allowed while skipping is limited
+    QCborStreamReader nested(QByteArray::fromHex("8181818100"));
+    QVERIFY(!nested.next(3));
+    QCOMPARE(nested.lastError(), QCborError::NestingTooDeep);
+    QCborStreamReader nested2(QByteArray::fromHex("8181818100"));
+    QVERIFY(nested2.next(4));
+}
+
+void tst_QCborStream::tags()
+{
+    // 1(1363896240), 0("2013-03-21T20:04:00Z")
+    const QByteArray encoded = QByteArray::fromHex("c11a514b67b0"
+                                                   "c074323031332d30332d32315432303a30343a30305a");
+    QCborStreamReader reader(encoded);
+    QVERIFY(reader.isTag());
+    QCOMPARE(quint64(reader.toTag()), quint64(QCborKnownTags::UnixTime_t));
+    QVERIFY(reader.next());
+    QCOMPARE(reader.toInteger(), Q_INT64_C(1363896240));
+    QVERIFY(reader.next());
+    QVERIFY(reader.isTag());
+    QCOMPARE(reader.readVariant(),
+             QVariant(QDateTime(QDate(2013, 3, 21), QTime(20, 4), Qt::UTC)));
+
+    QCborStreamReader variant(encoded);
+    QCOMPARE(variant.readVariant(), QVariant(QDateTime::fromMSecsSinceEpoch(1363896240000, Qt::UTC)));
+
+    // skipping a tag skips the item it applies to
+    QCborStreamReader skip(QByteArray::fromHex("82c1820102c20103"));
+    QVERIFY(skip.enterContainer());
+    qint64 offset = skip.currentOffset();
+    QVERIFY(skip.isTag());
+    QVERIFY(skip.next());
+    QVERIFY(skip.isArray());
+    QVERIFY(skip.next());
+    QVERIFY(skip.currentOffset() > offset);
+    QVERIFY(skip.isTag());
+    QVERIFY(skip.next());
+    QVERIFY(skip.next());
+    QVERIFY(!skip.hasNext());
+    QVERIFY(skip.leaveContainer());
+
+    QCOMPARE(encode([](QCborStreamWriter &w) {
+                 w.append(QCborKnownTags::UnixTime_t);
+                 w.append(1363896240);
+             }), encoded.left(6));
+}
+
+void tst_QCborStream::errors_data()
+{
+    QTest::addColumn<QByteArray>("encoded");
+    QTest::addColumn<int>("error");
+
+    QTest::newRow("empty") << QByteArray() << int(QCborError::EndOfFile);
+    QTest::newRow("truncated-integer") << QByteArray::fromHex("1a0000") << int(QCborError::EndOfFile);
+    QTest::newRow("truncated-string") << QByteArray::fromHex("6461626364"
+                                                             ).left(4) << int(QCborError::EndOfFile);
+    QTest::newRow("truncated-array") << QByteArray::fromHex("830102") << int(QCborError::EndOfFile);
+    QTest::newRow("unterminated-array") << QByteArray::fromHex("9f0102") << int(QCborError::EndOfFile);
+    QTest::newRow("reserved-28") << QByteArray::fromHex("1c") << int(QCborError::IllegalNumber);
+    QTest::newRow("reserved-30") << QByteArray::fromHex("5e") << int(QCborError::IllegalNumber);
+    QTest::newRow("indefinite-integer") << QByteArray::fromHex("1f") << int(QCborError::IllegalNumber);
+    QTest::newRow("indefinite-tag") << QByteArray::fromHex("df") << int(QCborError::IllegalNumber);
+    QTest::newRow("break") << QByteArray::fromHex("ff") << int(QCborError::UnexpectedBreak);
+    QTest::newRow("break-in-array") << QByteArray::fromHex("8201ff") << int(QCborError::UnexpectedBreak);
+    QTest::newRow("break-after-tag") << QByteArray::fromHex("9fc1ff") << int(QCborError::UnexpectedBreak);
+    QTest::newRow("break-after-key") << QByteArray::fromHex("bf01ff") << int(QCborError::UnexpectedBreak);
+    QTest::newRow("simple-type") << QByteArray::fromHex("f810") << int(QCborError::IllegalSimpleType);
+    QTest::newRow("invalid-utf8") << QByteArray::fromHex("62c328") << int(QCborError::InvalidUtf8String);
+    QTest::newRow("overlong-utf8") << QByteArray::fromHex("62c0af") << int(QCborError::InvalidUtf8String);
+    QTest::newRow("chunk-type") << QByteArray::fromHex("5f6161ff") << int(QCborError::IllegalType);
+    QTest::newRow("nested-chunk") << QByteArray::fromHex("7f7f6161ffff") << int(QCborError::IllegalType);
+    QTest::newRow("huge-string") << QByteArray::fromHex("5bffffffffffffffff00") << int(QCborError::DataTooLarge);
+    QTest::newRow("huge-map") << QByteArray::fromHex("bbffffffffffffffff00") << int(QCborError::DataTooLarge);
+    QTest::newRow("huge-array") << QByteArray::fromHex("9bffffffffffffffff00") << int(QCborError::EndOfFile);
+    QTest::newRow("deep-nesting") << QByteArray(2000, char(0x81)) + char(0)
+                                  << int(QCborError::NestingTooDeep);
+}
+
+void tst_QCborStream::errors()
+{
+    QFETCH(QByteArray, encoded);
+    QFETCH(int, error);
+
+    QCborStreamReader reader(encoded);
+    const QJsonValue json = reader.readJsonValue();
+    QCOMPARE(int(reader.lastError()), error);
+    QVERIFY(json.isUndefined());
+    QVERIFY(!reader.hasNext());
+    QVERIFY(!reader.next());
+    QVERIFY(!reader.lastError().toString().isEmpty());
+
+    // skipping neither validates UTF-8 nor limits the nesting as much
+    QCborStreamReader skipper(encoded);
+    while (skipper.next(100000))
+        ;
+    if (error != QCborError::InvalidUtf8String && error != QCborError::NestingTooDeep)
+        QCOMPARE(int(skipper.lastError()), error);
+
+    QCborStreamReader variant(encoded);
+    QVERIFY(!variant.readVariant().isValid());
+    QCOMPARE(int(variant.lastError()), error);
+}
+
+void tst_QCborStream::incremental()
+{
+    const QByteArray encoded = QByteArray::fromHex("a26161016162827f657374726561646d696e67ff03");
+    QCborStreamReader reader;
+    QCOMPARE(reader.lastError(), QCborError::EndOfFile);
+
+    // feed one byte at a time: the current item is only decoded once complete
+    int used = 0;
+    auto feed = [&]() {
+        if (used >= encoded.size())
+            return false;
+        reader.addData(encoded.constData() + used++, 1);
+        reader.reparse();
+        return true;
+    };
+    auto waitFor = [&]() {
+        while (reader.lastError() == QCborError::EndOfFile)
+            if (!feed())
+                return false;
+        return true;
+    };
+    auto readString = [&]() {
+        QCborStreamReader::StringResult<QString> result;
+        while ((result = reader.readString()).status != QCborStreamReader::Ok) {
+            if (reader.lastError() != QCborError::EndOfFile || !feed())
+                break;
+        }
+        return result.data;
+    };
+
+    QVERIFY(waitFor());
+    QVERIFY(reader.enterContainer());
+    QVERIFY(waitFor());
+    QCOMPARE(readString(), QString("a"));
+    QVERIFY(waitFor());
+    QCOMPARE(reader.toInteger(), Q_INT64_C(1));
+    QVERIFY(reader.next());
+    QVERIFY(waitFor());
+    QCOMPARE(readString(), QString("b"));
+    QVERIFY(waitFor());
+    QVERIFY(reader.enterContainer());
+    QVERIFY(waitFor());
+    QVERIFY(reader.isString());
+    QCOMPARE(readString(), QString("streaming"));
+    QVERIFY(waitFor());
+    QCOMPARE(reader.toInteger(), Q_INT64_C(3));
+    QVERIFY(reader.next());
+    QVERIFY(reader.leaveContainer());
+    QVERIFY(reader.leaveContainer());
+    QCOMPARE(used, encoded.size());
+    QCOMPARE(reader.currentOffset(), qint64(encoded.size()));
+}
+
+void tst_QCborStream::device()
+{
+    QJsonArray array;
+    for (int i = 0; i < 5000; ++i)
+        array.append(QJsonObject{ { "index", i }, { "name", QString("item %1").arg(i) } });
+
+    QBuffer buffer;
+    buffer.open(QIODevice::ReadWrite);
+    {
+        QCborStreamWriter writer(&buffer);
+        QCOMPARE(writer.device(), &buffer);
+        writer.appendJsonValue(array);
+        writer.append(42);
+    }
+    QVERIFY(buffer.size() > 16 * 1024);
+
+    buffer.seek(0);
+    QCborStreamReader reader(&buffer);
+    QCOMPARE(reader.device(), &buffer);
+    QCOMPARE(reader.readJsonValue(), QJsonValue(array));
+    QCOMPARE(reader.toInteger(), Q_INT64_C(42));
+    QVERIFY(reader.next());
+    QCOMPARE(reader.lastError(), QCborError::EndOfFile);
+    QCOMPARE(reader.currentOffset(), buffer.size());
+
+    reader.reset();
+    QVERIFY(reader.isArray());
+    QCOMPARE(reader.length(), quint64(5000));
+}
+
+void tst_QCborStream::multipleItems()
+{
+    QByteArray data;
+    QCborStreamWriter writer(&data);
+    for (int i = 0; i < 10; ++i) {
+        writer.startMap(1);
+        writer.append(QLatin1String("i"));
+        writer.append(i);
+        QVERIFY(writer.endMap());
+    }
+
+    QCborStreamReader reader(data);
+    int count = 0;
+    while (reader.hasNext()) {
+        QCOMPARE(reader.readVariant(), QVariant(QVariantMap{ { "i", qint64(count) } }));
+        ++count;
+    }
+    QCOMPARE(count, 10);
+    QCOMPARE(reader.lastError(), QCborError::EndOfFile);
+}
+
+void tst_QCborStream::writerCounts()
+{
+    QByteArray data;
+    QCborStreamWriter writer(&data);
+    writer.startArray(2);
+    writer.append(1);
+    QVERIFY(!writer.endArray());
+
+    writer.startMap(1);
+    writer.append(1);
+    writer.append(2);
+    QVERIFY(writer.endMap());
+
+    writer.startMap();
+    writer.append(1);
+    QVERIFY(!writer.endMap());
+
+    writer.startArray();
+    writer.append(QCborKnownTags::Url);
+    writer.append("http://qt.io");
+    writer.append(QCborSimpleType::Undefined);
+    writer.append(QCborSimpleType(32));
+    writer.append(QCborNegativeInteger(0));
+    writer.append(nullptr);
+    QVERIFY(writer.endArray());
+
+    QCOMPARE(data, QByteArray::fromHex("8201" "a10102" "bf01ff"
+                                       "9fd8206c687474703a2f2f71742e696f" "f7" "f820"
+                                       "3bffffffffffffffff" "f6" "ff"));
+}
+
+void tst_QCborStream::jsonRoundTrip()
+{
+    const QString testFile = QFINDTESTDATA("../json/test.json");
+    QFile file(testFile);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    QVERIFY(!doc.isNull());
+
+    QByteArray cbor;
+    QCborStreamWriter writer(&cbor);
+    writer.appendJsonValue(doc.array());
+    QVERIFY(cbor.size() < doc.toJson(QJsonDocument::Compact).size());
+
+    QCborStreamReader reader(cbor);
+    QCOMPARE(reader.readJsonValue(), QJsonValue(doc.array()));
+    QCOMPARE(reader.lastError(), QCborError::EndOfFile);
+}
+
+void tst_QCborStream::jsonConversion()
+{
+    // byte strings, with and without expected-encoding tags
+    QCborStreamReader bytes(QByteArray::fromHex("8443fbff01d54301ff02d64301ff02d74301ff02"));
+    QCOMPARE(bytes.readJsonValue(), QJsonValue(QJsonArray{ "-_8B", "Af8C", "Af8C", "01ff02" }));
+
+    // values without a JSON equivalent
+    QCborStreamReader special(QByteArray::fromHex("86f97e00fa7f800000f7f0f5f6"));
+    QCOMPARE(special.readJsonValue(),
+             QJsonValue(QJsonArray{ QJsonValue::Null, QJsonValue::Null, QJsonValue::Null,
+                                    QJsonValue::Null, true, QJsonValue::Null }));
+
+    // non-string keys
+    QCborStreamReader keys(QByteArray::fromHex("a4010220f4f582010203f6"));
+    QCOMPARE(keys.readJsonValue(), QJsonValue(QJsonObject{
+                                       { "1", 2 }, { "-1", false }, { "true", QJsonArray{ 1, 2 } },
+                                       { "3", QJsonValue::Null } }));
+
+    // the last of equal keys wins, and keys need not be ASCII
+    QCborStreamReader duplicates(QByteArray::fromHex("a3616201616102616203"));
+    QCOMPARE(duplicates.readJsonValue(), QJsonValue(QJsonObject{ { "a", 2 }, { "b", 3 } }));
+    QCborStreamReader unicode(QByteArray::fromHex("a263c3a46b82626f6b6ae4b8ade69687f09f98806165381a"));
+    QCOMPARE(unicode.readJsonValue(), QJsonValue(QJsonObject{
+                 { QString::fromUtf8("\xc3\xa4k"),
+                   QJsonArray{ "ok", QString::fromUtf8("\xe4\xb8\xad\xe6\x96\x87\xf0\x9f\x98\x80") } },
+                 { "e", QJsonValue(-27) } }));
+
+    // bignums and large integers
+    QCborStreamReader big(QByteArray::fromHex("83c249010000000000000000c349010000000000000000"
+                                              "1bffffffffffffffff"));
+    QCOMPARE(big.readJsonValue(),
+             QJsonValue(QJsonArray{ "AQAAAAAAAAAA", "~AQAAAAAAAAAA", 18446744073709551615. }));
+
+    // integral doubles become integers
+    QCOMPARE(encode([](QCborStreamWriter &w) {
+                 w.appendJsonValue(QJsonArray{ 1.0, -2.0, 0.5, 1e300 });
+             }), QByteArray::fromHex("840121fb3fe0000000000000fb7e37e43c8800759c"));
+}
+
+void tst_QCborStream::variantRoundTrip()
+{
+    QVariantMap map;
+    map.insert("int", qint64(-42));
+    map.insert("uint", quint64(std::numeric_limits<quint64>::max()));
+    map.insert("double", 2.5);
+    map.insert("bool", true);
+    map.insert("null", QVariant::fromValue(nullptr));
+    map.insert("bytes", QByteArray("\0\1\2", 3));
+    map.insert("string", QString::fromUtf8("gr\xc3\xbc\xc3\x9f dich"));
+    map.insert("list", QVariantList{ qint64(1), QString("two"), 3.5 });
+    map.insert("date", QDateTime(QDate(2018, 4, 1), QTime(12, 30, 15, 250), Qt::UTC));
+    map.insert("url", QUrl("https://www.qt.io/?q=cbor"));
+    map.insert("uuid", QUuid("{67c8770b-44f1-410a-ab9a-f9b5446f13ee}"));
+    map.insert("regexp", QRegularExpression("^a+b*$"));
+
+    QByteArray cbor;
+    QCborStreamWriter writer(&cbor);
+    writer.appendVariant(map);
+
+    QCborStreamReader reader(cbor);
+    const QVariant result = reader.readVariant();
+    QCOMPARE(reader.lastError(), QCborError::EndOfFile);
+    QCOMPARE(result.type(), QVariant::Map);
+    const QVariantMap resultMap = result.toMap();
+    QCOMPARE(resultMap.keys(), map.keys());
+    for (auto it = map.cbegin(); it != map.cend(); ++it)
+        QCOMPARE(resultMap.value(it.key()), it.value());
+}
+
+void tst_QCborStream::fuzz()
+{
+    QByteArray valid;
+    {
+        QCborStreamWriter writer(&valid);
+        writer.startArray();
+        writer.append(QCborKnownTags::ExpectedBase16);
+        writer.startMap(3);
+        writer.append("key");
+        writer.append(QByteArray("bytes"));
+        writer.append(1);
+        writer.append(-1.5);
+        writer.append(QString::fromUtf8("\xc3\xa9t\xc3\xa9"));
+        writer.startArray(2);
+        writer.append(qfloat16(1.0f));
+        writer.appendUndefined();
+        writer.endArray();
+        writer.endMap();
+        writer.append(std::numeric_limits<quint64>::max());
+        writer.endArray();
+    }
+
+    // mutated and truncated streams must be rejected, or decode to
+    // something, without reading out of bounds
+    QRandomGenerator rng(1234);
+    for (int i = 0; i < 20000; ++i) {
+        QByteArray data = valid;
+        const int mutations = 1 + rng.bounded(4);
+        for (int m = 0; m < mutations; ++m)
+            data[int(rng.bounded(data.size()))] = char(rng.bounded(256));
+        if (rng.bounded(4) == 0)
+            data.truncate(rng.bounded(data.size()));
+        if (rng.bounded(8) == 0) {
+            data.resize(rng.bounded(64));
+            rng.fillRange(reinterpret_cast<quint32 *>(data.data()), data.size() / 4);
+        }
+
+        QCborStreamReader json(data.constData(), data.size());
+        while (json.hasNext())
+            json.readJsonValue();
+        QCborStreamReader variant(data.constData(), data.size());
+        while (variant.hasNext())
+            variant.readVariant();
+        QCborStreamReader skip(data.constData(), data.size());
+        while (skip.next())
+            ;
+        QCOMPARE(json.lastError() == QCborError::NoError, false);
+    }
+}
+
+QTEST_MAIN(tst_QCborStream)
+
+#include "tst_qcborstream.moc"
@@ -173,6 +173,8 @@ private slots:
     void streamRealDataTypes();
 
     void floatingPointPrecision();
+    void numericVectors_data();
+    void numericVectors();
 
     void compatibility_Qt3();
     void compatibility_Qt2();
@@ -3320,6 +3322,121 @@ void tst_QDataStream::floatingPointPrecision()
 
 }
 
+Q_DECLARE_METATYPE(QDataStream::ByteOrder)
+Q_DECLARE_METATYPE(QDataStream::FloatingPointPrecision)
+
+template <typename T>
+static void checkNumericVector(const QVector<T> &vector, QDataStream::ByteOrder byteOrder, int version,
+                               QDataStream::FloatingPointPrecision precision)
+{
+    const auto setUp = [=](QDataStream &stream) {
+        stream.setByteOrder(byteOrder);
+        stream.setVersion(version);
+        stream.setFloatingPointPrecision(precision);
+    };
+
+    // the whole vector must come out exactly as the elements one by one
+    QByteArray expected;
+    {
+        QDataStream stream(&expected, QIODevice::WriteOnly);
+        setUp(stream);
+        stream << quint32(vector.size());
+        for (T t : vector)
+            stream << t;
+    }
+    QByteArray data;
+    {
+        QDataStream stream(&data, QIODevice::WriteOnly);
+        setUp(stream);
+        stream << vector;
+        QCOMPARE(stream.status(), QDataStream::Ok);
+    }
+    QCOMPARE(data, expected);
+
+    // and reading it must give what reading the elements one by one gives
+    QVector<T> reference;
+    {
+        QDataStream stream(expected);
+        setUp(stream);
+        quint32 n;
+        stream >> n;
+        for (quint32 i = 0; i < n; ++i) {
+            T t;
+            stream >> t;
+            reference.append(t);
+        }
+    }
+    {
+        QDataStream stream(data);
+        setUp(stream);
+        QVector<T> result;
+        stream >> result;
+        QCOMPARE(stream.status(), QDataStream::Ok);
+        QVERIFY(stream.atEnd());
+        QCOMPARE(result, reference);
+    }
+
+    if (!vector.isEmpty()) {
+        QDataStream stream(data.left(data.size() - 1));
+        setUp(stream);
+        QVector<T> result(1);
+        stream >> result;
+        QCOMPARE(stream.status(), QDataStream::ReadPastEnd);
+        QVERIFY(result.isEmpty());
+    }
+}
+
+template <typename T>
+static QVector<T> numericVector(int size)
+{
+    QVector<T> result;
+    for (int i = 0; i < size; ++i)
+        result.append(T((i * 7919) ^ (i << 5)) * T(i % 3 ? 1 : -1));
+    return result;
+}
+
+void tst_QDataStream::numericVectors_data()
+{
+    QTest::addColumn<QDataStream::ByteOrder>("byteOrder");
+    QTest::addColumn<int>("version");
+    QTest::addColumn<QDataStream::FloatingPointPrecision>("precision");
+
+    QTest::newRow("big-endian") << QDataStream::BigEndian << int(QDataStream::Qt_DefaultCompiledVersion)
+                                << QDataStream::DoublePrecision;
+    QTest::newRow("little-endian") << QDataStream::LittleEndian << int(QDataStream::Qt_DefaultCompiledVersion)
+                                   << QDataStream::DoublePrecision;
+    QTest::newRow("single-precision") << QDataStream::BigEndian << int(QDataStream::Qt_DefaultCompiledVersion)
+                                      << QDataStream::SinglePrecision;
+    QTest::newRow("Qt 4.5") << QDataStream::BigEndian << int(QDataStream::Qt_4_5)
+                            << QDataStream::DoublePrecision;
+    QTest::newRow("Qt 3.1") << QDataStream::LittleEndian << int(QDataStream::Qt_3_1)
+                            << QDataStream::DoublePrecision;
+}
+
+void tst_QDataStream::numericVectors()
+{
+    QFETCH(QDataStream::ByteOrder, byteOrder);
+    QFETCH(int, version);
+    QFETCH(QDataStream::FloatingPointPrecision, precision);
+
+    // sizes around the vector width and the size of the swapping buffer
+    for (int size : { 0, 1, 7, 17, 1000, 5000 }) {
+        checkNumericVector(numericVector<qint8>(size), byteOrder, version, precision);
+        checkNumericVector(numericVector<quint8>(size), byteOrder, version, precision);
+        checkNumericVector(numericVector<qint16>(size), byteOrder, version, precision);
+        checkNumericVector(numericVector<quint16>(size), byteOrder, version, precision);
+        checkNumericVector(numericVector<qint32>(size), byteOrder, version, precision);
+        checkNumericVector(numericVector<quint32>(size), byteOrder, version, precision);
+        checkNumericVector(numericVector<qint64>(size), byteOrder, version, precision);
+        checkNumericVector(numericVector<quint64>(size), byteOrder, version, precision);
+        checkNumericVector(numericVector<float>(size), byteOrder, version, precision);
+        checkNumericVector(numericVector<double>(size), byteOrder, version, precision);
+        checkNumericVector(QVector<bool>(size, true), byteOrder, version, precision);
+        if (QTest::currentTestFailed())
+            return;
+    }
+}
+
 void tst_QDataStream::transaction_data()
 {
     QTest::addColumn<qint8>("i8Data");
@@ -0,0 +1,4 @@
+CONFIG += testcase
+TARGET = tst_qjsonstream
+QT = core testlib
+SOURCES = tst_qjsonstream.cpp
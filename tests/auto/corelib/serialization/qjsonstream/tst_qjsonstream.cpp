@@ -0,0 +1,426 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest>
+
+#include <qbuffer.h>
+#include <qjsonarray.h>
+#include <qjsondocument.h>
+#include <qjsonobject.h>
+#include <qjsonstream.h>
+
+class tst_QJsonStream : public QObject
+{
+    Q_OBJECT
+private slots:
+    void tokens_data();
+    void tokens();
+    void incremental_data();
+    void incremental();
+    void errors_data();
+    void errors();
+    void truncatedFile();
+    void numbers();
+    void multipleDocuments();
+    void readValue();
+    void skipCurrentValue();
+    void largeInput();
+
+    void writer_data();
+    void writer();
+    void writerToDevice();
+    void writeCurrentToken();
+};
+
+// Describes the tokens of a reader in a compact form, for comparisons
+static QString describeToken(const QJsonStreamReader &reader)
+{
+    QString prefix = reader.name().isEmpty() ? QString() : reader.name() + QLatin1Char('=');
+    switch (reader.tokenType()) {
+    case QJsonStreamReader::StartObject: return prefix + QLatin1Char('{');
+    case QJsonStreamReader::EndObject: return QStringLiteral("}");
+    case QJsonStreamReader::StartArray: return prefix + QLatin1Char('[');
+    case QJsonStreamReader::EndArray: return QStringLiteral("]");
+    case QJsonStreamReader::String: return prefix + QLatin1Char('"') + reader.text() + QLatin1Char('"');
+    case QJsonStreamReader::Number: return prefix + QString::number(reader.toDouble());
+    case QJsonStreamReader::Bool: return prefix + (reader.toBool() ? QLatin1String("true") : QLatin1String("false"));
+    case QJsonStreamReader::Null: return prefix + QLatin1String("null");
+    case QJsonStreamReader::NoToken: return QStringLiteral("<none>");
+    case QJsonStreamReader::Invalid: return QStringLiteral("<invalid>");
+    }
+    return QString();
+}
+
+static QString readAll(QJsonStreamReader &reader)
+{
+    QStringList tokens;
+    while (!reader.atEnd()) {
+        if (reader.readNext() != QJsonStreamReader::NoToken)
+            tokens << describeToken(reader);
+    }
+    return tokens.join(QLatin1Char(' '));
+}
+
+void tst_QJsonStream::tokens_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("empty-object") << QByteArray("{}") << "{ }";
+    QTest::newRow("empty-array") << QByteArray(" [ ] ") << "[ ]";
+    QTest::newRow("bom") << QByteArray("\xef\xbb\xbf[1]") << "[ 1 ]";
+    QTest::newRow("scalars") << QByteArray("[true, false, null, -1.5e2, \"x\"]")
+                             << "[ true false null -150 \"x\" ]";
+    QTest::newRow("members") << QByteArray("{\"a\": 1, \"b\": [2, {\"c\": \"d\"}], \"e\": {}}")
+                             << "{ a=1 b=[ 2 { c=\"d\" } ] e={ } }";
+    QTest::newRow("whitespace") << QByteArray("\n{\t\"a\"\r\n:\n1 ,\"b\" : 2 }\n")
+                                << "{ a=1 b=2 }";
+    QTest::newRow("escapes") << QByteArray("[\"a\\\"b\\\\c\\/d\\b\\f\\n\\r\\t\\u0041\\u00e9\"]")
+                             << QString::fromUtf8("[ \"a\"b\\c/d\b\f\n\r\tA\xc3\xa9\" ]");
+    QTest::newRow("utf8") << QByteArray("{\"\xc3\xa9t\xc3\xa9\": \"\xe2\x82\xac \xf0\x9f\x98\x80\"}")
+                          << QString::fromUtf8("{ \xc3\xa9t\xc3\xa9=\"\xe2\x82\xac \xf0\x9f\x98\x80\" }");
+    QTest::newRow("surrogate-escape") << QByteArray("[\"\\ud83d\\ude00\"]")
+                                      << QString::fromUtf8("[ \"\xf0\x9f\x98\x80\" ]");
+    QTest::newRow("empty-name") << QByteArray("{\"\": true}") << "{ true }";
+}
+
+void tst_QJsonStream::tokens()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QString, expected);
+
+    QJsonStreamReader reader(json);
+    QCOMPARE(readAll(reader), expected);
+    QVERIFY(!reader.hasError());
+    QCOMPARE(reader.depth(), 0);
+    QCOMPARE(reader.characterOffset(), qint64(json.size()));
+
+    // reading from a device gives the same tokens
+    QBuffer buffer(&json);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QJsonStreamReader deviceReader(&buffer);
+    QCOMPARE(readAll(deviceReader), expected);
+    QVERIFY(!deviceReader.hasError());
+}
+
+void tst_QJsonStream::incremental_data()
+{
+    tokens_data();
+}
+
+void tst_QJsonStream::incremental()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QString, expected);
+
+    // feed the data one byte at a time
+    QJsonStreamReader reader;
+    QStringList tokens;
+    for (char c : json) {
+        reader.addData(QByteArray(1, c));
+        while (reader.readNext() != QJsonStreamReader::NoToken) {
+            QVERIFY(!reader.hasError());
+            tokens << describeToken(reader);
+        }
+        QVERIFY(reader.atEnd());
+    }
+    QCOMPARE(tokens.join(QLatin1Char(' ')), expected);
+    QCOMPARE(reader.depth(), 0);
+}
+
+void tst_QJsonStream::errors_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    QTest::newRow("top-level-scalar") << QByteArray("42");
+    QTest::newRow("unterminated-object") << QByteArray("{\"a\": 1 \"b\": 2}");
+    QTest::newRow("missing-name-separator") << QByteArray("{\"a\" 1}");
+    QTest::newRow("missing-value-separator") << QByteArray("[1 2]");
+    QTest::newRow("missing-object") << QByteArray("[1, ]");
+    QTest::newRow("missing-member") << QByteArray("{\"a\": 1, }");
+    QTest::newRow("illegal-value") << QByteArray("[tru]");
+    QTest::newRow("comma-value") << QByteArray("{\"a\": ,}");
+    QTest::newRow("illegal-number") << QByteArray("[-]");
+    QTest::newRow("missing-exponent") << QByteArray("[1e]");
+    QTest::newRow("missing-exponent-after-sign") << QByteArray("[1.5e+]");
+    QTest::newRow("missing-negative-exponent") << QByteArray("[1.5E-]");
+    QTest::newRow("illegal-escape") << QByteArray("[\"\\u12x4\"]");
+    QTest::newRow("illegal-utf8") << QByteArray("[\"\xc3\x28\"]");
+    QTest::newRow("non-string-name") << QByteArray("{1: 2}");
+    QTest::newRow("deep-nesting") << QByteArray(2000, '[');
+}
+
+void tst_QJsonStream::errors()
+{
+    QFETCH(QByteArray, json);
+
+    QJsonParseError parseError;
+    QJsonDocument::fromJson(json, &parseError);
+    QVERIFY(parseError.error != QJsonParseError::NoError);
+
+    QJsonStreamReader reader(json);
+    while (!reader.atEnd())
+        reader.readNext();
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::Invalid);
+    QCOMPARE(reader.error(), parseError.error);
+    QCOMPARE(reader.errorString(), parseError.errorString());
+
+    // errors are sticky
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+}
+
+void tst_QJsonStream::truncatedFile()
+{
+    const QByteArray json = "{\"a\": [1, 2, {\"b\": \"some text\"}, 3.25], \"c\": true}";
+    for (int length = 1; length < json.size(); ++length) {
+        QByteArray truncated = json.left(length);
+        QBuffer buffer(&truncated);
+        QVERIFY(buffer.open(QIODevice::ReadOnly));
+        QJsonStreamReader reader(&buffer);
+        while (!reader.atEnd())
+            reader.readNext();
+        QVERIFY2(reader.hasError(), truncated.constData());
+        QCOMPARE(reader.tokenType(), QJsonStreamReader::Invalid);
+
+        // data added piecewise may still be completed
+        QJsonStreamReader incremental(truncated);
+        while (!incremental.atEnd())
+            incremental.readNext();
+        QVERIFY(!incremental.hasError());
+        QVERIFY(incremental.depth() > 0);
+        incremental.addData(json.mid(length));
+        QCOMPARE(readAll(incremental).isEmpty(), false);
+        QVERIFY(!incremental.hasError());
+        QCOMPARE(incremental.depth(), 0);
+    }
+}
+
+void tst_QJsonStream::numbers()
+{
+    QJsonStreamReader reader(QByteArray("[0, -7, 9007199254740993, 1.5, 1e3, 99999999999999999999]"));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.toInteger(-1), qint64(0));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.toInteger(), qint64(-7));
+    QCOMPARE(reader.toDouble(), -7.);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.toInteger(), Q_INT64_C(9007199254740993));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.toInteger(-1), qint64(-1));
+    QCOMPARE(reader.toDouble(), 1.5);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.toInteger(-1), qint64(-1));
+    QCOMPARE(reader.toDouble(), 1000.);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.toInteger(-1), qint64(-1));
+    QCOMPARE(reader.toDouble(), 1e20);
+
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndArray);
+    QCOMPARE(reader.toDouble(), 0.);
+}
+
+void tst_QJsonStream::multipleDocuments()
+{
+    QByteArray ndjson;
+    for (int i = 0; i < 100; ++i)
+        ndjson += "{\"id\": " + QByteArray::number(i) + ", \"tags\": [\"a\", \"b\"]}\n";
+
+    QBuffer buffer(&ndjson);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QJsonStreamReader reader(&buffer);
+    int count = 0;
+    while (reader.readNext() == QJsonStreamReader::StartObject) {
+        const QJsonObject object = reader.readValue().toObject();
+        QCOMPARE(object.value(QLatin1String("id")).toInt(), count);
+        QCOMPARE(object.value(QLatin1String("tags")).toArray().size(), 2);
+        ++count;
+    }
+    QCOMPARE(count, 100);
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::NoToken);
+    QVERIFY(reader.atEnd());
+    QVERIFY(!reader.hasError());
+}
+
+void tst_QJsonStream::readValue()
+{
+    const QByteArray json = "{\"array\": [1, \"two\", [3], {\"four\": 4}, null, false], "
+                            "\"object\": {\"x\": {\"y\": \"z\"}}, \"string\": \"s\"}";
+    QJsonStreamReader reader(json);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.readValue().toObject(), QJsonDocument::fromJson(json).object());
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::EndObject);
+    QCOMPARE(reader.depth(), 0);
+
+    // the whole value must be available
+    QJsonStreamReader partial(json.left(24));
+    QCOMPARE(partial.readNext(), QJsonStreamReader::StartObject);
+    QVERIFY(partial.readValue().isUndefined());
+    QCOMPARE(partial.error(), QJsonParseError::UnterminatedArray);
+}
+
+void tst_QJsonStream::skipCurrentValue()
+{
+    QJsonStreamReader reader(QByteArray("{\"skip\": {\"a\": [1, {\"b\": []}]}, \"keep\": 42}"));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.name(), QString("skip"));
+    reader.skipCurrentValue();
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::EndObject);
+    QCOMPARE(reader.depth(), 1);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.name(), QString("keep"));
+    QCOMPARE(reader.toInteger(), qint64(42));
+}
+
+void tst_QJsonStream::largeInput()
+{
+    // strings larger than the reader's buffer, and many values
+    QJsonObject object;
+    QJsonArray array;
+    for (int i = 0; i < 20000; ++i)
+        array.append(QString::number(i));
+    object.insert(QLatin1String("array"), array);
+    object.insert(QLatin1String("long"), QString(100000, QLatin1Char('x')));
+    object.insert(QLatin1String("unicode"), QString(50000, QChar(0x20ac)));
+    QByteArray json = QJsonDocument(object).toJson();
+
+    QBuffer buffer(&json);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QJsonStreamReader reader(&buffer);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.readValue().toObject(), object);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+    QVERIFY(!reader.hasError());
+    QCOMPARE(reader.characterOffset(), qint64(json.size()));
+}
+
+void tst_QJsonStream::writer_data()
+{
+    QTest::addColumn<QJsonValue>("value");
+
+    QJsonObject nested;
+    nested.insert(QLatin1String("empty object"), QJsonObject());
+    nested.insert(QLatin1String("empty array"), QJsonArray());
+    nested.insert(QLatin1String("string"), QString::fromUtf8("\"quoted\"\n\xe2\x82\xac"));
+    QJsonObject object;
+    object.insert(QLatin1String("number"), 1.25);
+    object.insert(QLatin1String("integer"), 42);
+    object.insert(QLatin1String("bool"), true);
+    object.insert(QLatin1String("null"), QJsonValue());
+    object.insert(QLatin1String("nested"), nested);
+    object.insert(QLatin1String("array"), QJsonArray() << 1 << QLatin1String("two") << nested << QJsonArray());
+
+    QTest::newRow("empty-object") << QJsonValue(QJsonObject());
+    QTest::newRow("empty-array") << QJsonValue(QJsonArray());
+    QTest::newRow("object") << QJsonValue(object);
+    QTest::newRow("array") << QJsonValue(QJsonArray() << object << nested << 3);
+}
+
+void tst_QJsonStream::writer()
+{
+    QFETCH(QJsonValue, value);
+    const QJsonDocument document = value.isObject() ? QJsonDocument(value.toObject())
+                                                    : QJsonDocument(value.toArray());
+
+    for (QJsonDocument::JsonFormat format : { QJsonDocument::Indented, QJsonDocument::Compact }) {
+        QByteArray output;
+        {
+            QJsonStreamWriter writer(&output);
+            writer.setFormat(format);
+            QCOMPARE(writer.format(), format);
+            writer.writeValue(value);
+        }
+        QByteArray expected = document.toJson(format);
+        if (!expected.endsWith('\n'))
+            expected += '\n';
+        QCOMPARE(output, expected);
+    }
+}
+
+void tst_QJsonStream::writerToDevice()
+{
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    {
+        QJsonStreamWriter writer(&buffer);
+        writer.setFormat(QJsonDocument::Compact);
+        for (int i = 0; i < 3; ++i) {
+            writer.writeStartObject();
+            writer.writeValue(QLatin1String("id"), i);
+            writer.writeStartArray(QLatin1String("list"));
+            writer.writeValue(QLatin1String("a"));
+            writer.writeStartObject();
+            writer.writeEndObject();
+            writer.writeEndArray();
+            writer.writeEndObject();
+            // every top-level value is flushed
+            QCOMPARE(buffer.data().count('\n'), i + 1);
+        }
+        QVERIFY(!writer.hasError());
+    }
+    QCOMPARE(buffer.data(), QByteArray("{\"id\":0,\"list\":[\"a\",{}]}\n"
+                                       "{\"id\":1,\"list\":[\"a\",{}]}\n"
+                                       "{\"id\":2,\"list\":[\"a\",{}]}\n"));
+
+    QBuffer readOnly;
+    QVERIFY(readOnly.open(QIODevice::ReadOnly));
+    QJsonStreamWriter failing(&readOnly);
+    QTest::ignoreMessage(QtWarningMsg, "QIODevice::write (QBuffer): ReadOnly device");
+    failing.writeValue(QJsonArray());
+    QVERIFY(failing.hasError());
+}
+
+void tst_QJsonStream::writeCurrentToken()
+{
+    QJsonObject object;
+    object.insert(QLatin1String("a"), QJsonArray() << 1 << true << QJsonValue() << QLatin1String("\\"));
+    object.insert(QLatin1String(""), QJsonObject());
+    object.insert(QLatin1String("b"), QString::fromUtf8("\xc3\xa9"));
+    const QByteArray json = QJsonDocument(object).toJson(QJsonDocument::Compact) + '\n';
+
+    for (QJsonDocument::JsonFormat format : { QJsonDocument::Indented, QJsonDocument::Compact }) {
+        QJsonStreamReader reader(json + json);
+        QByteArray output;
+        QJsonStreamWriter writer(&output);
+        writer.setFormat(format);
+        while (!reader.atEnd()) {
+            reader.readNext();
+            writer.writeCurrentToken(reader);
+        }
+        QVERIFY(!reader.hasError());
+        const QByteArray expected = QJsonDocument(object).toJson(format).trimmed() + '\n';
+        QCOMPARE(output, expected + expected);
+    }
+}
+
+QTEST_MAIN(tst_QJsonStream)
+
+#include "tst_qjsonstream.moc"
@@ -2958,6 +2958,12 @@ void tst_QTextStream::double_write_with_precision_data()
     QTest::newRow("6") << 6 << 3.14159 << QString("3.14159");
     QTest::newRow("7") << 7 << 3.14159 << QString("3.14159");
     QTest::newRow("10") << 10 << 3.14159 << QString("3.14159");
+    QTest::newRow("shortest") << int(QLocale::FloatingPointShortest) << 3.14159 << QString("3.14159");
+    QTest::newRow("shortest-third") << int(QLocale::FloatingPointShortest) << 1.0 / 3
+                                    << QString("0.3333333333333333");
+    QTest::newRow("shortest-large") << int(QLocale::FloatingPointShortest) << 1e300 << QString("1e+300");
+    QTest::newRow("shortest-integral") << int(QLocale::FloatingPointShortest) << 123456789.0
+                                       << QString("123456789");
 }
 
 void tst_QTextStream::double_write_with_precision()
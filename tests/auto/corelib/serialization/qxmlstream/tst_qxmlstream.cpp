@@ -577,6 +577,8 @@ private slots:
     void invalidStringCharacters() const;
     void hasError() const;
     void readBack() const;
+    void readLargeDocument_data() const;
+    void readLargeDocument() const;
 
 private:
     static QByteArray readFile(const QString &filename);
@@ -1741,5 +1743,92 @@ void tst_QXmlStream::readBack() const
     }
 }
 
+void tst_QXmlStream::readLargeDocument_data() const
+{
+    QTest::addColumn<QByteArray>("document");
+    QTest::addColumn<QString>("expectedText");
+
+    // several times the reader's buffer size, with multi-byte characters,
+    // line breaks and whitespace-only text falling on all kinds of offsets
+    const QString word = QString::fromUtf8("caf\xc3\xa9 \xd0\xbc\xd0\xb8\xd1\x80 ");
+    QString text;
+    QString body;
+    for (int i = 0; i < 2000; ++i) {
+        const QString line = word.repeated(i % 5) + QString::number(i);
+        text += line;
+        body += QLatin1String("<item n=\"") + QString::number(i) + QLatin1String("\" note=\"")
+                + word + QLatin1String("\">") + line + QLatin1String("</item>\n  ");
+    }
+
+    QTest::newRow("utf-8") << (QByteArray("<?xml version=\"1.0\"?>\n<root>\n  ")
+                               + body.toUtf8() + "</root>\n")
+                           << text;
+
+    QString latin1Body = body;
+    latin1Body.replace(QString::fromUtf8("\xd0\xbc\xd0\xb8\xd1\x80"), QLatin1String("m\xeer"));
+    QString latin1Text = text;
+    latin1Text.replace(QString::fromUtf8("\xd0\xbc\xd0\xb8\xd1\x80"), QLatin1String("m\xeer"));
+    QTest::newRow("iso-8859-1") << (QByteArray("<?xml version=\"1.0\" encoding=\"ISO-8859-1\"?>\n<root>\n  ")
+                                    + latin1Body.toLatin1() + "</root>\n")
+                                << latin1Text;
+}
+
+void tst_QXmlStream::readLargeDocument() const
+{
+    QFETCH(QByteArray, document);
+    QFETCH(QString, expectedText);
+
+    // text may be reported in more pieces when the data arrives in pieces,
+    // so only log the elements and collect the text separately
+    const auto read = [](QXmlStreamReader &reader, QString *log, QString *text) {
+        while (!reader.atEnd()) {
+            switch (reader.readNext()) {
+            case QXmlStreamReader::StartElement:
+                *log += QString::number(reader.lineNumber()) + QLatin1Char(',')
+                        + QString::number(reader.characterOffset()) + QLatin1Char(' ');
+                for (const QXmlStreamAttribute &attribute : reader.attributes())
+                    *log += attribute.name() + QLatin1Char('=') + attribute.value() + QLatin1Char(';');
+                break;
+            case QXmlStreamReader::Characters:
+                if (!reader.isWhitespace())
+                    *text += reader.text();
+                break;
+            default:
+                break;
+            }
+        }
+    };
+
+    QString expected;
+    QString text;
+    QXmlStreamReader fromData(document);
+    read(fromData, &expected, &text);
+    QVERIFY2(!fromData.hasError(), qPrintable(fromData.errorString()));
+    QCOMPARE(text, expectedText);
+
+    QString log;
+    text.clear();
+    QBuffer buffer(&document);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QXmlStreamReader fromDevice(&buffer);
+    read(fromDevice, &log, &text);
+    QVERIFY2(!fromDevice.hasError(), qPrintable(fromDevice.errorString()));
+    QCOMPARE(log, expected);
+    QCOMPARE(text, expectedText);
+
+    // feed the data in pieces that don't line up with the reader's buffer
+    log.clear();
+    text.clear();
+    QXmlStreamReader incremental;
+    for (int i = 0; i < document.size(); i += 1000) {
+        incremental.addData(document.mid(i, 1000));
+        read(incremental, &log, &text);
+        QCOMPARE(incremental.error(), i + 1000 < document.size() ? QXmlStreamReader::PrematureEndOfDocumentError
+                                                                   : QXmlStreamReader::NoError);
+    }
+    QCOMPARE(log, expected);
+    QCOMPARE(text, expectedText);
+}
+
 #include "tst_qxmlstream.moc"
 // vim: et:ts=4:sw=4:sts=4
@@ -75,6 +75,15 @@ private slots:
     void nestedExceptions();
 #endif
     void nonGlobalThreadPool();
+    void then();
+    void thenOnThreadPool();
+    void thenOnContext();
+    void thenCancellation();
+#ifndef QT_NO_EXCEPTIONS
+    void thenExceptions();
+#endif
+    void whenAll();
+    void whenAny();
 };
 
 void tst_QFuture::resultStore()
@@ -1486,5 +1495,379 @@ void tst_QFuture::nonGlobalThreadPool()
     }
 }
 
+void tst_QFuture::then()
+{
+    // attached before the future finishes
+    {
+        QFutureInterface<int> promise;
+        promise.reportStarted();
+        QFuture<int> f = promise.future();
+
+        QFuture<QString> chained = f.then([](int value) { return QString::number(value * 2); })
+                                    .then([](const QString &s) { return s + QLatin1Char('!'); });
+        QVERIFY(chained.isRunning());
+        QVERIFY(!chained.isFinished());
+
+        promise.reportResult(21);
+        promise.reportFinished();
+        QVERIFY(chained.isFinished());
+        QCOMPARE(chained.result(), QStringLiteral("42!"));
+    }
+
+    // attached after the future finished
+    {
+        QFutureInterface<int> promise;
+        promise.reportStarted();
+        promise.reportResult(5);
+        promise.reportFinished();
+        QFuture<int> f = promise.future();
+
+        QFuture<int> chained = f.then([](int value) { return value + 1; });
+        QVERIFY(chained.isFinished());
+        QCOMPARE(chained.result(), 6);
+    }
+
+    // void futures and continuations
+    {
+        QFutureInterface<void> promise;
+        promise.reportStarted();
+        QFuture<void> f = promise.future();
+
+        int calls = 0;
+        QFuture<int> fromVoid = f.then([&calls]() { return ++calls; });
+        QFuture<void> toVoid = fromVoid.then([&calls](int) { ++calls; });
+        promise.reportFinished();
+        QVERIFY(toVoid.isFinished());
+        QCOMPARE(fromVoid.result(), 1);
+        QCOMPARE(calls, 2);
+    }
+
+    // continuations taking the future itself see all the results
+    {
+        QFutureInterface<int> promise;
+        promise.reportStarted();
+        QFuture<int> f = promise.future();
+
+        QFuture<int> sum = f.then([](const QFuture<int> &future) {
+            int sum = 0;
+            for (int value : future.results())
+                sum += value;
+            return sum;
+        });
+        promise.reportResults(QVector<int>() << 1 << 2 << 3);
+        promise.reportFinished();
+        QCOMPARE(sum.result(), 6);
+    }
+
+    // several continuations on the same future
+    {
+        QFutureInterface<int> promise;
+        promise.reportStarted();
+        QFuture<int> f = promise.future();
+
+        QFuture<int> first = f.then([](int value) { return value + 1; });
+        QFuture<int> second = f.then([](int value) { return value + 2; });
+        promise.reportResult(1);
+        promise.reportFinished();
+        QCOMPARE(first.result(), 2);
+        QCOMPARE(second.result(), 3);
+    }
+}
+
+void tst_QFuture::thenOnThreadPool()
+{
+    QThreadPool pool;
+
+    QFutureInterface<int> promise;
+    promise.reportStarted();
+    QFuture<int> f = promise.future();
+
+    QThread *continuationThread = nullptr;
+    QFuture<int> chained = f.then(&pool, [&continuationThread](int value) {
+        continuationThread = QThread::currentThread();
+        return value * 2;
+    });
+
+    promise.reportResult(21);
+    promise.reportFinished();
+    QCOMPARE(chained.result(), 42);
+    QVERIFY(continuationThread);
+    QVERIFY(continuationThread != QThread::currentThread());
+    QVERIFY(pool.waitForDone());
+
+    // a chain started on the pool does not hold a thread while it waits
+    pool.setMaxThreadCount(1);
+    QFutureInterface<int> gate;
+    gate.reportStarted();
+    QFuture<int> last = gate.future();
+    for (int i = 0; i < 10; ++i)
+        last = last.then(&pool, [](int value) { return value + 1; });
+    QCOMPARE(pool.activeThreadCount(), 0);
+    gate.reportResult(0);
+    gate.reportFinished();
+    QCOMPARE(last.result(), 10);
+}
+
+void tst_QFuture::thenOnContext()
+{
+    QFutureInterface<int> promise;
+    promise.reportStarted();
+    QFuture<int> f = promise.future();
+
+    QObject context;
+    QThread *continuationThread = nullptr;
+    QFuture<int> chained = f.then(&context, [&continuationThread](int value) {
+        continuationThread = QThread::currentThread();
+        return value + 1;
+    });
+
+    // finish the future in another thread; the continuation comes back here
+    QThreadPool pool;
+    struct Finisher : QRunnable
+    {
+        QFutureInterface<int> promise;
+        void run() override { promise.reportResult(1); promise.reportFinished(); }
+    };
+    Finisher *task = new Finisher;
+    task->promise = promise;
+    pool.start(task);
+    QVERIFY(pool.waitForDone());
+
+    QVERIFY(!chained.isFinished());
+    QTRY_VERIFY(chained.isFinished());
+    QCOMPARE(chained.result(), 2);
+    QCOMPARE(continuationThread, QThread::currentThread());
+
+    // destroying the context cancels the continuation
+    QFutureInterface<int> second;
+    second.reportStarted();
+    QObject *gone = new QObject;
+    bool called = false;
+    QFuture<void> dropped = second.future().then(gone, [&called](int) { called = true; });
+    delete gone;
+    second.reportResult(1);
+    second.reportFinished();
+    QVERIFY(dropped.isFinished());
+    QVERIFY(dropped.isCanceled());
+    QVERIFY(!called);
+}
+
+void tst_QFuture::thenCancellation()
+{
+    // a canceled future cancels its continuations without running them
+    {
+        QFutureInterface<int> promise;
+        promise.reportStarted();
+        QFuture<int> f = promise.future();
+
+        bool called = false;
+        QFuture<int> first = f.then([&called](int value) { called = true; return value; });
+        QFuture<int> second = first.then([&called](int value) { called = true; return value; });
+
+        f.cancel();
+        promise.reportFinished();
+        QVERIFY(!called);
+        QVERIFY(first.isFinished());
+        QVERIFY(first.isCanceled());
+        QVERIFY(second.isFinished());
+        QVERIFY(second.isCanceled());
+    }
+
+    // continuations taking the future are still run
+    {
+        QFutureInterface<void> promise;
+        promise.reportStarted();
+        QFuture<void> f = promise.future();
+
+        QFuture<bool> wasCanceled = f.then([](const QFuture<void> &future) {
+            return future.isCanceled();
+        });
+        promise.reportCanceled();
+        promise.reportFinished();
+        QVERIFY(!wasCanceled.isCanceled());
+        QCOMPARE(wasCanceled.result(), true);
+    }
+
+    // canceling the continuation's future skips it
+    {
+        QFutureInterface<int> promise;
+        promise.reportStarted();
+        QFuture<int> f = promise.future();
+
+        bool called = false;
+        QFuture<void> chained = f.then([&called](int) { called = true; });
+        chained.cancel();
+        promise.reportResult(1);
+        promise.reportFinished();
+        QVERIFY(!called);
+        QVERIFY(chained.isFinished());
+        QVERIFY(!f.isCanceled());
+    }
+
+    // a future that is destroyed without finishing cancels its continuation
+    {
+        QFuture<int> chained;
+        {
+            QFutureInterface<int> promise;
+            promise.reportStarted();
+            chained = promise.future().then([](int value) { return value; });
+        }
+        QVERIFY(chained.isFinished());
+        QVERIFY(chained.isCanceled());
+    }
+}
+
+#ifndef QT_NO_EXCEPTIONS
+void tst_QFuture::thenExceptions()
+{
+    // exceptions thrown by a continuation end up in its future
+    {
+        QFutureInterface<int> promise;
+        promise.reportStarted();
+        QFuture<int> f = promise.future();
+
+        QFuture<int> chained = f.then([](int) -> int { throw DerivedException(); });
+        promise.reportResult(1);
+        promise.reportFinished();
+        QVERIFY(chained.isCanceled());
+        QVERIFY_EXCEPTION_THROWN(chained.result(), DerivedException);
+    }
+
+    // exceptions propagate through continuations taking values
+    {
+        QFuture<void> f = createDerivedExceptionFuture();
+        bool called = false;
+        QFuture<int> chained = f.then([&called]() { called = true; return 0; })
+                                .then([&called](int value) { called = true; return value; });
+        QVERIFY(!called);
+        QVERIFY(chained.isFinished());
+        QVERIFY_EXCEPTION_THROWN(chained.waitForFinished(), DerivedException);
+    }
+
+    // and can be handled by a continuation taking the future
+    {
+        QFuture<void> f = createDerivedExceptionFuture();
+        QFuture<int> handled = f.then([](QFuture<void> future) {
+            try {
+                future.waitForFinished();
+            } catch (const DerivedException &) {
+                return -1;
+            }
+            return 0;
+        });
+        QCOMPARE(handled.result(), -1);
+    }
+
+    // other exceptions are reported as QUnhandledException
+    {
+        QFutureInterface<void> promise;
+        promise.reportStarted();
+        QFuture<void> chained = promise.future().then([]() { throw 42; });
+        promise.reportFinished();
+        QVERIFY_EXCEPTION_THROWN(chained.waitForFinished(), QUnhandledException);
+    }
+}
+#endif
+
+void tst_QFuture::whenAll()
+{
+    QFutureInterface<int> first;
+    QFutureInterface<int> second;
+    first.reportStarted();
+    second.reportStarted();
+
+    QList<QFuture<int> > futures;
+    futures << first.future() << second.future();
+    QFuture<QList<QFuture<int> > > all = QtFuture::whenAll(futures);
+    QVERIFY(!all.isFinished());
+
+    int sum = 0;
+    QFuture<void> summed = all.then([&sum](const QList<QFuture<int> > &finished) {
+        for (const QFuture<int> &future : finished)
+            sum += future.result();
+    });
+
+    second.reportResult(2);
+    second.reportFinished();
+    QVERIFY(!all.isFinished());
+    first.reportResult(1);
+    first.reportFinished();
+    QVERIFY(all.isFinished());
+    QVERIFY(summed.isFinished());
+    QCOMPARE(sum, 3);
+    QCOMPARE(all.result(), futures);
+
+    // canceled inputs are finished, too
+    QFutureInterface<void> canceled;
+    canceled.reportStarted();
+    QFuture<QList<QFuture<void> > > withCanceled
+            = QtFuture::whenAll(QList<QFuture<void> >() << canceled.future() << QFuture<void>());
+    QVERIFY(!withCanceled.isFinished());
+    canceled.reportCanceled();
+    canceled.reportFinished();
+    QVERIFY(withCanceled.isFinished());
+    QVERIFY(withCanceled.result().at(0).isCanceled());
+
+    QFuture<QList<QFuture<int> > > none = QtFuture::whenAll(QList<QFuture<int> >());
+    QVERIFY(none.isFinished());
+    QVERIFY(none.result().isEmpty());
+
+    // futures running on a thread pool
+    QList<QFuture<int> > running;
+    QVector<QFutureInterface<int> > promises(8);
+    for (QFutureInterface<int> &promise : promises) {
+        promise.reportStarted();
+        running << promise.future();
+    }
+    QFuture<QList<QFuture<int> > > allRunning = QtFuture::whenAll(running);
+    QThreadPool pool;
+    for (int i = 0; i < promises.size(); ++i) {
+        QFutureInterface<int> promise = promises.at(i);
+        struct Reporter : QRunnable
+        {
+            QFutureInterface<int> promise;
+            int value;
+            void run() override { promise.reportFinished(&value); }
+        };
+        Reporter *reporter = new Reporter;
+        reporter->promise = promise;
+        reporter->value = i;
+        pool.start(reporter);
+    }
+    allRunning.waitForFinished();
+    int total = 0;
+    for (const QFuture<int> &future : allRunning.result())
+        total += future.result();
+    QCOMPARE(total, 28);
+}
+
+void tst_QFuture::whenAny()
+{
+    QFutureInterface<int> first;
+    QFutureInterface<int> second;
+    first.reportStarted();
+    second.reportStarted();
+
+    QList<QFuture<int> > futures;
+    futures << first.future() << second.future();
+    QFuture<QtFuture::WhenAnyResult<int> > any = QtFuture::whenAny(futures);
+    QVERIFY(!any.isFinished());
+
+    second.reportResult(2);
+    second.reportFinished();
+    QVERIFY(any.isFinished());
+    QCOMPARE(any.result().index, 1);
+    QCOMPARE(any.result().future.result(), 2);
+
+    first.reportResult(1);
+    first.reportFinished();
+    QCOMPARE(any.result().index, 1);
+    QCOMPARE(any.resultCount(), 1);
+
+    QFuture<QtFuture::WhenAnyResult<int> > none = QtFuture::whenAny(QList<QFuture<int> >());
+    QVERIFY(none.isFinished());
+    QCOMPARE(none.result().index, -1);
+}
+
 QTEST_MAIN(tst_QFuture)
 #include "tst_qfuture.moc"
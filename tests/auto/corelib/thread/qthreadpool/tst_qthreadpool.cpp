@@ -96,6 +96,8 @@ private slots:
     void stressTest();
     void takeAllAndIncreaseMaxThreadCount();
     void waitForDoneAfterTake();
+    void workStealing();
+    void workStealingTakeAndClear();
 
 private:
     QMutex m_functionTestMutex;
@@ -1335,5 +1337,133 @@ void tst_QThreadPool::waitForDoneAfterTake()
 
 }
 
+void tst_QThreadPool::workStealing()
+{
+    class Child : public QRunnable
+    {
+    public:
+        Child(QAtomicInt *count, QMutex *mutex, QSet<QThread *> *threads)
+            : count(count), mutex(mutex), threads(threads) {}
+        void run() override
+        {
+            count->ref();
+            QMutexLocker locker(mutex);
+            threads->insert(QThread::currentThread());
+        }
+        QAtomicInt *count;
+        QMutex *mutex;
+        QSet<QThread *> *threads;
+    };
+
+    class Parent : public QRunnable
+    {
+    public:
+        Parent(QThreadPool *pool, int children, QAtomicInt *count, QMutex *mutex,
+               QSet<QThread *> *threads)
+            : pool(pool), children(children), count(count), mutex(mutex), threads(threads) {}
+        void run() override
+        {
+            for (int i = 0; i < children; ++i)
+                pool->start(new Child(count, mutex, threads));
+        }
+        QThreadPool *pool;
+        int children;
+        QAtomicInt *count;
+        QMutex *mutex;
+        QSet<QThread *> *threads;
+    };
+
+    const int parents = 4;
+    const int children = 1000;
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(4);
+    QVERIFY(!pool.isWorkStealingEnabled());
+    pool.setWorkStealingEnabled(true);
+    QVERIFY(pool.isWorkStealingEnabled());
+
+    QAtomicInt count;
+    QMutex mutex;
+    QSet<QThread *> threads;
+    for (int i = 0; i < parents; ++i)
+        pool.start(new Parent(&pool, children, &count, &mutex, &threads));
+
+    QVERIFY(pool.waitForDone(5 * 60 * 1000));
+    QCOMPARE(count.load(), parents * children);
+    // local runnables are handed to new threads while the pool is below capacity
+    QVERIFY(threads.size() > 1);
+    QVERIFY(threads.size() <= pool.maxThreadCount());
+
+    // the pool keeps working after its threads expired
+    pool.setExpiryTimeout(0);
+    QVERIFY(pool.waitForDone());
+    count.store(0);
+    pool.start(new Parent(&pool, children, &count, &mutex, &threads));
+    QVERIFY(pool.waitForDone(5 * 60 * 1000));
+    QCOMPARE(count.load(), children);
+}
+
+void tst_QThreadPool::workStealingTakeAndClear()
+{
+    class Child : public QRunnable
+    {
+    public:
+        Child(QSemaphore *started, QSemaphore *block, QAtomicInt *count)
+            : started(started), block(block), count(count) { setAutoDelete(false); }
+        void run() override
+        {
+            count->ref();
+            started->release();
+            block->acquire();
+        }
+        QSemaphore *started;
+        QSemaphore *block;
+        QAtomicInt *count;
+    };
+
+    const int threadCount = 4;
+    const int children = 10;
+
+    QSemaphore started;
+    QSemaphore block;
+    QAtomicInt count;
+    QVector<Child *> tasks;
+    for (int i = 0; i < children; ++i)
+        tasks.append(new Child(&started, &block, &count));
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threadCount);
+    pool.setWorkStealingEnabled(true);
+
+    bool taken = false;
+    bool takenAgain = true;
+
+    class Parent : public QRunnable
+    {
+    public:
+        std::function<void()> function;
+        void run() override { function(); }
+    };
+    Parent *parent = new Parent;
+    parent->function = [&] {
+        for (Child *task : qAsConst(tasks))
+            pool.start(task);
+        // the other threads each picked up one of the first children and
+        // are now blocked; the remaining ones are still in our local queue
+        started.acquire(threadCount - 1);
+        taken = pool.tryTake(tasks.last());
+        takenAgain = pool.tryTake(tasks.last());
+        pool.clear();
+        block.release(children);
+    };
+    pool.start(parent);
+
+    QVERIFY(pool.waitForDone(5 * 60 * 1000));
+    QVERIFY(taken);
+    QVERIFY(!takenAgain);
+    QCOMPARE(count.load(), threadCount - 1);
+    qDeleteAll(tasks);
+}
+
 QTEST_MAIN(tst_QThreadPool);
 #include "tst_qthreadpool.moc"
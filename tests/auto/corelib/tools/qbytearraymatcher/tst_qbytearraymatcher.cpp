@@ -43,6 +43,8 @@ class tst_QByteArrayMatcher : public QObject
 private slots:
     void interface();
     void indexIn();
+    void indexInEveryPosition_data();
+    void indexInEveryPosition();
     void staticByteArrayMatcher();
 };
 
@@ -137,6 +139,46 @@ void tst_QByteArrayMatcher::indexIn()
     QCOMPARE(matcher.indexIn(haystack, 34), -1);
 }
 
+void tst_QByteArrayMatcher::indexInEveryPosition_data()
+{
+    QTest::addColumn<QByteArray>("needle");
+
+    QTest::newRow("two") << QByteArray("xq");
+    QTest::newRow("three") << QByteArray("xyq");
+    QTest::newRow("repeated") << QByteArray("oo");
+    QTest::newRow("long") << QByteArray("jumps over the lazy cat, not the dog");
+    QTest::newRow("binary") << QByteArray("\x00\xff\x80", 3);
+}
+
+void tst_QByteArrayMatcher::indexInEveryPosition()
+{
+    QFETCH(QByteArray, needle);
+
+    // place the needle at every position of a haystack long enough to cover
+    // the vectorised loops as well as their scalar tails
+    QByteArray background;
+    while (background.size() < 100)
+        background += QByteArray("The quick brown fox jumps over the lazy dog.\x00\xff ", 47);
+    background.truncate(100);
+
+    QByteArrayMatcher matcher(needle);
+    for (int pos = 0; pos <= background.size(); ++pos) {
+        const QByteArray haystack = background.left(pos) + needle + background.mid(pos);
+        int expected = -1;
+        for (int i = 0; i <= haystack.size() - needle.size(); ++i) {
+            if (memcmp(haystack.constData() + i, needle.constData(), needle.size()) == 0) {
+                expected = i;
+                break;
+            }
+        }
+        QVERIFY(expected != -1);
+        QCOMPARE(matcher.indexIn(haystack), expected);
+        QCOMPARE(haystack.indexOf(needle), expected);
+        QCOMPARE(matcher.indexIn(haystack, expected + 1), haystack.indexOf(needle, expected + 1));
+        QCOMPARE(matcher.indexIn(haystack.constData(), haystack.size() - 1), haystack.left(haystack.size() - 1).indexOf(needle));
+    }
+}
+
 void tst_QByteArrayMatcher::staticByteArrayMatcher()
 {
     {
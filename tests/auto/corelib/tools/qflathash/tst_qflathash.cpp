@@ -0,0 +1,412 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <qflathash.h>
+#include <qhash.h>
+
+class tst_QFlatHash : public QObject
+{
+    Q_OBJECT
+private slots:
+    void empty();
+    void insert();
+    void operatorBracket();
+    void remove();
+    void take();
+    void erase();
+    void iterators();
+    void implicitSharing();
+    void detachKeepsTombstones();
+    void reserveAndSqueeze();
+    void collisions();
+    void randomOperations();
+    void complexTypes();
+    void initializerList();
+    void equality();
+};
+
+void tst_QFlatHash::empty()
+{
+    const QFlatHash<int, int> hash;
+    QVERIFY(hash.isEmpty());
+    QCOMPARE(hash.size(), 0);
+    QCOMPARE(hash.capacity(), 0);
+    QVERIFY(!hash.contains(1));
+    QCOMPARE(hash.value(1), 0);
+    QCOMPARE(hash.value(1, 42), 42);
+    QVERIFY(hash.constBegin() == hash.constEnd());
+    QVERIFY(hash.constFind(1) == hash.constEnd());
+    QVERIFY(hash.keys().isEmpty());
+
+    QFlatHash<int, int> copy = hash;
+    QVERIFY(copy.begin() == copy.end());
+    QCOMPARE(copy.capacity(), 0);
+    QCOMPARE(copy.remove(1), 0);
+    QCOMPARE(copy.take(1), 0);
+    QVERIFY(copy.isEmpty());
+    copy.clear();
+    copy.squeeze();
+    QVERIFY(copy.isEmpty());
+
+    // iterating over an empty hash doesn't detach it
+    QFlatHash<int, int> reserved;
+    reserved.reserve(10);
+    QFlatHash<int, int> shared = reserved;
+    QVERIFY(shared.begin() == shared.end());
+    QVERIFY(shared.isSharedWith(reserved));
+}
+
+void tst_QFlatHash::insert()
+{
+    QFlatHash<int, QString> hash;
+    QFlatHash<int, QString>::iterator it = hash.insert(1, QStringLiteral("one"));
+    QCOMPARE(it.key(), 1);
+    QCOMPARE(it.value(), QStringLiteral("one"));
+    QCOMPARE(hash.size(), 1);
+
+    it = hash.insert(1, QStringLiteral("uno"));
+    QCOMPARE(hash.size(), 1);
+    QCOMPARE(*it, QStringLiteral("uno"));
+    QCOMPARE(hash.value(1), QStringLiteral("uno"));
+
+    hash.insert(2, QStringLiteral("two"));
+    QCOMPARE(hash.size(), 2);
+    QVERIFY(hash.contains(2));
+    QVERIFY(!hash.contains(3));
+    QCOMPARE(hash.value(3, QStringLiteral("none")), QStringLiteral("none"));
+    QVERIFY(hash.capacity() >= hash.size());
+}
+
+void tst_QFlatHash::operatorBracket()
+{
+    QFlatHash<QString, int> hash;
+    hash[QStringLiteral("a")] = 1;
+    ++hash[QStringLiteral("a")];
+    ++hash[QStringLiteral("b")];
+    QCOMPARE(hash.size(), 2);
+    QCOMPARE(hash.value(QStringLiteral("a")), 2);
+    QCOMPARE(hash.value(QStringLiteral("b")), 1);
+
+    const QFlatHash<QString, int> &constHash = hash;
+    QCOMPARE(constHash[QStringLiteral("c")], 0);
+    QCOMPARE(hash.size(), 2);
+}
+
+void tst_QFlatHash::remove()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i * 2);
+    for (int i = 0; i < 1000; i += 2)
+        QCOMPARE(hash.remove(i), 1);
+    QCOMPARE(hash.remove(0), 0);
+    QCOMPARE(hash.size(), 500);
+    for (int i = 0; i < 1000; ++i) {
+        QCOMPARE(hash.contains(i), bool(i & 1));
+        if (i & 1)
+            QCOMPARE(hash.value(i), i * 2);
+    }
+
+    // removed slots get reused
+    for (int round = 0; round < 100; ++round) {
+        for (int i = 0; i < 1000; i += 2)
+            hash.insert(i, round);
+        for (int i = 0; i < 1000; i += 2)
+            hash.remove(i);
+    }
+    QCOMPARE(hash.size(), 500);
+    QVERIFY(hash.capacity() < 4096);
+}
+
+void tst_QFlatHash::take()
+{
+    QFlatHash<int, QString> hash;
+    hash.insert(1, QStringLiteral("one"));
+    hash.insert(2, QStringLiteral("two"));
+    QCOMPARE(hash.take(1), QStringLiteral("one"));
+    QCOMPARE(hash.take(1), QString());
+    QCOMPARE(hash.size(), 1);
+    QVERIFY(!hash.contains(1));
+    QVERIFY(hash.contains(2));
+}
+
+void tst_QFlatHash::erase()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 100; ++i)
+        hash.insert(i, i);
+
+    QFlatHash<int, int> copy = hash;
+    int visited = 0;
+    QFlatHash<int, int>::iterator it = hash.begin();
+    while (it != hash.end()) {
+        ++visited;
+        if (it.value() % 3 == 0)
+            it = hash.erase(it);
+        else
+            ++it;
+    }
+    QCOMPARE(visited, 100);
+    QCOMPARE(hash.size(), 66);
+    for (int i = 0; i < 100; ++i)
+        QCOMPARE(hash.contains(i), i % 3 != 0);
+    QCOMPARE(copy.size(), 100);
+
+    // erasing through an iterator obtained before detaching
+    QFlatHash<int, int>::const_iterator cit = copy.constFind(50);
+    QFlatHash<int, int> other = copy;
+    copy.erase(cit);
+    QVERIFY(!copy.contains(50));
+    QVERIFY(other.contains(50));
+    QCOMPARE(copy.size(), 99);
+    QCOMPARE(other.size(), 100);
+}
+
+void tst_QFlatHash::iterators()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, -i);
+
+    QSet<int> seen;
+    for (QFlatHash<int, int>::const_iterator it = hash.constBegin(); it != hash.constEnd(); ++it) {
+        QCOMPARE(it.value(), -it.key());
+        QVERIFY(!seen.contains(it.key()));
+        seen.insert(it.key());
+    }
+    QCOMPARE(seen.size(), 1000);
+
+    for (QFlatHash<int, int>::iterator it = hash.begin(); it != hash.end(); ++it)
+        *it = it.key();
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(hash.value(i), i);
+
+    int sum = 0;
+    for (int v : qAsConst(hash))
+        sum += v;
+    QCOMPARE(sum, 999 * 1000 / 2);
+
+    QList<int> keys = hash.keys();
+    std::sort(keys.begin(), keys.end());
+    QCOMPARE(keys.size(), 1000);
+    QCOMPARE(keys.first(), 0);
+    QCOMPARE(keys.last(), 999);
+    QCOMPARE(hash.values().size(), 1000);
+}
+
+void tst_QFlatHash::implicitSharing()
+{
+    QFlatHash<int, QString> hash;
+    hash.insert(1, QStringLiteral("one"));
+    QFlatHash<int, QString> copy = hash;
+    QVERIFY(copy.isSharedWith(hash));
+
+    copy.insert(2, QStringLiteral("two"));
+    QVERIFY(!copy.isSharedWith(hash));
+    QCOMPARE(hash.size(), 1);
+    QCOMPARE(copy.size(), 2);
+
+    QFlatHash<int, QString> copy2 = hash;
+    copy2[1] = QStringLiteral("uno");
+    QCOMPARE(hash.value(1), QStringLiteral("one"));
+    QCOMPARE(copy2.value(1), QStringLiteral("uno"));
+
+    QFlatHash<int, QString> moved = std::move(copy2);
+    QVERIFY(copy2.isEmpty());
+    QCOMPARE(moved.value(1), QStringLiteral("uno"));
+}
+
+void tst_QFlatHash::detachKeepsTombstones()
+{
+    // fill a table completely, so that removals leave tombstones behind
+    QFlatHash<int, int> hash;
+    hash.reserve(1000);
+    const int capacity = hash.capacity();
+    for (int i = 0; i < capacity; ++i)
+        hash.insert(i, i);
+    QCOMPARE(hash.capacity(), capacity);
+    for (int i = 0; i < capacity; i += 3)
+        hash.remove(i);
+
+    QFlatHash<int, int> copy = hash;
+    copy.insert(-1, -1);
+    for (int i = 0; i < capacity; ++i) {
+        QCOMPARE(copy.contains(i), i % 3 != 0);
+        QCOMPARE(hash.contains(i), i % 3 != 0);
+    }
+    QVERIFY(copy.contains(-1));
+    QVERIFY(!hash.contains(-1));
+}
+
+void tst_QFlatHash::reserveAndSqueeze()
+{
+    QFlatHash<int, int> hash;
+    hash.reserve(1000);
+    QVERIFY(hash.capacity() >= 1000);
+    const int capacity = hash.capacity();
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i);
+    QCOMPARE(hash.capacity(), capacity);
+
+    for (int i = 10; i < 1000; ++i)
+        hash.remove(i);
+    hash.squeeze();
+    QVERIFY(hash.capacity() < capacity);
+    QVERIFY(hash.capacity() >= 10);
+    QCOMPARE(hash.size(), 10);
+    for (int i = 0; i < 10; ++i)
+        QCOMPARE(hash.value(i), i);
+}
+
+struct BadHash
+{
+    int v;
+    bool operator==(const BadHash &other) const { return v == other.v; }
+};
+uint qHash(const BadHash &, uint seed = 0) { return seed; }
+
+void tst_QFlatHash::collisions()
+{
+    // everything lands in the same group and has the same control byte
+    QFlatHash<BadHash, int> hash;
+    for (int i = 0; i < 200; ++i)
+        hash.insert(BadHash{i}, i);
+    QCOMPARE(hash.size(), 200);
+    for (int i = 0; i < 200; ++i)
+        QCOMPARE(hash.value(BadHash{i}, -1), i);
+    QVERIFY(!hash.contains(BadHash{200}));
+    for (int i = 0; i < 200; i += 2)
+        hash.remove(BadHash{i});
+    for (int i = 0; i < 200; ++i)
+        QCOMPARE(hash.contains(BadHash{i}), bool(i & 1));
+}
+
+void tst_QFlatHash::randomOperations()
+{
+    QFlatHash<int, int> hash;
+    QHash<int, int> reference;
+    QRandomGenerator rng(1234);
+    for (int i = 0; i < 100000; ++i) {
+        const int key = rng.bounded(5000);
+        switch (rng.bounded(4)) {
+        case 0:
+        case 1:
+            hash.insert(key, i);
+            reference.insert(key, i);
+            break;
+        case 2:
+            QCOMPARE(hash.remove(key), reference.remove(key));
+            break;
+        case 3:
+            QCOMPARE(hash.value(key, -1), reference.value(key, -1));
+            break;
+        }
+        QCOMPARE(hash.size(), reference.size());
+    }
+    for (QHash<int, int>::const_iterator it = reference.constBegin(); it != reference.constEnd(); ++it)
+        QCOMPARE(hash.value(it.key(), -1), it.value());
+    int count = 0;
+    for (QFlatHash<int, int>::const_iterator it = hash.constBegin(); it != hash.constEnd(); ++it, ++count)
+        QCOMPARE(reference.value(it.key(), -1), it.value());
+    QCOMPARE(count, reference.size());
+}
+
+struct Counted
+{
+    static int instances;
+    int v;
+    Counted(int v = 0) : v(v) { ++instances; }
+    Counted(const Counted &other) : v(other.v) { ++instances; }
+    ~Counted() { --instances; }
+    Counted &operator=(const Counted &other) { v = other.v; return *this; }
+    bool operator==(const Counted &other) const { return v == other.v; }
+};
+int Counted::instances = 0;
+uint qHash(const Counted &c, uint seed = 0) { return qHash(c.v, seed); }
+
+void tst_QFlatHash::complexTypes()
+{
+    {
+        QFlatHash<Counted, Counted> hash;
+        for (int i = 0; i < 1000; ++i)
+            hash.insert(Counted(i), Counted(-i));
+        QCOMPARE(Counted::instances, 2000);
+        {
+            QFlatHash<Counted, Counted> copy = hash;
+            copy.remove(Counted(0));
+            QCOMPARE(Counted::instances, 2000 + 1998);
+            copy.take(Counted(1));
+            copy.squeeze();
+            QCOMPARE(Counted::instances, 2000 + 1996);
+        }
+        QCOMPARE(Counted::instances, 2000);
+        hash.clear();
+        QCOMPARE(Counted::instances, 0);
+    }
+    QCOMPARE(Counted::instances, 0);
+
+    QFlatHash<QString, QStringList> hash;
+    for (int i = 0; i < 100; ++i)
+        hash[QString::number(i)] << QString::number(i) << QString::number(i * i);
+    QCOMPARE(hash.value(QStringLiteral("9")), QStringList() << "9" << "81");
+}
+
+void tst_QFlatHash::initializerList()
+{
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+    QFlatHash<int, QString> hash = { { 1, QStringLiteral("one") }, { 2, QStringLiteral("two") } };
+    QCOMPARE(hash.size(), 2);
+    QCOMPARE(hash.value(1), QStringLiteral("one"));
+    QCOMPARE(hash.value(2), QStringLiteral("two"));
+#else
+    QSKIP("Compiler doesn't support initializer lists");
+#endif
+}
+
+void tst_QFlatHash::equality()
+{
+    QFlatHash<int, int> a;
+    QFlatHash<int, int> b;
+    QVERIFY(a == b);
+    for (int i = 0; i < 100; ++i)
+        a.insert(i, i);
+    for (int i = 99; i >= 0; --i)
+        b.insert(i, i);
+    QVERIFY(a == b);
+    b.insert(0, 1);
+    QVERIFY(a != b);
+    b.insert(0, 0);
+    QVERIFY(a == b);
+    b.remove(0);
+    QVERIFY(a != b);
+}
+
+QTEST_APPLESS_MAIN(tst_QFlatHash)
+#include "tst_qflathash.moc"
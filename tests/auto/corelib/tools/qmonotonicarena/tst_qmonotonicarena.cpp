@@ -0,0 +1,273 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+
+#include <qmonotonicarena.h>
+#include <qhash.h>
+#include <qmap.h>
+#include <qthread.h>
+
+class tst_QMonotonicArena : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void install();
+    void containersUseArena();
+    void largeAllocationsUseHeap();
+    void escapingData();
+    void reallocate();
+    void nested();
+    void otherThreads();
+    void manyScopes();
+};
+
+void tst_QMonotonicArena::initTestCase()
+{
+    if (!QMonotonicArena::isSupported())
+        QSKIP("Arenas are not supported on this platform");
+}
+
+void tst_QMonotonicArena::install()
+{
+    QCOMPARE(QMonotonicArena::current(), static_cast<QMonotonicArena *>(nullptr));
+    {
+        QMonotonicArena outer;
+        QCOMPARE(QMonotonicArena::current(), &outer);
+        {
+            QMonotonicArena inner;
+            QCOMPARE(QMonotonicArena::current(), &inner);
+        }
+        QCOMPARE(QMonotonicArena::current(), &outer);
+    }
+    QCOMPARE(QMonotonicArena::current(), static_cast<QMonotonicArena *>(nullptr));
+}
+
+void tst_QMonotonicArena::containersUseArena()
+{
+    QMonotonicArena arena;
+    QCOMPARE(arena.bytesAllocated(), qint64(0));
+
+    qint64 last = 0;
+    QString string(QStringLiteral("Hello")); // static data, nothing allocated
+    QCOMPARE(arena.bytesAllocated(), last);
+    string += QLatin1String(", World");
+    QVERIFY(arena.bytesAllocated() > last);
+    last = arena.bytesAllocated();
+
+    QByteArray array(100, 'a');
+    QVERIFY(arena.bytesAllocated() > last);
+    last = arena.bytesAllocated();
+
+    QVector<double> vector(10, 1.5);
+    QVERIFY(arena.bytesAllocated() > last);
+    last = arena.bytesAllocated();
+
+    QHash<int, int> hash;
+    hash.insert(1, 1);
+    QVERIFY(arena.bytesAllocated() > last);
+    last = arena.bytesAllocated();
+
+    QMap<int, QString> map;
+    map.insert(1, string);
+    QVERIFY(arena.bytesAllocated() > last);
+    last = arena.bytesAllocated();
+
+    // freeing does not make the memory available again
+    string.clear();
+    array.clear();
+    hash.clear();
+    map.clear();
+    QCOMPARE(arena.bytesAllocated(), last);
+    QByteArray again(100, 'b');
+    QVERIFY(arena.bytesAllocated() > last);
+}
+
+void tst_QMonotonicArena::largeAllocationsUseHeap()
+{
+    QMonotonicArena arena;
+    QByteArray large(1024 * 1024, 'x');
+    QCOMPARE(arena.bytesAllocated(), qint64(0));
+    large.append('y');
+    QCOMPARE(large.size(), 1024 * 1024 + 1);
+    QCOMPARE(arena.bytesAllocated(), qint64(0));
+}
+
+void tst_QMonotonicArena::escapingData()
+{
+    QString string;
+    QStringList list;
+    QHash<QString, int> hash;
+    QMap<int, QByteArray> map;
+    {
+        QMonotonicArena arena;
+        // enough data to span several blocks
+        for (int i = 0; i < 5000; ++i) {
+            const QString key = QString::number(i);
+            hash.insert(key, i);
+            map.insert(i, key.toLatin1());
+            if (i % 10 == 0)
+                list.append(key);
+        }
+        string = QString::number(42).repeated(10);
+        QVERIFY(arena.bytesAllocated() > 4 * 64 * 1024);
+    }
+
+    QCOMPARE(string, QString(QStringLiteral("42")).repeated(10));
+    QCOMPARE(list.size(), 500);
+    QCOMPARE(hash.size(), 5000);
+    QCOMPARE(map.size(), 5000);
+    for (int i = 0; i < 5000; ++i) {
+        QCOMPARE(hash.value(QString::number(i)), i);
+        QCOMPARE(map.value(i), QByteArray::number(i));
+    }
+
+    // modifying the escaped data moves it to the heap
+    string.append(QLatin1String("!!"));
+    QVERIFY(string.endsWith(QLatin1String("4242!!")));
+    for (int i = 0; i < 5000; i += 2) {
+        hash.remove(QString::number(i));
+        map[i + 1].append("+");
+    }
+    QCOMPARE(hash.size(), 2500);
+    QCOMPARE(map.value(1), QByteArray("1+"));
+    QCOMPARE(map.value(2), QByteArray("2"));
+
+    hash.clear();
+    map.clear();
+    list.clear();
+    string.clear();
+}
+
+void tst_QMonotonicArena::reallocate()
+{
+    QByteArray reference;
+    QString grownInside;
+    QByteArray grownOutside;
+    {
+        QMonotonicArena arena;
+        for (int i = 0; i < 2000; ++i) {
+            reference += QByteArray::number(i);
+            grownInside += QString::number(i);
+        }
+        grownOutside = "start";
+        grownOutside.reserve(10);
+    }
+    QCOMPARE(grownInside.toLatin1(), reference);
+
+    // reallocating arena data after the arena is gone uses the heap
+    for (int i = 0; i < 2000; ++i)
+        grownOutside += QByteArray::number(i);
+    QCOMPARE(grownOutside, "start" + reference);
+}
+
+void tst_QMonotonicArena::nested()
+{
+    QByteArray outerData;
+    QVector<int> innerData;
+    {
+        QMonotonicArena outer;
+        outerData = QByteArray(10, 'o');
+        const qint64 outerBytes = outer.bytesAllocated();
+        {
+            QMonotonicArena inner;
+            innerData.append(1);
+            QVERIFY(inner.bytesAllocated() > 0);
+            // growing data from the outer arena moves it to the inner one
+            outerData.append(QByteArray(20, 'i'));
+            QCOMPARE(outer.bytesAllocated(), outerBytes);
+        }
+        innerData.reserve(100);
+        innerData.append(2);
+        QVERIFY(outer.bytesAllocated() > outerBytes);
+    }
+    QCOMPARE(outerData, QByteArray(10, 'o') + QByteArray(20, 'i'));
+    QCOMPARE(innerData, QVector<int>() << 1 << 2);
+}
+
+class ArenaThread : public QThread
+{
+public:
+    QStringList data;
+    bool hadArena = true;
+    qint64 bytesAllocated = 0;
+
+protected:
+    void run() override
+    {
+        hadArena = QMonotonicArena::current() != nullptr;
+
+        // release data allocated from another thread's arena
+        data.clear();
+
+        QMonotonicArena arena;
+        for (int i = 0; i < 1000; ++i)
+            data.append(QString::number(i));
+        bytesAllocated = arena.bytesAllocated();
+    }
+};
+
+void tst_QMonotonicArena::otherThreads()
+{
+    ArenaThread thread;
+    {
+        QMonotonicArena arena;
+        for (int i = 0; i < 1000; ++i)
+            thread.data.append(QString::number(-i));
+
+        thread.start();
+        QVERIFY(thread.wait(30000));
+        QCOMPARE(arena.bytesAllocated() > 0, true);
+    }
+    QVERIFY(!thread.hadArena);
+    QVERIFY(thread.bytesAllocated > 0);
+    QCOMPARE(thread.data.size(), 1000);
+    QCOMPARE(thread.data.last(), QString::number(999));
+    thread.data.clear();
+}
+
+void tst_QMonotonicArena::manyScopes()
+{
+    QHash<int, QString> kept;
+    for (int scope = 0; scope < 1000; ++scope) {
+        QMonotonicArena arena;
+        QMap<QString, QString> map;
+        for (int i = 0; i < 50; ++i)
+            map.insert(QString::number(i), QString::number(scope));
+        if (scope % 100 == 0)
+            kept.insert(scope, map.value(QStringLiteral("7")));
+    }
+    QCOMPARE(kept.size(), 10);
+    for (auto it = kept.cbegin(); it != kept.cend(); ++it)
+        QCOMPARE(it.value(), QString::number(it.key()));
+}
+
+QTEST_APPLESS_MAIN(tst_QMonotonicArena)
+#include "tst_qmonotonicarena.moc"
@@ -40,6 +40,8 @@ private slots:
     void indexIn();
     void setCaseSensitivity_data();
     void setCaseSensitivity();
+    void indexInEveryPosition_data();
+    void indexInEveryPosition();
     void assignOperator();
 };
 
@@ -130,6 +132,59 @@ void tst_QStringMatcher::setCaseSensitivity()
     QCOMPARE(matcher.indexIn(haystack, from), indexIn);
 }
 
+void tst_QStringMatcher::indexInEveryPosition_data()
+{
+    QTest::addColumn<QString>("needle");
+    QTest::addColumn<QString>("filler");
+    QTest::addColumn<int>("cs");
+
+    const QString latin1Filler = QStringLiteral("The quick brown fox jumps over the lazy dog. ");
+    const QString unicodeFiller = QString::fromUtf8("Gr\xc3\xbc\xc3\x9f K\xe2\x84\xaa \xce\xb1\xce\xb2\xce\xb3 \xf0\x9f\x98\x80 ");
+
+    QTest::newRow("two") << QString("xq") << latin1Filler << int(Qt::CaseSensitive);
+    QTest::newRow("three") << QString("xyq") << latin1Filler << int(Qt::CaseSensitive);
+    QTest::newRow("repeated") << QString("oo") << latin1Filler << int(Qt::CaseSensitive);
+    QTest::newRow("long") << QString("jumps over the lazy cat, not the dog") << latin1Filler << int(Qt::CaseSensitive);
+    QTest::newRow("non-ascii") << QString::fromUtf8("\xce\xb1x\xce\xb3") << unicodeFiller << int(Qt::CaseSensitive);
+    QTest::newRow("two-ci") << QString("Xq") << latin1Filler << int(Qt::CaseInsensitive);
+    QTest::newRow("long-ci") << QString("JUMPS over THE lazy cat") << latin1Filler << int(Qt::CaseInsensitive);
+    QTest::newRow("symbols-ci") << QString("[x]") << latin1Filler << int(Qt::CaseInsensitive);
+    QTest::newRow("kelvin-ci") << QString("k ") << unicodeFiller << int(Qt::CaseInsensitive);
+    QTest::newRow("non-ascii-ci") << QString::fromUtf8("\xce\x91X\xce\x93") << unicodeFiller << int(Qt::CaseInsensitive);
+}
+
+void tst_QStringMatcher::indexInEveryPosition()
+{
+    QFETCH(QString, needle);
+    QFETCH(QString, filler);
+    QFETCH(int, cs);
+    const Qt::CaseSensitivity sensitivity = static_cast<Qt::CaseSensitivity>(cs);
+
+    // place the needle at every position of a haystack long enough to cover
+    // the vectorised loops as well as their scalar tails
+    QString background;
+    while (background.size() < 100)
+        background += filler;
+    background.truncate(100);
+
+    QStringMatcher matcher(needle, sensitivity);
+    for (int pos = 0; pos <= background.size(); ++pos) {
+        const QString haystack = background.left(pos) + needle + background.mid(pos);
+        int expected = -1;
+        for (int i = 0; i <= haystack.size() - needle.size(); ++i) {
+            if (haystack.midRef(i, needle.size()).compare(needle, sensitivity) == 0) {
+                expected = i;
+                break;
+            }
+        }
+        QVERIFY(expected != -1);
+        QCOMPARE(matcher.indexIn(haystack), expected);
+        QCOMPARE(haystack.indexOf(needle, 0, sensitivity), expected);
+        QCOMPARE(matcher.indexIn(haystack, expected + 1), haystack.indexOf(needle, expected + 1, sensitivity));
+        QCOMPARE(matcher.indexIn(haystack.constData(), haystack.size() - 1), haystack.left(haystack.size() - 1).indexOf(needle, 0, sensitivity));
+    }
+}
+
 void tst_QStringMatcher::assignOperator()
 {
     QString needle("d");
@@ -20,6 +20,7 @@ SUBDIRS=\
     qdatetime \
     qeasingcurve \
     qexplicitlyshareddatapointer \
+    qflathash \
     qfreelist \
     qhash \
     qhash_strictiterators \
@@ -34,6 +35,7 @@ SUBDIRS=\
     qmap_strictiterators \
     qmargins \
     qmessageauthenticationcode \
+    qmonotonicarena \
     qpair \
     qpoint \
     qpointf \
@@ -39,6 +39,7 @@
 #include <QtCore/QList>
 #include <QtCore/QResource>
 #include <QtCore/QLocale>
+#include <QtCore/QTemporaryDir>
 #include <QtCore/QtGlobal>
 
 #include <algorithm>
@@ -57,6 +58,9 @@ private slots:
     void rcc();
     void binary_data();
     void binary();
+    void compression_data();
+    void compression();
+    void compressionFormatVersion();
 
     void cleanupTestCase();
 
@@ -180,13 +184,13 @@ void tst_rcc::rcc()
 
 
 static void createRccBinaryData(const QString &rcc, const QString &baseDir,
-    const QString &qrcFileName, const QString &rccFileName)
+    const QString &qrcFileName, const QString &rccFileName, const QStringList &options)
 {
     QString currentDir = QDir::currentPath();
     QDir::setCurrent(baseDir);
 
     QProcess rccProcess;
-    rccProcess.start(rcc, QStringList() << "-binary" << "-o" << rccFileName << qrcFileName);
+    rccProcess.start(rcc, QStringList() << "-binary" << options << "-o" << rccFileName << qrcFileName);
     bool ok = rccProcess.waitForFinished();
     if (!ok) {
         QString errorString = QString::fromLatin1("Could not start rcc (is it in PATH?): %1").arg(rccProcess.errorString());
@@ -246,6 +250,9 @@ static QStringMap readExpectedFiles(const QString &fileName)
         relative to data/binary/ (for testing the C locale)
     - base.localeName.expected : for each localeName in the base.locale file,
         as the above .expected file
+
+    Each file is also compiled with -path-index into base.indexed.rcc, which
+    must give the same results.
 */
 
 void tst_rcc::binary_data()
@@ -265,8 +272,12 @@ void tst_rcc::binary_data()
         iter.next();
         QFileInfo qrcFileInfo = iter.fileInfo();
         QString absoluteBaseName = QFileInfo(qrcFileInfo.absolutePath(), qrcFileInfo.baseName()).absoluteFilePath();
-        QString rccFileName = absoluteBaseName + QLatin1String(".rcc");
-        createRccBinaryData(m_rcc, dataPath, qrcFileInfo.absoluteFilePath(), rccFileName);
+
+        for (bool pathIndex : { false, true }) {
+        const QString rowSuffix = pathIndex ? QLatin1String("_indexed") : QString();
+        QString rccFileName = absoluteBaseName + (pathIndex ? QLatin1String(".indexed.rcc") : QLatin1String(".rcc"));
+        createRccBinaryData(m_rcc, dataPath, qrcFileInfo.absoluteFilePath(), rccFileName,
+                            pathIndex ? QStringList(QLatin1String("-path-index")) : QStringList());
 
         QString localeFileName = absoluteBaseName + QLatin1String(".locale");
         QFile localeFile(localeFileName);
@@ -275,20 +286,21 @@ void tst_rcc::binary_data()
             foreach (const QString &locale, locales) {
                 QString expectedFileName = QString::fromLatin1("%1.%2.%3").arg(absoluteBaseName, locale, QLatin1String("expected"));
                 QStringMap expectedFiles = readExpectedFiles(expectedFileName);
-                QTest::newRow(qPrintable(qrcFileInfo.baseName() + QLatin1Char('_') + locale)) << rccFileName
-                                                                                              << QLocale(locale)
-                                                                                              << dataPath
-                                                                                              << expectedFiles;
+                QTest::newRow(qPrintable(qrcFileInfo.baseName() + QLatin1Char('_') + locale + rowSuffix)) << rccFileName
+                                                                                                          << QLocale(locale)
+                                                                                                          << dataPath
+                                                                                                          << expectedFiles;
             }
         }
 
         // always test for the C locale as well
         QString expectedFileName = absoluteBaseName + QLatin1String(".expected");
         QStringMap expectedFiles = readExpectedFiles(expectedFileName);
-        QTest::newRow(qPrintable(qrcFileInfo.baseName() + QLatin1String("_C"))) << rccFileName
-                                                                                << QLocale::c()
-                                                                                << dataPath
-                                                                                << expectedFiles;
+        QTest::newRow(qPrintable(qrcFileInfo.baseName() + QLatin1String("_C") + rowSuffix)) << rccFileName
+                                                                                            << QLocale::c()
+                                                                                            << dataPath
+                                                                                            << expectedFiles;
+        }
     }
 }
 
@@ -353,6 +365,125 @@ void tst_rcc::binary()
     QLocale::setDefault(oldDefaultLocale);
 }
 
+void tst_rcc::compression_data()
+{
+    QTest::addColumn<QString>("algorithm");
+    QTest::addColumn<int>("compression");
+
+    QTest::newRow("none") << "none" << int(QResource::NoCompression);
+    QTest::newRow("zlib") << "zlib" << int(QResource::ZlibCompression);
+    QTest::newRow("zstd") << "zstd" << int(QResource::ZstdCompression);
+}
+
+void tst_rcc::compression()
+{
+    QFETCH(QString, algorithm);
+    QFETCH(int, compression);
+
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), qPrintable(dir.errorString()));
+
+    // big enough for rcc to split it into several Zstandard frames
+    QByteArray contents;
+    for (int i = 0; contents.size() < 1024 * 1024; ++i)
+        contents += QByteArray::number(i) + '\n';
+    QFile dataFile(dir.filePath("numbers.txt"));
+    QVERIFY(dataFile.open(QIODevice::WriteOnly));
+    dataFile.write(contents);
+    dataFile.close();
+    QFile qrcFile(dir.filePath("compression.qrc"));
+    QVERIFY(qrcFile.open(QIODevice::WriteOnly));
+    qrcFile.write("<RCC><qresource><file>numbers.txt</file></qresource></RCC>\n");
+    qrcFile.close();
+
+    QProcess rccProcess;
+    rccProcess.setWorkingDirectory(dir.path());
+    rccProcess.start(m_rcc, QStringList() << "-binary" << "-threshold" << "30"
+                                          << "-compress-algo" << algorithm
+                                          << "-o" << "compression.rcc" << "compression.qrc");
+    QVERIFY2(rccProcess.waitForFinished(), qPrintable(rccProcess.errorString()));
+    const QByteArray errors = rccProcess.readAllStandardError();
+    if (errors.contains("not compiled in"))
+        QSKIP(errors.constData());
+    QVERIFY2(rccProcess.exitCode() == 0, errors.constData());
+
+    const QString rccFileName = dir.filePath("compression.rcc");
+
+    // the header has the layout of the format version it declares
+    QFile rccFile(rccFileName);
+    QVERIFY(rccFile.open(QIODevice::ReadOnly));
+    const QByteArray header = rccFile.read(24);
+    QCOMPARE(header.size(), 24);
+    const quint32 version = qFromBigEndian<quint32>(header.constData() + 4);
+    QCOMPARE(version, compression == QResource::ZstdCompression ? 3U : 2U);
+    const quint32 headerSize = version >= 3 ? 24 : 20;
+    for (int i = 8; i < 20; i += 4)
+        QVERIFY(qFromBigEndian<quint32>(header.constData() + i) >= headerSize);
+    rccFile.close();
+
+    const QString rootPrefix = QLatin1String("/test_compression/");
+    QVERIFY(QResource::registerResource(rccFileName, rootPrefix));
+
+    {
+    QResource resource(QLatin1Char(':') + rootPrefix + QLatin1String("numbers.txt"));
+    QVERIFY(resource.isValid());
+    QCOMPARE(int(resource.compressionAlgorithm()), compression);
+    QCOMPARE(resource.isCompressed(), compression != QResource::NoCompression);
+    QCOMPARE(resource.uncompressedSize(), qint64(contents.size()));
+    QCOMPARE(resource.uncompressedData(), contents);
+
+    // seeking around must not depend on what was read before, including
+    // reads that straddle two frames
+    QFile file(resource.absoluteFilePath());
+    QVERIFY(file.open(QIODevice::ReadOnly | QIODevice::Unbuffered));
+    QCOMPARE(file.size(), qint64(contents.size()));
+    const int offsets[] = { contents.size() - 10, 5, 300000, 256 * 1024 - 10, 0 };
+    for (int offset : offsets) {
+        QVERIFY(file.seek(offset));
+        QCOMPARE(file.read(20), contents.mid(offset, 20));
+    }
+    QVERIFY(file.seek(0));
+    QCOMPARE(file.readAll(), contents);
+
+    uchar *mapped = file.map(100, 1000);
+    QVERIFY(mapped);
+    QCOMPARE(QByteArray(reinterpret_cast<char *>(mapped), 1000), contents.mid(100, 1000));
+    }
+
+    QVERIFY(QResource::unregisterResource(rccFileName, rootPrefix));
+}
+
+void tst_rcc::compressionFormatVersion()
+{
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), qPrintable(dir.errorString()));
+
+    QFile dataFile(dir.filePath("data.txt"));
+    QVERIFY(dataFile.open(QIODevice::WriteOnly));
+    dataFile.write(QByteArray(4096, 'a'));
+    dataFile.close();
+    QFile qrcFile(dir.filePath("compression.qrc"));
+    QVERIFY(qrcFile.open(QIODevice::WriteOnly));
+    qrcFile.write("<RCC><qresource><file compression-algorithm=\"zstd\">data.txt</file></qresource></RCC>\n");
+    qrcFile.close();
+
+    // the version is raised for Zstandard unless one was asked for
+    QProcess rccProcess;
+    rccProcess.setWorkingDirectory(dir.path());
+    rccProcess.start(m_rcc, QStringList() << "-binary" << "-o" << "compression.rcc" << "compression.qrc");
+    QVERIFY2(rccProcess.waitForFinished(), qPrintable(rccProcess.errorString()));
+    QByteArray errors = rccProcess.readAllStandardError();
+    if (errors.contains("not compiled in"))
+        QSKIP(errors.constData());
+    QVERIFY2(rccProcess.exitCode() == 0, errors.constData());
+
+    rccProcess.start(m_rcc, QStringList() << "-binary" << "-format-version" << "2"
+                                          << "-o" << "compression.rcc" << "compression.qrc");
+    QVERIFY2(rccProcess.waitForFinished(), qPrintable(rccProcess.errorString()));
+    errors = rccProcess.readAllStandardError();
+    QVERIFY(rccProcess.exitCode() != 0);
+    QVERIFY2(errors.contains("requires format version 3"), errors.constData());
+}
 
 void tst_rcc::cleanupTestCase()
 {
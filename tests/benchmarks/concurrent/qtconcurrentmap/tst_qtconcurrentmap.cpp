@@ -0,0 +1,78 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QtConcurrent>
+#include <QtTest>
+
+class tst_QtConcurrentMap : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void mappedReduced_data();
+    void mappedReduced();
+};
+
+static qint64 square(const int &value)
+{
+    return qint64(value) * value;
+}
+
+static void sum(qint64 &result, const qint64 &value)
+{
+    result += value;
+}
+
+void tst_QtConcurrentMap::mappedReduced_data()
+{
+    QTest::addColumn<int>("options");
+
+    QTest::newRow("OrderedReduce") << int(QtConcurrent::OrderedReduce | QtConcurrent::SequentialReduce);
+    QTest::newRow("UnorderedReduce") << int(QtConcurrent::UnorderedReduce | QtConcurrent::SequentialReduce);
+    QTest::newRow("ParallelReduce") << int(QtConcurrent::ParallelReduce);
+}
+
+void tst_QtConcurrentMap::mappedReduced()
+{
+    QFETCH(int, options);
+
+    QVector<int> values(10 * 1000 * 1000);
+    for (int i = 0; i < values.size(); ++i)
+        values[i] = i % 1000;
+
+    qint64 result = 0;
+    QBENCHMARK {
+        result = QtConcurrent::blockingMappedReduced(values, square, sum,
+                                                     QtConcurrent::ReduceOptions(options));
+    }
+
+    QCOMPARE(result, qint64(10 * 1000) * (999 * 1000 * 1999 / 6));
+}
+
+QTEST_MAIN(tst_QtConcurrentMap)
+
+#include "tst_qtconcurrentmap.moc"
@@ -0,0 +1,5 @@
+TEMPLATE = app
+TARGET = tst_bench_qtconcurrentsort
+
+SOURCES += tst_qtconcurrentsort.cpp
+QT = core concurrent testlib
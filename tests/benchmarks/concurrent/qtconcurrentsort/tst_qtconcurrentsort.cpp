@@ -0,0 +1,75 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QtConcurrent>
+#include <QtTest>
+
+#include <algorithm>
+
+class tst_QtConcurrentSort : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void sort_data();
+    void sort();
+};
+
+void tst_QtConcurrentSort::sort_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<bool>("concurrent");
+
+    for (int count : {1000 * 1000, 50 * 1000 * 1000}) {
+        const QByteArray name = QByteArray::number(count / (1000 * 1000)) + "M ints, ";
+        QTest::newRow((name + "std::sort").constData()) << count << false;
+        QTest::newRow((name + "QtConcurrent::blockingSort").constData()) << count << true;
+    }
+}
+
+void tst_QtConcurrentSort::sort()
+{
+    QFETCH(int, count);
+    QFETCH(bool, concurrent);
+
+    QVector<int> values(count);
+    QRandomGenerator generator(count);
+    generator.fillRange(reinterpret_cast<quint32 *>(values.data()), values.size());
+
+    QBENCHMARK_ONCE {
+        if (concurrent)
+            QtConcurrent::blockingSort(values);
+        else
+            std::sort(values.begin(), values.end());
+    }
+
+    QVERIFY(std::is_sorted(values.constBegin(), values.constEnd()));
+}
+
+QTEST_MAIN(tst_QtConcurrentSort)
+
+#include "tst_qtconcurrentsort.moc"
@@ -0,0 +1,5 @@
+TARGET = tst_bench_qcborstream
+QT = core testlib
+CONFIG -= app_bundle
+
+SOURCES += tst_bench_qcborstream.cpp
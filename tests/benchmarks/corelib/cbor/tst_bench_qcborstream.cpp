@@ -0,0 +1,198 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/qcborstream.h>
+#include <QtCore/qdatastream.h>
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qjsonobject.h>
+#include <QtCore/qrandom.h>
+#include <QtTest>
+
+class tst_QCborStream : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void write_data();
+    void write();
+    void read_data();
+    void read();
+    void scan_data();
+    void scan();
+};
+
+enum Format { Cbor, Json, DataStream };
+Q_DECLARE_METATYPE(Format)
+
+static QJsonObject recordsDocument()
+{
+    QRandomGenerator rng(1);
+    QJsonArray records;
+    for (int i = 0; i < 2000; ++i) {
+        QJsonObject record;
+        record.insert("id", 100000 + i);
+        record.insert("name", QString("Record number %1").arg(i));
+        record.insert("active", i % 3 == 0);
+        record.insert("score", rng.generateDouble() * 1000);
+        record.insert("parent", i % 5 ? QJsonValue(i / 5) : QJsonValue());
+        record.insert("tags", QJsonArray{ "alpha", "beta", QString::number(i % 17) });
+        records.append(record);
+    }
+    return QJsonObject{ { "records", records } };
+}
+
+static QByteArray encode(Format format, const QJsonObject &object)
+{
+    QByteArray result;
+    switch (format) {
+    case Cbor: {
+        QCborStreamWriter writer(&result);
+        writer.appendJsonValue(object);
+        break;
+    }
+    case Json:
+        result = QJsonDocument(object).toJson(QJsonDocument::Compact);
+        break;
+    case DataStream: {
+        QDataStream stream(&result, QIODevice::WriteOnly);
+        stream << object.toVariantMap();
+        break;
+    }
+    }
+    return result;
+}
+
+static void addRows()
+{
+    QTest::addColumn<Format>("format");
+    QTest::addColumn<QJsonObject>("object");
+
+    const QJsonObject records = recordsDocument();
+    QTest::newRow("cbor") << Cbor << records;
+    QTest::newRow("json") << Json << records;
+    QTest::newRow("datastream") << DataStream << records;
+}
+
+void tst_QCborStream::write_data()
+{
+    addRows();
+}
+
+void tst_QCborStream::write()
+{
+    QFETCH(Format, format);
+    QFETCH(QJsonObject, object);
+
+    const QVariantMap map = object.toVariantMap();
+    QBENCHMARK {
+        QByteArray result;
+        switch (format) {
+        case Cbor: {
+            QCborStreamWriter writer(&result);
+            writer.appendJsonValue(object);
+            break;
+        }
+        case Json:
+            result = QJsonDocument(object).toJson(QJsonDocument::Compact);
+            break;
+        case DataStream: {
+            QDataStream stream(&result, QIODevice::WriteOnly);
+            stream << map;
+            break;
+        }
+        }
+    }
+}
+
+void tst_QCborStream::read_data()
+{
+    addRows();
+}
+
+void tst_QCborStream::read()
+{
+    QFETCH(Format, format);
+    QFETCH(QJsonObject, object);
+
+    const QByteArray data = encode(format, object);
+    QBENCHMARK {
+        switch (format) {
+        case Cbor: {
+            QCborStreamReader reader(data);
+            QJsonValue value = reader.readJsonValue();
+            Q_UNUSED(value);
+            break;
+        }
+        case Json: {
+            QJsonDocument doc = QJsonDocument::fromJson(data);
+            Q_UNUSED(doc);
+            break;
+        }
+        case DataStream: {
+            QDataStream stream(data);
+            QVariantMap map;
+            stream >> map;
+            break;
+        }
+        }
+    }
+}
+
+void tst_QCborStream::scan_data()
+{
+    QTest::addColumn<QByteArray>("data");
+
+    QTest::newRow("records") << encode(Cbor, recordsDocument());
+}
+
+void tst_QCborStream::scan()
+{
+    QFETCH(QByteArray, data);
+
+    // visit every item without converting anything, the way a filter would
+    QBENCHMARK {
+        QCborStreamReader reader(data.constData(), data.size());
+        int strings = 0;
+        while (reader.lastError() == QCborError::NoError) {
+            if (reader.isContainer()) {
+                reader.enterContainer();
+            } else if (!reader.hasNext() && reader.containerDepth()) {
+                reader.leaveContainer();
+            } else if (reader.isString()) {
+                strings += reader.readStringData().data.size() != 0;
+            } else {
+                reader.next();
+            }
+        }
+        QVERIFY(strings > 0);
+    }
+}
+
+QTEST_MAIN(tst_QCborStream)
+#include "tst_bench_qcborstream.moc"
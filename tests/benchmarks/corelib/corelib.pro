@@ -1,11 +1,13 @@
 TEMPLATE = subdirs
 SUBDIRS = \
+        cbor \
         io \
         json \
         mimetypes \
         kernel \
         thread \
         tools \
+        xml \
         codecs \
         plugin
 
@@ -1,10 +1,13 @@
 TEMPLATE = subdirs
 SUBDIRS = \
+        qdatastream \
         qdir \
         qdiriterator \
         qfile \
         qfileinfo \
         qiodevice \
+        qresource \
+        qsettings \
         qtemporaryfile \
         qtextstream
 
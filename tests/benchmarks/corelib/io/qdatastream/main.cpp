@@ -0,0 +1,168 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QBuffer>
+#include <QDataStream>
+#include <QVector>
+#include <qtest.h>
+
+class tst_QDataStream : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void write_data();
+    void write();
+    void read_data() { write_data(); }
+    void read();
+    void copy_data() { write_data(); }
+    void copy();
+};
+
+enum Type { Int16, Int32, Int64, Float, Double };
+Q_DECLARE_METATYPE(Type)
+Q_DECLARE_METATYPE(QDataStream::ByteOrder)
+
+static const int elementCount = 1000000;
+
+template <typename T>
+static QVector<T> makeVector()
+{
+    QVector<T> v(elementCount);
+    for (int i = 0; i < elementCount; ++i)
+        v[i] = T(i * 3 + 1);
+    return v;
+}
+
+template <typename T>
+static void writeVector(QDataStream::ByteOrder byteOrder)
+{
+    const QVector<T> v = makeVector<T>();
+    QByteArray data;
+    data.reserve(int(v.size() * sizeof(T)) + 4);
+    QBENCHMARK {
+        data.resize(0);
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::WriteOnly);
+        QDataStream stream(&buffer);
+        stream.setByteOrder(byteOrder);
+        stream.setFloatingPointPrecision(sizeof(T) == 4 ? QDataStream::SinglePrecision
+                                                        : QDataStream::DoublePrecision);
+        stream << v;
+    }
+    QCOMPARE(data.size(), int(v.size() * sizeof(T)) + 4);
+}
+
+template <typename T>
+static void readVector(QDataStream::ByteOrder byteOrder)
+{
+    const QVector<T> v = makeVector<T>();
+    QByteArray data;
+    {
+        QDataStream stream(&data, QIODevice::WriteOnly);
+        stream.setByteOrder(byteOrder);
+        stream.setFloatingPointPrecision(sizeof(T) == 4 ? QDataStream::SinglePrecision
+                                                        : QDataStream::DoublePrecision);
+        stream << v;
+    }
+
+    QVector<T> result;
+    QBENCHMARK {
+        QDataStream stream(data);
+        stream.setByteOrder(byteOrder);
+        stream.setFloatingPointPrecision(sizeof(T) == 4 ? QDataStream::SinglePrecision
+                                                        : QDataStream::DoublePrecision);
+        stream >> result;
+    }
+    QCOMPARE(result, v);
+}
+
+void tst_QDataStream::write_data()
+{
+    QTest::addColumn<Type>("type");
+    QTest::addColumn<QDataStream::ByteOrder>("byteOrder");
+
+    const QDataStream::ByteOrder native = QDataStream::ByteOrder(QSysInfo::ByteOrder);
+    const QDataStream::ByteOrder swapped = native == QDataStream::BigEndian ? QDataStream::LittleEndian
+                                                                            : QDataStream::BigEndian;
+    QTest::newRow("qint16-native") << Int16 << native;
+    QTest::newRow("qint16-swapped") << Int16 << swapped;
+    QTest::newRow("qint32-native") << Int32 << native;
+    QTest::newRow("qint32-swapped") << Int32 << swapped;
+    QTest::newRow("qint64-native") << Int64 << native;
+    QTest::newRow("qint64-swapped") << Int64 << swapped;
+    QTest::newRow("float-native") << Float << native;
+    QTest::newRow("float-swapped") << Float << swapped;
+    QTest::newRow("double-native") << Double << native;
+    QTest::newRow("double-swapped") << Double << swapped;
+}
+
+void tst_QDataStream::write()
+{
+    QFETCH(Type, type);
+    QFETCH(QDataStream::ByteOrder, byteOrder);
+
+    switch (type) {
+    case Int16: writeVector<qint16>(byteOrder); break;
+    case Int32: writeVector<qint32>(byteOrder); break;
+    case Int64: writeVector<qint64>(byteOrder); break;
+    case Float: writeVector<float>(byteOrder); break;
+    case Double: writeVector<double>(byteOrder); break;
+    }
+}
+
+void tst_QDataStream::read()
+{
+    QFETCH(Type, type);
+    QFETCH(QDataStream::ByteOrder, byteOrder);
+
+    switch (type) {
+    case Int16: readVector<qint16>(byteOrder); break;
+    case Int32: readVector<qint32>(byteOrder); break;
+    case Int64: readVector<qint64>(byteOrder); break;
+    case Float: readVector<float>(byteOrder); break;
+    case Double: readVector<double>(byteOrder); break;
+    }
+}
+
+// the lower bound for the above: copying the same amount of memory
+void tst_QDataStream::copy()
+{
+    QFETCH(Type, type);
+
+    static const int sizes[] = { 2, 4, 8, 4, 8 };
+    const QByteArray source(elementCount * sizes[type], 'x');
+    QByteArray destination(source.size(), Qt::Uninitialized);
+    QBENCHMARK {
+        memcpy(destination.data(), source.constData(), source.size());
+    }
+}
+
+QTEST_MAIN(tst_QDataStream)
+
+#include "main.moc"
@@ -52,6 +52,10 @@ private slots:
     void posix_data() { data(); }
     void diriterator();
     void diriterator_data() { data(); }
+    void diriteratorSizes();
+    void diriteratorSizes_data() { data(); }
+    void diriteratorConcurrentSizes();
+    void diriteratorConcurrentSizes_data() { data(); }
     void fsiterator();
     void fsiterator_data() { data(); }
     void data();
@@ -203,6 +207,40 @@ void tst_qdiriterator::diriterator()
     qDebug() << count;
 }
 
+static void sumSizes(const QByteArray &dirpath, QDirIterator::IteratorFlags flags)
+{
+    int count = 0;
+    qint64 total = 0;
+
+    QBENCHMARK {
+        int c = 0;
+        qint64 t = 0;
+
+        QDirIterator dir(dirpath, QDir::Files, flags);
+        while (dir.hasNext()) {
+            dir.next();
+            t += dir.fileInfo().size();
+            ++c;
+        }
+        count = c;
+        total = t;
+    }
+    qDebug() << count << total;
+}
+
+void tst_qdiriterator::diriteratorSizes()
+{
+    QFETCH(QByteArray, dirpath);
+    sumSizes(dirpath, QDirIterator::Subdirectories);
+}
+
+void tst_qdiriterator::diriteratorConcurrentSizes()
+{
+    QFETCH(QByteArray, dirpath);
+    sumSizes(dirpath, QDirIterator::Subdirectories | QDirIterator::Concurrent
+             | QDirIterator::PrefetchMetaData);
+}
+
 void tst_qdiriterator::fsiterator()
 {
     QFETCH(QByteArray, dirpath);
@@ -36,6 +36,13 @@ class tst_QProcess : public QObject
 private slots:
 
     void echoTest_performance();
+    void startLatency_data();
+    void startLatency();
+};
+
+// A subclass might reimplement setupChildProcess(), so QProcess forks for it
+class ForkedProcess : public QProcess
+{
 };
 
 void tst_QProcess::echoTest_performance()
@@ -83,5 +90,34 @@ void tst_QProcess::echoTest_performance()
     QVERIFY(process.waitForFinished());
 }
 
+void tst_QProcess::startLatency_data()
+{
+    QTest::addColumn<int>("residentMBytes");
+    QTest::addColumn<bool>("fork");
+
+    for (int mbytes : { 0, 256, 1024 }) {
+        QTest::newRow(qPrintable(QString::fromLatin1("spawn-%1MB").arg(mbytes))) << mbytes << false;
+        QTest::newRow(qPrintable(QString::fromLatin1("fork-%1MB").arg(mbytes))) << mbytes << true;
+    }
+}
+
+void tst_QProcess::startLatency()
+{
+    QFETCH(int, residentMBytes);
+    QFETCH(bool, fork);
+
+    // touch every page, so that they are all mapped in the parent
+    QByteArray resident(residentMBytes * 1024 * 1024, 'x');
+
+    QBENCHMARK {
+        QScopedPointer<QProcess> process(fork ? new ForkedProcess : new QProcess);
+        process->start("testProcessLoopback/testProcessLoopback");
+        QVERIFY2(process->waitForStarted(), qPrintable(process->errorString()));
+        process->closeWriteChannel();
+        QVERIFY(process->waitForFinished());
+    }
+    QCOMPARE(resident.count('x'), resident.size());
+}
+
 QTEST_MAIN(tst_QProcess)
 #include "tst_bench_qprocess.moc"
@@ -0,0 +1,204 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QFile>
+#include <QLibraryInfo>
+#include <QProcess>
+#include <QResource>
+#include <QTemporaryDir>
+#include <qtest.h>
+
+class tst_QResource : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void startup_data();
+    void startup();
+    void readAll_data();
+    void readAll();
+    void lookup_data();
+    void lookup();
+
+private:
+    void addRows();
+
+    QTemporaryDir dir;
+    QByteArray contents;
+    QStringList algorithms;
+    QStringList lookupRcc;
+};
+
+static const int lookupDirectories = 500;
+static const int lookupFilesPerDirectory = 100;
+
+static const char resourceRoot[] = "/bench_qresource/";
+
+void tst_QResource::initTestCase()
+{
+    QVERIFY2(dir.isValid(), qPrintable(dir.errorString()));
+
+    // 32 MB of text that compresses well
+    contents.reserve(32 * 1024 * 1024);
+    for (int i = 0; contents.size() < 32 * 1024 * 1024; ++i)
+        contents += "line " + QByteArray::number(i) + ": the quick brown fox jumps over the lazy dog\n";
+
+    QFile dataFile(dir.filePath("data.txt"));
+    QVERIFY(dataFile.open(QIODevice::WriteOnly));
+    dataFile.write(contents);
+    dataFile.close();
+    QFile qrcFile(dir.filePath("data.qrc"));
+    QVERIFY(qrcFile.open(QIODevice::WriteOnly));
+    qrcFile.write("<RCC><qresource><file>data.txt</file></qresource></RCC>\n");
+    qrcFile.close();
+
+    const QString rcc = QLibraryInfo::location(QLibraryInfo::BinariesPath) + QLatin1String("/rcc");
+    for (const char *algorithm : { "none", "zlib", "zstd" }) {
+        QProcess rccProcess;
+        rccProcess.setWorkingDirectory(dir.path());
+        rccProcess.start(rcc, QStringList() << "-binary" << "-compress-algo" << algorithm
+                                            << "-o" << QString(algorithm) + ".rcc" << "data.qrc");
+        QVERIFY2(rccProcess.waitForFinished(-1), qPrintable(rccProcess.errorString()));
+        if (rccProcess.exitCode() == 0)
+            algorithms << algorithm;
+        else
+            qWarning("rcc: %s", rccProcess.readAllStandardError().constData());
+    }
+
+    // 50000 small files, with and without the path index
+    QFile smallFile(dir.filePath("small.txt"));
+    QVERIFY(smallFile.open(QIODevice::WriteOnly));
+    smallFile.write("small\n");
+    smallFile.close();
+    QFile lookupQrcFile(dir.filePath("lookup.qrc"));
+    QVERIFY(lookupQrcFile.open(QIODevice::WriteOnly));
+    lookupQrcFile.write("<RCC><qresource>\n");
+    for (int d = 0; d < lookupDirectories; ++d) {
+        for (int f = 0; f < lookupFilesPerDirectory; ++f)
+            lookupQrcFile.write(QString::fromLatin1("<file alias=\"dir%1/file%2.txt\">small.txt</file>\n").arg(d).arg(f).toLatin1());
+    }
+    lookupQrcFile.write("</qresource></RCC>\n");
+    lookupQrcFile.close();
+    for (const char *index : { "tree", "indexed" }) {
+        QStringList arguments = QStringList() << "-binary" << "-no-compress";
+        if (qstrcmp(index, "indexed") == 0)
+            arguments << "-path-index";
+        QProcess rccProcess;
+        rccProcess.setWorkingDirectory(dir.path());
+        rccProcess.start(rcc, arguments << "-o" << QString(index) + ".rcc" << "lookup.qrc");
+        QVERIFY2(rccProcess.waitForFinished(-1), qPrintable(rccProcess.errorString()));
+        QVERIFY2(rccProcess.exitCode() == 0, rccProcess.readAllStandardError().constData());
+        lookupRcc << index;
+    }
+}
+
+void tst_QResource::addRows()
+{
+    QTest::addColumn<QString>("rccFile");
+
+    for (const QString &algorithm : qAsConst(algorithms))
+        QTest::newRow(qPrintable(algorithm)) << dir.filePath(algorithm + ".rcc");
+}
+
+void tst_QResource::startup_data()
+{
+    addRows();
+}
+
+void tst_QResource::startup()
+{
+    QFETCH(QString, rccFile);
+
+    // what an application pays to get at the first bytes of a big resource
+    QBENCHMARK {
+        QVERIFY(QResource::registerResource(rccFile, resourceRoot));
+        {
+            QFile file(QLatin1Char(':') + resourceRoot + QLatin1String("data.txt"));
+            QVERIFY(file.open(QIODevice::ReadOnly));
+            QCOMPARE(file.read(4096), contents.left(4096));
+        }
+        QVERIFY(QResource::unregisterResource(rccFile, resourceRoot));
+    }
+}
+
+void tst_QResource::readAll_data()
+{
+    addRows();
+}
+
+void tst_QResource::readAll()
+{
+    QFETCH(QString, rccFile);
+
+    QVERIFY(QResource::registerResource(rccFile, resourceRoot));
+    QBENCHMARK {
+        QFile file(QLatin1Char(':') + resourceRoot + QLatin1String("data.txt"));
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        char buffer[16384];
+        qint64 total = 0;
+        for (qint64 n; (n = file.read(buffer, sizeof(buffer))) > 0; )
+            total += n;
+        QCOMPARE(total, qint64(contents.size()));
+    }
+    QVERIFY(QResource::unregisterResource(rccFile, resourceRoot));
+}
+
+void tst_QResource::lookup_data()
+{
+    QTest::addColumn<QString>("rccFile");
+
+    for (const QString &index : qAsConst(lookupRcc))
+        QTest::newRow(qPrintable(index)) << dir.filePath(index + ".rcc");
+}
+
+void tst_QResource::lookup()
+{
+    QFETCH(QString, rccFile);
+
+    QStringList paths;
+    for (int i = 0; i < 1000; ++i) {
+        paths << QString::fromLatin1(":%1dir%2/file%3.txt").arg(QLatin1String(resourceRoot))
+                 .arg((i * 7919) % lookupDirectories).arg(i % lookupFilesPerDirectory);
+    }
+
+    QVERIFY(QResource::registerResource(rccFile, resourceRoot));
+    QBENCHMARK {
+        for (const QString &path : qAsConst(paths)) {
+            QFile file(path);
+            if (!file.open(QIODevice::ReadOnly))
+                QFAIL(qPrintable(path));
+        }
+    }
+    QVERIFY(QResource::unregisterResource(rccFile, resourceRoot));
+}
+
+QTEST_MAIN(tst_QResource)
+
+#include "main.moc"
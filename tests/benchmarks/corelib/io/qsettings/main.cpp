@@ -0,0 +1,134 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QtTest/QtTest>
+#include <QtCore/QSettings>
+#include <QtCore/QTemporaryDir>
+
+#include <private/qsettings_p.h>
+
+class tst_QSettings : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void open_data();
+    void open();
+    void sync_data();
+    void sync();
+
+private:
+    void populate(const QString &fileName, QSettings::Format format, int count);
+    QString fileName(QSettings::Format format, int count) const;
+
+    QTemporaryDir dir;
+};
+
+static QString keyName(int i)
+{
+    return QString::fromLatin1("group%1/key%2").arg(i / 100).arg(i % 100);
+}
+
+void tst_QSettings::initTestCase()
+{
+    QVERIFY2(dir.isValid(), qPrintable(dir.errorString()));
+}
+
+QString tst_QSettings::fileName(QSettings::Format format, int count) const
+{
+    return dir.filePath(QString::fromLatin1("settings%1-%2").arg(int(format)).arg(count));
+}
+
+void tst_QSettings::populate(const QString &fileName, QSettings::Format format, int count)
+{
+    if (QFile::exists(fileName))
+        return;
+    QSettings settings(fileName, format);
+    for (int i = 0; i < count; ++i)
+        settings.setValue(keyName(i), QString::fromLatin1("value of key number %1").arg(i));
+}
+
+static void addFormatRows()
+{
+    QTest::addColumn<QSettings::Format>("format");
+    QTest::addColumn<int>("count");
+
+    for (int count : {100, 10000}) {
+        QTest::addRow("ini-%d", count) << QSettings::IniFormat << count;
+        QTest::addRow("binary-%d", count) << QSettings::BinaryFormat << count;
+    }
+}
+
+void tst_QSettings::open_data()
+{
+    addFormatRows();
+}
+
+// opening the file for the first time in a process and reading a few keys
+void tst_QSettings::open()
+{
+    QFETCH(QSettings::Format, format);
+    QFETCH(int, count);
+
+    const QString path = fileName(format, count);
+    populate(path, format, count);
+
+    QBENCHMARK {
+        QConfFile::clearCache();
+        QSettings settings(path, format);
+        for (int i = 0; i < count; i += count / 10)
+            settings.value(keyName(i));
+    }
+}
+
+void tst_QSettings::sync_data()
+{
+    addFormatRows();
+}
+
+// writing one key, and picking up what another process wrote
+void tst_QSettings::sync()
+{
+    QFETCH(QSettings::Format, format);
+    QFETCH(int, count);
+
+    const QString path = fileName(format, count);
+    populate(path, format, count);
+
+    QSettings settings(path, format);
+    int i = 0;
+    QBENCHMARK {
+        settings.setValue(keyName(i % count), i);
+        settings.sync();
+        ++i;
+    }
+    QCOMPARE(settings.status(), QSettings::NoError);
+}
+
+QTEST_MAIN(tst_QSettings)
+
+#include "main.moc"
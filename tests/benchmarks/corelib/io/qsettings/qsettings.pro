@@ -0,0 +1,8 @@
+TEMPLATE = app
+TARGET = tst_bench_qsettings
+
+QT = core-private testlib
+
+CONFIG += release
+
+SOURCES += main.cpp
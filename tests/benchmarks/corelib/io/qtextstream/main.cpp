@@ -38,6 +38,10 @@ class tst_qtextstream : public QObject
 private slots:
     void writeSingleChar_data();
     void writeSingleChar();
+    void writeNumbers_data();
+    void writeNumbers();
+    void readNumbers_data();
+    void readNumbers();
 
 private:
 };
@@ -115,6 +119,84 @@ void tst_qtextstream::writeSingleChar()
     QCOMPARE(result.left(10), QString("hhhhhhhhhh"));
 }
 
+enum NumberType { IntNumber, DoubleNumber };
+Q_DECLARE_METATYPE(NumberType);
+
+void tst_qtextstream::writeNumbers_data()
+{
+    QTest::addColumn<NumberType>("type");
+    QTest::addColumn<QString>("locale");
+
+    QTest::newRow("int") << IntNumber << QString("C");
+    QTest::newRow("int_de") << IntNumber << QString("de_DE");
+    QTest::newRow("double") << DoubleNumber << QString("C");
+    QTest::newRow("double_de") << DoubleNumber << QString("de_DE");
+}
+
+void tst_qtextstream::writeNumbers()
+{
+    QFETCH(NumberType, type);
+    QFETCH(QString, locale);
+
+    // write CSV-like lines of numbers to a device
+    const int amount = 100000;
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QTextStream stream(&buffer);
+    stream.setLocale(QLocale(locale));
+    QBENCHMARK {
+        buffer.seek(0);
+        for (int i = 0; i < amount; ++i) {
+            if (type == IntNumber)
+                stream << i * 7919 - 500000 << ',';
+            else
+                stream << i * 3.25 - 1e5 << ',';
+        }
+        stream.flush();
+    }
+    QVERIFY(buffer.size() > amount);
+}
+
+void tst_qtextstream::readNumbers_data()
+{
+    writeNumbers_data();
+}
+
+void tst_qtextstream::readNumbers()
+{
+    QFETCH(NumberType, type);
+    QFETCH(QString, locale);
+
+    const int amount = 100000;
+    QByteArray data;
+    {
+        QTextStream stream(&data);
+        stream.setLocale(QLocale(locale));
+        for (int i = 0; i < amount; ++i) {
+            if (type == IntNumber)
+                stream << i * 7919 - 500000 << ' ';
+            else
+                stream << i * 3.25 - 1e5 << ' ';
+        }
+    }
+
+    QBENCHMARK {
+        QTextStream stream(data);
+        stream.setLocale(QLocale(locale));
+        int count = 0;
+        if (type == IntNumber) {
+            int value;
+            while (!(stream >> value).atEnd())
+                ++count;
+        } else {
+            double value;
+            while (!(stream >> value).atEnd())
+                ++count;
+        }
+        QCOMPARE(count, amount);
+    }
+}
+
 QTEST_MAIN(tst_qtextstream)
 
 #include "main.moc"
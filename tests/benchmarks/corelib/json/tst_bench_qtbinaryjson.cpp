@@ -27,8 +27,12 @@
 ****************************************************************************/
 
 #include <QtTest>
+#include <qjsonarray.h>
 #include <qjsondocument.h>
 #include <qjsonobject.h>
+#include <qrandom.h>
+#include <qsavefile.h>
+#include <qtemporarydir.h>
 
 class BenchmarkQtBinaryJson: public QObject
 {
@@ -45,9 +49,13 @@ private Q_SLOTS:
     void parseNumbers();
     void parseJson();
     void parseJsonToVariant();
+    void parseCorpus_data();
+    void parseCorpus();
 
     void toByteArray();
     void fromByteArray();
+    void fromBinaryFile_data();
+    void fromBinaryFile();
 
     void jsonObjectInsert();
     void variantMapInsert();
@@ -120,6 +128,117 @@ void BenchmarkQtBinaryJson::parseJsonToVariant()
     }
 }
 
+// Documents shaped like the twitter.json, canada.json and citm_catalog.json
+// files commonly used to benchmark JSON parsers
+static QByteArray twitterLikeJson()
+{
+    static const char *const words[] = {
+        "RT", "@qt", "release", "performance", "http://t.co/a1b2c3", "#cpp", "today",
+        "\xe3\x81\x93\xe3\x82\x93\xe3\x81\xab\xe3\x81\xa1\xe3\x81\xaf",
+        "caf\xc3\xa9", "\"quoted\"", "line\nbreak", "and", "the", "with"
+    };
+    QRandomGenerator rng(1);
+    QJsonArray statuses;
+    for (int i = 0; i < 1000; ++i) {
+        QString text;
+        for (int w = 0; w < 20; ++w)
+            text += QString::fromUtf8(words[rng.bounded(int(sizeof words / sizeof *words))]) + QLatin1Char(' ');
+        QJsonObject user;
+        user.insert("id", 100000 + i);
+        user.insert("name", QString("User number %1").arg(i));
+        user.insert("screen_name", QString("user_%1").arg(i));
+        user.insert("description", text.left(80));
+        user.insert("followers_count", int(rng.bounded(100000)));
+        user.insert("verified", i % 7 == 0);
+        user.insert("profile_image_url", QString("http://a0.twimg.com/profile_images/%1/normal.png").arg(i));
+        QJsonObject status;
+        status.insert("created_at", "Sun Aug 31 00:29:15 +0000 2014");
+        status.insert("id", 505874924095815700. + i);
+        status.insert("id_str", QString::number(505874924095815700LL + i));
+        status.insert("text", text);
+        status.insert("user", user);
+        status.insert("retweet_count", int(rng.bounded(1000)));
+        status.insert("favorited", false);
+        status.insert("in_reply_to_status_id", QJsonValue());
+        status.insert("entities", QJsonObject{ { "hashtags", QJsonArray{ "cpp", "qt" } },
+                                               { "urls", QJsonArray() } });
+        statuses.append(status);
+    }
+    return QJsonDocument(QJsonObject{ { "statuses", statuses } }).toJson(QJsonDocument::Indented);
+}
+
+static QByteArray canadaLikeJson()
+{
+    QRandomGenerator rng(2);
+    QByteArray json = "{\"type\":\"FeatureCollection\",\"features\":[{\"type\":\"Feature\","
+                      "\"properties\":{\"name\":\"Canada\"},\"geometry\":{\"type\":\"Polygon\","
+                      "\"coordinates\":[";
+    for (int ring = 0; ring < 50; ++ring) {
+        json += ring ? ",[" : "[";
+        for (int point = 0; point < 1000; ++point) {
+            if (point)
+                json += ',';
+            json += '[' + QByteArray::number(-140 + rng.generateDouble() * 80, 'f', 15)
+                    + ',' + QByteArray::number(42 + rng.generateDouble() * 40, 'f', 15) + ']';
+        }
+        json += ']';
+    }
+    json += "]}}]}";
+    return json;
+}
+
+static QByteArray citmLikeJson()
+{
+    QRandomGenerator rng(3);
+    QJsonObject areaNames;
+    QJsonObject events;
+    QJsonArray performances;
+    for (int i = 0; i < 2000; ++i) {
+        const QString id = QString::number(138586341 + i * 17);
+        areaNames.insert(id, QString::fromUtf8("Arri\xc3\xa8re-sc\xc3\xa8ne %1").arg(i));
+        QJsonObject event;
+        event.insert("description", QJsonValue());
+        event.insert("id", 138586341 + i * 17);
+        event.insert("logo", i % 3 ? QJsonValue() : QJsonValue(QString("/images/UE0AAAAACEKo6QAAAAZD%1").arg(i)));
+        event.insert("name", QString("30th Anniversary Tour %1").arg(i));
+        event.insert("subTopicIds", QJsonArray{ 337184269 + i, 337184283 + i });
+        event.insert("subjectCode", QJsonValue());
+        event.insert("topicIds", QJsonArray{ 324846099, 107888604 });
+        events.insert(id, event);
+        QJsonObject performance;
+        performance.insert("eventId", 138586341 + i * 17);
+        performance.insert("id", 339887544 + i);
+        performance.insert("prices", QJsonArray{ QJsonObject{ { "amount", int(rng.bounded(100000)) },
+                                                             { "audienceSubCategoryId", 337100890 },
+                                                             { "seatCategoryId", 338937295 } } });
+        performance.insert("start", 1372701600000. + i * 86400000.);
+        performance.insert("venueCode", "PLEYEL_PLEYEL");
+        performances.append(performance);
+    }
+    return QJsonDocument(QJsonObject{ { "areaNames", areaNames }, { "events", events },
+                                      { "performances", performances } }).toJson(QJsonDocument::Indented);
+}
+
+void BenchmarkQtBinaryJson::parseCorpus_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    QTest::newRow("twitter") << twitterLikeJson();
+    QTest::newRow("canada") << canadaLikeJson();
+    QTest::newRow("citm_catalog") << citmLikeJson();
+}
+
+void BenchmarkQtBinaryJson::parseCorpus()
+{
+    QFETCH(QByteArray, json);
+    QJsonParseError error;
+    QVERIFY(!QJsonDocument::fromJson(json, &error).isNull());
+
+    QBENCHMARK {
+        QJsonDocument doc = QJsonDocument::fromJson(json);
+    }
+}
+
 void BenchmarkQtBinaryJson::toByteArray()
 {
     // Example: send information over a datastream to another process
@@ -150,6 +269,37 @@ void BenchmarkQtBinaryJson::fromByteArray()
     }
 }
 
+Q_DECLARE_METATYPE(QJsonDocument::DataValidation)
+
+void BenchmarkQtBinaryJson::fromBinaryFile_data()
+{
+    QTest::addColumn<QJsonDocument::DataValidation>("validation");
+
+    QTest::newRow("validate") << QJsonDocument::Validate;
+    QTest::newRow("lazy") << QJsonDocument::ValidateLazily;
+    QTest::newRow("bypass") << QJsonDocument::BypassValidation;
+}
+
+void BenchmarkQtBinaryJson::fromBinaryFile()
+{
+    // Example: load a large cached document and look up a single entry
+    QFETCH(QJsonDocument::DataValidation, validation);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = dir.filePath("catalog.qbjs");
+    QSaveFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(QJsonDocument::fromJson(citmLikeJson()).toBinaryData());
+    QVERIFY(file.commit());
+
+    QBENCHMARK {
+        QJsonDocument doc = QJsonDocument::fromBinaryFile(fileName, validation);
+        QJsonValue name = doc.object().value("areaNames").toObject().value("138586341");
+        QVERIFY(name.isString());
+    }
+}
+
 void BenchmarkQtBinaryJson::jsonObjectInsert()
 {
     QJsonObject object;
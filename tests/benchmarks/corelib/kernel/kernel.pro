@@ -7,6 +7,10 @@ SUBDIRS = \
         qvariant \
         qcoreapplication
 
+unix: SUBDIRS += \
+    qeventdispatcher \
+    qtimerinfolist
+
 !qtHaveModule(widgets): SUBDIRS -= \
     qmetaobject \
     qobject
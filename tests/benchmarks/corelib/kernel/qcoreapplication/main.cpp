@@ -29,12 +29,63 @@
 #include <qtest.h>
 #include <qcoreapplication.h>
 
+#include <memory>
+#include <vector>
+
+class Emitter : public QObject
+{
+Q_OBJECT
+signals:
+    void ping();
+};
+
+class Receiver : public QObject
+{
+Q_OBJECT
+public:
+    int count = 0;
+    int expected = 0;
+
+public slots:
+    void pong()
+    {
+        if (++count == expected)
+            QCoreApplication::exit();
+    }
+};
+
+class EmitterThread : public QThread
+{
+public:
+    EmitterThread(Receiver *receiver, int emissions, Qt::ConnectionType type)
+        : emissions(emissions)
+    {
+        QObject::connect(&emitter, &Emitter::ping, receiver, &Receiver::pong, type);
+    }
+
+    QSemaphore go;
+
+protected:
+    void run() override
+    {
+        go.acquire();
+        for (int i = 0; i < emissions; ++i)
+            emit emitter.ping();
+    }
+
+private:
+    Emitter emitter;
+    int emissions;
+};
+
 class QCoreApplicationBenchmark : public QObject
 {
 Q_OBJECT
 private slots:
     void event_posting_benchmark_data();
     void event_posting_benchmark();
+    void queued_emission_contention_benchmark_data();
+    void queued_emission_contention_benchmark();
 };
 
 void QCoreApplicationBenchmark::event_posting_benchmark_data()
@@ -64,6 +115,55 @@ void QCoreApplicationBenchmark::event_posting_benchmark()
     }
 }
 
+void QCoreApplicationBenchmark::queued_emission_contention_benchmark_data()
+{
+    QTest::addColumn<int>("threads");
+    QTest::addColumn<bool>("batched");
+    QTest::newRow("1 thread") << 1 << false;
+    QTest::newRow("2 threads") << 2 << false;
+    QTest::newRow("4 threads") << 4 << false;
+    QTest::newRow("8 threads") << 8 << false;
+    QTest::newRow("16 threads") << 16 << false;
+    QTest::newRow("1 thread, batched") << 1 << true;
+    QTest::newRow("2 threads, batched") << 2 << true;
+    QTest::newRow("4 threads, batched") << 4 << true;
+    QTest::newRow("8 threads, batched") << 8 << true;
+    QTest::newRow("16 threads, batched") << 16 << true;
+}
+
+void QCoreApplicationBenchmark::queued_emission_contention_benchmark()
+{
+    QFETCH(int, threads);
+    QFETCH(bool, batched);
+
+    // N threads emit queued signals into the main thread as fast as they
+    // can, while it delivers them
+    const int emissions = 100000 / threads;
+    const Qt::ConnectionType type = batched
+            ? Qt::ConnectionType(Qt::QueuedConnection | Qt::BatchedConnection)
+            : Qt::QueuedConnection;
+    Receiver receiver;
+
+    QBENCHMARK {
+        std::vector<std::unique_ptr<EmitterThread>> emitters;
+        for (int i = 0; i < threads; ++i) {
+            emitters.emplace_back(new EmitterThread(&receiver, emissions, type));
+            emitters.back()->start();
+        }
+
+        receiver.count = 0;
+        receiver.expected = threads * emissions;
+        for (const auto &emitter : emitters)
+            emitter->go.release();
+        QCoreApplication::exec();
+
+        for (const auto &emitter : emitters)
+            emitter->wait();
+    }
+
+    QCOMPARE(receiver.count, threads * emissions);
+}
+
 QTEST_MAIN(QCoreApplicationBenchmark)
 
 #include "main.moc"
@@ -0,0 +1,6 @@
+QT = core-private testlib
+
+TEMPLATE = app
+TARGET = tst_bench_qeventdispatcher
+
+SOURCES += tst_qeventdispatcher.cpp
@@ -0,0 +1,162 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QSocketNotifier>
+#include <QtCore/QVector>
+#include <QtTest/QtTest>
+
+#include <private/qeventdispatcher_unix_p.h>
+#if QT_CONFIG(epoll)
+#  include <private/qeventdispatcher_epoll_p.h>
+#endif
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+class tst_QEventDispatcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void idleNotifiers_data();
+    void idleNotifiers();
+
+private:
+    rlim_t maxFds;
+};
+
+static QAbstractEventDispatcher *createDispatcher(const QByteArray &name)
+{
+#if QT_CONFIG(epoll)
+    if (name == "epoll")
+        return new QEventDispatcherEpoll;
+#endif
+    if (name == "poll")
+        return new QEventDispatcherUNIX;
+    return nullptr;
+}
+
+void tst_QEventDispatcher::initTestCase()
+{
+    // 10000 pipes need 20000 descriptors, more than the usual soft limit
+    rlimit limit;
+    QCOMPARE(getrlimit(RLIMIT_NOFILE, &limit), 0);
+    if (limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+        getrlimit(RLIMIT_NOFILE, &limit);
+    }
+    maxFds = limit.rlim_cur;
+}
+
+void tst_QEventDispatcher::idleNotifiers_data()
+{
+    QTest::addColumn<QByteArray>("dispatcher");
+    QTest::addColumn<int>("count");
+
+    QList<QByteArray> dispatchers;
+    dispatchers << "poll";
+#if QT_CONFIG(epoll)
+    dispatchers << "epoll";
+#endif
+
+    for (const QByteArray &dispatcher : qAsConst(dispatchers)) {
+        for (int count : { 100, 1000, 10000 }) {
+            QTest::newRow(QByteArray(dispatcher + '-' + QByteArray::number(count)).constData())
+                    << dispatcher << count;
+        }
+    }
+}
+
+// Registers \a count read notifiers on idle pipes, then measures one loop
+// iteration that has exactly one of them ready.
+void tst_QEventDispatcher::idleNotifiers()
+{
+    QFETCH(QByteArray, dispatcher);
+    QFETCH(int, count);
+
+    if (rlim_t(2 * count + 64) > maxFds)
+        QSKIP("Not enough file descriptors available");
+
+    QScopedPointer<QAbstractEventDispatcher> eventDispatcher(createDispatcher(dispatcher));
+    QVERIFY(eventDispatcher);
+
+    QVector<int> readFds;
+    QVector<int> writeFds;
+    QVector<QSocketNotifier *> notifiers;
+    readFds.reserve(count);
+    writeFds.reserve(count);
+    notifiers.reserve(count);
+
+    int activations = 0;
+    for (int i = 0; i < count; ++i) {
+        int fds[2];
+        QCOMPARE(::pipe(fds), 0);
+        ::fcntl(fds[0], F_SETFL, O_NONBLOCK);
+        readFds << fds[0];
+        writeFds << fds[1];
+
+        // the notifier enables itself on the thread's dispatcher; move it
+        // over to the one being measured
+        QSocketNotifier *notifier = new QSocketNotifier(fds[0], QSocketNotifier::Read);
+        notifier->setEnabled(false);
+        eventDispatcher->registerSocketNotifier(notifier);
+        connect(notifier, &QSocketNotifier::activated, [&activations](int fd) {
+            char c;
+            while (::read(fd, &c, 1) == 1)
+                ++activations;
+        });
+        notifiers << notifier;
+    }
+
+    int i = 0;
+    QBENCHMARK {
+        const char c = 0;
+        QCOMPARE(::write(writeFds.at(i), &c, 1), ssize_t(1));
+        eventDispatcher->processEvents(QEventLoop::AllEvents);
+        i = (i + 1) % count;
+    }
+    QVERIFY(activations > 0);
+
+    for (QSocketNotifier *notifier : qAsConst(notifiers)) {
+        eventDispatcher->unregisterSocketNotifier(notifier);
+        delete notifier;
+    }
+    for (int fd : qAsConst(readFds))
+        ::close(fd);
+    for (int fd : qAsConst(writeFds))
+        ::close(fd);
+}
+
+QTEST_MAIN(tst_QEventDispatcher)
+
+#include "tst_qeventdispatcher.moc"
@@ -0,0 +1,5 @@
+QT = core-private testlib
+
+TEMPLATE = app
+TARGET = tst_bench_qtimerinfolist
+SOURCES += tst_qtimerinfolist.cpp
@@ -0,0 +1,155 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QObject>
+#include <QtCore/QVector>
+#include <QtTest/QtTest>
+
+#include <private/qtimerinfo_unix_p.h>
+
+class TimerCounter : public QObject
+{
+public:
+    int count = 0;
+
+protected:
+    void timerEvent(QTimerEvent *) override { ++count; }
+};
+
+class tst_QTimerInfoList : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void registerUnregister_data();
+    void registerUnregister();
+    void restartTimeouts_data();
+    void restartTimeouts();
+    void activateBatch_data();
+    void activateBatch();
+};
+
+static void addRows()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("10000") << 10000;
+    QTest::newRow("100000") << 100000;
+}
+
+// idle timeouts of a few seconds to a few minutes, like a server would use
+static int idleTimeout(int i)
+{
+    return 5000 + (i * 7919) % 120000;
+}
+
+void tst_QTimerInfoList::registerUnregister_data()
+{
+    addRows();
+}
+
+void tst_QTimerInfoList::registerUnregister()
+{
+    QFETCH(int, count);
+
+    QObject object;
+    QTimerInfoList list;
+
+    QBENCHMARK {
+        for (int i = 0; i < count; ++i)
+            list.registerTimer(i + 1, idleTimeout(i), Qt::CoarseTimer, &object);
+        for (int i = 0; i < count; ++i)
+            list.unregisterTimer(i + 1);
+    }
+
+    QVERIFY(list.isEmpty());
+}
+
+void tst_QTimerInfoList::restartTimeouts_data()
+{
+    addRows();
+}
+
+void tst_QTimerInfoList::restartTimeouts()
+{
+    // every connection restarts its idle timer when traffic arrives
+    QFETCH(int, count);
+
+    QVector<QObject *> objects;
+    objects.reserve(count);
+    QTimerInfoList list;
+    for (int i = 0; i < count; ++i) {
+        objects << new QObject;
+        list.registerTimer(i + 1, idleTimeout(i), Qt::CoarseTimer, objects.at(i));
+    }
+
+    int round = 0;
+    QBENCHMARK {
+        for (int i = 0; i < count; ++i) {
+            list.unregisterTimer(i + 1);
+            list.registerTimer(i + 1, idleTimeout(i + round), Qt::CoarseTimer, objects.at(i));
+        }
+        ++round;
+    }
+
+    QCOMPARE(list.size(), count);
+    qDeleteAll(objects);
+}
+
+void tst_QTimerInfoList::activateBatch_data()
+{
+    addRows();
+}
+
+void tst_QTimerInfoList::activateBatch()
+{
+    // a batch of zero timers expires on every pass, while the
+    // long-running ones must not get in the way
+    QFETCH(int, count);
+
+    TimerCounter counter;
+    QObject idle;
+    QTimerInfoList list;
+    const int active = 100;
+    for (int i = 0; i < count; ++i)
+        list.registerTimer(i + 1, idleTimeout(i), Qt::CoarseTimer, &idle);
+    for (int i = 0; i < active; ++i)
+        list.registerTimer(count + i + 1, 0, Qt::PreciseTimer, &counter);
+
+    QBENCHMARK {
+        list.activateTimers();
+    }
+
+    QVERIFY(counter.count >= active);
+    QCOMPARE(counter.count % active, 0);
+}
+
+QTEST_MAIN(tst_QTimerInfoList)
+
+#include "tst_qtimerinfolist.moc"
@@ -28,15 +28,42 @@
 
 #include <QtTest/QtTest>
 
+Q_DECLARE_METATYPE(QMimeDatabase::MatchMode)
+
 class tst_QMimeDatabase: public QObject
 {
 
     Q_OBJECT
 
 private slots:
+    void initTestCase();
     void inheritsPerformance();
+    void mimeTypeForFile_data();
+    void mimeTypeForFile();
+    void mimeTypesForFiles_data();
+    void mimeTypesForFiles();
+
+private:
+    QTemporaryDir m_dir;
+    QStringList m_files;
 };
 
+void tst_QMimeDatabase::initTestCase()
+{
+    // A corpus of small files with a mix of known suffixes, unknown suffixes and no suffix
+    QVERIFY(m_dir.isValid());
+    static const char *const suffixes[] = { ".txt", ".cpp", ".png", ".pdf", ".tar.gz", "", ".dat", ".xml" };
+    static const char *const contents[] = { "hello world\n", "%PDF-1.4\n", "\x89PNG\r\n\x1a\n", "<?xml version=\"1.0\"?>\n" };
+    for (int i = 0; i < 2000; ++i) {
+        const QString fileName = m_dir.path() + QLatin1String("/file") + QString::number(i)
+                + QLatin1String(suffixes[i % 8]);
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(contents[i % 4]);
+        m_files.append(fileName);
+    }
+}
+
 void tst_QMimeDatabase::inheritsPerformance()
 {
     // Check performance of inherits().
@@ -70,5 +97,38 @@ void tst_QMimeDatabase::inheritsPerformance()
     // parsing XML, and then keeps being around 4.5 MB for all the in-memory hashes.
 }
 
+void tst_QMimeDatabase::mimeTypeForFile_data()
+{
+    QTest::addColumn<QMimeDatabase::MatchMode>("mode");
+    QTest::newRow("default") << QMimeDatabase::MatchDefault;
+    QTest::newRow("extension") << QMimeDatabase::MatchExtension;
+    QTest::newRow("content") << QMimeDatabase::MatchContent;
+}
+
+void tst_QMimeDatabase::mimeTypeForFile()
+{
+    QFETCH(QMimeDatabase::MatchMode, mode);
+    QMimeDatabase db;
+    QBENCHMARK {
+        for (const QString &fileName : qAsConst(m_files))
+            db.mimeTypeForFile(fileName, mode);
+    }
+}
+
+void tst_QMimeDatabase::mimeTypesForFiles_data()
+{
+    mimeTypeForFile_data();
+}
+
+void tst_QMimeDatabase::mimeTypesForFiles()
+{
+    QFETCH(QMimeDatabase::MatchMode, mode);
+    QMimeDatabase db;
+    QBENCHMARK {
+        const QList<QMimeType> types = db.mimeTypesForFiles(m_files, mode);
+        QCOMPARE(types.size(), m_files.size());
+    }
+}
+
 QTEST_MAIN(tst_QMimeDatabase)
 #include "main.moc"
@@ -40,6 +40,8 @@ public:
 private slots:
     void startRunnables();
     void activeThreadCount();
+    void startNestedRunnables_data();
+    void startNestedRunnables();
 };
 
 tst_QThreadPool::tst_QThreadPool()
@@ -75,5 +77,48 @@ void tst_QThreadPool::activeThreadCount()
     }
 }
 
+class SpawnerRunnable : public QRunnable
+{
+public:
+    SpawnerRunnable(QThreadPool *pool, int count) : pool(pool), count(count) {}
+    void run() override {
+        for (int i = 0; i < count; ++i)
+            pool->start(new NoOpRunnable());
+    }
+private:
+    QThreadPool *pool;
+    int count;
+};
+
+void tst_QThreadPool::startNestedRunnables_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<bool>("workStealing");
+
+    for (int threadCount : {1, 2, 4, 8, 16, 32}) {
+        const QByteArray name = QByteArray::number(threadCount) + " threads";
+        QTest::newRow((name + ", global queue").constData()) << threadCount << false;
+        QTest::newRow((name + ", work stealing").constData()) << threadCount << true;
+    }
+}
+
+void tst_QThreadPool::startNestedRunnables()
+{
+    QFETCH(int, threadCount);
+    QFETCH(bool, workStealing);
+
+    // 10 million trivial runnables, started from runnables already inside the pool
+    const int total = 10 * 1000 * 1000;
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(threadCount);
+    threadPool.setWorkStealingEnabled(workStealing);
+    QBENCHMARK_ONCE {
+        for (int i = 0; i < threadCount; ++i)
+            threadPool.start(new SpawnerRunnable(&threadPool, total / threadCount));
+        threadPool.waitForDone();
+    }
+}
+
 QTEST_MAIN(tst_QThreadPool)
 #include "tst_qthreadpool.moc"
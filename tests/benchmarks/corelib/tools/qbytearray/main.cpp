@@ -30,6 +30,7 @@
 #include <QIODevice>
 #include <QFile>
 #include <QString>
+#include <QByteArrayMatcher>
 
 #include <qtest.h>
 
@@ -48,6 +49,11 @@ private slots:
     void latin1Uppercasing_xlate_checked();
     void latin1Uppercasing_category();
     void latin1Uppercasing_bitcheck();
+
+    void indexOf_data();
+    void indexOf();
+    void byteArrayMatcher_data() { indexOf_data(); }
+    void byteArrayMatcher();
 };
 
 void tst_qbytearray::initTestCase()
@@ -259,6 +265,71 @@ void tst_qbytearray::latin1Uppercasing_bitcheck()
 }
 
 
+// Log-like text, which is what large haystacks tend to be
+static QByteArray logText(int size)
+{
+    static QByteArray cache;
+    if (cache.size() != size) {
+        QByteArray block;
+        for (int i = 0; block.size() < 64 * 1024; ++i) {
+            block += QString::fromLatin1("2018-05-%1 12:%2:%3 [info] qt.network: connection %4 from 10.0.%5.%6 established\n")
+                    .arg(i % 28 + 1).arg(i % 60).arg((i * 7) % 60).arg(i).arg(i % 256).arg((i * 13) % 256).toLatin1();
+        }
+        cache = block.repeated(size / block.size() + 1);
+        cache.truncate(size);
+    }
+    return cache;
+}
+
+void tst_qbytearray::indexOf_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::addColumn<QByteArray>("needle");
+
+    // the needles don't occur, so every search scans the whole haystack
+    const struct {
+        const char *name;
+        int size;
+    } sizes[] = {
+        { "1KB", 1024 },
+        { "64KB", 64 * 1024 },
+        { "1MB", 1024 * 1024 },
+        { "100MB", 100 * 1024 * 1024 }
+    };
+    const char *needles[] = { "xz", "failed", "connection 123 refused by peer" };
+    for (const auto &size : sizes) {
+        for (const char *needle : needles)
+            QTest::addRow("%s-%d", size.name, int(qstrlen(needle))) << size.size << QByteArray(needle);
+    }
+}
+
+void tst_qbytearray::indexOf()
+{
+    QFETCH(int, size);
+    QFETCH(QByteArray, needle);
+
+    const QByteArray haystack = logText(size);
+    int result = 0;
+    QBENCHMARK {
+        result = haystack.indexOf(needle);
+    }
+    QCOMPARE(result, -1);
+}
+
+void tst_qbytearray::byteArrayMatcher()
+{
+    QFETCH(int, size);
+    QFETCH(QByteArray, needle);
+
+    const QByteArray haystack = logText(size);
+    const QByteArrayMatcher matcher(needle);
+    int result = 0;
+    QBENCHMARK {
+        result = matcher.indexIn(haystack);
+    }
+    QCOMPARE(result, -1);
+}
+
 QTEST_MAIN(tst_qbytearray)
 
 #include "main.moc"
@@ -0,0 +1,230 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QFlatHash>
+#include <QHash>
+#include <QRandomGenerator>
+#include <QSet>
+#include <QTest>
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+class tst_QFlatHash : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void memory_QHash_data() { data(); }
+    void memory_QHash() { memory<QHash<int, int> >(); }
+    void memory_QFlatHash_data() { data(); }
+    void memory_QFlatHash() { memory<QFlatHash<int, int> >(); }
+    void memory_unordered_map_data() { data(); }
+    void memory_unordered_map() { memory<std::unordered_map<int, int> >(); }
+
+    void insert_QHash_data() { data(); }
+    void insert_QHash() { insert<QHash<int, int> >(); }
+    void insert_QFlatHash_data() { data(); }
+    void insert_QFlatHash() { insert<QFlatHash<int, int> >(); }
+    void insert_unordered_map_data() { data(); }
+    void insert_unordered_map() { insert<std::unordered_map<int, int> >(); }
+
+    void lookup_QHash_data() { data(); }
+    void lookup_QHash() { lookup<QHash<int, int> >(); }
+    void lookup_QFlatHash_data() { data(); }
+    void lookup_QFlatHash() { lookup<QFlatHash<int, int> >(); }
+    void lookup_unordered_map_data() { data(); }
+    void lookup_unordered_map() { lookup<std::unordered_map<int, int> >(); }
+
+    void lookupString_QHash_data() { data(); }
+    void lookupString_QHash() { lookup<QHash<QString, int> >(); }
+    void lookupString_QFlatHash_data() { data(); }
+    void lookupString_QFlatHash() { lookup<QFlatHash<QString, int> >(); }
+    void lookupString_unordered_map_data() { data(); }
+    void lookupString_unordered_map() { lookup<std::unordered_map<QString, int> >(); }
+
+    void iterate_QHash_data() { data(); }
+    void iterate_QHash() { iterate<QHash<int, int> >(); }
+    void iterate_QFlatHash_data() { data(); }
+    void iterate_QFlatHash() { iterate<QFlatHash<int, int> >(); }
+    void iterate_unordered_map_data() { data(); }
+    void iterate_unordered_map() { iterate<std::unordered_map<int, int> >(); }
+
+private:
+    void data();
+    template <typename Container> void memory();
+    template <typename Container> void insert();
+    template <typename Container> void lookup();
+    template <typename Container> void iterate();
+};
+
+// use Qt's hashing for std::unordered_map too, so that only the tables are compared
+namespace std {
+template <> struct hash<QString>
+{
+    size_t operator()(const QString &s) const Q_DECL_NOTHROW { return qHash(s); }
+};
+}
+
+template <typename Key> Key makeKey(quint32 n);
+template <> int makeKey<int>(quint32 n) { return int(n); }
+template <> QString makeKey<QString>(quint32 n) { return QString::number(n, 16); }
+
+// distinct keys, in random order
+template <typename Key>
+static std::vector<Key> randomKeys(int count)
+{
+    QRandomGenerator rng(42);
+    QSet<quint32> seen;
+    seen.reserve(count);
+    std::vector<Key> keys;
+    keys.reserve(count);
+    while (int(keys.size()) < count) {
+        const quint32 n = rng.generate();
+        if (!seen.contains(n)) {
+            seen.insert(n);
+            keys.push_back(makeKey<Key>(n));
+        }
+    }
+    return keys;
+}
+
+template <typename Key> static void insertInto(QHash<Key, int> &c, const Key &k, int v) { c.insert(k, v); }
+template <typename Key> static void insertInto(QFlatHash<Key, int> &c, const Key &k, int v) { c.insert(k, v); }
+template <typename Key> static void insertInto(std::unordered_map<Key, int> &c, const Key &k, int v) { c[k] = v; }
+
+template <typename Key> static int lookupIn(const QHash<Key, int> &c, const Key &k) { return c.value(k); }
+template <typename Key> static int lookupIn(const QFlatHash<Key, int> &c, const Key &k) { return c.value(k); }
+template <typename Key> static int lookupIn(const std::unordered_map<Key, int> &c, const Key &k)
+{
+    const auto it = c.find(k);
+    return it == c.end() ? 0 : it->second;
+}
+
+static int valueOf(int v) { return v; }
+static int valueOf(const std::pair<const int, int> &p) { return p.second; }
+
+template <typename Container>
+static Container filled(const std::vector<typename Container::key_type> &keys)
+{
+    Container c;
+    int i = 0;
+    for (const auto &key : keys)
+        insertInto(c, key, i++);
+    return c;
+}
+
+static qint64 heapInUse()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    // large blocks are mmap()ed and not counted in uordblks
+    const struct mallinfo2 info = mallinfo2();
+    return qint64(info.uordblks) + qint64(info.hblkhd);
+#elif defined(__GLIBC__)
+    const struct mallinfo info = mallinfo();
+    return qint64(uint(info.uordblks)) + qint64(uint(info.hblkhd));
+#else
+    return -1;
+#endif
+}
+
+void tst_QFlatHash::data()
+{
+    QTest::addColumn<int>("size");
+
+    QTest::newRow("1K") << 1000;
+    QTest::newRow("100K") << 100 * 1000;
+    QTest::newRow("10M") << 10 * 1000 * 1000;
+}
+
+template <typename Container>
+void tst_QFlatHash::memory()
+{
+    QFETCH(int, size);
+    const auto keys = randomKeys<typename Container::key_type>(size);
+
+    const qint64 before = heapInUse();
+    if (before < 0)
+        QSKIP("Can't measure the heap usage on this platform");
+    const Container c = filled<Container>(keys);
+    const qint64 after = heapInUse();
+    QTest::setBenchmarkResult(qreal(after - before) / size, QTest::BytesAllocated);
+    QCOMPARE(int(c.size()), size);
+}
+
+template <typename Container>
+void tst_QFlatHash::insert()
+{
+    QFETCH(int, size);
+    const auto keys = randomKeys<typename Container::key_type>(size);
+
+    QBENCHMARK {
+        const Container c = filled<Container>(keys);
+        Q_UNUSED(c);
+    }
+}
+
+template <typename Container>
+void tst_QFlatHash::lookup()
+{
+    QFETCH(int, size);
+    auto keys = randomKeys<typename Container::key_type>(size);
+    const Container c = filled<Container>(keys);
+    // QHash allocates its nodes in insertion order, so don't look them up in that order
+    std::shuffle(keys.begin(), keys.end(), QRandomGenerator(7));
+
+    qint64 sum = 0;
+    QBENCHMARK {
+        for (const auto &key : keys)
+            sum += lookupIn(c, key);
+    }
+    QVERIFY(sum != 0);
+}
+
+template <typename Container>
+void tst_QFlatHash::iterate()
+{
+    QFETCH(int, size);
+    const Container c = filled<Container>(randomKeys<typename Container::key_type>(size));
+
+    qint64 sum = 0;
+    QBENCHMARK {
+        for (const auto &v : c)
+            sum += valueOf(v);
+    }
+    QVERIFY(sum != 0);
+}
+
+QTEST_MAIN(tst_QFlatHash)
+
+#include "main.moc"
@@ -0,0 +1,120 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMonotonicArena>
+#include <QScopedPointer>
+#include <QTest>
+#include <QVariant>
+
+class tst_QMonotonicArena : public QObject
+{
+    Q_OBJECT
+private slots:
+    void parseAndDiscard_data();
+    void parseAndDiscard();
+};
+
+// A request made of records that look like those of a typical REST API
+static QByteArray makeRequest(int records)
+{
+    static const char *const tags[] = { "red", "green", "blue", "urgent", "archived", "shared" };
+    QJsonArray array;
+    for (int i = 0; i < records; ++i) {
+        QJsonObject record;
+        record.insert(QStringLiteral("id"), i);
+        record.insert(QStringLiteral("name"), QStringLiteral("Record number %1").arg(i));
+        record.insert(QStringLiteral("email"), QStringLiteral("user%1@example.com").arg(i));
+        record.insert(QStringLiteral("score"), i * 0.25);
+        record.insert(QStringLiteral("active"), i % 3 != 0);
+        QJsonArray recordTags;
+        for (int j = 0; j < 1 + i % 4; ++j)
+            recordTags.append(QLatin1String(tags[(i + j) % 6]));
+        record.insert(QStringLiteral("tags"), recordTags);
+        QJsonObject address;
+        address.insert(QStringLiteral("street"), QStringLiteral("%1 Main Street").arg(i));
+        address.insert(QStringLiteral("city"), QStringLiteral("Oslo"));
+        record.insert(QStringLiteral("address"), address);
+        array.append(record);
+    }
+    return QJsonDocument(array).toJson(QJsonDocument::Compact);
+}
+
+// Parses the request, looks at every record, and throws everything away
+static int processRequest(const QByteArray &json)
+{
+    const QVariantList records = QJsonDocument::fromJson(json).array().toVariantList();
+    QHash<QString, int> tagCounts;
+    int result = 0;
+    for (const QVariant &value : records) {
+        const QVariantMap record = value.toMap();
+        result += record.value(QStringLiteral("name")).toString().size();
+        result += record.value(QStringLiteral("address")).toMap().value(QStringLiteral("city")).toString().size();
+        const QVariantList tags = record.value(QStringLiteral("tags")).toList();
+        for (const QVariant &tag : tags)
+            ++tagCounts[tag.toString()];
+    }
+    return result + tagCounts.size();
+}
+
+void tst_QMonotonicArena::parseAndDiscard_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<bool>("useArena");
+
+    for (int records : { 10, 100, 1000 }) {
+        const QByteArray json = makeRequest(records);
+        const QByteArray size = QByteArray::number(records) + " records ("
+                + QByteArray::number(json.size() / 1024) + "KB)";
+        QTest::newRow(("heap, " + size).constData()) << json << false;
+        QTest::newRow(("arena, " + size).constData()) << json << true;
+    }
+}
+
+void tst_QMonotonicArena::parseAndDiscard()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(bool, useArena);
+
+    if (useArena && !QMonotonicArena::isSupported())
+        QSKIP("Arenas are not supported on this platform");
+
+    int result = 0;
+    QBENCHMARK {
+        QScopedPointer<QMonotonicArena> arena(useArena ? new QMonotonicArena : nullptr);
+        result += processRequest(json);
+    }
+    QVERIFY(result > 0);
+}
+
+QTEST_MAIN(tst_QMonotonicArena)
+
+#include "main.moc"
@@ -49,6 +49,16 @@ private slots:
     void toCaseFolded_data();
     void toCaseFolded();
 
+    void indexOf_data();
+    void indexOf();
+    void stringMatcher_data() { indexOf_data(); }
+    void stringMatcher();
+
+    void fromUtf8_data();
+    void fromUtf8();
+    void toUtf8_data() { fromUtf8_data(); }
+    void toUtf8();
+
 private:
     void section_data_impl(bool includeRegExOnly = true);
     template <typename RX> void section_impl();
@@ -188,6 +198,134 @@ void tst_QString::toCaseFolded()
     }
 }
 
+// Log-like text, which is what large haystacks tend to be
+static QString logText(int size)
+{
+    static QString cache;
+    if (cache.size() != size) {
+        QString block;
+        for (int i = 0; block.size() < 64 * 1024; ++i) {
+            block += QString::fromLatin1("2018-05-%1 12:%2:%3 [info] qt.network: connection %4 from 10.0.%5.%6 established\n")
+                    .arg(i % 28 + 1).arg(i % 60).arg((i * 7) % 60).arg(i).arg(i % 256).arg((i * 13) % 256);
+        }
+        cache = block.repeated(size / block.size() + 1);
+        cache.truncate(size);
+    }
+    return cache;
+}
+
+void tst_QString::indexOf_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::addColumn<QString>("needle");
+    QTest::addColumn<Qt::CaseSensitivity>("cs");
+
+    // the needles don't occur, so every search scans the whole haystack
+    const struct {
+        const char *name;
+        int size;
+    } sizes[] = {
+        { "1KB", 1024 / 2 },
+        { "64KB", 64 * 1024 / 2 },
+        { "1MB", 1024 * 1024 / 2 },
+        { "100MB", 100 * 1024 * 1024 / 2 }
+    };
+    const char *needles[] = { "xz", "failed", "connection 123 refused by peer" };
+    for (const auto &size : sizes) {
+        for (const char *needle : needles) {
+            QTest::addRow("%s-%d-cs", size.name, int(qstrlen(needle)))
+                    << size.size << QString::fromLatin1(needle) << Qt::CaseSensitive;
+            QTest::addRow("%s-%d-ci", size.name, int(qstrlen(needle)))
+                    << size.size << QString::fromLatin1(needle) << Qt::CaseInsensitive;
+        }
+    }
+}
+
+void tst_QString::indexOf()
+{
+    QFETCH(int, size);
+    QFETCH(QString, needle);
+    QFETCH(Qt::CaseSensitivity, cs);
+
+    const QString haystack = logText(size);
+    int result = 0;
+    QBENCHMARK {
+        result = haystack.indexOf(needle, 0, cs);
+    }
+    QCOMPARE(result, -1);
+}
+
+void tst_QString::stringMatcher()
+{
+    QFETCH(int, size);
+    QFETCH(QString, needle);
+    QFETCH(Qt::CaseSensitivity, cs);
+
+    const QString haystack = logText(size);
+    const QStringMatcher matcher(needle, cs);
+    int result = 0;
+    QBENCHMARK {
+        result = matcher.indexIn(haystack);
+    }
+    QCOMPARE(result, -1);
+}
+
+void tst_QString::fromUtf8_data()
+{
+    QTest::addColumn<QString>("text");
+
+    // words of each script with spaces and punctuation, as in real text
+    const struct {
+        const char *name;
+        QStringList words;
+    } scripts[] = {
+        { "ascii", { "the", "quick", "brown", "fox", "jumps", "over", "lazy", "dog." } },
+        { "latin1", { QString::fromUtf8("caf\xc3\xa9"), QString::fromUtf8("na\xc3\xafve"), "the",
+                      QString::fromUtf8("r\xc3\xa9sum\xc3\xa9"), QString::fromUtf8("\xc3\xbc" "ber"), "and" } },
+        { "cyrillic", { QString::fromUtf8("\xd0\x9f\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82"),
+                        QString::fromUtf8("\xd0\xbc\xd0\xb8\xd1\x80,"),
+                        QString::fromUtf8("\xd0\xb4\xd0\xb0\xd0\xbd\xd0\xbd\xd1\x8b\xd0\xb5"),
+                        QString::fromUtf8("\xd0\xb8"), QString::fromUtf8("\xd1\x82\xd0\xb5\xd0\xba\xd1\x81\xd1\x82.") } },
+        { "cjk", { QString::fromUtf8("\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e"),
+                   QString::fromUtf8("\xe3\x81\xae"), QString::fromUtf8("\xe3\x83\x86\xe3\x82\xad\xe3\x82\xb9\xe3\x83\x88"),
+                   QString::fromUtf8("\xe4\xb8\xad\xe6\x96\x87\xef\xbc\x8c"), QString::fromUtf8("Qt"),
+                   QString::fromUtf8("\xe6\x95\xb0\xe6\x8d\xae\xe3\x80\x82") } },
+        { "mixed", { "Qt", QString::fromUtf8("\xd0\xbc\xd0\xb8\xd1\x80"), QString::fromUtf8("caf\xc3\xa9"),
+                     QString::fromUtf8("\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e"),
+                     QString::fromUtf8("\xce\x95\xce\xbb\xce\xbb\xce\xac\xce\xb4\xce\xb1"), "release",
+                     QString::fromUtf8("\xf0\x9f\x98\x80") } }
+    };
+    for (const auto &script : scripts) {
+        QString text;
+        for (int i = 0; text.size() < 8 * 1024; ++i)
+            text += script.words.at(i % script.words.size()) + QLatin1Char(' ');
+        QTest::newRow(script.name) << text;
+    }
+}
+
+void tst_QString::fromUtf8()
+{
+    QFETCH(QString, text);
+
+    const QByteArray utf8 = text.toUtf8();
+    QString result;
+    QBENCHMARK {
+        result = QString::fromUtf8(utf8.constData(), utf8.size());
+    }
+    QCOMPARE(result, text);
+}
+
+void tst_QString::toUtf8()
+{
+    QFETCH(QString, text);
+
+    QByteArray result;
+    QBENCHMARK {
+        result = text.toUtf8();
+    }
+    QCOMPARE(QString::fromUtf8(result), text);
+}
+
 QTEST_APPLESS_MAIN(tst_QString)
 
 #include "main.moc"
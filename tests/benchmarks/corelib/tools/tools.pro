@@ -6,9 +6,11 @@ SUBDIRS = \
         qcontiguouscache \
         qcryptographichash \
         qdatetime \
+        qflathash \
         qlist \
         qlocale \
         qmap \
+        qmonotonicarena \
         qrect \
         qringbuffer \
         qstack \
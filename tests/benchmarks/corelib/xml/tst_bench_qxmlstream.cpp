@@ -0,0 +1,213 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtCore/qbuffer.h>
+#include <QtCore/qxmlstream.h>
+#include <QtTest>
+
+#if defined(__GLIBC__)
+#include <atomic>
+
+// count heap allocations by interposing the C library's allocator
+extern "C" void *__libc_malloc(size_t);
+extern "C" void *__libc_realloc(void *, size_t);
+
+static std::atomic<qint64> allocationCount(0);
+
+extern "C" void *malloc(size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+extern "C" void *realloc(void *ptr, size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+#endif
+
+class tst_QXmlStream : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void read_data();
+    void read();
+    void allocations_data() { read_data(); }
+    void allocations();
+};
+
+// an OpenStreetMap-like extract: many small elements with several attributes each
+static QByteArray mapDocument(bool latin)
+{
+    static const char *const names[] = {
+        "Main Street", "Station Road", "High Street", "Church Lane", "Mill Road"
+    };
+    static const char *const localNames[] = {
+        "\xd0\x9b\xd0\xb5\xd0\xbd\xd0\xb8\xd0\xbd\xd1\x81\xd0\xba\xd0\xb8\xd0\xb9 "
+        "\xd0\xbf\xd1\x80\xd0\xbe\xd1\x81\xd0\xbf\xd0\xb5\xd0\xba\xd1\x82",
+        "\xe4\xb8\xad\xe5\xb1\xb1\xe8\xb7\xaf",
+        "Stra\xc3\x9f" "e des 17. Juni",
+        "\xce\x9f\xce\xb4\xcf\x8c\xcf\x82 \xce\x95\xcf\x81\xce\xbc\xce\xbf\xcf\x8d",
+        "Rue de la Libert\xc3\xa9"
+    };
+
+    QByteArray result = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<osm version=\"0.6\" generator=\"bench\">\n";
+    for (int i = 0; i < 10000; ++i) {
+        result += "  <node id=\"" + QByteArray::number(100000 + i)
+                + "\" lat=\"" + QByteArray::number(51.5 + i * 1e-5, 'f', 7)
+                + "\" lon=\"" + QByteArray::number(-0.12 + i * 2e-5, 'f', 7)
+                + "\" version=\"3\" timestamp=\"2018-03-14T12:00:00Z\" user=\"mapper"
+                + QByteArray::number(i % 97) + "\">\n";
+        if (i % 4 == 0) {
+            result += "    <tag k=\"name\" v=\"";
+            result += latin ? names[i % 5] : localNames[i % 5];
+            result += "\"/>\n    <tag k=\"highway\" v=\"residential\"/>\n";
+        }
+        result += "  </node>\n";
+        if (i % 50 == 49) {
+            result += "  <way id=\"" + QByteArray::number(i) + "\">\n";
+            for (int j = i - 49; j <= i; j += 7)
+                result += "    <nd ref=\"" + QByteArray::number(100000 + j) + "\"/>\n";
+            result += "    <tag k=\"note\" v=\"surveyed &amp; checked\"/>\n  </way>\n";
+        }
+    }
+    result += "</osm>\n";
+    return result;
+}
+
+// a Wikipedia-dump-like document: few elements, long runs of text
+static QByteArray pagesDocument()
+{
+    static const char paragraph[] =
+        "The city lies on both banks of the river, about 50 km from the sea. "
+        "It was first mentioned in 1237 and became the capital in 1701; today "
+        "it is known for its museums, its parks and the \xe2\x80\x9c" "Festival of Lights\xe2\x80\x9d, "
+        "which draws visitors from M\xc3\xbcnchen, Krak\xc3\xb3w and \xd0\x9c\xd0\xbe\xd1\x81\xd0\xba\xd0\xb2\xd0\xb0 alike.\n"
+        "Population figures &amp; other statistics are updated every year.\n";
+
+    QByteArray result = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<mediawiki xml:lang=\"en\">\n";
+    for (int i = 0; i < 10000; ++i) {
+        result += "  <page>\n    <title>Article " + QByteArray::number(i) + "</title>\n"
+                  "    <ns>0</ns>\n    <id>" + QByteArray::number(i + 1) + "</id>\n"
+                  "    <revision>\n      <timestamp>2018-03-14T12:00:00Z</timestamp>\n"
+                  "      <text xml:space=\"preserve\" bytes=\"1024\">";
+        for (int j = 0; j < 1 + i % 4; ++j)
+            result += paragraph;
+        result += "</text>\n    </revision>\n  </page>\n";
+    }
+    result += "</mediawiki>\n";
+    return result;
+}
+
+static void addRows()
+{
+    QTest::addColumn<QByteArray>("document");
+    QTest::addColumn<bool>("useDevice");
+    QTest::addColumn<QString>("element");
+
+    const QByteArray ascii = mapDocument(true);
+    const QByteArray utf8 = mapDocument(false);
+    const QByteArray pages = pagesDocument();
+    QTest::newRow("map-ascii") << ascii << false << QString("node");
+    QTest::newRow("map-ascii-device") << ascii << true << QString("node");
+    QTest::newRow("map-utf8") << utf8 << false << QString("node");
+    QTest::newRow("map-utf8-device") << utf8 << true << QString("node");
+    QTest::newRow("pages") << pages << false << QString("page");
+    QTest::newRow("pages-device") << pages << true << QString("page");
+}
+
+// what a typical consumer does: look at names, attributes and text, keep nothing
+static int readDocument(const QByteArray &document, bool useDevice, const QString &element)
+{
+    QBuffer buffer;
+    QXmlStreamReader reader;
+    if (useDevice) {
+        buffer.setData(document);
+        buffer.open(QIODevice::ReadOnly);
+        reader.setDevice(&buffer);
+    } else {
+        reader.addData(document);
+    }
+
+    int elements = 0;
+    int textLength = 0;
+    while (!reader.atEnd()) {
+        switch (reader.readNext()) {
+        case QXmlStreamReader::StartElement: {
+            const QXmlStreamAttributes attributes = reader.attributes();
+            if (reader.name() == element && attributes.value(QLatin1String("version")) != QLatin1String("0"))
+                ++elements;
+            break;
+        }
+        case QXmlStreamReader::Characters:
+            textLength += reader.text().size();
+            break;
+        default:
+            break;
+        }
+    }
+    return reader.hasError() || !textLength ? -1 : elements;
+}
+
+void tst_QXmlStream::read_data()
+{
+    addRows();
+}
+
+void tst_QXmlStream::read()
+{
+    QFETCH(QByteArray, document);
+    QFETCH(bool, useDevice);
+    QFETCH(QString, element);
+
+    QBENCHMARK {
+        QCOMPARE(readDocument(document, useDevice, element), 10000);
+    }
+}
+
+void tst_QXmlStream::allocations()
+{
+#if defined(__GLIBC__)
+    QFETCH(QByteArray, document);
+    QFETCH(bool, useDevice);
+    QFETCH(QString, element);
+
+    readDocument(document, useDevice, element);  // warm up any global caches
+    const qint64 before = allocationCount.load();
+    QCOMPARE(readDocument(document, useDevice, element), 10000);
+    QTest::setBenchmarkResult(allocationCount.load() - before, QTest::Events);
+#else
+    QSKIP("Allocation counting needs glibc");
+#endif
+}
+
+QTEST_MAIN(tst_QXmlStream)
+#include "tst_bench_qxmlstream.moc"